@@ -59,6 +59,10 @@ public:
 
 protected:
     friend class Breakpoint;
+
+    void
+    AddLocationsInCompileUnit (SearchFilter &filter, CompileUnit *cu);
+
     FileSpec m_file_spec; // This is the file spec we are looking for.
     uint32_t m_line_number; // This is the line number that we are looking for.
     bool m_inlines; // This determines whether the resolver looks for inlined functions or not.
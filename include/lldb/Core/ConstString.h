@@ -484,6 +484,22 @@ public:
     static size_t
     StaticMemorySize ();
 
+    //------------------------------------------------------------------
+    /// Dump the number of strings in each shard of the global string
+    /// pool and how often threads had to wait for a shard's lock.
+    ///
+    /// @param[in] s
+    ///     The stream to dump the statistics to.
+    //------------------------------------------------------------------
+    static void
+    DumpStatistics (Stream *s);
+
+    //------------------------------------------------------------------
+    /// Reset the lock counters of the global string pool.
+    //------------------------------------------------------------------
+    static void
+    ResetStatistics ();
+
 protected:
     //------------------------------------------------------------------
     // Member variables
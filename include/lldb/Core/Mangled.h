@@ -400,6 +400,57 @@ public:
     const ConstString&
     GetDemangledName () const;
 
+    //----------------------------------------------------------------------
+    /// Check if the demangled name is available without running the
+    /// demangler.
+    ///
+    /// @return
+    ///     \b true if there is no mangled name or if the demangled name
+    ///     has already been computed, \b false otherwise.
+    //----------------------------------------------------------------------
+    bool
+    DemangledNameIsCached () const
+    {
+        return !m_mangled || m_demangled.GetCString() != NULL;
+    }
+
+    //----------------------------------------------------------------------
+    /// Extract the qualified name of an Itanium C++ mangled name without
+    /// demangling it.
+    ///
+    /// Only handles names made of plain identifiers, constructors,
+    /// destructors and operators, optionally nested in namespaces and
+    /// classes. Anything else (template arguments, substitutions, local
+    /// and special names) makes this function fail so the caller can
+    /// fall back on the demangler. Nothing is allocated.
+    ///
+    /// @param[in] mangled
+    ///     The mangled name.
+    ///
+    /// @param[out] dst
+    ///     A buffer that receives the qualified name, for example
+    ///     "ns::Class::method" for a method of "ns::Class".
+    ///
+    /// @param[in] dst_len
+    ///     The size in bytes of \a dst.
+    ///
+    /// @param[out] basename_offset
+    ///     The offset in \a dst of the last component of the name.
+    ///
+    /// @param[out] is_demangled_name
+    ///     Set to \b true if \a dst is exactly what the demangler would
+    ///     return, which is the case for names without a parameter list.
+    ///
+    /// @return
+    ///     \b true if the name was extracted, \b false otherwise.
+    //----------------------------------------------------------------------
+    static bool
+    ExtractQualifiedName (const char *mangled,
+                          char *dst,
+                          size_t dst_len,
+                          size_t &basename_offset,
+                          bool &is_demangled_name);
+
     void
     SetDemangledName (const char *name)
     {
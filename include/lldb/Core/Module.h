@@ -645,6 +645,26 @@ public:
     uint32_t
     ResolveSymbolContextsForFileSpec (const FileSpec &file_spec, uint32_t line, bool check_inlines, uint32_t resolve_scope, SymbolContextList& sc_list);
 
+    //------------------------------------------------------------------
+    /// Get the indexes of the compile units that can have line table
+    /// entries for a source file.
+    ///
+    /// @param[in] file_spec
+    ///     The source file to look for.
+    ///
+    /// @param[out] cu_indexes
+    ///     The sorted indexes, suitable for GetCompileUnitAtIndex(), of
+    ///     the compile units whose main source file or line table files
+    ///     might match \a file_spec.
+    ///
+    /// @return
+    ///     \b true if \a cu_indexes was filled in, \b false if the
+    ///     symbol file doesn't know and all compile units need to be
+    ///     checked.
+    //------------------------------------------------------------------
+    bool
+    FindCompileUnitsForFile (const FileSpec &file_spec, std::vector<uint32_t> &cu_indexes);
+
 
     void
     SetFileSpecAndObjectName (const FileSpec &file,
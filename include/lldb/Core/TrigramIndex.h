@@ -0,0 +1,115 @@
+//===-- TrigramIndex.h ------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_TrigramIndex_h_
+#define liblldb_TrigramIndex_h_
+#if defined(__cplusplus)
+
+#include <string>
+#include <vector>
+
+#include "llvm/ADT/DenseMap.h"
+
+namespace lldb_private {
+
+class RegularExpression;
+
+//----------------------------------------------------------------------
+/// @class TrigramIndex TrigramIndex.h "lldb/Core/TrigramIndex.h"
+/// @brief Narrows down which names a regular expression can match.
+///
+/// Every name added to the index is identified by a number. For each
+/// sequence of three bytes found in the names the index keeps the
+/// sorted list of names containing it. Literal text the regular
+/// expression requires in every match is looked up in these lists,
+/// and only the names that contain all of it need to be run through
+/// the regular expression.
+///
+/// The candidates are always a superset of the matches, so callers
+/// still have to execute the regular expression on them.
+//----------------------------------------------------------------------
+class TrigramIndex
+{
+public:
+    TrigramIndex ();
+
+    ~TrigramIndex ();
+
+    void
+    Clear ();
+
+    //------------------------------------------------------------------
+    /// Add the trigrams of \a name to the index.
+    ///
+    /// @param[in] id
+    ///     The number identifying the name. Names must be added in
+    ///     increasing order of \a id, several names can share an \a id.
+    ///
+    /// @param[in] name
+    ///     The name to add.
+    //------------------------------------------------------------------
+    void
+    Append (uint32_t id, const char *name);
+
+    //------------------------------------------------------------------
+    /// Mark the index as complete. Must be called once all names have
+    /// been added.
+    //------------------------------------------------------------------
+    void
+    Finalize ();
+
+    bool
+    IsFinalized () const
+    {
+        return m_finalized;
+    }
+
+    //------------------------------------------------------------------
+    /// Get the identifiers of the names \a regex might match.
+    ///
+    /// @param[in] regex
+    ///     A compiled regular expression.
+    ///
+    /// @param[out] ids
+    ///     The sorted identifiers of the candidate names.
+    ///
+    /// @return
+    ///     \b true if the index could be used, \b false if \a regex
+    ///     doesn't require any literal text long enough to be looked up,
+    ///     in which case all names need to be checked.
+    //------------------------------------------------------------------
+    bool
+    GetCandidates (const RegularExpression &regex, std::vector<uint32_t> &ids) const;
+
+    //------------------------------------------------------------------
+    /// Get the literal strings that every match of a POSIX extended
+    /// regular expression must contain.
+    ///
+    /// This errs on the side of returning less, any construct that
+    /// isn't understood just ends the current literal.
+    ///
+    /// @return
+    ///     \b false if no literal is required, for example because of
+    ///     an alternation.
+    //------------------------------------------------------------------
+    static bool
+    GetRequiredLiterals (const char *regex, int compile_flags, std::vector<std::string> &literals);
+
+protected:
+    typedef std::vector<uint32_t> IDList;
+    typedef llvm::DenseMap<uint32_t, IDList> TrigramMap;
+
+    TrigramMap m_trigrams;
+    bool m_finalized;
+};
+
+} // namespace lldb_private
+
+#endif  // #if defined(__cplusplus)
+#endif  // liblldb_TrigramIndex_h_
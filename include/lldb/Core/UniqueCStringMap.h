@@ -273,6 +273,24 @@ public:
     {
         std::sort (m_map.begin(), m_map.end());
     }
+
+    //------------------------------------------------------------------
+    // Sort the contents of this map by string and then by value. The
+    // resulting order doesn't depend on the order the entries were
+    // appended in, which makes it suitable for maps that are filled in
+    // from several threads. If the first "sorted_size" entries are
+    // already in order, only the entries after them are sorted and then
+    // merged in.
+    //------------------------------------------------------------------
+    void
+    SortByCStringThenValue (size_t sorted_size = 0)
+    {
+        assert (sorted_size <= m_map.size());
+        iterator middle = m_map.begin() + sorted_size;
+        std::sort (middle, m_map.end(), CStringThenValueLessThan);
+        if (sorted_size > 0)
+            std::inplace_merge (m_map.begin(), middle, m_map.end(), CStringThenValueLessThan);
+    }
     
     //------------------------------------------------------------------
     // Since we are using a vector to contain our items it will always 
@@ -293,6 +311,14 @@ public:
     }
 
 protected:
+    static bool
+    CStringThenValueLessThan (const Entry& lhs, const Entry& rhs)
+    {
+        if (lhs.cstring != rhs.cstring)
+            return lhs.cstring < rhs.cstring;
+        return lhs.value < rhs.value;
+    }
+
     typedef std::vector<Entry> collection;
     typedef typename collection::iterator iterator;
     typedef typename collection::const_iterator const_iterator;
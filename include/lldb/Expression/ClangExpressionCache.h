@@ -0,0 +1,183 @@
+//===-- ClangExpressionCache.h ----------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_ClangExpressionCache_h_
+#define liblldb_ClangExpressionCache_h_
+
+// C Includes
+// C++ Includes
+#include <list>
+#include <map>
+#include <string>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/lldb-private.h"
+#include "lldb/Host/Mutex.h"
+
+namespace lldb_private
+{
+
+//----------------------------------------------------------------------
+/// @class ClangExpressionCache ClangExpressionCache.h "lldb/Expression/ClangExpressionCache.h"
+/// @brief Keeps parsed user expressions around so they can be evaluated again.
+///
+/// Parsing an expression, transforming its IR and JIT-compiling it is far
+/// more expensive than running it.  Expressions that are evaluated over
+/// and over in the same function (breakpoint conditions, scripted
+/// stepping, data formatters) only need to have their variables
+/// materialized again, or, if the IR interpreter handled them, to be
+/// interpreted again.
+///
+/// Entries are keyed by the expression text, the prefix, the language,
+/// the desired result type and the innermost block or function of the
+/// frame the expression was parsed in, since that determines which
+/// variables the expression resolved to.  The target clears the cache
+/// whenever modules are loaded or unloaded, and when its process goes
+/// away.  Since the block or function is only known by address, each
+/// entry also holds on to its module so that the address can't be reused
+/// for another block or function while the entry exists.  When the cache
+/// is full, the least recently used expression is evicted.
+//----------------------------------------------------------------------
+class ClangExpressionCache
+{
+public:
+    typedef lldb::SharedPtr<ClangUserExpression>::Type ClangUserExpressionSP;
+
+    //------------------------------------------------------------------
+    /// Constructor
+    //------------------------------------------------------------------
+    ClangExpressionCache ();
+
+    //------------------------------------------------------------------
+    /// Destructor
+    //------------------------------------------------------------------
+    ~ClangExpressionCache ();
+
+    //------------------------------------------------------------------
+    /// Get the declaration context an expression would be parsed in.
+    ///
+    /// @param[in] exe_ctx
+    ///     The execution context the expression will run in.
+    ///
+    /// @param[out] decl_context
+    ///     The innermost block or function of the frame, or NULL if the
+    ///     expression is evaluated without a thread.
+    ///
+    /// @param[out] module_sp
+    ///     The module \a decl_context belongs to.
+    ///
+    /// @return
+    ///     True if expressions evaluated in \a exe_ctx can be cached.
+    //------------------------------------------------------------------
+    static bool
+    GetDeclContext (ExecutionContext &exe_ctx,
+                    const void *&decl_context,
+                    lldb::ModuleSP &module_sp);
+
+    //------------------------------------------------------------------
+    /// Remove an expression from the cache and return it.
+    ///
+    /// The caller owns the expression while it runs, and hands it back
+    /// with Insert() if it completed.  This keeps an expression from
+    /// being reused while it is still running.
+    ///
+    /// @return
+    ///     The cached expression, or an empty shared pointer on a miss.
+    //------------------------------------------------------------------
+    ClangUserExpressionSP
+    Take (const char *expr_cstr,
+          const char *expr_prefix,
+          lldb::LanguageType language,
+          uint32_t desired_type,
+          const void *decl_context);
+
+    //------------------------------------------------------------------
+    /// Add a successfully evaluated expression to the cache.
+    //------------------------------------------------------------------
+    void
+    Insert (const char *expr_cstr,
+            const char *expr_prefix,
+            lldb::LanguageType language,
+            uint32_t desired_type,
+            const void *decl_context,
+            const lldb::ModuleSP &module_sp,
+            const ClangUserExpressionSP &expr_sp);
+
+    //------------------------------------------------------------------
+    /// Drop all cached expressions.  The hit and miss counters are kept.
+    //------------------------------------------------------------------
+    void
+    Clear ();
+
+    void
+    DumpStatistics (Stream *s);
+
+    void
+    ResetStatistics ();
+
+    uint64_t
+    GetNumHits () const
+    {
+        return m_num_hits;
+    }
+
+    uint64_t
+    GetNumMisses () const
+    {
+        return m_num_misses;
+    }
+
+protected:
+    struct Key
+    {
+        std::string m_expr_text;
+        std::string m_expr_prefix;
+        lldb::LanguageType m_language;
+        uint32_t m_desired_type;
+        const void *m_decl_context;
+
+        bool
+        operator < (const Key &rhs) const;
+    };
+
+    struct Entry
+    {
+        Key m_key;
+        lldb::ModuleSP m_module_sp;     ///< Keeps m_key.m_decl_context alive
+        ClangUserExpressionSP m_expr_sp;
+    };
+
+    // Entries are kept from the most to the least recently used one.
+    typedef std::list<Entry> collection;
+    typedef std::map<Key, collection::iterator> KeyToEntryMap;
+
+    static void
+    MakeKey (const char *expr_cstr,
+             const char *expr_prefix,
+             lldb::LanguageType language,
+             uint32_t desired_type,
+             const void *decl_context,
+             Key &key);
+
+    Mutex m_mutex;
+    collection m_expressions;
+    KeyToEntryMap m_key_to_entry;
+    uint64_t m_num_hits;
+    uint64_t m_num_misses;
+    uint64_t m_num_evictions;       ///< Number of expressions evicted to make room for others
+    uint64_t m_num_invalidations;   ///< Number of times a non-empty cache was cleared
+
+private:
+    DISALLOW_COPY_AND_ASSIGN (ClangExpressionCache);
+};
+
+} // namespace lldb_private
+
+#endif  // liblldb_ClangExpressionCache_h_
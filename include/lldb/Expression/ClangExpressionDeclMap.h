@@ -107,6 +107,34 @@ public:
     void 
     DidParse ();
     
+    //------------------------------------------------------------------
+    /// Prepare an expression that has already been parsed and run to
+    /// be materialized again.
+    ///
+    /// The variables the expression refers to are looked up again in
+    /// \a exe_ctx when the struct is materialized or the IR interpreter
+    /// runs the expression again. The result gets a
+    /// new persistent variable, so the results of earlier runs keep
+    /// their values.
+    ///
+    /// @param[in] exe_ctx
+    ///     The execution context the expression will run in.
+    ///
+    /// @return
+    ///     True if the expression can run again; false if it has to be
+    ///     parsed again, for instance because it declares persistent
+    ///     variables.
+    //------------------------------------------------------------------
+    bool
+    WillReuse (ExecutionContext &exe_ctx);
+    
+    //------------------------------------------------------------------
+    /// Return true if the expression can be run more than once without
+    /// parsing it again.  See WillReuse().
+    //------------------------------------------------------------------
+    bool
+    CanReuse ();
+    
     //------------------------------------------------------------------
     /// [Used by IRForTarget] Get a new result variable name of the form
     ///     $n, where n is a natural number starting with 0.
@@ -725,6 +753,8 @@ private:
             m_struct_size(0),
             m_struct_laid_out(false),
             m_result_name(),
+            m_result_flags(0),
+            m_declares_persistent_vars(false),
             m_object_pointer_type(NULL, NULL)
         {
         }
@@ -733,6 +763,8 @@ private:
         size_t                      m_struct_size;              ///< The size of the struct in bytes.
         bool                        m_struct_laid_out;          ///< True if the struct has been laid out and the layout is valid (that is, no new fields have been added since).
         ConstString                 m_result_name;              ///< The name of the result variable ($1, for example)
+        uint16_t                    m_result_flags;             ///< The flags of the result variable before the expression first ran.
+        bool                        m_declares_persistent_vars; ///< True if the expression declares persistent variables other than its result.
         TypeFromUser                m_object_pointer_type;      ///< The type of the "this" variable, if one exists
     };
     
@@ -122,6 +122,33 @@ public:
                          lldb::ClangExpressionVariableSP &const_result,
                          lldb_private::ExecutionPolicy execution_policy);
         
+    //------------------------------------------------------------------
+    /// Return true if PrepareForExecution evaluated the expression with
+    /// the IR interpreter, and kept the IR so it can do so again.
+    //------------------------------------------------------------------
+    bool
+    CanInterpretAgain () const
+    {
+        return m_interpreted_function != NULL;
+    }
+    
+    //------------------------------------------------------------------
+    /// Run the IR interpreter again on an expression that
+    /// PrepareForExecution evaluated statically.  The values of the
+    /// variables used by the expression are read anew through the
+    /// expression's DeclMap, so it must already be set up for the new
+    /// execution context.
+    ///
+    /// @param[out] const_result
+    ///     Set to the result of the expression.
+    ///
+    /// @return
+    ///     An error code indicating the success or failure of the operation.
+    ///     Test with Success().
+    //------------------------------------------------------------------
+    Error
+    InterpretAgain (lldb::ClangExpressionVariableSP &const_result);
+    
     //------------------------------------------------------------------
     /// Disassemble the machine code for a JITted function from the target 
     /// process's memory and print the result to a stream.
@@ -191,6 +218,9 @@ private:
     std::auto_ptr<clang::CodeGenerator>         m_code_generator;       ///< [owned by the Execution Engine] The Clang object that generates IR
     std::auto_ptr<llvm::ExecutionEngine>        m_execution_engine;     ///< The LLVM JIT
     std::vector<JittedFunction>                 m_jitted_functions;     ///< A vector of all functions that have been JITted into machine code (just one, if ParseExpression() was called)
+    std::auto_ptr<llvm::Module>                 m_interpreted_module;   ///< The module holding m_interpreted_function, if any
+    llvm::Function                             *m_interpreted_function; ///< The function the IR interpreter evaluated, NULL if the expression was JIT compiled or constant
+    TypeFromParser                              m_interpreted_result_type; ///< The type of the result of m_interpreted_function
 };
     
 }
@@ -279,6 +279,13 @@ public:
         return m_variables.size() - 1;
     }
 
+    void
+    SetVariableAtIndex (size_t index, const lldb::ClangExpressionVariableSP &var_sp)
+    {
+        if (index < m_variables.size())
+            m_variables[index] = var_sp;
+    }
+
     bool
     ContainsVariable (const lldb::ClangExpressionVariableSP &var_sp)
     {
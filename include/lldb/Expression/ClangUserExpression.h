@@ -350,6 +350,33 @@ private:
                                    lldb::addr_t &object_ptr,
                                    lldb::addr_t &cmd_ptr);
     
+    //------------------------------------------------------------------
+    /// Return true if the expression can be evaluated again without
+    /// parsing it, either by running its JIT-compiled code or by
+    /// interpreting its IR again.
+    //------------------------------------------------------------------
+    bool
+    CanReuse ();
+    
+    //------------------------------------------------------------------
+    /// Prepare an expression that was parsed and run before to run
+    /// again in \a exe_ctx without parsing it.
+    ///
+    /// @return
+    ///     True if the expression can be evaluated in \a exe_ctx under
+    ///     \a execution_policy without parsing it again.
+    //------------------------------------------------------------------
+    bool
+    WillReuse (ExecutionContext &exe_ctx,
+               lldb_private::ExecutionPolicy execution_policy);
+    
+    //------------------------------------------------------------------
+    /// Evaluate an expression that the IR interpreter handled again,
+    /// after WillReuse().  Sets m_const_result to the new result.
+    //------------------------------------------------------------------
+    bool
+    InterpretAgain (Stream &error_stream);
+    
     bool
     EvaluatedStatically ()
     {
@@ -365,6 +392,7 @@ private:
     ResultType                                  m_desired_type;         ///< The type to coerce the expression's result to.  If eResultTypeAny, inferred from the expression.
     
     std::auto_ptr<ClangExpressionDeclMap>       m_expr_decl_map;        ///< The map to use when parsing and materializing the expression.
+    std::auto_ptr<ClangExpressionParser>        m_parser;               ///< The parser, kept after parsing only if the IR interpreter can evaluate the expression again.
     std::auto_ptr<ClangExpressionVariableList>  m_local_variables;      ///< The local expression variables, if the expression is DWARF.
     std::auto_ptr<ProcessDataAllocator>         m_data_allocator;       ///< The allocator that the parser uses to place strings for use by JIT-compiled code.
     
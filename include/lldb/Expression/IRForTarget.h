@@ -151,6 +151,27 @@ public:
     {
         return m_interpret_success;
     }
+    
+    //------------------------------------------------------------------
+    /// Returns the function the IR interpreter ran to get the result,
+    /// or NULL if the interpreter didn't run it.  The function can be
+    /// interpreted again as long as the module is around.
+    //------------------------------------------------------------------
+    llvm::Function *
+    interpretedFunction ()
+    {
+        return m_interpreted_function;
+    }
+    
+    //------------------------------------------------------------------
+    /// Returns the type of the result variable, in the parser's AST
+    /// context.
+    //------------------------------------------------------------------
+    const lldb_private::TypeFromParser &
+    resultType ()
+    {
+        return m_result_type;
+    }
 
 private:
     //------------------------------------------------------------------
@@ -621,6 +642,7 @@ private:
     bool                                    m_resolve_vars;             ///< True if external variable references and persistent variable references should be resolved
     lldb_private::ExecutionPolicy           m_execution_policy;         ///< True if the interpreter should be used to attempt to get a static result
     bool                                    m_interpret_success;        ///< True if the interpreter successfully handled the whole expression
+    llvm::Function                         *m_interpreted_function;     ///< The function the interpreter handled, if it did
     std::string                             m_func_name;                ///< The name of the function to translate
     lldb_private::ConstString               m_result_name;              ///< The name of the result variable ($0, $1, ...)
     lldb_private::TypeFromParser            m_result_type;              ///< The type of the result variable.
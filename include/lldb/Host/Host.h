@@ -87,6 +87,15 @@ public:
     static size_t
     GetPageSize();
 
+    //------------------------------------------------------------------
+    /// Get the number of processors that are online on the host.
+    ///
+    /// @return
+    ///     The number of online processors, at least one.
+    //------------------------------------------------------------------
+    static uint32_t
+    GetNumberOfCPUs();
+
     //------------------------------------------------------------------
     /// Returns the endianness of the host system.
     ///
@@ -227,6 +236,46 @@ public:
                 lldb::thread_result_t *thread_result_ptr,
                 Error *error);
 
+    typedef void (*ParallelForEachCallback) (void *baton,
+                                             uint32_t worker_idx,
+                                             size_t task_idx);
+
+    //------------------------------------------------------------------
+    /// Run a set of independent tasks on a pool of worker threads.
+    ///
+    /// The calling thread is used as worker zero and up to \a num_workers
+    /// - 1 additional threads are created. Tasks are handed out in
+    /// increasing index order to whichever worker is idle, so callers
+    /// that need deterministic results must not depend on which worker
+    /// ran a given task. This function returns once every task has run.
+    ///
+    /// @param[in] thread_name
+    ///     The name given to the additional worker threads.
+    ///
+    /// @param[in] num_workers
+    ///     The maximum number of workers, including the calling thread.
+    ///     Pass zero to use one worker per online processor.
+    ///
+    /// @param[in] num_tasks
+    ///     The number of tasks to run.
+    ///
+    /// @param[in] callback
+    ///     The function called for each task, along with the index in
+    ///     [0, num_workers) of the worker running it.
+    ///
+    /// @param[in] baton
+    ///     The baton passed to \a callback.
+    ///
+    /// @return
+    ///     The number of workers that were used.
+    //------------------------------------------------------------------
+    static uint32_t
+    ParallelForEach (const char *thread_name,
+                     uint32_t num_workers,
+                     size_t num_tasks,
+                     ParallelForEachCallback callback,
+                     void *baton);
+
     //------------------------------------------------------------------
     /// Gets the name of a thread in a process.
     ///
@@ -108,6 +108,20 @@ private:
     void
     GetFDEIndex ();
 
+    // Find the FDE for an address with the sorted table in the
+    // .eh_frame_hdr section, which spares us scanning all of .eh_frame.
+    bool
+    GetEHFrameHeader ();
+
+    bool
+    GetFDEEntryFromEHFrameHeader (Address addr, FDEEntry& fde_entry);
+
+    lldb::addr_t
+    GetEHFrameHeaderTableValue (uint32_t index);
+
+    bool
+    ParseFDEEntry (dw_offset_t fde_offset, FDEEntry& fde_entry);
+
     bool
     FDEToUnwindPlan (uint32_t offset, Address startaddr, UnwindPlan& unwind_plan);
 
@@ -129,6 +143,14 @@ private:
     std::vector<FDEEntry>       m_fde_index;
     bool                        m_fde_index_initialized;  // only scan the section for FDEs once
 
+    DataExtractor               m_hdr_data;               // the .eh_frame_hdr section, if there is one
+    lldb::addr_t                m_hdr_file_addr;
+    dw_offset_t                 m_hdr_table_offset;       // offset of the sorted (location, FDE) table
+    uint32_t                    m_hdr_fde_count;          // zero if we can't use the table
+    uint8_t                     m_hdr_table_enc;
+    uint8_t                     m_hdr_table_value_size;   // byte size of each encoded value in the table
+    bool                        m_hdr_initialized;        // only look for the header once
+
     bool                        m_is_eh_frame;
 
     CIESP
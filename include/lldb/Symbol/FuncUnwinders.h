@@ -64,6 +64,12 @@ public:
     const Address&
     GetFunctionStartAddress () const;
 
+    const AddressRange&
+    GetFunctionAddressRange () const
+    {
+        return m_range;
+    }
+
     bool
     ContainsAddress (const Address& addr) const
     { 
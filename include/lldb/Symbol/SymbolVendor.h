@@ -97,6 +97,10 @@ public:
                           uint32_t resolve_scope,
                           SymbolContextList& sc_list);
 
+    virtual bool
+    FindCompileUnitsForFile (const FileSpec& file_spec,
+                             std::vector<uint32_t>& cu_indexes);
+
     virtual uint32_t
     FindGlobalVariables (const ConstString &name,
                          const ClangNamespaceDecl *namespace_decl,
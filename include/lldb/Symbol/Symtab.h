@@ -14,6 +14,7 @@
 #include <vector>
 
 #include "lldb/lldb-private.h"
+#include "lldb/Core/TrigramIndex.h"
 #include "lldb/Core/UniqueCStringMap.h"
 #include "lldb/Host/Mutex.h"
 #include "lldb/Symbol/Symbol.h"
@@ -103,12 +104,16 @@ protected:
     typedef collection::const_iterator  const_iterator;
 
             void        InitNameIndexes ();
+            void        InitDemangledNameIndexes ();
+            void        InitNameTrigramIndex ();
             void        InitAddressIndexes ();
 
     ObjectFile *        m_objfile;
     collection          m_symbols;
     std::vector<uint32_t> m_addr_indexes;
     UniqueCStringMap<uint32_t> m_name_to_index;
+    IndexCollection     m_pending_demangle_indexes;     // C++ symbols whose demangled names aren't in m_name_to_index yet
+    TrigramIndex        m_name_trigrams;                // Built on the first regex lookup
     mutable Mutex       m_mutex; // Provide thread safety for this symbol table
     bool                m_addr_indexes_computed:1,
                         m_name_indexes_computed:1;
@@ -12,8 +12,11 @@
 #define liblldb_UnwindTable_h
 
 #include <map>
+#include <vector>
 
 #include "lldb/lldb-private.h"
+#include "lldb/Host/Mutex.h"
+#include "lldb/Symbol/UnwindPlan.h"
 
 namespace lldb_private {
 
@@ -33,6 +36,59 @@ public:
     lldb::FuncUnwindersSP
     GetFuncUnwindersContainingAddress (const Address& addr, SymbolContext &sc);
 
+    //------------------------------------------------------------------
+    // A row of a function's UnwindPlan reduced to what it takes to walk
+    // the stack: how to find the CFA, and how to recover the caller's pc,
+    // stack pointer and frame pointer.  Register numbers are of kind
+    // eRegisterKindGeneric.  Sampling unwinds use these so they don't
+    // have to go through FuncUnwinders and UnwindPlans for every frame.
+    //------------------------------------------------------------------
+    struct FastUnwindRow
+    {
+        enum Type
+        {
+            eTypeCompiled,          // The fields below tell how to unwind
+            eTypeNoUnwindInfo,      // Nothing is known about this address, use the ABI's default
+            eTypeUnsupported        // The UnwindPlan needs the full unwinder
+        };
+
+        enum Rule
+        {
+            eRuleSame,              // reg is unchanged
+            eRuleUndefined,         // reg can't be recovered
+            eRuleAtCFAPlusOffset,   // reg = deref(CFA + offset)
+            eRuleIsCFAPlusOffset    // reg = CFA + offset
+        };
+
+        lldb::addr_t base;          // File address where the row starts
+        lldb::addr_t size;
+        uint8_t type;
+        uint8_t pc_rule;
+        uint8_t sp_rule;
+        uint8_t fp_rule;
+        uint32_t cfa_reg;           // LLDB_REGNUM_GENERIC_SP or LLDB_REGNUM_GENERIC_FP
+        int32_t cfa_offset;
+        int32_t pc_offset;
+        int32_t sp_offset;
+        int32_t fp_offset;
+    };
+
+    // Get the row for the function containing "addr", compiling the
+    // function's UnwindPlan the first time one of its addresses is asked
+    // about.  "frame_zero" selects the rows that are valid anywhere in the
+    // function, rather than only at call sites.
+    bool
+    GetFastUnwindRow (const Address& addr, 
+                      bool frame_zero, 
+                      Thread &thread, 
+                      FastUnwindRow &fast_row);
+
+    static bool
+    CompileFastUnwindRow (const UnwindPlan &unwind_plan,
+                          const UnwindPlan::Row &row,
+                          RegisterContext &reg_ctx,
+                          FastUnwindRow &fast_row);
+
 private:
     void
     Dump (Stream &s);
@@ -51,6 +107,23 @@ private:
     UnwindAssembly* m_assembly_profiler;
 
     DWARFCallFrameInfo* m_eh_frame;
+
+    // Compiled rows sorted by address, for frame zero and for callers
+    typedef std::vector<FastUnwindRow> FastUnwindRows;
+    Mutex               m_fast_unwind_mutex;
+    FastUnwindRows      m_fast_unwind_rows[2];
+    uint32_t            m_fast_unwind_misses[2];    // One byte eTypeNoUnwindInfo rows in m_fast_unwind_rows
+
+    static bool
+    FindFastUnwindRow (const FastUnwindRows &rows, 
+                       lldb::addr_t file_addr, 
+                       FastUnwindRow &fast_row);
+
+    void
+    CompileFastUnwindRows (const Address& addr, 
+                           bool frame_zero, 
+                           Thread &thread, 
+                           FastUnwindRows &rows);
     
     DISALLOW_COPY_AND_ASSIGN (UnwindTable);
 };
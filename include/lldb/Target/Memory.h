@@ -20,12 +20,20 @@
 
 // Project includes
 #include "lldb/lldb-private.h"
+#include "lldb/Core/RangeMap.h"
 #include "lldb/Host/Mutex.h"
 
 namespace lldb_private {
     //----------------------------------------------------------------------
     // A class to track memory that was read from a live process between 
     // runs. 
+    //
+    // Memory is cached in lines whose size depends on the region of memory
+    // they come from: code and read-only data use large lines, writable data
+    // uses small ones so a scattered heap doesn't drag in bytes nobody asked
+    // for. Misses that walk forward through memory, like the unwinder reading
+    // up a stack or ValueObject reading the elements of an array, make the
+    // cache read further ahead each time.
     //----------------------------------------------------------------------
     class MemoryCache
     {
@@ -40,6 +48,15 @@ namespace lldb_private {
         void
         Clear();
         
+        //------------------------------------------------------------------
+        // Throws away everything that was cached, including the line sizes
+        // of the regions, without counting a stop. Called when images are
+        // loaded or unloaded, since memory may have been mapped or unmapped
+        // under us (an exec replaces all of it).
+        //------------------------------------------------------------------
+        void
+        MemoryMapChanged ();
+
         void
         Flush (lldb::addr_t addr, size_t size);
         
@@ -48,21 +65,133 @@ namespace lldb_private {
               void *dst, 
               size_t dst_len,
               Error &error);
+
+        //------------------------------------------------------------------
+        // Adds memory the process got without reading it through us, like
+        // memory a remote stub sent along with a stop, so reads of it don't
+        // go back to the process. It is thrown away with the rest of the
+        // cache when the process resumes.
+        //------------------------------------------------------------------
+        void
+        AddPrefetchedData (lldb::addr_t addr,
+                           const void *src,
+                           size_t src_len);
         
         uint32_t
         GetMemoryCacheLineSize() const
         {
             return m_cache_line_byte_size ;
         }
+
+        void
+        DumpStatistics (Stream *s);
+
+        void
+        ResetStatistics ();
+
     protected:
-        typedef std::map<lldb::addr_t, lldb::DataBufferSP> collection;
+        enum
+        {
+            eSmallLineByteSize      = 256,      // Writable data
+            eDefaultLineByteSize    = 512,      // Memory we know nothing about
+            eLargeLineByteSize      = 4096,     // Code and read-only data
+            eNumLineSizes           = 3,
+            eSlabByteSize           = 64 * 1024,
+            eMaxStrideByteSize      = 1024,
+            eMinSequentialMisses    = 2,
+            eMaxPrefetchByteSize    = 32 * 1024
+        };
+
+        struct CacheLine
+        {
+            lldb::addr_t addr;
+            uint8_t *bytes;             // NULL for an empty slot
+            uint32_t byte_size;         // Less than line_byte_size if the rest wasn't readable
+            uint32_t line_byte_size;
+        };
+
+        struct Statistics
+        {
+            Statistics () :
+                num_hits (0),
+                num_misses (0),
+                num_prefetched_lines (0),
+                num_bytes_fetched (0)
+            {
+            }
+
+            uint64_t num_hits;
+            uint64_t num_misses;
+            uint64_t num_prefetched_lines;
+            uint64_t num_bytes_fetched;
+        };
+
+        // Open addressed with linear probing, the size is a power of two
+        typedef std::vector<CacheLine> LineTable;
+        // The line byte size to use for each region of memory
+        typedef RangeDataArray<lldb::addr_t, lldb::addr_t, uint32_t, 8> RegionLineSizes;
+        // Blocks of prefetched memory by their start address
+        typedef std::map<lldb::addr_t, lldb::DataBufferSP> PrefetchedBlocks;
+
+        CacheLine *
+        FindLine (lldb::addr_t line_addr, uint32_t line_byte_size);
+
+        void
+        InsertLines (lldb::addr_t addr,
+                     const uint8_t *bytes,
+                     size_t byte_size,
+                     uint32_t line_byte_size);
+
+        void
+        RemoveLine (lldb::addr_t line_addr, uint32_t line_byte_size);
+
+        void
+        ClearCachedMemory ();
+
+        size_t
+        ReadPrefetchedData (lldb::addr_t addr, void *dst, size_t dst_len);
+
+        void
+        GrowLineTable ();
+
+        uint8_t *
+        AllocateLine (uint32_t line_byte_size);
+
+        void
+        FreeLine (const CacheLine &line);
+
+        const RegionLineSizes::Entry *
+        FindRegion (lldb::addr_t addr) const;
+
+        void
+        AddRegion (lldb::addr_t addr);
+
+        size_t
+        GetFetchByteSize (lldb::addr_t line_addr, 
+                          uint32_t line_byte_size,
+                          lldb::addr_t request_end,
+                          lldb::addr_t region_end);
+
         //------------------------------------------------------------------
         // Classes that inherit from MemoryCache can see and modify these
         //------------------------------------------------------------------
         Process &m_process;
         uint32_t m_cache_line_byte_size;
         Mutex m_cache_mutex;
-        collection m_cache;
+        LineTable m_lines;
+        size_t m_num_lines;
+        uint32_t m_generation;          // Bumped whenever cached lines are thrown away
+        std::vector<uint8_t *> m_free_lines[eNumLineSizes];
+        std::vector<uint8_t *> m_slabs;
+        RegionLineSizes m_regions;
+        PrefetchedBlocks m_prefetched_blocks;
+        LazyBool m_supports_region_info;
+        lldb::addr_t m_last_fetch_end;
+        uint32_t m_num_sequential_misses;
+        size_t m_prefetch_byte_size;
+        uint32_t m_num_stops;
+        Statistics m_stop_stats;        // Since the process last stopped
+        Statistics m_total_stats;       // For all previous stops
         
     private:
         DISALLOW_COPY_AND_ASSIGN (MemoryCache);
@@ -1611,6 +1611,35 @@ public:
     virtual Error
     ConnectRemote (const char *remote_url);
 
+    //------------------------------------------------------------------
+    /// Load a core file into this process.
+    ///
+    /// This function is not meant to be overridden by Process
+    /// subclasses. It calls DoLoadCore (const FileSpec &) to read the
+    /// threads and memory regions out of the core file, and if that
+    /// succeeds the dynamic loader is asked to find the shared
+    /// libraries and the process is put in the stopped state.
+    ///
+    /// @param[in] core_file
+    ///     The core file to load.
+    ///
+    /// @return
+    ///     An error object describing why the core file couldn't be
+    ///     loaded.
+    //------------------------------------------------------------------
+    Error
+    LoadCore (const FileSpec &core_file);
+
+    //------------------------------------------------------------------
+    /// Get the auxiliary vector the process was started with.
+    ///
+    /// @return
+    ///     The raw contents of the auxiliary vector, or an empty shared
+    ///     pointer if it isn't available.
+    //------------------------------------------------------------------
+    virtual lldb::DataBufferSP
+    GetAuxvData ();
+
     bool
     GetShouldDetach () const
     {
@@ -1833,6 +1862,23 @@ public:
         return error;
     }
 
+    //------------------------------------------------------------------
+    /// Read the state of a process from a core file.
+    ///
+    /// @param[in] core_file
+    ///     The core file to load.
+    ///
+    /// @return
+    ///     Returns an error object.
+    //------------------------------------------------------------------
+    virtual Error
+    DoLoadCore (const FileSpec &core_file)
+    {
+        Error error;
+        error.SetErrorString ("loading core files is not supported");
+        return error;
+    }
+
     //------------------------------------------------------------------
     /// Attach to an existing process using a process ID.
     ///
@@ -2298,6 +2344,17 @@ public:
     virtual bool
     IsAlive () = 0;
 
+    //------------------------------------------------------------------
+    /// A range of memory to read with ReadMemoryRangesFromInferior.
+    //------------------------------------------------------------------
+    struct MemoryReadRange
+    {
+        lldb::addr_t addr;
+        void *buf;
+        size_t size;
+        size_t bytes_read;      // Set to the number of bytes read
+    };
+
     //------------------------------------------------------------------
     /// Actually do the reading of memory from a process.
     ///
@@ -2326,6 +2383,24 @@ public:
                   size_t size,
                   Error &error) = 0;
 
+    //------------------------------------------------------------------
+    /// Actually do the reading of several ranges of memory from a
+    /// process.
+    ///
+    /// Subclasses that can read many ranges with one request should
+    /// override this. The default reads ranges that follow each other
+    /// in both the process and their buffers with one DoReadMemory call,
+    /// and goes back to reading them one at a time if that comes up
+    /// short. Ranges after one that still can't be read in full are
+    /// left unread.
+    ///
+    /// @see Process::ReadMemoryRangesFromInferior
+    //------------------------------------------------------------------
+    virtual size_t
+    DoReadMemoryRanges (MemoryReadRange *ranges,
+                        size_t num_ranges,
+                        Error &error);
+
     //------------------------------------------------------------------
     /// Read of memory from a process.
     ///
@@ -2381,6 +2456,40 @@ public:
                             void *buf, 
                             size_t size,
                             Error &error);
+
+    //------------------------------------------------------------------
+    /// Read several ranges of memory from the process at once, without
+    /// going through the memory cache.
+    ///
+    /// Unlike a single read that covers all of them, a range that can't
+    /// be read doesn't cost the ones before it. Any software breakpoint
+    /// opcodes are removed from what is read.
+    ///
+    /// @param[in] ranges
+    ///     The ranges to read, the  bytes_read member of each is set
+    ///     to the number of bytes read into its buffer.
+    ///
+    /// @param[in] num_ranges
+    ///     The number of ranges in  ranges.
+    ///
+    /// @return
+    ///     The total number of bytes read.  error is set from the
+    ///     first range that couldn't be read in full.
+    //------------------------------------------------------------------
+    size_t
+    ReadMemoryRangesFromInferior (MemoryReadRange *ranges,
+                                  size_t num_ranges,
+                                  Error &error);
+
+    //------------------------------------------------------------------
+    /// Get the cache ReadMemory() reads through, which holds memory
+    /// read since the process last stopped.
+    //------------------------------------------------------------------
+    MemoryCache &
+    GetMemoryCache ()
+    {
+        return m_memory_cache;
+    }
     
     //------------------------------------------------------------------
     /// Reads an unsigned integer of the specified byte size from 
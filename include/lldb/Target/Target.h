@@ -24,6 +24,7 @@
 #include "lldb/Core/ModuleList.h"
 #include "lldb/Core/UserSettingsController.h"
 #include "lldb/Core/SourceManager.h"
+#include "lldb/Expression/ClangExpressionCache.h"
 #include "lldb/Expression/ClangPersistentVariables.h"
 #include "lldb/Interpreter/Args.h"
 #include "lldb/Interpreter/NamedOptionValue.h"
@@ -81,6 +82,12 @@ public:
         return m_skip_prologue;
     }
 
+    bool
+    GetUseFastStepping()
+    {
+        return m_use_fast_stepping;
+    }
+
     PathMappingList &
     GetSourcePathMap ()
     {
@@ -224,6 +231,7 @@ protected:
     std::string m_expr_prefix_contents;
     int m_prefer_dynamic_value;
     OptionValueBoolean m_skip_prologue;
+    OptionValueBoolean m_use_fast_stepping;
     PathMappingList m_source_map;
     uint32_t m_max_children_display;
     uint32_t m_max_strlen_length;
@@ -279,6 +287,34 @@ public:
     static void
     SetDefaultArchitecture (const ArchSpec &arch);
 
+    //------------------------------------------------------------------
+    /// Get the directory in which symbol files cache their name
+    /// indexes. The returned file spec is empty if caching is disabled.
+    //------------------------------------------------------------------
+    static FileSpec
+    GetIndexCachePath ();
+
+    //------------------------------------------------------------------
+    /// Get the maximum size in bytes of the symbol index cache.
+    //------------------------------------------------------------------
+    static uint64_t
+    GetIndexCacheMaxSize ();
+
+    //------------------------------------------------------------------
+    /// Returns true if symbol files should index only the compile
+    /// units that the accelerator tables list for a name.
+    //------------------------------------------------------------------
+    static bool
+    GetUsePubnamesIndex ();
+
+    //------------------------------------------------------------------
+    /// Get the maximum size in bytes of the DIEs all symbol files keep
+    /// around after scanning them, before they start throwing away the
+    /// least recently used ones.
+    //------------------------------------------------------------------
+    static uint64_t
+    GetDIECacheMaxSize ();
+
     void
     UpdateInstanceName ();
 
@@ -289,7 +325,51 @@ public:
                      const ConstString *object_name = NULL,
                      off_t object_offset = 0,
                      Error *error_ptr = NULL);
+
+    //------------------------------------------------------------------
+    /// Get the shared modules for many files at once.
+    ///
+    /// The modules are found or created, and their section headers and
+    /// symbol tables parsed, on a pool of threads. They are then added
+    /// to the image list one by one in the order of \a file_specs.
+    ///
+    /// @param[in] file_specs
+    ///     The files to get modules for.
+    ///
+    /// @param[in] arch
+    ///     The architecture of the modules.
+    ///
+    /// @param[out] modules
+    ///     The module for each entry in \a file_specs, or an empty
+    ///     shared pointer if none could be found.
+    ///
+    /// @return
+    ///     The number of modules that were found.
+    //------------------------------------------------------------------
+    size_t
+    GetSharedModules (const FileSpecList &file_specs,
+                      const ArchSpec& arch,
+                      std::vector<lldb::ModuleSP> &modules);
+
+    //------------------------------------------------------------------
+    /// Find or create a shared module without adding it to the image
+    /// list. This may be called from several threads at once.
+    //------------------------------------------------------------------
+    Error
+    FindSharedModule (const FileSpec& file_spec,
+                      const ArchSpec& arch,
+                      const lldb_private::UUID *uuid_ptr,
+                      const ConstString *object_name,
+                      off_t object_offset,
+                      lldb::ModuleSP &module_sp,
+                      lldb::ModuleSP &old_module_sp,
+                      bool &did_create_module);
 private:
+    void
+    AddSharedModule (lldb::ModuleSP &module_sp,
+                     lldb::ModuleSP &old_module_sp,
+                     bool did_create_module);
+
     //------------------------------------------------------------------
     /// Construct with optional file and arch.
     ///
@@ -828,6 +908,12 @@ public:
         return m_persistent_variables;
     }
 
+    ClangExpressionCache &
+    GetExpressionCache()
+    {
+        return m_expression_cache;
+    }
+
     //------------------------------------------------------------------
     // Target Stop Hooks
     //------------------------------------------------------------------
@@ -1021,6 +1107,30 @@ public:
         {
             return m_default_architecture;
         }
+
+        const FileSpec &
+        GetIndexCachePath () const
+        {
+            return m_index_cache_path.GetCurrentValue();
+        }
+
+        uint32_t
+        GetIndexCacheMaxSize () const
+        {
+            return m_index_cache_max_size;
+        }
+
+        bool
+        GetUsePubnamesIndex () const
+        {
+            return m_use_pubnames_index;
+        }
+
+        uint32_t
+        GetDIECacheMaxSize () const
+        {
+            return m_die_cache_max_size;
+        }
     protected:
         
         lldb::InstanceSettingsSP
@@ -1030,6 +1140,10 @@ public:
         
         // Class-wide settings.
         ArchSpec m_default_architecture;
+        OptionValueFileSpec m_index_cache_path;
+        uint32_t m_index_cache_max_size;   // In megabytes
+        OptionValueBoolean m_use_pubnames_index;
+        uint32_t m_die_cache_max_size;     // In megabytes
         
         DISALLOW_COPY_AND_ASSIGN (SettingsController);
     };
@@ -1060,6 +1174,7 @@ protected:
     std::auto_ptr<ClangASTSource> m_scratch_ast_source_ap;
     std::auto_ptr<ClangASTImporter> m_ast_importer_ap;
     ClangPersistentVariables m_persistent_variables;      ///< These are the persistent variables associated with this process for the expression parser.
+    ClangExpressionCache m_expression_cache;              ///< JIT-compiled expressions that can run again in the same context.
 
     SourceManager m_source_manager;
 
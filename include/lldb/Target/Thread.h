@@ -69,6 +69,15 @@ public:
     static const ConstString &
     GetTraceThreadVarName ();
 
+    bool
+    GetFastUnwindEnabledState()
+    {
+        return m_fast_unwind_enabled;
+    }
+
+    static const ConstString &
+    GetFastUnwindVarName ();
+
 protected:
 
     void
@@ -82,6 +91,7 @@ private:
 
     std::auto_ptr<RegularExpression> m_avoid_regexp_ap;
     bool m_trace_enabled;
+    bool m_fast_unwind_enabled;
 };
 
 class Thread :
@@ -12,6 +12,8 @@
 
 #include <vector>
 
+#include "llvm/ADT/DenseMap.h"
+
 #include "lldb/lldb-private.h"
 #include "lldb/Host/Mutex.h"
 #include "lldb/Core/UserID.h"
@@ -113,12 +115,14 @@ public:
 protected:
 
     typedef std::vector<lldb::ThreadSP> collection;
+    typedef llvm::DenseMap<lldb::tid_t, uint32_t> tid_to_index_collection;
     //------------------------------------------------------------------
     // Classes that inherit from Process can see and modify these
     //------------------------------------------------------------------
     Process *m_process; ///< The process that manages this thread list.
     uint32_t m_stop_id; ///< The process stop ID that this thread list is valid for.
     collection m_threads; ///< The threads for this process.
+    tid_to_index_collection m_tid_to_index; ///< Maps thread IDs to their index in m_threads for constant time lookup.
     mutable Mutex m_threads_mutex;
     lldb::tid_t m_selected_tid;  ///< For targets that need the notion of a current thread.
 
@@ -42,6 +42,7 @@ public:
     virtual lldb::StateType GetPlanRunState ();
     virtual bool WillStop ();
     virtual bool MischiefManaged ();
+    virtual void WillPop ();
 
     void AddRange(const AddressRange &new_range);
 
@@ -52,7 +53,27 @@ protected:
     bool FrameIsOlder();
     bool InSymbol();
     void DumpRanges (Stream *s);
+
+    //------------------------------------------------------------------
+    /// Instead of single-stepping every instruction of the range, run
+    /// the thread to the next instruction that can leave it.
+    ///
+    /// If the pc isn't sitting on a branch, a call or a return, this sets
+    /// a thread-specific internal breakpoint on the next one in the
+    /// range, or at the end of the range if there is none, so the plan
+    /// can continue instead of stepping.  Only the branch itself is then
+    /// single-stepped.
+    ///
+    /// @return
+    ///     \b true if the breakpoint was set.
+    //------------------------------------------------------------------
+    bool SetNextBranchBreakpoint ();
+    void ClearNextBranchBreakpoint ();
+    bool NextRangeBreakpointExplainsStop (lldb::StopInfoSP stop_info_sp);
+    
+    InstructionList *GetInstructionsForAddress (lldb::addr_t addr, size_t &range_index, size_t &insn_offset);
     
+
     SymbolContext m_addr_context;
     std::vector<AddressRange> m_address_ranges;
     lldb::RunMode m_stop_others;
@@ -61,6 +82,8 @@ protected:
     bool m_no_more_plans;  // Need this one so we can tell if we stepped into a call, but can't continue,
                            // in which case we are done.
     bool m_first_run_event;  // We want to broadcast only one running event, our first.
+    std::vector<lldb::DisassemblerSP> m_instruction_ranges;  // The disassembly of m_address_ranges, filled in lazily.
+    lldb::BreakpointSP m_next_branch_bp_sp;
 
 private:
     DISALLOW_COPY_AND_ASSIGN (ThreadPlanStepRange);
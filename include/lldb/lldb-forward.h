@@ -92,6 +92,7 @@ class   InlineFunctionInfo;
 class   InputReader;
 class   InstanceSettings;
 class   Instruction;
+class   InstructionList;
 class   LanguageRuntime;
 class   LineTable;
 class   Listener;
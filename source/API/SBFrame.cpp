@@ -275,7 +275,9 @@ SBFrame::SetPC (addr_t new_pc)
     if (m_opaque_sp)
     {
         Mutex::Locker api_locker (m_opaque_sp->GetThread().GetProcess().GetTarget().GetAPIMutex());
-        ret_val = m_opaque_sp->GetRegisterContext()->SetPC (new_pc);
+        RegisterContextSP reg_ctx_sp (m_opaque_sp->GetRegisterContext());
+        if (reg_ctx_sp)
+            ret_val = reg_ctx_sp->SetPC (new_pc);
     }
 
     LogSP log(GetLogIfAllCategoriesSet (LIBLLDB_LOG_API));
@@ -293,7 +295,9 @@ SBFrame::GetSP () const
     if (m_opaque_sp)
     {
         Mutex::Locker api_locker (m_opaque_sp->GetThread().GetProcess().GetTarget().GetAPIMutex());
-        addr = m_opaque_sp->GetRegisterContext()->GetSP();
+        RegisterContextSP reg_ctx_sp (m_opaque_sp->GetRegisterContext());
+        if (reg_ctx_sp)
+            addr = reg_ctx_sp->GetSP();
     }
     LogSP log(GetLogIfAllCategoriesSet (LIBLLDB_LOG_API));
     if (log)
@@ -310,7 +314,9 @@ SBFrame::GetFP () const
     if (m_opaque_sp)
     {
         Mutex::Locker api_locker (m_opaque_sp->GetThread().GetProcess().GetTarget().GetAPIMutex());
-        addr = m_opaque_sp->GetRegisterContext()->GetFP();
+        RegisterContextSP reg_ctx_sp (m_opaque_sp->GetRegisterContext());
+        if (reg_ctx_sp)
+            addr = reg_ctx_sp->GetFP();
     }
 
     LogSP log(GetLogIfAllCategoriesSet (LIBLLDB_LOG_API));
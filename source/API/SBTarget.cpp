@@ -1138,7 +1138,11 @@ bool
 SBTarget::RemoveModule (lldb::SBModule module)
 {
     if (m_opaque_sp)
+    {
+        // Cached expressions may refer to the module's variables and functions.
+        m_opaque_sp->GetExpressionCache().Clear();
         return m_opaque_sp->GetImages().Remove(module.get_sp());
+    }
     return false;
 }
 
@@ -15,6 +15,7 @@
 // Project includes
 #include "lldb/Breakpoint/BreakpointLocation.h"
 #include "lldb/Core/Log.h"
+#include "lldb/Core/Module.h"
 #include "lldb/Core/StreamString.h"
 #include "lldb/lldb-private-log.h"
 
@@ -50,12 +51,40 @@ BreakpointResolverFileLine::SearchCallback
     Address *addr,
     bool containing
 )
+{
+    assert (m_breakpoint != NULL);
+
+    Module *module = context.module_sp.get();
+    if (module == NULL)
+        return Searcher::eCallbackReturnContinue;
+
+    // Let the symbol file tell us which compile units can contain the
+    // file so we don't parse the support files and line tables of all
+    // the others.
+    std::vector<uint32_t> cu_indexes;
+    if (!module->FindCompileUnitsForFile (m_file_spec, cu_indexes))
+    {
+        const uint32_t num_comp_units = module->GetNumCompileUnits();
+        for (uint32_t i = 0; i < num_comp_units; ++i)
+            cu_indexes.push_back (i);
+    }
+
+    const size_t num_cu_indexes = cu_indexes.size();
+    for (size_t i = 0; i < num_cu_indexes; ++i)
+    {
+        CompUnitSP cu_sp (module->GetCompileUnitAtIndex (cu_indexes[i]));
+        if (cu_sp && filter.CompUnitPasses (*cu_sp))
+            AddLocationsInCompileUnit (filter, cu_sp.get());
+    }
+    return Searcher::eCallbackReturnContinue;
+}
+
+void
+BreakpointResolverFileLine::AddLocationsInCompileUnit (SearchFilter &filter, CompileUnit *cu)
 {
     SymbolContextList sc_list;
     uint32_t sc_list_size;
-    CompileUnit *cu = context.comp_unit;
 
-    assert (m_breakpoint != NULL);
     LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_BREAKPOINTS));
 
     sc_list_size = cu->ResolveSymbolContext (m_file_spec, m_line_number, m_inlines, false, eSymbolContextEverything, sc_list);
@@ -109,13 +138,12 @@ BreakpointResolverFileLine::SearchCallback
 #endif
         }
     }
-    return Searcher::eCallbackReturnContinue;
 }
 
 Searcher::Depth
 BreakpointResolverFileLine::GetDepth()
 {
-    return Searcher::eDepthCompUnit;
+    return Searcher::eDepthModule;
 }
 
 void
@@ -506,6 +506,143 @@ public:
     }
 };
 
+//----------------------------------------------------------------------
+// A "log <name> < dump | reset >" command for the statistics kept by
+// some part of LLDB. The dump and reset callbacks do the actual work and
+// report an error if what they operate on isn't available.
+//----------------------------------------------------------------------
+class CommandObjectLogStatistics : public CommandObject
+{
+public:
+    typedef bool (*StatisticsCallback) (CommandInterpreter &interpreter,
+                                        CommandReturnObject &result);
+
+    //------------------------------------------------------------------
+    // Constructors and Destructors
+    //------------------------------------------------------------------
+    CommandObjectLogStatistics(CommandInterpreter &interpreter,
+                               const char *name,
+                               const char *help,
+                               const char *syntax,
+                               StatisticsCallback dump_callback,
+                               StatisticsCallback reset_callback) :
+        CommandObject (interpreter, name, help, syntax),
+        m_dump_callback (dump_callback),
+        m_reset_callback (reset_callback)
+    {
+    }
+
+    virtual
+    ~CommandObjectLogStatistics()
+    {
+    }
+
+    virtual bool
+    Execute (Args& args,
+             CommandReturnObject &result)
+    {
+        const size_t argc = args.GetArgumentCount();
+        result.SetStatus(eReturnStatusFailed);
+
+        if (argc == 1)
+        {
+            const char *sub_command = args.GetArgumentAtIndex(0);
+
+            if (strcasecmp(sub_command, "dump") == 0)
+            {
+                if (!m_dump_callback (m_interpreter, result))
+                    return false;
+                result.SetStatus(eReturnStatusSuccessFinishResult);
+            }
+            else if (strcasecmp(sub_command, "reset") == 0)
+            {
+                if (!m_reset_callback (m_interpreter, result))
+                    return false;
+                result.SetStatus(eReturnStatusSuccessFinishNoResult);
+            }
+        }
+        
+        if (!result.Succeeded())
+        {
+            result.AppendError("Missing subcommand");
+            result.AppendErrorWithFormat("Usage: %s\n", m_cmd_syntax.c_str());
+        }
+        return result.Succeeded();
+    }
+
+protected:
+    StatisticsCallback m_dump_callback;
+    StatisticsCallback m_reset_callback;
+};
+
+static bool
+DumpStringPoolStatistics (CommandInterpreter &interpreter, CommandReturnObject &result)
+{
+    ConstString::DumpStatistics (&result.GetOutputStream());
+    return true;
+}
+
+static bool
+ResetStringPoolStatistics (CommandInterpreter &interpreter, CommandReturnObject &result)
+{
+    ConstString::ResetStatistics ();
+    return true;
+}
+
+static bool
+DumpExpressionCacheStatistics (CommandInterpreter &interpreter, CommandReturnObject &result)
+{
+    Target *target = interpreter.GetDebugger().GetSelectedTarget().get();
+    if (target == NULL)
+    {
+        result.AppendError("invalid target, create a debug target using the 'target create' command");
+        return false;
+    }
+    target->GetExpressionCache().DumpStatistics (&result.GetOutputStream());
+    return true;
+}
+
+static bool
+ResetExpressionCacheStatistics (CommandInterpreter &interpreter, CommandReturnObject &result)
+{
+    Target *target = interpreter.GetDebugger().GetSelectedTarget().get();
+    if (target == NULL)
+    {
+        result.AppendError("invalid target, create a debug target using the 'target create' command");
+        return false;
+    }
+    target->GetExpressionCache().ResetStatistics ();
+    return true;
+}
+
+static bool
+DumpMemoryCacheStatistics (CommandInterpreter &interpreter, CommandReturnObject &result)
+{
+    Target *target = interpreter.GetDebugger().GetSelectedTarget().get();
+    Process *process = target ? target->GetProcessSP().get() : NULL;
+    if (process == NULL)
+    {
+        result.AppendError("invalid process");
+        return false;
+    }
+    process->GetMemoryCache().DumpStatistics (&result.GetOutputStream());
+    return true;
+}
+
+static bool
+ResetMemoryCacheStatistics (CommandInterpreter &interpreter, CommandReturnObject &result)
+{
+    Target *target = interpreter.GetDebugger().GetSelectedTarget().get();
+    Process *process = target ? target->GetProcessSP().get() : NULL;
+    if (process == NULL)
+    {
+        result.AppendError("invalid process");
+        return false;
+    }
+    process->GetMemoryCache().ResetStatistics ();
+    return true;
+}
+
 //----------------------------------------------------------------------
 // CommandObjectLog constructor
 //----------------------------------------------------------------------
@@ -519,6 +656,24 @@ CommandObjectLog::CommandObjectLog(CommandInterpreter &interpreter) :
     LoadSubCommand ("disable", CommandObjectSP (new CommandObjectLogDisable (interpreter)));
     LoadSubCommand ("list",    CommandObjectSP (new CommandObjectLogList (interpreter)));
     LoadSubCommand ("timers",  CommandObjectSP (new CommandObjectLogTimer (interpreter)));
+    LoadSubCommand ("string-pool", CommandObjectSP (new CommandObjectLogStatistics (interpreter,
+                                                                                    "log string-pool",
+                                                                                    "Dump and reset LLDB internal string pool lock contention counters.",
+                                                                                    "log string-pool < dump | reset >",
+                                                                                    DumpStringPoolStatistics,
+                                                                                    ResetStringPoolStatistics)));
+    LoadSubCommand ("expression-cache", CommandObjectSP (new CommandObjectLogStatistics (interpreter,
+                                                                                         "log expression-cache",
+                                                                                         "Dump and reset the hit and miss counters of the current target's cache of compiled expressions.",
+                                                                                         "log expression-cache < dump | reset >",
+                                                                                         DumpExpressionCacheStatistics,
+                                                                                         ResetExpressionCacheStatistics)));
+    LoadSubCommand ("memory-cache", CommandObjectSP (new CommandObjectLogStatistics (interpreter,
+                                                                                     "log memory-cache",
+                                                                                     "Dump and reset the hit, miss and fetch counters of the current process's memory cache.",
+                                                                                     "log memory-cache < dump | reset >",
+                                                                                     DumpMemoryCacheStatistics,
+                                                                                     ResetMemoryCacheStatistics)));
 }
 
 //----------------------------------------------------------------------
@@ -148,7 +148,8 @@ public:
                        NULL),
         m_option_group (interpreter),
         m_arch_option (),
-        m_platform_options(true) // Do include the "--platform" option in the platform settings by passing true
+        m_platform_options(true), // Do include the "--platform" option in the platform settings by passing true
+        m_core_file (LLDB_OPT_SET_1, false, "core-file", 'c', CommandCompletions::eDiskFileCompletion, eArgTypePath, "Fullpath to a core file to use for this target.")
     {
         CommandArgumentEntry arg;
         CommandArgumentData file_arg;
@@ -165,6 +166,7 @@ public:
         
         m_option_group.Append (&m_arch_option, LLDB_OPT_SET_ALL, LLDB_OPT_SET_1);
         m_option_group.Append (&m_platform_options, LLDB_OPT_SET_ALL, LLDB_OPT_SET_1);
+        m_option_group.Append (&m_core_file, LLDB_OPT_SET_ALL, LLDB_OPT_SET_1);
         m_option_group.Finalize();
     }
 
@@ -202,6 +204,28 @@ public:
             if (target_sp)
             {
                 debugger.GetTargetList().SetSelectedTarget(target_sp.get());
+                if (m_core_file.GetOptionValue().OptionWasSet())
+                {
+                    const FileSpec &core_file = m_core_file.GetOptionValue().GetCurrentValue();
+                    char core_path[PATH_MAX];
+                    core_file.GetPath (core_path, sizeof(core_path));
+
+                    // Core files are only handled by the "elf-core" process
+                    // plug-in, which doesn't get picked for live processes.
+                    ProcessSP process_sp (target_sp->CreateProcess (debugger.GetListener(), "elf-core"));
+                    if (process_sp)
+                        error = process_sp->LoadCore (core_file);
+                    else
+                        error.SetErrorString ("no process plug-in can load core files on this host");
+
+                    if (error.Fail())
+                    {
+                        result.AppendErrorWithFormat ("Unable to load core file '%s': %s\n", core_path, error.AsCString());
+                        result.SetStatus (eReturnStatusFailed);
+                        return false;
+                    }
+                    result.AppendMessageWithFormat ("Core file '%s' (%s) was loaded.\n", core_path, target_sp->GetArchitecture().GetArchitectureName());
+                }
                 result.AppendMessageWithFormat ("Current executable set to '%s' (%s).\n", file_path, target_sp->GetArchitecture().GetArchitectureName());
                 result.SetStatus (eReturnStatusSuccessFinishNoResult);
             }
@@ -247,6 +271,7 @@ private:
     OptionGroupOptions m_option_group;
     OptionGroupArchitecture m_arch_option;
     OptionGroupPlatform m_platform_options;
+    OptionGroupFile m_core_file;
 
 };
 
@@ -131,6 +131,11 @@ ConnectionFileDescriptor::Connect (const char *s, Error *error_ptr)
             // unix://SOCKNAME
             return NamedSocketAccept (s + strlen("unix-accept://"), error_ptr);
         }
+        else if (strstr(s, "unix-connect://"))
+        {
+            // unix-connect://SOCKNAME
+            return NamedSocketConnect (s + strlen("unix-connect://"), error_ptr);
+        }
         else if (strstr(s, "connect://"))
         {
             return ConnectTCP (s + strlen("connect://"), error_ptr);
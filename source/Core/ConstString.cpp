@@ -9,6 +9,7 @@
 #include "lldb/Core/ConstString.h"
 #include "lldb/Core/Stream.h"
 #include "lldb/Host/Mutex.h"
+#include "llvm/ADT/StringExtras.h"
 #include "llvm/ADT/StringMap.h"
 
 using namespace lldb_private;
@@ -20,15 +21,21 @@ public:
     typedef const char * StringPoolValueType;
     typedef llvm::StringMap<StringPoolValueType, llvm::BumpPtrAllocator> StringPool;
     typedef llvm::StringMapEntry<StringPoolValueType> StringPoolEntryType;
+
+    //------------------------------------------------------------------
+    // The pool is split into shards picked by the hash of a string, so
+    // threads interning different strings rarely wait on each other. A
+    // string always hashes to the same shard, so there is still only
+    // one copy of each string and pointer equality still works.
+    //------------------------------------------------------------------
+    enum { kNumShards = 64 };
     
     //------------------------------------------------------------------
     // Default constructor
     //
     // Initialize the member variables and create the empty string.
     //------------------------------------------------------------------
-    Pool () :
-        m_mutex (Mutex::eMutexTypeRecursive),
-        m_string_map ()
+    Pool ()
     {
     }
 
@@ -62,7 +69,14 @@ public:
     GetMangledCounterpart (const char *ccstr) const
     {
         if (ccstr)
-            return GetStringMapEntryFromKeyData (ccstr).getValue();
+        {
+            // Names are demangled on several threads at once, so the
+            // counterpart is only read and written with the lock of the
+            // shard its string lives in.
+            const StringPoolEntryType &entry = GetStringMapEntryFromKeyData (ccstr);
+            ShardLocker locker (GetShard (entry.getKey()));
+            return entry.getValue();
+        }
         return 0;
     }
 
@@ -71,8 +85,16 @@ public:
     {
         if (key_ccstr && value_ccstr)
         {
-            GetStringMapEntryFromKeyData (key_ccstr).setValue(value_ccstr);
-            GetStringMapEntryFromKeyData (value_ccstr).setValue(key_ccstr);
+            {
+                StringPoolEntryType &key_entry = GetStringMapEntryFromKeyData (key_ccstr);
+                ShardLocker locker (GetShard (key_entry.getKey()));
+                key_entry.setValue(value_ccstr);
+            }
+            {
+                StringPoolEntryType &value_entry = GetStringMapEntryFromKeyData (value_ccstr);
+                ShardLocker locker (GetShard (value_entry.getKey()));
+                value_entry.setValue(key_ccstr);
+            }
             return true;
         }
         return false;
@@ -91,9 +113,10 @@ public:
     {
         if (cstr)
         {
-            Mutex::Locker locker (m_mutex);
             llvm::StringRef string_ref (cstr, cstr_len);
-            StringPoolEntryType& entry = m_string_map.GetOrCreateValue (string_ref, (StringPoolValueType)NULL);
+            Shard &shard = GetShard (string_ref);
+            ShardLocker locker (shard);
+            StringPoolEntryType& entry = shard.m_string_map.GetOrCreateValue (string_ref, (StringPoolValueType)NULL);
             return entry.getKeyData();
         }
         return NULL;
@@ -104,15 +127,25 @@ public:
     {
         if (demangled_cstr)
         {
-            Mutex::Locker locker (m_mutex);
-            // Make string pool entry with the mangled counterpart already set
-            StringPoolEntryType& entry = m_string_map.GetOrCreateValue (llvm::StringRef (demangled_cstr), mangled_ccstr);
-
-            // Extract the const version of the demangled_cstr
-            const char *demangled_ccstr = entry.getKeyData();
-            // Now assign the demangled const string as the counterpart of the
-            // mangled const string...
-            GetStringMapEntryFromKeyData (mangled_ccstr).setValue(demangled_ccstr);
+            const char *demangled_ccstr = NULL;
+            {
+                llvm::StringRef string_ref (demangled_cstr);
+                Shard &shard = GetShard (string_ref);
+                ShardLocker locker (shard);
+                // Make string pool entry with the mangled counterpart already set
+                StringPoolEntryType& entry = shard.m_string_map.GetOrCreateValue (string_ref, mangled_ccstr);
+
+                // Extract the const version of the demangled_cstr
+                demangled_ccstr = entry.getKeyData();
+            }
+            {
+                // Now assign the demangled const string as the counterpart of the
+                // mangled const string while holding the lock of the shard the
+                // mangled string lives in.
+                StringPoolEntryType &mangled_entry = GetStringMapEntryFromKeyData (mangled_ccstr);
+                ShardLocker locker (GetShard (mangled_entry.getKey()));
+                mangled_entry.setValue(demangled_ccstr);
+            }
             // Return the constant demangled C string
             return demangled_ccstr;
         }
@@ -138,16 +171,64 @@ public:
     size_t
     MemorySize() const
     {
-        Mutex::Locker locker (m_mutex);
         size_t mem_size = sizeof(Pool);
-        const_iterator end = m_string_map.end();
-        for (const_iterator pos = m_string_map.begin(); pos != end; ++pos)
+        for (size_t i = 0; i < kNumShards; ++i)
         {
-            mem_size += sizeof(StringPoolEntryType) + pos->getKey().size();
+            const Shard &shard = m_shards[i];
+            ShardLocker locker (shard);
+            const_iterator end = shard.m_string_map.end();
+            for (const_iterator pos = shard.m_string_map.begin(); pos != end; ++pos)
+            {
+                mem_size += sizeof(StringPoolEntryType) + pos->getKey().size();
+            }
         }
         return mem_size;
     }
 
+    void
+    DumpStatistics (Stream *s) const
+    {
+        uint64_t total_strings = 0;
+        uint64_t total_lookups = 0;
+        uint64_t total_contended = 0;
+        s->Printf ("shard  strings    lookups    contended\n");
+        s->Printf ("-----  ---------- ---------- ----------\n");
+        for (size_t i = 0; i < kNumShards; ++i)
+        {
+            const Shard &shard = m_shards[i];
+            uint64_t num_strings;
+            uint64_t num_lookups;
+            uint64_t num_contended;
+            {
+                ShardLocker locker (shard);
+                num_strings = shard.m_string_map.getNumItems();
+                num_lookups = shard.m_num_lookups;
+                num_contended = shard.m_num_contended;
+            }
+            s->Printf ("%5u  %10llu %10llu %10llu\n", (uint32_t)i, num_strings, num_lookups, num_contended);
+            total_strings += num_strings;
+            total_lookups += num_lookups;
+            total_contended += num_contended;
+        }
+        s->Printf ("total  %10llu %10llu %10llu (%.2f%% of lookups waited for a lock)\n",
+                   total_strings,
+                   total_lookups,
+                   total_contended,
+                   total_lookups ? (100.0 * total_contended) / total_lookups : 0.0);
+    }
+
+    void
+    ResetStatistics ()
+    {
+        for (size_t i = 0; i < kNumShards; ++i)
+        {
+            Shard &shard = m_shards[i];
+            ShardLocker locker (shard);
+            shard.m_num_lookups = 0;
+            shard.m_num_contended = 0;
+        }
+    }
+
 protected:
     //------------------------------------------------------------------
     // Typedefs
@@ -155,11 +236,66 @@ protected:
     typedef StringPool::iterator iterator;
     typedef StringPool::const_iterator const_iterator;
 
+    struct Shard
+    {
+        Shard () :
+            m_mutex (Mutex::eMutexTypeNormal),
+            m_string_map (),
+            m_num_lookups (0),
+            m_num_contended (0)
+        {
+        }
+
+        mutable Mutex m_mutex;
+        StringPool m_string_map;
+        mutable uint64_t m_num_lookups;     // Number of times the lock was taken
+        mutable uint64_t m_num_contended;   // Number of times the lock was already held by another thread
+    };
+
+    //------------------------------------------------------------------
+    // Locks a shard and counts whether another thread held the lock.
+    //------------------------------------------------------------------
+    class ShardLocker
+    {
+    public:
+        ShardLocker (const Shard &shard) :
+            m_shard (shard)
+        {
+            const bool contended = m_shard.m_mutex.TryLock() != 0;
+            if (contended)
+                m_shard.m_mutex.Lock();
+            ++m_shard.m_num_lookups;
+            if (contended)
+                ++m_shard.m_num_contended;
+        }
+
+        ~ShardLocker ()
+        {
+            m_shard.m_mutex.Unlock();
+        }
+
+    private:
+        const Shard &m_shard;
+    };
+
+    Shard &
+    GetShard (llvm::StringRef string_ref)
+    {
+        // The string map uses the low bits of the same hash to pick a
+        // bucket, so use the high bits to pick the shard.
+        return m_shards[(llvm::HashString (string_ref) >> 26) % kNumShards];
+    }
+
+    const Shard &
+    GetShard (llvm::StringRef string_ref) const
+    {
+        return m_shards[(llvm::HashString (string_ref) >> 26) % kNumShards];
+    }
+
     //------------------------------------------------------------------
     // Member variables
     //------------------------------------------------------------------
-    mutable Mutex m_mutex;
-    StringPool m_string_map;
+    Shard m_shards[kNumShards];
 };
 
 //----------------------------------------------------------------------
@@ -294,3 +430,15 @@ ConstString::StaticMemorySize()
     // Get the size of the static string pool
     return StringPool().MemorySize();
 }
+
+void
+ConstString::DumpStatistics (Stream *s)
+{
+    StringPool().DumpStatistics (s);
+}
+
+void
+ConstString::ResetStatistics ()
+{
+    StringPool().ResetStatistics ();
+}
@@ -1158,6 +1158,37 @@ DataExtractor::PeekCStr (uint32_t offset) const
     return NULL;
 }
 
+//----------------------------------------------------------------------
+// Decode a LEB128 number of up to 8 bytes a whole 64 bit word at a time
+// instead of byte by byte. "src" must have at least 8 readable bytes.
+//
+// Returns the number of bytes in the LEB128 number and its value with
+// the 7 bit groups packed together, or zero if the number is longer
+// than 8 bytes.
+//----------------------------------------------------------------------
+static inline uint32_t
+DecodeLEB128Word (const uint8_t *src, uint64_t &value)
+{
+    uint64_t word;
+    memcpy (&word, src, sizeof(word));
+    if (lldb::endian::InlHostByteOrder() != eByteOrderLittle)
+        word = llvm::ByteSwap_64 (word);
+
+    // The number ends at the first byte with its high bit clear
+    const uint64_t stop_bits = ~word & 0x8080808080808080ull;
+    if (stop_bits == 0)
+        return 0;
+
+    // Mask off everything after the last byte and the continuation bits,
+    // then squeeze out the gaps the continuation bits leave behind.
+    word &= (stop_bits ^ (stop_bits - 1)) & 0x7f7f7f7f7f7f7f7full;
+    word = (word & 0x007f007f007f007full) | ((word & 0x7f007f007f007f00ull) >> 1);
+    word = (word & 0x00003fff00003fffull) | ((word & 0x3fff00003fff0000ull) >> 2);
+    word = (word & 0x000000000fffffffull) | ((word & 0x0fffffff00000000ull) >> 4);
+    value = word;
+    return (llvm::CountTrailingZeros_64 (stop_bits) >> 3) + 1;
+}
+
 //----------------------------------------------------------------------
 // Extracts an unsigned LEB128 number from this object's data
 // starting at the offset pointed to by "offset_ptr". The offset
@@ -1177,12 +1208,23 @@ DataExtractor::GetULEB128 (uint32_t *offset_ptr) const
         uint64_t result = *src++;
         if (result >= 0x80)
         {
+            if (end - src >= 7)
+            {
+                const uint32_t byte_count = DecodeLEB128Word (src - 1, result);
+                if (byte_count)
+                {
+                    *offset_ptr += byte_count;
+                    return result;
+                }
+                result = *(src - 1);
+            }
+
             result &= 0x7f;
             int shift = 7;
             while (src < end)
             {
                 uint8_t byte = *src++;
-                result |= (byte & 0x7f) << shift;
+                result |= (uint64_t)(byte & 0x7f) << shift;
                 if ((byte & 0x80) == 0)
                     break;
                 shift += 7;
@@ -1211,9 +1253,24 @@ DataExtractor::GetSLEB128 (uint32_t *offset_ptr) const
     if ( m_start < m_end )
     {
         int shift = 0;
-        int size = sizeof (uint32_t) * 8;
+        int size = sizeof (int64_t) * 8;
         const uint8_t *src = m_start + *offset_ptr;
 
+        if (m_end - src >= 8)
+        {
+            uint64_t value;
+            const uint32_t byte_count = DecodeLEB128Word (src, value);
+            if (byte_count)
+            {
+                shift = byte_count * 7;
+                // Sign bit is the high bit of the last 7 bit group
+                if (value & (1ull << (shift - 1)))
+                    value |= UINT64_MAX << shift;
+                *offset_ptr += byte_count;
+                return (int64_t)value;
+            }
+        }
+
         uint8_t byte = 0;
         int bytecount = 0;
 
@@ -1221,7 +1278,8 @@ DataExtractor::GetSLEB128 (uint32_t *offset_ptr) const
         {
             bytecount++;
             byte = *src++;
-            result |= (byte & 0x7f) << shift;
+            if (shift < size)
+                result |= (int64_t)(byte & 0x7f) << shift;
             shift += 7;
             if ((byte & 0x80) == 0)
                 break;
@@ -1229,7 +1287,7 @@ DataExtractor::GetSLEB128 (uint32_t *offset_ptr) const
 
         // Sign bit of byte is 2nd high order bit (0x40)
         if (shift < size && (byte & 0x40))
-            result |= - (1 << shift);
+            result |= - ((int64_t)1 << shift);
 
         *offset_ptr += bytecount;
     }
@@ -1253,8 +1311,28 @@ DataExtractor::Skip_LEB128 (uint32_t *offset_ptr) const
         const uint8_t *start = m_start + *offset_ptr;
         const uint8_t *src = start;
 
+        // Find the last byte of the number a word at a time
+        while (m_end - src >= 8)
+        {
+            uint64_t word;
+            memcpy (&word, src, sizeof(word));
+            if (lldb::endian::InlHostByteOrder() != eByteOrderLittle)
+                word = llvm::ByteSwap_64 (word);
+            const uint64_t stop_bits = ~word & 0x8080808080808080ull;
+            if (stop_bits)
+            {
+                src += llvm::CountTrailingZeros_64 (stop_bits) >> 3;
+                *offset_ptr += src - start + 1;
+                return src - start;
+            }
+            src += 8;
+        }
+
         while ((src < m_end) && (*src++ & 0x80))
-            ++bytes_consumed;
+            ;
+        bytes_consumed = src - start;
+        if (bytes_consumed && (*(src - 1) & 0x80) == 0)
+            --bytes_consumed;
 
         *offset_ptr += src - start;
     }
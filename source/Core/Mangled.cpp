@@ -178,6 +178,257 @@ Mangled::GetDemangledName () const
     return m_demangled;
 }
 
+//----------------------------------------------------------------------
+// Operator names from the Itanium C++ ABI along with what the demangler
+// prints for them.
+//----------------------------------------------------------------------
+static const struct
+{
+    char code[3];
+    const char *name;
+} g_operator_names[] =
+{
+    { "nw", "operator new"      },
+    { "na", "operator new[]"    },
+    { "dl", "operator delete"   },
+    { "da", "operator delete[]" },
+    { "ps", "operator+"         },
+    { "ng", "operator-"         },
+    { "ad", "operator&"         },
+    { "de", "operator*"         },
+    { "co", "operator~"         },
+    { "pl", "operator+"         },
+    { "mi", "operator-"         },
+    { "ml", "operator*"         },
+    { "dv", "operator/"         },
+    { "rm", "operator%"         },
+    { "an", "operator&"         },
+    { "or", "operator|"         },
+    { "eo", "operator^"         },
+    { "aS", "operator="         },
+    { "pL", "operator+="        },
+    { "mI", "operator-="        },
+    { "mL", "operator*="        },
+    { "dV", "operator/="        },
+    { "rM", "operator%="        },
+    { "aN", "operator&="        },
+    { "oR", "operator|="        },
+    { "eO", "operator^="        },
+    { "ls", "operator<<"        },
+    { "rs", "operator>>"        },
+    { "lS", "operator<<="       },
+    { "rS", "operator>>="       },
+    { "eq", "operator=="        },
+    { "ne", "operator!="        },
+    { "lt", "operator<"         },
+    { "gt", "operator>"         },
+    { "le", "operator<="        },
+    { "ge", "operator>="        },
+    { "nt", "operator!"         },
+    { "aa", "operator&&"        },
+    { "oo", "operator||"        },
+    { "pp", "operator++"        },
+    { "mm", "operator--"        },
+    { "cm", "operator,"         },
+    { "pm", "operator->*"       },
+    { "pt", "operator->"        },
+    { "cl", "operator()"        },
+    { "ix", "operator[]"        }
+};
+
+namespace {
+
+    // Appends name components to a fixed size buffer, remembering where
+    // the last one starts.
+    class QualifiedNameBuilder
+    {
+    public:
+        QualifiedNameBuilder (char *dst, size_t dst_len) :
+            m_dst (dst),
+            m_dst_len (dst_len),
+            m_pos (0),
+            m_basename_offset (0),
+            m_basename_len (0)
+        {
+        }
+
+        bool
+        AppendComponent (const char *prefix, const char *name, size_t name_len)
+        {
+            const size_t prefix_len = strlen (prefix);
+            const size_t sep_len = m_pos > 0 ? 2 : 0;
+            if (m_pos + sep_len + prefix_len + name_len >= m_dst_len)
+                return false;
+            if (sep_len)
+            {
+                m_dst[m_pos++] = ':';
+                m_dst[m_pos++] = ':';
+            }
+            m_basename_offset = m_pos;
+            memcpy (m_dst + m_pos, prefix, prefix_len);
+            m_pos += prefix_len;
+            memcpy (m_dst + m_pos, name, name_len);
+            m_pos += name_len;
+            m_basename_len = m_pos - m_basename_offset;
+            m_dst[m_pos] = '\0';
+            return true;
+        }
+
+        // Constructors and destructors are named after the enclosing
+        // class, which is the last component appended so far.
+        bool
+        AppendStructor (const char *prefix)
+        {
+            if (m_pos == 0 || m_dst[m_basename_offset] == '~')
+                return false;
+            const size_t class_offset = m_basename_offset;
+            const size_t class_len = m_basename_len;
+            const size_t prefix_len = strlen (prefix);
+            if (m_pos + 2 + prefix_len + class_len >= m_dst_len)
+                return false;
+            m_dst[m_pos++] = ':';
+            m_dst[m_pos++] = ':';
+            m_basename_offset = m_pos;
+            memcpy (m_dst + m_pos, prefix, prefix_len);
+            m_pos += prefix_len;
+            memmove (m_dst + m_pos, m_dst + class_offset, class_len);
+            m_pos += class_len;
+            m_basename_len = m_pos - m_basename_offset;
+            m_dst[m_pos] = '\0';
+            return true;
+        }
+
+        size_t
+        GetBasenameOffset () const
+        {
+            return m_basename_offset;
+        }
+
+        bool
+        IsEmpty () const
+        {
+            return m_pos == 0;
+        }
+
+    private:
+        char *m_dst;
+        size_t m_dst_len;
+        size_t m_pos;
+        size_t m_basename_offset;
+        size_t m_basename_len;
+    };
+
+}
+
+//----------------------------------------------------------------------
+// Parse one <unqualified-name> at "p" and append it to "builder".
+// Returns a pointer past the component or NULL if it isn't one of the
+// forms we handle.
+//----------------------------------------------------------------------
+static const char *
+ExtractUnqualifiedName (const char *p, QualifiedNameBuilder &builder)
+{
+    if (isdigit (*p))
+    {
+        // <source-name> ::= <positive length number> <identifier>
+        size_t len = 0;
+        while (isdigit (*p))
+            len = len * 10 + (*p++ - '0');
+        if (len == 0 || strnlen (p, len) < len)
+            return NULL;
+        // The demangler prints anonymous namespaces as
+        // "(anonymous namespace)", let it handle those.
+        if (len >= 10 && strncmp (p, "_GLOBAL__N", 10) == 0)
+            return NULL;
+        if (!builder.AppendComponent ("", p, len))
+            return NULL;
+        return p + len;
+    }
+
+    if (p[0] == 'C' && (p[1] == '1' || p[1] == '2' || p[1] == '3'))
+        return builder.AppendStructor ("") ? p + 2 : NULL;
+
+    if (p[0] == 'D' && (p[1] == '0' || p[1] == '1' || p[1] == '2'))
+        return builder.AppendStructor ("~") ? p + 2 : NULL;
+
+    if (islower (p[0]) && p[1])
+    {
+        for (size_t i = 0; i < sizeof(g_operator_names)/sizeof(g_operator_names[0]); ++i)
+        {
+            if (p[0] == g_operator_names[i].code[0] && p[1] == g_operator_names[i].code[1])
+            {
+                const char *name = g_operator_names[i].name;
+                if (!builder.AppendComponent ("", name, strlen (name)))
+                    return NULL;
+                return p + 2;
+            }
+        }
+    }
+    return NULL;
+}
+
+bool
+Mangled::ExtractQualifiedName (const char *mangled,
+                               char *dst,
+                               size_t dst_len,
+                               size_t &basename_offset,
+                               bool &is_demangled_name)
+{
+    if (mangled == NULL || mangled[0] != '_' || mangled[1] != 'Z' || dst_len == 0)
+        return false;
+
+    QualifiedNameBuilder builder (dst, dst_len);
+    const char *p = mangled + 2;
+
+    if (*p == 'N')
+    {
+        // <nested-name> ::= N [<CV-qualifiers>] [<ref-qualifier>] <prefix> <unqualified-name> E
+        ++p;
+        while (*p == 'r' || *p == 'V' || *p == 'K')
+            ++p;
+        if (*p == 'R' || *p == 'O')
+            ++p;
+        if (p[0] == 'S' && p[1] == 't')
+        {
+            if (!builder.AppendComponent ("", "std", 3))
+                return false;
+            p += 2;
+        }
+        while (*p != 'E')
+        {
+            p = ExtractUnqualifiedName (p, builder);
+            if (p == NULL)
+                return false;
+        }
+        ++p;
+    }
+    else
+    {
+        // <unscoped-name> ::= [L] <unqualified-name>
+        //                 ::= St <unqualified-name>
+        if (*p == 'L')
+            ++p;
+        else if (p[0] == 'S' && p[1] == 't')
+        {
+            if (!builder.AppendComponent ("", "std", 3))
+                return false;
+            p += 2;
+        }
+        p = ExtractUnqualifiedName (p, builder);
+        if (p == NULL)
+            return false;
+    }
+
+    if (builder.IsEmpty())
+        return false;
+
+    // Anything left is a parameter list or a clone suffix which the
+    // demangler would print.
+    basename_offset = builder.GetBasenameOffset();
+    is_demangled_name = *p == '\0';
+    return true;
+}
+
 
 bool
 Mangled::NameMatches (const RegularExpression& regex) const
@@ -360,6 +360,15 @@ Module::ResolveSymbolContextsForFileSpec (const FileSpec &file_spec, uint32_t li
     return sc_list.GetSize() - initial_count;
 }
 
+bool
+Module::FindCompileUnitsForFile (const FileSpec &file_spec, std::vector<uint32_t> &cu_indexes)
+{
+    SymbolVendor *symbols = GetSymbolVendor ();
+    if (symbols)
+        return symbols->FindCompileUnitsForFile (file_spec, cu_indexes);
+    return false;
+}
+
 
 uint32_t
 Module::FindGlobalVariables(const ConstString &name, const ClangNamespaceDecl *namespace_decl, bool append, uint32_t max_matches, VariableList& variables)
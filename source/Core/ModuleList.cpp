@@ -834,6 +834,11 @@ ModuleList::GetSharedModule
             return error;
         else
         {
+            // Opening the object file maps it and parses its header. Don't
+            // make threads getting other modules wait for that, we check
+            // whether someone else created the same module in the meantime
+            // once we hold the lock again.
+            locker.Reset();
 #if defined ENABLE_MODULE_SP_LOGGING
             ModuleSP logging_module_sp (new Module (in_file_spec, arch, object_name_ptr, object_offset), ModuleSharedPtrLogger, (void *)ConstString("a.out").GetCString());
             module_sp = logging_module_sp;
@@ -843,7 +848,10 @@ ModuleList::GetSharedModule
             // Make sure there are a module and an object file since we can specify
             // a valid file path with an architecture that might not be in that file.
             // By getting the object file we can guarantee that the architecture matches
-            if (module_sp && module_sp->GetObjectFile())
+            const bool has_object_file = module_sp && module_sp->GetObjectFile();
+            locker.Reset (shared_module_list.m_modules_mutex.GetMutex());
+
+            if (has_object_file)
             {
                 // If we get in here we got the correct arch, now we just need
                 // to verify the UUID if one was given
@@ -851,6 +859,15 @@ ModuleList::GetSharedModule
                     module_sp.reset();
                 else
                 {
+                    ModuleList matching_module_list;
+                    if (always_create == false &&
+                        shared_module_list.FindModules (&in_file_spec, &arch, &module_sp->GetUUID(), object_name_ptr, matching_module_list) > 0)
+                    {
+                        // Another thread beat us to it, use its module.
+                        module_sp = matching_module_list.GetModuleAtIndex(0);
+                        return error;
+                    }
+
                     if (did_create_ptr)
                         *did_create_ptr = true;
                     
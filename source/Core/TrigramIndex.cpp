@@ -0,0 +1,264 @@
+//===-- TrigramIndex.cpp ----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Core/TrigramIndex.h"
+
+// C Includes
+#include <regex.h>
+#include <string.h>
+
+// C++ Includes
+#include <algorithm>
+
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Core/RegularExpression.h"
+
+using namespace lldb_private;
+
+static inline uint32_t
+MakeTrigram (const char *s)
+{
+    return ((uint32_t)(uint8_t)s[0] << 16) |
+           ((uint32_t)(uint8_t)s[1] << 8)  |
+            (uint32_t)(uint8_t)s[2];
+}
+
+TrigramIndex::TrigramIndex () :
+    m_trigrams (),
+    m_finalized (false)
+{
+}
+
+TrigramIndex::~TrigramIndex ()
+{
+}
+
+void
+TrigramIndex::Clear ()
+{
+    m_trigrams.clear();
+    m_finalized = false;
+}
+
+void
+TrigramIndex::Append (uint32_t id, const char *name)
+{
+    if (name == NULL)
+        return;
+
+    const size_t len = strlen (name);
+    for (size_t i = 0; i + 3 <= len; ++i)
+    {
+        IDList &ids = m_trigrams[MakeTrigram (name + i)];
+        // Names are added in increasing order of id, so a repeated
+        // trigram always shows up at the end of the list.
+        if (ids.empty() || ids.back() != id)
+            ids.push_back (id);
+    }
+}
+
+void
+TrigramIndex::Finalize ()
+{
+    for (TrigramMap::iterator pos = m_trigrams.begin(), end = m_trigrams.end(); pos != end; ++pos)
+    {
+        IDList &ids = pos->second;
+        if (ids.capacity() > ids.size())
+            IDList (ids.begin(), ids.end()).swap (ids);
+    }
+    m_finalized = true;
+}
+
+bool
+TrigramIndex::GetCandidates (const RegularExpression &regex, std::vector<uint32_t> &ids) const
+{
+    ids.clear();
+
+    std::vector<std::string> literals;
+    if (!GetRequiredLiterals (regex.GetText(), regex.GetCompileFlags(), literals))
+        return false;
+
+    // Collect the posting lists of every trigram and intersect them
+    // starting with the shortest.
+    std::vector<const IDList *> lists;
+    for (size_t i = 0; i < literals.size(); ++i)
+    {
+        const std::string &literal = literals[i];
+        for (size_t j = 0; j + 3 <= literal.size(); ++j)
+        {
+            TrigramMap::const_iterator pos = m_trigrams.find (MakeTrigram (literal.data() + j));
+            if (pos == m_trigrams.end())
+                return true;
+            lists.push_back (&pos->second);
+        }
+    }
+
+    if (lists.empty())
+        return false;
+
+    const IDList *shortest = lists[0];
+    for (size_t i = 1; i < lists.size(); ++i)
+    {
+        if (lists[i]->size() < shortest->size())
+            shortest = lists[i];
+    }
+    ids = *shortest;
+
+    std::vector<uint32_t> intersection;
+    for (size_t i = 0; i < lists.size() && !ids.empty(); ++i)
+    {
+        if (lists[i] == shortest)
+            continue;
+        intersection.clear();
+        std::set_intersection (ids.begin(), ids.end(),
+                               lists[i]->begin(), lists[i]->end(),
+                               std::back_inserter (intersection));
+        ids.swap (intersection);
+    }
+    return true;
+}
+
+bool
+TrigramIndex::GetRequiredLiterals (const char *regex, int compile_flags, std::vector<std::string> &literals)
+{
+    literals.clear();
+
+    // Basic regular expressions give different meanings to most of the
+    // special characters, and case insensitive matching would need a
+    // folded index. Don't try to be clever with either.
+    if (regex == NULL || (compile_flags & REG_EXTENDED) == 0 || (compile_flags & REG_ICASE) != 0)
+        return false;
+
+    std::string literal;
+    const char *p = regex;
+    while (*p)
+    {
+        switch (*p)
+        {
+        case '|':
+            // With an alternation, nothing is required in every match.
+            literals.clear();
+            return false;
+
+        case '\\':
+            if (p[1] && strchr (".[](){}*+?|^$\\", p[1]))
+            {
+                literal += p[1];
+                p += 2;
+            }
+            else
+            {
+                // Character classes and anchors like "\w" and "\<".
+                if (literal.size() >= 3)
+                    literals.push_back (literal);
+                literal.clear();
+                p += p[1] ? 2 : 1;
+            }
+            break;
+
+        case '[':
+            if (literal.size() >= 3)
+                literals.push_back (literal);
+            literal.clear();
+            ++p;
+            if (*p == '^')
+                ++p;
+            if (*p == ']')
+                ++p;
+            while (*p && *p != ']')
+            {
+                if (p[0] == '[' && (p[1] == ':' || p[1] == '.' || p[1] == '='))
+                {
+                    const char terminator[3] = { p[1], ']', '\0' };
+                    const char *class_end = strstr (p + 2, terminator);
+                    if (class_end == NULL)
+                        return false;
+                    p = class_end + 2;
+                }
+                else
+                    ++p;
+            }
+            if (*p)
+                ++p;
+            break;
+
+        case '(':
+            {
+                // Skip the whole group, it may be optional or repeated.
+                if (literal.size() >= 3)
+                    literals.push_back (literal);
+                literal.clear();
+                uint32_t depth = 0;
+                for (; *p; ++p)
+                {
+                    if (*p == '\\' && p[1])
+                        ++p;
+                    else if (*p == '[')
+                        return false; // A ')' could hide in there
+                    else if (*p == '(')
+                        ++depth;
+                    else if (*p == ')' && --depth == 0)
+                        break;
+                }
+                if (*p)
+                    ++p;
+            }
+            break;
+
+        case '*':
+        case '?':
+        case '{':
+        case '+':
+            {
+                // Only "+" keeps the previous character required, and
+                // even then the literal can't continue past it since it
+                // may repeat.
+                bool optional = false;
+                while (*p == '*' || *p == '?' || *p == '{' || *p == '+')
+                {
+                    if (*p != '+')
+                        optional = true;
+                    if (*p == '{')
+                    {
+                        while (*p && *p != '}')
+                            ++p;
+                    }
+                    if (*p)
+                        ++p;
+                }
+                if (optional && !literal.empty())
+                    literal.erase (literal.size() - 1);
+                if (literal.size() >= 3)
+                    literals.push_back (literal);
+                literal.clear();
+            }
+            break;
+
+        case '.':
+        case '^':
+        case '$':
+        case ')':
+            if (literal.size() >= 3)
+                literals.push_back (literal);
+            literal.clear();
+            ++p;
+            break;
+
+        default:
+            literal += *p;
+            ++p;
+            break;
+        }
+    }
+    if (literal.size() >= 3)
+        literals.push_back (literal);
+
+    return !literals.empty();
+}
@@ -0,0 +1,230 @@
+//===-- ClangExpressionCache.cpp --------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "lldb/Expression/ClangExpressionCache.h"
+
+// C Includes
+// C++ Includes
+// Other libraries and framework includes
+// Project includes
+#include "lldb/Core/Log.h"
+#include "lldb/Core/Module.h"
+#include "lldb/Core/Stream.h"
+#include "lldb/Expression/ClangUserExpression.h"
+#include "lldb/Symbol/Block.h"
+#include "lldb/Symbol/Function.h"
+#include "lldb/Symbol/SymbolContext.h"
+#include "lldb/Target/ExecutionContext.h"
+#include "lldb/Target/StackFrame.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+// Every cached expression keeps its JIT-compiled code and its argument
+// struct layout alive in the process, so don't let the cache grow
+// without bounds.
+static const size_t g_max_cached_expressions = 256;
+
+bool
+ClangExpressionCache::Key::operator < (const Key &rhs) const
+{
+    if (m_decl_context != rhs.m_decl_context)
+        return m_decl_context < rhs.m_decl_context;
+    if (m_language != rhs.m_language)
+        return m_language < rhs.m_language;
+    if (m_desired_type != rhs.m_desired_type)
+        return m_desired_type < rhs.m_desired_type;
+    int cmp = m_expr_text.compare (rhs.m_expr_text);
+    if (cmp != 0)
+        return cmp < 0;
+    return m_expr_prefix < rhs.m_expr_prefix;
+}
+
+ClangExpressionCache::ClangExpressionCache () :
+    m_mutex (Mutex::eMutexTypeRecursive),
+    m_expressions (),
+    m_key_to_entry (),
+    m_num_hits (0),
+    m_num_misses (0),
+    m_num_evictions (0),
+    m_num_invalidations (0)
+{
+}
+
+ClangExpressionCache::~ClangExpressionCache ()
+{
+}
+
+bool
+ClangExpressionCache::GetDeclContext (ExecutionContext &exe_ctx,
+                                      const void *&decl_context,
+                                      lldb::ModuleSP &module_sp)
+{
+    decl_context = NULL;
+    module_sp.reset();
+
+    StackFrame *frame = exe_ctx.GetFramePtr();
+    if (frame == NULL)
+    {
+        // Without a frame the expression parser looks at the first frame
+        // of the thread, which changes whenever the thread runs.
+        return exe_ctx.GetThreadPtr() == NULL;
+    }
+
+    const SymbolContext &sc (frame->GetSymbolContext (eSymbolContextModule | eSymbolContextFunction | eSymbolContextBlock | eSymbolContextSymbol));
+    if (sc.block)
+        decl_context = sc.block;
+    else if (sc.function)
+        decl_context = sc.function;
+    else
+        decl_context = sc.symbol;
+    if (decl_context)
+        module_sp = sc.module_sp;
+    return true;
+}
+
+void
+ClangExpressionCache::MakeKey (const char *expr_cstr,
+                               const char *expr_prefix,
+                               lldb::LanguageType language,
+                               uint32_t desired_type,
+                               const void *decl_context,
+                               Key &key)
+{
+    key.m_expr_text = expr_cstr;
+    if (expr_prefix)
+        key.m_expr_prefix = expr_prefix;
+    key.m_language = language;
+    key.m_desired_type = desired_type;
+    key.m_decl_context = decl_context;
+}
+
+ClangExpressionCache::ClangUserExpressionSP
+ClangExpressionCache::Take (const char *expr_cstr,
+                            const char *expr_prefix,
+                            lldb::LanguageType language,
+                            uint32_t desired_type,
+                            const void *decl_context)
+{
+    ClangUserExpressionSP expr_sp;
+    if (expr_cstr == NULL)
+        return expr_sp;
+
+    Key key;
+    MakeKey (expr_cstr, expr_prefix, language, desired_type, decl_context, key);
+
+    Mutex::Locker locker (m_mutex);
+    KeyToEntryMap::iterator pos = m_key_to_entry.find (key);
+    if (pos != m_key_to_entry.end())
+    {
+        collection::iterator entry = pos->second;
+        expr_sp = entry->m_expr_sp;
+        m_key_to_entry.erase (pos);
+        m_expressions.erase (entry);
+        ++m_num_hits;
+    }
+    else
+    {
+        ++m_num_misses;
+    }
+
+    LogSP log (lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_EXPRESSIONS));
+    if (log)
+        log->Printf ("ClangExpressionCache::Take (\"%s\", decl_context = %p) => %s (%llu hits, %llu misses)",
+                     expr_cstr,
+                     decl_context,
+                     expr_sp ? "hit" : "miss",
+                     m_num_hits,
+                     m_num_misses);
+    return expr_sp;
+}
+
+void
+ClangExpressionCache::Insert (const char *expr_cstr,
+                              const char *expr_prefix,
+                              lldb::LanguageType language,
+                              uint32_t desired_type,
+                              const void *decl_context,
+                              const lldb::ModuleSP &module_sp,
+                              const ClangUserExpressionSP &expr_sp)
+{
+    if (expr_cstr == NULL || !expr_sp)
+        return;
+
+    Entry new_entry;
+    MakeKey (expr_cstr, expr_prefix, language, desired_type, decl_context, new_entry.m_key);
+    new_entry.m_module_sp = module_sp;
+    new_entry.m_expr_sp = expr_sp;
+
+    // Expressions free their JIT-compiled code as they are destroyed, do
+    // that without holding the lock.
+    collection evicted;
+    {
+        Mutex::Locker locker (m_mutex);
+        KeyToEntryMap::iterator pos = m_key_to_entry.find (new_entry.m_key);
+        if (pos != m_key_to_entry.end())
+        {
+            evicted.splice (evicted.end(), m_expressions, pos->second);
+            m_key_to_entry.erase (pos);
+        }
+        else if (m_expressions.size() >= g_max_cached_expressions)
+        {
+            collection::iterator lru_entry = --m_expressions.end();
+            m_key_to_entry.erase (lru_entry->m_key);
+            evicted.splice (evicted.end(), m_expressions, lru_entry);
+            ++m_num_evictions;
+        }
+
+        m_expressions.push_front (new_entry);
+        m_key_to_entry[m_expressions.front().m_key] = m_expressions.begin();
+    }
+}
+
+void
+ClangExpressionCache::Clear ()
+{
+    collection expressions;
+    {
+        Mutex::Locker locker (m_mutex);
+        if (m_expressions.empty())
+            return;
+        expressions.swap (m_expressions);
+        m_key_to_entry.clear();
+        ++m_num_invalidations;
+    }
+    // The expressions free their JIT-compiled code as they are destroyed,
+    // do that without holding the lock.
+}
+
+void
+ClangExpressionCache::DumpStatistics (Stream *s)
+{
+    if (s == NULL)
+        return;
+
+    Mutex::Locker locker (m_mutex);
+    const uint64_t num_lookups = m_num_hits + m_num_misses;
+    s->Printf ("%llu expressions cached, %llu hits, %llu misses (%.1f%% hit rate), %llu evictions, %llu invalidations\n",
+               (uint64_t)m_expressions.size(),
+               m_num_hits,
+               m_num_misses,
+               num_lookups ? (100.0 * m_num_hits) / num_lookups : 0.0,
+               m_num_evictions,
+               m_num_invalidations);
+}
+
+void
+ClangExpressionCache::ResetStatistics ()
+{
+    Mutex::Locker locker (m_mutex);
+    m_num_hits = 0;
+    m_num_misses = 0;
+    m_num_evictions = 0;
+    m_num_invalidations = 0;
+}
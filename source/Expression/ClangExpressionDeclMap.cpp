@@ -137,6 +137,79 @@ ClangExpressionDeclMap::DidParse()
     }
 }
 
+bool
+ClangExpressionDeclMap::CanReuse ()
+{
+    return m_parser_vars.get() && 
+           m_struct_vars.get() && 
+           !m_struct_vars->m_declares_persistent_vars;
+}
+
+bool
+ClangExpressionDeclMap::WillReuse (ExecutionContext &exe_ctx)
+{
+    if (!CanReuse())
+        return false;
+    
+    lldb::LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_EXPRESSIONS));
+    
+    m_parser_vars->m_exe_ctx = &exe_ctx;
+    
+    if (!m_struct_vars->m_result_name)
+        return true;
+    
+    ClangExpressionVariableSP old_result_sp (m_parser_vars->m_persistent_vars->GetVariable(m_struct_vars->m_result_name));
+    
+    if (!old_result_sp)
+        return false;
+    
+    // The previous result stays in the persistent variables with the
+    // value it got from the last run.  Give this run a variable of its
+    // own, in the state the result variable was in after parsing.
+    
+    ConstString result_name = m_parser_vars->m_persistent_vars->GetNextPersistentVariableName();
+    
+    ClangExpressionVariableSP result_sp = m_parser_vars->m_persistent_vars->CreatePersistentVariable (exe_ctx.GetBestExecutionContextScope (),
+                                                                                                      result_name, 
+                                                                                                      old_result_sp->GetTypeFromUser(),
+                                                                                                      m_parser_vars->m_target_info.byte_order,
+                                                                                                      m_parser_vars->m_target_info.address_byte_size);
+    if (!result_sp)
+        return false;
+    
+    result_sp->m_flags = m_struct_vars->m_result_flags;
+    
+    // Lookups by declaration, as done by the IR interpreter, must find
+    // the new variable.
+    result_sp->m_parser_vars = old_result_sp->m_parser_vars;
+    
+    if (old_result_sp->m_jit_vars.get())
+    {
+        result_sp->EnableJITVars();
+        *result_sp->m_jit_vars = *old_result_sp->m_jit_vars;
+    }
+    
+    for (size_t member_index = 0, num_members = m_struct_members.GetSize();
+         member_index < num_members;
+         ++member_index)
+    {
+        if (m_struct_members.GetVariableAtIndex(member_index).get() == old_result_sp.get())
+        {
+            m_struct_members.SetVariableAtIndex(member_index, result_sp);
+            break;
+        }
+    }
+    
+    m_struct_vars->m_result_name = result_name;
+    
+    if (log)
+        log->Printf("Reusing expression with new result variable %s (flags 0x%hx)", 
+                    result_name.GetCString(), 
+                    result_sp->m_flags);
+    
+    return true;
+}
+
 // Interface for IRForTarget
 
 ClangExpressionDeclMap::TargetInfo 
@@ -492,6 +565,11 @@ ClangExpressionDeclMap::AddPersistentVariable
     if (log)
         log->Printf("Created persistent variable with flags 0x%hx", var_sp->m_flags);
     
+    if (is_result)
+        m_struct_vars->m_result_flags = var_sp->m_flags;
+    else
+        m_struct_vars->m_declares_persistent_vars = true;
+    
     var_sp->EnableParserVars();
     
     var_sp->m_parser_vars->m_named_decl = decl;
@@ -19,6 +19,7 @@
 #include "lldb/Expression/ClangExpression.h"
 #include "lldb/Expression/ClangExpressionDeclMap.h"
 #include "lldb/Expression/IRDynamicChecks.h"
+#include "lldb/Expression/IRInterpreter.h"
 #include "lldb/Expression/RecordingMemoryManager.h"
 #include "lldb/Target/ExecutionContext.h"
 #include "lldb/Target/ObjCLanguageRuntime.h"
@@ -188,7 +189,10 @@ ClangExpressionParser::ClangExpressionParser (ExecutionContextScope *exe_scope,
     m_compiler (),
     m_code_generator (NULL),
     m_execution_engine (),
-    m_jitted_functions ()
+    m_jitted_functions (),
+    m_interpreted_module (),
+    m_interpreted_function (NULL),
+    m_interpreted_result_type ()
 {
     // Initialize targets first, so that --version shows registered targets.
     static struct InitializeLLVM {
@@ -503,6 +507,15 @@ ClangExpressionParser::PrepareForExecution (lldb::addr_t &func_allocation_addr,
             if (const_result)
                 const_result->TransferAddress();
             evaluated_statically = true;
+            
+            // Hold on to the IR, running the interpreter again is much
+            // cheaper than parsing the expression again.
+            if (ir_for_target.interpretedFunction())
+            {
+                m_interpreted_module.reset(module);
+                m_interpreted_function = ir_for_target.interpretedFunction();
+                m_interpreted_result_type = ir_for_target.resultType();
+            }
             err.Clear();
             return err;
         }
@@ -721,6 +734,46 @@ ClangExpressionParser::PrepareForExecution (lldb::addr_t &func_allocation_addr,
     return err;
 }
 
+Error
+ClangExpressionParser::InterpretAgain (lldb::ClangExpressionVariableSP &const_result)
+{
+    lldb::LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_EXPRESSIONS));
+
+    Error err;
+    
+    ClangExpressionDeclMap *decl_map = m_expr.DeclMap();
+    
+    if (!m_interpreted_function || !decl_map)
+    {
+        err.SetErrorToGenericError();
+        err.SetErrorString("The expression wasn't interpreted");
+        return err;
+    }
+    
+    IRInterpreter interpreter (*decl_map, NULL);
+    
+    const_result.reset();
+    
+    if (!interpreter.maybeRunOnFunction(const_result, 
+                                        decl_map->GetPersistentResultName(), 
+                                        m_interpreted_result_type, 
+                                        *m_interpreted_function, 
+                                        *m_interpreted_module))
+    {
+        if (log)
+            log->Printf("The IR interpreter couldn't run %s() again", m_expr.FunctionName());
+        
+        err.SetErrorToGenericError();
+        err.SetErrorString("The expression couldn't be interpreted again");
+        return err;
+    }
+    
+    if (const_result)
+        const_result->TransferAddress();
+    
+    return err;
+}
+
 Error
 ClangExpressionParser::DisassembleFunction (Stream &stream, ExecutionContext &exe_ctx, RecordingMemoryManager *jit_memory_manager)
 {
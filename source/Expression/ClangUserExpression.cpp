@@ -24,6 +24,7 @@
 #include "lldb/Core/StreamString.h"
 #include "lldb/Core/ValueObjectConstResult.h"
 #include "lldb/Expression/ASTResultSynthesizer.h"
+#include "lldb/Expression/ClangExpressionCache.h"
 #include "lldb/Expression/ClangExpressionDeclMap.h"
 #include "lldb/Expression/ClangExpressionParser.h"
 #include "lldb/Expression/ClangFunction.h"
@@ -317,9 +318,9 @@ ClangUserExpression::Parse (Stream &error_stream,
     }
     
     Process *process = exe_ctx.GetProcessPtr();
-    ClangExpressionParser parser(process, *this);
+    m_parser.reset(new ClangExpressionParser(process, *this));
     
-    unsigned num_errors = parser.Parse (error_stream);
+    unsigned num_errors = m_parser->Parse (error_stream);
     
     if (num_errors)
     {
@@ -327,6 +328,8 @@ ClangUserExpression::Parse (Stream &error_stream,
         
         m_expr_decl_map->DidParse();
         
+        m_parser.reset();
+        
         return false;
     }
     
@@ -337,7 +340,7 @@ ClangUserExpression::Parse (Stream &error_stream,
     if (execution_policy != eExecutionPolicyNever && process)
         m_data_allocator.reset(new ProcessDataAllocator(*process));
     
-    Error jit_error = parser.PrepareForExecution (m_jit_alloc,
+    Error jit_error = m_parser->PrepareForExecution (m_jit_alloc,
                                                   m_jit_start_addr,
                                                   m_jit_end_addr,
                                                   exe_ctx,
@@ -354,6 +357,11 @@ ClangUserExpression::Parse (Stream &error_stream,
         log->Printf("Data buffer contents:\n%s", dump_string.GetString().c_str());
     }
         
+    // The parser is only needed later if the IR interpreter evaluated the
+    // expression and can do so again.
+    if (!jit_error.Success() || !m_evaluated_statically || !m_parser->CanInterpretAgain())
+        m_parser.reset();
+    
     if (jit_error.Success())
     {
         if (process && m_jit_alloc != LLDB_INVALID_ADDRESS)
@@ -371,6 +379,58 @@ ClangUserExpression::Parse (Stream &error_stream,
     }
 }
 
+bool
+ClangUserExpression::CanReuse ()
+{
+    if (!m_expr_decl_map.get() || !m_expr_decl_map->CanReuse())
+        return false;
+    
+    if (m_evaluated_statically)
+        return m_parser.get() && m_parser->CanInterpretAgain();
+    
+    return m_jit_start_addr != LLDB_INVALID_ADDRESS && m_jit_process_sp;
+}
+
+bool
+ClangUserExpression::WillReuse (ExecutionContext &exe_ctx,
+                                lldb_private::ExecutionPolicy execution_policy)
+{
+    if (!CanReuse() || m_target != exe_ctx.GetTargetPtr())
+        return false;
+    
+    if (m_evaluated_statically)
+    {
+        if (execution_policy == eExecutionPolicyAlways)
+            return false;
+    }
+    else
+    {
+        // The JIT-compiled code lives in the process it was parsed for.
+        if (execution_policy == eExecutionPolicyNever ||
+            m_jit_process_sp.get() != exe_ctx.GetProcessPtr())
+            return false;
+    }
+    
+    return m_expr_decl_map->WillReuse (exe_ctx);
+}
+
+bool
+ClangUserExpression::InterpretAgain (Stream &error_stream)
+{
+    if (!m_parser.get())
+        return false;
+    
+    Error interpret_error = m_parser->InterpretAgain (m_const_result);
+    
+    if (!interpret_error.Success())
+    {
+        error_stream.Printf ("error: %s\n", interpret_error.AsCString("couldn't interpret the expression"));
+        return false;
+    }
+    
+    return true;
+}
+
 bool
 ClangUserExpression::PrepareToExecuteJITExpression (Stream &error_stream,
                                                     ExecutionContext &exe_ctx,
@@ -681,16 +741,64 @@ ClangUserExpression::EvaluateWithError (ExecutionContext &exe_ctx,
     if (process == NULL || !process->CanJIT())
         execution_policy = eExecutionPolicyNever;
     
-    ClangUserExpressionSP user_expression_sp (new ClangUserExpression (expr_cstr, expr_prefix, language, desired_type));
-
+    // Parsed expressions are worth keeping around: evaluating the same
+    // expression in the same context again only needs its variables to
+    // be materialized for the JIT-compiled code, or read again by the
+    // IR interpreter.
+    ClangExpressionCache *expression_cache = NULL;
+    const void *decl_context = NULL;
+    lldb::ModuleSP decl_module_sp;
+    Target *target = exe_ctx.GetTargetPtr();
+    
+    if (target && 
+        ClangExpressionCache::GetDeclContext (exe_ctx, decl_context, decl_module_sp))
+        expression_cache = &target->GetExpressionCache();
+    
+    ClangUserExpressionSP user_expression_sp;
+    
+    if (expression_cache)
+    {
+        user_expression_sp = expression_cache->Take (expr_cstr, expr_prefix, language, desired_type, decl_context);
+        
+        if (user_expression_sp && !user_expression_sp->WillReuse (exe_ctx, execution_policy))
+            user_expression_sp.reset();
+    }
+    
     StreamString error_stream;
+    
+    bool parsed = false;
+    
+    if (user_expression_sp)
+    {
+        if (log)
+            log->Printf("== [ClangUserExpression::Evaluate] Reusing parsed expression %s ==", expr_cstr);
         
-    if (log)
-        log->Printf("== [ClangUserExpression::Evaluate] Parsing expression %s ==", expr_cstr);
+        // If the interpreter can't handle the expression in this context,
+        // start over with a fresh parse.
+        if (user_expression_sp->EvaluatedStatically() && !user_expression_sp->InterpretAgain (error_stream))
+        {
+            error_stream.GetString().clear();
+            user_expression_sp.reset();
+        }
+        else
+        {
+            parsed = true;
+        }
+    }
     
-    const bool keep_expression_in_memory = true;
+    if (!user_expression_sp)
+    {
+        user_expression_sp.reset (new ClangUserExpression (expr_cstr, expr_prefix, language, desired_type));
+        
+        if (log)
+            log->Printf("== [ClangUserExpression::Evaluate] Parsing expression %s ==", expr_cstr);
+        
+        const bool keep_expression_in_memory = true;
+        
+        parsed = user_expression_sp->Parse (error_stream, exe_ctx, execution_policy, keep_expression_in_memory);
+    }
     
-    if (!user_expression_sp->Parse (error_stream, exe_ctx, execution_policy, keep_expression_in_memory))
+    if (!parsed)
     {
         if (error_stream.GetString().empty())
             error.SetErrorString ("expression failed to parse, unknown error");
@@ -711,6 +819,9 @@ ClangUserExpression::EvaluateWithError (ExecutionContext &exe_ctx,
             else
                 error.SetError(ClangUserExpression::kNoResult, lldb::eErrorTypeGeneric);
             
+            if (expression_cache && user_expression_sp->CanReuse())
+                expression_cache->Insert (expr_cstr, expr_prefix, language, desired_type, decl_context, decl_module_sp, user_expression_sp);
+            
             execution_results = eExecutionCompleted;
         }
         else if (execution_policy == eExecutionPolicyNever)
@@ -746,6 +857,9 @@ ClangUserExpression::EvaluateWithError (ExecutionContext &exe_ctx,
             }
             else 
             {
+                if (expression_cache && user_expression_sp->CanReuse())
+                    expression_cache->Insert (expr_cstr, expr_prefix, language, desired_type, decl_context, decl_module_sp, user_expression_sp);
+                
                 if (expr_result)
                 {
                     result_valobj_sp = expr_result->GetValueObject();
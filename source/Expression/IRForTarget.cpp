@@ -55,6 +55,7 @@ IRForTarget::IRForTarget (lldb_private::ClangExpressionDeclMap *decl_map,
     m_resolve_vars(resolve_vars),
     m_execution_policy(execution_policy),
     m_interpret_success(false),
+    m_interpreted_function(NULL),
     m_func_name(func_name),
     m_module(NULL),
     m_decl_map(decl_map),
@@ -2666,6 +2667,7 @@ IRForTarget::runOnModule (Module &llvm_module)
         if (interpreter.maybeRunOnFunction(m_const_result, m_result_name, m_result_type, *function, llvm_module))
         {
             m_interpret_success = true;
+            m_interpreted_function = function;
             return true;
         }
     }
@@ -255,6 +255,15 @@ Host::GetPageSize()
     return ::getpagesize();
 }
 
+uint32_t
+Host::GetNumberOfCPUs()
+{
+    long num_cpus = ::sysconf (_SC_NPROCESSORS_ONLN);
+    if (num_cpus < 1)
+        return 1;
+    return num_cpus;
+}
+
 const ArchSpec &
 Host::GetArchitecture (SystemDefaultArchitecture arch_kind)
 {
@@ -604,6 +613,87 @@ Host::ThreadJoin (lldb::thread_t thread, thread_result_t *thread_result_ptr, Err
     return err == 0;
 }
 
+namespace {
+
+    struct ParallelForEachInfo
+    {
+        Host::ParallelForEachCallback callback;
+        void *baton;
+        size_t num_tasks;
+        size_t next_task_idx;
+    };
+
+    struct ParallelForEachWorker
+    {
+        ParallelForEachInfo *info;
+        uint32_t worker_idx;
+    };
+
+}
+
+static void
+RunParallelForEachWorker (ParallelForEachWorker *worker)
+{
+    ParallelForEachInfo *info = worker->info;
+    while (1)
+    {
+        const size_t task_idx = __sync_fetch_and_add (&info->next_task_idx, 1);
+        if (task_idx >= info->num_tasks)
+            break;
+        info->callback (info->baton, worker->worker_idx, task_idx);
+    }
+}
+
+static thread_result_t
+ParallelForEachThread (thread_arg_t arg)
+{
+    RunParallelForEachWorker ((ParallelForEachWorker *)arg);
+    return NULL;
+}
+
+uint32_t
+Host::ParallelForEach (const char *thread_name,
+                       uint32_t num_workers,
+                       size_t num_tasks,
+                       ParallelForEachCallback callback,
+                       void *baton)
+{
+    if (num_tasks == 0)
+        return 0;
+
+    if (num_workers == 0)
+        num_workers = GetNumberOfCPUs();
+    if (num_workers > num_tasks)
+        num_workers = num_tasks;
+
+    ParallelForEachInfo info = { callback, baton, num_tasks, 0 };
+    std::vector<ParallelForEachWorker> workers (num_workers);
+    std::vector<lldb::thread_t> threads;
+    for (uint32_t i = 0; i < num_workers; ++i)
+    {
+        workers[i].info = &info;
+        workers[i].worker_idx = i;
+    }
+
+    // If a thread can't be created the remaining workers simply pick up
+    // its share of the tasks.
+    for (uint32_t i = 1; i < num_workers; ++i)
+    {
+        lldb::thread_t thread = ThreadCreate (thread_name,
+                                              ParallelForEachThread,
+                                              &workers[i],
+                                              NULL);
+        if (IS_VALID_LLDB_HOST_THREAD(thread))
+            threads.push_back (thread);
+    }
+
+    RunParallelForEachWorker (&workers[0]);
+
+    for (size_t i = 0; i < threads.size(); ++i)
+        ThreadJoin (threads[i], NULL, NULL);
+    return num_workers;
+}
+
 //------------------------------------------------------------------
 // Control access to a static file thread name map using a single
 // static function to avoid a static constructor.
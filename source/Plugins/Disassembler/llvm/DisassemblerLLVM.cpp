@@ -574,10 +574,52 @@ InstructionLLVM::CalculateComment(ExecutionContextScope *exe_scope)
     CalculateMnemonic (exe_scope);    
 }
 
+//----------------------------------------------------------------------
+// Opcodes of x86 instructions that don't continue with the next
+// instruction but that the enhanced disassembler doesn't flag as
+// branches, which it only does for jumps and calls.
+//----------------------------------------------------------------------
+static bool
+X86OpcodeLeavesStraightLineCode (const char *opcode)
+{
+    static const char *g_opcode_prefixes[] =
+    {
+        "ret", "lret", "iret", "int", "syscall", "sysret", "sysenter",
+        "sysexit", "hlt", "ud2", "loop", "jcxz", "jecxz", "jrcxz"
+    };
+    const size_t num_prefixes = sizeof(g_opcode_prefixes) / sizeof(g_opcode_prefixes[0]);
+    for (size_t i = 0; i < num_prefixes; i++)
+    {
+        if (::strncmp (opcode, g_opcode_prefixes[i], ::strlen (g_opcode_prefixes[i])) == 0)
+            return true;
+    }
+    return false;
+}
+
 bool
 InstructionLLVM::DoesBranch() const
 {
-    return EDInstIsBranch(m_inst);
+    if (EDInstIsBranch(m_inst))
+        return true;
+
+    if (m_arch_type != llvm::Triple::x86 && m_arch_type != llvm::Triple::x86_64)
+        return false;
+
+    const int num_tokens = EDNumTokens(m_inst);
+    for (int token_idx = 0; token_idx < num_tokens; ++token_idx)
+    {
+        EDTokenRef token;
+        if (EDGetToken(&token, m_inst, token_idx))
+            break;
+        if (EDTokenIsOpcode(token) == 1)
+        {
+            const char *token_cstr = NULL;
+            if (EDGetTokenString(&token_cstr, token) == 0 && token_cstr)
+                return X86OpcodeLeavesStraightLineCode (token_cstr);
+            break;
+        }
+    }
+    return false;
 }
 
 size_t
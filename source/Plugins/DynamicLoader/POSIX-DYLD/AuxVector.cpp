@@ -49,8 +49,7 @@ ParseAuxvEntry(DataExtractor &data, AuxVector::Entry &entry,
 DataBufferSP
 AuxVector::GetAuxvData()
 {
-
-    return lldb_private::Host::GetAuxvData(m_process);
+    return m_process->GetAuxvData();
 }
 
 void
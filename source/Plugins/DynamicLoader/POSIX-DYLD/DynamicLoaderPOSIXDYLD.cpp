@@ -261,14 +261,10 @@ DynamicLoaderPOSIXDYLD::RefreshModules()
     {
         ModuleList new_modules;
 
-        E = m_rendezvous.loaded_end();
-        for (I = m_rendezvous.loaded_begin(); I != E; ++I)
-        {
-            FileSpec file(I->path.c_str(), true);
-            ModuleSP module_sp = LoadModuleAtAddress(file, I->base_addr);
-            if (module_sp.get())
-                new_modules.Append(module_sp);
-        }
+        LoadModulesAtAddresses(m_rendezvous.loaded_begin(),
+                               m_rendezvous.loaded_end(),
+                               true,
+                               new_modules);
         m_process->GetTarget().ModulesDidLoad(new_modules);
     }
     
@@ -353,15 +349,58 @@ DynamicLoaderPOSIXDYLD::LoadAllCurrentModules()
     if (!m_rendezvous.Resolve())
         return;
 
-    for (I = m_rendezvous.begin(), E = m_rendezvous.end(); I != E; ++I)
+    LoadModulesAtAddresses(m_rendezvous.begin(), m_rendezvous.end(),
+                           false, module_list);
+
+    m_process->GetTarget().ModulesDidLoad(module_list);
+}
+
+void
+DynamicLoaderPOSIXDYLD::LoadModulesAtAddresses(DYLDRendezvous::iterator begin,
+                                               DYLDRendezvous::iterator end,
+                                               bool resolve_paths,
+                                               ModuleList &module_list)
+{
+    Target &target = m_process->GetTarget();
+    ModuleList &modules = target.GetImages();
+    DYLDRendezvous::iterator I;
+    FileSpecList missing_files;
+    std::vector<addr_t> missing_base_addrs;
+
+    // Modules we already know about only need their sections slid, collect
+    // the others so they can be located and parsed together.
+    for (I = begin; I != end; ++I)
     {
-        FileSpec file(I->path.c_str(), false);
-        ModuleSP module_sp = LoadModuleAtAddress(file, I->base_addr);
+        FileSpec file(I->path.c_str(), resolve_paths);
+        ModuleSP module_sp = modules.FindFirstModuleForFileSpec(file, NULL, NULL);
         if (module_sp.get())
+        {
+            UpdateLoadedSections(module_sp, I->base_addr);
             module_list.Append(module_sp);
+        }
+        else
+        {
+            missing_files.Append(file);
+            missing_base_addrs.push_back(I->base_addr);
+        }
     }
 
-    m_process->GetTarget().ModulesDidLoad(module_list);
+    if (missing_files.GetSize() == 0)
+        return;
+
+    std::vector<ModuleSP> new_modules;
+    target.GetSharedModules(missing_files, target.GetArchitecture(), new_modules);
+
+    for (size_t i = 0; i < new_modules.size(); ++i)
+    {
+        ModuleSP &module_sp = new_modules[i];
+        if (module_sp.get())
+        {
+            UpdateLoadedSections(module_sp, missing_base_addrs[i]);
+            modules.Append(module_sp);
+            module_list.Append(module_sp);
+        }
+    }
 }
 
 ModuleSP
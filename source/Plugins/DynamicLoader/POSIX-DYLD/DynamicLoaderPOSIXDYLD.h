@@ -127,6 +127,15 @@ protected:
     lldb::ModuleSP
     LoadModuleAtAddress(const lldb_private::FileSpec &file, lldb::addr_t base_addr);
 
+    /// Loads every module in [@p begin, @p end) at its base address and
+    /// appends it to @p module_list.  Modules the target doesn't have yet
+    /// are located and parsed in parallel.
+    void
+    LoadModulesAtAddresses(DYLDRendezvous::iterator begin,
+                           DYLDRendezvous::iterator end,
+                           bool resolve_paths,
+                           lldb_private::ModuleList &module_list);
+
     /// Resolves the entry point for the current inferior process and sets a
     /// breakpoint at that address.
     void
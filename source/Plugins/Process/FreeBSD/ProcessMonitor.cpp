@@ -24,6 +24,7 @@
 #include "lldb/Core/RegisterValue.h"
 #include "lldb/Core/Scalar.h"
 #include "lldb/Host/Host.h"
+#include "lldb/Host/TimeValue.h"
 #include "lldb/Target/Thread.h"
 #include "lldb/Target/RegisterContext.h"
 #include "lldb/Utility/PseudoTerminal.h"
@@ -191,9 +192,23 @@ EnsureFDFlags(int fd, int flags, Error &error)
 class Operation
 {
 public:
+    virtual ~Operation() { }
+
     virtual void Execute(ProcessMonitor *monitor) = 0;
 };
 
+//------------------------------------------------------------------------------
+/// @class OperationRequest
+/// @brief The unit of work passed to the operation thread.
+///
+/// A request refers to one or more operations which the operation thread
+/// executes in order before acknowledging the request.
+struct OperationRequest
+{
+    Operation *const *m_ops;
+    size_t m_count;
+};
+
 //------------------------------------------------------------------------------
 /// @class ReadOperation
 /// @brief Implements ProcessMonitor::ReadMemory.
@@ -260,13 +275,14 @@ WriteOperation::Execute(ProcessMonitor *monitor)
 class ReadRegOperation : public Operation
 {
 public:
-    ReadRegOperation(unsigned offset, unsigned size, RegisterValue &value, bool &result)
-      : m_offset(offset), m_size(size), m_value(value), m_result(result)
+    ReadRegOperation(lldb::tid_t tid, unsigned offset, unsigned size, RegisterValue &value, bool &result)
+      : m_tid(tid), m_offset(offset), m_size(size), m_value(value), m_result(result)
         { }
 
     void Execute(ProcessMonitor *monitor);
 
 private:
+    lldb::tid_t m_tid;
     unsigned m_offset;
     unsigned m_size;
     RegisterValue &m_value;
@@ -276,11 +292,10 @@ private:
 void
 ReadRegOperation::Execute(ProcessMonitor *monitor)
 {
-    lldb::pid_t pid = monitor->GetPID();
     struct reg regs;
     int rc;
 
-    if ((rc = PTRACE(PT_GETREGS, pid, (caddr_t)&regs, 0)) < 0) {
+    if ((rc = PTRACE(PT_GETREGS, m_tid, (caddr_t)&regs, 0)) < 0) {
         m_result = false;
     } else {
         if (m_size == sizeof(uintptr_t))
@@ -297,13 +312,14 @@ ReadRegOperation::Execute(ProcessMonitor *monitor)
 class WriteRegOperation : public Operation
 {
 public:
-    WriteRegOperation(unsigned offset, const RegisterValue &value, bool &result)
-        : m_offset(offset), m_value(value), m_result(result)
+    WriteRegOperation(lldb::tid_t tid, unsigned offset, const RegisterValue &value, bool &result)
+        : m_tid(tid), m_offset(offset), m_value(value), m_result(result)
         { }
 
     void Execute(ProcessMonitor *monitor);
 
 private:
+    lldb::tid_t m_tid;
     unsigned m_offset;
     const RegisterValue &m_value;
     bool &m_result;
@@ -312,15 +328,82 @@ private:
 void
 WriteRegOperation::Execute(ProcessMonitor *monitor)
 {
-    lldb::pid_t pid = monitor->GetPID();
     struct reg regs;
 
-    if (PTRACE(PT_GETREGS, pid, (caddr_t)&regs, 0) < 0) {
+    if (PTRACE(PT_GETREGS, m_tid, (caddr_t)&regs, 0) < 0) {
         m_result = false;
         return;
     }
     *(uintptr_t *)(((caddr_t)&regs) + m_offset) = (uintptr_t)m_value.GetAsUInt64();
-    if (PTRACE(PT_SETREGS, pid, (caddr_t)&regs, 0) < 0)
+    if (PTRACE(PT_SETREGS, m_tid, (caddr_t)&regs, 0) < 0)
+        m_result = false;
+    else
+        m_result = true;
+}
+
+//------------------------------------------------------------------------------
+/// @class ReadDebugRegOperation
+/// @brief Implements ProcessMonitor::ReadDebugRegisterValue.
+class ReadDebugRegOperation : public Operation
+{
+public:
+    ReadDebugRegOperation(lldb::tid_t tid, unsigned index, RegisterValue &value, bool &result)
+        : m_tid(tid), m_index(index), m_value(value), m_result(result)
+        { }
+
+    void Execute(ProcessMonitor *monitor);
+
+private:
+    lldb::tid_t m_tid;
+    unsigned m_index;
+    RegisterValue &m_value;
+    bool &m_result;
+};
+
+void
+ReadDebugRegOperation::Execute(ProcessMonitor *monitor)
+{
+    struct dbreg dbregs;
+
+    if (PTRACE(PT_GETDBREGS, m_tid, (caddr_t)&dbregs, 0) < 0)
+        m_result = false;
+    else
+    {
+        m_value = (uint64_t)DBREG_DRX(&dbregs, m_index);
+        m_result = true;
+    }
+}
+
+//------------------------------------------------------------------------------
+/// @class WriteDebugRegOperation
+/// @brief Implements ProcessMonitor::WriteDebugRegisterValue.
+class WriteDebugRegOperation : public Operation
+{
+public:
+    WriteDebugRegOperation(lldb::tid_t tid, unsigned index, const RegisterValue &value, bool &result)
+        : m_tid(tid), m_index(index), m_value(value), m_result(result)
+        { }
+
+    void Execute(ProcessMonitor *monitor);
+
+private:
+    lldb::tid_t m_tid;
+    unsigned m_index;
+    const RegisterValue &m_value;
+    bool &m_result;
+};
+
+void
+WriteDebugRegOperation::Execute(ProcessMonitor *monitor)
+{
+    struct dbreg dbregs;
+
+    if (PTRACE(PT_GETDBREGS, m_tid, (caddr_t)&dbregs, 0) < 0) {
+        m_result = false;
+        return;
+    }
+    DBREG_DRX(&dbregs, m_index) = (uintptr_t)m_value.GetAsUInt64();
+    if (PTRACE(PT_SETDBREGS, m_tid, (caddr_t)&dbregs, 0) < 0)
         m_result = false;
     else
         m_result = true;
@@ -332,13 +415,14 @@ WriteRegOperation::Execute(ProcessMonitor *monitor)
 class ReadGPROperation : public Operation
 {
 public:
-    ReadGPROperation(void *buf, bool &result)
-        : m_buf(buf), m_result(result)
+    ReadGPROperation(lldb::tid_t tid, void *buf, bool &result)
+        : m_tid(tid), m_buf(buf), m_result(result)
         { }
 
     void Execute(ProcessMonitor *monitor);
 
 private:
+    lldb::tid_t m_tid;
     void *m_buf;
     bool &m_result;
 };
@@ -349,7 +433,7 @@ ReadGPROperation::Execute(ProcessMonitor *monitor)
     int rc;
 
     errno = 0;
-    rc = PTRACE(PT_GETREGS, monitor->GetPID(), (caddr_t)m_buf, 0);
+    rc = PTRACE(PT_GETREGS, m_tid, (caddr_t)m_buf, 0);
     if (errno != 0)
         m_result = false;
     else
@@ -362,13 +446,14 @@ ReadGPROperation::Execute(ProcessMonitor *monitor)
 class ReadFPROperation : public Operation
 {
 public:
-    ReadFPROperation(void *buf, bool &result)
-        : m_buf(buf), m_result(result)
+    ReadFPROperation(lldb::tid_t tid, void *buf, bool &result)
+        : m_tid(tid), m_buf(buf), m_result(result)
         { }
 
     void Execute(ProcessMonitor *monitor);
 
 private:
+    lldb::tid_t m_tid;
     void *m_buf;
     bool &m_result;
 };
@@ -376,7 +461,7 @@ private:
 void
 ReadFPROperation::Execute(ProcessMonitor *monitor)
 {
-    if (PTRACE(PT_GETFPREGS, monitor->GetPID(), (caddr_t)m_buf, 0) < 0)
+    if (PTRACE(PT_GETFPREGS, m_tid, (caddr_t)m_buf, 0) < 0)
         m_result = false;
     else
         m_result = true;
@@ -388,13 +473,14 @@ ReadFPROperation::Execute(ProcessMonitor *monitor)
 class WriteGPROperation : public Operation
 {
 public:
-    WriteGPROperation(void *buf, bool &result)
-        : m_buf(buf), m_result(result)
+    WriteGPROperation(lldb::tid_t tid, void *buf, bool &result)
+        : m_tid(tid), m_buf(buf), m_result(result)
         { }
 
     void Execute(ProcessMonitor *monitor);
 
 private:
+    lldb::tid_t m_tid;
     void *m_buf;
     bool &m_result;
 };
@@ -402,7 +488,7 @@ private:
 void
 WriteGPROperation::Execute(ProcessMonitor *monitor)
 {
-    if (PTRACE(PT_SETREGS, monitor->GetPID(), (caddr_t)m_buf, 0) < 0)
+    if (PTRACE(PT_SETREGS, m_tid, (caddr_t)m_buf, 0) < 0)
         m_result = false;
     else
         m_result = true;
@@ -414,13 +500,14 @@ WriteGPROperation::Execute(ProcessMonitor *monitor)
 class WriteFPROperation : public Operation
 {
 public:
-    WriteFPROperation(void *buf, bool &result)
-        : m_buf(buf), m_result(result)
+    WriteFPROperation(lldb::tid_t tid, void *buf, bool &result)
+        : m_tid(tid), m_buf(buf), m_result(result)
         { }
 
     void Execute(ProcessMonitor *monitor);
 
 private:
+    lldb::tid_t m_tid;
     void *m_buf;
     bool &m_result;
 };
@@ -428,7 +515,7 @@ private:
 void
 WriteFPROperation::Execute(ProcessMonitor *monitor)
 {
-    if (PTRACE(PT_SETFPREGS, monitor->GetPID(), (caddr_t)m_buf, 0) < 0)
+    if (PTRACE(PT_SETFPREGS, m_tid, (caddr_t)m_buf, 0) < 0)
         m_result = false;
     else
         m_result = true;
@@ -1315,6 +1402,10 @@ ProcessMonitor::ServeOperation(OperationArgs *args)
 
     ProcessMonitor *monitor = args->m_monitor;
 
+    // Operation counts and times reported through the log.
+    uint64_t num_ops = 0;
+    uint64_t total_usec = 0;
+
     fdset.fd = monitor->m_server_fd;
     fdset.events = POLLIN | POLLPRI;
     fdset.revents = 0;
@@ -1342,32 +1433,69 @@ ProcessMonitor::ServeOperation(OperationArgs *args)
 
         if (fdset.revents & POLLIN)
         {
-            Operation *op = NULL;
+            OperationRequest *request = NULL;
 
         READ_AGAIN:
-            if ((status = read(fdset.fd, &op, sizeof(op))) < 0)
+            if ((status = read(fdset.fd, &request, sizeof(request))) < 0)
             {
                 // There is only one acceptable failure.
                 assert(errno == EINTR);
                 goto READ_AGAIN;
             }
 
-            assert(status == sizeof(op));
-            op->Execute(monitor);
-            write(fdset.fd, &op, sizeof(op));
+            assert(status == sizeof(request));
+
+            // Drain the whole batch before waking the client.
+            LogSP log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_OPERATIONS));
+            TimeValue start;
+            if (log)
+                start = TimeValue::Now();
+
+            for (size_t i = 0; i < request->m_count; ++i)
+                request->m_ops[i]->Execute(monitor);
+
+            if (log)
+            {
+                const uint64_t elapsed_usec =
+                    TimeValue::Now().GetAsMicroSecondsSinceJan1_1970() -
+                    start.GetAsMicroSecondsSinceJan1_1970();
+                num_ops += request->m_count;
+                total_usec += elapsed_usec;
+                log->Printf ("ProcessMonitor::%s() executed %zu operations in %llu us "
+                             "(%llu operations in %llu us total)", __FUNCTION__,
+                             request->m_count, elapsed_usec, num_ops, total_usec);
+            }
+
+            write(fdset.fd, &request, sizeof(request));
         }
     }
 }
 
 void
 ProcessMonitor::DoOperation(Operation *op)
+{
+    DoOperations(&op, 1);
+}
+
+void
+ProcessMonitor::DoOperations(Operation *const *ops, size_t count)
 {
     int status;
-    Operation *ack = NULL;
+    OperationRequest request = { ops, count };
+    OperationRequest *req = &request;
+    OperationRequest *ack = NULL;
+    LogSP log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_OPERATIONS));
+    TimeValue start;
+
+    if (count == 0)
+        return;
+
     Mutex::Locker lock(m_server_mutex);
+    if (log)
+        start = TimeValue::Now();
 
     // FIXME: Do proper error checking here.
-    write(m_client_fd, &op, sizeof(op));
+    write(m_client_fd, &req, sizeof(req));
 
 READ_AGAIN:
     if ((status = read(m_client_fd, &ack, sizeof(ack))) < 0)
@@ -1381,7 +1509,60 @@ READ_AGAIN:
     }
 
     assert(status == sizeof(ack));
-    assert(ack == op && "Invalid monitor thread response!");
+    assert(ack == req && "Invalid monitor thread response!");
+
+    if (log)
+    {
+        const uint64_t elapsed_usec =
+            TimeValue::Now().GetAsMicroSecondsSinceJan1_1970() -
+            start.GetAsMicroSecondsSinceJan1_1970();
+        log->Printf ("ProcessMonitor::%s() %zu operations completed in %llu us "
+                     "(%llu us per operation)", __FUNCTION__, count,
+                     elapsed_usec, elapsed_usec / count);
+    }
+}
+
+bool
+ProcessMonitor::ExecuteBatch(OperationBatch &batch)
+{
+    const size_t count = batch.GetSize();
+    bool success = true;
+
+    if (count == 0)
+        return true;
+
+    std::vector<Operation *> ops;
+    ops.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        OperationBatch::Entry &entry = batch.GetEntryAtIndex(i);
+        switch (entry.m_kind)
+        {
+        case OperationBatch::eResume:
+            ops.push_back(new ResumeOperation(entry.m_tid, entry.m_signo,
+                                              entry.m_success));
+            break;
+
+        case OperationBatch::eSingleStep:
+            ops.push_back(new SingleStepOperation(entry.m_tid, entry.m_signo,
+                                                  entry.m_success));
+            break;
+
+        case OperationBatch::eReadGPR:
+            ops.push_back(new ReadGPROperation(entry.m_tid, entry.m_buf,
+                                               entry.m_success));
+            break;
+        }
+    }
+
+    DoOperations(&ops[0], count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        success = batch.Succeeded(i) && success;
+        delete ops[i];
+    }
+    return success;
 }
 
 size_t
@@ -1405,55 +1586,73 @@ ProcessMonitor::WriteMemory(lldb::addr_t vm_addr, const void *buf, size_t size,
 }
 
 bool
-ProcessMonitor::ReadRegisterValue(unsigned offset, unsigned size, RegisterValue &value)
+ProcessMonitor::ReadRegisterValue(lldb::tid_t tid, unsigned offset, unsigned size, RegisterValue &value)
+{
+    bool result;
+    ReadRegOperation op(tid, offset, size, value, result);
+    DoOperation(&op);
+    return result;
+}
+
+bool
+ProcessMonitor::WriteRegisterValue(lldb::tid_t tid, unsigned offset, const RegisterValue &value)
+{
+    bool result;
+    WriteRegOperation op(tid, offset, value, result);
+    DoOperation(&op);
+    return result;
+}
+
+bool
+ProcessMonitor::ReadDebugRegisterValue(lldb::tid_t tid, unsigned index, RegisterValue &value)
 {
     bool result;
-    ReadRegOperation op(offset, size, value, result);
+    ReadDebugRegOperation op(tid, index, value, result);
     DoOperation(&op);
     return result;
 }
 
 bool
-ProcessMonitor::WriteRegisterValue(unsigned offset, const RegisterValue &value)
+ProcessMonitor::WriteDebugRegisterValue(lldb::tid_t tid, unsigned index, const RegisterValue &value)
 {
     bool result;
-    WriteRegOperation op(offset, value, result);
+    WriteDebugRegOperation op(tid, index, value, result);
     DoOperation(&op);
     return result;
 }
 
 bool
-ProcessMonitor::ReadGPR(void *buf)
+ProcessMonitor::ReadGPR(lldb::tid_t tid, void *buf)
 {
     bool result;
-    ReadGPROperation op(buf, result);
+    ReadGPROperation op(tid, buf, result);
     DoOperation(&op);
     return result;
 }
 
 bool
-ProcessMonitor::ReadFPR(void *buf)
+ProcessMonitor::ReadFPR(lldb::tid_t tid, void *buf)
 {
     bool result;
-    ReadFPROperation op(buf, result);
+    ReadFPROperation op(tid, buf, result);
     DoOperation(&op);
     return result;
 }
 
 bool
-ProcessMonitor::WriteGPR(void *buf)
+ProcessMonitor::WriteGPR(lldb::tid_t tid, void *buf)
 {
     bool result;
-    WriteGPROperation op(buf, result);
+    WriteGPROperation op(tid, buf, result);
     DoOperation(&op);
     return result;
 }
 
 bool
-ProcessMonitor::WriteFPR(void *buf)
+ProcessMonitor::WriteFPR(lldb::tid_t tid, void *buf)
 {
     bool result;
-    WriteFPROperation op(buf, result);
+    WriteFPROperation op(tid, buf, result);
     DoOperation(&op);
     return result;
 }
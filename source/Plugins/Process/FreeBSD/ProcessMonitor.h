@@ -15,10 +15,15 @@
 #include <signal.h>
 
 // C++ Includes
+#include <vector>
+
 // Other libraries and framework includes
 #include "lldb/lldb-types.h"
+#include "lldb/Core/Error.h"
 #include "lldb/Host/Mutex.h"
 
+#include "OperationBatch.h"
+
 namespace lldb_private
 {
 class Error;
@@ -100,34 +105,49 @@ public:
                 lldb_private::Error &error);
 
     /// Reads the contents from the register identified by the given (architecture
-    /// dependent) offset.
+    /// dependent) offset of thread @p tid.
     ///
     /// This method is provided for use by RegisterContextFreeBSD derivatives.
     bool
-    ReadRegisterValue(unsigned offset, unsigned size, lldb_private::RegisterValue &value);
+    ReadRegisterValue(lldb::tid_t tid, unsigned offset, unsigned size, lldb_private::RegisterValue &value);
 
     /// Writes the given value to the register identified by the given
-    /// (architecture dependent) offset.
+    /// (architecture dependent) offset of thread @p tid.
     ///
     /// This method is provided for use by RegisterContextFreeBSD derivatives.
     bool
-    WriteRegisterValue(unsigned offset, const lldb_private::RegisterValue &value);
+    WriteRegisterValue(lldb::tid_t tid, unsigned offset, const lldb_private::RegisterValue &value);
+
+    /// Reads the debug register DR@p index of thread @p tid.
+    ///
+    /// This method is provided for use by RegisterContextFreeBSD derivatives
+    /// implementing hardware watchpoints.
+    bool
+    ReadDebugRegisterValue(lldb::tid_t tid, unsigned index, lldb_private::RegisterValue &value);
 
-    /// Reads all general purpose registers into the specified buffer.
+    /// Writes @p value to the debug register DR@p index of thread @p tid.
     bool
-    ReadGPR(void *buf);
+    WriteDebugRegisterValue(lldb::tid_t tid, unsigned index, const lldb_private::RegisterValue &value);
 
-    /// Reads all floating point registers into the specified buffer.
+    /// Reads all general purpose registers of thread @p tid into the specified
+    /// buffer.
     bool
-    ReadFPR(void *buf);
+    ReadGPR(lldb::tid_t tid, void *buf);
 
-    /// Writes all general purpose registers into the specified buffer.
+    /// Reads all floating point registers of thread @p tid into the specified
+    /// buffer.
     bool
-    WriteGPR(void *buf);
+    ReadFPR(lldb::tid_t tid, void *buf);
 
-    /// Writes all floating point registers into the specified buffer.
+    /// Writes all general purpose registers of thread @p tid into the specified
+    /// buffer.
     bool
-    WriteFPR(void *buf);
+    WriteGPR(lldb::tid_t tid, void *buf);
+
+    /// Writes all floating point registers of thread @p tid into the specified
+    /// buffer.
+    bool
+    WriteFPR(lldb::tid_t tid, void *buf);
 
     /// Writes a siginfo_t structure corresponding to the given thread ID to the
     /// memory region pointed to by @p siginfo.
@@ -159,6 +179,10 @@ public:
     lldb_private::Error
     Detach();
 
+    /// Runs every request queued in @p batch with a single round trip to
+    /// the operation thread.  Returns true if all of them succeeded.
+    bool
+    ExecuteBatch(OperationBatch &batch);
 
 private:
     ProcessFreeBSD *m_process;
@@ -278,6 +302,9 @@ private:
     void
     DoOperation(Operation *op);
 
+    void
+    DoOperations(Operation *const *ops, size_t count);
+
     /// Stops the child monitor thread.
     void
     StopMonitoringChildProcess();
@@ -0,0 +1,988 @@
+//===-- NativeProcessLinux.cpp -------------------------------- -*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// C Includes
+#include <dirent.h>
+#include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
+#include <signal.h>
+#include <stddef.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <sys/ptrace.h>
+#include <sys/syscall.h>
+#include <sys/types.h>
+#include <sys/user.h>
+#include <sys/wait.h>
+
+// C++ Includes
+#include <algorithm>
+
+// Other libraries and framework includes
+#include "lldb/Target/Process.h"
+
+#include "NativeProcessLinux.h"
+#include "ProcessMonitor.h"
+#include "RegisterContext_x86_64.h"
+
+// Older C libraries don't define the codes of all SIGTRAPs.
+#ifndef TRAP_BRKPT
+#define TRAP_BRKPT 1
+#endif
+#ifndef TRAP_TRACE
+#define TRAP_TRACE 2
+#endif
+
+using namespace lldb;
+using namespace lldb_private;
+
+//------------------------------------------------------------------------------
+// Signal numbers used by the GDB remote protocol.
+
+static const struct
+{
+    int host_signo;
+    int gdb_signo;
+} g_signal_map[] =
+{
+    { SIGHUP,       1 },
+    { SIGINT,       2 },
+    { SIGQUIT,      3 },
+    { SIGILL,       4 },
+    { SIGTRAP,      5 },
+    { SIGABRT,      6 },
+    { SIGFPE,       8 },
+    { SIGKILL,      9 },
+    { SIGBUS,       10 },
+    { SIGSEGV,      11 },
+    { SIGSYS,       12 },
+    { SIGPIPE,      13 },
+    { SIGALRM,      14 },
+    { SIGTERM,      15 },
+    { SIGURG,       16 },
+    { SIGSTOP,      17 },
+    { SIGTSTP,      18 },
+    { SIGCONT,      19 },
+    { SIGCHLD,      20 },
+    { SIGTTIN,      21 },
+    { SIGTTOU,      22 },
+    { SIGIO,        23 },
+    { SIGXCPU,      24 },
+    { SIGXFSZ,      25 },
+    { SIGVTALRM,    26 },
+    { SIGPROF,      27 },
+    { SIGWINCH,     28 },
+    { SIGUSR1,      30 },
+    { SIGUSR2,      31 },
+    { SIGPWR,       32 }
+};
+
+static const size_t k_num_signals = sizeof(g_signal_map) / sizeof(g_signal_map[0]);
+
+int
+NativeProcessLinux::GetGDBSignal(int host_signo)
+{
+    for (size_t i = 0; i < k_num_signals; ++i)
+    {
+        if (g_signal_map[i].host_signo == host_signo)
+            return g_signal_map[i].gdb_signo;
+    }
+    return host_signo;
+}
+
+int
+NativeProcessLinux::GetHostSignal(int gdb_signo)
+{
+    for (size_t i = 0; i < k_num_signals; ++i)
+    {
+        if (g_signal_map[i].gdb_signo == gdb_signo)
+            return g_signal_map[i].host_signo;
+    }
+    return gdb_signo;
+}
+
+//------------------------------------------------------------------------------
+// NativeProcessLinux.
+
+NativeProcessLinux::NativeProcessLinux()
+    : m_pid(LLDB_INVALID_PROCESS_ID),
+      m_state(eStateInvalid),
+      m_stop_tid(LLDB_INVALID_THREAD_ID),
+      m_exit_status(0),
+      m_exit_signo(0),
+      m_mem_fd(-1),
+      m_interrupt_tid(LLDB_INVALID_THREAD_ID),
+      m_interrupt_pending(false),
+      m_threads(),
+      m_breakpoints()
+{
+}
+
+NativeProcessLinux::~NativeProcessLinux()
+{
+    // Never leave a process we launched or attached to stopped behind.
+    if (m_state == eStateStopped || m_state == eStateRunning)
+        Kill();
+    Reset();
+}
+
+void
+NativeProcessLinux::Reset()
+{
+    if (m_mem_fd >= 0)
+    {
+        close(m_mem_fd);
+        m_mem_fd = -1;
+    }
+    m_threads.clear();
+    m_breakpoints.clear();
+    m_stop_tid = LLDB_INVALID_THREAD_ID;
+    m_interrupt_tid = LLDB_INVALID_THREAD_ID;
+    m_interrupt_pending = false;
+}
+
+NativeProcessLinux::ThreadState &
+NativeProcessLinux::AddThread(lldb::tid_t tid, StateType state)
+{
+    ThreadState &thread = m_threads[tid];
+    thread.state = state;
+    thread.stop_reason = eStopReasonNone;
+    thread.stop_signo = 0;
+    thread.stepping = false;
+    thread.sigstop_pending = false;
+    return thread;
+}
+
+void
+NativeProcessLinux::ResumeThread(lldb::tid_t tid, const ThreadState &thread)
+{
+    ptrace(thread.stepping ? PTRACE_SINGLESTEP : PTRACE_CONT, tid, NULL, NULL);
+}
+
+// The file a launched process should open for @p fd, or NULL if it
+// should inherit ours.
+static const char *
+GetFileActionPath(const ProcessLaunchInfo &launch_info, int fd)
+{
+    const ProcessLaunchInfo::FileAction *action = launch_info.GetFileActionForFD(fd);
+    if (action && action->GetAction() == ProcessLaunchInfo::FileAction::eFileActionOpen)
+        return action->GetPath();
+    return NULL;
+}
+
+Error
+NativeProcessLinux::Launch(ProcessLaunchInfo &launch_info)
+{
+    Error error;
+    if (m_pid != LLDB_INVALID_PROCESS_ID)
+    {
+        error.SetErrorString("already debugging a process");
+        return error;
+    }
+
+    char exe_path[PATH_MAX];
+    if (launch_info.GetExecutableFile().GetPath(exe_path, sizeof(exe_path)) == 0)
+    {
+        error.SetErrorString("no executable to launch");
+        return error;
+    }
+
+    const char **argv = launch_info.GetArguments().GetConstArgumentVector();
+    const char **envp = launch_info.GetEnvironmentEntries().GetConstArgumentVector();
+    const bool disable_aslr = launch_info.GetFlags().Test(eLaunchFlagDisableASLR);
+    const lldb::pid_t pid = ProcessMonitor::LaunchTracedProcess(exe_path, argv, envp,
+                                                                GetFileActionPath(launch_info, STDIN_FILENO),
+                                                                GetFileActionPath(launch_info, STDOUT_FILENO),
+                                                                GetFileActionPath(launch_info, STDERR_FILENO),
+                                                                launch_info.GetWorkingDirectory(),
+                                                                disable_aslr,
+                                                                NULL,
+                                                                error);
+    if (pid == LLDB_INVALID_PROCESS_ID)
+        return error;
+
+    if (!InitializeProcess(pid, error))
+    {
+        kill(pid, SIGKILL);
+        return error;
+    }
+
+    ThreadState &thread = AddThread(pid, eStateStopped);
+    thread.stop_reason = eStopReasonSignal;
+    thread.stop_signo = SIGTRAP;
+    m_stop_tid = pid;
+    m_state = eStateStopped;
+    launch_info.SetProcessID(pid);
+    return error;
+}
+
+bool
+NativeProcessLinux::InitializeProcess(lldb::pid_t pid, Error &error)
+{
+    if (ptrace(PTRACE_SETOPTIONS, pid, NULL, (void*)PTRACE_O_TRACECLONE) < 0)
+    {
+        error.SetErrorToErrno();
+        return false;
+    }
+
+    m_pid = pid;
+    m_exit_status = 0;
+    m_exit_signo = 0;
+
+    // Reading through /proc/<pid>/mem transfers a whole buffer at a time
+    // instead of a word per system call.
+    char mem_path[PATH_MAX];
+    snprintf(mem_path, sizeof(mem_path), "/proc/%llu/mem", pid);
+    m_mem_fd = open(mem_path, O_RDONLY);
+    return true;
+}
+
+Error
+NativeProcessLinux::Attach(lldb::pid_t pid)
+{
+    Error error;
+    if (m_pid != LLDB_INVALID_PROCESS_ID)
+    {
+        error.SetErrorString("already debugging a process");
+        return error;
+    }
+
+    char task_path[PATH_MAX];
+    snprintf(task_path, sizeof(task_path), "/proc/%llu/task", pid);
+
+    // Threads may be created while we attach to the others, so keep
+    // scanning until a pass finds nothing new.
+    bool found_new_thread = true;
+    while (found_new_thread && error.Success())
+    {
+        found_new_thread = false;
+        DIR *dir = opendir(task_path);
+        if (dir == NULL)
+        {
+            error.SetErrorStringWithFormat("no such process: %llu", pid);
+            break;
+        }
+
+        struct dirent *entry;
+        while ((entry = readdir(dir)) != NULL)
+        {
+            char *end = NULL;
+            const lldb::tid_t tid = strtoul(entry->d_name, &end, 10);
+            if (entry->d_name[0] == '.' || end == NULL || *end != '\0')
+                continue;
+            if (m_threads.find(tid) != m_threads.end())
+                continue;
+
+            if (ptrace(PTRACE_ATTACH, tid, NULL, NULL) < 0)
+            {
+                // Threads other than the main one may have exited already.
+                if (tid == pid)
+                {
+                    error.SetErrorToErrno();
+                    break;
+                }
+                continue;
+            }
+
+            int status;
+            if (waitpid(tid, &status, __WALL) < 0 || !WIFSTOPPED(status))
+                continue;
+            ptrace(PTRACE_SETOPTIONS, tid, NULL, (void*)PTRACE_O_TRACECLONE);
+
+            ThreadState &thread = AddThread(tid, eStateStopped);
+            if (WSTOPSIG(status) != SIGSTOP)
+            {
+                // Some other signal got there first, report it and throw
+                // our SIGSTOP away when it shows up.
+                thread.stop_reason = eStopReasonSignal;
+                thread.stop_signo = WSTOPSIG(status);
+                thread.sigstop_pending = true;
+            }
+            found_new_thread = true;
+        }
+        closedir(dir);
+    }
+
+    if (error.Success() && m_threads.find(pid) == m_threads.end())
+        error.SetErrorStringWithFormat("unable to attach to process %llu", pid);
+
+    if (error.Fail())
+    {
+        for (ThreadMap::iterator pos = m_threads.begin(); pos != m_threads.end(); ++pos)
+            ptrace(PTRACE_DETACH, pos->first, NULL, NULL);
+        Reset();
+        return error;
+    }
+
+    if (!InitializeProcess(pid, error))
+        return error;
+
+    ThreadState &thread = m_threads[pid];
+    if (thread.stop_reason == eStopReasonNone)
+    {
+        thread.stop_reason = eStopReasonSignal;
+        thread.stop_signo = SIGSTOP;
+    }
+    m_stop_tid = pid;
+    m_state = eStateStopped;
+    return error;
+}
+
+Error
+NativeProcessLinux::Detach()
+{
+    Error error;
+    if (m_pid == LLDB_INVALID_PROCESS_ID)
+    {
+        error.SetErrorString("no process to detach from");
+        return error;
+    }
+
+    if (m_state == eStateRunning)
+    {
+        StopAllThreads();
+        m_state = eStateStopped;
+    }
+
+    while (!m_breakpoints.empty())
+        RemoveBreakpoint(m_breakpoints.begin()->first);
+
+    bool sigstop_pending = false;
+    for (ThreadMap::iterator pos = m_threads.begin(); pos != m_threads.end(); ++pos)
+    {
+        if (pos->second.sigstop_pending)
+            sigstop_pending = true;
+        ptrace(PTRACE_DETACH, pos->first, NULL, NULL);
+    }
+
+    // A SIGSTOP we sent but never collected would stop the process as soon
+    // as we let go of it.
+    if (sigstop_pending)
+        kill(m_pid, SIGCONT);
+
+    Reset();
+    m_pid = LLDB_INVALID_PROCESS_ID;
+    m_state = eStateDetached;
+    return error;
+}
+
+Error
+NativeProcessLinux::Kill()
+{
+    Error error;
+    if (m_pid == LLDB_INVALID_PROCESS_ID || m_state == eStateExited)
+    {
+        error.SetErrorString("no process to kill");
+        return error;
+    }
+
+    if (kill(m_pid, SIGKILL) < 0)
+    {
+        error.SetErrorToErrno();
+        return error;
+    }
+
+    // Reap every thread so nothing is left behind as a zombie.
+    int status;
+    ::pid_t wpid;
+    while ((wpid = waitpid(-1, &status, __WALL)) > 0)
+    {
+        if (wpid == (::pid_t)m_pid && (WIFEXITED(status) || WIFSIGNALED(status)))
+        {
+            m_exit_status = WIFEXITED(status) ? WEXITSTATUS(status) : 0;
+            m_exit_signo = WIFSIGNALED(status) ? WTERMSIG(status) : 0;
+            break;
+        }
+    }
+
+    Reset();
+    m_state = eStateExited;
+    return error;
+}
+
+Error
+NativeProcessLinux::Interrupt()
+{
+    Error error;
+    if (m_state != eStateRunning || m_interrupt_pending)
+        return error;
+
+    // Prefer the main thread, but it may have exited already.
+    lldb::tid_t tid = m_pid;
+    ThreadMap::iterator pos = m_threads.find(tid);
+    if (pos == m_threads.end() || pos->second.state == eStateStopped)
+    {
+        for (pos = m_threads.begin(); pos != m_threads.end(); ++pos)
+        {
+            if (pos->second.state != eStateStopped)
+                break;
+        }
+        if (pos == m_threads.end())
+        {
+            error.SetErrorString("no running thread to interrupt");
+            return error;
+        }
+        tid = pos->first;
+    }
+
+    if (syscall(SYS_tgkill, m_pid, tid, SIGSTOP) < 0)
+    {
+        error.SetErrorToErrno();
+        return error;
+    }
+    m_interrupt_tid = tid;
+    m_interrupt_pending = true;
+    return error;
+}
+
+Error
+NativeProcessLinux::Resume(const ResumeActionList &actions)
+{
+    Error error;
+    if (m_state != eStateStopped)
+    {
+        error.SetErrorString("process is not stopped");
+        return error;
+    }
+
+    const ResumeAction *default_action = NULL;
+    for (ResumeActionList::const_iterator pos = actions.begin(); pos != actions.end(); ++pos)
+    {
+        if (pos->tid == LLDB_INVALID_THREAD_ID)
+            default_action = &*pos;
+    }
+
+    bool resumed = false;
+    for (ThreadMap::iterator pos = m_threads.begin(); pos != m_threads.end(); ++pos)
+    {
+        const ResumeAction *action = default_action;
+        for (ResumeActionList::const_iterator apos = actions.begin(); apos != actions.end(); ++apos)
+        {
+            if (apos->tid == pos->first)
+                action = &*apos;
+        }
+        if (action == NULL)
+            continue;
+
+        ThreadState &thread = pos->second;
+        const bool stepping = action->state == eStateStepping;
+        const int signo = action->signo ? GetHostSignal(action->signo) : 0;
+        if (ptrace(stepping ? PTRACE_SINGLESTEP : PTRACE_CONT, pos->first, NULL, (void*)(intptr_t)signo) < 0)
+        {
+            error.SetErrorToErrno();
+            continue;
+        }
+        thread.state = stepping ? eStateStepping : eStateRunning;
+        thread.stop_reason = eStopReasonNone;
+        thread.stop_signo = 0;
+        thread.stepping = stepping;
+        resumed = true;
+    }
+
+    if (!resumed)
+    {
+        if (error.Success())
+            error.SetErrorString("no threads to resume");
+        return error;
+    }
+
+    m_stop_tid = LLDB_INVALID_THREAD_ID;
+    m_state = eStateRunning;
+    return Error();
+}
+
+bool
+NativeProcessLinux::CheckForStop()
+{
+    if (m_state != eStateRunning)
+        return true;
+
+    int status;
+    ::pid_t wpid;
+    while ((wpid = waitpid(-1, &status, __WALL | WNOHANG)) > 0)
+    {
+        if (HandleWaitStatus(wpid, status))
+        {
+            if (m_state != eStateExited)
+            {
+                StopAllThreads();
+                m_state = eStateStopped;
+            }
+            return true;
+        }
+    }
+
+    if (wpid < 0 && errno == ECHILD)
+    {
+        // Nothing left to wait for, the process is gone.
+        Reset();
+        m_state = eStateExited;
+        return true;
+    }
+    return false;
+}
+
+bool
+NativeProcessLinux::HandleWaitStatus(lldb::tid_t tid, int status)
+{
+    if (WIFEXITED(status) || WIFSIGNALED(status))
+    {
+        if (tid == m_pid)
+        {
+            m_exit_status = WIFEXITED(status) ? WEXITSTATUS(status) : 0;
+            m_exit_signo = WIFSIGNALED(status) ? WTERMSIG(status) : 0;
+            Reset();
+            m_state = eStateExited;
+            return true;
+        }
+        m_threads.erase(tid);
+        return false;
+    }
+
+    if (!WIFSTOPPED(status))
+        return false;
+
+    const int signo = WSTOPSIG(status);
+    ThreadMap::iterator pos = m_threads.find(tid);
+    if (pos == m_threads.end())
+    {
+        // A new thread can report its initial SIGSTOP before the thread that
+        // created it reports the clone.
+        AddThread(tid, eStateRunning);
+        pos = m_threads.find(tid);
+        if (signo == SIGSTOP)
+        {
+            ResumeThread(tid, pos->second);
+            return false;
+        }
+    }
+
+    ThreadState &thread = pos->second;
+    if (signo == SIGTRAP && (status >> 16) == PTRACE_EVENT_CLONE)
+    {
+        unsigned long new_tid = 0;
+        if (ptrace(PTRACE_GETEVENTMSG, tid, NULL, &new_tid) == 0 &&
+            m_threads.find(new_tid) == m_threads.end())
+        {
+            // Collect the initial SIGSTOP of the new thread and let it run.
+            int new_status;
+            if (waitpid(new_tid, &new_status, __WALL) == (::pid_t)new_tid && WIFSTOPPED(new_status))
+            {
+                ResumeThread(new_tid, AddThread(new_tid, eStateRunning));
+            }
+        }
+        ResumeThread(tid, thread);
+        return false;
+    }
+
+    if (signo == SIGSTOP)
+    {
+        if (m_interrupt_pending && tid == m_interrupt_tid)
+        {
+            m_interrupt_pending = false;
+            thread.state = eStateStopped;
+            thread.stop_reason = eStopReasonSignal;
+            thread.stop_signo = SIGSTOP;
+            m_stop_tid = tid;
+            return true;
+        }
+        if (thread.sigstop_pending)
+        {
+            thread.sigstop_pending = false;
+            ResumeThread(tid, thread);
+            return false;
+        }
+    }
+
+    thread.state = eStateStopped;
+    if (signo == SIGTRAP)
+        HandleTrap(tid, thread);
+    else
+    {
+        thread.stop_reason = eStopReasonSignal;
+        thread.stop_signo = signo;
+    }
+    m_stop_tid = tid;
+    return true;
+}
+
+void
+NativeProcessLinux::HandleTrap(lldb::tid_t tid, ThreadState &thread)
+{
+    thread.stop_reason = eStopReasonSignal;
+    thread.stop_signo = SIGTRAP;
+
+    siginfo_t info;
+    if (ptrace(PTRACE_GETSIGINFO, tid, NULL, &info) < 0)
+        return;
+
+    lldb::addr_t pc;
+    if ((info.si_code == SI_KERNEL || info.si_code == TRAP_BRKPT) &&
+        ReadPC(tid, pc) && m_breakpoints.find(pc - 1) != m_breakpoints.end())
+    {
+        // The int3 has executed, back the pc up to the breakpoint address.
+        if (WritePC(tid, pc - 1))
+            thread.stop_reason = eStopReasonBreakpoint;
+    }
+    else if (thread.stepping || info.si_code == TRAP_TRACE)
+        thread.stop_reason = eStopReasonTrace;
+}
+
+void
+NativeProcessLinux::StopAllThreads()
+{
+    // If the thread we interrupted stopped for another reason, the SIGSTOP
+    // is still on its way.
+    if (m_interrupt_pending)
+    {
+        ThreadMap::iterator pos = m_threads.find(m_interrupt_tid);
+        if (pos != m_threads.end())
+            pos->second.sigstop_pending = true;
+        m_interrupt_pending = false;
+    }
+
+    std::vector<lldb::tid_t> running;
+    for (ThreadMap::iterator pos = m_threads.begin(); pos != m_threads.end(); ++pos)
+    {
+        ThreadState &thread = pos->second;
+        if (thread.state == eStateStopped)
+            continue;
+        if (!thread.sigstop_pending)
+        {
+            if (syscall(SYS_tgkill, m_pid, pos->first, SIGSTOP) < 0)
+                continue;
+            thread.sigstop_pending = true;
+        }
+        running.push_back(pos->first);
+    }
+
+    for (size_t i = 0; i < running.size(); ++i)
+    {
+        const lldb::tid_t tid = running[i];
+        for (;;)
+        {
+            ThreadMap::iterator pos = m_threads.find(tid);
+            if (pos == m_threads.end())
+                break;
+            ThreadState &thread = pos->second;
+
+            int status;
+            if (waitpid(tid, &status, __WALL) != (::pid_t)tid || !WIFSTOPPED(status))
+            {
+                m_threads.erase(pos);
+                break;
+            }
+
+            const int signo = WSTOPSIG(status);
+            if (signo == SIGTRAP && (status >> 16) == PTRACE_EVENT_CLONE)
+            {
+                // Keep the new thread stopped along with everybody else.
+                unsigned long new_tid = 0;
+                if (ptrace(PTRACE_GETEVENTMSG, tid, NULL, &new_tid) == 0 &&
+                    m_threads.find(new_tid) == m_threads.end())
+                {
+                    int new_status;
+                    if (waitpid(new_tid, &new_status, __WALL) == (::pid_t)new_tid && WIFSTOPPED(new_status))
+                        AddThread(new_tid, eStateStopped);
+                }
+                ResumeThread(tid, thread);
+                continue;
+            }
+
+            thread.state = eStateStopped;
+            if (signo == SIGSTOP)
+            {
+                thread.sigstop_pending = false;
+                thread.stop_reason = eStopReasonNone;
+                thread.stop_signo = 0;
+            }
+            else if (signo == SIGTRAP)
+                HandleTrap(tid, thread);
+            else
+            {
+                thread.stop_reason = eStopReasonSignal;
+                thread.stop_signo = signo;
+            }
+            break;
+        }
+    }
+}
+
+int
+NativeProcessLinux::GetExitStatus(int *signo_ptr) const
+{
+    if (signo_ptr)
+        *signo_ptr = m_exit_signo;
+    return m_exit_status;
+}
+
+size_t
+NativeProcessLinux::GetThreadIDs(std::vector<lldb::tid_t> &tids) const
+{
+    tids.clear();
+    for (ThreadMap::const_iterator pos = m_threads.begin(); pos != m_threads.end(); ++pos)
+        tids.push_back(pos->first);
+    return tids.size();
+}
+
+bool
+NativeProcessLinux::HasThread(lldb::tid_t tid) const
+{
+    return m_threads.find(tid) != m_threads.end();
+}
+
+bool
+NativeProcessLinux::GetThreadStopInfo(lldb::tid_t tid, StopReason &reason, int &signo) const
+{
+    ThreadMap::const_iterator pos = m_threads.find(tid);
+    if (pos == m_threads.end() || pos->second.state != eStateStopped)
+        return false;
+    reason = pos->second.stop_reason;
+    signo = pos->second.stop_signo ? GetGDBSignal(pos->second.stop_signo) : 0;
+    return true;
+}
+
+//------------------------------------------------------------------------------
+// Memory.
+
+size_t
+NativeProcessLinux::ReadMemory(lldb::addr_t addr, void *buf, size_t size,
+                               Error &error)
+{
+    error.Clear();
+    if (m_pid == LLDB_INVALID_PROCESS_ID || m_state == eStateExited)
+    {
+        error.SetErrorString("no process");
+        return 0;
+    }
+
+    size_t bytes_read = 0;
+    if (m_mem_fd >= 0)
+    {
+        const ssize_t result = pread(m_mem_fd, buf, size, addr);
+        if (result > 0)
+            bytes_read = result;
+    }
+    if (bytes_read < size)
+        bytes_read += ReadMemoryWithPtrace(addr + bytes_read,
+                                           (uint8_t *)buf + bytes_read,
+                                           size - bytes_read,
+                                           error);
+    if (bytes_read > 0)
+        error.Clear();
+
+    // Show the original opcodes under our breakpoints.
+    const lldb::addr_t end_addr = addr + bytes_read;
+    for (BreakpointMap::const_iterator pos = m_breakpoints.lower_bound(addr);
+         pos != m_breakpoints.end() && pos->first < end_addr;
+         ++pos)
+    {
+        ((uint8_t *)buf)[pos->first - addr] = pos->second;
+    }
+    return bytes_read;
+}
+
+size_t
+NativeProcessLinux::WriteMemory(lldb::addr_t addr, const void *buf, size_t size,
+                                Error &error)
+{
+    error.Clear();
+    if (m_pid == LLDB_INVALID_PROCESS_ID || m_state == eStateExited)
+    {
+        error.SetErrorString("no process");
+        return 0;
+    }
+
+    BreakpointMap::iterator pos = m_breakpoints.lower_bound(addr);
+    if (pos == m_breakpoints.end() || pos->first >= addr + size)
+        return WriteMemoryWithPtrace(addr, buf, size, error);
+
+    // Keep our breakpoints in place and remember the new opcodes under them.
+    std::vector<uint8_t> data((const uint8_t *)buf, (const uint8_t *)buf + size);
+    for (; pos != m_breakpoints.end() && pos->first < addr + size; ++pos)
+    {
+        pos->second = data[pos->first - addr];
+        data[pos->first - addr] = 0xcc;
+    }
+    return WriteMemoryWithPtrace(addr, &data[0], size, error);
+}
+
+size_t
+NativeProcessLinux::ReadMemoryWithPtrace(lldb::addr_t addr, void *buf, size_t size,
+                                         Error &error)
+{
+    uint8_t *dst = (uint8_t *)buf;
+    size_t bytes_read = 0;
+    while (bytes_read < size)
+    {
+        const lldb::addr_t word_addr = (addr + bytes_read) & ~(lldb::addr_t)(sizeof(long) - 1);
+        const size_t word_offset = (addr + bytes_read) - word_addr;
+
+        errno = 0;
+        long word = ptrace(PTRACE_PEEKDATA, m_pid, (void*)word_addr, NULL);
+        if (errno)
+        {
+            error.SetErrorToErrno();
+            break;
+        }
+
+        const size_t count = std::min(sizeof(word) - word_offset, size - bytes_read);
+        memcpy(dst + bytes_read, (uint8_t *)&word + word_offset, count);
+        bytes_read += count;
+    }
+    return bytes_read;
+}
+
+size_t
+NativeProcessLinux::WriteMemoryWithPtrace(lldb::addr_t addr, const void *buf, size_t size,
+                                          Error &error)
+{
+    const uint8_t *src = (const uint8_t *)buf;
+    size_t bytes_written = 0;
+    while (bytes_written < size)
+    {
+        const lldb::addr_t word_addr = (addr + bytes_written) & ~(lldb::addr_t)(sizeof(long) - 1);
+        const size_t word_offset = (addr + bytes_written) - word_addr;
+        const size_t count = std::min(sizeof(long) - word_offset, size - bytes_written);
+
+        long word = 0;
+        if (count < sizeof(word))
+        {
+            // Merge partial words with what is already there.
+            errno = 0;
+            word = ptrace(PTRACE_PEEKDATA, m_pid, (void*)word_addr, NULL);
+            if (errno)
+            {
+                error.SetErrorToErrno();
+                break;
+            }
+        }
+        memcpy((uint8_t *)&word + word_offset, src + bytes_written, count);
+
+        if (ptrace(PTRACE_POKEDATA, m_pid, (void*)word_addr, (void*)word) < 0)
+        {
+            error.SetErrorToErrno();
+            break;
+        }
+        bytes_written += count;
+    }
+    return bytes_written;
+}
+
+Error
+NativeProcessLinux::SetBreakpoint(lldb::addr_t addr)
+{
+    Error error;
+    if (m_breakpoints.find(addr) != m_breakpoints.end())
+        return error;
+
+    uint8_t saved_opcode;
+    if (ReadMemoryWithPtrace(addr, &saved_opcode, 1, error) != 1)
+        return error;
+
+    static const uint8_t int3 = 0xcc;
+    if (WriteMemoryWithPtrace(addr, &int3, 1, error) != 1)
+        return error;
+
+    m_breakpoints[addr] = saved_opcode;
+    return error;
+}
+
+Error
+NativeProcessLinux::RemoveBreakpoint(lldb::addr_t addr)
+{
+    Error error;
+    BreakpointMap::iterator pos = m_breakpoints.find(addr);
+    if (pos == m_breakpoints.end())
+    {
+        error.SetErrorStringWithFormat("no breakpoint at 0x%llx", addr);
+        return error;
+    }
+
+    const uint8_t saved_opcode = pos->second;
+    m_breakpoints.erase(pos);
+    WriteMemoryWithPtrace(addr, &saved_opcode, 1, error);
+    return error;
+}
+
+//------------------------------------------------------------------------------
+// Registers.
+
+uint32_t
+NativeProcessLinux::GetRegisterCount()
+{
+    return RegisterContext_x86_64::GetStaticRegisterCount();
+}
+
+const RegisterInfo *
+NativeProcessLinux::GetRegisterInfoAtIndex(uint32_t reg)
+{
+    return RegisterContext_x86_64::GetStaticRegisterInfoAtIndex(reg);
+}
+
+const char *
+NativeProcessLinux::GetRegisterSetName(uint32_t reg)
+{
+    const uint32_t num_sets = RegisterContext_x86_64::GetStaticRegisterSetCount();
+    for (uint32_t set = 0; set < num_sets; ++set)
+    {
+        const RegisterSet *reg_set = RegisterContext_x86_64::GetStaticRegisterSet(set);
+        if (std::find(reg_set->registers, reg_set->registers + reg_set->num_registers, reg) !=
+            reg_set->registers + reg_set->num_registers)
+            return reg_set->name;
+    }
+    return NULL;
+}
+
+size_t
+NativeProcessLinux::GetRegisterDataByteSize()
+{
+    // The register offsets are into a UserArea, we only fill in the part
+    // of it up to the end of the floating point registers.
+    return offsetof(RegisterContext_x86_64::UserArea, i387) + sizeof(RegisterContext_x86_64::FPU);
+}
+
+bool
+NativeProcessLinux::ReadRegisterData(lldb::tid_t tid, void *buf, size_t size)
+{
+    if (size < GetRegisterDataByteSize() || !HasThread(tid))
+        return false;
+
+    uint8_t *data = (uint8_t *)buf;
+    return ptrace(PTRACE_GETREGS, tid, NULL, data + offsetof(RegisterContext_x86_64::UserArea, regs)) == 0 &&
+           ptrace(PTRACE_GETFPREGS, tid, NULL, data + offsetof(RegisterContext_x86_64::UserArea, i387)) == 0;
+}
+
+bool
+NativeProcessLinux::WriteRegisterData(lldb::tid_t tid, const void *buf, size_t size)
+{
+    if (size < GetRegisterDataByteSize() || !HasThread(tid))
+        return false;
+
+    uint8_t *data = (uint8_t *)const_cast<void *>(buf);
+    return ptrace(PTRACE_SETREGS, tid, NULL, data + offsetof(RegisterContext_x86_64::UserArea, regs)) == 0 &&
+           ptrace(PTRACE_SETFPREGS, tid, NULL, data + offsetof(RegisterContext_x86_64::UserArea, i387)) == 0;
+}
+
+bool
+NativeProcessLinux::ReadPC(lldb::tid_t tid, lldb::addr_t &pc)
+{
+    errno = 0;
+    pc = ptrace(PTRACE_PEEKUSER, tid, (void*)offsetof(struct user, regs.rip), NULL);
+    return errno == 0;
+}
+
+bool
+NativeProcessLinux::WritePC(lldb::tid_t tid, lldb::addr_t pc)
+{
+    return ptrace(PTRACE_POKEUSER, tid, (void*)offsetof(struct user, regs.rip), (void*)pc) == 0;
+}
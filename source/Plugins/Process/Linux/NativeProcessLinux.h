@@ -0,0 +1,235 @@
+//===-- NativeProcessLinux.h ---------------------------------- -*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_NativeProcessLinux_H_
+#define liblldb_NativeProcessLinux_H_
+
+// C Includes
+// C++ Includes
+#include <map>
+#include <vector>
+
+// Other libraries and framework includes
+#include "lldb/lldb-private.h"
+#include "lldb/Core/Error.h"
+
+namespace lldb_private
+{
+class ProcessLaunchInfo;
+
+} // End lldb_private namespace.
+
+/// @class NativeProcessLinux
+/// @brief Debugs a Linux process directly with ptrace on behalf of a remote
+/// debugger.
+///
+/// ProcessMonitor serves lldb's own Process and Thread objects and funnels
+/// every request through a dedicated operation thread.  This class is used
+/// by the gdb-remote server instead, which has no such objects and talks to
+/// the inferior from a single thread: all calls must be made from the thread
+/// that launched or attached to the process, since that is the only thread
+/// the kernel lets use ptrace on it.
+///
+/// The process is debugged in all-stop mode: whenever one thread stops, all
+/// other threads are stopped too before the stop is reported.  Only x86_64
+/// inferiors are supported.
+///
+/// Signal numbers passed in and out of this class are the ones used on the
+/// wire by the GDB remote protocol, not the host's numbering.
+class NativeProcessLinux
+{
+public:
+    /// @brief How a thread should be resumed.
+    struct ResumeAction
+    {
+        lldb::tid_t tid;        ///< LLDB_INVALID_THREAD_ID for the default action.
+        lldb::StateType state;  ///< eStateRunning or eStateStepping.
+        int signo;              ///< Signal to deliver to the thread, or zero.
+    };
+
+    typedef std::vector<ResumeAction> ResumeActionList;
+
+    /// @brief Why a thread is stopped.
+    enum StopReason
+    {
+        eStopReasonNone,
+        eStopReasonSignal,
+        eStopReasonBreakpoint,
+        eStopReasonTrace
+    };
+
+    NativeProcessLinux();
+
+    ~NativeProcessLinux();
+
+    /// Launches and stops the process described by @p launch_info at its
+    /// first instruction.
+    lldb_private::Error
+    Launch(lldb_private::ProcessLaunchInfo &launch_info);
+
+    /// Attaches to and stops every thread of process @p pid.
+    lldb_private::Error
+    Attach(lldb::pid_t pid);
+
+    /// Removes all breakpoints and lets the process run free.
+    lldb_private::Error
+    Detach();
+
+    lldb_private::Error
+    Kill();
+
+    /// Asks a running process to stop.  The stop is reported by a later call
+    /// to CheckForStop().
+    lldb_private::Error
+    Interrupt();
+
+    /// Resumes the threads named in @p actions.  Threads without an action
+    /// of their own use the default one, or stay stopped if there is none.
+    lldb_private::Error
+    Resume(const ResumeActionList &actions);
+
+    /// Reaps pending events from a running process without blocking.
+    ///
+    /// @return
+    ///     True if the process stopped or exited.
+    bool
+    CheckForStop();
+
+    lldb::pid_t
+    GetID() const { return m_pid; }
+
+    lldb::StateType
+    GetState() const { return m_state; }
+
+    /// The exit status of an exited process, or the signal that killed it
+    /// if @p signo_ptr is set to a non-zero value.
+    int
+    GetExitStatus(int *signo_ptr = NULL) const;
+
+    /// The thread that caused the last stop.
+    lldb::tid_t
+    GetStopThreadID() const { return m_stop_tid; }
+
+    size_t
+    GetThreadIDs(std::vector<lldb::tid_t> &tids) const;
+
+    bool
+    HasThread(lldb::tid_t tid) const;
+
+    bool
+    GetThreadStopInfo(lldb::tid_t tid, StopReason &reason, int &signo) const;
+
+    size_t
+    ReadMemory(lldb::addr_t addr, void *buf, size_t size,
+               lldb_private::Error &error);
+
+    size_t
+    WriteMemory(lldb::addr_t addr, const void *buf, size_t size,
+                lldb_private::Error &error);
+
+    lldb_private::Error
+    SetBreakpoint(lldb::addr_t addr);
+
+    lldb_private::Error
+    RemoveBreakpoint(lldb::addr_t addr);
+
+    //------------------------------------------------------------------
+    // Registers are numbered by their index in a static table, which is
+    // also the number used for them by the GDB remote protocol.  The
+    // register data of a thread is one buffer holding its general purpose
+    // and floating point registers, and each RegisterInfo gives the offset
+    // of a register within that buffer.
+    //------------------------------------------------------------------
+    static uint32_t
+    GetRegisterCount();
+
+    static const lldb_private::RegisterInfo *
+    GetRegisterInfoAtIndex(uint32_t reg);
+
+    static const char *
+    GetRegisterSetName(uint32_t reg);
+
+    static size_t
+    GetRegisterDataByteSize();
+
+    bool
+    ReadRegisterData(lldb::tid_t tid, void *buf, size_t size);
+
+    bool
+    WriteRegisterData(lldb::tid_t tid, const void *buf, size_t size);
+
+    static int
+    GetGDBSignal(int host_signo);
+
+    static int
+    GetHostSignal(int gdb_signo);
+
+private:
+    struct ThreadState
+    {
+        lldb::StateType state;
+        StopReason stop_reason;
+        int stop_signo;         ///< Host signal number.
+        bool stepping;          ///< Resumed with PTRACE_SINGLESTEP.
+        bool sigstop_pending;   ///< We sent a SIGSTOP it has not seen yet.
+    };
+
+    typedef std::map<lldb::tid_t, ThreadState> ThreadMap;
+    typedef std::map<lldb::addr_t, uint8_t> BreakpointMap;
+
+    lldb::pid_t m_pid;
+    lldb::StateType m_state;
+    lldb::tid_t m_stop_tid;
+    int m_exit_status;
+    int m_exit_signo;
+    int m_mem_fd;               ///< /proc/<pid>/mem, used for fast reads.
+    lldb::tid_t m_interrupt_tid;  ///< Thread sent a SIGSTOP by Interrupt().
+    bool m_interrupt_pending;
+    ThreadMap m_threads;
+    BreakpointMap m_breakpoints;
+
+    void
+    Reset();
+
+    ThreadState &
+    AddThread(lldb::tid_t tid, lldb::StateType state);
+
+    void
+    ResumeThread(lldb::tid_t tid, const ThreadState &thread);
+
+    bool
+    InitializeProcess(lldb::pid_t pid, lldb_private::Error &error);
+
+    bool
+    HandleWaitStatus(lldb::tid_t tid, int status);
+
+    void
+    HandleTrap(lldb::tid_t tid, ThreadState &thread);
+
+    void
+    StopAllThreads();
+
+    size_t
+    ReadMemoryWithPtrace(lldb::addr_t addr, void *buf, size_t size,
+                         lldb_private::Error &error);
+
+    size_t
+    WriteMemoryWithPtrace(lldb::addr_t addr, const void *buf, size_t size,
+                          lldb_private::Error &error);
+
+    bool
+    ReadPC(lldb::tid_t tid, lldb::addr_t &pc);
+
+    bool
+    WritePC(lldb::tid_t tid, lldb::addr_t pc);
+
+    DISALLOW_COPY_AND_ASSIGN(NativeProcessLinux);
+};
+
+#endif // #ifndef liblldb_NativeProcessLinux_H_
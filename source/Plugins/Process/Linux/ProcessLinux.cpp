@@ -97,24 +97,30 @@ ProcessLinux::GetPluginDescriptionStatic()
 uint32_t
 ProcessLinux::UpdateThreadList(ThreadList &old_thread_list, ThreadList &new_thread_list)
 {
-    LogSP log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_THREAD));
-    if (log && log->GetMask().Test(POSIX_LOG_VERBOSE))
-        log->Printf ("ProcessLinux::%s() (pid = %i)", __FUNCTION__, GetID());
-
-    // Update the process thread list with this new thread.
-    // FIXME: We should be using tid, not pid.
-    assert(m_monitor);
-    ThreadSP thread_sp (old_thread_list.FindThreadByID (GetID(), false));
-    if (!thread_sp)
-        thread_sp.reset(new POSIXThread(*this, GetID()));
-
-    if (log && log->GetMask().Test(POSIX_LOG_VERBOSE))
-        log->Printf ("ProcessLinux::%s() updated pid = %i", __FUNCTION__, GetID());
-    new_thread_list.AddThread(thread_sp);
-
-    return new_thread_list.GetSize(false);
+    // The monitor tracks thread creation and exit, so the generic
+    // implementation has everything it needs.
+    return ProcessPOSIX::UpdateThreadList(old_thread_list, new_thread_list);
 }
 
+size_t
+ProcessLinux::DoReadMemoryRanges(MemoryReadRange *ranges, size_t num_ranges,
+                                 Error &error)
+{
+    std::vector<ProcessMonitor::ReadRange> monitor_ranges(num_ranges);
+    for (size_t i = 0; i < num_ranges; ++i)
+    {
+        monitor_ranges[i].m_addr = ranges[i].addr;
+        monitor_ranges[i].m_buf = ranges[i].buf;
+        monitor_ranges[i].m_size = ranges[i].size;
+        monitor_ranges[i].m_bytes_read = 0;
+    }
+
+    const size_t bytes_read =
+        GetMonitor().ReadMemoryRanges(&monitor_ranges[0], num_ranges, error);
+    for (size_t i = 0; i < num_ranges; ++i)
+        ranges[i].bytes_read = monitor_ranges[i].m_bytes_read;
+    return bytes_read;
+}
 
 //------------------------------------------------------------------------------
 // ProcessInterface protocol.
@@ -54,6 +54,13 @@ public:
 
     virtual uint32_t
     UpdateThreadList(lldb_private::ThreadList &old_thread_list, lldb_private::ThreadList &new_thread_list);
+
+    /// Reads all of the ranges with as few process_vm_readv calls as
+    /// possible.
+    virtual size_t
+    DoReadMemoryRanges(MemoryReadRange *ranges, size_t num_ranges,
+                       lldb_private::Error &error);
+
     //------------------------------------------------------------------
     // PluginInterface protocol
     //------------------------------------------------------------------
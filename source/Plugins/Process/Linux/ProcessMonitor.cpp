@@ -8,22 +8,36 @@
 //===----------------------------------------------------------------------===//
 
 // C Includes
+#include <dirent.h>
 #include <errno.h>
+#include <fcntl.h>
+#include <limits.h>
 #include <poll.h>
+#include <stddef.h>
+#include <pthread.h>
+#include <stdio.h>
+#include <stdlib.h>
 #include <string.h>
 #include <unistd.h>
+#include <sys/personality.h>
 #include <sys/ptrace.h>
 #include <sys/socket.h>
+#include <sys/syscall.h>
 #include <sys/types.h>
+#include <sys/uio.h>
+#include <sys/user.h>
 #include <sys/wait.h>
 
 // C++ Includes
+#include <vector>
+
 // Other libraries and framework includes
 #include "lldb/Core/Debugger.h"
 #include "lldb/Core/Error.h"
 #include "lldb/Core/RegisterValue.h"
 #include "lldb/Core/Scalar.h"
 #include "lldb/Host/Host.h"
+#include "lldb/Host/TimeValue.h"
 #include "lldb/Target/Thread.h"
 #include "lldb/Target/RegisterContext.h"
 #include "lldb/Utility/PseudoTerminal.h"
@@ -36,6 +50,12 @@
 
 #define DEBUG_PTRACE_MAXBYTES 20
 
+// Older C libraries don't define the code of SIGTRAPs raised by the debug
+// registers.
+#ifndef TRAP_HWBKPT
+#define TRAP_HWBKPT 4
+#endif
+
 using namespace lldb_private;
 
 // FIXME: this code is host-dependent with respect to types and
@@ -296,6 +316,89 @@ DoWriteMemory(lldb::pid_t pid, unsigned word_size,
     return bytes_written;
 }
 
+//------------------------------------------------------------------------------
+// Bulk memory transfer helpers.  Unlike ptrace, process_vm_readv(2) and
+// /proc/<pid>/mem accesses are not restricted to the tracing thread, so they
+// can be issued directly from the client thread without a trip through the
+// operation thread.
+
+#ifndef IOV_MAX
+#define IOV_MAX 1024
+#endif
+
+// Set once the running kernel reports that process_vm_readv is not available.
+static bool g_vm_readv_unsupported = false;
+
+static ssize_t
+VMReadV(lldb::pid_t pid,
+        const struct iovec *local_iov, unsigned long local_count,
+        const struct iovec *remote_iov, unsigned long remote_count)
+{
+#ifdef __NR_process_vm_readv
+    if (!g_vm_readv_unsupported)
+    {
+        ssize_t result = syscall(__NR_process_vm_readv, pid,
+                                 local_iov, local_count,
+                                 remote_iov, remote_count, 0UL);
+        if (result < 0 && errno == ENOSYS)
+            g_vm_readv_unsupported = true;
+        return result;
+    }
+#endif
+    errno = ENOSYS;
+    return -1;
+}
+
+// Reads from /proc/<pid>/mem until @p size bytes are transferred or an error
+// occurs.  Returns the number of bytes read.
+static size_t
+ProcMemRead(int fd, lldb::addr_t vm_addr, void *buf, size_t size)
+{
+    uint8_t *dst = static_cast<uint8_t *>(buf);
+    size_t bytes_read = 0;
+
+    if (fd < 0)
+        return 0;
+
+    while (bytes_read < size)
+    {
+        ssize_t status = pread64(fd, dst + bytes_read, size - bytes_read,
+                                 (off64_t)(vm_addr + bytes_read));
+        if (status < 0 && errno == EINTR)
+            continue;
+        if (status <= 0)
+            break;
+        bytes_read += status;
+    }
+    return bytes_read;
+}
+
+// Writes to /proc/<pid>/mem until @p size bytes are transferred or an error
+// occurs.  Returns the number of bytes written.  Unlike process_vm_writev,
+// writes through /proc/<pid>/mem ignore page protections, which we rely on to
+// insert breakpoint opcodes into the text segment.
+static size_t
+ProcMemWrite(int fd, lldb::addr_t vm_addr, const void *buf, size_t size)
+{
+    const uint8_t *src = static_cast<const uint8_t *>(buf);
+    size_t bytes_written = 0;
+
+    if (fd < 0)
+        return 0;
+
+    while (bytes_written < size)
+    {
+        ssize_t status = pwrite64(fd, src + bytes_written, size - bytes_written,
+                                  (off64_t)(vm_addr + bytes_written));
+        if (status < 0 && errno == EINTR)
+            continue;
+        if (status <= 0)
+            break;
+        bytes_written += status;
+    }
+    return bytes_written;
+}
+
 // Simple helper function to ensure flags are enabled on the given file
 // descriptor.
 static bool
@@ -318,6 +421,42 @@ EnsureFDFlags(int fd, int flags, Error &error)
     return true;
 }
 
+// Collects the IDs of all threads of process @p pid from /proc/<pid>/task.
+static bool
+GetTaskIDs(lldb::pid_t pid, std::vector<lldb::tid_t> &tids, Error &error)
+{
+    char path[PATH_MAX];
+    DIR *dir;
+    struct dirent *entry;
+
+    ::snprintf(path, sizeof(path), "/proc/%d/task", (int)pid);
+    if ((dir = opendir(path)) == NULL)
+    {
+        error.SetErrorToErrno();
+        return false;
+    }
+
+    tids.clear();
+    while ((entry = readdir(dir)) != NULL)
+    {
+        char *end;
+        unsigned long tid = strtoul(entry->d_name, &end, 10);
+        if (end != entry->d_name && *end == '\0')
+            tids.push_back(tid);
+    }
+
+    closedir(dir);
+    return true;
+}
+
+// Offset of the debug register DR@p index within the user area accessed by
+// PTRACE_PEEKUSER and PTRACE_POKEUSER.
+static inline size_t
+GetDebugRegOffset(unsigned index)
+{
+    return offsetof(struct user, u_debugreg) + index * sizeof(((struct user *)0)->u_debugreg[0]);
+}
+
 //------------------------------------------------------------------------------
 /// @class Operation
 /// @brief Represents a ProcessMonitor operation.
@@ -332,9 +471,23 @@ EnsureFDFlags(int fd, int flags, Error &error)
 class Operation
 {
 public:
+    virtual ~Operation() { }
+
     virtual void Execute(ProcessMonitor *monitor) = 0;
 };
 
+//------------------------------------------------------------------------------
+/// @class OperationRequest
+/// @brief The unit of work passed to the operation thread.
+///
+/// A request refers to one or more operations which the operation thread
+/// executes in order before acknowledging the request.
+struct OperationRequest
+{
+    Operation *const *m_ops;
+    size_t m_count;
+};
+
 //------------------------------------------------------------------------------
 /// @class ReadOperation
 /// @brief Implements ProcessMonitor::ReadMemory.
@@ -404,13 +557,14 @@ WriteOperation::Execute(ProcessMonitor *monitor)
 class ReadRegOperation : public Operation
 {
 public:
-    ReadRegOperation(unsigned offset, RegisterValue &value, bool &result)
-        : m_offset(offset), m_value(value), m_result(result)
+    ReadRegOperation(lldb::tid_t tid, unsigned offset, RegisterValue &value, bool &result)
+        : m_tid(tid), m_offset(offset), m_value(value), m_result(result)
         { }
 
     void Execute(ProcessMonitor *monitor);
 
 private:
+    lldb::tid_t m_tid;
     unsigned m_offset;
     RegisterValue &m_value;
     bool &m_result;
@@ -419,12 +573,11 @@ private:
 void
 ReadRegOperation::Execute(ProcessMonitor *monitor)
 {
-    lldb::pid_t pid = monitor->GetPID();
     LogSP log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_REGISTERS));
 
     // Set errno to zero so that we can detect a failed peek.
     errno = 0;
-    lldb::addr_t data = PTRACE(PTRACE_PEEKUSER, pid, (void*)m_offset, NULL);
+    lldb::addr_t data = PTRACE(PTRACE_PEEKUSER, m_tid, (void*)m_offset, NULL);
     if (data == -1UL && errno)
         m_result = false;
     else
@@ -443,13 +596,14 @@ ReadRegOperation::Execute(ProcessMonitor *monitor)
 class WriteRegOperation : public Operation
 {
 public:
-    WriteRegOperation(unsigned offset, const RegisterValue &value, bool &result)
-        : m_offset(offset), m_value(value), m_result(result)
+    WriteRegOperation(lldb::tid_t tid, unsigned offset, const RegisterValue &value, bool &result)
+        : m_tid(tid), m_offset(offset), m_value(value), m_result(result)
         { }
 
     void Execute(ProcessMonitor *monitor);
 
 private:
+    lldb::tid_t m_tid;
     unsigned m_offset;
     const RegisterValue &m_value;
     bool &m_result;
@@ -459,7 +613,6 @@ void
 WriteRegOperation::Execute(ProcessMonitor *monitor)
 {
     void* buf;
-    lldb::pid_t pid = monitor->GetPID();
     LogSP log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_REGISTERS));
 
     if (sizeof(void*) == sizeof(uint64_t))
@@ -473,7 +626,81 @@ WriteRegOperation::Execute(ProcessMonitor *monitor)
     if (log)
         log->Printf ("ProcessMonitor::%s() reg %s: %p", __FUNCTION__,
                      POSIXThread::GetRegisterNameFromOffset(m_offset), buf);
-    if (PTRACE(PTRACE_POKEUSER, pid, (void*)m_offset, buf))
+    if (PTRACE(PTRACE_POKEUSER, m_tid, (void*)m_offset, buf))
+        m_result = false;
+    else
+        m_result = true;
+}
+
+//------------------------------------------------------------------------------
+/// @class ReadDebugRegOperation
+/// @brief Implements ProcessMonitor::ReadDebugRegisterValue.
+class ReadDebugRegOperation : public Operation
+{
+public:
+    ReadDebugRegOperation(lldb::tid_t tid, unsigned index, RegisterValue &value, bool &result)
+        : m_tid(tid), m_index(index), m_value(value), m_result(result)
+        { }
+
+    void Execute(ProcessMonitor *monitor);
+
+private:
+    lldb::tid_t m_tid;
+    unsigned m_index;
+    RegisterValue &m_value;
+    bool &m_result;
+};
+
+void
+ReadDebugRegOperation::Execute(ProcessMonitor *monitor)
+{
+    LogSP log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_REGISTERS));
+
+    // Set errno to zero so that we can detect a failed peek.
+    errno = 0;
+    lldb::addr_t data = PTRACE(PTRACE_PEEKUSER, m_tid, (void*)GetDebugRegOffset(m_index), NULL);
+    if (data == -1UL && errno)
+        m_result = false;
+    else
+    {
+        m_value = data;
+        m_result = true;
+    }
+    if (log)
+        log->Printf ("ProcessMonitor::%s() dr%u: 0x%llx", __FUNCTION__,
+                     m_index, (uint64_t)data);
+}
+
+//------------------------------------------------------------------------------
+/// @class WriteDebugRegOperation
+/// @brief Implements ProcessMonitor::WriteDebugRegisterValue.
+class WriteDebugRegOperation : public Operation
+{
+public:
+    WriteDebugRegOperation(lldb::tid_t tid, unsigned index, const RegisterValue &value, bool &result)
+        : m_tid(tid), m_index(index), m_value(value), m_result(result)
+        { }
+
+    void Execute(ProcessMonitor *monitor);
+
+private:
+    lldb::tid_t m_tid;
+    unsigned m_index;
+    const RegisterValue &m_value;
+    bool &m_result;
+};
+
+void
+WriteDebugRegOperation::Execute(ProcessMonitor *monitor)
+{
+    LogSP log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_REGISTERS));
+    void *buf = (void*)(uintptr_t)m_value.GetAsUInt64();
+
+    if (log)
+        log->Printf ("ProcessMonitor::%s() dr%u: %p", __FUNCTION__, m_index, buf);
+    // The kernel validates the control register against the addresses
+    // already in DR0-DR3, so callers write the addresses first.
+    if (PTRACE(PTRACE_POKEUSER, m_tid, (void*)GetDebugRegOffset(m_index), buf))
         m_result = false;
     else
         m_result = true;
@@ -485,13 +712,14 @@ WriteRegOperation::Execute(ProcessMonitor *monitor)
 class ReadGPROperation : public Operation
 {
 public:
-    ReadGPROperation(void *buf, bool &result)
-        : m_buf(buf), m_result(result)
+    ReadGPROperation(lldb::tid_t tid, void *buf, bool &result)
+        : m_tid(tid), m_buf(buf), m_result(result)
         { }
 
     void Execute(ProcessMonitor *monitor);
 
 private:
+    lldb::tid_t m_tid;
     void *m_buf;
     bool &m_result;
 };
@@ -499,7 +727,7 @@ private:
 void
 ReadGPROperation::Execute(ProcessMonitor *monitor)
 {
-    if (PTRACE(PTRACE_GETREGS, monitor->GetPID(), NULL, m_buf) < 0)
+    if (PTRACE(PTRACE_GETREGS, m_tid, NULL, m_buf) < 0)
         m_result = false;
     else
         m_result = true;
@@ -511,13 +739,14 @@ ReadGPROperation::Execute(ProcessMonitor *monitor)
 class ReadFPROperation : public Operation
 {
 public:
-    ReadFPROperation(void *buf, bool &result)
-        : m_buf(buf), m_result(result)
+    ReadFPROperation(lldb::tid_t tid, void *buf, bool &result)
+        : m_tid(tid), m_buf(buf), m_result(result)
         { }
 
     void Execute(ProcessMonitor *monitor);
 
 private:
+    lldb::tid_t m_tid;
     void *m_buf;
     bool &m_result;
 };
@@ -525,7 +754,7 @@ private:
 void
 ReadFPROperation::Execute(ProcessMonitor *monitor)
 {
-    if (PTRACE(PTRACE_GETFPREGS, monitor->GetPID(), NULL, m_buf) < 0)
+    if (PTRACE(PTRACE_GETFPREGS, m_tid, NULL, m_buf) < 0)
         m_result = false;
     else
         m_result = true;
@@ -537,13 +766,14 @@ ReadFPROperation::Execute(ProcessMonitor *monitor)
 class WriteGPROperation : public Operation
 {
 public:
-    WriteGPROperation(void *buf, bool &result)
-        : m_buf(buf), m_result(result)
+    WriteGPROperation(lldb::tid_t tid, void *buf, bool &result)
+        : m_tid(tid), m_buf(buf), m_result(result)
         { }
 
     void Execute(ProcessMonitor *monitor);
 
 private:
+    lldb::tid_t m_tid;
     void *m_buf;
     bool &m_result;
 };
@@ -551,7 +781,7 @@ private:
 void
 WriteGPROperation::Execute(ProcessMonitor *monitor)
 {
-    if (PTRACE(PTRACE_SETREGS, monitor->GetPID(), NULL, m_buf) < 0)
+    if (PTRACE(PTRACE_SETREGS, m_tid, NULL, m_buf) < 0)
         m_result = false;
     else
         m_result = true;
@@ -563,13 +793,14 @@ WriteGPROperation::Execute(ProcessMonitor *monitor)
 class WriteFPROperation : public Operation
 {
 public:
-    WriteFPROperation(void *buf, bool &result)
-        : m_buf(buf), m_result(result)
+    WriteFPROperation(lldb::tid_t tid, void *buf, bool &result)
+        : m_tid(tid), m_buf(buf), m_result(result)
         { }
 
     void Execute(ProcessMonitor *monitor);
 
 private:
+    lldb::tid_t m_tid;
     void *m_buf;
     bool &m_result;
 };
@@ -577,7 +808,7 @@ private:
 void
 WriteFPROperation::Execute(ProcessMonitor *monitor)
 {
-    if (PTRACE(PTRACE_SETFPREGS, monitor->GetPID(), NULL, m_buf) < 0)
+    if (PTRACE(PTRACE_SETFPREGS, m_tid, NULL, m_buf) < 0)
         m_result = false;
     else
         m_result = true;
@@ -608,8 +839,14 @@ ResumeOperation::Execute(ProcessMonitor *monitor)
     if (m_signo != LLDB_INVALID_SIGNAL_NUMBER)
         data = m_signo;
 
+    // Mark the thread running before it actually is, so that a stop reported
+    // by the monitor thread right after the resume is not overwritten.
+    monitor->ThreadResumed(m_tid, false);
     if (PTRACE(PTRACE_CONT, m_tid, NULL, (void*)data))
+    {
+        monitor->ThreadStopped(m_tid);
         m_result = false;
+    }
     else
         m_result = true;
 }
@@ -639,8 +876,12 @@ SingleStepOperation::Execute(ProcessMonitor *monitor)
     if (m_signo != LLDB_INVALID_SIGNAL_NUMBER)
         data = m_signo;
 
+    monitor->ThreadResumed(m_tid, true);
     if (PTRACE(PTRACE_SINGLESTEP, m_tid, NULL, (void*)data))
+    {
+        monitor->ThreadStopped(m_tid);
         m_result = false;
+    }
     else
         m_result = true;
 }
@@ -728,11 +969,13 @@ KillOperation::Execute(ProcessMonitor *monitor)
 class DetachOperation : public Operation
 {
 public:
-    DetachOperation(Error &result) : m_error(result) { }
+    DetachOperation(const std::vector<lldb::tid_t> &tids, Error &result)
+        : m_tids(tids), m_error(result) { }
 
     void Execute(ProcessMonitor *monitor);
 
 private:
+    const std::vector<lldb::tid_t> &m_tids;
     Error &m_error;
 };
 
@@ -741,6 +984,13 @@ DetachOperation::Execute(ProcessMonitor *monitor)
 {
     lldb::pid_t pid = monitor->GetPID();
 
+    // Each thread is traced on its own and must be released individually.
+    for (size_t i = 0; i < m_tids.size(); ++i)
+    {
+        if (m_tids[i] != pid)
+            ptrace(PT_DETACH, m_tids[i], NULL, 0);
+    }
+
     if (ptrace(PT_DETACH, pid, NULL, 0) < 0)
         m_error.SetErrorToErrno();
   
@@ -806,6 +1056,7 @@ ProcessMonitor::ProcessMonitor(ProcessPOSIX *process,
       m_operation_thread(LLDB_INVALID_HOST_THREAD),
       m_pid(LLDB_INVALID_PROCESS_ID),
       m_terminal_fd(-1),
+      m_mem_fd(-1),
       m_monitor_thread(LLDB_INVALID_HOST_THREAD),
       m_client_fd(-1),
       m_server_fd(-1)
@@ -848,8 +1099,8 @@ WAIT_AGAIN:
     }
 
     // Finally, start monitoring the child process for change in state.
-    m_monitor_thread = Host::StartMonitoringChildProcess(
-        ProcessMonitor::MonitorCallback, this, GetPID(), true);
+    m_monitor_thread = Host::ThreadCreate("lldb.process.linux.monitor",
+                                          MonitorThread, this, NULL);
     if (!IS_VALID_LLDB_HOST_THREAD(m_monitor_thread))
     {
         error.SetErrorToGenericError();
@@ -865,6 +1116,7 @@ ProcessMonitor::ProcessMonitor(ProcessPOSIX *process,
       m_operation_thread(LLDB_INVALID_HOST_THREAD),
       m_pid(LLDB_INVALID_PROCESS_ID),
       m_terminal_fd(-1),
+      m_mem_fd(-1),
       m_monitor_thread(LLDB_INVALID_HOST_THREAD),
       m_client_fd(-1),
       m_server_fd(-1)
@@ -906,8 +1158,8 @@ WAIT_AGAIN:
     }
 
     // Finally, start monitoring the child process for change in state.
-    m_monitor_thread = Host::StartMonitoringChildProcess(
-        ProcessMonitor::MonitorCallback, this, GetPID(), true);
+    m_monitor_thread = Host::ThreadCreate("lldb.process.linux.monitor",
+                                          MonitorThread, this, NULL);
     if (!IS_VALID_LLDB_HOST_THREAD(m_monitor_thread))
     {
         error.SetErrorToGenericError();
@@ -961,42 +1213,35 @@ ProcessMonitor::LaunchOpThread(void *arg)
     return NULL;
 }
 
-bool
-ProcessMonitor::Launch(LaunchArgs *args)
+lldb::pid_t
+ProcessMonitor::LaunchTracedProcess(const char *exe_path,
+                                    const char *argv[],
+                                    const char *envp[],
+                                    const char *stdin_path,
+                                    const char *stdout_path,
+                                    const char *stderr_path,
+                                    const char *working_dir,
+                                    bool disable_aslr,
+                                    lldb_utility::PseudoTerminal *terminal,
+                                    Error &error)
 {
-    ProcessMonitor *monitor = args->m_monitor;
-    ProcessLinux &process = monitor->GetProcess();
-    const char **argv = args->m_argv;
-    const char **envp = args->m_envp;
-    const char *stdin_path = args->m_stdin_path;
-    const char *stdout_path = args->m_stdout_path;
-    const char *stderr_path = args->m_stderr_path;
-
-    lldb_utility::PseudoTerminal terminal;
     const size_t err_len = 1024;
     char err_str[err_len];
-    lldb::pid_t pid;
-
-    lldb::ThreadSP inferior;
-    LogSP log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_PROCESS));
+    ::pid_t pid;
 
     // Propagate the environment if one is not supplied.
     if (envp == NULL || envp[0] == NULL)
         envp = const_cast<const char **>(environ);
 
-    // Pseudo terminal setup.
-    if (!terminal.OpenFirstAvailableMaster(O_RDWR | O_NOCTTY, err_str, err_len))
-    {
-        args->m_error.SetErrorToGenericError();
-        args->m_error.SetErrorString("Could not open controlling TTY.");
-        goto FINISH;
-    }
-
-    if ((pid = terminal.Fork(err_str, err_len)) < 0)
+    if (terminal)
+        pid = terminal->Fork(err_str, err_len);
+    else
+        pid = fork();
+    if (pid < 0)
     {
-        args->m_error.SetErrorToGenericError();
-        args->m_error.SetErrorString("Process fork failed.");
-        goto FINISH;
+        error.SetErrorToGenericError();
+        error.SetErrorString("Process fork failed.");
+        return LLDB_INVALID_PROCESS_ID;
     }
 
     // Recognized child exit status codes.
@@ -1005,6 +1250,7 @@ ProcessMonitor::Launch(LaunchArgs *args)
         eDupStdinFailed,
         eDupStdoutFailed,
         eDupStderrFailed,
+        eChdirFailed,
         eExecFailed
     };
 
@@ -1037,54 +1283,108 @@ ProcessMonitor::Launch(LaunchArgs *args)
             if (!DupDescriptor(stderr_path, STDERR_FILENO, O_WRONLY | O_CREAT))
                 exit(eDupStderrFailed);
 
+        if (working_dir != NULL && working_dir[0] && chdir(working_dir) != 0)
+            exit(eChdirFailed);
+
+        if (disable_aslr)
+        {
+            const int old_personality = personality(0xffffffff);
+            if (old_personality != -1)
+                personality(old_personality | ADDR_NO_RANDOMIZE);
+        }
+
         // Execute.  We should never return.
-        execve(argv[0],
+        execve(exe_path,
                const_cast<char *const *>(argv),
                const_cast<char *const *>(envp));
         exit(eExecFailed);
     }
 
     // Wait for the child process to to trap on its call to execve.
-    pid_t wpid;
     int status;
-    if ((wpid = waitpid(pid, &status, 0)) < 0)
+    if (waitpid(pid, &status, 0) < 0)
     {
-        args->m_error.SetErrorToErrno();
-        goto FINISH;
+        error.SetErrorToErrno();
+        return LLDB_INVALID_PROCESS_ID;
     }
     else if (WIFEXITED(status))
     {
-        // open, dup or execve likely failed for some reason.
-        args->m_error.SetErrorToGenericError();
+        // open, dup, chdir or execve likely failed for some reason.
+        error.SetErrorToGenericError();
         switch (WEXITSTATUS(status))
         {
             case ePtraceFailed: 
-                args->m_error.SetErrorString("Child ptrace failed.");
+                error.SetErrorString("Child ptrace failed.");
                 break;
             case eDupStdinFailed: 
-                args->m_error.SetErrorString("Child open stdin failed.");
+                error.SetErrorString("Child open stdin failed.");
                 break;
             case eDupStdoutFailed: 
-                args->m_error.SetErrorString("Child open stdout failed.");
+                error.SetErrorString("Child open stdout failed.");
                 break;
             case eDupStderrFailed: 
-                args->m_error.SetErrorString("Child open stderr failed.");
+                error.SetErrorString("Child open stderr failed.");
+                break;
+            case eChdirFailed:
+                error.SetErrorStringWithFormat("Child could not change to directory '%s'.", working_dir);
                 break;
             case eExecFailed: 
-                args->m_error.SetErrorString("Child exec failed.");
+                error.SetErrorString("Child exec failed.");
                 break;
             default: 
-                args->m_error.SetErrorString("Child returned unknown exit status.");
+                error.SetErrorString("Child returned unknown exit status.");
                 break;
         }
+        return LLDB_INVALID_PROCESS_ID;
+    }
+    else if (!WIFSTOPPED(status) || WSTOPSIG(status) != SIGTRAP)
+    {
+        kill(pid, SIGKILL);
+        error.SetErrorToGenericError();
+        error.SetErrorString("Child did not stop after exec.");
+        return LLDB_INVALID_PROCESS_ID;
+    }
+    return pid;
+}
+
+bool
+ProcessMonitor::Launch(LaunchArgs *args)
+{
+    ProcessMonitor *monitor = args->m_monitor;
+    ProcessLinux &process = monitor->GetProcess();
+    const char **argv = args->m_argv;
+    const char **envp = args->m_envp;
+    const char *stdin_path = args->m_stdin_path;
+    const char *stdout_path = args->m_stdout_path;
+    const char *stderr_path = args->m_stderr_path;
+
+    lldb_utility::PseudoTerminal terminal;
+    const size_t err_len = 1024;
+    char err_str[err_len];
+    lldb::pid_t pid;
+
+    lldb::ThreadSP inferior;
+    LogSP log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_PROCESS));
+
+    // Pseudo terminal setup.
+    if (!terminal.OpenFirstAvailableMaster(O_RDWR | O_NOCTTY, err_str, err_len))
+    {
+        args->m_error.SetErrorToGenericError();
+        args->m_error.SetErrorString("Could not open controlling TTY.");
         goto FINISH;
     }
-    assert(WIFSTOPPED(status) && wpid == pid &&
-           "Could not sync with inferior process.");
+
+    pid = LaunchTracedProcess(argv[0], argv, envp,
+                              stdin_path, stdout_path, stderr_path,
+                              NULL, false, &terminal, args->m_error);
+    if (pid == LLDB_INVALID_PROCESS_ID)
+        goto FINISH;
 
     // Have the child raise an event on exit.  This is used to keep the child in
-    // limbo until it is destroyed.
-    if (PTRACE(PTRACE_SETOPTIONS, pid, NULL, (void*)PTRACE_O_TRACEEXIT) < 0)
+    // limbo until it is destroyed.  Also trace the creation of new threads;
+    // they are attached automatically and inherit these options.
+    if (PTRACE(PTRACE_SETOPTIONS, pid, NULL,
+               (void*)(PTRACE_O_TRACEEXIT | PTRACE_O_TRACECLONE)) < 0)
     {
         args->m_error.SetErrorToErrno();
         goto FINISH;
@@ -1094,6 +1394,7 @@ ProcessMonitor::Launch(LaunchArgs *args)
     // ProcessMonitor instance.  Similarly stash the inferior pid.
     monitor->m_terminal_fd = terminal.ReleaseMasterFileDescriptor();
     monitor->m_pid = pid;
+    monitor->OpenMemoryFD();
 
     // Set the terminal fd to be in non blocking mode (it simplifies the
     // implementation of ProcessLinux::GetSTDOUT to have a non-blocking
@@ -1103,11 +1404,12 @@ ProcessMonitor::Launch(LaunchArgs *args)
 
     // Update the process thread list with this new thread.
     // FIXME: should we be letting UpdateThreadList handle this?
-    // FIXME: by using pids instead of tids, we can only support one thread.
     inferior.reset(new POSIXThread(process, pid));
     if (log)
         log->Printf ("ProcessMonitor::%s() adding pid = %i", __FUNCTION__, pid);
     process.GetThreadList().AddThread(inferior);
+    process.AddThreadID(pid);
+    monitor->ThreadStopped(pid);
 
     // Let our process instance know the thread has stopped.
     process.SendMessage(ProcessMessage::Trace(pid));
@@ -1116,6 +1418,25 @@ FINISH:
     return args->m_error.Success();
 }
 
+void
+ProcessMonitor::OpenMemoryFD()
+{
+    char path[PATH_MAX];
+    LogSP log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_MEMORY));
+
+    ::snprintf(path, sizeof(path), "/proc/%d/mem", (int)m_pid);
+
+    // Failure here is not fatal; memory transfers fall back to
+    // PTRACE_PEEKDATA/POKEDATA.
+    m_mem_fd = open(path, O_RDWR | O_CLOEXEC);
+    if (m_mem_fd < 0)
+        m_mem_fd = open(path, O_RDONLY | O_CLOEXEC);
+
+    if (log)
+        log->Printf ("ProcessMonitor::%s() %s: fd = %d", __FUNCTION__,
+                     path, m_mem_fd);
+}
+
 bool
 ProcessMonitor::EnableIPC()
 {
@@ -1176,25 +1497,56 @@ ProcessMonitor::Attach(AttachArgs *args)
         goto FINISH;
     }
 
-    // Attach to the requested process.
-    if (PTRACE(PTRACE_ATTACH, pid, NULL, NULL) < 0)
+    // Attach to every thread of the requested process.  Threads may be
+    // created while we are attaching, so repeat until a pass over
+    // /proc/<pid>/task finds no thread we have not seen.
+    for (bool found_new_thread = true; found_new_thread; )
     {
-        args->m_error.SetErrorToErrno();
-        goto FINISH;
-    }
+        std::vector<lldb::tid_t> tids;
 
-    int status;
-    if ((status = waitpid(pid, NULL, 0)) < 0)
-    {
-        args->m_error.SetErrorToErrno();
-        goto FINISH;
-    }
+        found_new_thread = false;
+        if (!GetTaskIDs(pid, tids, args->m_error))
+            goto FINISH;
 
-    // Update the process thread list with the attached thread.
-    inferior.reset(new POSIXThread(process, pid));
-    if (log)
-        log->Printf ("ProcessMonitor::%s() adding tid = %i", __FUNCTION__, pid);
-    process.GetThreadList().AddThread(inferior);
+        for (size_t i = 0; i < tids.size(); ++i)
+        {
+            const lldb::tid_t tid = tids[i];
+            if (monitor->m_threads.count(tid))
+                continue;
+
+            if (PTRACE(PTRACE_ATTACH, tid, NULL, NULL) < 0)
+            {
+                // Threads other than the initial one may have exited since we
+                // listed them.
+                if (tid != pid)
+                    continue;
+                args->m_error.SetErrorToErrno();
+                goto FINISH;
+            }
+
+            if (waitpid(tid, NULL, __WALL) < 0)
+            {
+                args->m_error.SetErrorToErrno();
+                goto FINISH;
+            }
+
+            if (PTRACE(PTRACE_SETOPTIONS, tid, NULL,
+                       (void*)(PTRACE_O_TRACEEXIT | PTRACE_O_TRACECLONE)) < 0)
+            {
+                args->m_error.SetErrorToErrno();
+                goto FINISH;
+            }
+
+            // Update the process thread list with the attached thread.
+            inferior.reset(new POSIXThread(process, tid));
+            if (log)
+                log->Printf ("ProcessMonitor::%s() adding tid = %llu", __FUNCTION__, (uint64_t)tid);
+            process.GetThreadList().AddThread(inferior);
+            process.AddThreadID(tid);
+            monitor->ThreadStopped(tid);
+            found_new_thread = true;
+        }
+    }
 
     // Let our process instance know the thread has stopped.
     process.SendMessage(ProcessMessage::Trace(pid));
@@ -1203,6 +1555,150 @@ ProcessMonitor::Attach(AttachArgs *args)
     return args->m_error.Success();
 }
 
+void *
+ProcessMonitor::MonitorThread(void *arg)
+{
+    ProcessMonitor *monitor = static_cast<ProcessMonitor*>(arg);
+    LogSP log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_PROCESS));
+
+    for (;;)
+    {
+        siginfo_t info;
+        int status;
+        int old_state;
+
+        // Wait for an event of any child without consuming it.  Waiting on
+        // the inferior's process group instead would fail with ECHILD once
+        // the inferior moves to another group, and a plain waitpid(-1) would
+        // reap processes the debugger itself started.
+        if (!PeekChildEvent(P_ALL, 0, info))
+        {
+            if (errno == EINTR)
+                continue;
+            break;
+        }
+
+        if (!monitor->IsInferiorThread(info.si_pid))
+        {
+            // The event belongs to another child of the debugger.  Leave it
+            // to its owner and block until a thread of the inferior has an
+            // event, which only the inferior's process group can tell us
+            // without reaping the other child.
+            const ::pid_t pgid = ::getpgid(monitor->GetPID());
+            const ::pid_t child_pgid = ::getpgid(info.si_pid);
+            if (child_pgid < 0)
+                continue;   // Its owner reaped it in the meantime.
+
+            if (pgid < 0 || child_pgid == pgid)
+            {
+                // Waiting on the group would find the child again.  It
+                // shares the inferior's group, so reap it and move on.
+                ::waitpid(info.si_pid, &status, __WALL | WNOHANG);
+                if (log)
+                    log->Printf ("ProcessMonitor::%s() reaped pid = %i, which is not a thread of the inferior",
+                                 __FUNCTION__, info.si_pid);
+                continue;
+            }
+
+            if (!PeekChildEvent(P_PGID, pgid, info))
+            {
+                // ECHILD means the inferior moved to another group.
+                if (errno == EINTR || errno == ECHILD)
+                    continue;
+                break;
+            }
+        }
+
+        ::pid_t wait_tid;
+        while ((wait_tid = ::waitpid(info.si_pid, &status, __WALL | WNOHANG)) < 0 &&
+               errno == EINTR)
+            ;
+        if (wait_tid <= 0)
+            continue;
+
+        if (log)
+            log->Printf ("ProcessMonitor::%s() waitpid => tid = %i, status = 0x%8.8x",
+                         __FUNCTION__, wait_tid, status);
+
+        // A thread which was just cloned may report its first event before
+        // its parent reports the clone event.  Keep the event until
+        // AddClonedThread registers the thread.
+        if (monitor->ParkNewThreadEvent(wait_tid, status))
+            continue;
+
+        bool exited = false;
+        int signal = 0;
+        int exit_status = 0;
+        if (WIFSTOPPED(status))
+            signal = WSTOPSIG(status);
+        else if (WIFEXITED(status))
+        {
+            exit_status = WEXITSTATUS(status);
+            exited = true;
+        }
+        else if (WIFSIGNALED(status))
+        {
+            signal = WTERMSIG(status);
+            exit_status = -1;
+            exited = true;
+        }
+
+        // Do not allow the thread to be cancelled while the event is handled.
+        ::pthread_setcancelstate(PTHREAD_CANCEL_DISABLE, &old_state);
+        bool stop_monitoring = MonitorCallback(monitor, wait_tid, exited,
+                                               signal, exit_status);
+        ::pthread_setcancelstate(old_state, NULL);
+
+        if (stop_monitoring)
+            break;
+    }
+
+    return NULL;
+}
+
+bool
+ProcessMonitor::PeekChildEvent(idtype_t idtype, id_t id, siginfo_t &info)
+{
+    ::pthread_testcancel();
+    info.si_pid = 0;
+    const int result = ::waitid(idtype, id, &info,
+                                WEXITED | WSTOPPED | WNOWAIT | __WALL);
+    ::pthread_testcancel();
+    return result == 0;
+}
+
+bool
+ProcessMonitor::IsInferiorThread(lldb::tid_t tid)
+{
+    if (tid == GetPID())
+        return true;
+
+    {
+        Mutex::Locker lock(m_threads_mutex);
+        if (m_threads.count(tid))
+            return true;
+    }
+
+    // A thread which was just cloned may report its first stop before its
+    // parent reports the clone event.
+    char path[PATH_MAX];
+    ::snprintf(path, sizeof(path), "/proc/%d/task/%d", (int)GetPID(), (int)tid);
+    return ::access(path, F_OK) == 0;
+}
+
+bool
+ProcessMonitor::ParkNewThreadEvent(lldb::tid_t tid, int status)
+{
+    if (tid == GetPID())
+        return false;
+
+    Mutex::Locker lock(m_threads_mutex);
+    if (m_threads.count(tid))
+        return false;
+    m_parked_events[tid] = status;
+    return true;
+}
+
 bool
 ProcessMonitor::MonitorCallback(void *callback_baton,
                                 lldb::pid_t pid,
@@ -1217,8 +1713,26 @@ ProcessMonitor::MonitorCallback(void *callback_baton,
     bool stop_monitoring;
     siginfo_t info;
 
+    // Threads other than the initial one come and go without affecting the
+    // process as a whole.
+    const bool is_initial_thread = (pid == monitor->GetPID());
+    if (exited && !is_initial_thread)
+    {
+        monitor->RemoveThread(pid);
+        return false;
+    }
+
+    monitor->ThreadStopped(pid);
+
     if (!monitor->GetSignalInfo(pid, &info))
+    {
+        if (!is_initial_thread)
+        {
+            monitor->RemoveThread(pid);
+            return false;
+        }
         stop_monitoring = true; // pid is gone.  Bail.
+    }
     else {
         switch (info.si_signo)
         {
@@ -1231,6 +1745,15 @@ ProcessMonitor::MonitorCallback(void *callback_baton,
             break;
         }
 
+        // Events handled internally by the monitor are not reported.
+        if (message.GetKind() == ProcessMessage::eInvalidMessage)
+            return false;
+
+        // Implement all-stop: halt every other thread before reporting the
+        // event.  There is no point when the inferior is about to exit.
+        if (message.GetKind() != ProcessMessage::eLimboMessage)
+            monitor->StopAllThreads(pid);
+
         process->SendMessage(message);
         stop_monitoring = message.GetKind() == ProcessMessage::eExitMessage;
     }
@@ -1253,8 +1776,28 @@ ProcessMonitor::MonitorSIGTRAP(ProcessMonitor *monitor,
         assert(false && "Unexpected SIGTRAP code!");
         break;
 
+    case (SIGTRAP | (PTRACE_EVENT_CLONE << 8)):
+    {
+        // The inferior created a new thread, which the kernel attached for
+        // us.  Register it and let both threads carry on.
+        unsigned long tid = 0;
+        if (monitor->GetEventMessage(pid, &tid) &&
+            monitor->AddClonedThread(pid, tid))
+            monitor->Resume(tid, LLDB_INVALID_SIGNAL_NUMBER);
+        monitor->ResumeThread(pid);
+        break;
+    }
+
     case (SIGTRAP | (PTRACE_EVENT_EXIT << 8)):
     {
+        // A thread other than the initial one is about to exit.  Let it go;
+        // it is forgotten once waitpid reports its exit.
+        if (pid != monitor->GetPID())
+        {
+            monitor->Resume(pid, LLDB_INVALID_SIGNAL_NUMBER);
+            break;
+        }
+
         // The inferior process is about to exit.  Maintain the process in a
         // state of "limbo" until we are explicitly commanded to detach,
         // destroy, resume, etc.
@@ -1274,6 +1817,10 @@ ProcessMonitor::MonitorSIGTRAP(ProcessMonitor *monitor,
     case TRAP_BRKPT:
         message = ProcessMessage::Break(pid);
         break;
+
+    case TRAP_HWBKPT:
+        message = ProcessMessage::Watch(pid);
+        break;
     }
 
     return message;
@@ -1296,6 +1843,16 @@ ProcessMonitor::MonitorSignal(ProcessMonitor *monitor,
     // Similarly, ACK signals generated by this monitor.
     if (info->si_code == SI_TKILL || info->si_code == SI_USER)
     {
+        // A SIGSTOP sent by StopAllThreads which was overtaken by another
+        // event of the thread is only delivered once the thread has been
+        // resumed.  Discard it and let the thread carry on.
+        if (signo == SIGSTOP && info->si_code == SI_TKILL &&
+            info->si_pid == getpid() && monitor->ClearPendingSIGSTOP(pid))
+        {
+            monitor->ResumeThread(pid);
+            return ProcessMessage();
+        }
+
         if (info->si_pid == getpid())
             return ProcessMessage::SignalDelivered(pid, signo);
         else
@@ -1466,6 +2023,232 @@ ProcessMonitor::GetCrashReasonForSIGBUS(const siginfo_t *info)
     return reason;
 }
 
+bool
+ProcessMonitor::ThreadStopped(lldb::tid_t tid)
+{
+    Mutex::Locker lock(m_threads_mutex);
+    std::pair<ThreadInfoMap::iterator, bool> result =
+        m_threads.insert(std::make_pair(tid, ThreadInfo()));
+    result.first->second.m_stopped = true;
+    return !result.second;
+}
+
+void
+ProcessMonitor::ThreadResumed(lldb::tid_t tid, bool stepping)
+{
+    Mutex::Locker lock(m_threads_mutex);
+    ThreadInfoMap::iterator pos = m_threads.find(tid);
+    if (pos != m_threads.end())
+    {
+        pos->second.m_stopped = false;
+        pos->second.m_stepping = stepping;
+    }
+}
+
+void
+ProcessMonitor::RemoveThread(lldb::tid_t tid)
+{
+    LogSP log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_THREAD));
+    if (log)
+        log->Printf ("ProcessMonitor::%s() tid = %llu", __FUNCTION__, (uint64_t)tid);
+
+    {
+        Mutex::Locker lock(m_threads_mutex);
+        m_threads.erase(tid);
+    }
+    m_process->RemoveThreadID(tid);
+}
+
+bool
+ProcessMonitor::ClearPendingSIGSTOP(lldb::tid_t tid)
+{
+    Mutex::Locker lock(m_threads_mutex);
+    ThreadInfoMap::iterator pos = m_threads.find(tid);
+    if (pos == m_threads.end() || !pos->second.m_sigstop_pending)
+        return false;
+    pos->second.m_sigstop_pending = false;
+    return true;
+}
+
+bool
+ProcessMonitor::AddClonedThread(lldb::tid_t parent_tid, lldb::tid_t tid)
+{
+    LogSP log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_THREAD));
+    if (log)
+        log->Printf ("ProcessMonitor::%s() tid = %llu", __FUNCTION__, (uint64_t)tid);
+
+    bool seen;
+    bool parked = false;
+    int status = 0;
+    {
+        Mutex::Locker lock(m_threads_mutex);
+        seen = m_threads.count(tid);
+        ParkedEventMap::iterator pos = m_parked_events.find(tid);
+        if (pos != m_parked_events.end())
+        {
+            status = pos->second;
+            parked = true;
+            m_parked_events.erase(pos);
+        }
+    }
+
+    // The new thread starts with a SIGSTOP pending.  Consume it unless the
+    // monitor thread has already parked it.
+    if (!seen)
+    {
+        if (!parked)
+        {
+            ::pid_t wait_tid;
+            while ((wait_tid = waitpid(tid, &status, __WALL)) < 0 && errno == EINTR)
+                ;
+            if (wait_tid < 0)
+                status = 0;
+        }
+
+        if (!WIFSTOPPED(status))
+        {
+            // The thread is gone before it got to run.
+            if (log)
+                log->Printf ("ProcessMonitor::%s() tid = %llu exited before it was registered",
+                             __FUNCTION__, (uint64_t)tid);
+            return false;
+        }
+        ThreadStopped(tid);
+    }
+
+    // Watchpoints apply to the whole process, so the new thread must watch
+    // whatever its parent does before it gets to run.
+    CopyDebugRegisters(parent_tid, tid);
+
+    m_process->AddThreadID(tid);
+    return true;
+}
+
+void
+ProcessMonitor::CopyDebugRegisters(lldb::tid_t from_tid, lldb::tid_t to_tid)
+{
+    enum { k_num_address_regs = 4, k_control_reg = 7 };
+
+    RegisterValue control;
+    if (!ReadDebugRegisterValue(from_tid, k_control_reg, control) ||
+        control.GetAsUInt64() == 0)
+        return;
+
+    LogSP log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_WATCHPOINTS));
+    if (log)
+        log->Printf ("ProcessMonitor::%s() tid %llu -> %llu, dr7 = 0x%llx", __FUNCTION__,
+                     (uint64_t)from_tid, (uint64_t)to_tid, control.GetAsUInt64());
+
+    for (unsigned i = 0; i < k_num_address_regs; ++i)
+    {
+        RegisterValue addr;
+        if (ReadDebugRegisterValue(from_tid, i, addr))
+            WriteDebugRegisterValue(to_tid, i, addr);
+    }
+    WriteDebugRegisterValue(to_tid, k_control_reg, control);
+}
+
+void
+ProcessMonitor::ResumeThread(lldb::tid_t tid)
+{
+    bool stepping = false;
+    {
+        Mutex::Locker lock(m_threads_mutex);
+        ThreadInfoMap::iterator pos = m_threads.find(tid);
+        if (pos != m_threads.end())
+            stepping = pos->second.m_stepping;
+    }
+
+    if (stepping)
+        SingleStep(tid, LLDB_INVALID_SIGNAL_NUMBER);
+    else
+        Resume(tid, LLDB_INVALID_SIGNAL_NUMBER);
+}
+
+void
+ProcessMonitor::StopAllThreads(lldb::tid_t tid)
+{
+    LogSP log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_THREAD));
+    std::vector<lldb::tid_t> signalled;
+    const ::pid_t self = getpid();
+
+    // Signal every running thread first and only then collect the resulting
+    // stops, so that the threads come to a halt concurrently rather than one
+    // after the other.
+    {
+        Mutex::Locker lock(m_threads_mutex);
+        for (ThreadInfoMap::iterator pos = m_threads.begin();
+             pos != m_threads.end(); ++pos)
+        {
+            ThreadInfo &thread = pos->second;
+            if (pos->first == tid || thread.m_stopped || thread.m_sigstop_pending)
+                continue;
+            if (syscall(SYS_tgkill, m_pid, pos->first, SIGSTOP) == 0)
+            {
+                thread.m_sigstop_pending = true;
+                signalled.push_back(pos->first);
+            }
+        }
+    }
+
+    if (log)
+        log->Printf ("ProcessMonitor::%s() tid = %llu, stopping %zu threads",
+                     __FUNCTION__, (uint64_t)tid, signalled.size());
+
+    for (size_t i = 0; i < signalled.size(); ++i)
+    {
+        const lldb::tid_t stopping_tid = signalled[i];
+        ::pid_t wait_tid;
+        int status;
+        siginfo_t info;
+
+        while ((wait_tid = waitpid(stopping_tid, &status, __WALL)) < 0 &&
+               errno == EINTR)
+            ;
+
+        if (wait_tid < 0 || WIFEXITED(status) || WIFSIGNALED(status))
+        {
+            RemoveThread(stopping_tid);
+            continue;
+        }
+
+        ThreadStopped(stopping_tid);
+        if (!GetSignalInfo(stopping_tid, &info))
+            continue;
+
+        // This is the stop we asked for.
+        if (info.si_signo == SIGSTOP && info.si_code == SI_TKILL &&
+            info.si_pid == self)
+        {
+            ClearPendingSIGSTOP(stopping_tid);
+            continue;
+        }
+
+        // The thread was creating another.  Keep both halted; the SIGSTOP we
+        // sent is delivered, and discarded, once the thread is resumed.
+        if (info.si_signo == SIGTRAP &&
+            info.si_code == (SIGTRAP | (PTRACE_EVENT_CLONE << 8)))
+        {
+            unsigned long new_tid = 0;
+            if (GetEventMessage(stopping_tid, &new_tid))
+                AddClonedThread(stopping_tid, new_tid);
+            continue;
+        }
+
+        // The thread stopped for a reason of its own before the SIGSTOP was
+        // delivered.  Report the event along with the one that caused the
+        // process to stop.
+        ProcessMessage message;
+        if (info.si_signo == SIGTRAP)
+            message = MonitorSIGTRAP(this, &info, stopping_tid);
+        else
+            message = MonitorSignal(this, &info, stopping_tid);
+
+        if (message.GetKind() != ProcessMessage::eInvalidMessage)
+            m_process->QueueMessage(message);
+    }
+}
+
 void
 ProcessMonitor::ServeOperation(OperationArgs *args)
 {
@@ -1474,6 +2257,10 @@ ProcessMonitor::ServeOperation(OperationArgs *args)
 
     ProcessMonitor *monitor = args->m_monitor;
 
+    // Operation counts and times reported through the log.
+    uint64_t num_ops = 0;
+    uint64_t total_usec = 0;
+
     fdset.fd = monitor->m_server_fd;
     fdset.events = POLLIN | POLLPRI;
     fdset.revents = 0;
@@ -1501,32 +2288,69 @@ ProcessMonitor::ServeOperation(OperationArgs *args)
 
         if (fdset.revents & POLLIN)
         {
-            Operation *op = NULL;
+            OperationRequest *request = NULL;
 
         READ_AGAIN:
-            if ((status = read(fdset.fd, &op, sizeof(op))) < 0)
+            if ((status = read(fdset.fd, &request, sizeof(request))) < 0)
             {
                 // There is only one acceptable failure.
                 assert(errno == EINTR);
                 goto READ_AGAIN;
             }
 
-            assert(status == sizeof(op));
-            op->Execute(monitor);
-            write(fdset.fd, &op, sizeof(op));
+            assert(status == sizeof(request));
+
+            // Drain the whole batch before waking the client.
+            LogSP log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_OPERATIONS));
+            TimeValue start;
+            if (log)
+                start = TimeValue::Now();
+
+            for (size_t i = 0; i < request->m_count; ++i)
+                request->m_ops[i]->Execute(monitor);
+
+            if (log)
+            {
+                const uint64_t elapsed_usec =
+                    TimeValue::Now().GetAsMicroSecondsSinceJan1_1970() -
+                    start.GetAsMicroSecondsSinceJan1_1970();
+                num_ops += request->m_count;
+                total_usec += elapsed_usec;
+                log->Printf ("ProcessMonitor::%s() executed %zu operations in %llu us "
+                             "(%llu operations in %llu us total)", __FUNCTION__,
+                             request->m_count, elapsed_usec, num_ops, total_usec);
+            }
+
+            write(fdset.fd, &request, sizeof(request));
         }
     }
 }
 
 void
 ProcessMonitor::DoOperation(Operation *op)
+{
+    DoOperations(&op, 1);
+}
+
+void
+ProcessMonitor::DoOperations(Operation *const *ops, size_t count)
 {
     int status;
-    Operation *ack = NULL;
+    OperationRequest request = { ops, count };
+    OperationRequest *req = &request;
+    OperationRequest *ack = NULL;
+    LogSP log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_OPERATIONS));
+    TimeValue start;
+
+    if (count == 0)
+        return;
+
     Mutex::Locker lock(m_server_mutex);
+    if (log)
+        start = TimeValue::Now();
 
     // FIXME: Do proper error checking here.
-    write(m_client_fd, &op, sizeof(op));
+    write(m_client_fd, &req, sizeof(req));
 
 READ_AGAIN:
     if ((status = read(m_client_fd, &ack, sizeof(ack))) < 0)
@@ -1540,79 +2364,264 @@ READ_AGAIN:
     }
 
     assert(status == sizeof(ack));
-    assert(ack == op && "Invalid monitor thread response!");
+    assert(ack == req && "Invalid monitor thread response!");
+
+    if (log)
+    {
+        const uint64_t elapsed_usec =
+            TimeValue::Now().GetAsMicroSecondsSinceJan1_1970() -
+            start.GetAsMicroSecondsSinceJan1_1970();
+        log->Printf ("ProcessMonitor::%s() %zu operations completed in %llu us "
+                     "(%llu us per operation)", __FUNCTION__, count,
+                     elapsed_usec, elapsed_usec / count);
+    }
+}
+
+bool
+ProcessMonitor::ExecuteBatch(OperationBatch &batch)
+{
+    const size_t count = batch.GetSize();
+    bool success = true;
+
+    if (count == 0)
+        return true;
+
+    std::vector<Operation *> ops;
+    ops.reserve(count);
+    for (size_t i = 0; i < count; ++i)
+    {
+        OperationBatch::Entry &entry = batch.GetEntryAtIndex(i);
+        switch (entry.m_kind)
+        {
+        case OperationBatch::eResume:
+            ops.push_back(new ResumeOperation(entry.m_tid, entry.m_signo,
+                                              entry.m_success));
+            break;
+
+        case OperationBatch::eSingleStep:
+            ops.push_back(new SingleStepOperation(entry.m_tid, entry.m_signo,
+                                                  entry.m_success));
+            break;
+
+        case OperationBatch::eReadGPR:
+            ops.push_back(new ReadGPROperation(entry.m_tid, entry.m_buf,
+                                               entry.m_success));
+            break;
+        }
+    }
+
+    DoOperations(&ops[0], count);
+
+    for (size_t i = 0; i < count; ++i)
+    {
+        success = batch.Succeeded(i) && success;
+        delete ops[i];
+    }
+    return success;
+}
+
+size_t
+ProcessMonitor::BulkReadMemory(lldb::addr_t vm_addr, void *buf, size_t size)
+{
+    struct iovec local_iov = { buf, size };
+    struct iovec remote_iov = { (void *)vm_addr, size };
+
+    ssize_t result = VMReadV(m_pid, &local_iov, 1, &remote_iov, 1);
+    if (result > 0)
+        return result;
+
+    return ProcMemRead(m_mem_fd, vm_addr, buf, size);
+}
+
+size_t
+ProcessMonitor::BulkWriteMemory(lldb::addr_t vm_addr, const void *buf,
+                                size_t size)
+{
+    return ProcMemWrite(m_mem_fd, vm_addr, buf, size);
 }
 
 size_t
 ProcessMonitor::ReadMemory(lldb::addr_t vm_addr, void *buf, size_t size,
                            Error &error)
 {
+    LogSP log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_MEMORY));
+
+    size_t bytes_read = BulkReadMemory(vm_addr, buf, size);
+    if (log)
+        log->Printf ("ProcessMonitor::%s(0x%llx, %zu) bulk read %zu bytes",
+                     __FUNCTION__, (unsigned long long)vm_addr, size,
+                     bytes_read);
+    if (bytes_read == size)
+        return bytes_read;
+
+    // Fall back to PTRACE_PEEKDATA for whatever the bulk read could not
+    // transfer.
     size_t result;
-    ReadOperation op(vm_addr, buf, size, error, result);
+    ReadOperation op(vm_addr + bytes_read,
+                     static_cast<uint8_t *>(buf) + bytes_read,
+                     size - bytes_read, error, result);
     DoOperation(&op);
-    return result;
+    return bytes_read + result;
+}
+
+size_t
+ProcessMonitor::ReadMemoryRanges(ReadRange *ranges, size_t count,
+                                 lldb_private::Error &error)
+{
+    LogSP log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_MEMORY));
+    std::vector<struct iovec> local_iov;
+    std::vector<struct iovec> remote_iov;
+    size_t total = 0;
+
+    for (size_t i = 0; i < count; ++i)
+        ranges[i].m_bytes_read = 0;
+
+    // Read the ranges in batches of at most IOV_MAX with a single
+    // process_vm_readv call each.  The kernel stops at the first range it
+    // fails to read, so the bytes read are distributed in order.
+    for (size_t start = 0; start < count; start += IOV_MAX)
+    {
+        const size_t batch = std::min<size_t>(count - start, IOV_MAX);
+
+        local_iov.resize(batch);
+        remote_iov.resize(batch);
+        for (size_t i = 0; i < batch; ++i)
+        {
+            ReadRange &range = ranges[start + i];
+            local_iov[i].iov_base = range.m_buf;
+            local_iov[i].iov_len = range.m_size;
+            remote_iov[i].iov_base = (void *)range.m_addr;
+            remote_iov[i].iov_len = range.m_size;
+        }
+
+        ssize_t result = VMReadV(m_pid, &local_iov[0], batch,
+                                 &remote_iov[0], batch);
+        if (log)
+            log->Printf ("ProcessMonitor::%s() batch of %zu ranges read %zd bytes",
+                         __FUNCTION__, batch, result);
+
+        size_t remaining = result > 0 ? result : 0;
+        for (size_t i = 0; i < batch && remaining > 0; ++i)
+        {
+            ReadRange &range = ranges[start + i];
+            range.m_bytes_read = std::min<size_t>(range.m_size, remaining);
+            remaining -= range.m_bytes_read;
+        }
+    }
+
+    // Complete any ranges that were not fully read one at a time, using the
+    // /proc/<pid>/mem and PTRACE_PEEKDATA fallbacks.
+    for (size_t i = 0; i < count; ++i)
+    {
+        ReadRange &range = ranges[i];
+        if (range.m_bytes_read < range.m_size)
+        {
+            Error range_error;
+            range.m_bytes_read +=
+                ReadMemory(range.m_addr + range.m_bytes_read,
+                           static_cast<uint8_t *>(range.m_buf) + range.m_bytes_read,
+                           range.m_size - range.m_bytes_read, range_error);
+            if (range_error.Fail() && error.Success())
+                error = range_error;
+        }
+        total += range.m_bytes_read;
+    }
+
+    return total;
 }
 
 size_t
 ProcessMonitor::WriteMemory(lldb::addr_t vm_addr, const void *buf, size_t size,
                             lldb_private::Error &error)
 {
+    LogSP log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_MEMORY));
+
+    size_t bytes_written = BulkWriteMemory(vm_addr, buf, size);
+    if (log)
+        log->Printf ("ProcessMonitor::%s(0x%llx, %zu) bulk wrote %zu bytes",
+                     __FUNCTION__, (unsigned long long)vm_addr, size,
+                     bytes_written);
+    if (bytes_written == size)
+        return bytes_written;
+
+    // Fall back to PTRACE_POKEDATA for whatever the bulk write could not
+    // transfer.
     size_t result;
-    WriteOperation op(vm_addr, buf, size, error, result);
+    WriteOperation op(vm_addr + bytes_written,
+                      static_cast<const uint8_t *>(buf) + bytes_written,
+                      size - bytes_written, error, result);
+    DoOperation(&op);
+    return bytes_written + result;
+}
+
+bool
+ProcessMonitor::ReadRegisterValue(lldb::tid_t tid, unsigned offset, unsigned size, RegisterValue &value)
+{
+    bool result;
+    ReadRegOperation op(tid, offset, value, result);
     DoOperation(&op);
     return result;
 }
 
 bool
-ProcessMonitor::ReadRegisterValue(unsigned offset, unsigned size, RegisterValue &value)
+ProcessMonitor::WriteRegisterValue(lldb::tid_t tid, unsigned offset, const RegisterValue &value)
 {
     bool result;
-    ReadRegOperation op(offset, value, result);
+    WriteRegOperation op(tid, offset, value, result);
     DoOperation(&op);
     return result;
 }
 
 bool
-ProcessMonitor::WriteRegisterValue(unsigned offset, const RegisterValue &value)
+ProcessMonitor::ReadDebugRegisterValue(lldb::tid_t tid, unsigned index, RegisterValue &value)
 {
     bool result;
-    WriteRegOperation op(offset, value, result);
+    ReadDebugRegOperation op(tid, index, value, result);
     DoOperation(&op);
     return result;
 }
 
 bool
-ProcessMonitor::ReadGPR(void *buf)
+ProcessMonitor::WriteDebugRegisterValue(lldb::tid_t tid, unsigned index, const RegisterValue &value)
 {
     bool result;
-    ReadGPROperation op(buf, result);
+    WriteDebugRegOperation op(tid, index, value, result);
     DoOperation(&op);
     return result;
 }
 
 bool
-ProcessMonitor::ReadFPR(void *buf)
+ProcessMonitor::ReadGPR(lldb::tid_t tid, void *buf)
 {
     bool result;
-    ReadFPROperation op(buf, result);
+    ReadGPROperation op(tid, buf, result);
     DoOperation(&op);
     return result;
 }
 
 bool
-ProcessMonitor::WriteGPR(void *buf)
+ProcessMonitor::ReadFPR(lldb::tid_t tid, void *buf)
 {
     bool result;
-    WriteGPROperation op(buf, result);
+    ReadFPROperation op(tid, buf, result);
     DoOperation(&op);
     return result;
 }
 
 bool
-ProcessMonitor::WriteFPR(void *buf)
+ProcessMonitor::WriteGPR(lldb::tid_t tid, void *buf)
 {
     bool result;
-    WriteFPROperation op(buf, result);
+    WriteGPROperation op(tid, buf, result);
+    DoOperation(&op);
+    return result;
+}
+
+bool
+ProcessMonitor::WriteFPR(lldb::tid_t tid, void *buf)
+{
+    bool result;
+    WriteFPROperation op(tid, buf, result);
     DoOperation(&op);
     return result;
 }
@@ -1667,7 +2676,14 @@ ProcessMonitor::Detach()
 {
     bool result;
     lldb_private::Error error;
-    DetachOperation op(error);
+    std::vector<lldb::tid_t> tids;
+    {
+        Mutex::Locker lock(m_threads_mutex);
+        for (ThreadInfoMap::iterator pos = m_threads.begin();
+             pos != m_threads.end(); ++pos)
+            tids.push_back(pos->first);
+    }
+    DetachOperation op(tids, error);
     result = error.Success();
     DoOperation(&op);
     StopMonitor();
@@ -1704,6 +2720,7 @@ ProcessMonitor::StopMonitor()
     StopMonitoringChildProcess();
     StopLaunchOpThread();
     CloseFD(m_terminal_fd);
+    CloseFD(m_mem_fd);
     CloseFD(m_client_fd);
     CloseFD(m_server_fd);
 }
@@ -13,12 +13,21 @@
 // C Includes
 #include <semaphore.h>
 #include <signal.h>
+#include <sys/wait.h>
 
 // C++ Includes
+#include <vector>
+
 // Other libraries and framework includes
+#include "llvm/ADT/DenseMap.h"
+
 #include "lldb/lldb-types.h"
+#include "lldb/Core/Error.h"
 #include "lldb/Host/Mutex.h"
 
+#include "OperationBatch.h"
+#include "ProcessMessage.h"
+
 namespace lldb_private
 {
 class Error;
@@ -27,6 +36,12 @@ class Scalar;
 
 } // End lldb_private namespace.
 
+namespace lldb_utility
+{
+class PseudoTerminal;
+
+} // End lldb_utility namespace.
+
 class ProcessLinux;
 class Operation;
 class ProcessPOSIX;
@@ -64,6 +79,29 @@ public:
 
     ~ProcessMonitor();
 
+    /// Forks and execs @p exe_path traced by the calling thread, and waits
+    /// for it to stop at its first instruction.  This is the part of
+    /// launching an inferior shared with NativeProcessLinux.
+    ///
+    /// Paths and @p working_dir may be NULL to inherit ours.  If @p terminal
+    /// is not NULL, the child is forked by it and has its slave side as its
+    /// controlling terminal.
+    ///
+    /// @return
+    ///     The pid of the stopped child, or LLDB_INVALID_PROCESS_ID with
+    ///     @p error set.
+    static lldb::pid_t
+    LaunchTracedProcess(const char *exe_path,
+                        char const *argv[],
+                        char const *envp[],
+                        const char *stdin_path,
+                        const char *stdout_path,
+                        const char *stderr_path,
+                        const char *working_dir,
+                        bool disable_aslr,
+                        lldb_utility::PseudoTerminal *terminal,
+                        lldb_private::Error &error);
+
     /// Provides the process number of debugee.
     lldb::pid_t
     GetPID() const { return m_pid; }
@@ -88,11 +126,36 @@ public:
     /// Reads @p size bytes from address @vm_adder in the inferior process
     /// address space.
     ///
+    /// The transfer is done in bulk with process_vm_readv or through
+    /// /proc/<pid>/mem when possible, falling back to PTRACE_PEEKDATA.
+    ///
     /// This method is provided to implement Process::DoReadMemory.
     size_t
     ReadMemory(lldb::addr_t vm_addr, void *buf, size_t size,
                lldb_private::Error &error);
 
+    /// @class ReadRange
+    ///
+    /// @brief A single address range of a scatter-gather read issued
+    /// through ReadMemoryRanges.
+    struct ReadRange
+    {
+        lldb::addr_t m_addr;            // Inferior address to read from.
+        void *m_buf;                    // Destination buffer.
+        size_t m_size;                  // Number of bytes requested.
+        size_t m_bytes_read;            // Set to the number of bytes read.
+    };
+
+    /// Reads each of the @p count ranges in @p ranges from the inferior
+    /// process address space, batching as many ranges as possible into a
+    /// single system call.
+    ///
+    /// Returns the total number of bytes read.  @p error is set from the
+    /// first range that could not be read in full.
+    size_t
+    ReadMemoryRanges(ReadRange *ranges, size_t count,
+                     lldb_private::Error &error);
+
     /// Writes @p size bytes from address @p vm_adder in the inferior process
     /// address space.
     ///
@@ -102,34 +165,49 @@ public:
                 lldb_private::Error &error);
 
     /// Reads the contents from the register identified by the given (architecture
-    /// dependent) offset.
+    /// dependent) offset of thread @p tid.
     ///
     /// This method is provided for use by RegisterContextLinux derivatives.
     bool
-    ReadRegisterValue(unsigned offset, unsigned size, lldb_private::RegisterValue &value);
+    ReadRegisterValue(lldb::tid_t tid, unsigned offset, unsigned size, lldb_private::RegisterValue &value);
 
     /// Writes the given value to the register identified by the given
-    /// (architecture dependent) offset.
+    /// (architecture dependent) offset of thread @p tid.
     ///
     /// This method is provided for use by RegisterContextLinux derivatives.
     bool
-    WriteRegisterValue(unsigned offset, const lldb_private::RegisterValue &value);
+    WriteRegisterValue(lldb::tid_t tid, unsigned offset, const lldb_private::RegisterValue &value);
+
+    /// Reads the debug register DR@p index of thread @p tid.
+    ///
+    /// This method is provided for use by RegisterContextLinux derivatives
+    /// implementing hardware watchpoints.
+    bool
+    ReadDebugRegisterValue(lldb::tid_t tid, unsigned index, lldb_private::RegisterValue &value);
 
-    /// Reads all general purpose registers into the specified buffer.
+    /// Writes @p value to the debug register DR@p index of thread @p tid.
     bool
-    ReadGPR(void *buf);
+    WriteDebugRegisterValue(lldb::tid_t tid, unsigned index, const lldb_private::RegisterValue &value);
 
-    /// Reads all floating point registers into the specified buffer.
+    /// Reads all general purpose registers of thread @p tid into the specified
+    /// buffer.
     bool
-    ReadFPR(void *buf);
+    ReadGPR(lldb::tid_t tid, void *buf);
 
-    /// Writes all general purpose registers into the specified buffer.
+    /// Reads all floating point registers of thread @p tid into the specified
+    /// buffer.
     bool
-    WriteGPR(void *buf);
+    ReadFPR(lldb::tid_t tid, void *buf);
 
-    /// Writes all floating point registers into the specified buffer.
+    /// Writes all general purpose registers of thread @p tid into the specified
+    /// buffer.
     bool
-    WriteFPR(void *buf);
+    WriteGPR(lldb::tid_t tid, void *buf);
+
+    /// Writes all floating point registers of thread @p tid into the specified
+    /// buffer.
+    bool
+    WriteFPR(lldb::tid_t tid, void *buf);
 
     /// Writes a siginfo_t structure corresponding to the given thread ID to the
     /// memory region pointed to by @p siginfo.
@@ -161,6 +239,11 @@ public:
     bool
     Detach();
 
+    /// Runs every request queued in @p batch with a single round trip to
+    /// the operation thread.  Returns true if all of them succeeded.
+    bool
+    ExecuteBatch(OperationBatch &batch);
+
 
 private:
     ProcessLinux *m_process;
@@ -168,9 +251,33 @@ private:
     lldb::thread_t m_operation_thread;
     lldb::pid_t m_pid;
     int m_terminal_fd;
+    int m_mem_fd;               // Descriptor for /proc/<pid>/mem or -1.
 
     lldb::thread_t m_monitor_thread;
 
+    /// @class ThreadInfo
+    ///
+    /// @brief State kept for each thread of the inferior in order to
+    /// implement all-stop semantics.
+    struct ThreadInfo
+    {
+        ThreadInfo()
+            : m_stopped(true), m_stepping(false), m_sigstop_pending(false) { }
+
+        bool m_stopped;                 // Thread is in a ptrace-stop.
+        bool m_stepping;                // Thread was last resumed by a single step.
+        bool m_sigstop_pending;         // A SIGSTOP sent by StopAllThreads is undelivered.
+    };
+    typedef llvm::DenseMap<lldb::tid_t, ThreadInfo> ThreadInfoMap;
+
+    /// Events of new threads reported before the clone event of their
+    /// parent, by thread ID.
+    typedef llvm::DenseMap<lldb::tid_t, int> ParkedEventMap;
+
+    lldb_private::Mutex m_threads_mutex;
+    ThreadInfoMap m_threads;
+    ParkedEventMap m_parked_events;     // Guarded by m_threads_mutex.
+
     lldb_private::Mutex m_server_mutex;
     int m_client_fd;
     int m_server_fd;
@@ -225,6 +332,18 @@ private:
     bool
     EnableIPC();
 
+    /// Opens m_mem_fd onto the address space of the traced process.
+    void
+    OpenMemoryFD();
+
+    /// Bulk memory transfers that bypass the operation thread.  These return
+    /// the number of bytes transferred, which may be short of @p size.
+    size_t
+    BulkReadMemory(lldb::addr_t vm_addr, void *buf, size_t size);
+
+    size_t
+    BulkWriteMemory(lldb::addr_t vm_addr, const void *buf, size_t size);
+
     struct AttachArgs : OperationArgs
     {
         AttachArgs(ProcessMonitor *monitor,
@@ -253,10 +372,73 @@ private:
     static bool
     DupDescriptor(const char *path, int fd, int flags);
 
+    static void *
+    MonitorThread(void *arg);
+
     static bool
     MonitorCallback(void *callback_baton,
                     lldb::pid_t pid, bool exited, int signal, int status);
 
+    /// Returns true if @p tid is a thread of the inferior, as opposed to
+    /// another child of the debugger.
+    bool
+    IsInferiorThread(lldb::tid_t tid);
+
+    /// Blocks until a child selected by @p idtype and @p id has an event
+    /// and describes it in @p info, leaving the event to be reaped.  Returns
+    /// false, with errno set, if waitid fails.
+    static bool
+    PeekChildEvent(idtype_t idtype, id_t id, siginfo_t &info);
+
+    /// Keeps the event @p status of thread @p tid, which the monitor does not
+    /// know yet, for AddClonedThread.  Returns false if the thread is known.
+    bool
+    ParkNewThreadEvent(lldb::tid_t tid, int status);
+
+    // The resume operations record the state of the thread they resume.
+    friend class ResumeOperation;
+    friend class SingleStepOperation;
+
+    /// Records that thread @p tid is in a ptrace-stop.  Returns false if the
+    /// thread was not known to the monitor before.
+    bool
+    ThreadStopped(lldb::tid_t tid);
+
+    /// Records that thread @p tid has been resumed.
+    void
+    ThreadResumed(lldb::tid_t tid, bool stepping);
+
+    /// Forgets about the thread @p tid once it has exited.
+    void
+    RemoveThread(lldb::tid_t tid);
+
+    /// Returns true, clearing the flag, if a SIGSTOP sent to thread @p tid by
+    /// StopAllThreads has not been delivered yet.
+    bool
+    ClearPendingSIGSTOP(lldb::tid_t tid);
+
+    /// Registers the thread @p tid created by @p parent_tid and reported by a
+    /// PTRACE_EVENT_CLONE event, waiting for its initial stop if it has not
+    /// yet been parked.  Returns false if the thread exited before that.
+    bool
+    AddClonedThread(lldb::tid_t parent_tid, lldb::tid_t tid);
+
+    /// Programs the hardware watchpoints of thread @p from_tid into thread
+    /// @p to_tid.  The kernel does not carry debug registers over to new
+    /// threads.
+    void
+    CopyDebugRegisters(lldb::tid_t from_tid, lldb::tid_t to_tid);
+
+    /// Resumes thread @p tid the way it was last resumed.
+    void
+    ResumeThread(lldb::tid_t tid);
+
+    /// Brings every running thread of the inferior other than @p tid to a
+    /// halt.  Events reported by those threads in the meantime are queued with
+    /// the process.
+    void
+    StopAllThreads(lldb::tid_t tid);
+
     static ProcessMessage
     MonitorSIGTRAP(ProcessMonitor *monitor,
                    const siginfo_t *info, lldb::pid_t pid);
@@ -280,6 +462,9 @@ private:
     void
     DoOperation(Operation *op);
 
+    void
+    DoOperations(Operation *const *ops, size_t count);
+
     /// Stops the child monitor thread.
     void
     StopMonitoringChildProcess();
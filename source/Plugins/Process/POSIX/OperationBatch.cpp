@@ -0,0 +1,64 @@
+//===-- OperationBatch.cpp --------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// C Includes
+#include <assert.h>
+
+// C++ Includes
+// Other libraries and framework includes
+// Project includes
+#include "OperationBatch.h"
+
+OperationBatch::OperationBatch()
+{
+}
+
+OperationBatch::~OperationBatch()
+{
+}
+
+size_t
+OperationBatch::Append(Kind kind, lldb::tid_t tid, uint32_t signo, void *buf)
+{
+    Entry entry = { kind, tid, signo, buf, false };
+    m_entries.push_back(entry);
+    return m_entries.size() - 1;
+}
+
+size_t
+OperationBatch::Resume(lldb::tid_t tid, uint32_t signo)
+{
+    return Append(eResume, tid, signo, NULL);
+}
+
+size_t
+OperationBatch::SingleStep(lldb::tid_t tid, uint32_t signo)
+{
+    return Append(eSingleStep, tid, signo, NULL);
+}
+
+size_t
+OperationBatch::ReadGPR(lldb::tid_t tid, void *buf)
+{
+    return Append(eReadGPR, tid, 0, buf);
+}
+
+OperationBatch::Entry &
+OperationBatch::GetEntryAtIndex(size_t index)
+{
+    assert(index < m_entries.size());
+    return m_entries[index];
+}
+
+bool
+OperationBatch::Succeeded(size_t index) const
+{
+    assert(index < m_entries.size());
+    return m_entries[index].m_success;
+}
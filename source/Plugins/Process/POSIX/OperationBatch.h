@@ -0,0 +1,82 @@
+//===-- OperationBatch.h ----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_OperationBatch_H_
+#define liblldb_OperationBatch_H_
+
+// C Includes
+// C++ Includes
+#include <vector>
+
+// Other libraries and framework includes
+#include "lldb/lldb-defines.h"
+#include "lldb/lldb-types.h"
+
+/// @class OperationBatch
+/// @brief A list of ProcessMonitor requests, thread resumes and reads of the
+/// general purpose registers of several threads, serviced with a single
+/// round trip to its operation thread.
+///
+/// Each of the methods queueing a request returns the index of that request
+/// within the batch.  Once the batch has been run by
+/// ProcessMonitor::ExecuteBatch, Succeeded reports the outcome of the
+/// request at a given index.
+class OperationBatch
+{
+public:
+    enum Kind
+    {
+        eResume,
+        eSingleStep,
+        eReadGPR
+    };
+
+    struct Entry
+    {
+        Kind m_kind;
+        lldb::tid_t m_tid;
+        uint32_t m_signo;               // Signal to resume with.
+        void *m_buf;                    // Buffer the registers are read into.
+        bool m_success;                 // Set by ProcessMonitor::ExecuteBatch.
+    };
+
+    OperationBatch();
+
+    ~OperationBatch();
+
+    size_t
+    Resume(lldb::tid_t tid, uint32_t signo);
+
+    size_t
+    SingleStep(lldb::tid_t tid, uint32_t signo);
+
+    /// Reads the general purpose registers of thread @p tid into @p buf, in
+    /// the layout ProcessMonitor::ReadGPR uses.
+    size_t
+    ReadGPR(lldb::tid_t tid, void *buf);
+
+    size_t
+    GetSize() const { return m_entries.size(); }
+
+    Entry &
+    GetEntryAtIndex(size_t index);
+
+    bool
+    Succeeded(size_t index) const;
+
+private:
+    size_t
+    Append(Kind kind, lldb::tid_t tid, uint32_t signo, void *buf);
+
+    std::vector<Entry> m_entries;
+
+    DISALLOW_COPY_AND_ASSIGN (OperationBatch);
+};
+
+#endif // #ifndef liblldb_OperationBatch_H_
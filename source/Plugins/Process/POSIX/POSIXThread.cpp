@@ -13,6 +13,7 @@
 // C++ Includes
 // Other libraries and framework includes
 // Project includes
+#include "lldb/Breakpoint/Watchpoint.h"
 #include "lldb/Core/Debugger.h"
 #include "lldb/Host/Host.h"
 #include "lldb/Target/Process.h"
@@ -152,9 +153,18 @@ POSIXThread::WillResume(lldb::StateType resume_state)
 
 bool
 POSIXThread::Resume()
+{
+    OperationBatch batch;
+
+    if (!Resume(batch))
+        return false;
+    return GetMonitor().ExecuteBatch(batch);
+}
+
+bool
+POSIXThread::Resume(OperationBatch &batch)
 {
     lldb::StateType resume_state = GetResumeState();
-    ProcessMonitor &monitor = GetMonitor();
     bool status;
 
     LogSP log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_THREAD));
@@ -170,12 +180,19 @@ POSIXThread::Resume()
 
     case lldb::eStateRunning:
         SetState(resume_state);
-        status = monitor.Resume(GetID(), GetResumeSignal());
+        batch.Resume(GetID(), GetResumeSignal());
+        status = true;
         break;
 
     case lldb::eStateStepping:
         SetState(resume_state);
-        status = monitor.SingleStep(GetID(), GetResumeSignal());
+        batch.SingleStep(GetID(), GetResumeSignal());
+        status = true;
+        break;
+
+    case lldb::eStateSuspended:
+        // Another thread wants to run on its own; stay where we are.
+        status = false;
         break;
     }
 
@@ -215,6 +232,10 @@ POSIXThread::Notify(const ProcessMessage &message)
         BreakNotify(message);
         break;
 
+    case ProcessMessage::eWatchpointMessage:
+        WatchNotify(message);
+        break;
+
     case ProcessMessage::eCrashMessage:
         CrashNotify(message);
         break;
@@ -247,10 +268,57 @@ POSIXThread::BreakNotify(const ProcessMessage &message)
     m_stop_info = StopInfo::CreateStopReasonWithBreakpointSiteID(*this, bp_id);
 }
 
+void
+POSIXThread::WatchNotify(const ProcessMessage &message)
+{
+    if (!WatchpointHitNotify())
+        m_stop_info = StopInfo::CreateStopReasonToTrace(*this);
+}
+
+bool
+POSIXThread::WatchpointHitNotify()
+{
+    // Don't pay for reading the debug registers on every trace unless
+    // something is being watched.
+    if (GetProcess().GetTarget().GetWatchpointList().GetSize() == 0)
+        return false;
+
+    RegisterContextPOSIX *reg_ctx = GetRegisterContextPOSIX();
+    const uint32_t num_hw_watchpoints = reg_ctx->NumSupportedHardwareWatchpoints();
+    if (num_hw_watchpoints == 0)
+        return false;
+
+    lldb::WatchpointSP wp_sp;
+    for (uint32_t hw_index = 0; hw_index < num_hw_watchpoints && !wp_sp; ++hw_index)
+    {
+        if (!reg_ctx->IsWatchpointHit(hw_index))
+            continue;
+
+        lldb::addr_t wp_addr = reg_ctx->GetWatchpointAddress(hw_index);
+        wp_sp = GetProcess().GetTarget().GetWatchpointList().FindByAddress(wp_addr);
+
+        LogSP log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_THREAD));
+        if (log)
+            log->Printf ("POSIXThread::%s () hardware watchpoint %u hit at 0x%8.8llx", 
+                         __FUNCTION__, hw_index, wp_addr);
+    }
+
+    // The processor never clears the status bits itself.
+    reg_ctx->ClearWatchpointHits();
+
+    if (!wp_sp)
+        return false;
+
+    m_stop_info = StopInfo::CreateStopReasonWithWatchpointID(*this, wp_sp->GetID());
+    return true;
+}
+
 void
 POSIXThread::TraceNotify(const ProcessMessage &message)
 {
-    m_stop_info = StopInfo::CreateStopReasonToTrace(*this);
+    // A watchpoint triggered while single stepping is reported as a trace.
+    if (!WatchpointHitNotify())
+        m_stop_info = StopInfo::CreateStopReasonToTrace(*this);
 }
 
 void
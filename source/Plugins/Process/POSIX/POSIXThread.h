@@ -18,6 +18,7 @@
 #include "lldb/Target/Thread.h"
 #include "RegisterContextPOSIX.h"
 
+class OperationBatch;
 class ProcessMessage;
 class ProcessMonitor;
 class RegisterContextPOSIX;
@@ -67,6 +68,10 @@ public:
     //
     bool Resume();
 
+    /// Queues the operation resuming this thread onto @p batch.  Returns false
+    /// if the thread is to remain stopped.
+    bool Resume(OperationBatch &batch);
+
     void Notify(const ProcessMessage &message);
 
 private:
@@ -93,12 +98,16 @@ private:
     GetPrivateStopReason();
 
     void BreakNotify(const ProcessMessage &message);
+    void WatchNotify(const ProcessMessage &message);
     void TraceNotify(const ProcessMessage &message);
     void LimboNotify(const ProcessMessage &message);
     void SignalNotify(const ProcessMessage &message);
     void SignalDeliveredNotify(const ProcessMessage &message);
     void CrashNotify(const ProcessMessage &message);
 
+    /// Sets the stop reason to the watchpoint that triggered, if any.
+    bool WatchpointHitNotify();
+
     lldb_private::Unwind *
     GetUnwinder();
 };
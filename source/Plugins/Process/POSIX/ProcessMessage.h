@@ -29,6 +29,7 @@ public:
         eSignalDeliveredMessage,
         eTraceMessage,
         eBreakpointMessage,
+        eWatchpointMessage,
         eCrashMessage
     };
 
@@ -103,6 +104,11 @@ public:
         return ProcessMessage(tid, eBreakpointMessage);
     }
 
+    /// Indicates that the thread @p tid triggered a hardware watchpoint.
+    static ProcessMessage Watch(lldb::tid_t tid) {
+        return ProcessMessage(tid, eWatchpointMessage);
+    }
+
     /// Indicates that the thread @p tid crashed.
     static ProcessMessage Crash(lldb::pid_t pid, CrashReason reason,
                                 int signo, lldb::addr_t fault_addr) {
@@ -12,6 +12,7 @@
 
 // C++ Includes
 // Other libraries and framework includes
+#include "lldb/Breakpoint/Watchpoint.h"
 #include "lldb/Core/PluginManager.h"
 #include "lldb/Core/State.h"
 #include "lldb/Host/Host.h"
@@ -24,6 +25,7 @@
 #include "Plugins/Process/Utility/InferiorCallPOSIX.h"
 #include "ProcessMonitor.h"
 #include "POSIXThread.h"
+#include "RegisterContextPOSIX.h"
 
 using namespace lldb;
 using namespace lldb_private;
@@ -210,14 +212,20 @@ ProcessPOSIX::DoResume()
             SetPrivateState(eStateRunning);
     }
 
-    bool did_resume = false;
+    // Resume every thread with a single round trip to the monitor.
+    OperationBatch batch;
     uint32_t thread_count = m_thread_list.GetSize(false);
     for (uint32_t i = 0; i < thread_count; ++i)
     {
         POSIXThread *thread = static_cast<POSIXThread*>(
             m_thread_list.GetThreadAtIndex(i, false).get());
-        did_resume = thread->Resume() || did_resume;
+        thread->Resume(batch);
     }
+    GetMonitor().ExecuteBatch(batch);
+
+    bool did_resume = false;
+    for (size_t i = 0; i < batch.GetSize(); ++i)
+        did_resume = batch.Succeeded(i) || did_resume;
     assert(did_resume && "Process resume failed!");
 
     return Error();
@@ -337,6 +345,7 @@ ProcessPOSIX::SendMessage(const ProcessMessage &message)
 
     case ProcessMessage::eTraceMessage:
     case ProcessMessage::eBreakpointMessage:
+    case ProcessMessage::eWatchpointMessage:
         SetPrivateState(eStateStopped);
         break;
 
@@ -353,6 +362,27 @@ ProcessPOSIX::SendMessage(const ProcessMessage &message)
     m_message_queue.push(message);
 }
 
+void
+ProcessPOSIX::QueueMessage(const ProcessMessage &message)
+{
+    Mutex::Locker lock(m_message_mutex);
+    m_message_queue.push(message);
+}
+
+void
+ProcessPOSIX::AddThreadID(lldb::tid_t tid)
+{
+    Mutex::Locker lock(m_tid_mutex);
+    m_tids.insert(tid);
+}
+
+void
+ProcessPOSIX::RemoveThreadID(lldb::tid_t tid)
+{
+    Mutex::Locker lock(m_tid_mutex);
+    m_tids.erase(tid);
+}
+
 void
 ProcessPOSIX::RefreshStateAfterStop()
 {
@@ -361,24 +391,63 @@ ProcessPOSIX::RefreshStateAfterStop()
         log->Printf ("ProcessPOSIX::%s()", __FUNCTION__);
 
     Mutex::Locker lock(m_message_mutex);
-    if (m_message_queue.empty())
-        return;
 
-    ProcessMessage &message = m_message_queue.front();
+    // Several threads may have stopped for a reason of their own while the
+    // process was being halted.  Resolve the thread each message corresponds
+    // to and pass it along.
+    while (!m_message_queue.empty())
+    {
+        ProcessMessage &message = m_message_queue.front();
 
-    // Resolve the thread this message corresponds to and pass it along.
-    // FIXME: we're really dealing with the pid here.  This should get
-    // fixed when this code is fixed to handle multiple threads.
-    lldb::tid_t tid = message.GetTID();
-    if (log)
-        log->Printf ("ProcessPOSIX::%s() pid = %i", __FUNCTION__, tid);
-    POSIXThread *thread = static_cast<POSIXThread*>(
-        GetThreadList().FindThreadByID(tid, false).get());
+        lldb::tid_t tid = message.GetTID();
+        if (log)
+            log->Printf ("ProcessPOSIX::%s() tid = %llu", __FUNCTION__, (uint64_t)tid);
+        ThreadSP thread_sp(GetThreadList().FindThreadByID(tid, false));
+
+        // The thread may have been created since the thread list was last
+        // updated.
+        if (!thread_sp)
+        {
+            thread_sp.reset(new POSIXThread(*this, tid));
+            GetThreadList().AddThread(thread_sp);
+        }
+
+        POSIXThread *thread = static_cast<POSIXThread*>(thread_sp.get());
+        thread->Notify(message);
+
+        m_message_queue.pop();
+    }
 
-    assert(thread);
-    thread->Notify(message);
+    ReadAllThreadsGPR();
+}
 
-    m_message_queue.pop();
+void
+ProcessPOSIX::ReadAllThreadsGPR()
+{
+    // Deciding what to do after a stop looks at the registers of every
+    // thread.  Read the general purpose registers of all of them with a
+    // single round trip to the monitor instead of one trip per register.
+    OperationBatch batch;
+    std::vector<RegisterContextSP> reg_ctxs;
+    std::vector<size_t> indexes;
+    const uint32_t thread_count = m_thread_list.GetSize(false);
+    for (uint32_t i = 0; i < thread_count; ++i)
+    {
+        RegisterContextSP reg_ctx_sp (m_thread_list.GetThreadAtIndex(i, false)->GetRegisterContext());
+        RegisterContextPOSIX *reg_ctx = static_cast<RegisterContextPOSIX*>(reg_ctx_sp.get());
+        size_t index;
+        if (reg_ctx && reg_ctx->QueueReadGPR(batch, index))
+        {
+            reg_ctxs.push_back(reg_ctx_sp);
+            indexes.push_back(index);
+        }
+    }
+    if (reg_ctxs.empty())
+        return;
+
+    GetMonitor().ExecuteBatch(batch);
+    for (size_t i = 0; i < reg_ctxs.size(); ++i)
+        static_cast<RegisterContextPOSIX*>(reg_ctxs[i].get())->DidReadGPR(batch.Succeeded(indexes[i]));
 }
 
 bool
@@ -482,6 +551,141 @@ ProcessPOSIX::DisableBreakpoint(BreakpointSite *bp_site)
     return DisableSoftwareBreakpoint(bp_site);
 }
 
+Error
+ProcessPOSIX::EnableWatchpoint(Watchpoint *wp)
+{
+    Error error;
+    if (wp == NULL)
+    {
+        error.SetErrorString("Watchpoint argument was NULL.");
+        return error;
+    }
+
+    LogSP log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_WATCHPOINTS));
+    if (log)
+        log->Printf ("ProcessPOSIX::%s(watchID = %i) addr = 0x%8.8llx, size = %zu", 
+                     __FUNCTION__, wp->GetID(), (uint64_t)wp->GetLoadAddress(), wp->GetByteSize());
+
+    if (wp->IsEnabled())
+        return error;
+
+    Mutex::Locker lock(m_thread_list.GetMutex());
+    const uint32_t num_threads = m_thread_list.GetSize(false);
+    if (num_threads == 0)
+    {
+        error.SetErrorString("no threads to watch with");
+        return error;
+    }
+
+    // Every thread watches the address with the same debug register, which
+    // lets a hit reported by any thread be traced back to the watchpoint.
+    // Find a slot which is vacant in all of them.
+    POSIXThread *first_thread = static_cast<POSIXThread*>(
+        m_thread_list.GetThreadAtIndex(0, false).get());
+    const uint32_t num_hw_watchpoints =
+        first_thread->GetRegisterContext()->NumSupportedHardwareWatchpoints();
+    if (num_hw_watchpoints == 0)
+    {
+        error.SetErrorString("hardware watchpoints are not supported on this architecture");
+        return error;
+    }
+
+    uint32_t hw_index;
+    for (hw_index = 0; hw_index < num_hw_watchpoints; ++hw_index)
+    {
+        uint32_t i;
+        for (i = 0; i < num_threads; ++i)
+        {
+            RegisterContextPOSIX *reg_ctx = static_cast<RegisterContextPOSIX*>(
+                m_thread_list.GetThreadAtIndex(i, false)->GetRegisterContext().get());
+            if (!reg_ctx->IsWatchpointVacant(hw_index))
+                break;
+        }
+        if (i == num_threads)
+            break;
+    }
+
+    if (hw_index >= num_hw_watchpoints)
+    {
+        error.SetErrorStringWithFormat("all %u hardware watchpoints are in use", num_hw_watchpoints);
+        return error;
+    }
+
+    for (uint32_t i = 0; i < num_threads; ++i)
+    {
+        RegisterContextPOSIX *reg_ctx = static_cast<RegisterContextPOSIX*>(
+            m_thread_list.GetThreadAtIndex(i, false)->GetRegisterContext().get());
+        if (!reg_ctx->SetHardwareWatchpointWithIndex(wp->GetLoadAddress(),
+                                                     wp->GetByteSize(),
+                                                     wp->WatchpointRead(),
+                                                     wp->WatchpointWrite(),
+                                                     hw_index))
+        {
+            // Don't leave the watchpoint half set.
+            while (i-- > 0)
+            {
+                reg_ctx = static_cast<RegisterContextPOSIX*>(
+                    m_thread_list.GetThreadAtIndex(i, false)->GetRegisterContext().get());
+                reg_ctx->ClearHardwareWatchpoint(hw_index);
+            }
+            error.SetErrorStringWithFormat("unable to watch %zu bytes at 0x%llx, the address must be aligned to a size of 1, 2, 4 or 8 bytes", 
+                                           wp->GetByteSize(), (uint64_t)wp->GetLoadAddress());
+            return error;
+        }
+    }
+
+    if (log)
+        log->Printf ("ProcessPOSIX::%s(watchID = %i) using hardware watchpoint %u on %u threads", 
+                     __FUNCTION__, wp->GetID(), hw_index, num_threads);
+
+    wp->SetHardwareIndex(hw_index);
+    wp->SetEnabled(true);
+    return error;
+}
+
+Error
+ProcessPOSIX::DisableWatchpoint(Watchpoint *wp)
+{
+    Error error;
+    if (wp == NULL)
+    {
+        error.SetErrorString("Watchpoint argument was NULL.");
+        return error;
+    }
+
+    LogSP log (ProcessPOSIXLog::GetLogIfAllCategoriesSet (POSIX_LOG_WATCHPOINTS));
+    if (log)
+        log->Printf ("ProcessPOSIX::%s(watchID = %i) addr = 0x%8.8llx", 
+                     __FUNCTION__, wp->GetID(), (uint64_t)wp->GetLoadAddress());
+
+    if (!wp->IsEnabled())
+        return error;
+
+    const uint32_t hw_index = wp->GetHardwareIndex();
+    if (hw_index == LLDB_INVALID_INDEX32)
+    {
+        error.SetErrorString("watchpoint doesn't use a hardware watchpoint");
+        return error;
+    }
+
+    Mutex::Locker lock(m_thread_list.GetMutex());
+    const uint32_t num_threads = m_thread_list.GetSize(false);
+    for (uint32_t i = 0; i < num_threads; ++i)
+    {
+        RegisterContextPOSIX *reg_ctx = static_cast<RegisterContextPOSIX*>(
+            m_thread_list.GetThreadAtIndex(i, false)->GetRegisterContext().get());
+        if (!reg_ctx->ClearHardwareWatchpoint(hw_index))
+            error.SetErrorStringWithFormat("unable to clear hardware watchpoint %u", hw_index);
+    }
+
+    if (error.Success())
+    {
+        wp->SetHardwareIndex(LLDB_INVALID_INDEX32);
+        wp->SetEnabled(false);
+    }
+    return error;
+}
+
 uint32_t
 ProcessPOSIX::UpdateThreadListIfNeeded()
 {
@@ -496,16 +700,26 @@ ProcessPOSIX::UpdateThreadList(ThreadList &old_thread_list, ThreadList &new_thre
     if (log && log->GetMask().Test(POSIX_LOG_VERBOSE))
         log->Printf ("ProcessPOSIX::%s() (pid = %i)", __FUNCTION__, GetID());
 
-    // Update the process thread list with this new thread.
-    // FIXME: We should be using tid, not pid.
     assert(m_monitor);
-    ThreadSP thread_sp (old_thread_list.FindThreadByID (GetID(), false));
-    if (!thread_sp)
-        thread_sp.reset(new POSIXThread(*this, GetID()));
+    Mutex::Locker lock(m_tid_mutex);
 
-    if (log && log->GetMask().Test(POSIX_LOG_VERBOSE))
-        log->Printf ("ProcessPOSIX::%s() updated pid = %i", __FUNCTION__, GetID());
-    new_thread_list.AddThread(thread_sp);
+    // Until the monitor reports the threads of the inferior the process
+    // consists of its initial thread alone.
+    if (m_tids.empty())
+        m_tids.insert(GetID());
+
+    for (std::set<lldb::tid_t>::const_iterator pos = m_tids.begin();
+         pos != m_tids.end(); ++pos)
+    {
+        ThreadSP thread_sp (old_thread_list.FindThreadByID (*pos, false));
+        if (!thread_sp)
+        {
+            thread_sp.reset(new POSIXThread(*this, *pos));
+            if (log && log->GetMask().Test(POSIX_LOG_VERBOSE))
+                log->Printf ("ProcessPOSIX::%s() added tid = %llu", __FUNCTION__, (uint64_t)*pos);
+        }
+        new_thread_list.AddThread(thread_sp);
+    }
 
     return new_thread_list.GetSize(false);
 }
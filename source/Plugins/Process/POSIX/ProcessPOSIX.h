@@ -14,6 +14,7 @@
 
 // C++ Includes
 #include <queue>
+#include <set>
 
 // Other libraries and framework includes
 #include "lldb/Target/Process.h"
@@ -102,6 +103,12 @@ public:
     virtual lldb_private::Error
     DisableBreakpoint(lldb_private::BreakpointSite *bp_site);
 
+    virtual lldb_private::Error
+    EnableWatchpoint(lldb_private::Watchpoint *wp);
+
+    virtual lldb_private::Error
+    DisableWatchpoint(lldb_private::Watchpoint *wp);
+
     virtual uint32_t
     UpdateThreadListIfNeeded();
 
@@ -130,6 +137,18 @@ public:
     /// Registers the given message with this process.
     void SendMessage(const ProcessMessage &message);
 
+    /// Queues a message for a thread which stopped while the process was being
+    /// brought to a halt.  Unlike SendMessage the process state is not
+    /// changed; the message is delivered along with the next stop.
+    void QueueMessage(const ProcessMessage &message);
+
+    /// Records that the thread @p tid exists in the inferior.  The thread list
+    /// is brought up to date on the next stop.
+    void AddThreadID(lldb::tid_t tid);
+
+    /// Records that the thread @p tid has exited.
+    void RemoveThreadID(lldb::tid_t tid);
+
     ProcessMonitor &
     GetMonitor() { assert(m_monitor); return *m_monitor; }
 
@@ -154,6 +173,10 @@ protected:
     lldb_private::Mutex m_message_mutex;
     std::queue<ProcessMessage> m_message_queue;
 
+    /// IDs of the threads currently alive in the inferior.
+    lldb_private::Mutex m_tid_mutex;
+    std::set<lldb::tid_t> m_tids;
+
     /// True when the process has entered a state of "limbo".
     ///
     /// This flag qualifies eStateStopped.  It lets us know that when we
@@ -173,6 +196,10 @@ protected:
     /// Returns true if the process is stopped.
     bool IsStopped();
 
+    /// Reads the general purpose registers of every thread with a single
+    /// round trip to the monitor.
+    void ReadAllThreadsGPR();
+
     typedef std::map<lldb::addr_t, lldb::addr_t> MMapMap;
     MMapMap m_addr_to_mmap_size;
 };
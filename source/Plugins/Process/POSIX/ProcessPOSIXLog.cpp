@@ -67,6 +67,7 @@ ProcessPOSIXLog::DisableLog (Args &args, Stream *feedback_strm)
                 else if (::strcasecmp (arg, "default")    == 0 ) flag_bits &= ~POSIX_LOG_DEFAULT;
                 else if (::strcasecmp (arg, "packets")    == 0 ) flag_bits &= ~POSIX_LOG_PACKETS;
                 else if (::strcasecmp (arg, "memory")     == 0 ) flag_bits &= ~POSIX_LOG_MEMORY;
+                else if (::strncasecmp (arg, "operation", 9) == 0 ) flag_bits &= ~POSIX_LOG_OPERATIONS;
                 else if (::strcasecmp (arg, "data-short") == 0 ) flag_bits &= ~POSIX_LOG_MEMORY_DATA_SHORT;
                 else if (::strcasecmp (arg, "data-long")  == 0 ) flag_bits &= ~POSIX_LOG_MEMORY_DATA_LONG;
                 else if (::strcasecmp (arg, "process")    == 0 ) flag_bits &= ~POSIX_LOG_PROCESS;
@@ -126,6 +127,7 @@ ProcessPOSIXLog::EnableLog (StreamSP &log_stream_sp, uint32_t log_options, Args
             else if (::strcasecmp (arg, "default")    == 0 ) flag_bits |= POSIX_LOG_DEFAULT;
             else if (::strcasecmp (arg, "packets")    == 0 ) flag_bits |= POSIX_LOG_PACKETS;
             else if (::strcasecmp (arg, "memory")     == 0 ) flag_bits |= POSIX_LOG_MEMORY;
+            else if (::strncasecmp (arg, "operation", 9) == 0 ) flag_bits |= POSIX_LOG_OPERATIONS;
             else if (::strcasecmp (arg, "data-short") == 0 ) flag_bits |= POSIX_LOG_MEMORY_DATA_SHORT;
             else if (::strcasecmp (arg, "data-long")  == 0 ) flag_bits |= POSIX_LOG_MEMORY_DATA_LONG;
             else if (::strcasecmp (arg, "process")    == 0 ) flag_bits |= POSIX_LOG_PROCESS;
@@ -166,6 +168,7 @@ ProcessPOSIXLog::ListLogCategories (Stream *strm)
                   "  memory - log memory reads and writes\n"
                   "  data-short - log memory bytes for memory reads and writes for short transactions only\n"
                   "  data-long - log memory bytes for memory reads and writes for all transactions\n"
+                  "  operations - log batches serviced by the operation thread and their timing\n"
                   "  process - log process events and activities\n"
 #ifndef LLDB_CONFIGURATION_BUILDANDINTEGRATION
                   "  ptrace - log all calls to ptrace\n"
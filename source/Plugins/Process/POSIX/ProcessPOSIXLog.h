@@ -31,6 +31,7 @@
 #define POSIX_LOG_ASYNC                    (1u << 11)
 #define POSIX_LOG_PTRACE                   (1u << 12)
 #define POSIX_LOG_REGISTERS                (1u << 13)
+#define POSIX_LOG_OPERATIONS               (1u << 14)
 #define POSIX_LOG_ALL                      (UINT32_MAX)
 #define POSIX_LOG_DEFAULT                  POSIX_LOG_PACKETS
 
@@ -15,6 +15,8 @@
 // Other libraries and framework includes
 #include "lldb/Target/RegisterContext.h"
 
+class OperationBatch;
+
 //------------------------------------------------------------------------------
 /// @class RegisterContextPOSIX
 ///
@@ -35,6 +37,51 @@ public:
     /// @return
     ///    True if the operation succeeded and false otherwise.
     virtual bool UpdateAfterBreakpoint() { return true; }
+
+    /// Programs the hardware watchpoint @p hw_index of the thread, so that
+    /// every thread of a process can watch an address with the same debug
+    /// register.
+    ///
+    /// @return
+    ///    True if the watchpoint was set and false otherwise.
+    virtual bool
+    SetHardwareWatchpointWithIndex(lldb::addr_t addr, size_t size,
+                                   bool read, bool write,
+                                   uint32_t hw_index) { return false; }
+
+    /// Returns true if the hardware watchpoint @p hw_index is not in use.
+    virtual bool
+    IsWatchpointVacant(uint32_t hw_index) { return false; }
+
+    /// Returns true if the hardware watchpoint @p hw_index triggered the
+    /// last stop of the thread.
+    virtual bool
+    IsWatchpointHit(uint32_t hw_index) { return false; }
+
+    /// Resets the status bits recording which hardware watchpoints
+    /// triggered.
+    virtual bool
+    ClearWatchpointHits() { return false; }
+
+    /// Returns the address watched by the hardware watchpoint @p hw_index.
+    virtual lldb::addr_t
+    GetWatchpointAddress(uint32_t hw_index) { return LLDB_INVALID_ADDRESS; }
+
+    /// Queues a read of the general purpose registers of the thread into
+    /// @p batch at @p index, so that the registers of every thread can be
+    /// read with a single round trip to the monitor.  Once the batch has
+    /// run, DidReadGPR must be called with the outcome of that request.
+    ///
+    /// @return
+    ///    True if a read was queued and false if the context only reads
+    ///    registers one at a time.
+    virtual bool
+    QueueReadGPR(OperationBatch &batch, size_t &index) { return false; }
+
+    /// Keeps the general purpose registers read by the request QueueReadGPR
+    /// queued, if @p success, until the process resumes.
+    virtual void
+    DidReadGPR(bool success) { }
 };
 
 #endif // #ifndef liblldb_RegisterContextPOSIX_H_
@@ -13,6 +13,7 @@
 
 #include "lldb/Core/DataBufferHeap.h"
 #include "lldb/Core/DataExtractor.h"
+#include "lldb/Core/RegisterValue.h"
 #include "lldb/Core/Scalar.h"
 #include "lldb/Target/Thread.h"
 #include "lldb/Host/Endian.h"
@@ -333,14 +334,14 @@ g_register_infos[k_num_registers] =
     // General purpose registers.
     DEFINE_GPR(rax,    NULL,    gcc_dwarf_gpr_rax,   gcc_dwarf_gpr_rax,   LLDB_INVALID_REGNUM,       gdb_gpr_rax),
     DEFINE_GPR(rbx,    NULL,    gcc_dwarf_gpr_rbx,   gcc_dwarf_gpr_rbx,   LLDB_INVALID_REGNUM,       gdb_gpr_rbx),
-    DEFINE_GPR(rcx,    NULL,    gcc_dwarf_gpr_rcx,   gcc_dwarf_gpr_rcx,   LLDB_INVALID_REGNUM,       gdb_gpr_rcx),
-    DEFINE_GPR(rdx,    NULL,    gcc_dwarf_gpr_rdx,   gcc_dwarf_gpr_rdx,   LLDB_INVALID_REGNUM,       gdb_gpr_rdx),
-    DEFINE_GPR(rdi,    NULL,    gcc_dwarf_gpr_rdi,   gcc_dwarf_gpr_rdi,   LLDB_INVALID_REGNUM,       gdb_gpr_rdi),
-    DEFINE_GPR(rsi,    NULL,    gcc_dwarf_gpr_rsi,   gcc_dwarf_gpr_rsi,   LLDB_INVALID_REGNUM,       gdb_gpr_rsi),
+    DEFINE_GPR(rcx,    NULL,    gcc_dwarf_gpr_rcx,   gcc_dwarf_gpr_rcx,   LLDB_REGNUM_GENERIC_ARG4,  gdb_gpr_rcx),
+    DEFINE_GPR(rdx,    NULL,    gcc_dwarf_gpr_rdx,   gcc_dwarf_gpr_rdx,   LLDB_REGNUM_GENERIC_ARG3,  gdb_gpr_rdx),
+    DEFINE_GPR(rdi,    NULL,    gcc_dwarf_gpr_rdi,   gcc_dwarf_gpr_rdi,   LLDB_REGNUM_GENERIC_ARG1,  gdb_gpr_rdi),
+    DEFINE_GPR(rsi,    NULL,    gcc_dwarf_gpr_rsi,   gcc_dwarf_gpr_rsi,   LLDB_REGNUM_GENERIC_ARG2,  gdb_gpr_rsi),
     DEFINE_GPR(rbp,    "fp",    gcc_dwarf_gpr_rbp,   gcc_dwarf_gpr_rbp,   LLDB_REGNUM_GENERIC_FP,    gdb_gpr_rbp),
     DEFINE_GPR(rsp,    "sp",    gcc_dwarf_gpr_rsp,   gcc_dwarf_gpr_rsp,   LLDB_REGNUM_GENERIC_SP,    gdb_gpr_rsp),
-    DEFINE_GPR(r8,     NULL,    gcc_dwarf_gpr_r8,    gcc_dwarf_gpr_r8,    LLDB_INVALID_REGNUM,       gdb_gpr_r8),
-    DEFINE_GPR(r9,     NULL,    gcc_dwarf_gpr_r9,    gcc_dwarf_gpr_r9,    LLDB_INVALID_REGNUM,       gdb_gpr_r9),
+    DEFINE_GPR(r8,     NULL,    gcc_dwarf_gpr_r8,    gcc_dwarf_gpr_r8,    LLDB_REGNUM_GENERIC_ARG5,  gdb_gpr_r8),
+    DEFINE_GPR(r9,     NULL,    gcc_dwarf_gpr_r9,    gcc_dwarf_gpr_r9,    LLDB_REGNUM_GENERIC_ARG6,  gdb_gpr_r9),
     DEFINE_GPR(r10,    NULL,    gcc_dwarf_gpr_r10,   gcc_dwarf_gpr_r10,   LLDB_INVALID_REGNUM,       gdb_gpr_r10),
     DEFINE_GPR(r11,    NULL,    gcc_dwarf_gpr_r11,   gcc_dwarf_gpr_r11,   LLDB_INVALID_REGNUM,       gdb_gpr_r11),
     DEFINE_GPR(r12,    NULL,    gcc_dwarf_gpr_r12,   gcc_dwarf_gpr_r12,   LLDB_INVALID_REGNUM,       gdb_gpr_r12),
@@ -423,7 +424,8 @@ static bool IsFPR(unsigned reg)
 
 RegisterContext_x86_64::RegisterContext_x86_64(Thread &thread,
                                                          uint32_t concrete_frame_idx)
-    : RegisterContextPOSIX(thread, concrete_frame_idx)
+    : RegisterContextPOSIX(thread, concrete_frame_idx),
+      m_gpr_valid(false)
 {
 }
 
@@ -446,16 +448,41 @@ RegisterContext_x86_64::Invalidate()
 void
 RegisterContext_x86_64::InvalidateAllRegisters()
 {
+    m_gpr_valid = false;
 }
 
 size_t
 RegisterContext_x86_64::GetRegisterCount()
 {
-    return k_num_registers;
+    return GetStaticRegisterCount();
 }
 
 const RegisterInfo *
 RegisterContext_x86_64::GetRegisterInfoAtIndex(uint32_t reg)
+{
+    return GetStaticRegisterInfoAtIndex(reg);
+}
+
+size_t
+RegisterContext_x86_64::GetRegisterSetCount()
+{
+    return GetStaticRegisterSetCount();
+}
+
+const RegisterSet *
+RegisterContext_x86_64::GetRegisterSet(uint32_t set)
+{
+    return GetStaticRegisterSet(set);
+}
+
+uint32_t
+RegisterContext_x86_64::GetStaticRegisterCount()
+{
+    return k_num_registers;
+}
+
+const RegisterInfo *
+RegisterContext_x86_64::GetStaticRegisterInfoAtIndex(uint32_t reg)
 {
     if (reg < k_num_registers)
         return &g_register_infos[reg];
@@ -463,14 +490,14 @@ RegisterContext_x86_64::GetRegisterInfoAtIndex(uint32_t reg)
         return NULL;
 }
 
-size_t
-RegisterContext_x86_64::GetRegisterSetCount()
+uint32_t
+RegisterContext_x86_64::GetStaticRegisterSetCount()
 {
     return k_num_register_sets;
 }
 
 const RegisterSet *
-RegisterContext_x86_64::GetRegisterSet(uint32_t set)
+RegisterContext_x86_64::GetStaticRegisterSet(uint32_t set)
 {
     if (set < k_num_register_sets)
         return &g_reg_sets[set];
@@ -503,8 +530,20 @@ RegisterContext_x86_64::ReadRegister(const RegisterInfo *reg_info,
                                           RegisterValue &value)
 {
     const uint32_t reg = reg_info->kinds[eRegisterKindLLDB];
+
+    // The general purpose registers may have been read along with those of
+    // the other threads when the process stopped.
+    InvalidateIfNeeded(false);
+    if (m_gpr_valid && IsGPR(reg))
+    {
+        uint64_t data;
+        ::memcpy (&data, (const uint8_t *)&user + GetRegOffset(reg), sizeof(data));
+        value = data;
+        return true;
+    }
+
     ProcessMonitor &monitor = GetMonitor();
-    return monitor.ReadRegisterValue(GetRegOffset(reg), GetRegSize(reg), value);
+    return monitor.ReadRegisterValue(m_thread.GetID(), GetRegOffset(reg), GetRegSize(reg), value);
 }
 
 bool
@@ -529,7 +568,8 @@ RegisterContext_x86_64::WriteRegister(const lldb_private::RegisterInfo *reg_info
 {
     const uint32_t reg = reg_info->kinds[eRegisterKindLLDB];
     ProcessMonitor &monitor = GetMonitor();
-    return monitor.WriteRegisterValue(GetRegOffset(reg), value);
+    m_gpr_valid = false;
+    return monitor.WriteRegisterValue(m_thread.GetID(), GetRegOffset(reg), value);
 }
 
 bool
@@ -542,6 +582,7 @@ RegisterContext_x86_64::WriteAllRegisterValues(const DataBufferSP &data_sp)
         src += sizeof(user.regs);
 
         ::memcpy (&user.i387, src, sizeof(user.i387));
+        m_gpr_valid = false;
         return WriteGPR() & WriteFPR();
     }
     return false;
@@ -728,30 +769,194 @@ RegisterContext_x86_64::HardwareSingleStep(bool enable)
     return WriteRegisterFromUnsigned(gpr_rflags, rflags);
 }
 
+// Bits of the debug status (DR6) and control (DR7) registers.
+enum
+{
+    k_num_hw_watchpoints = 4,
+    k_dr_status = 6,
+    k_dr_control = 7
+};
+
+static inline uint64_t
+GetWatchControlMask(uint32_t hw_index)
+{
+    // Local and global enable bits, along with the access type and length.
+    return ((uint64_t)3 << (2 * hw_index)) | ((uint64_t)0xf << (16 + 4 * hw_index));
+}
+
+uint32_t
+RegisterContext_x86_64::NumSupportedHardwareWatchpoints()
+{
+    return k_num_hw_watchpoints;
+}
+
+uint32_t
+RegisterContext_x86_64::SetHardwareWatchpoint(lldb::addr_t addr, size_t size,
+                                              bool read, bool write)
+{
+    for (uint32_t hw_index = 0; hw_index < k_num_hw_watchpoints; ++hw_index)
+    {
+        if (IsWatchpointVacant(hw_index))
+        {
+            if (SetHardwareWatchpointWithIndex(addr, size, read, write, hw_index))
+                return hw_index;
+            break;
+        }
+    }
+    return LLDB_INVALID_INDEX32;
+}
+
+bool
+RegisterContext_x86_64::SetHardwareWatchpointWithIndex(lldb::addr_t addr, size_t size,
+                                                       bool read, bool write,
+                                                       uint32_t hw_index)
+{
+    if (hw_index >= k_num_hw_watchpoints || !(read || write))
+        return false;
+
+    uint64_t len_bits;
+    switch (size)
+    {
+    default:
+        return false;
+    case 1: len_bits = 0; break;
+    case 2: len_bits = 1; break;
+    case 4: len_bits = 3; break;
+    case 8: len_bits = 2; break;
+    }
+
+    // Debug registers can only watch naturally aligned locations.
+    if (addr % size != 0)
+        return false;
+
+    // The hardware can't trap on reads alone, only on reads or writes.
+    const uint64_t rw_bits = read ? 3 : 1;
+
+    uint64_t control;
+    if (!ReadDebugRegister(k_dr_control, control))
+        return false;
+
+    control &= ~GetWatchControlMask(hw_index);
+    control |= (uint64_t)1 << (2 * hw_index);
+    control |= (rw_bits | (len_bits << 2)) << (16 + 4 * hw_index);
+
+    // The address has to be in place before the watchpoint is enabled.
+    return WriteDebugRegister(hw_index, addr) &&
+           WriteDebugRegister(k_dr_control, control);
+}
+
+bool
+RegisterContext_x86_64::ClearHardwareWatchpoint(uint32_t hw_index)
+{
+    if (hw_index >= k_num_hw_watchpoints)
+        return false;
+
+    uint64_t control;
+    if (!ReadDebugRegister(k_dr_control, control))
+        return false;
+
+    control &= ~GetWatchControlMask(hw_index);
+    return WriteDebugRegister(k_dr_control, control) &&
+           WriteDebugRegister(hw_index, 0);
+}
+
+bool
+RegisterContext_x86_64::IsWatchpointVacant(uint32_t hw_index)
+{
+    uint64_t control;
+    if (hw_index >= k_num_hw_watchpoints || !ReadDebugRegister(k_dr_control, control))
+        return false;
+
+    return (control & ((uint64_t)3 << (2 * hw_index))) == 0;
+}
+
+bool
+RegisterContext_x86_64::IsWatchpointHit(uint32_t hw_index)
+{
+    uint64_t status;
+    if (hw_index >= k_num_hw_watchpoints || !ReadDebugRegister(k_dr_status, status))
+        return false;
+
+    return (status & ((uint64_t)1 << hw_index)) != 0;
+}
+
+bool
+RegisterContext_x86_64::ClearWatchpointHits()
+{
+    // The status bits are sticky, the processor never clears them.
+    return WriteDebugRegister(k_dr_status, 0);
+}
+
+lldb::addr_t
+RegisterContext_x86_64::GetWatchpointAddress(uint32_t hw_index)
+{
+    uint64_t addr;
+    if (hw_index >= k_num_hw_watchpoints || IsWatchpointVacant(hw_index) ||
+        !ReadDebugRegister(hw_index, addr))
+        return LLDB_INVALID_ADDRESS;
+
+    return addr;
+}
+
+bool
+RegisterContext_x86_64::QueueReadGPR(OperationBatch &batch, size_t &index)
+{
+    m_gpr_valid = false;
+    index = batch.ReadGPR(m_thread.GetID(), &user.regs);
+    return true;
+}
+
+void
+RegisterContext_x86_64::DidReadGPR(bool success)
+{
+    // The registers are good until the process resumes, which changes the
+    // stop ID.
+    SetStopID(m_thread.GetProcess().GetStopID());
+    m_gpr_valid = success;
+}
+
 bool
 RegisterContext_x86_64::ReadGPR()
 {
      ProcessMonitor &monitor = GetMonitor();
-     return monitor.ReadGPR(&user.regs);
+     return monitor.ReadGPR(m_thread.GetID(), &user.regs);
 }
 
 bool
 RegisterContext_x86_64::ReadFPR()
 {
     ProcessMonitor &monitor = GetMonitor();
-    return monitor.ReadFPR(&user.i387);
+    return monitor.ReadFPR(m_thread.GetID(), &user.i387);
 }
 
 bool
 RegisterContext_x86_64::WriteGPR()
 {
      ProcessMonitor &monitor = GetMonitor();
-     return monitor.WriteGPR(&user.regs);
+     return monitor.WriteGPR(m_thread.GetID(), &user.regs);
 }
 
 bool
 RegisterContext_x86_64::WriteFPR()
 {
     ProcessMonitor &monitor = GetMonitor();
-    return monitor.WriteFPR(&user.i387);
+    return monitor.WriteFPR(m_thread.GetID(), &user.i387);
+}
+
+bool
+RegisterContext_x86_64::ReadDebugRegister(unsigned index, uint64_t &value)
+{
+    ProcessMonitor &monitor = GetMonitor();
+    RegisterValue reg_value;
+    if (!monitor.ReadDebugRegisterValue(m_thread.GetID(), index, reg_value))
+        return false;
+    value = reg_value.GetAsUInt64();
+    return true;
+}
+
+bool
+RegisterContext_x86_64::WriteDebugRegister(unsigned index, uint64_t value)
+{
+    ProcessMonitor &monitor = GetMonitor();
+    return monitor.WriteDebugRegisterValue(m_thread.GetID(), index, RegisterValue(value));
 }
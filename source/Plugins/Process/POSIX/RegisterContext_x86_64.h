@@ -56,6 +56,23 @@ public:
     static const char *
     GetRegisterName(unsigned reg);
 
+    //------------------------------------------------------------------
+    // The register table without a register context, for code that has
+    // no thread to make one for, like NativeProcessLinux. The register
+    // offsets are offsets into a UserArea.
+    //------------------------------------------------------------------
+    static uint32_t
+    GetStaticRegisterCount();
+
+    static const lldb_private::RegisterInfo *
+    GetStaticRegisterInfoAtIndex(uint32_t reg);
+
+    static uint32_t
+    GetStaticRegisterSetCount();
+
+    static const lldb_private::RegisterSet *
+    GetStaticRegisterSet(uint32_t set);
+
     virtual bool
     ReadRegister(const lldb_private::RegisterInfo *reg_info,
                  lldb_private::RegisterValue &value);
@@ -79,6 +96,37 @@ public:
     bool
     UpdateAfterBreakpoint();
 
+    uint32_t
+    NumSupportedHardwareWatchpoints();
+
+    uint32_t
+    SetHardwareWatchpoint(lldb::addr_t addr, size_t size, bool read, bool write);
+
+    bool
+    ClearHardwareWatchpoint(uint32_t hw_index);
+
+    bool
+    SetHardwareWatchpointWithIndex(lldb::addr_t addr, size_t size,
+                                   bool read, bool write, uint32_t hw_index);
+
+    bool
+    IsWatchpointVacant(uint32_t hw_index);
+
+    bool
+    IsWatchpointHit(uint32_t hw_index);
+
+    bool
+    ClearWatchpointHits();
+
+    lldb::addr_t
+    GetWatchpointAddress(uint32_t hw_index);
+
+    bool
+    QueueReadGPR(OperationBatch &batch, size_t &index);
+
+    void
+    DidReadGPR(bool success);
+
     struct MMSReg
     {
         uint8_t bytes[10];
@@ -130,6 +178,7 @@ public:
 
 private:
     UserArea user;
+    bool m_gpr_valid;           // user.regs holds the registers of this stop.
 
     ProcessMonitor &GetMonitor();
 
@@ -138,6 +187,9 @@ private:
 
     bool WriteGPR();
     bool WriteFPR();
+
+    bool ReadDebugRegister(unsigned index, uint64_t &value);
+    bool WriteDebugRegister(unsigned index, uint64_t value);
 };
 
 #endif // #ifndef liblldb_RegisterContext_x86_64_H_
@@ -9,8 +9,11 @@
 
 #include "lldb/Core/Module.h"
 #include "lldb/Core/Log.h"
+#include "lldb/Core/DataExtractor.h"
+#include "lldb/Core/Error.h"
 #include "lldb/Symbol/FuncUnwinders.h"
 #include "lldb/Symbol/Function.h"
+#include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Symbol/UnwindPlan.h"
 #include "lldb/Target/Thread.h"
 #include "lldb/Target/Target.h"
@@ -25,7 +28,13 @@ using namespace lldb_private;
 
 UnwindLLDB::UnwindLLDB (Thread &thread) :
     Unwind (thread),
-    m_frames()
+    m_frames(),
+    m_fast_unwind_frames (false),
+    m_arch_default_row_valid (eLazyBoolCalculate),
+    m_arch_default_row (),
+    m_stack_base (LLDB_INVALID_ADDRESS),
+    m_stack_bytes (),
+    m_stack_read_complete (false)
 {
 }
 
@@ -39,6 +48,9 @@ UnwindLLDB::DoGetFrameCount()
 #define FRAME_COUNT 10000
         TimeValue time_value (TimeValue::Now());
 #endif
+        if (m_thread.GetFastUnwindEnabledState() && AddFramesWithFastUnwind ())
+            return m_frames.size ();
+
         if (!AddFirstFrame ())
             return 0;
 
@@ -181,13 +193,17 @@ UnwindLLDB::DoGetFrameInfoAtIndex (uint32_t idx, addr_t& cfa, addr_t& pc)
 {
     if (m_frames.size() == 0)
     {
-        if (!AddFirstFrame())
+        if (m_thread.GetFastUnwindEnabledState())
+            AddFramesWithFastUnwind ();
+
+        if (m_frames.empty() && !AddFirstFrame())
             return false;
     }
 
     ABI *abi = m_thread.GetProcess().GetABI().get();
 
-    while (idx >= m_frames.size() && AddOneMoreFrame (abi))
+    // A fast unwind already added every frame it could find
+    while (idx >= m_frames.size() && !m_fast_unwind_frames && AddOneMoreFrame (abi))
         ;
 
     if (idx < m_frames.size ())
@@ -210,6 +226,16 @@ UnwindLLDB::DoCreateRegisterContextForFrame (StackFrame *frame)
         return m_thread.GetRegisterContext();
     }
 
+    if (m_fast_unwind_frames)
+    {
+        // Frames from a fast unwind have no register contexts. Give them
+        // full ones, without redoing the unwind: the frames may already
+        // have been shown and must stay as they are.
+        if (AddRegisterContextsToFastFrames (idx))
+            reg_ctx_sp = m_frames[idx]->reg_ctx;
+        return reg_ctx_sp;
+    }
+
     if (m_frames.size() == 0)
     {
         if (!AddFirstFrame())
@@ -226,6 +252,286 @@ UnwindLLDB::DoCreateRegisterContextForFrame (StackFrame *frame)
     return reg_ctx_sp;
 }
 
+//----------------------------------------------------------------------
+// Create the RegisterContextLLDBs of the fast unwind frames up to and
+// including "idx", the way AddFirstFrame() and AddOneMoreFrame() would.
+// Each one must find the same pc and CFA as the fast unwind did; if one
+// doesn't, the fast unwind went wrong at that frame and there is no
+// register context we could hand out for it, or for the frames above it,
+// that agrees with what the frame says.
+//----------------------------------------------------------------------
+bool
+UnwindLLDB::AddRegisterContextsToFastFrames (uint32_t idx)
+{
+    if (idx >= m_frames.size())
+        return false;
+
+    LogSP log(GetLogIfAllCategoriesSet (LIBLLDB_LOG_UNWIND));
+    for (uint32_t cur_idx = 0; cur_idx <= idx; ++cur_idx)
+    {
+        Cursor &cursor = *m_frames[cur_idx];
+        if (cursor.reg_ctx.get())
+            continue;
+
+        RegisterContextLLDBSharedPtr prev_reg_ctx_sp;
+        if (cur_idx > 0)
+            prev_reg_ctx_sp = m_frames[cur_idx - 1]->reg_ctx;
+        RegisterContextLLDBSharedPtr reg_ctx_sp (new RegisterContextLLDB (m_thread, 
+                                                                            prev_reg_ctx_sp, 
+                                                                            cursor.sctx, 
+                                                                            cur_idx, *this));
+        addr_t cfa = LLDB_INVALID_ADDRESS;
+        addr_t pc = LLDB_INVALID_ADDRESS;
+        if (!reg_ctx_sp->IsValid() ||
+            !reg_ctx_sp->GetCFA (cfa) ||
+            !reg_ctx_sp->ReadPC (pc) ||
+            cfa != cursor.cfa ||
+            pc != cursor.start_pc)
+        {
+            if (log)
+            {
+                log->Printf("%*sFrame %u pc 0x%llx cfa 0x%llx from the fast unwind doesn't match pc 0x%llx cfa 0x%llx from the full unwinder",
+                            cur_idx < 100 ? cur_idx : 100, "", cur_idx, 
+                            (uint64_t)cursor.start_pc, (uint64_t)cursor.cfa, (uint64_t)pc, (uint64_t)cfa);
+            }
+            return false;
+        }
+        cursor.reg_ctx = reg_ctx_sp;
+    }
+    return true;
+}
+
+//----------------------------------------------------------------------
+// Walk the stack using only the compiled rows from the UnwindTables,
+// tracking nothing but the pc, stack pointer and frame pointer of each
+// frame.  This is what profilers sampling the stack of a running program
+// need, and it avoids creating a RegisterContextLLDB and looking up
+// FuncUnwinders and UnwindPlans for every frame.  The stack is read in
+// large chunks instead of a word at a time.
+//
+// Returns false, leaving m_frames empty, if some frame needs the full
+// unwinder.  Where the walk ends must match AddOneMoreFrame().
+//----------------------------------------------------------------------
+bool
+UnwindLLDB::AddFramesWithFastUnwind ()
+{
+    LogSP log(GetLogIfAllCategoriesSet (LIBLLDB_LOG_UNWIND));
+    ABI *abi = m_thread.GetProcess().GetABI().get();
+    RegisterContextSP reg_ctx_sp (m_thread.GetRegisterContext());
+    if (abi == NULL || reg_ctx_sp.get() == NULL)
+        return false;
+
+    addr_t pc = reg_ctx_sp->GetPC();
+    addr_t sp = reg_ctx_sp->GetSP();
+    addr_t fp = reg_ctx_sp->GetFP();
+    if (pc == LLDB_INVALID_ADDRESS || sp == LLDB_INVALID_ADDRESS)
+        return false;
+
+    m_stack_base = sp;
+    m_stack_bytes.clear();
+    m_stack_read_complete = false;
+
+    std::vector<CursorSP> frames;
+    for (uint32_t cur_idx = 0; ; ++cur_idx)
+    {
+        const bool frame_zero = cur_idx == 0;
+        UnwindTable::FastUnwindRow fast_row;
+        if (!GetFastUnwindRow (pc, frame_zero, fast_row))
+        {
+            if (log)
+            {
+                log->Printf("%*sFrame %u pc 0x%llx needs the full unwinder",
+                            cur_idx < 100 ? cur_idx : 100, "", cur_idx, (uint64_t)pc);
+            }
+            return false;
+        }
+
+        const addr_t cfa_reg_value = fast_row.cfa_reg == LLDB_REGNUM_GENERIC_SP ? sp : fp;
+        if (cfa_reg_value == LLDB_INVALID_ADDRESS)
+        {
+            if (log)
+            {
+                log->Printf("%*sFrame %u needs a frame pointer that wasn't recovered",
+                            cur_idx < 100 ? cur_idx : 100, "", cur_idx);
+            }
+            return false;
+        }
+        const addr_t cfa = cfa_reg_value + fast_row.cfa_offset;
+
+        if (!frame_zero)
+        {
+            if (!abi->CallFrameAddressIsValid (cfa))
+                break;
+            if (frames.back()->start_pc == pc)
+            {
+                if (frames.back()->cfa == cfa)
+                    break;
+                else if (abi->StackUsesFrames() && fp == 0)
+                    break;
+            }
+        }
+
+        CursorSP cursor_sp (new Cursor ());
+        cursor_sp->start_pc = pc;
+        cursor_sp->cfa = cfa;
+        frames.push_back (cursor_sp);
+
+        // Recover the caller's registers
+        addr_t caller_pc, caller_sp, caller_fp;
+        if (!RecoverRegister (fast_row.pc_rule, fast_row.pc_offset, cfa, pc, caller_pc))
+            break;
+        if (!abi->CodeAddressIsValid (caller_pc))
+            break;
+        if (!RecoverRegister (fast_row.sp_rule, fast_row.sp_offset, cfa, sp, caller_sp))
+            break;
+        if (!RecoverRegister (fast_row.fp_rule, fast_row.fp_offset, cfa, fp, caller_fp))
+            caller_fp = LLDB_INVALID_ADDRESS;
+
+        pc = caller_pc;
+        sp = caller_sp;
+        fp = caller_fp;
+    }
+
+    if (log)
+    {
+        log->Printf("Fast unwind of %u frames read %llu bytes of stack",
+                    (uint32_t)frames.size(), (uint64_t)m_stack_bytes.size());
+    }
+    m_frames.swap (frames);
+    m_fast_unwind_frames = true;
+    return true;
+}
+
+bool
+UnwindLLDB::GetFastUnwindRow (addr_t pc, bool frame_zero, UnwindTable::FastUnwindRow &fast_row)
+{
+    // The return address of a caller may be the first address past the
+    // end of its function, so look up the call instruction instead.
+    const addr_t lookup_pc = frame_zero ? pc : pc - 1;
+    Address lookup_addr;
+    Target &target = m_thread.GetProcess().GetTarget();
+    if (target.GetSectionLoadList().ResolveLoadAddress (lookup_pc, lookup_addr) &&
+        lookup_addr.GetModule() && 
+        lookup_addr.GetModule()->GetObjectFile())
+    {
+        UnwindTable &unwind_table = lookup_addr.GetModule()->GetObjectFile()->GetUnwindTable();
+        if (!unwind_table.GetFastUnwindRow (lookup_addr, frame_zero, m_thread, fast_row))
+            return false;
+        if (fast_row.type == UnwindTable::FastUnwindRow::eTypeCompiled)
+            return true;
+        if (fast_row.type == UnwindTable::FastUnwindRow::eTypeUnsupported)
+            return false;
+    }
+    else if (frame_zero)
+    {
+        // We may have jumped through a bad function pointer, the full
+        // unwinder knows how to deal with that.
+        return false;
+    }
+    return GetArchDefaultFastUnwindRow (fast_row);
+}
+
+bool
+UnwindLLDB::GetArchDefaultFastUnwindRow (UnwindTable::FastUnwindRow &fast_row)
+{
+    if (m_arch_default_row_valid == eLazyBoolCalculate)
+    {
+        m_arch_default_row_valid = eLazyBoolNo;
+        ABI *abi = m_thread.GetProcess().GetABI().get();
+        RegisterContextSP reg_ctx_sp (m_thread.GetRegisterContext());
+        if (abi && reg_ctx_sp.get())
+        {
+            UnwindPlan arch_default (eRegisterKindGeneric);
+            if (abi->CreateDefaultUnwindPlan (arch_default) &&
+                arch_default.GetRowCount() == 1 &&
+                UnwindTable::CompileFastUnwindRow (arch_default, 
+                                                   arch_default.GetRowAtIndex (0), 
+                                                   *reg_ctx_sp, 
+                                                   m_arch_default_row))
+            {
+                m_arch_default_row_valid = eLazyBoolYes;
+            }
+        }
+    }
+    if (m_arch_default_row_valid != eLazyBoolYes)
+        return false;
+    fast_row = m_arch_default_row;
+    return true;
+}
+
+bool
+UnwindLLDB::RecoverRegister (uint8_t rule, int32_t offset, addr_t cfa, addr_t reg_value, addr_t &caller_value)
+{
+    switch (rule)
+    {
+    case UnwindTable::FastUnwindRow::eRuleSame:
+        caller_value = reg_value;
+        return reg_value != LLDB_INVALID_ADDRESS;
+
+    case UnwindTable::FastUnwindRow::eRuleAtCFAPlusOffset:
+        return ReadStackWord (cfa + offset, caller_value);
+
+    case UnwindTable::FastUnwindRow::eRuleIsCFAPlusOffset:
+        caller_value = cfa + offset;
+        return true;
+
+    default:
+        break;
+    }
+    return false;
+}
+
+// Read a pointer sized value from the stack.  Words above the stack
+// pointer of frame zero come from a buffer that is filled in large reads,
+// doubling in size each time the walk goes past its end.
+bool
+UnwindLLDB::ReadStackWord (addr_t addr, addr_t &value)
+{
+    Process &process = m_thread.GetProcess();
+    const uint32_t addr_byte_size = process.GetAddressByteSize();
+    if (addr >= m_stack_base && addr - m_stack_base <= eMaxStackReadByteSize)
+    {
+        const addr_t needed_byte_size = addr - m_stack_base + addr_byte_size;
+        if (needed_byte_size > m_stack_bytes.size() && !m_stack_read_complete)
+        {
+            size_t new_byte_size = m_stack_bytes.empty() ? eInitialStackReadByteSize : m_stack_bytes.size() * 2;
+            while (new_byte_size < needed_byte_size)
+                new_byte_size *= 2;
+            if (new_byte_size > eMaxStackReadByteSize)
+                new_byte_size = eMaxStackReadByteSize;
+
+            const size_t old_byte_size = m_stack_bytes.size();
+            const size_t read_byte_size = new_byte_size - old_byte_size;
+            m_stack_bytes.resize (new_byte_size);
+            Error error;
+            const size_t bytes_read = process.ReadMemory (m_stack_base + old_byte_size, 
+                                                          &m_stack_bytes[old_byte_size], 
+                                                          read_byte_size, 
+                                                          error);
+            m_stack_bytes.resize (old_byte_size + bytes_read);
+            // A short read means we hit the end of the stack
+            if (bytes_read < read_byte_size || new_byte_size == eMaxStackReadByteSize)
+                m_stack_read_complete = true;
+        }
+
+        if (needed_byte_size <= m_stack_bytes.size())
+        {
+            DataExtractor data (&m_stack_bytes[0], 
+                                m_stack_bytes.size(), 
+                                process.GetByteOrder(), 
+                                addr_byte_size);
+            uint32_t offset = addr - m_stack_base;
+            value = data.GetAddress (&offset);
+            return true;
+        }
+    }
+
+    // Not in the part of the stack we read
+    Error error;
+    value = process.ReadPointerFromMemory (addr, error);
+    return error.Success();
+}
+
 UnwindLLDB::RegisterContextLLDBSharedPtr
 UnwindLLDB::GetRegisterContextForFrameNum (uint32_t frame_num)
 {
@@ -15,6 +15,7 @@
 #include "lldb/lldb-public.h"
 #include "lldb/Symbol/FuncUnwinders.h"
 #include "lldb/Symbol/UnwindPlan.h"
+#include "lldb/Symbol/UnwindTable.h"
 #include "lldb/Target/RegisterContext.h"
 #include "lldb/Target/Unwind.h"
 
@@ -30,6 +31,12 @@ public:
     virtual
     ~UnwindLLDB() { }
 
+    enum
+    {
+        eInitialStackReadByteSize = 4096,
+        eMaxStackReadByteSize = 1024 * 1024
+    };
+
 protected:
     friend class lldb_private::RegisterContextLLDB;
 
@@ -56,6 +63,7 @@ protected:
     DoClear()
     {
         m_frames.clear();
+        m_fast_unwind_frames = false;
     }
 
     virtual uint32_t
@@ -102,6 +110,27 @@ private:
     bool AddOneMoreFrame (ABI *abi);
     bool AddFirstFrame ();
 
+    //------------------------------------------------------------------
+    // Fast unwinds, see the thread's "fast-unwind" setting.  The frames
+    // only get a pc and a CFA, computed from the compiled rows of the
+    // UnwindTables, and get a RegisterContextLLDB only when one is asked
+    // for.  Anything these can't handle makes us redo the unwind with the
+    // code above.
+    //------------------------------------------------------------------
+    bool m_fast_unwind_frames;          // m_frames came from AddFramesWithFastUnwind()
+    LazyBool m_arch_default_row_valid;
+    UnwindTable::FastUnwindRow m_arch_default_row;
+    lldb::addr_t m_stack_base;          // Stack pointer of frame zero
+    std::vector<uint8_t> m_stack_bytes; // The part of the stack read so far
+    bool m_stack_read_complete;         // Don't try to read more of the stack
+
+    bool AddFramesWithFastUnwind ();
+    bool AddRegisterContextsToFastFrames (uint32_t idx);
+    bool GetFastUnwindRow (lldb::addr_t pc, bool frame_zero, UnwindTable::FastUnwindRow &fast_row);
+    bool GetArchDefaultFastUnwindRow (UnwindTable::FastUnwindRow &fast_row);
+    bool RecoverRegister (uint8_t rule, int32_t offset, lldb::addr_t cfa, lldb::addr_t reg_value, lldb::addr_t &caller_value);
+    bool ReadStackWord (lldb::addr_t addr, lldb::addr_t &value);
+
     //------------------------------------------------------------------
     // For UnwindLLDB only
     //------------------------------------------------------------------
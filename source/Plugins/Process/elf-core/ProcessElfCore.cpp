@@ -0,0 +1,627 @@
+//===-- ProcessElfCore.cpp --------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// C Includes
+#include <limits.h>
+#include <stdlib.h>
+#include <string.h>
+
+// C++ Includes
+#include <algorithm>
+#include <string>
+
+// Other libraries and framework includes
+#include "llvm/Support/ELF.h"
+
+#include "lldb/Core/ArchSpec.h"
+#include "lldb/Core/DataBufferHeap.h"
+#include "lldb/Core/DataExtractor.h"
+#include "lldb/Core/Log.h"
+#include "lldb/Core/PluginManager.h"
+#include "lldb/Core/State.h"
+#include "lldb/Target/Target.h"
+
+// Project includes
+#include "ProcessElfCore.h"
+#include "ThreadElfCore.h"
+#include "Plugins/ObjectFile/ELF/ELFHeader.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+// Types of the notes in the PT_NOTE segment of a core file. The values
+// are the NT_* constants of <elf.h>, which isn't available everywhere.
+enum
+{
+    eNoteTypePRStatus = 1,      // NT_PRSTATUS
+    eNoteTypeFPRegSet = 2,      // NT_FPREGSET
+    eNoteTypePRPSInfo = 3,      // NT_PRPSINFO
+    eNoteTypeAuxv = 6,          // NT_AUXV
+    eNoteTypeFreeBSDAuxv = 16   // NT_PROCSTAT_AUXV
+};
+
+// Offsets of the fields we need in the x86_64 prstatus and prpsinfo
+// structures of Linux and FreeBSD.
+enum
+{
+    eLinuxPRStatusSignalOffset = 12,    // pr_cursig
+    eLinuxPRStatusPIDOffset = 32,       // pr_pid
+    eLinuxPRStatusRegsOffset = 112,     // pr_reg
+    eLinuxPRPSInfoPIDOffset = 24,       // pr_pid
+    eFreeBSDPRStatusSignalOffset = 36,  // pr_cursig
+    eFreeBSDPRStatusPIDOffset = 40,     // pr_pid
+    eFreeBSDPRStatusRegsOffset = 48     // pr_reg
+};
+
+const char *
+ProcessElfCore::GetPluginNameStatic()
+{
+    return "elf-core";
+}
+
+const char *
+ProcessElfCore::GetPluginDescriptionStatic()
+{
+    return "ELF core dump plug-in.";
+}
+
+void
+ProcessElfCore::Terminate()
+{
+    PluginManager::UnregisterPlugin (ProcessElfCore::CreateInstance);
+}
+
+
+Process*
+ProcessElfCore::CreateInstance (Target &target, Listener &listener)
+{
+    return new ProcessElfCore (target, listener);
+}
+
+bool
+ProcessElfCore::CanDebug(Target &target, bool plugin_specified_by_name)
+{
+    // A core file can't be launched or attached to, only loaded by a
+    // client that asked for this plug-in.
+    return plugin_specified_by_name;
+}
+
+//----------------------------------------------------------------------
+// ProcessElfCore constructor
+//----------------------------------------------------------------------
+ProcessElfCore::ProcessElfCore(Target& target, Listener &listener) :
+    Process (target, listener),
+    m_core_data_sp (),
+    m_thread_data (),
+    m_auxv (),
+    m_core_aranges (),
+    m_core_range_infos ()
+{
+}
+
+//----------------------------------------------------------------------
+// Destructor
+//----------------------------------------------------------------------
+ProcessElfCore::~ProcessElfCore()
+{
+    Clear();
+    // We need to call finalize on the process before destroying ourselves
+    // to make sure all of the broadcaster cleanup goes as planned. If we
+    // destruct this class, then Process::~Process() might have problems
+    // trying to fully destroy the broadcaster.
+    Finalize();
+}
+
+//----------------------------------------------------------------------
+// PluginInterface
+//----------------------------------------------------------------------
+const char *
+ProcessElfCore::GetPluginName()
+{
+    return "Process plug-in that reads ELF core files";
+}
+
+const char *
+ProcessElfCore::GetShortPluginName()
+{
+    return GetPluginNameStatic();
+}
+
+uint32_t
+ProcessElfCore::GetPluginVersion()
+{
+    return 1;
+}
+
+void
+ProcessElfCore::Clear()
+{
+    m_thread_list.Clear();
+    m_thread_data.clear();
+    m_auxv.Clear();
+    m_core_aranges.Clear();
+    m_core_range_infos.Clear();
+    m_core_data_sp.reset();
+}
+
+void
+ProcessElfCore::AddAddressRangeFromLoadSegment (const elf::ELFProgramHeader &segment_header)
+{
+    // Segments the kernel didn't dump, like the text of mapped files, have
+    // no bytes in the core file. Leave them out so reading their memory
+    // fails instead of returning zeros.
+    if (segment_header.p_filesz == 0 || segment_header.p_memsz == 0)
+        return;
+
+    FileRange file_range (segment_header.p_offset, segment_header.p_filesz);
+    m_core_aranges.Append (VMRangeToFileOffset::Entry (segment_header.p_vaddr,
+                                                       segment_header.p_memsz,
+                                                       file_range));
+    m_core_range_infos.Append (VMRangeToPermissions::Entry (segment_header.p_vaddr,
+                                                            segment_header.p_memsz,
+                                                            segment_header.p_flags));
+}
+
+Error
+ProcessElfCore::ParseThreadContextsFromNoteSegment (const elf::ELFProgramHeader &segment_header,
+                                                    ByteOrder byte_order,
+                                                    uint32_t address_byte_size)
+{
+    Error error;
+    const size_t core_size = m_core_data_sp->GetByteSize();
+    if (segment_header.p_offset > core_size ||
+        segment_header.p_filesz > core_size - segment_header.p_offset ||
+        segment_header.p_filesz > UINT32_MAX)
+    {
+        error.SetErrorString ("the note segment is truncated");
+        return error;
+    }
+
+    // The notes are small and near the start of the file, and we copy out
+    // the few we need so the threads don't depend on the mapping.
+    DataExtractor segment_data (m_core_data_sp->GetBytes() + segment_header.p_offset,
+                                segment_header.p_filesz,
+                                byte_order,
+                                address_byte_size);
+    ThreadData *thread_data = NULL;
+    uint32_t offset = 0;
+    while (segment_data.ValidOffsetForDataOfSize (offset, 12))
+    {
+        const uint32_t namesz = segment_data.GetU32 (&offset);
+        const uint32_t descsz = segment_data.GetU32 (&offset);
+        const uint32_t type = segment_data.GetU32 (&offset);
+
+        const char *name_data = namesz ? (const char *)segment_data.PeekData (offset, namesz) : "";
+        if (namesz > segment_data.GetByteSize() || name_data == NULL)
+        {
+            error.SetErrorString ("corrupt note in the note segment");
+            break;
+        }
+        offset += (namesz + 3) & ~3u;
+        const uint32_t desc_offset = offset;
+        if (descsz > segment_data.GetByteSize() ||
+            !segment_data.ValidOffsetForDataOfSize (desc_offset, descsz))
+        {
+            error.SetErrorString ("corrupt note in the note segment");
+            break;
+        }
+        offset += (descsz + 3) & ~3u;
+
+        const std::string name (name_data, strnlen (name_data, namesz));
+        const bool is_linux = name == "CORE";
+        const bool is_freebsd = name == "FreeBSD";
+        if ((!is_linux && !is_freebsd) || descsz == 0)
+            continue;
+
+        DataBufferSP desc_sp (new DataBufferHeap (segment_data.PeekData (desc_offset, descsz), descsz));
+        DataExtractor desc (desc_sp, byte_order, address_byte_size);
+        uint32_t field_offset;
+
+        switch (type)
+        {
+        case eNoteTypePRStatus:
+            {
+                // Every thread starts with its NT_PRSTATUS note, the notes
+                // that follow until the next one belong to the same thread.
+                const uint32_t regs_offset = is_linux ? eLinuxPRStatusRegsOffset : eFreeBSDPRStatusRegsOffset;
+                if (descsz <= regs_offset)
+                {
+                    error.SetErrorString ("NT_PRSTATUS note is too small");
+                    return error;
+                }
+                m_thread_data.push_back (ThreadData());
+                thread_data = &m_thread_data.back();
+                if (is_linux)
+                {
+                    field_offset = eLinuxPRStatusSignalOffset;
+                    thread_data->signo = desc.GetU16 (&field_offset);
+                    field_offset = eLinuxPRStatusPIDOffset;
+                    thread_data->tid = desc.GetU32 (&field_offset);
+                }
+                else
+                {
+                    field_offset = eFreeBSDPRStatusSignalOffset;
+                    thread_data->signo = desc.GetU32 (&field_offset);
+                    field_offset = eFreeBSDPRStatusPIDOffset;
+                    thread_data->tid = desc.GetU32 (&field_offset);
+                }
+                thread_data->gpregset = DataExtractor (desc, regs_offset, descsz - regs_offset);
+            }
+            break;
+
+        case eNoteTypeFPRegSet:
+            if (thread_data)
+                thread_data->fpregset = desc;
+            break;
+
+        case eNoteTypePRPSInfo:
+            if (is_linux && descsz >= eLinuxPRPSInfoPIDOffset + 4)
+            {
+                field_offset = eLinuxPRPSInfoPIDOffset;
+                SetID (desc.GetU32 (&field_offset));
+            }
+            break;
+
+        case eNoteTypeAuxv:
+            if (is_linux)
+                m_auxv = desc;
+            break;
+
+        case eNoteTypeFreeBSDAuxv:
+            // The FreeBSD note starts with the size of an auxv entry.
+            if (is_freebsd && descsz > 4)
+                m_auxv = DataExtractor (desc, 4, descsz - 4);
+            break;
+
+        default:
+            break;
+        }
+    }
+    return error;
+}
+
+//----------------------------------------------------------------------
+// Process Control
+//----------------------------------------------------------------------
+Error
+ProcessElfCore::DoLoadCore (const FileSpec &core_file)
+{
+    Error error;
+    Clear();
+
+    char core_path[PATH_MAX];
+    core_file.GetPath (core_path, sizeof(core_path));
+
+    // Map the whole file up front, the kernel only reads in the pages we
+    // actually touch, so this is cheap even for very large core files.
+    DataBufferMemoryMap *core_mapping = new DataBufferMemoryMap();
+    DataBufferSP core_data_sp (core_mapping);
+    if (core_mapping->MemoryMapFromFileSpec (&core_file) == 0)
+    {
+        error.SetErrorStringWithFormat ("unable to map core file '%s'", core_path);
+        return error;
+    }
+
+    const uint8_t *core_bytes = core_data_sp->GetBytes();
+    const size_t core_size = core_data_sp->GetByteSize();
+    const uint32_t header_size = std::min<size_t> (core_size, sizeof(llvm::ELF::Elf64_Ehdr));
+    if (header_size < llvm::ELF::EI_NIDENT || !elf::ELFHeader::MagicBytesMatch (core_bytes))
+    {
+        error.SetErrorStringWithFormat ("'%s' is not an ELF file", core_path);
+        return error;
+    }
+
+    DataExtractor header_data (core_bytes, header_size, eByteOrderLittle, 4);
+    elf::ELFHeader header;
+    uint32_t offset = 0;
+    if (!header.Parse (header_data, &offset))
+    {
+        error.SetErrorStringWithFormat ("'%s' has a truncated ELF header", core_path);
+        return error;
+    }
+    if (header.e_type != llvm::ELF::ET_CORE)
+    {
+        error.SetErrorStringWithFormat ("'%s' is not a core file", core_path);
+        return error;
+    }
+    if (header.e_machine != llvm::ELF::EM_X86_64)
+    {
+        error.SetErrorStringWithFormat ("'%s' is not an x86_64 core file, only x86_64 is supported", core_path);
+        return error;
+    }
+
+    const uint64_t phdrs_size = (uint64_t)header.e_phnum * header.e_phentsize;
+    if (header.e_phoff > core_size || phdrs_size > core_size - header.e_phoff)
+    {
+        error.SetErrorStringWithFormat ("'%s' has truncated program headers", core_path);
+        return error;
+    }
+
+    m_core_data_sp = core_data_sp;
+
+    const ByteOrder byte_order = header.GetByteOrder();
+    const uint32_t address_byte_size = header.Is32Bit() ? 4 : 8;
+    DataExtractor phdr_data (core_bytes + header.e_phoff, phdrs_size, byte_order, address_byte_size);
+    for (uint32_t i = 0; i < header.e_phnum; ++i)
+    {
+        elf::ELFProgramHeader phdr;
+        offset = i * header.e_phentsize;
+        if (!phdr.Parse (phdr_data, &offset))
+            break;
+
+        if (phdr.p_type == llvm::ELF::PT_NOTE)
+        {
+            error = ParseThreadContextsFromNoteSegment (phdr, byte_order, address_byte_size);
+            if (error.Fail())
+            {
+                Clear();
+                return error;
+            }
+        }
+        else if (phdr.p_type == llvm::ELF::PT_LOAD)
+        {
+            AddAddressRangeFromLoadSegment (phdr);
+        }
+    }
+
+    // Memory reads binary search these by virtual address.
+    m_core_aranges.Sort();
+    m_core_range_infos.Sort();
+
+    if (m_thread_data.empty())
+    {
+        Clear();
+        error.SetErrorStringWithFormat ("'%s' doesn't contain any threads", core_path);
+        return error;
+    }
+
+    if (GetID() == LLDB_INVALID_PROCESS_ID)
+        SetID (m_thread_data.front().tid);
+
+    if (!m_target.GetArchitecture().IsValid())
+        m_target.SetArchitecture (ArchSpec (eArchTypeELF, header.e_machine, LLDB_INVALID_CPUTYPE));
+
+    LogSP log (GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
+    if (log)
+        log->Printf ("ProcessElfCore::DoLoadCore (\"%s\") %llu bytes, %u threads, %u load segments",
+                     core_path,
+                     (uint64_t)core_size,
+                     (uint32_t)m_thread_data.size(),
+                     (uint32_t)m_core_aranges.GetSize());
+    return error;
+}
+
+Error
+ProcessElfCore::DoLaunch (Module *exe_module, const ProcessLaunchInfo &launch_info)
+{
+    Error error;
+    error.SetErrorString ("launching is not supported by the elf-core plug-in");
+    return error;
+}
+
+Error
+ProcessElfCore::DoAttachToProcessWithID (lldb::pid_t pid)
+{
+    Error error;
+    error.SetErrorString ("attaching is not supported by the elf-core plug-in");
+    return error;
+}
+
+uint32_t
+ProcessElfCore::UpdateThreadList (ThreadList &old_thread_list, ThreadList &new_thread_list)
+{
+    // The threads of a core file never change, only create them once.
+    const uint32_t num_threads = m_thread_data.size();
+    for (uint32_t i = 0; i < num_threads; ++i)
+    {
+        const ThreadData &td = m_thread_data[i];
+        ThreadSP thread_sp (old_thread_list.FindThreadByID (td.tid, false));
+        if (!thread_sp)
+            thread_sp.reset (new ThreadElfCore (*this, td));
+        new_thread_list.AddThread (thread_sp);
+    }
+    return new_thread_list.GetSize(false);
+}
+
+void
+ProcessElfCore::RefreshStateAfterStop ()
+{
+    m_thread_list.RefreshStateAfterStop();
+}
+
+Error
+ProcessElfCore::DoResume ()
+{
+    Error error;
+    error.SetErrorString ("a process loaded from a core file can't be resumed");
+    return error;
+}
+
+Error
+ProcessElfCore::DoHalt (bool &caused_stop)
+{
+    caused_stop = false;
+    return Error();
+}
+
+Error
+ProcessElfCore::DoDetach ()
+{
+    return Error();
+}
+
+Error
+ProcessElfCore::DoSignal (int signal)
+{
+    Error error;
+    error.SetErrorString ("signals can't be sent to a process loaded from a core file");
+    return error;
+}
+
+Error
+ProcessElfCore::DoDestroy ()
+{
+    return Error();
+}
+
+//------------------------------------------------------------------
+// Process Queries
+//------------------------------------------------------------------
+bool
+ProcessElfCore::IsAlive ()
+{
+    return m_core_data_sp.get() != NULL;
+}
+
+DataBufferSP
+ProcessElfCore::GetAuxvData ()
+{
+    DataBufferSP auxv_sp;
+    if (m_auxv.GetByteSize() > 0)
+        auxv_sp.reset (new DataBufferHeap (m_auxv.GetDataStart(), m_auxv.GetByteSize()));
+    return auxv_sp;
+}
+
+//------------------------------------------------------------------
+// Process Memory
+//------------------------------------------------------------------
+size_t
+ProcessElfCore::DoReadMemory (addr_t addr, void *buf, size_t size, Error &error)
+{
+    if (!m_core_data_sp)
+    {
+        error.SetErrorString ("no core file is loaded");
+        return 0;
+    }
+
+    const uint8_t *core_bytes = m_core_data_sp->GetBytes();
+    const addr_t core_size = m_core_data_sp->GetByteSize();
+    uint8_t *dst = (uint8_t *)buf;
+    size_t bytes_read = 0;
+    while (bytes_read < size)
+    {
+        const addr_t curr_addr = addr + bytes_read;
+        const VMRangeToFileOffset::Entry *entry = m_core_aranges.FindEntryThatContains (curr_addr);
+        if (entry == NULL)
+            break;
+
+        const addr_t offset_in_segment = curr_addr - entry->GetRangeBase();
+        const size_t bytes_wanted = std::min<addr_t> (size - bytes_read, entry->GetRangeEnd() - curr_addr);
+
+        // Only the first p_filesz bytes of a segment are in the file, the
+        // rest were all zeros, like the .bss of an ELF file. A truncated
+        // core file can also end in the middle of a segment.
+        const addr_t file_end = std::min<addr_t> (entry->data.GetRangeEnd(), core_size);
+        const addr_t file_offset = entry->data.GetRangeBase() + offset_in_segment;
+        size_t file_bytes = 0;
+        if (file_offset < file_end)
+        {
+            file_bytes = std::min<addr_t> (bytes_wanted, file_end - file_offset);
+            ::memcpy (dst + bytes_read, core_bytes + file_offset, file_bytes);
+            bytes_read += file_bytes;
+        }
+        if (file_bytes < bytes_wanted)
+        {
+            if (entry->data.GetRangeEnd() > core_size)
+                break;
+            ::memset (dst + bytes_read, 0, bytes_wanted - file_bytes);
+            bytes_read += bytes_wanted - file_bytes;
+        }
+    }
+
+    if (bytes_read == 0)
+        error.SetErrorStringWithFormat ("core file does not contain 0x%llx", addr);
+    return bytes_read;
+}
+
+size_t
+ProcessElfCore::DoWriteMemory (addr_t addr, const void *buf, size_t size, Error &error)
+{
+    error.SetErrorString ("the memory of a process loaded from a core file can't be modified");
+    return 0;
+}
+
+Error
+ProcessElfCore::GetMemoryRegionInfo (addr_t load_addr, MemoryRegionInfo &region_info)
+{
+    Error error;
+    region_info.Clear();
+    const VMRangeToPermissions::Entry *entry = m_core_range_infos.FindEntryThatContains (load_addr);
+    if (entry)
+    {
+        region_info.GetRange().SetRangeBase (entry->GetRangeBase());
+        region_info.GetRange().SetByteSize (entry->GetByteSize());
+        region_info.SetReadable ((entry->data & llvm::ELF::PF_R) ? MemoryRegionInfo::eYes : MemoryRegionInfo::eNo);
+        region_info.SetWritable ((entry->data & llvm::ELF::PF_W) ? MemoryRegionInfo::eYes : MemoryRegionInfo::eNo);
+        region_info.SetExecutable ((entry->data & llvm::ELF::PF_X) ? MemoryRegionInfo::eYes : MemoryRegionInfo::eNo);
+        return error;
+    }
+
+    // Describe the unmapped gap up to the next segment.
+    addr_t gap_end = LLDB_INVALID_ADDRESS;
+    const size_t num_entries = m_core_range_infos.GetSize();
+    for (size_t i = 0; i < num_entries; ++i)
+    {
+        const VMRangeToPermissions::Entry *next_entry = m_core_range_infos.GetEntryAtIndex (i);
+        if (next_entry->GetRangeBase() > load_addr)
+        {
+            gap_end = next_entry->GetRangeBase();
+            break;
+        }
+    }
+    region_info.GetRange().SetRangeBase (load_addr);
+    region_info.GetRange().SetRangeEnd (gap_end);
+    region_info.SetReadable (MemoryRegionInfo::eNo);
+    region_info.SetWritable (MemoryRegionInfo::eNo);
+    region_info.SetExecutable (MemoryRegionInfo::eNo);
+    return error;
+}
+
+addr_t
+ProcessElfCore::DoAllocateMemory (size_t size, uint32_t permissions, Error &error)
+{
+    error.SetErrorString ("memory can't be allocated in a process loaded from a core file");
+    return LLDB_INVALID_ADDRESS;
+}
+
+Error
+ProcessElfCore::DoDeallocateMemory (lldb::addr_t addr)
+{
+    Error error;
+    error.SetErrorString ("memory can't be deallocated in a process loaded from a core file");
+    return error;
+}
+
+Error
+ProcessElfCore::EnableBreakpoint (BreakpointSite *bp_site)
+{
+    Error error;
+    error.SetErrorString ("breakpoints can't be set in a process loaded from a core file");
+    return error;
+}
+
+Error
+ProcessElfCore::DisableBreakpoint (BreakpointSite *bp_site)
+{
+    return Error();
+}
+
+void
+ProcessElfCore::Initialize()
+{
+    static bool g_initialized = false;
+
+    if (g_initialized == false)
+    {
+        g_initialized = true;
+        PluginManager::RegisterPlugin (GetPluginNameStatic(),
+                                       GetPluginDescriptionStatic(),
+                                       CreateInstance);
+    }
+}
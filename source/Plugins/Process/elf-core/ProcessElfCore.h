@@ -0,0 +1,194 @@
+//===-- ProcessElfCore.h ----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_ProcessElfCore_h_
+#define liblldb_ProcessElfCore_h_
+
+// C Includes
+// C++ Includes
+#include <vector>
+
+// Other libraries and framework includes
+#include "lldb/Core/DataBufferMemoryMap.h"
+#include "lldb/Core/RangeMap.h"
+#include "lldb/Target/Process.h"
+
+// Project includes
+#include "ThreadElfCore.h"
+
+namespace elf
+{
+struct ELFProgramHeader;
+}
+
+//----------------------------------------------------------------------
+/// @class ProcessElfCore ProcessElfCore.h
+/// @brief A process read from an ELF core file.
+///
+/// The core file is memory mapped once and never read in full, the
+/// kernel only brings in the pages that are actually looked at. Each
+/// PT_LOAD segment of the core file is entered in a table sorted by
+/// virtual address, so reading process memory is a binary search
+/// followed by a copy out of the mapping.
+//----------------------------------------------------------------------
+class ProcessElfCore : public lldb_private::Process
+{
+public:
+    //------------------------------------------------------------------
+    // Constructors and Destructors
+    //------------------------------------------------------------------
+    static lldb_private::Process*
+    CreateInstance (lldb_private::Target& target,
+                    lldb_private::Listener &listener);
+
+    static void
+    Initialize();
+
+    static void
+    Terminate();
+
+    static const char *
+    GetPluginNameStatic();
+
+    static const char *
+    GetPluginDescriptionStatic();
+
+    //------------------------------------------------------------------
+    // Constructors and Destructors
+    //------------------------------------------------------------------
+    ProcessElfCore(lldb_private::Target& target,
+                   lldb_private::Listener &listener);
+
+    virtual
+    ~ProcessElfCore();
+
+    //------------------------------------------------------------------
+    // Check if a given Process
+    //------------------------------------------------------------------
+    virtual bool
+    CanDebug (lldb_private::Target &target,
+              bool plugin_specified_by_name);
+
+    //------------------------------------------------------------------
+    // Creating a new process, or attaching to an existing one
+    //------------------------------------------------------------------
+    virtual lldb_private::Error
+    DoLoadCore (const lldb_private::FileSpec &core_file);
+
+    virtual lldb_private::Error
+    DoLaunch (lldb_private::Module *exe_module,
+              const lldb_private::ProcessLaunchInfo &launch_info);
+
+    virtual lldb_private::Error
+    DoAttachToProcessWithID (lldb::pid_t pid);
+
+    //------------------------------------------------------------------
+    // PluginInterface protocol
+    //------------------------------------------------------------------
+    virtual const char *
+    GetPluginName();
+
+    virtual const char *
+    GetShortPluginName();
+
+    virtual uint32_t
+    GetPluginVersion();
+
+    //------------------------------------------------------------------
+    // Process Control
+    //------------------------------------------------------------------
+    virtual lldb_private::Error
+    DoResume ();
+
+    virtual lldb_private::Error
+    DoHalt (bool &caused_stop);
+
+    virtual lldb_private::Error
+    DoDetach ();
+
+    virtual lldb_private::Error
+    DoSignal (int signal);
+
+    virtual lldb_private::Error
+    DoDestroy ();
+
+    virtual void
+    RefreshStateAfterStop();
+
+    //------------------------------------------------------------------
+    // Process Queries
+    //------------------------------------------------------------------
+    virtual bool
+    IsAlive ();
+
+    virtual lldb::DataBufferSP
+    GetAuxvData ();
+
+    //------------------------------------------------------------------
+    // Process Memory
+    //------------------------------------------------------------------
+    virtual size_t
+    DoReadMemory (lldb::addr_t addr, void *buf, size_t size, lldb_private::Error &error);
+
+    virtual size_t
+    DoWriteMemory (lldb::addr_t addr, const void *buf, size_t size, lldb_private::Error &error);
+
+    virtual lldb_private::Error
+    GetMemoryRegionInfo (lldb::addr_t load_addr,
+                         lldb_private::MemoryRegionInfo &region_info);
+
+    virtual lldb::addr_t
+    DoAllocateMemory (size_t size, uint32_t permissions, lldb_private::Error &error);
+
+    virtual lldb_private::Error
+    DoDeallocateMemory (lldb::addr_t ptr);
+
+    //----------------------------------------------------------------------
+    // Process Breakpoints
+    //----------------------------------------------------------------------
+    virtual lldb_private::Error
+    EnableBreakpoint (lldb_private::BreakpointSite *bp_site);
+
+    virtual lldb_private::Error
+    DisableBreakpoint (lldb_private::BreakpointSite *bp_site);
+
+protected:
+    void
+    Clear ( );
+
+    virtual uint32_t
+    UpdateThreadList (lldb_private::ThreadList &old_thread_list,
+                      lldb_private::ThreadList &new_thread_list);
+
+private:
+    //------------------------------------------------------------------
+    // For ProcessElfCore only
+    //------------------------------------------------------------------
+    typedef lldb_private::Range<lldb::addr_t, lldb::addr_t> FileRange;
+    typedef lldb_private::RangeDataArray<lldb::addr_t, lldb::addr_t, FileRange, 1> VMRangeToFileOffset;
+    typedef lldb_private::RangeDataArray<lldb::addr_t, lldb::addr_t, uint32_t, 1> VMRangeToPermissions;
+
+    lldb::DataBufferSP m_core_data_sp;          ///< The whole core file, memory mapped
+    std::vector<ThreadData> m_thread_data;      ///< Threads found in the NT_PRSTATUS notes
+    lldb_private::DataExtractor m_auxv;         ///< Contents of the NT_AUXV note
+    VMRangeToFileOffset m_core_aranges;         ///< PT_LOAD segments sorted by virtual address
+    VMRangeToPermissions m_core_range_infos;    ///< Permissions of the PT_LOAD segments
+
+    lldb_private::Error
+    ParseThreadContextsFromNoteSegment (const elf::ELFProgramHeader &segment_header,
+                                        lldb::ByteOrder byte_order,
+                                        uint32_t address_byte_size);
+
+    void
+    AddAddressRangeFromLoadSegment (const elf::ELFProgramHeader &segment_header);
+
+    DISALLOW_COPY_AND_ASSIGN (ProcessElfCore);
+};
+
+#endif  // liblldb_ProcessElfCore_h_
@@ -0,0 +1,101 @@
+//===-- RegisterContextCorePOSIX_x86_64.cpp ---------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include <stddef.h>
+#include <string.h>
+
+#include "lldb/Core/DataBufferHeap.h"
+#include "lldb/Core/RegisterValue.h"
+#include "lldb/Target/Thread.h"
+
+#include "RegisterContextCorePOSIX_x86_64.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+RegisterContextCorePOSIX_x86_64::RegisterContextCorePOSIX_x86_64(Thread &thread,
+                                                                 const DataExtractor &gpregset,
+                                                                 const DataExtractor &fpregset)
+    : RegisterContext_x86_64(thread, 0),
+      m_gpregset(gpregset),
+      m_fpregset(fpregset)
+{
+}
+
+RegisterContextCorePOSIX_x86_64::~RegisterContextCorePOSIX_x86_64()
+{
+}
+
+bool
+RegisterContextCorePOSIX_x86_64::ReadRegister(const RegisterInfo *reg_info,
+                                              RegisterValue &value)
+{
+    // The register offsets are relative to the user area, which starts
+    // with the general purpose registers and has the FPU area further in.
+    const uint32_t fpu_offset = offsetof(UserArea, i387);
+    uint32_t offset = reg_info->byte_offset;
+    if (offset + reg_info->byte_size <= sizeof(GPR))
+    {
+        if (offset + reg_info->byte_size > m_gpregset.GetByteSize())
+            return false;
+        return value.SetValueFromData(reg_info, m_gpregset, offset, false).Success();
+    }
+
+    if (offset < fpu_offset)
+        return false;
+    offset -= fpu_offset;
+    if (offset + reg_info->byte_size > m_fpregset.GetByteSize())
+        return false;
+    return value.SetValueFromData(reg_info, m_fpregset, offset, false).Success();
+}
+
+bool
+RegisterContextCorePOSIX_x86_64::ReadAllRegisterValues(DataBufferSP &data_sp)
+{
+    if (m_gpregset.GetByteSize() < sizeof(GPR) ||
+        m_fpregset.GetByteSize() < sizeof(FPU))
+        return false;
+
+    data_sp.reset (new DataBufferHeap (sizeof(GPR) + sizeof(FPU), 0));
+    uint8_t *dst = data_sp->GetBytes();
+    ::memcpy (dst, m_gpregset.GetDataStart(), sizeof(GPR));
+    ::memcpy (dst + sizeof(GPR), m_fpregset.GetDataStart(), sizeof(FPU));
+    return true;
+}
+
+bool
+RegisterContextCorePOSIX_x86_64::WriteRegister(const RegisterInfo *reg_info,
+                                               const RegisterValue &value)
+{
+    return false;
+}
+
+bool
+RegisterContextCorePOSIX_x86_64::WriteAllRegisterValues(const DataBufferSP &data_sp)
+{
+    return false;
+}
+
+bool
+RegisterContextCorePOSIX_x86_64::HardwareSingleStep(bool enable)
+{
+    return false;
+}
+
+bool
+RegisterContextCorePOSIX_x86_64::UpdateAfterBreakpoint()
+{
+    return false;
+}
+
+uint32_t
+RegisterContextCorePOSIX_x86_64::NumSupportedHardwareWatchpoints()
+{
+    return 0;
+}
@@ -0,0 +1,63 @@
+//===-- RegisterContextCorePOSIX_x86_64.h -----------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_RegisterContextCorePOSIX_x86_64_H_
+#define liblldb_RegisterContextCorePOSIX_x86_64_H_
+
+#include "lldb/Core/DataExtractor.h"
+
+#include "RegisterContext_x86_64.h"
+
+//------------------------------------------------------------------------------
+/// @class RegisterContextCorePOSIX_x86_64
+/// @brief Registers of a thread saved in an ELF core file.
+///
+/// The general purpose registers come from the NT_PRSTATUS note and the
+/// floating point registers from the NT_FPREGSET note, both are laid out
+/// like the GPR and FPU areas the live register context reads with ptrace.
+/// The registers of a core file can't be modified.
+class RegisterContextCorePOSIX_x86_64
+  : public RegisterContext_x86_64
+{
+public:
+    RegisterContextCorePOSIX_x86_64(lldb_private::Thread &thread,
+                                    const lldb_private::DataExtractor &gpregset,
+                                    const lldb_private::DataExtractor &fpregset);
+
+    ~RegisterContextCorePOSIX_x86_64();
+
+    virtual bool
+    ReadRegister(const lldb_private::RegisterInfo *reg_info,
+                 lldb_private::RegisterValue &value);
+
+    bool
+    ReadAllRegisterValues(lldb::DataBufferSP &data_sp);
+
+    virtual bool
+    WriteRegister(const lldb_private::RegisterInfo *reg_info,
+                  const lldb_private::RegisterValue &value);
+
+    bool
+    WriteAllRegisterValues(const lldb::DataBufferSP &data_sp);
+
+    bool
+    HardwareSingleStep(bool enable);
+
+    bool
+    UpdateAfterBreakpoint();
+
+    uint32_t
+    NumSupportedHardwareWatchpoints();
+
+private:
+    lldb_private::DataExtractor m_gpregset;
+    lldb_private::DataExtractor m_fpregset;
+};
+
+#endif // #ifndef liblldb_RegisterContextCorePOSIX_x86_64_H_
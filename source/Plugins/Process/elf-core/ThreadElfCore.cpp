@@ -0,0 +1,97 @@
+//===-- ThreadElfCore.cpp ---------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "ThreadElfCore.h"
+
+#include "lldb/Target/Process.h"
+#include "lldb/Target/RegisterContext.h"
+#include "lldb/Target/StackFrame.h"
+#include "lldb/Target/StopInfo.h"
+#include "lldb/Target/Target.h"
+#include "lldb/Target/Unwind.h"
+
+#include "RegisterContextCorePOSIX_x86_64.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+//----------------------------------------------------------------------
+// Construct a Thread object with given data
+//----------------------------------------------------------------------
+ThreadElfCore::ThreadElfCore (Process &process, const ThreadData &td) :
+    Thread(process, td.tid),
+    m_signo (td.signo),
+    m_gpregset (td.gpregset),
+    m_fpregset (td.fpregset)
+{
+}
+
+ThreadElfCore::~ThreadElfCore ()
+{
+    DestroyThread();
+}
+
+void
+ThreadElfCore::RefreshStateAfterStop()
+{
+    GetRegisterContext()->InvalidateIfNeeded (false);
+}
+
+void
+ThreadElfCore::ClearStackFrames ()
+{
+    Unwind *unwinder = GetUnwinder ();
+    if (unwinder)
+        unwinder->Clear();
+    Thread::ClearStackFrames();
+}
+
+RegisterContextSP
+ThreadElfCore::GetRegisterContext ()
+{
+    if (m_reg_context_sp.get() == NULL)
+        m_reg_context_sp = CreateRegisterContextForFrame (NULL);
+    return m_reg_context_sp;
+}
+
+RegisterContextSP
+ThreadElfCore::CreateRegisterContextForFrame (StackFrame *frame)
+{
+    RegisterContextSP reg_ctx_sp;
+    uint32_t concrete_frame_idx = 0;
+
+    if (frame)
+        concrete_frame_idx = frame->GetConcreteFrameIndex ();
+
+    if (concrete_frame_idx == 0)
+    {
+        // ProcessElfCore::DoLoadCore() only accepts x86_64 core files.
+        reg_ctx_sp.reset (new RegisterContextCorePOSIX_x86_64 (*this, m_gpregset, m_fpregset));
+    }
+    else if (GetUnwinder())
+        reg_ctx_sp = GetUnwinder()->CreateRegisterContextForFrame (frame);
+    return reg_ctx_sp;
+}
+
+StopInfoSP
+ThreadElfCore::GetPrivateStopReason ()
+{
+    const uint32_t process_stop_id = GetProcess().GetStopID();
+    if (m_thread_stop_reason_stop_id != process_stop_id ||
+        (m_actual_stop_info_sp && !m_actual_stop_info_sp->IsValid()))
+    {
+        // The threads of a core file never run again, the only reason
+        // they stopped for is the signal the kernel recorded.
+        if (m_signo != 0)
+            SetStopInfo (StopInfo::CreateStopReasonWithSignal (*this, m_signo));
+        else
+            SetStopInfo (StopInfoSP());
+    }
+    return m_actual_stop_info_sp;
+}
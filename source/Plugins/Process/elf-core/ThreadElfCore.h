@@ -0,0 +1,70 @@
+//===-- ThreadElfCore.h -----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef liblldb_ThreadElfCore_h_
+#define liblldb_ThreadElfCore_h_
+
+#include <string>
+
+#include "lldb/Core/DataExtractor.h"
+#include "lldb/Target/Thread.h"
+
+//----------------------------------------------------------------------
+// The state of one thread as recorded in the notes of an ELF core file.
+//----------------------------------------------------------------------
+struct ThreadData
+{
+    lldb::tid_t tid;
+    int signo;
+    lldb_private::DataExtractor gpregset;
+    lldb_private::DataExtractor fpregset;
+
+    ThreadData () :
+        tid (LLDB_INVALID_THREAD_ID),
+        signo (0),
+        gpregset (),
+        fpregset ()
+    {
+    }
+};
+
+class ThreadElfCore : public lldb_private::Thread
+{
+public:
+    ThreadElfCore (lldb_private::Process &process,
+                   const ThreadData &td);
+
+    virtual
+    ~ThreadElfCore ();
+
+    virtual void
+    RefreshStateAfterStop();
+
+    virtual lldb::RegisterContextSP
+    GetRegisterContext ();
+
+    virtual lldb::RegisterContextSP
+    CreateRegisterContextForFrame (lldb_private::StackFrame *frame);
+
+    virtual void
+    ClearStackFrames ();
+
+protected:
+    //------------------------------------------------------------------
+    // Member variables.
+    //------------------------------------------------------------------
+    int m_signo;
+    lldb_private::DataExtractor m_gpregset;
+    lldb_private::DataExtractor m_fpregset;
+
+    virtual lldb::StopInfoSP
+    GetPrivateStopReason ();
+};
+
+#endif  // liblldb_ThreadElfCore_h_
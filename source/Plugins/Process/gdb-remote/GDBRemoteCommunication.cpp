@@ -26,7 +26,12 @@
 // Project includes
 #include "ProcessGDBRemoteLog.h"
 
+#if defined (__linux__)
+// The Linux stub takes the same command line options as debugserver
+#define DEBUGSERVER_BASENAME    "lldb-gdbserver"
+#else
 #define DEBUGSERVER_BASENAME    "debugserver"
+#endif
 
 using namespace lldb;
 using namespace lldb_private;
@@ -43,7 +48,10 @@ GDBRemoteCommunication::GDBRemoteCommunication(const char *comm_name,
     m_public_is_running (false),
     m_private_is_running (false),
     m_send_acks (true),
-    m_is_platform (is_platform)
+    m_is_platform (is_platform),
+    m_send_compression_type (GDBRemoteEncoding::eCompressionNone),
+    m_recv_compression_type (GDBRemoteEncoding::eCompressionNone),
+    m_max_packet_size (0)
 {
 }
 
@@ -121,6 +129,16 @@ GDBRemoteCommunication::SendPacketNoLock (const char *payload, size_t payload_le
 {
     if (IsConnected())
     {
+        std::string compressed_payload;
+        if (m_send_compression_type != GDBRemoteEncoding::eCompressionNone)
+        {
+            GDBRemoteEncoding::CompressPayload (m_send_compression_type, 
+                                                std::string (payload, payload_length), 
+                                                compressed_payload);
+            payload = compressed_payload.data();
+            payload_length = compressed_payload.size();
+        }
+
         StreamString packet(0, 4, eByteOrderBig);
 
         packet.PutChar('$');
@@ -386,6 +404,26 @@ GDBRemoteCommunication::CheckForPacket (const uint8_t *src, size_t src_len, Stri
                         if (log)
                             log->Printf ("read packet: %.*s", (int)(total_length), m_bytes.c_str());
                     }
+                    if (success && m_recv_compression_type != GDBRemoteEncoding::eCompressionNone)
+                    {
+                        std::string decompressed_str;
+                        // Don't let a corrupt header make us allocate more
+                        // than a packet could hold
+                        success = GDBRemoteEncoding::DecompressPayload (m_recv_compression_type, 
+                                                                        packet_str, 
+                                                                        m_max_packet_size ? m_max_packet_size : eDefaultMaxPacketSize,
+                                                                        decompressed_str);
+                        if (success)
+                        {
+                            if (log && log->GetVerbose() && decompressed_str != packet_str)
+                                log->Printf ("decompressed packet: %s", decompressed_str.c_str());
+                            packet_str.swap (decompressed_str);
+                        }
+                        else if (log)
+                        {
+                            log->Printf ("error: failed to decompress packet: %.*s", (int)(total_length), m_bytes.c_str());
+                        }
+                    }
                 }
                 else
                 {
@@ -24,6 +24,7 @@
 #include "lldb/Host/Predicate.h"
 #include "lldb/Host/TimeValue.h"
 
+#include "Utility/GDBRemoteEncoding.h"
 #include "Utility/StringExtractorGDBRemote.h"
 
 class ProcessGDBRemote;
@@ -35,6 +36,11 @@ public:
     {
         eBroadcastBitRunPacketSent = kLoUserBroadcastBit
     };
+
+    enum
+    {
+        eDefaultMaxPacketSize = 0x20000     // When the other end doesn't tell us its "PacketSize"
+    };
     //------------------------------------------------------------------
     // Constructors and Destructors
     //------------------------------------------------------------------
@@ -154,6 +160,9 @@ protected:
     bool m_is_platform; // Set to true if this class represents a platform,
                         // false if this class represents a debug session for
                         // a single process
+    GDBRemoteEncoding::CompressionType m_send_compression_type; // How we compress the packets we send
+    GDBRemoteEncoding::CompressionType m_recv_compression_type; // How the packets we receive are compressed
+    size_t m_max_packet_size;   // The "PacketSize" the other end told us about, zero if it didn't
     
 
 
@@ -31,6 +31,11 @@
 using namespace lldb;
 using namespace lldb_private;
 
+enum
+{
+    eMaxOutstandingPackets = 16     // Packets sent before we wait for a response when pipelining
+};
+
 //----------------------------------------------------------------------
 // GDBRemoteCommunicationClient constructor
 //----------------------------------------------------------------------
@@ -47,16 +52,21 @@ GDBRemoteCommunicationClient::GDBRemoteCommunicationClient(bool is_platform) :
     m_qHostInfo_is_valid (eLazyBoolCalculate),
     m_supports_alloc_dealloc_memory (eLazyBoolCalculate),
     m_supports_memory_region_info  (eLazyBoolCalculate),
+    m_qSupported_is_valid (eLazyBoolCalculate),
     m_supports_qProcessInfoPID (true),
     m_supports_qfProcessInfo (true),
     m_supports_qUserName (true),
     m_supports_qGroupName (true),
     m_supports_qThreadStopInfo (true),
+    m_supports_qThreadStopSnapshot (true),
     m_supports_z0 (true),
     m_supports_z1 (true),
     m_supports_z2 (true),
     m_supports_z3 (true),
     m_supports_z4 (true),
+    m_supports_binary_memory (false),
+    m_supports_pipelining (false),
+    m_supported_compression_mask (0),
     m_curr_tid (LLDB_INVALID_THREAD_ID),
     m_curr_tid_run (LLDB_INVALID_THREAD_ID),
     m_async_mutex (Mutex::eMutexTypeRecursive),
@@ -113,6 +123,127 @@ GDBRemoteCommunicationClient::QueryNoAckModeSupported ()
     }
 }
 
+void
+GDBRemoteCommunicationClient::GetRemoteQSupported ()
+{
+    if (m_qSupported_is_valid == eLazyBoolCalculate)
+    {
+        m_qSupported_is_valid = eLazyBoolNo;
+        m_supports_binary_memory = false;
+        m_supports_pipelining = false;
+        m_supported_compression_mask = 0;
+        m_max_packet_size = 0;
+
+        StreamString packet;
+        packet.Printf ("qSupported:binary-memory+;pipelining+;compression=%s", GDBRemoteEncoding::GetSupportedCompressionNames());
+        StringExtractorGDBRemote response;
+        if (SendPacketAndWaitForResponse (packet.GetData(), packet.GetSize(), response, false))
+        {
+            if (response.IsNormalResponse())
+            {
+                m_qSupported_is_valid = eLazyBoolYes;
+                // The response is "name=value", "name+" and "name-"
+                // features separated by semicolons
+                const std::string &features = response.GetStringRef();
+                size_t pos = 0;
+                while (pos < features.size())
+                {
+                    size_t end = features.find (';', pos);
+                    if (end == std::string::npos)
+                        end = features.size();
+                    const std::string feature (features, pos, end - pos);
+                    pos = end + 1;
+
+                    if (feature.compare ("binary-memory+") == 0)
+                    {
+                        m_supports_binary_memory = true;
+                    }
+                    else if (feature.compare ("pipelining+") == 0)
+                    {
+                        m_supports_pipelining = true;
+                    }
+                    else if (feature.compare (0, 11, "PacketSize=") == 0)
+                    {
+                        // The size is in hex
+                        m_max_packet_size = ::strtoul (feature.c_str() + 11, NULL, 16);
+                    }
+                    else if (feature.compare (0, 12, "compression=") == 0)
+                    {
+                        size_t name_pos = 12;
+                        while (name_pos < feature.size())
+                        {
+                            size_t name_end = feature.find (',', name_pos);
+                            if (name_end == std::string::npos)
+                                name_end = feature.size();
+                            GDBRemoteEncoding::CompressionType type;
+                            if (GDBRemoteEncoding::GetCompressionType (feature.c_str() + name_pos, name_end - name_pos, type))
+                                m_supported_compression_mask |= (1u << type);
+                            name_pos = name_end + 1;
+                        }
+                    }
+                }
+            }
+        }
+    }
+}
+
+bool
+GDBRemoteCommunicationClient::GetBinaryMemorySupported ()
+{
+    if (m_qSupported_is_valid == eLazyBoolCalculate)
+        GetRemoteQSupported ();
+    return m_supports_binary_memory;
+}
+
+size_t
+GDBRemoteCommunicationClient::GetRemoteMaxPacketSize ()
+{
+    if (m_qSupported_is_valid == eLazyBoolCalculate)
+        GetRemoteQSupported ();
+    return m_max_packet_size;
+}
+
+bool
+GDBRemoteCommunicationClient::GetPipeliningSupported ()
+{
+    if (m_qSupported_is_valid == eLazyBoolCalculate)
+        GetRemoteQSupported ();
+    return m_supports_pipelining && !GetSendAcks();
+}
+
+bool
+GDBRemoteCommunicationClient::GetCompressionSupported (GDBRemoteEncoding::CompressionType type)
+{
+    if (type == GDBRemoteEncoding::eCompressionNone)
+        return true;
+    if (m_qSupported_is_valid == eLazyBoolCalculate)
+        GetRemoteQSupported ();
+    return (m_supported_compression_mask & (1u << type)) != 0;
+}
+
+bool
+GDBRemoteCommunicationClient::EnableCompression (GDBRemoteEncoding::CompressionType type)
+{
+    if (type == m_recv_compression_type)
+        return true;
+    if (!GetCompressionSupported (type))
+        return false;
+
+    StreamString packet;
+    packet.Printf ("QEnableCompression:type:%s;", GDBRemoteEncoding::GetCompressionName (type));
+    StringExtractorGDBRemote response;
+    if (SendPacketAndWaitForResponse (packet.GetData(), packet.GetSize(), response, false))
+    {
+        // The server compresses everything it sends after its reply
+        if (response.IsOKResponse())
+        {
+            m_recv_compression_type = type;
+            return true;
+        }
+    }
+    return false;
+}
+
 void
 GDBRemoteCommunicationClient::ResetDiscoverableSettings()
 {
@@ -125,17 +256,24 @@ GDBRemoteCommunicationClient::ResetDiscoverableSettings()
     m_qHostInfo_is_valid = eLazyBoolCalculate;
     m_supports_alloc_dealloc_memory = eLazyBoolCalculate;
     m_supports_memory_region_info = eLazyBoolCalculate;
+    m_qSupported_is_valid = eLazyBoolCalculate;
+    m_recv_compression_type = GDBRemoteEncoding::eCompressionNone;
 
     m_supports_qProcessInfoPID = true;
     m_supports_qfProcessInfo = true;
     m_supports_qUserName = true;
     m_supports_qGroupName = true;
     m_supports_qThreadStopInfo = true;
+    m_supports_qThreadStopSnapshot = true;
     m_supports_z0 = true;
     m_supports_z1 = true;
     m_supports_z2 = true;
     m_supports_z3 = true;
     m_supports_z4 = true;
+    m_supports_binary_memory = false;
+    m_supports_pipelining = false;
+    m_supported_compression_mask = 0;
+    m_max_packet_size = 0;
     m_host_arch.Clear();
 }
 
@@ -334,6 +472,70 @@ GDBRemoteCommunicationClient::SendPacketAndWaitForResponse
     return response_len;
 }
 
+size_t
+GDBRemoteCommunicationClient::SendPacketsAndWaitForResponses (const std::vector<std::string> &packets,
+                                                              std::vector<StringExtractorGDBRemote> &responses)
+{
+    LogSP log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_PROCESS));
+    responses.clear();
+    if (packets.empty())
+        return 0;
+
+    // Keep few enough packets in flight that neither side can fill up its
+    // socket buffers while the other one is still sending
+    const size_t max_outstanding = GetPipeliningSupported() ? eMaxOutstandingPackets : 1;
+
+    Mutex::Locker locker;
+    if (!GetSequenceMutex (locker))
+    {
+        if (log)
+            log->Printf("error: packet mutex taken, not sending %llu packets starting with '%s'", 
+                        (uint64_t)packets.size(), 
+                        packets[0].c_str());
+        return 0;
+    }
+
+    const size_t num_packets = packets.size();
+    responses.resize (num_packets);
+    size_t num_sent = 0;
+    size_t num_received = 0;
+    while (num_received < num_packets)
+    {
+        while (num_sent < num_packets && num_sent - num_received < max_outstanding)
+        {
+            if (!SendPacketNoLock (packets[num_sent].data(), packets[num_sent].size()))
+            {
+                if (log)
+                    log->Printf("error: failed to send '%s'", packets[num_sent].c_str());
+                break;
+            }
+            ++num_sent;
+        }
+
+        if (num_received == num_sent ||
+            WaitForPacketWithTimeoutMicroSecondsNoLock (responses[num_received], GetPacketTimeoutInMicroSeconds ()) == 0)
+            break;
+        ++num_received;
+    }
+
+    if (num_received < num_sent)
+    {
+        if (log)
+            log->Printf("error: failed to get response for '%s'", packets[num_received].c_str());
+
+        // Responses still on their way would otherwise be taken for the
+        // responses to the next packets we send
+        StringExtractorGDBRemote discarded_response;
+        for (size_t i = num_received + 1; i < num_sent; ++i)
+        {
+            if (WaitForPacketWithTimeoutMicroSecondsNoLock (discarded_response, GetPacketTimeoutInMicroSeconds ()) == 0)
+                break;
+        }
+    }
+    responses.resize (num_received);
+    return num_received;
+}
+
 //template<typename _Tp>
 //class ScopedValueChanger
 //{
@@ -1570,6 +1772,7 @@ GDBRemoteCommunicationClient::TestPacketSpeed (const uint32_t num_packets)
             if (send_size == 0)
                 send_size = 32;
         }
+        TestTransferSpeed (num_packets / 10);
     }
     else
     {
@@ -1589,11 +1792,56 @@ GDBRemoteCommunicationClient::TestPacketSpeed (const uint32_t num_packets)
     }
 }
 
+void
+GDBRemoteCommunicationClient::TestTransferSpeed (const uint32_t num_packets)
+{
+    static const char *g_encodings[] = { "hex", "binary" };
+    static const GDBRemoteEncoding::CompressionType g_compressions[] = 
+    {
+        GDBRemoteEncoding::eCompressionNone,
+        GDBRemoteEncoding::eCompressionRLE,
+        GDBRemoteEncoding::eCompressionLZSS
+    };
+
+    const GDBRemoteEncoding::CompressionType orig_compression = GetCompressionType();
+    for (size_t c = 0; c < sizeof(g_compressions)/sizeof(g_compressions[0]); ++c)
+    {
+        if (!EnableCompression (g_compressions[c]))
+            continue;
+        for (size_t e = 0; e < sizeof(g_encodings)/sizeof(g_encodings[0]); ++e)
+        {
+            if (!SendSpeedTestPacket (0, 32, g_encodings[e]))
+                continue;
+            for (uint32_t recv_size = 512; recv_size <= 16384; recv_size *= 4)
+            {
+                const TimeValue start_time (TimeValue::Now());
+                for (uint32_t i = 0; i < num_packets; ++i)
+                    SendSpeedTestPacket (0, recv_size, g_encodings[e]);
+                const TimeValue end_time (TimeValue::Now());
+                const uint64_t total_time_nsec = end_time.GetAsNanoSecondsSinceJan1_1970() - start_time.GetAsNanoSecondsSinceJan1_1970();
+                const float bytes_per_second = (((float)num_packets * recv_size)/(float)total_time_nsec) * (float)TimeValue::NanoSecPerSec;
+                printf ("%u qSpeedTest(recv=%-5u, encoding=%-6s, compression=%-4s) in %llu.%9.9llu sec for %f KB/sec.\n", 
+                        num_packets, 
+                        recv_size,
+                        g_encodings[e],
+                        GDBRemoteEncoding::GetCompressionName (g_compressions[c]),
+                        total_time_nsec / TimeValue::NanoSecPerSec,
+                        total_time_nsec % TimeValue::NanoSecPerSec, 
+                        bytes_per_second / 1024.0f);
+            }
+        }
+    }
+    EnableCompression (orig_compression);
+}
+
 bool
-GDBRemoteCommunicationClient::SendSpeedTestPacket (uint32_t send_size, uint32_t recv_size)
+GDBRemoteCommunicationClient::SendSpeedTestPacket (uint32_t send_size, uint32_t recv_size, const char *encoding)
 {
     StreamString packet;
-    packet.Printf ("qSpeedTest:response_size:%i;data:", recv_size);
+    packet.Printf ("qSpeedTest:response_size:%i;", recv_size);
+    if (encoding)
+        packet.Printf ("encoding:%s;", encoding);
+    packet.PutCString ("data:");
     uint32_t bytes_left = send_size;
     while (bytes_left > 0)
     {
@@ -1610,8 +1858,13 @@ GDBRemoteCommunicationClient::SendSpeedTestPacket (uint32_t send_size, uint32_t
     }
 
     StringExtractorGDBRemote response;
-    return SendPacketAndWaitForResponse (packet.GetData(), packet.GetSize(), response, false) > 0;
-    return false;
+    if (SendPacketAndWaitForResponse (packet.GetData(), packet.GetSize(), response, false) == 0)
+        return false;
+    // Servers that know about encodings say which one they used, older
+    // ones ignore it and send text
+    if (encoding && recv_size > 0)
+        return response.GetStringRef().compare (0, 9, "encoding:") == 0;
+    return true;
 }
 
 uint16_t
@@ -1720,6 +1973,38 @@ GDBRemoteCommunicationClient::GetThreadStopInfo (uint32_t tid, StringExtractorGD
     return false;
 }
 
+bool
+GDBRemoteCommunicationClient::GetThreadStopSnapshot (uint32_t stack_byte_size,
+                                                     StringExtractorGDBRemote &response,
+                                                     bool &sequence_mutex_unavailable)
+{
+    sequence_mutex_unavailable = false;
+    if (!m_supports_qThreadStopSnapshot)
+        return false;
+
+    // Take the sequence mutex the way GetCurrentThreadIDs() does, so we
+    // can tell a busy connection from a server without the packet
+    Mutex::Locker locker;
+    if (!GetSequenceMutex (locker))
+    {
+        sequence_mutex_unavailable = true;
+        return false;
+    }
+
+    char packet[64];
+    const int packet_len = ::snprintf (packet, sizeof(packet), "qThreadStopSnapshot:stack:%x;", stack_byte_size);
+    assert (packet_len < sizeof(packet));
+    if (SendPacketNoLock (packet, packet_len) &&
+        WaitForPacketWithTimeoutMicroSecondsNoLock (response, GetPacketTimeoutInMicroSeconds ()))
+    {
+        if (response.IsUnsupportedResponse())
+            m_supports_qThreadStopSnapshot = false;
+        else if (response.IsNormalResponse())
+            return true;
+    }
+    return false;
+}
+
 
 uint8_t
 GDBRemoteCommunicationClient::SendGDBStoppointTypePacket (GDBStoppointType type, bool insert,  addr_t addr, uint32_t length)
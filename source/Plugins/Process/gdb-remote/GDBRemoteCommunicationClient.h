@@ -59,6 +59,22 @@ public:
                                   StringExtractorGDBRemote &response,
                                   bool send_async);
 
+    //------------------------------------------------------------------
+    // Send packets that don't depend on each other's responses, like
+    // memory and register reads, and get their responses in the same
+    // order. Servers that support it get several packets back to back
+    // before we wait for the first response, so the round trips overlap;
+    // other servers get one packet at a time.
+    //
+    // Returns the number of responses received, which stops short of the
+    // number of packets if one of them gets no response. Nothing is sent
+    // if another thread is using the connection, for instance because
+    // the process is running.
+    //------------------------------------------------------------------
+    size_t
+    SendPacketsAndWaitForResponses (const std::vector<std::string> &packets,
+                                    std::vector<StringExtractorGDBRemote> &responses);
+
     lldb::StateType
     SendContinuePacketAndWaitForResponse (ProcessGDBRemote *process,
                                           const char *packet_payload,
@@ -71,6 +87,43 @@ public:
     void
     QueryNoAckModeSupported ();
 
+    //------------------------------------------------------------------
+    // Ask the server which optional features it supports with the
+    // "qSupported" packet.
+    //------------------------------------------------------------------
+    void
+    GetRemoteQSupported ();
+
+    // The server can transfer memory as escaped binary data with the 'x'
+    // and 'X' packets, instead of as hex with the 'm' and 'M' packets.
+    bool
+    GetBinaryMemorySupported ();
+
+    // The largest packet the server can handle, from the "PacketSize"
+    // feature of its "qSupported" response, or zero if it didn't say.
+    size_t
+    GetRemoteMaxPacketSize ();
+
+    // The server handles packets sent before it responded to the previous
+    // ones. We only use this without acks, since a packet that had to be
+    // sent again would be answered out of order.
+    bool
+    GetPipeliningSupported ();
+
+    bool
+    GetCompressionSupported (GDBRemoteEncoding::CompressionType type);
+
+    // Ask the server to compress the packets it sends us, or to stop
+    // compressing them with eCompressionNone.
+    bool
+    EnableCompression (GDBRemoteEncoding::CompressionType type);
+
+    GDBRemoteEncoding::CompressionType
+    GetCompressionType () const
+    {
+        return m_recv_compression_type;
+    }
+
     bool
     SendAsyncSignal (int signo);
 
@@ -274,6 +327,16 @@ public:
     GetThreadStopInfo (uint32_t tid, 
                        StringExtractorGDBRemote &response);
 
+    // Get the stop info of every thread in one packet. Each thread's info
+    // is a stop reply packet with the expedited registers, the thread
+    // name sent as "hexname", and "memory:<addr>=<hex bytes>;" with
+    // "stack_byte_size" bytes of memory from its stack pointer up. The
+    // replies for each thread are separated by '|'.
+    bool
+    GetThreadStopSnapshot (uint32_t stack_byte_size,
+                           StringExtractorGDBRemote &response,
+                           bool &sequence_mutex_unavailable);
+
     bool
     SupportsGDBStoppointPacket (GDBStoppointType type)
     {
@@ -297,14 +360,22 @@ public:
     void
     TestPacketSpeed (const uint32_t num_packets);
 
+    // Time bulk transfers like those of memory reads in each encoding
+    // and compression the server supports.
+    void
+    TestTransferSpeed (const uint32_t num_packets);
+
     // This packet is for testing the speed of the interface only. Both
     // the client and server need to support it, but this allows us to
     // measure the packet speed without any other work being done on the
     // other end and avoids any of that work affecting the packet send
-    // and response times.
+    // and response times. If "encoding" is "hex" or "binary", the server
+    // responds with "recv_size" bytes of memory-like data in that
+    // encoding.
     bool
     SendSpeedTestPacket (uint32_t send_size, 
-                         uint32_t recv_size);
+                         uint32_t recv_size,
+                         const char *encoding = NULL);
     
     bool
     SetCurrentThread (int tid);
@@ -338,6 +409,7 @@ protected:
     lldb_private::LazyBool m_qHostInfo_is_valid;
     lldb_private::LazyBool m_supports_alloc_dealloc_memory;
     lldb_private::LazyBool m_supports_memory_region_info;
+    lldb_private::LazyBool m_qSupported_is_valid;
 
     bool
         m_supports_qProcessInfoPID:1,
@@ -345,11 +417,15 @@ protected:
         m_supports_qUserName:1,
         m_supports_qGroupName:1,
         m_supports_qThreadStopInfo:1,
+        m_supports_qThreadStopSnapshot:1,
         m_supports_z0:1,
         m_supports_z1:1,
         m_supports_z2:1,
         m_supports_z3:1,
-        m_supports_z4:1;
+        m_supports_z4:1,
+        m_supports_binary_memory:1,
+        m_supports_pipelining:1;
+    uint32_t m_supported_compression_mask; // Bit N is set if the server supports CompressionType N
     
 
     lldb::tid_t m_curr_tid;         // Current gdb remote protocol thread index for all other operations
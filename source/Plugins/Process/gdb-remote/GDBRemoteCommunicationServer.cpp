@@ -11,7 +11,11 @@
 #include "GDBRemoteCommunicationServer.h"
 
 // C Includes
+#include <stdlib.h>
+
 // C++ Includes
+#include <vector>
+
 // Other libraries and framework includes
 #include "llvm/ADT/Triple.h"
 #include "lldb/Interpreter/Args.h"
@@ -28,10 +32,25 @@
 #include "Utility/StringExtractorGDBRemote.h"
 #include "ProcessGDBRemote.h"
 #include "ProcessGDBRemoteLog.h"
+#if defined (__linux__)
+#include "NativeProcessLinux.h"
+#endif
 
 using namespace lldb;
 using namespace lldb_private;
 
+// The largest packet we accept, we tell the client in our reply to
+// "qSupported".
+static const size_t k_max_packet_size = 0x20000;
+
+// The most memory a memory read or write packet may ask for. The data takes
+// up to two characters per byte, and the address and length take up the
+// rest of the packet.
+static const size_t k_max_memory_packet_bytes = (k_max_packet_size - 32) / 2;
+
+// The most stack memory "qThreadStopSnapshot" sends for each thread
+static const uint32_t k_max_snapshot_stack_bytes = 4096;
+
 //----------------------------------------------------------------------
 // GDBRemoteCommunicationServer constructor
 //----------------------------------------------------------------------
@@ -43,7 +62,13 @@ GDBRemoteCommunicationServer::GDBRemoteCommunicationServer(bool is_platform) :
     m_proc_infos (),
     m_proc_infos_index (0),
     m_lo_port_num (0),
-    m_hi_port_num (0)
+    m_hi_port_num (0),
+    m_client_supports_binary_memory (false)
+#if defined (__linux__)
+    , m_native_process_ap ()
+    , m_current_tid (LLDB_INVALID_THREAD_ID)
+    , m_continue_tid (LLDB_INVALID_THREAD_ID)
+#endif
 {
 }
 
@@ -100,6 +125,12 @@ GDBRemoteCommunicationServer::GetPacketAndSendResponse (uint32_t timeout_usec,
                 break;
 
             case StringExtractorGDBRemote::eServerPacketType_interrupt:
+#if defined (__linux__)
+                // Interrupts for a running process are handled while waiting
+                // for it to stop, this one arrived too late to matter.
+                if (m_native_process_ap.get())
+                    break;
+#endif
                 error.SetErrorString("interrupt received");
                 interrupt = true;
                 break;
@@ -137,6 +168,12 @@ GDBRemoteCommunicationServer::GetPacketAndSendResponse (uint32_t timeout_usec,
             case StringExtractorGDBRemote::eServerPacketType_qSpeedTest:
                 return Handle_qSpeedTest (packet);
 
+            case StringExtractorGDBRemote::eServerPacketType_qSupported:
+                return Handle_qSupported (packet);
+
+            case StringExtractorGDBRemote::eServerPacketType_QEnableCompression:
+                return Handle_QEnableCompression (packet);
+
             case StringExtractorGDBRemote::eServerPacketType_qUserName:
                 return Handle_qUserName (packet);
 
@@ -160,6 +197,93 @@ GDBRemoteCommunicationServer::GetPacketAndSendResponse (uint32_t timeout_usec,
 
             case StringExtractorGDBRemote::eServerPacketType_QStartNoAckMode:
                 return Handle_QStartNoAckMode (packet);
+
+#if defined (__linux__)
+            case StringExtractorGDBRemote::eServerPacketType_QThreadSuffixSupported:
+                return Handle_QThreadSuffixSupported (packet);
+
+            case StringExtractorGDBRemote::eServerPacketType_qfThreadInfo:
+                return Handle_qfThreadInfo (packet);
+
+            case StringExtractorGDBRemote::eServerPacketType_qsThreadInfo:
+                return Handle_qsThreadInfo (packet);
+
+            case StringExtractorGDBRemote::eServerPacketType_qRegisterInfo:
+                return Handle_qRegisterInfo (packet);
+
+            case StringExtractorGDBRemote::eServerPacketType_qThreadStopInfo:
+                return Handle_qThreadStopInfo (packet);
+
+            case StringExtractorGDBRemote::eServerPacketType_qThreadStopSnapshot:
+                return Handle_qThreadStopSnapshot (packet);
+
+            case StringExtractorGDBRemote::eServerPacketType_stop_reason:
+                return Handle_stop_reason (packet);
+
+            case StringExtractorGDBRemote::eServerPacketType_c:
+            case StringExtractorGDBRemote::eServerPacketType_C:
+                return Handle_c (packet);
+
+            case StringExtractorGDBRemote::eServerPacketType_s:
+            case StringExtractorGDBRemote::eServerPacketType_S:
+                return Handle_s (packet);
+
+            case StringExtractorGDBRemote::eServerPacketType_vCont_actions:
+                return Handle_vCont_actions (packet);
+
+            case StringExtractorGDBRemote::eServerPacketType_vCont:
+                return Handle_vCont (packet);
+
+            case StringExtractorGDBRemote::eServerPacketType_vAttach:
+                return Handle_vAttach (packet);
+
+            case StringExtractorGDBRemote::eServerPacketType_m:
+                return Handle_m (packet);
+
+            case StringExtractorGDBRemote::eServerPacketType_M:
+                return Handle_M (packet);
+
+            case StringExtractorGDBRemote::eServerPacketType_x:
+                return Handle_x (packet);
+
+            case StringExtractorGDBRemote::eServerPacketType_X:
+                return Handle_X (packet);
+
+            case StringExtractorGDBRemote::eServerPacketType_p:
+                return Handle_p (packet);
+
+            case StringExtractorGDBRemote::eServerPacketType_P:
+                return Handle_P (packet);
+
+            case StringExtractorGDBRemote::eServerPacketType_g:
+                return Handle_g (packet);
+
+            case StringExtractorGDBRemote::eServerPacketType_G:
+                return Handle_G (packet);
+
+            case StringExtractorGDBRemote::eServerPacketType_Z:
+            case StringExtractorGDBRemote::eServerPacketType_z:
+                return Handle_Z (packet);
+
+            case StringExtractorGDBRemote::eServerPacketType_H:
+                return Handle_H (packet);
+
+            case StringExtractorGDBRemote::eServerPacketType_T:
+                return Handle_T (packet);
+
+            case StringExtractorGDBRemote::eServerPacketType_k:
+                // A platform keeps serving other clients after a kill.
+                if (!m_is_platform)
+                    quit = true;
+                return Handle_k (packet);
+
+            case StringExtractorGDBRemote::eServerPacketType_D:
+                quit = true;
+                return Handle_D (packet);
+#endif
+
+            default:
+                return SendUnimplementedResponse (packet.GetStringRef().c_str()) > 0;
         }
         return true;
     }
@@ -482,6 +606,37 @@ GDBRemoteCommunicationServer::Handle_qSpeedTest (StringExtractorGDBRemote &packe
         {
             if (response_size == 0)
                 return SendOKResponse();
+
+            // Bulk data encoded like a memory read. The bytes look like an
+            // array of small 64 bit integers, so they compress about as
+            // well as typical stack and heap memory.
+            const uint32_t pre_encoding_pos = packet.GetFilePos();
+            if (packet.GetNameColonValue(key, value) && key.compare("encoding") == 0)
+            {
+                const bool binary = value.compare("binary") == 0;
+                if (!binary && value.compare("hex") != 0)
+                    return SendErrorResponse (8);
+
+                std::vector<uint8_t> data (response_size);
+                for (uint32_t i = 0; i < response_size; ++i)
+                    data[i] = (i % 8) < 3 ? (uint8_t)((i / 8) * 41 + i) : 0;
+
+                StreamString response;
+                response.Printf ("encoding:%s;data:", value.c_str());
+                if (binary)
+                {
+                    std::string escaped_bytes ("b");
+                    GDBRemoteEncoding::AppendEscapedBytes (escaped_bytes, &data[0], data.size());
+                    response.Write (escaped_bytes.data(), escaped_bytes.size());
+                }
+                else
+                {
+                    response.PutBytesAsRawHex8 (&data[0], data.size());
+                }
+                return SendPacket (response);
+            }
+            packet.SetFilePos(pre_encoding_pos);
+
             StreamString response;
             uint32_t bytes_left = response_size;
             response.PutCString("data:");
@@ -627,6 +782,18 @@ GDBRemoteCommunicationServer::Handle_A (StringExtractorGDBRemote &packet)
     if (success)
     {
         m_process_launch_info.GetFlags().Set (eLaunchFlagDebug);
+#if defined (__linux__)
+        if (!m_is_platform)
+        {
+            // Launch the process and debug it ourselves
+            m_native_process_ap.reset (new NativeProcessLinux());
+            m_process_launch_error = m_native_process_ap->Launch (m_process_launch_info);
+            if (m_process_launch_error.Success())
+                return SendOKResponse ();
+            m_native_process_ap.reset();
+            return SendErrorResponse (8);
+        }
+#endif
         m_process_launch_error = Host::LaunchProcess (m_process_launch_info);
         if (m_process_launch_info.GetProcessID() != LLDB_INVALID_PROCESS_ID)
         {
@@ -640,6 +807,10 @@ bool
 GDBRemoteCommunicationServer::Handle_qC (StringExtractorGDBRemote &packet)
 {
     lldb::pid_t pid = m_process_launch_info.GetProcessID();
+#if defined (__linux__)
+    if (m_native_process_ap.get())
+        pid = m_native_process_ap->GetID();
+#endif
     StreamString response;
     response.Printf("QC%llx", pid);
     if (m_is_platform)
@@ -824,6 +995,55 @@ GDBRemoteCommunicationServer::Handle_QSetSTDERR (StringExtractorGDBRemote &packe
     return SendErrorResponse (12);
 }
 
+bool
+GDBRemoteCommunicationServer::Handle_qSupported (StringExtractorGDBRemote &packet)
+{
+    // Most features the client asks for with other packets. The one we
+    // need to know about up front is whether it takes binary memory in
+    // our replies. Packets that arrive while we handle one are buffered,
+    // so the client can send several before waiting for our responses.
+    m_client_supports_binary_memory = false;
+    const std::string &packet_str = packet.GetStringRef();
+    size_t pos = packet_str.find (':');
+    while (pos != std::string::npos)
+    {
+        ++pos;
+        size_t end = packet_str.find (';', pos);
+        if (packet_str.compare (pos, end == std::string::npos ? std::string::npos : end - pos, "binary-memory+") == 0)
+            m_client_supports_binary_memory = true;
+        pos = end;
+    }
+
+    StreamString response;
+    response.Printf ("PacketSize=%llx;pipelining+;compression=%s", (uint64_t)k_max_packet_size, GDBRemoteEncoding::GetSupportedCompressionNames());
+#if defined (__linux__)
+    if (!m_is_platform)
+        response.PutCString (";binary-memory+");
+#endif
+    return SendPacket (response);
+}
+
+bool
+GDBRemoteCommunicationServer::Handle_QEnableCompression (StringExtractorGDBRemote &packet)
+{
+    // Packet format: "QEnableCompression:type:<name>;"
+    packet.SetFilePos(::strlen ("QEnableCompression:"));
+    std::string key;
+    std::string value;
+    if (packet.GetNameColonValue(key, value) && key.compare("type") == 0)
+    {
+        GDBRemoteEncoding::CompressionType type;
+        if (GDBRemoteEncoding::GetCompressionType (value.c_str(), value.size(), type))
+        {
+            // The reply still goes out the way the client expects it
+            SendOKResponse ();
+            m_send_compression_type = type;
+            return true;
+        }
+    }
+    return SendErrorResponse (9);
+}
+
 bool
 GDBRemoteCommunicationServer::Handle_QStartNoAckMode (StringExtractorGDBRemote &packet)
 {
@@ -832,3 +1052,779 @@ GDBRemoteCommunicationServer::Handle_QStartNoAckMode (StringExtractorGDBRemote &
     m_send_acks = false;
     return true;
 }
+
+#if defined (__linux__)
+
+static const char *
+GetEncodingName (Encoding encoding)
+{
+    switch (encoding)
+    {
+    case eEncodingUint:     return "uint";
+    case eEncodingSint:     return "sint";
+    case eEncodingIEEE754:  return "ieee754";
+    case eEncodingVector:   return "vector";
+    default:                break;
+    }
+    return NULL;
+}
+
+static const char *
+GetFormatName (Format format)
+{
+    switch (format)
+    {
+    case eFormatBinary:             return "binary";
+    case eFormatDecimal:            return "decimal";
+    case eFormatHex:                return "hex";
+    case eFormatFloat:              return "float";
+    case eFormatVectorOfSInt8:      return "vector-sint8";
+    case eFormatVectorOfUInt8:      return "vector-uint8";
+    case eFormatVectorOfSInt16:     return "vector-sint16";
+    case eFormatVectorOfUInt16:     return "vector-uint16";
+    case eFormatVectorOfSInt32:     return "vector-sint32";
+    case eFormatVectorOfUInt32:     return "vector-uint32";
+    case eFormatVectorOfFloat32:    return "vector-float32";
+    case eFormatVectorOfUInt128:    return "vector-uint128";
+    default:                        break;
+    }
+    return NULL;
+}
+
+static const char *
+GetGenericRegisterName (uint32_t generic_reg)
+{
+    switch (generic_reg)
+    {
+    case LLDB_REGNUM_GENERIC_PC:    return "pc";
+    case LLDB_REGNUM_GENERIC_SP:    return "sp";
+    case LLDB_REGNUM_GENERIC_FP:    return "fp";
+    case LLDB_REGNUM_GENERIC_RA:    return "ra";
+    case LLDB_REGNUM_GENERIC_FLAGS: return "flags";
+    case LLDB_REGNUM_GENERIC_ARG1:  return "arg1";
+    case LLDB_REGNUM_GENERIC_ARG2:  return "arg2";
+    case LLDB_REGNUM_GENERIC_ARG3:  return "arg3";
+    case LLDB_REGNUM_GENERIC_ARG4:  return "arg4";
+    case LLDB_REGNUM_GENERIC_ARG5:  return "arg5";
+    case LLDB_REGNUM_GENERIC_ARG6:  return "arg6";
+    case LLDB_REGNUM_GENERIC_ARG7:  return "arg7";
+    case LLDB_REGNUM_GENERIC_ARG8:  return "arg8";
+    default:                        break;
+    }
+    return NULL;
+}
+
+bool
+GDBRemoteCommunicationServer::Handle_QThreadSuffixSupported (StringExtractorGDBRemote &packet)
+{
+    return SendOKResponse ();
+}
+
+bool
+GDBRemoteCommunicationServer::Handle_qfThreadInfo (StringExtractorGDBRemote &packet)
+{
+    if (m_native_process_ap.get() == NULL)
+        return SendErrorResponse (14);
+
+    std::vector<lldb::tid_t> tids;
+    m_native_process_ap->GetThreadIDs (tids);
+    if (tids.empty())
+        return SendPacket ("l");
+
+    StreamString response;
+    response.PutChar ('m');
+    for (size_t i = 0; i < tids.size(); ++i)
+    {
+        if (i > 0)
+            response.PutChar (',');
+        response.Printf ("%llx", tids[i]);
+    }
+    return SendPacket (response);
+}
+
+bool
+GDBRemoteCommunicationServer::Handle_qsThreadInfo (StringExtractorGDBRemote &packet)
+{
+    // All threads were sent in reply to "qfThreadInfo"
+    return SendPacket ("l");
+}
+
+bool
+GDBRemoteCommunicationServer::Handle_qRegisterInfo (StringExtractorGDBRemote &packet)
+{
+    packet.SetFilePos(::strlen ("qRegisterInfo"));
+    const uint32_t reg = packet.GetHexMaxU32 (false, UINT32_MAX);
+    const RegisterInfo *reg_info = NativeProcessLinux::GetRegisterInfoAtIndex (reg);
+    if (reg_info == NULL)
+        return SendErrorResponse (0x45);
+
+    StreamString response;
+    response.Printf ("name:%s;", reg_info->name);
+    if (reg_info->alt_name)
+        response.Printf ("alt-name:%s;", reg_info->alt_name);
+    response.Printf ("bitsize:%u;offset:%u;", reg_info->byte_size * 8, reg_info->byte_offset);
+
+    const char *encoding = GetEncodingName (reg_info->encoding);
+    if (encoding)
+        response.Printf ("encoding:%s;", encoding);
+    const char *format = GetFormatName (reg_info->format);
+    if (format)
+        response.Printf ("format:%s;", format);
+    response.Printf ("set:%s;", NativeProcessLinux::GetRegisterSetName (reg));
+
+    if (reg_info->kinds[eRegisterKindGCC] != LLDB_INVALID_REGNUM)
+        response.Printf ("gcc:%u;", reg_info->kinds[eRegisterKindGCC]);
+    if (reg_info->kinds[eRegisterKindDWARF] != LLDB_INVALID_REGNUM)
+        response.Printf ("dwarf:%u;", reg_info->kinds[eRegisterKindDWARF]);
+    const char *generic = GetGenericRegisterName (reg_info->kinds[eRegisterKindGeneric]);
+    if (generic)
+        response.Printf ("generic:%s;", generic);
+    return SendPacket (response);
+}
+
+bool
+GDBRemoteCommunicationServer::Handle_qThreadStopInfo (StringExtractorGDBRemote &packet)
+{
+    if (m_native_process_ap.get() == NULL)
+        return SendErrorResponse (15);
+
+    packet.SetFilePos(::strlen ("qThreadStopInfo"));
+    const lldb::tid_t tid = packet.GetHexMaxU64 (false, LLDB_INVALID_THREAD_ID);
+    return SendStopReplyPacket (tid);
+}
+
+bool
+GDBRemoteCommunicationServer::Handle_qThreadStopSnapshot (StringExtractorGDBRemote &packet)
+{
+    if (m_native_process_ap.get() == NULL || m_native_process_ap->GetState() != eStateStopped)
+        return SendErrorResponse (58);
+
+    // Packet format: "qThreadStopSnapshot:stack:<hex byte size>;"
+    //
+    // The reply has the stop reply packets of the threads separated by
+    // '|'. Each one may end with the top of the thread's stack, as
+    // "binary-memory:<addr>,<hex size of the escaped bytes>=<escaped bytes>;"
+    // if the client takes binary memory, or as "memory:<addr>=<hex bytes>;".
+    // The reply ends with "|truncated" if it can't hold all of the threads.
+    packet.SetFilePos(::strlen ("qThreadStopSnapshot:"));
+    uint32_t stack_byte_size = 0;
+    std::string key;
+    std::string value;
+    while (packet.GetNameColonValue (key, value))
+    {
+        if (key.compare ("stack") == 0)
+            stack_byte_size = Args::StringToUInt32 (value.c_str(), 0, 16);
+    }
+    if (stack_byte_size > k_max_snapshot_stack_bytes)
+        stack_byte_size = k_max_snapshot_stack_bytes;
+
+    std::vector<lldb::tid_t> tids;
+    m_native_process_ap->GetThreadIDs (tids);
+    std::vector<uint8_t> stack_data (stack_byte_size);
+    // Leave room for the framing of the packet and the truncation marker
+    const size_t max_response_size = k_max_packet_size - 32;
+    StreamString response;
+    for (size_t i = 0; i < tids.size(); ++i)
+    {
+        const lldb::tid_t tid = tids[i];
+        StreamString entry;
+        if (i > 0)
+            entry.PutChar ('|');
+        if (!AppendThreadStopInfo (tid, entry))
+            return SendErrorResponse (59);
+        if (response.GetSize() + entry.GetSize() > max_response_size)
+        {
+            // The client gets the rest of the threads with "qfThreadInfo"
+            response.PutCString ("|truncated");
+            break;
+        }
+        response.Write (entry.GetData(), entry.GetSize());
+
+        // Send the top of the stack, where the client's unwinder will look
+        // first, if there is room left for it
+        lldb::addr_t sp = LLDB_INVALID_ADDRESS;
+        std::vector<uint8_t> reg_data (NativeProcessLinux::GetRegisterDataByteSize());
+        if (stack_byte_size > 0 && m_native_process_ap->ReadRegisterData (tid, &reg_data[0], reg_data.size()))
+        {
+            const uint32_t num_registers = NativeProcessLinux::GetRegisterCount();
+            for (uint32_t reg = 0; reg < num_registers; ++reg)
+            {
+                const RegisterInfo *reg_info = NativeProcessLinux::GetRegisterInfoAtIndex (reg);
+                if (reg_info->kinds[eRegisterKindGeneric] == LLDB_REGNUM_GENERIC_SP)
+                {
+                    uint64_t sp_value = 0;
+                    ::memcpy (&sp_value, &reg_data[reg_info->byte_offset], std::min<size_t> (reg_info->byte_size, sizeof(sp_value)));
+                    sp = sp_value;
+                    break;
+                }
+            }
+        }
+        if (sp != LLDB_INVALID_ADDRESS)
+        {
+            Error error;
+            const size_t bytes_read = m_native_process_ap->ReadMemory (sp, &stack_data[0], stack_byte_size, error);
+            if (bytes_read > 0)
+            {
+                StreamString memory;
+                if (m_client_supports_binary_memory)
+                {
+                    std::string escaped_bytes;
+                    GDBRemoteEncoding::AppendEscapedBytes (escaped_bytes, &stack_data[0], bytes_read);
+                    memory.Printf ("binary-memory:%llx,%llx=", sp, (uint64_t)escaped_bytes.size());
+                    memory.Write (escaped_bytes.data(), escaped_bytes.size());
+                }
+                else
+                {
+                    memory.Printf ("memory:%llx=", sp);
+                    memory.PutBytesAsRawHex8 (&stack_data[0], bytes_read);
+                }
+                memory.PutChar (';');
+                if (response.GetSize() + memory.GetSize() <= max_response_size)
+                    response.Write (memory.GetData(), memory.GetSize());
+            }
+        }
+    }
+    return SendPacket (response);
+}
+
+bool
+GDBRemoteCommunicationServer::Handle_stop_reason (StringExtractorGDBRemote &packet)
+{
+    if (m_native_process_ap.get() == NULL)
+        return SendErrorResponse (16);
+    return SendStopReplyPacket (m_native_process_ap->GetStopThreadID());
+}
+
+bool
+GDBRemoteCommunicationServer::Handle_c (StringExtractorGDBRemote &packet)
+{
+    if (m_native_process_ap.get() == NULL)
+        return SendErrorResponse (17);
+
+    // "c" and "C<signo>" resume all threads, we don't support resuming at
+    // a different address.
+    NativeProcessLinux::ResumeAction action = { LLDB_INVALID_THREAD_ID, eStateRunning, 0 };
+    packet.SetFilePos(0);
+    if (packet.GetChar() == 'C')
+        action.signo = packet.GetHexU8 ();
+    if (packet.GetBytesLeft() > 0 && packet.GetChar() != ';')
+        return SendUnimplementedResponse (packet.GetStringRef().c_str());
+
+    NativeProcessLinux::ResumeActionList actions (1, action);
+    Error error (m_native_process_ap->Resume (actions));
+    if (error.Fail())
+        return SendErrorResponse (18);
+    return WaitForStopAndSendStopReply ();
+}
+
+bool
+GDBRemoteCommunicationServer::Handle_s (StringExtractorGDBRemote &packet)
+{
+    if (m_native_process_ap.get() == NULL)
+        return SendErrorResponse (19);
+
+    // "s" and "S<signo>" step the thread selected with "Hc" while the other
+    // threads stay stopped.
+    lldb::tid_t tid = m_continue_tid;
+    if (tid == LLDB_INVALID_THREAD_ID || tid == 0)
+        tid = m_native_process_ap->GetStopThreadID();
+    NativeProcessLinux::ResumeAction action = { tid, eStateStepping, 0 };
+    packet.SetFilePos(0);
+    if (packet.GetChar() == 'S')
+        action.signo = packet.GetHexU8 ();
+    if (packet.GetBytesLeft() > 0 && packet.GetChar() != ';')
+        return SendUnimplementedResponse (packet.GetStringRef().c_str());
+
+    NativeProcessLinux::ResumeActionList actions (1, action);
+    Error error (m_native_process_ap->Resume (actions));
+    if (error.Fail())
+        return SendErrorResponse (20);
+    return WaitForStopAndSendStopReply ();
+}
+
+bool
+GDBRemoteCommunicationServer::Handle_vCont_actions (StringExtractorGDBRemote &packet)
+{
+    return SendPacket ("vCont;c;C;s;S");
+}
+
+bool
+GDBRemoteCommunicationServer::Handle_vCont (StringExtractorGDBRemote &packet)
+{
+    if (m_native_process_ap.get() == NULL)
+        return SendErrorResponse (21);
+
+    // Packet format: "vCont;<action>[:<tid>][;<action>[:<tid>]]..." where
+    // an action without a thread applies to all other threads.
+    packet.SetFilePos(::strlen ("vCont"));
+    NativeProcessLinux::ResumeActionList actions;
+    while (packet.GetBytesLeft() > 0)
+    {
+        if (packet.GetChar() != ';')
+            return SendErrorResponse (22);
+
+        NativeProcessLinux::ResumeAction action = { LLDB_INVALID_THREAD_ID, eStateRunning, 0 };
+        switch (packet.GetChar())
+        {
+        case 'C':
+            action.signo = packet.GetHexU8 ();
+            // Fall through...
+        case 'c':
+            action.state = eStateRunning;
+            break;
+
+        case 'S':
+            action.signo = packet.GetHexU8 ();
+            // Fall through...
+        case 's':
+            action.state = eStateStepping;
+            break;
+
+        default:
+            return SendUnimplementedResponse (packet.GetStringRef().c_str());
+        }
+
+        if (packet.GetBytesLeft() > 0 && *packet.Peek() == ':')
+        {
+            packet.GetChar();
+            action.tid = packet.GetHexMaxU64 (false, LLDB_INVALID_THREAD_ID);
+        }
+        actions.push_back (action);
+    }
+
+    Error error (m_native_process_ap->Resume (actions));
+    if (error.Fail())
+        return SendErrorResponse (23);
+    return WaitForStopAndSendStopReply ();
+}
+
+bool
+GDBRemoteCommunicationServer::Handle_vAttach (StringExtractorGDBRemote &packet)
+{
+    if (m_is_platform || m_native_process_ap.get())
+        return SendErrorResponse (24);
+
+    packet.SetFilePos(::strlen ("vAttach;"));
+    const lldb::pid_t pid = packet.GetHexMaxU64 (false, LLDB_INVALID_PROCESS_ID);
+    if (pid == LLDB_INVALID_PROCESS_ID)
+        return SendErrorResponse (25);
+
+    m_native_process_ap.reset (new NativeProcessLinux());
+    Error error (m_native_process_ap->Attach (pid));
+    if (error.Fail())
+    {
+        m_native_process_ap.reset();
+        return SendErrorResponse (26);
+    }
+    return SendStopReplyPacket (m_native_process_ap->GetStopThreadID());
+}
+
+bool
+GDBRemoteCommunicationServer::Handle_m (StringExtractorGDBRemote &packet)
+{
+    if (m_native_process_ap.get() == NULL)
+        return SendErrorResponse (27);
+
+    // Packet format: "m<addr>,<length>"
+    packet.SetFilePos(1);
+    const lldb::addr_t addr = packet.GetHexMaxU64 (false, LLDB_INVALID_ADDRESS);
+    if (packet.GetChar() != ',')
+        return SendErrorResponse (28);
+    const size_t length = packet.GetHexMaxU64 (false, 0);
+    if (length == 0)
+        return SendPacket ("");
+    if (length > k_max_memory_packet_bytes)
+        return SendErrorResponse (60);
+
+    std::vector<uint8_t> data (length);
+    Error error;
+    const size_t bytes_read = m_native_process_ap->ReadMemory (addr, &data[0], length, error);
+    if (bytes_read == 0)
+        return SendErrorResponse (29);
+
+    StreamString response;
+    response.PutBytesAsRawHex8 (&data[0], bytes_read);
+    return SendPacket (response);
+}
+
+bool
+GDBRemoteCommunicationServer::Handle_M (StringExtractorGDBRemote &packet)
+{
+    if (m_native_process_ap.get() == NULL)
+        return SendErrorResponse (30);
+
+    // Packet format: "M<addr>,<length>:<hex bytes>"
+    packet.SetFilePos(1);
+    const lldb::addr_t addr = packet.GetHexMaxU64 (false, LLDB_INVALID_ADDRESS);
+    if (packet.GetChar() != ',')
+        return SendErrorResponse (31);
+    const size_t length = packet.GetHexMaxU64 (false, 0);
+    if (packet.GetChar() != ':')
+        return SendErrorResponse (32);
+    if (length == 0)
+        return SendOKResponse ();
+    if (length > k_max_memory_packet_bytes)
+        return SendErrorResponse (61);
+
+    std::vector<uint8_t> data (length);
+    if (packet.GetHexBytes (&data[0], length, 0) != length)
+        return SendErrorResponse (33);
+
+    Error error;
+    if (m_native_process_ap->WriteMemory (addr, &data[0], length, error) != length)
+        return SendErrorResponse (34);
+    return SendOKResponse ();
+}
+
+bool
+GDBRemoteCommunicationServer::Handle_x (StringExtractorGDBRemote &packet)
+{
+    if (m_native_process_ap.get() == NULL)
+        return SendErrorResponse (27);
+
+    // Packet format: "x<addr>,<length>"
+    packet.SetFilePos(1);
+    const lldb::addr_t addr = packet.GetHexMaxU64 (false, LLDB_INVALID_ADDRESS);
+    if (packet.GetChar() != ',')
+        return SendErrorResponse (28);
+    const size_t length = packet.GetHexMaxU64 (false, 0);
+    if (length == 0)
+        return SendPacket ("b");
+    if (length > k_max_memory_packet_bytes)
+        return SendErrorResponse (60);
+
+    std::vector<uint8_t> data (length);
+    Error error;
+    const size_t bytes_read = m_native_process_ap->ReadMemory (addr, &data[0], length, error);
+    if (bytes_read == 0)
+        return SendErrorResponse (29);
+
+    // Start with a 'b' so data like "OK" isn't mistaken for a response
+    std::string response ("b");
+    GDBRemoteEncoding::AppendEscapedBytes (response, &data[0], bytes_read);
+    return SendPacket (response.data(), response.size());
+}
+
+bool
+GDBRemoteCommunicationServer::Handle_X (StringExtractorGDBRemote &packet)
+{
+    if (m_native_process_ap.get() == NULL)
+        return SendErrorResponse (30);
+
+    // Packet format: "X<addr>,<length>:<escaped binary bytes>"
+    packet.SetFilePos(1);
+    const lldb::addr_t addr = packet.GetHexMaxU64 (false, LLDB_INVALID_ADDRESS);
+    if (packet.GetChar() != ',')
+        return SendErrorResponse (31);
+    const size_t length = packet.GetHexMaxU64 (false, 0);
+    if (packet.GetChar() != ':')
+        return SendErrorResponse (32);
+    if (length == 0)
+        return SendOKResponse ();
+    if (length > k_max_memory_packet_bytes)
+        return SendErrorResponse (61);
+
+    const std::string &packet_str = packet.GetStringRef();
+    const size_t data_pos = packet.GetFilePos();
+    std::vector<uint8_t> data (length);
+    if (GDBRemoteEncoding::UnescapeBytes (packet_str.data() + data_pos, 
+                                          packet_str.size() - data_pos, 
+                                          &data[0], 
+                                          length) != length)
+        return SendErrorResponse (33);
+
+    Error error;
+    if (m_native_process_ap->WriteMemory (addr, &data[0], length, error) != length)
+        return SendErrorResponse (34);
+    return SendOKResponse ();
+}
+
+bool
+GDBRemoteCommunicationServer::Handle_p (StringExtractorGDBRemote &packet)
+{
+    if (m_native_process_ap.get() == NULL)
+        return SendErrorResponse (35);
+
+    // Packet format: "p<reg>[;thread:<tid>;]"
+    packet.SetFilePos(1);
+    const uint32_t reg = packet.GetHexMaxU32 (false, UINT32_MAX);
+    const RegisterInfo *reg_info = NativeProcessLinux::GetRegisterInfoAtIndex (reg);
+    if (reg_info == NULL)
+        return SendErrorResponse (36);
+
+    std::vector<uint8_t> reg_data (NativeProcessLinux::GetRegisterDataByteSize());
+    if (!m_native_process_ap->ReadRegisterData (GetThreadIDForPacket (packet), &reg_data[0], reg_data.size()))
+        return SendErrorResponse (37);
+
+    StreamString response;
+    response.PutBytesAsRawHex8 (&reg_data[reg_info->byte_offset], reg_info->byte_size);
+    return SendPacket (response);
+}
+
+bool
+GDBRemoteCommunicationServer::Handle_P (StringExtractorGDBRemote &packet)
+{
+    if (m_native_process_ap.get() == NULL)
+        return SendErrorResponse (38);
+
+    // Packet format: "P<reg>=<hex bytes>[;thread:<tid>;]"
+    packet.SetFilePos(1);
+    const uint32_t reg = packet.GetHexMaxU32 (false, UINT32_MAX);
+    const RegisterInfo *reg_info = NativeProcessLinux::GetRegisterInfoAtIndex (reg);
+    if (reg_info == NULL || packet.GetChar() != '=')
+        return SendErrorResponse (39);
+
+    const lldb::tid_t tid = GetThreadIDForPacket (packet);
+    std::vector<uint8_t> reg_data (NativeProcessLinux::GetRegisterDataByteSize());
+    if (!m_native_process_ap->ReadRegisterData (tid, &reg_data[0], reg_data.size()))
+        return SendErrorResponse (40);
+    if (packet.GetHexBytes (&reg_data[reg_info->byte_offset], reg_info->byte_size, 0) != reg_info->byte_size)
+        return SendErrorResponse (41);
+    if (!m_native_process_ap->WriteRegisterData (tid, &reg_data[0], reg_data.size()))
+        return SendErrorResponse (42);
+    return SendOKResponse ();
+}
+
+bool
+GDBRemoteCommunicationServer::Handle_g (StringExtractorGDBRemote &packet)
+{
+    if (m_native_process_ap.get() == NULL)
+        return SendErrorResponse (43);
+
+    std::vector<uint8_t> reg_data (NativeProcessLinux::GetRegisterDataByteSize());
+    if (!m_native_process_ap->ReadRegisterData (GetThreadIDForPacket (packet), &reg_data[0], reg_data.size()))
+        return SendErrorResponse (44);
+
+    StreamString response;
+    response.PutBytesAsRawHex8 (&reg_data[0], reg_data.size());
+    return SendPacket (response);
+}
+
+bool
+GDBRemoteCommunicationServer::Handle_G (StringExtractorGDBRemote &packet)
+{
+    if (m_native_process_ap.get() == NULL)
+        return SendErrorResponse (45);
+
+    // The client may know about fewer registers than we have, start from
+    // the current values so the ones it doesn't send are left alone.
+    const lldb::tid_t tid = GetThreadIDForPacket (packet);
+    std::vector<uint8_t> reg_data (NativeProcessLinux::GetRegisterDataByteSize());
+    if (!m_native_process_ap->ReadRegisterData (tid, &reg_data[0], reg_data.size()))
+        return SendErrorResponse (46);
+
+    std::vector<uint8_t> new_reg_data (reg_data.size());
+    packet.SetFilePos(1);
+    const size_t bytes_extracted = packet.GetHexBytes (&new_reg_data[0], new_reg_data.size(), 0);
+    if (bytes_extracted == 0)
+        return SendErrorResponse (47);
+    ::memcpy (&reg_data[0], &new_reg_data[0], bytes_extracted);
+    if (!m_native_process_ap->WriteRegisterData (tid, &reg_data[0], reg_data.size()))
+        return SendErrorResponse (48);
+    return SendOKResponse ();
+}
+
+bool
+GDBRemoteCommunicationServer::Handle_Z (StringExtractorGDBRemote &packet)
+{
+    if (m_native_process_ap.get() == NULL)
+        return SendErrorResponse (49);
+
+    // Packet format: "Z<type>,<addr>,<kind>" or "z<type>,<addr>,<kind>".
+    // Only software breakpoints are supported.
+    packet.SetFilePos(0);
+    const bool insert = packet.GetChar() == 'Z';
+    if (packet.GetChar() != '0')
+        return SendUnimplementedResponse (packet.GetStringRef().c_str());
+    if (packet.GetChar() != ',')
+        return SendErrorResponse (50);
+    const lldb::addr_t addr = packet.GetHexMaxU64 (false, LLDB_INVALID_ADDRESS);
+    if (addr == LLDB_INVALID_ADDRESS)
+        return SendErrorResponse (51);
+
+    Error error;
+    if (insert)
+        error = m_native_process_ap->SetBreakpoint (addr);
+    else
+        error = m_native_process_ap->RemoveBreakpoint (addr);
+    if (error.Fail())
+        return SendErrorResponse (52);
+    return SendOKResponse ();
+}
+
+bool
+GDBRemoteCommunicationServer::Handle_H (StringExtractorGDBRemote &packet)
+{
+    // Packet format: "Hg<tid>" or "Hc<tid>" where a tid of -1 means all
+    // threads and zero means any thread.
+    packet.SetFilePos(1);
+    const char op = packet.GetChar();
+    lldb::tid_t tid = LLDB_INVALID_THREAD_ID;
+    if (packet.GetBytesLeft() > 0 && *packet.Peek() != '-')
+        tid = packet.GetHexMaxU64 (false, LLDB_INVALID_THREAD_ID);
+
+    if (tid != LLDB_INVALID_THREAD_ID && tid != 0 &&
+        (m_native_process_ap.get() == NULL || !m_native_process_ap->HasThread (tid)))
+        return SendErrorResponse (53);
+
+    if (op == 'g')
+        m_current_tid = tid;
+    else if (op == 'c')
+        m_continue_tid = tid;
+    else
+        return SendUnimplementedResponse (packet.GetStringRef().c_str());
+    return SendOKResponse ();
+}
+
+bool
+GDBRemoteCommunicationServer::Handle_T (StringExtractorGDBRemote &packet)
+{
+    packet.SetFilePos(1);
+    const lldb::tid_t tid = packet.GetHexMaxU64 (false, LLDB_INVALID_THREAD_ID);
+    if (m_native_process_ap.get() && m_native_process_ap->HasThread (tid))
+        return SendOKResponse ();
+    return SendErrorResponse (54);
+}
+
+bool
+GDBRemoteCommunicationServer::Handle_k (StringExtractorGDBRemote &packet)
+{
+    if (m_native_process_ap.get())
+    {
+        m_native_process_ap->Kill();
+        m_native_process_ap.reset();
+    }
+    return SendPacket ("X09");
+}
+
+bool
+GDBRemoteCommunicationServer::Handle_D (StringExtractorGDBRemote &packet)
+{
+    if (m_native_process_ap.get() == NULL)
+        return SendErrorResponse (55);
+
+    Error error (m_native_process_ap->Detach());
+    m_native_process_ap.reset();
+    if (error.Fail())
+        return SendErrorResponse (56);
+    return SendOKResponse ();
+}
+
+lldb::tid_t
+GDBRemoteCommunicationServer::GetThreadIDForPacket (StringExtractorGDBRemote &packet)
+{
+    const std::string &packet_str = packet.GetStringRef();
+    const size_t thread_pos = packet_str.find (";thread:");
+    if (thread_pos != std::string::npos)
+        return ::strtoull (packet_str.c_str() + thread_pos + ::strlen (";thread:"), NULL, 16);
+
+    if (m_current_tid != LLDB_INVALID_THREAD_ID && m_current_tid != 0)
+        return m_current_tid;
+    if (m_native_process_ap->GetStopThreadID() != LLDB_INVALID_THREAD_ID)
+        return m_native_process_ap->GetStopThreadID();
+    return m_native_process_ap->GetID();
+}
+
+bool
+GDBRemoteCommunicationServer::WaitForStopAndSendStopReply ()
+{
+    // We can't block in waitpid() since the client may interrupt the
+    // process, so alternate between checking the process and waiting for a
+    // packet. Start with short waits so quick stops like single steps and
+    // breakpoint hits are reported right away, and back off when the
+    // process keeps running.
+    const uint32_t min_timeout_usec = 100;
+    const uint32_t max_timeout_usec = 10000;
+    uint32_t timeout_usec = min_timeout_usec;
+    while (!m_native_process_ap->CheckForStop())
+    {
+        StringExtractorGDBRemote packet;
+        if (WaitForPacketWithTimeoutMicroSeconds (packet, timeout_usec))
+        {
+            if (packet.GetServerPacketType() == StringExtractorGDBRemote::eServerPacketType_interrupt)
+                m_native_process_ap->Interrupt();
+        }
+        else if (!IsConnected())
+            return false;
+
+        if (timeout_usec < max_timeout_usec)
+            timeout_usec *= 2;
+    }
+
+    if (m_native_process_ap->GetState() == eStateStopped)
+    {
+        // Make the stopped thread the current one, like the client will
+        m_current_tid = m_native_process_ap->GetStopThreadID();
+        m_continue_tid = LLDB_INVALID_THREAD_ID;
+    }
+    return SendStopReplyPacket (m_native_process_ap->GetStopThreadID());
+}
+
+bool
+GDBRemoteCommunicationServer::SendStopReplyPacket (lldb::tid_t tid)
+{
+    StreamString response;
+    if (m_native_process_ap->GetState() == eStateExited)
+    {
+        int signo = 0;
+        const int status = m_native_process_ap->GetExitStatus (&signo);
+        if (signo)
+            response.Printf ("X%2.2x", NativeProcessLinux::GetGDBSignal (signo));
+        else
+            response.Printf ("W%2.2x", status);
+        return SendPacket (response) > 0;
+    }
+
+    if (!AppendThreadStopInfo (tid, response))
+        return SendErrorResponse (57);
+    return SendPacket (response) > 0;
+}
+
+bool
+GDBRemoteCommunicationServer::AppendThreadStopInfo (lldb::tid_t tid, StreamString &response)
+{
+    NativeProcessLinux::StopReason reason;
+    int signo;
+    if (!m_native_process_ap->GetThreadStopInfo (tid, reason, signo))
+        return false;
+
+    response.Printf ("T%2.2xthread:%llx;", signo, tid);
+    switch (reason)
+    {
+    case NativeProcessLinux::eStopReasonBreakpoint:
+        response.PutCString ("reason:breakpoint;");
+        break;
+    case NativeProcessLinux::eStopReasonTrace:
+        response.PutCString ("reason:trace;");
+        break;
+    default:
+        break;
+    }
+
+    // Expedite the registers needed to make the first stack frame so the
+    // client doesn't have to ask for them.
+    std::vector<uint8_t> reg_data (NativeProcessLinux::GetRegisterDataByteSize());
+    if (m_native_process_ap->ReadRegisterData (tid, &reg_data[0], reg_data.size()))
+    {
+        const uint32_t num_registers = NativeProcessLinux::GetRegisterCount();
+        for (uint32_t reg = 0; reg < num_registers; ++reg)
+        {
+            const RegisterInfo *reg_info = NativeProcessLinux::GetRegisterInfoAtIndex (reg);
+            switch (reg_info->kinds[eRegisterKindGeneric])
+            {
+            case LLDB_REGNUM_GENERIC_PC:
+            case LLDB_REGNUM_GENERIC_SP:
+            case LLDB_REGNUM_GENERIC_FP:
+                response.Printf ("%2.2x:", reg);
+                response.PutBytesAsRawHex8 (&reg_data[reg_info->byte_offset], reg_info->byte_size);
+                response.PutChar (';');
+                break;
+            default:
+                break;
+            }
+        }
+    }
+    return true;
+}
+
+#endif // #if defined (__linux__)
@@ -12,6 +12,8 @@
 
 // C Includes
 // C++ Includes
+#include <memory>
+
 // Other libraries and framework includes
 // Project includes
 #include "lldb/Target/Process.h"
@@ -20,6 +22,9 @@
 
 class ProcessGDBRemote;
 class StringExtractorGDBRemote;
+#if defined (__linux__)
+class NativeProcessLinux;
+#endif
 
 class GDBRemoteCommunicationServer : public GDBRemoteCommunication
 {
@@ -72,7 +77,14 @@ protected:
     uint32_t m_proc_infos_index;
     uint16_t m_lo_port_num;
     uint16_t m_hi_port_num;
+    bool m_client_supports_binary_memory;  // The client said "binary-memory+" in its "qSupported" packet
     //PortToPIDMap m_port_to_pid_map;
+#if defined (__linux__)
+    // When not acting as a platform, the server debugs a process itself
+    std::auto_ptr<NativeProcessLinux> m_native_process_ap;
+    lldb::tid_t m_current_tid;  // Thread selected with "Hg"
+    lldb::tid_t m_continue_tid; // Thread selected with "Hc"
+#endif
 
     size_t
     SendUnimplementedResponse (const char *packet);
@@ -116,6 +128,12 @@ protected:
     bool
     Handle_qSpeedTest (StringExtractorGDBRemote &packet);
 
+    bool
+    Handle_qSupported (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_QEnableCompression (StringExtractorGDBRemote &packet);
+
     bool
     Handle_QEnvironment  (StringExtractorGDBRemote &packet);
     
@@ -136,7 +154,105 @@ protected:
 
     bool
     Handle_QSetSTDERR (StringExtractorGDBRemote &packet);
-    
+
+#if defined (__linux__)
+    //------------------------------------------------------------------
+    // Packets that debug a process with NativeProcessLinux
+    //------------------------------------------------------------------
+    bool
+    Handle_QThreadSuffixSupported (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_qfThreadInfo (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_qsThreadInfo (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_qRegisterInfo (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_qThreadStopInfo (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_qThreadStopSnapshot (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_stop_reason (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_c (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_s (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_vCont_actions (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_vCont (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_vAttach (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_m (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_M (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_x (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_X (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_p (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_P (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_g (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_G (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_Z (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_H (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_T (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_k (StringExtractorGDBRemote &packet);
+
+    bool
+    Handle_D (StringExtractorGDBRemote &packet);
+
+    // Returns the thread named by a ";thread:<tid>;" suffix, or else the
+    // one selected with "Hg"
+    lldb::tid_t
+    GetThreadIDForPacket (StringExtractorGDBRemote &packet);
+
+    // Polls the running process for a stop while watching for interrupts
+    // from the client, then sends the stop reply packet
+    bool
+    WaitForStopAndSendStopReply ();
+
+    bool
+    SendStopReplyPacket (lldb::tid_t tid);
+
+    // Appends the stop reply packet of a stopped thread to "response"
+    bool
+    AppendThreadStopInfo (lldb::tid_t tid,
+                          lldb_private::StreamString &response);
+#endif
+
 private:
     //------------------------------------------------------------------
     // For GDBRemoteCommunicationServer only
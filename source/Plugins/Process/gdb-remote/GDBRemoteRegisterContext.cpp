@@ -155,6 +155,22 @@ GDBRemoteRegisterContext::PrivateSetRegisterValue (uint32_t reg, StringExtractor
 }
 
 
+uint32_t
+GDBRemoteRegisterContext::GetRegisterSetIndex (uint32_t reg)
+{
+    const size_t num_sets = m_reg_info.GetNumRegisterSets();
+    for (size_t set = 0; set < num_sets; ++set)
+    {
+        const RegisterSet *reg_set = m_reg_info.GetRegisterSet (set);
+        for (size_t i = 0; i < reg_set->num_registers; ++i)
+        {
+            if (reg_set->registers[i] == reg)
+                return set;
+        }
+    }
+    return UINT32_MAX;
+}
+
 bool
 GDBRemoteRegisterContext::ReadRegisterBytes (const RegisterInfo *reg_info, DataExtractor &data)
 {
@@ -190,6 +206,48 @@ GDBRemoteRegisterContext::ReadRegisterBytes (const RegisterInfo *reg_info, DataE
                                 SetAllRegisterValid (true);
                     }
                 }
+                else if (gdb_comm.GetPipeliningSupported())
+                {
+                    // The other registers in the same set, like the rest of
+                    // the general purpose registers, are likely to be read
+                    // next. Getting them now costs little more time than
+                    // the one register.
+                    std::vector<uint32_t> regs;
+                    regs.push_back (reg);
+                    const RegisterSet *reg_set = m_reg_info.GetRegisterSet (GetRegisterSetIndex (reg));
+                    if (reg_set)
+                    {
+                        for (size_t i = 0; i < reg_set->num_registers; ++i)
+                        {
+                            const uint32_t set_reg = reg_set->registers[i];
+                            if (set_reg != reg && !m_reg_valid[set_reg])
+                                regs.push_back (set_reg);
+                        }
+                    }
+
+                    std::vector<std::string> packets (regs.size());
+                    for (size_t i = 0; i < regs.size(); ++i)
+                    {
+                        if (thread_suffix_supported)
+                            packet_len = ::snprintf (packet, sizeof(packet), "p%x;thread:%4.4llx;", regs[i], m_thread.GetID());
+                        else
+                            packet_len = ::snprintf (packet, sizeof(packet), "p%x", regs[i]);
+                        assert (packet_len < (sizeof(packet) - 1));
+                        packets[i].assign (packet, packet_len);
+                    }
+
+                    std::vector<StringExtractorGDBRemote> responses;
+                    const size_t num_responses = gdb_comm.SendPacketsAndWaitForResponses (packets, responses);
+                    for (size_t i = 0; i < num_responses; ++i)
+                    {
+                        // An error reply, like "E45", would otherwise be
+                        // decoded as register bytes
+                        if (responses[i].IsNormalResponse())
+                            PrivateSetRegisterValue (regs[i], responses[i]);
+                        else
+                            m_reg_valid[regs[i]] = false;
+                    }
+                }
                 else
                 {
                     // Get each register individually
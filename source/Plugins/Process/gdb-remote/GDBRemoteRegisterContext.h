@@ -236,6 +236,10 @@ protected:
 
     bool
     PrivateSetRegisterValue (uint32_t reg, StringExtractor &response);
+
+    // The index of the register set "reg" is in, or UINT32_MAX
+    uint32_t
+    GetRegisterSetIndex (uint32_t reg);
     
     void
     SetAllRegisterValid (bool b);
@@ -27,6 +27,7 @@
 #include "lldb/Core/ArchSpec.h"
 #include "lldb/Core/Debugger.h"
 #include "lldb/Core/ConnectionFileDescriptor.h"
+#include "lldb/Core/DataBufferHeap.h"
 #include "lldb/Host/FileSpec.h"
 #include "lldb/Core/InputReader.h"
 #include "lldb/Core/Module.h"
@@ -55,10 +56,22 @@
 
 
 
+#if defined (__linux__)
+// The Linux stub takes the same command line options as debugserver
+#define DEBUGSERVER_BASENAME    "lldb-gdbserver"
+#else
 #define DEBUGSERVER_BASENAME    "debugserver"
+#endif
 using namespace lldb;
 using namespace lldb_private;
 
+// How much of each thread's stack to get along with its stop info, which
+// covers the first few frames of most backtraces
+enum
+{
+    eThreadStopSnapshotStackByteSize = 512
+};
+
 static bool rand_initialized = false;
 
 static inline uint16_t
@@ -74,6 +87,23 @@ get_random_port ()
     return (rand() % (UINT16_MAX - 1000u)) + 1000u;
 }
 
+// Returns true if "connect_url" is a connection to a process on this host
+static bool
+IsLocalConnectURL (const char *connect_url)
+{
+    static const char *k_connect_prefix = "connect://";
+    const size_t k_connect_prefix_len = ::strlen (k_connect_prefix);
+    if (connect_url == NULL || ::strncmp (connect_url, k_connect_prefix, k_connect_prefix_len) != 0)
+        return true;    // Unix sockets, file descriptors and such
+
+    const char *host = connect_url + k_connect_prefix_len;
+    const char *port = ::strrchr (host, ':');
+    const std::string host_str (host, port ? port - host : ::strlen (host));
+    return host_str.empty() || 
+           host_str.compare ("localhost") == 0 || 
+           host_str.compare ("127.0.0.1") == 0;
+}
+
 
 const char *
 ProcessGDBRemote::GetPluginNameStatic()
@@ -134,7 +164,9 @@ ProcessGDBRemote::ProcessGDBRemote(Target& target, Listener &listener) :
     m_dispatch_queue_offsets_addr (LLDB_INVALID_ADDRESS),
     m_max_memory_size (512),
     m_waiting_for_attach (false),
-    m_thread_observation_bps()
+    m_thread_observation_bps(),
+    m_thread_stop_snapshot (),
+    m_thread_stop_snapshot_stop_id (UINT32_MAX)
 {
     m_async_broadcaster.SetEventName (eBroadcastBitAsyncThreadShouldExit,   "async thread should exit");
     m_async_broadcaster.SetEventName (eBroadcastBitAsyncContinue,           "async thread continue");
@@ -667,9 +699,53 @@ ProcessGDBRemote::ConnectToDebugserver (const char *connect_url)
     m_gdb_comm.GetThreadSuffixSupported ();
     m_gdb_comm.GetHostInfo ();
     m_gdb_comm.GetVContSupported ('c');
+    m_gdb_comm.GetRemoteQSupported ();
+    // Read and write as much memory at a time as the stub takes in one
+    // packet, leaving room for the command and for the data doubling in
+    // size when it is hex encoded or escaped
+    const size_t max_packet_size = m_gdb_comm.GetRemoteMaxPacketSize ();
+    if (max_packet_size > 64)
+        m_max_memory_size = (max_packet_size - 32) / 2;
+    EnableCompressionForConnection (connect_url);
     return error;
 }
 
+//----------------------------------------------------------------------
+// Compression costs time on both ends of the connection, which only pays
+// off when the stub is on another host and we are bandwidth bound. The
+// LLDB_GDB_REMOTE_COMPRESSION environment variable can select "lzss",
+// "rle" or "none" for any connection.
+//----------------------------------------------------------------------
+void
+ProcessGDBRemote::EnableCompressionForConnection (const char *connect_url)
+{
+    GDBRemoteEncoding::CompressionType type = GDBRemoteEncoding::eCompressionNone;
+    const char *env_compression = getenv("LLDB_GDB_REMOTE_COMPRESSION");
+    if (env_compression)
+    {
+        if (!GDBRemoteEncoding::GetCompressionType (env_compression, ::strlen (env_compression), type))
+            type = GDBRemoteEncoding::eCompressionNone;
+    }
+    else if (!IsLocalConnectURL (connect_url))
+    {
+        if (m_gdb_comm.GetCompressionSupported (GDBRemoteEncoding::eCompressionLZSS))
+            type = GDBRemoteEncoding::eCompressionLZSS;
+        else if (m_gdb_comm.GetCompressionSupported (GDBRemoteEncoding::eCompressionRLE))
+            type = GDBRemoteEncoding::eCompressionRLE;
+    }
+
+    if (type != GDBRemoteEncoding::eCompressionNone)
+    {
+        const bool enabled = m_gdb_comm.EnableCompression (type);
+        LogSP log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_PROCESS));
+        if (log)
+            log->Printf ("ProcessGDBRemote::%s %s %s compression", 
+                         __FUNCTION__,
+                         enabled ? "enabled" : "failed to enable",
+                         GDBRemoteEncoding::GetCompressionName (type));
+    }
+}
+
 void
 ProcessGDBRemote::DidLaunchOrAttach ()
 {
@@ -1096,7 +1172,20 @@ ProcessGDBRemote::UpdateThreadList (ThreadList &old_thread_list, ThreadList &new
 
     std::vector<lldb::tid_t> thread_ids;
     bool sequence_mutex_unavailable = false;
-    const size_t num_thread_ids = m_gdb_comm.GetCurrentThreadIDs (thread_ids, sequence_mutex_unavailable);
+    size_t num_thread_ids = 0;
+    // Getting the stop info of every thread, and the memory at the top of
+    // its stack, in one packet saves several round trips per thread.
+    StringExtractorGDBRemote snapshot_response;
+    bool snapshot_complete = false;
+    if (m_gdb_comm.GetThreadStopSnapshot (eThreadStopSnapshotStackByteSize, snapshot_response, sequence_mutex_unavailable))
+        num_thread_ids = ParseThreadStopSnapshot (snapshot_response, thread_ids, snapshot_complete);
+    if (!snapshot_complete && !sequence_mutex_unavailable)
+    {
+        // There is no snapshot, or it didn't have room for all the threads.
+        // The stop replies we did get are still used.
+        thread_ids.clear();
+        num_thread_ids = m_gdb_comm.GetCurrentThreadIDs (thread_ids, sequence_mutex_unavailable);
+    }
     if (num_thread_ids > 0)
     {
         for (size_t i=0; i<num_thread_ids; ++i)
@@ -1114,6 +1203,148 @@ ProcessGDBRemote::UpdateThreadList (ThreadList &old_thread_list, ThreadList &new
     return new_thread_list.GetSize(false);
 }
 
+//----------------------------------------------------------------------
+// Splits a "qThreadStopSnapshot" response into the stop replies of each
+// thread, and puts the stack memory that came with them in the memory
+// cache. The stop replies are kept until RefreshStateAfterStop() can
+// give them to the threads, which aren't in m_thread_list yet.
+//
+// "complete" is set to false if the stub ran out of room for some of the
+// threads, or the response is malformed.
+//----------------------------------------------------------------------
+size_t
+ProcessGDBRemote::ParseThreadStopSnapshot (StringExtractorGDBRemote &response,
+                                           std::vector<lldb::tid_t> &thread_ids,
+                                           bool &complete)
+{
+    m_thread_stop_snapshot.clear();
+    m_thread_stop_snapshot_stop_id = GetStopID();
+    complete = true;
+
+    // The stop replies are separated by '|', but the escaped bytes of a
+    // "binary-memory" value may contain '|', ':' or ';', so the response
+    // is scanned one "name:value;" pair at a time.
+    const std::string &response_str = response.GetStringRef();
+    const size_t response_size = response_str.size();
+    size_t pos = 0;
+    while (complete && pos < response_size)
+    {
+        if (response_str.compare (pos, std::string::npos, "truncated") == 0)
+        {
+            complete = false;
+            break;
+        }
+        if (response_str[pos] != 'T' || pos + 3 > response_size)
+        {
+            // Not a stop reply we can use, skip it
+            pos = response_str.find ('|', pos);
+            if (pos == std::string::npos)
+                break;
+            ++pos;
+            continue;
+        }
+
+        tid_t tid = LLDB_INVALID_THREAD_ID;
+        std::string stop_reply (response_str, pos, 3);
+        pos += 3;
+        while (pos < response_size && response_str[pos] != '|')
+        {
+            const size_t colon_pos = response_str.find (':', pos);
+            if (colon_pos == std::string::npos)
+            {
+                complete = false;
+                break;
+            }
+            const std::string name (response_str, pos, colon_pos - pos);
+            if (name.compare("binary-memory") == 0)
+            {
+                // "binary-memory:<addr>,<hex size of the escaped bytes>=<escaped bytes>;"
+                const char *value_cstr = response_str.c_str() + colon_pos + 1;
+                char *end = NULL;
+                const addr_t addr = ::strtoull (value_cstr, &end, 16);
+                size_t escaped_byte_size = 0;
+                if (*end == ',')
+                    escaped_byte_size = ::strtoull (end + 1, &end, 16);
+                const size_t data_pos = end + 1 - response_str.c_str();
+                if (*end != '=' || 
+                    data_pos + escaped_byte_size >= response_size || 
+                    response_str[data_pos + escaped_byte_size] != ';')
+                {
+                    complete = false;
+                    break;
+                }
+                DataBufferHeap memory (escaped_byte_size, 0);
+                const size_t bytes_decoded = GDBRemoteEncoding::UnescapeBytes (response_str.data() + data_pos, 
+                                                                               escaped_byte_size, 
+                                                                               memory.GetBytes(), 
+                                                                               memory.GetByteSize());
+                GetMemoryCache().AddPrefetchedData (addr, memory.GetBytes(), bytes_decoded);
+                pos = data_pos + escaped_byte_size + 1;
+                continue;
+            }
+
+            size_t value_end = response_str.find (';', colon_pos);
+            if (value_end == std::string::npos)
+                value_end = response_size;
+            std::string value (response_str, colon_pos + 1, value_end - colon_pos - 1);
+            pos = value_end + 1;
+            if (name.compare("memory") == 0)
+            {
+                // "memory:<addr>=<hex bytes>"
+                StringExtractor memory_extractor;
+                memory_extractor.GetStringRef().swap (value);
+                const addr_t addr = memory_extractor.GetHexMaxU64 (false, LLDB_INVALID_ADDRESS);
+                if (addr == LLDB_INVALID_ADDRESS || memory_extractor.GetChar() != '=')
+                    continue;
+                DataBufferHeap memory (memory_extractor.GetBytesLeft() / 2, 0);
+                const size_t bytes_decoded = memory_extractor.GetHexBytes (memory.GetBytes(), memory.GetByteSize(), 0);
+                GetMemoryCache().AddPrefetchedData (addr, memory.GetBytes(), bytes_decoded);
+                continue;
+            }
+            if (name.compare("thread") == 0)
+                tid = Args::StringToUInt64 (value.c_str(), LLDB_INVALID_THREAD_ID, 16);
+            stop_reply.append (name);
+            stop_reply.push_back (':');
+            stop_reply.append (value);
+            stop_reply.push_back (';');
+        }
+        // Skip the '|'
+        ++pos;
+
+        if (complete && tid != LLDB_INVALID_THREAD_ID)
+        {
+            thread_ids.push_back (tid);
+            m_thread_stop_snapshot.push_back (stop_reply);
+        }
+    }
+
+    LogSP log (ProcessGDBRemoteLog::GetLogIfAllCategoriesSet (GDBR_LOG_THREAD));
+    if (log)
+        log->Printf ("ProcessGDBRemote::%s () got the stop info of %llu threads in %llu bytes%s", 
+                     __FUNCTION__,
+                     (uint64_t)thread_ids.size(),
+                     (uint64_t)response_size,
+                     complete ? "" : ", more threads need qfThreadInfo");
+    return thread_ids.size();
+}
+
+void
+ProcessGDBRemote::ApplyThreadStopSnapshot ()
+{
+    if (m_thread_stop_snapshot_stop_id == GetStopID())
+    {
+        // Setting the stop info of a thread also supplies its expedited
+        // registers, so neither needs another packet
+        for (size_t i = 0; i < m_thread_stop_snapshot.size(); ++i)
+        {
+            StringExtractor stop_packet (m_thread_stop_snapshot[i].c_str());
+            SetThreadStopInfo (stop_packet);
+        }
+    }
+    m_thread_stop_snapshot.clear();
+    m_thread_stop_snapshot_stop_id = UINT32_MAX;
+}
+
 
 StateType
 ProcessGDBRemote::SetThreadStopInfo (StringExtractor& stop_packet)
@@ -1377,6 +1608,7 @@ ProcessGDBRemote::RefreshStateAfterStop ()
     // Let all threads recover from stopping and do any clean up based
     // on the previous thread state (if any).
     m_thread_list.RefreshStateAfterStop();
+    ApplyThreadStopSnapshot ();
     SetThreadStopInfo (m_last_stop_packet);
 }
 
@@ -1598,34 +1830,103 @@ ProcessGDBRemote::DoReadMemory (addr_t addr, void *buf, size_t size, Error &erro
 {
     if (size > m_max_memory_size)
     {
+        // A read that takes several packets can send them all at once if
+        // the remote can take them that way
+        if (m_gdb_comm.GetPipeliningSupported())
+        {
+            const size_t bytes_read = DoReadMemoryPipelined (addr, buf, size, error);
+            if (bytes_read > 0 || error.Fail())
+                return bytes_read;
+        }
+
         // Keep memory read sizes down to a sane limit. This function will be
         // called multiple times in order to complete the task by 
         // lldb_private::Process so it is ok to do this.
         size = m_max_memory_size;
     }
 
-    char packet[64];
-    const int packet_len = ::snprintf (packet, sizeof(packet), "m%llx,%zx", (uint64_t)addr, size);
-    assert (packet_len + 1 < sizeof(packet));
+    std::string packet;
+    GetReadMemoryPacket (addr, size, packet);
     StringExtractorGDBRemote response;
-    if (m_gdb_comm.SendPacketAndWaitForResponse(packet, packet_len, response, true))
+    if (m_gdb_comm.SendPacketAndWaitForResponse(packet.data(), packet.size(), response, true))
+        return DecodeReadMemoryResponse (packet, response, buf, size, error);
+
+    error.SetErrorStringWithFormat("failed to sent packet: '%s'", packet.c_str());
+    return 0;
+}
+
+//----------------------------------------------------------------------
+// Reads memory with all the packets it takes in flight at once. Returns
+// zero without an error if the packets couldn't be sent now, for instance
+// because the process is running.
+//----------------------------------------------------------------------
+size_t
+ProcessGDBRemote::DoReadMemoryPipelined (addr_t addr, void *buf, size_t size, Error &error)
+{
+    std::vector<std::string> packets;
+    for (size_t offset = 0; offset < size; offset += m_max_memory_size)
     {
-        if (response.IsNormalResponse())
+        packets.push_back (std::string());
+        GetReadMemoryPacket (addr + offset, std::min<size_t> (m_max_memory_size, size - offset), packets.back());
+    }
+
+    std::vector<StringExtractorGDBRemote> responses;
+    const size_t num_responses = m_gdb_comm.SendPacketsAndWaitForResponses (packets, responses);
+    uint8_t *dst = (uint8_t *)buf;
+    size_t bytes_read = 0;
+    for (size_t i = 0; i < num_responses; ++i)
+    {
+        const size_t chunk_size = std::min<size_t> (m_max_memory_size, size - bytes_read);
+        const size_t chunk_bytes_read = DecodeReadMemoryResponse (packets[i], responses[i], dst + bytes_read, chunk_size, error);
+        bytes_read += chunk_bytes_read;
+        if (chunk_bytes_read < chunk_size)
         {
-            error.Clear();
-            return response.GetHexBytes(buf, size, '\xdd');
+            // Report how far we got, rather than the error for what's after
+            if (bytes_read > 0)
+                error.Clear();
+            return bytes_read;
         }
-        else if (response.IsErrorResponse())
-            error.SetErrorStringWithFormat("gdb remote returned an error: %s", response.GetStringRef().c_str());
-        else if (response.IsUnsupportedResponse())
-            error.SetErrorStringWithFormat("'%s' packet unsupported", packet);
-        else
-            error.SetErrorStringWithFormat("unexpected response to '%s': '%s'", packet, response.GetStringRef().c_str());
     }
-    else
+    return bytes_read;
+}
+
+void
+ProcessGDBRemote::GetReadMemoryPacket (addr_t addr, size_t size, std::string &packet)
+{
+    // Binary data takes about half the bytes of hex on the wire
+    const bool binary_memory = m_gdb_comm.GetBinaryMemorySupported();
+    char packet_cstr[64];
+    const int packet_len = ::snprintf (packet_cstr, sizeof(packet_cstr), "%c%llx,%zx", binary_memory ? 'x' : 'm', (uint64_t)addr, size);
+    assert (packet_len + 1 < sizeof(packet_cstr));
+    packet.assign (packet_cstr, packet_len);
+}
+
+size_t
+ProcessGDBRemote::DecodeReadMemoryResponse (const std::string &packet,
+                                            StringExtractorGDBRemote &response,
+                                            void *buf,
+                                            size_t size,
+                                            Error &error)
+{
+    if (response.IsNormalResponse())
     {
-        error.SetErrorStringWithFormat("failed to sent packet: '%s'", packet);
+        error.Clear();
+        if (packet[0] == 'm')
+            return response.GetHexBytes(buf, size, '\xdd');
+
+        // The data follows a 'b' so it can't be mistaken for an "OK"
+        // or error response
+        const std::string &response_str = response.GetStringRef();
+        if (response_str[0] == 'b')
+            return GDBRemoteEncoding::UnescapeBytes (response_str.data() + 1, response_str.size() - 1, buf, size);
+        error.SetErrorStringWithFormat("unexpected response to '%s': '%s'", packet.c_str(), response_str.c_str());
     }
+    else if (response.IsErrorResponse())
+        error.SetErrorStringWithFormat("gdb remote returned an error: %s", response.GetStringRef().c_str());
+    else if (response.IsUnsupportedResponse())
+        error.SetErrorStringWithFormat("'%s' packet unsupported", packet.c_str());
+    else
+        error.SetErrorStringWithFormat("unexpected response to '%s': '%s'", packet.c_str(), response.GetStringRef().c_str());
     return 0;
 }
 
@@ -1641,8 +1942,18 @@ ProcessGDBRemote::DoWriteMemory (addr_t addr, const void *buf, size_t size, Erro
     }
 
     StreamString packet;
-    packet.Printf("M%llx,%zx:", addr, size);
-    packet.PutBytesAsRawHex8(buf, size, lldb::endian::InlHostByteOrder(), lldb::endian::InlHostByteOrder());
+    if (m_gdb_comm.GetBinaryMemorySupported())
+    {
+        std::string escaped_bytes;
+        GDBRemoteEncoding::AppendEscapedBytes (escaped_bytes, buf, size);
+        packet.Printf("X%llx,%zx:", addr, size);
+        packet.Write(escaped_bytes.data(), escaped_bytes.size());
+    }
+    else
+    {
+        packet.Printf("M%llx,%zx:", addr, size);
+        packet.PutBytesAsRawHex8(buf, size, lldb::endian::InlHostByteOrder(), lldb::endian::InlHostByteOrder());
+    }
     StringExtractorGDBRemote response;
     if (m_gdb_comm.SendPacketAndWaitForResponse(packet.GetData(), packet.GetSize(), response, true))
     {
@@ -306,6 +306,8 @@ protected:
     bool m_waiting_for_attach;
     std::vector<lldb::user_id_t>  m_thread_observation_bps;
     MMapMap m_addr_to_mmap_size;
+    std::vector<std::string> m_thread_stop_snapshot;   // Stop replies for each thread from "qThreadStopSnapshot"
+    uint32_t m_thread_stop_snapshot_stop_id;           // The stop ID m_thread_stop_snapshot is for
     bool
     StartAsyncThread ();
 
@@ -325,12 +327,41 @@ protected:
     lldb::StateType
     SetThreadStopInfo (StringExtractor& stop_packet);
 
+    size_t
+    ParseThreadStopSnapshot (StringExtractorGDBRemote &response,
+                             std::vector<lldb::tid_t> &thread_ids,
+                             bool &complete);
+
+    void
+    ApplyThreadStopSnapshot ();
+
     void
     DidLaunchOrAttach ();
 
     lldb_private::Error
     ConnectToDebugserver (const char *host_port);
 
+    void
+    EnableCompressionForConnection (const char *connect_url);
+
+    size_t
+    DoReadMemoryPipelined (lldb::addr_t addr,
+                           void *buf,
+                           size_t size,
+                           lldb_private::Error &error);
+
+    void
+    GetReadMemoryPacket (lldb::addr_t addr,
+                         size_t size,
+                         std::string &packet);
+
+    size_t
+    DecodeReadMemoryResponse (const std::string &packet,
+                              StringExtractorGDBRemote &response,
+                              void *buf,
+                              size_t size,
+                              lldb_private::Error &error);
+
     const char *
     GetDispatchQueueNameForThread (lldb::addr_t thread_dispatch_qaddr,
                                    std::string &dispatch_queue_name);
@@ -19,7 +19,8 @@ DWARFAbbreviationDeclaration::DWARFAbbreviationDeclaration() :
     m_code  (InvalidCode),
     m_tag   (0),
     m_has_children (0),
-    m_attributes()
+    m_attributes(),
+    m_fixed_attr_offsets()
 {
 }
 
@@ -27,7 +28,8 @@ DWARFAbbreviationDeclaration::DWARFAbbreviationDeclaration(dw_tag_t tag, uint8_t
     m_code  (InvalidCode),
     m_tag   (tag),
     m_has_children (has_children),
-    m_attributes()
+    m_attributes(),
+    m_fixed_attr_offsets()
 {
 }
 
@@ -57,6 +59,7 @@ DWARFAbbreviationDeclaration::Extract(const DataExtractor& data, uint32_t* offse
             else
                 break;
         }
+        UpdateFixedAttributeOffsets();
 
         return m_tag != 0;
     }
@@ -64,11 +67,64 @@ DWARFAbbreviationDeclaration::Extract(const DataExtractor& data, uint32_t* offse
     {
         m_tag = 0;
         m_has_children = 0;
+        m_fixed_attr_offsets.clear();
     }
 
     return false;
 }
 
+//----------------------------------------------------------------------
+// Precompute the offsets of the attributes that only follow fixed size
+// forms so DWARFDebugInfoEntry::GetAttributeValue() can jump straight
+// to them instead of skipping each preceding form. If all forms have a
+// fixed size, the last entry is the size of the attribute data so
+// DWARFDebugInfoEntry::FastExtract() can skip the whole DIE at once.
+//----------------------------------------------------------------------
+void
+DWARFAbbreviationDeclaration::UpdateFixedAttributeOffsets()
+{
+    m_fixed_attr_offsets.clear();
+    const uint32_t num_attributes = m_attributes.size();
+    if (num_attributes == 0)
+        return;
+
+    FixedAttributeOffset attr_offset = { 0, 0 };
+    m_fixed_attr_offsets.push_back(attr_offset);
+    for (uint32_t i = 0; i < num_attributes; ++i)
+    {
+        switch (m_attributes[i].get_form())
+        {
+        case DW_FORM_addr:
+        case DW_FORM_ref_addr:
+            ++attr_offset.num_addresses;
+            break;
+        case DW_FORM_data1:
+        case DW_FORM_flag:
+        case DW_FORM_ref1:
+            attr_offset.byte_size += 1;
+            break;
+        case DW_FORM_data2:
+        case DW_FORM_ref2:
+            attr_offset.byte_size += 2;
+            break;
+        case DW_FORM_data4:
+        case DW_FORM_ref4:
+        case DW_FORM_strp:
+            attr_offset.byte_size += 4;
+            break;
+        case DW_FORM_data8:
+        case DW_FORM_ref8:
+            attr_offset.byte_size += 8;
+            break;
+        default:
+            // Variable sized, the offsets of all following attributes
+            // depend on the DIE's contents.
+            return;
+        }
+        m_fixed_attr_offsets.push_back(attr_offset);
+    }
+}
+
 
 void
 DWARFAbbreviationDeclaration::Dump(Stream *s)  const
@@ -134,6 +190,7 @@ DWARFAbbreviationDeclaration::CopyExcludingAddressAttributes(const DWARFAbbrevia
             break;
         }
     }
+    UpdateFixedAttributeOffsets();
 }
 
 void
@@ -168,6 +225,7 @@ DWARFAbbreviationDeclaration::CopyChangingStringToStrp(
         else
             m_attributes.push_back(DWARFAttribute(attr, form));
     }
+    UpdateFixedAttributeOffsets();
 }
 
 
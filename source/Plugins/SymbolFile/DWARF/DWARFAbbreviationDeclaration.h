@@ -26,6 +26,7 @@ public:
     void            AddAttribute(const DWARFAttribute& attr)
                     {
                         m_attributes.push_back(attr);
+                        UpdateFixedAttributeOffsets();
                     }
 
     dw_uleb128_t    Code() const { return m_code; }
@@ -63,6 +64,22 @@ public:
                         const DWARFCompileUnit* cu,
                         const uint32_t strp_min_len);
     uint32_t        FindAttributeIndex(dw_attr_t attr) const;
+
+                    // Advance "offset" from the start of a DIE's attribute data
+                    // towards the attribute at "attr_idx" without decoding any
+                    // forms, as far as the leading attributes have sizes that don't
+                    // depend on the DIE's contents. Returns the index of the
+                    // attribute "offset" now points to, which is NumAttributes()
+                    // if "attr_idx" is NumAttributes() and every form has a fixed
+                    // size.
+    uint32_t        SkipFixedSizeAttributes(uint32_t attr_idx, uint8_t addr_size, uint32_t& offset) const
+                    {
+                        if (m_fixed_attr_offsets.empty())
+                            return 0;
+                        const uint32_t idx = attr_idx < m_fixed_attr_offsets.size() ? attr_idx : m_fixed_attr_offsets.size() - 1;
+                        offset += m_fixed_attr_offsets[idx].byte_size + m_fixed_attr_offsets[idx].num_addresses * addr_size;
+                        return idx;
+                    }
     bool            Extract(const lldb_private::DataExtractor& data, uint32_t* offset_ptr);
     bool            Extract(const lldb_private::DataExtractor& data, uint32_t* offset_ptr, dw_uleb128_t code);
 //  void            Append(BinaryStreamBuf& out_buff) const;
@@ -72,10 +89,21 @@ public:
 //  DWARFAttribute::collection& Attributes() { return m_attributes; }
     const DWARFAttribute::collection& Attributes() const { return m_attributes; }
 protected:
+    void            UpdateFixedAttributeOffsets();
+
+    // The offset of an attribute from the start of a DIE's attribute
+    // data is the byte size plus the size of "num_addresses" addresses.
+    struct FixedAttributeOffset
+    {
+        uint32_t byte_size;
+        uint32_t num_addresses;
+    };
+
     dw_uleb128_t        m_code;
     dw_tag_t            m_tag;
     uint8_t             m_has_children;
     DWARFAttribute::collection m_attributes;
+    std::vector<FixedAttributeOffset> m_fixed_attr_offsets; // Offsets of the leading attributes that only follow fixed size forms, plus the end of the data if all forms are fixed size
 };
 
 #endif  // liblldb_DWARFAbbreviationDeclaration_h_
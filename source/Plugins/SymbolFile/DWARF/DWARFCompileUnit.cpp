@@ -36,7 +36,12 @@ DWARFCompileUnit::DWARFCompileUnit(SymbolFileDWARF* dwarf2Data) :
     m_dwarf2Data    (dwarf2Data),
     m_abbrevs       (NULL),
     m_user_data     (NULL),
-    m_die_array     (),
+    m_die_array     (NULL),
+    m_num_dies      (0),
+    m_die_array_capacity (0),
+    m_arena_pos     (),
+    m_dies_pinned   (false),
+    m_dies_evictable (false),
     m_func_aranges_ap (),
     m_base_addr     (0),
     m_offset        (DW_INVALID_OFFSET),
@@ -46,6 +51,13 @@ DWARFCompileUnit::DWARFCompileUnit(SymbolFileDWARF* dwarf2Data) :
 {
 }
 
+DWARFCompileUnit::~DWARFCompileUnit()
+{
+    // The DIE array memory belongs to the arena, but the arena must not
+    // evict a compile unit that no longer exists.
+    DWARFDIEArena::RemoveEvictable (this);
+}
+
 void
 DWARFCompileUnit::Clear()
 {
@@ -55,7 +67,8 @@ DWARFCompileUnit::Clear()
     m_abbrevs       = NULL;
     m_addr_size     = DWARFCompileUnit::GetDefaultAddressSize();
     m_base_addr     = 0;
-    m_die_array.clear();
+    SetDIEs (NULL, 0);
+    m_dies_pinned   = false;
     m_func_aranges_ap.reset();
     m_user_data     = NULL;
 }
@@ -122,24 +135,67 @@ DWARFCompileUnit::Extract(dw_offset_t offset, const DataExtractor& debug_info_da
 void
 DWARFCompileUnit::ClearDIEs(bool keep_compile_unit_die)
 {
-    if (m_die_array.size() > 1)
+    if (m_num_dies > 1)
     {
-        // std::vectors never get any smaller when resized to a smaller size,
-        // or when clear() or erase() are called, the size will report that it
-        // is smaller, but the memory allocated remains intact (call capacity()
-        // to see this). So we need to create a temporary vector and swap the
-        // contents which will cause just the internal pointers to be swapped
-        // so that when "tmp_array" goes out of scope, it will destroy the
-        // contents.
-
         // Save at least the compile unit DIE
-        DWARFDebugInfoEntry::collection tmp_array;
-        m_die_array.swap(tmp_array);
         if (keep_compile_unit_die)
-            m_die_array.push_back(tmp_array.front());
+        {
+            const DWARFDebugInfoEntry cu_die (m_die_array[0]);
+            SetDIEs (&cu_die, 1);
+        }
+        else
+            SetDIEs (NULL, 0);
+        m_dies_pinned = false;
+    }
+}
+
+//----------------------------------------------------------------------
+// Replace the DIE array with a copy of "dies" allocated from the
+// symbol file's DIE arena.
+//----------------------------------------------------------------------
+void
+DWARFCompileUnit::SetDIEs (const DWARFDebugInfoEntry *dies, uint32_t num_dies)
+{
+    DWARFDIEArena &arena = m_dwarf2Data->GetDIEArena();
+    DWARFDIEArena::RemoveEvictable (this);
+    arena.Deallocate (m_die_array, m_die_array_capacity);
+    m_die_array = NULL;
+    m_num_dies = 0;
+    m_die_array_capacity = 0;
+    if (num_dies > 0)
+    {
+        m_die_array = arena.Allocate (num_dies, m_die_array_capacity);
+        std::copy (dies, dies + num_dies, m_die_array);
+        m_num_dies = num_dies;
     }
 }
 
+void
+DWARFCompileUnit::AddDIE (DWARFDebugInfoEntry& die)
+{
+    if (m_num_dies == m_die_array_capacity)
+    {
+        // The average bytes per DIE entry has been seen to be
+        // around 14-20 so lets pre-reserve half of that since
+        // we are now stripping the NULL tags. 
+        uint32_t new_capacity = m_die_array_capacity * 2;
+        if (new_capacity < GetDebugInfoSize() / 24)
+            new_capacity = GetDebugInfoSize() / 24;
+        if (new_capacity <= m_num_dies)
+            new_capacity = m_num_dies + 1;
+
+        DWARFDIEArena &arena = m_dwarf2Data->GetDIEArena();
+        uint32_t capacity = 0;
+        DWARFDebugInfoEntry *die_array = arena.Allocate (new_capacity, capacity);
+        std::copy (m_die_array, m_die_array + m_num_dies, die_array);
+        arena.Deallocate (m_die_array, m_die_array_capacity);
+        m_die_array = die_array;
+        m_die_array_capacity = capacity;
+    }
+    m_die_array[m_num_dies++] = die;
+    m_dies_pinned = true;
+}
+
 //----------------------------------------------------------------------
 // ParseCompileUnitDIEsIfNeeded
 //
@@ -149,7 +205,42 @@ DWARFCompileUnit::ClearDIEs(bool keep_compile_unit_die)
 size_t
 DWARFCompileUnit::ExtractDIEsIfNeeded (bool cu_die_only)
 {
-    const size_t initial_die_array_size = m_die_array.size();
+    // Our caller may hold on to the DIEs from here on, so they can't be
+    // evicted anymore.
+    if (!cu_die_only && !m_dies_pinned)
+    {
+        m_dies_pinned = true;
+        DWARFDIEArena::RemoveEvictable (this);
+    }
+    return ExtractDIEs (cu_die_only);
+}
+
+bool
+DWARFCompileUnit::ExtractDIEsForScan ()
+{
+    if (m_dies_pinned && HasDIEsParsed())
+        return false;
+
+    // Keep the arena from evicting our DIEs while they are being scanned.
+    // The check and the unlink happen under the LRU list lock, so after
+    // this another thread can no longer pick this compile unit to evict.
+    DWARFDIEArena::RemoveEvictable (this);
+    ExtractDIEs (false);
+    m_dies_pinned = false;
+    return true;
+}
+
+void
+DWARFCompileUnit::ReleaseDIEs ()
+{
+    if (!m_dies_pinned && HasDIEsParsed())
+        DWARFDIEArena::AddEvictable (this);
+}
+
+size_t
+DWARFCompileUnit::ExtractDIEs (bool cu_die_only)
+{
+    const size_t initial_die_array_size = m_num_dies;
     if ((cu_die_only && initial_die_array_size > 0) || initial_die_array_size > 1)
         return 0; // Already parsed
 
@@ -165,8 +256,14 @@ DWARFCompileUnit::ExtractDIEsIfNeeded (bool cu_die_only)
 
     DWARFDebugInfoEntry die;
         // Keep a flat array of the DIE for binary lookup by DIE offset
+    DWARFDebugInfoEntry::collection die_array;
     if (!cu_die_only)
     {
+        // The average bytes per DIE entry has been seen to be
+        // around 14-20 so lets pre-reserve half of that since
+        // we are now stripping the NULL tags. 
+        die_array.reserve (GetDebugInfoSize() / 24);
+
         LogSP log (LogChannelDWARF::GetLogIfAny(DWARF_LOG_DEBUG_INFO | DWARF_LOG_LOOKUPS));
         if (log)
         {
@@ -202,10 +299,12 @@ DWARFCompileUnit::ExtractDIEsIfNeeded (bool cu_die_only)
             if (base_addr == LLDB_INVALID_ADDRESS)
                 base_addr = die.GetAttributeValueAsUnsigned(m_dwarf2Data, this, DW_AT_entry_pc, 0);
             SetBaseAddress (base_addr);
-            if (initial_die_array_size == 0)
-                AddDIE (die);
+            die_array.push_back (die);
             if (cu_die_only)
+            {
+                SetDIEs (&die_array[0], 1);
                 return 1;
+            }
         }
         else
         {
@@ -218,19 +317,19 @@ DWARFCompileUnit::ExtractDIEsIfNeeded (bool cu_die_only)
                     // the NULL DIEs from the list (saves up to 25% in C++ code),
                     // we need a way to let the DIE know that it actually doesn't
                     // have children.
-                    if (!m_die_array.empty())
-                        m_die_array.back().SetEmptyChildren(true);
+                    if (!die_array.empty())
+                        die_array.back().SetEmptyChildren(true);
                 }
             }
             else
             {
-                die.SetParentIndex(m_die_array.size() - die_index_stack[depth-1]);
+                die.SetParentIndex(die_array.size() - die_index_stack[depth-1]);
 
                 if (die_index_stack.back())
-                    m_die_array[die_index_stack.back()].SetSiblingIndex(m_die_array.size()-die_index_stack.back());
+                    die_array[die_index_stack.back()].SetSiblingIndex(die_array.size()-die_index_stack.back());
                 
                 // Only push the DIE if it isn't a NULL DIE
-                    m_die_array.push_back(die);
+                    die_array.push_back(die);
             }
         }
 
@@ -249,7 +348,7 @@ DWARFCompileUnit::ExtractDIEsIfNeeded (bool cu_die_only)
         }
         else
         {
-            die_index_stack.back() = m_die_array.size() - 1;
+            die_index_stack.back() = die_array.size() - 1;
             // Normal DIE
             const bool die_has_children = die.HasChildren();
             if (die_has_children)
@@ -271,25 +370,23 @@ DWARFCompileUnit::ExtractDIEsIfNeeded (bool cu_die_only)
                                                                    offset);
     }
 
-    // Since std::vector objects will double their size, we really need to
-    // make a new array with the perfect size so we don't end up wasting
-    // space. So here we copy and swap to make sure we don't have any extra
-    // memory taken up.
-    
-    if (m_die_array.size () < m_die_array.capacity())
-    {
-        DWARFDebugInfoEntry::collection exact_size_die_array (m_die_array.begin(), m_die_array.end());
-        exact_size_die_array.swap (m_die_array);
-    }
     LogSP log (LogChannelDWARF::GetLogIfAll (DWARF_LOG_DEBUG_INFO | DWARF_LOG_VERBOSE));
     if (log)
     {
         StreamString strm;
-        DWARFDebugInfoEntry::DumpDIECollection (strm, m_die_array);
+        DWARFDebugInfoEntry::DumpDIECollection (strm, die_array);
         log->PutCString (strm.GetString().c_str());
     }
 
-    return m_die_array.size();
+    // Since std::vector objects will double their size, copy the DIEs
+    // into an exactly sized array from the arena so we don't end up
+    // wasting space.
+    if (die_array.empty())
+        SetDIEs (NULL, 0);
+    else
+        SetDIEs (&die_array[0], die_array.size());
+
+    return m_num_dies;
 }
 
 
@@ -382,14 +479,15 @@ DWARFCompileUnit::BuildAddressRangeTable (SymbolFileDWARF* dwarf2Data,
     // all compile units to stay loaded when they weren't needed. So we can end
     // up parsing the DWARF and then throwing them all away to keep memory usage
     // down.
-    const bool clear_dies = ExtractDIEsIfNeeded (false) > 1;
+    const bool release_dies = ExtractDIEsForScan ();
     
-    DIE()->BuildAddressRangeTable(dwarf2Data, this, debug_aranges);
+    if (m_num_dies > 0)
+        m_die_array[0].BuildAddressRangeTable(dwarf2Data, this, debug_aranges);
     
-    // Keep memory down by clearing DIEs if this generate function
-    // caused them to be parsed
-    if (clear_dies)
-        ClearDIEs (true);
+    // Keep memory down by letting the arena evict the DIEs if this
+    // generate function caused them to be parsed
+    if (release_dies)
+        ReleaseDIEs ();
 
 }
 
@@ -472,19 +570,31 @@ DWARFCompileUnit::GetDIEPtr(dw_offset_t die_offset)
     if (die_offset != DW_INVALID_OFFSET)
     {
         ExtractDIEsIfNeeded (false);
-        DWARFDebugInfoEntry compare_die;
-        compare_die.SetOffset(die_offset);
-        DWARFDebugInfoEntry::iterator end = m_die_array.end();
-        DWARFDebugInfoEntry::iterator pos = lower_bound(m_die_array.begin(), end, compare_die, CompareDIEOffset);
-        if (pos != end)
-        {
-            if (die_offset == (*pos).GetOffset())
-                return &(*pos);
-        }
+        return FindDIE (die_offset);
     }
     return NULL;    // Not found in any compile units
 }
 
+//----------------------------------------------------------------------
+// FindDIE()
+//
+// Look up a DIE in the already extracted DIEs.
+//----------------------------------------------------------------------
+DWARFDebugInfoEntry*
+DWARFCompileUnit::FindDIE(dw_offset_t die_offset)
+{
+    DWARFDebugInfoEntry compare_die;
+    compare_die.SetOffset(die_offset);
+    DWARFDebugInfoEntry* end = m_die_array + m_num_dies;
+    DWARFDebugInfoEntry* pos = lower_bound(m_die_array, end, compare_die, CompareDIEOffset);
+    if (pos != end)
+    {
+        if (die_offset == pos->GetOffset())
+            return pos;
+    }
+    return NULL;
+}
+
 //----------------------------------------------------------------------
 // GetDIEPtrContainingOffset()
 //
@@ -499,13 +609,13 @@ DWARFCompileUnit::GetDIEPtrContainingOffset(dw_offset_t die_offset)
         ExtractDIEsIfNeeded (false);
         DWARFDebugInfoEntry compare_die;
         compare_die.SetOffset(die_offset);
-        DWARFDebugInfoEntry::iterator end = m_die_array.end();
-        DWARFDebugInfoEntry::iterator pos = lower_bound(m_die_array.begin(), end, compare_die, CompareDIEOffset);
+        DWARFDebugInfoEntry* end = m_die_array + m_num_dies;
+        DWARFDebugInfoEntry* pos = lower_bound(m_die_array, end, compare_die, CompareDIEOffset);
         if (pos != end)
         {
             if (die_offset >= (*pos).GetOffset())
             {
-                DWARFDebugInfoEntry::iterator next = pos + 1;
+                DWARFDebugInfoEntry* next = pos + 1;
                 if (next != end)
                 {
                     if (die_offset < (*next).GetOffset())
@@ -523,9 +633,9 @@ size_t
 DWARFCompileUnit::AppendDIEsWithTag (const dw_tag_t tag, DWARFDIECollection& dies, uint32_t depth) const
 {
     size_t old_size = dies.Size();
-    DWARFDebugInfoEntry::const_iterator pos;
-    DWARFDebugInfoEntry::const_iterator end = m_die_array.end();
-    for (pos = m_die_array.begin(); pos != end; ++pos)
+    const DWARFDebugInfoEntry* pos;
+    const DWARFDebugInfoEntry* end = m_die_array + m_num_dies;
+    for (pos = m_die_array; pos != end; ++pos)
     {
         if (pos->Tag() == tag)
             dies.Append (&(*pos));
@@ -567,7 +677,8 @@ DWARFCompileUnit::Index (const uint32_t cu_idx,
                          NameToDIE& objc_class_selectors,
                          NameToDIE& globals,
                          NameToDIE& types,
-                         NameToDIE& namespaces)
+                         NameToDIE& namespaces,
+                         ExternalSpecificationColl& external_specifications)
 {
     const DataExtractor* debug_str = &m_dwarf2Data->get_debug_str_data();
 
@@ -582,9 +693,9 @@ DWARFCompileUnit::Index (const uint32_t cu_idx,
                                                                 GetOffset());
     }
 
-    DWARFDebugInfoEntry::const_iterator pos;
-    DWARFDebugInfoEntry::const_iterator begin = m_die_array.begin();
-    DWARFDebugInfoEntry::const_iterator end = m_die_array.end();
+    const DWARFDebugInfoEntry* pos;
+    const DWARFDebugInfoEntry* begin = m_die_array;
+    const DWARFDebugInfoEntry* end = m_die_array + m_num_dies;
     for (pos = begin; pos != end; ++pos)
     {
         const DWARFDebugInfoEntry &die = *pos;
@@ -754,6 +865,7 @@ DWARFCompileUnit::Index (const uint32_t cu_idx,
                     // is usually the method name without the class or any parameters
                     const DWARFDebugInfoEntry *parent = die.GetParent();
                     bool is_method = false;
+                    bool is_external_specification = false;
                     if (parent)
                     {
                         dw_tag_t parent_tag = parent->Tag();
@@ -763,9 +875,15 @@ DWARFCompileUnit::Index (const uint32_t cu_idx,
                         }
                         else
                         {
-                            if (specification_die_offset != DW_INVALID_OFFSET)
+                            if (specification_die_offset != DW_INVALID_OFFSET && !ContainsDIEOffset (specification_die_offset))
+                            {
+                                ExternalSpecification external_spec = { name, die.GetOffset(), specification_die_offset };
+                                external_specifications.push_back (external_spec);
+                                is_external_specification = true;
+                            }
+                            else if (specification_die_offset != DW_INVALID_OFFSET)
                             {
-                                const DWARFDebugInfoEntry *specification_die = m_dwarf2Data->DebugInfo()->GetDIEPtr (specification_die_offset, NULL);
+                                const DWARFDebugInfoEntry *specification_die = FindDIE (specification_die_offset);
                                 if (specification_die)
                                 {
                                     parent = specification_die->GetParent();
@@ -782,7 +900,9 @@ DWARFCompileUnit::Index (const uint32_t cu_idx,
                     }
 
 
-                    if (is_method)
+                    if (is_external_specification)
+                        ; // Added by the caller once the specification is resolved
+                    else if (is_method)
                         func_methods.Insert (ConstString(name), die.GetOffset());
                     else
                         func_basenames.Insert (ConstString(name), die.GetOffset());
@@ -11,6 +11,7 @@
 #define SymbolFileDWARF_DWARFCompileUnit_h_
 
 #include "DWARFDebugInfoEntry.h"
+#include "DWARFDIEArena.h"
 #include "SymbolFileDWARF.h"
 
 class NameToDIE;
@@ -19,10 +20,22 @@ class DWARFCompileUnit
 {
 public:
     DWARFCompileUnit(SymbolFileDWARF* dwarf2Data);
+    ~DWARFCompileUnit();
 
     bool        Extract(const lldb_private::DataExtractor &debug_info, uint32_t* offset_ptr);
     dw_offset_t Extract(dw_offset_t offset, const lldb_private::DataExtractor& debug_info_data, const DWARFAbbreviationDeclarationSet* abbrevs);
     size_t      ExtractDIEsIfNeeded (bool cu_die_only);
+
+    //------------------------------------------------------------------
+    // Extract all DIEs for a single pass over them that doesn't keep
+    // any DIE pointers around (indexing, building address ranges).
+    // Returns true if the caller must call ReleaseDIEs() when done,
+    // which hands the DIEs to the symbol file's DIE arena to evict
+    // them when they aren't used again. Any ExtractDIEsIfNeeded() call
+    // in between keeps the DIEs around for good.
+    //------------------------------------------------------------------
+    bool        ExtractDIEsForScan ();
+    void        ReleaseDIEs ();
     bool        LookupAddress(
                     const dw_addr_t address,
                     DWARFDebugInfoEntry** function_die,
@@ -59,7 +72,7 @@ public:
     GetCompileUnitDIEOnly()
     {
         ExtractDIEsIfNeeded (true);
-        if (m_die_array.empty())
+        if (m_num_dies == 0)
             return NULL;
         return &m_die_array[0];
     }
@@ -68,32 +81,24 @@ public:
     DIE()
     {
         ExtractDIEsIfNeeded (false);
-        if (m_die_array.empty())
+        if (m_num_dies == 0)
             return NULL;
         return &m_die_array[0];
     }
 
     void
-    AddDIE (DWARFDebugInfoEntry& die)
-    {
-        // The average bytes per DIE entry has been seen to be
-        // around 14-20 so lets pre-reserve half of that since
-        // we are now stripping the NULL tags. 
-
-        // Only reserve the memory if we are adding children of
-        // the main compile unit DIE. The compile unit DIE is always
-        // the first entry, so if our size is 1, then we are adding
-        // the first compile unit child DIE and should reserve
-        // the memory.
-        if (m_die_array.empty())
-            m_die_array.reserve(GetDebugInfoSize() / 24);
-        m_die_array.push_back(die);
-    }
+    AddDIE (DWARFDebugInfoEntry& die);
 
     bool
     HasDIEsParsed () const
     {
-        return m_die_array.size() > 1;
+        return m_num_dies > 1;
+    }
+
+    size_t
+    GetDIEArrayByteSize () const
+    {
+        return m_die_array_capacity * sizeof(DWARFDebugInfoEntry);
     }
 
     DWARFDebugInfoEntry*
@@ -130,6 +135,20 @@ public:
     }
 
 
+    //------------------------------------------------------------------
+    // A function DIE whose DW_AT_specification lives in another compile
+    // unit. Index() doesn't touch other compile units since they may be
+    // being indexed on other threads, so it hands these back to the
+    // caller to add to either the method or the basename index.
+    //------------------------------------------------------------------
+    struct ExternalSpecification
+    {
+        const char *name;
+        dw_offset_t die_offset;
+        dw_offset_t specification_die_offset;
+    };
+    typedef std::vector<ExternalSpecification> ExternalSpecificationColl;
+
 //    void
 //    AddGlobalDIEByIndex (uint32_t die_idx);
 //
@@ -145,7 +164,8 @@ public:
            NameToDIE& objc_class_selectors,
            NameToDIE& globals,
            NameToDIE& types,
-           NameToDIE& namespaces);
+           NameToDIE& namespaces,
+           ExternalSpecificationColl& external_specifications);
 
     const DWARFDebugAranges &
     GetFunctionAranges ();
@@ -157,10 +177,26 @@ public:
     }
 
 protected:
+    friend class DWARFDIEArena;
+
+    size_t
+    ExtractDIEs (bool cu_die_only);
+
+    void
+    SetDIEs (const DWARFDebugInfoEntry *dies, uint32_t num_dies);
+
+    DWARFDebugInfoEntry*
+    FindDIE (dw_offset_t die_offset);
+
     SymbolFileDWARF*    m_dwarf2Data;
     const DWARFAbbreviationDeclarationSet *m_abbrevs;
     void *              m_user_data;
-    DWARFDebugInfoEntry::collection m_die_array;    // The compile unit debug information entry item
+    DWARFDebugInfoEntry* m_die_array;   // The compile unit debug information entries, allocated from the symbol file's DIE arena
+    uint32_t            m_num_dies;
+    uint32_t            m_die_array_capacity;
+    DWARFDIEArena::CompileUnitList::iterator m_arena_pos;  // Our entry in the LRU list when m_dies_evictable is set, guarded by the list's lock
+    bool                m_dies_pinned;      // Set once DIE pointers may have been handed out
+    bool                m_dies_evictable;   // Set while on the LRU list, guarded by the list's lock
     std::auto_ptr<DWARFDebugAranges> m_func_aranges_ap;   // A table similar to the .debug_aranges table, but this one points to the exact DW_TAG_subprogram DIEs
     dw_addr_t           m_base_addr;
     dw_offset_t         m_offset;
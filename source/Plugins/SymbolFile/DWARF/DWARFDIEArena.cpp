@@ -0,0 +1,199 @@
+//===-- DWARFDIEArena.cpp ---------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "DWARFDIEArena.h"
+
+#include <assert.h>
+
+#include "lldb/Core/Log.h"
+
+#include "DWARFCompileUnit.h"
+#include "DWARFDebugInfoEntry.h"
+#include "LogChannelDWARF.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+namespace {
+
+    // The LRU list of scanned compile units from all symbol files.
+    struct EvictableCompileUnits
+    {
+        EvictableCompileUnits () :
+            mutex (Mutex::eMutexTypeRecursive),
+            cus (),
+            byte_size (0),
+            max_byte_size (SIZE_MAX),
+            disable_count (0)
+        {
+        }
+
+        Mutex mutex;
+        DWARFDIEArena::CompileUnitList cus;    // Least recently used first
+        size_t byte_size;
+        size_t max_byte_size;
+        uint32_t disable_count;
+    };
+
+}
+
+static EvictableCompileUnits &
+GetEvictableCompileUnits ()
+{
+    // Leaked on purpose so that symbol files torn down during exit can
+    // still take their compile units off the list.
+    static EvictableCompileUnits *g_evictable_cus = new EvictableCompileUnits();
+    return *g_evictable_cus;
+}
+
+DWARFDIEArena::DWARFDIEArena () :
+    m_mutex (Mutex::eMutexTypeNormal),
+    m_allocator (),
+    m_free_blocks (),
+    m_num_evictions (0)
+{
+}
+
+DWARFDIEArena::~DWARFDIEArena ()
+{
+    LogSP log (LogChannelDWARF::GetLogIfAll (DWARF_LOG_DEBUG_INFO | DWARF_LOG_VERBOSE));
+    if (log)
+        log->Printf ("DWARFDIEArena::~DWARFDIEArena() %llu bytes allocated, %u compile units evicted",
+                     (uint64_t)m_allocator.getTotalMemory(),
+                     m_num_evictions);
+}
+
+DWARFDebugInfoEntry *
+DWARFDIEArena::Allocate (uint32_t num_dies, uint32_t &capacity)
+{
+    if (num_dies == 0)
+        num_dies = 1;
+
+    Mutex::Locker locker (m_mutex);
+
+    // Reuse the smallest free block that fits unless it would waste more
+    // than a quarter of its size.
+    FreeBlockMap::iterator pos = m_free_blocks.lower_bound (num_dies);
+    if (pos != m_free_blocks.end() && pos->first <= num_dies + num_dies / 4)
+    {
+        DWARFDebugInfoEntry *dies = pos->second;
+        capacity = pos->first;
+        m_free_blocks.erase (pos);
+        return dies;
+    }
+
+    capacity = num_dies;
+    return m_allocator.Allocate<DWARFDebugInfoEntry> (num_dies);
+}
+
+void
+DWARFDIEArena::Deallocate (DWARFDebugInfoEntry *dies, uint32_t capacity)
+{
+    if (dies == NULL)
+        return;
+    Mutex::Locker locker (m_mutex);
+    m_free_blocks.insert (std::make_pair (capacity, dies));
+}
+
+void
+DWARFDIEArena::AddEvictable (DWARFCompileUnit *cu)
+{
+    EvictableCompileUnits &evictable = GetEvictableCompileUnits();
+    Mutex::Locker locker (evictable.mutex);
+
+    if (cu->m_dies_evictable)
+        return;
+    cu->m_arena_pos = evictable.cus.insert (evictable.cus.end(), cu);
+    cu->m_dies_evictable = true;
+    evictable.byte_size += cu->GetDIEArrayByteSize();
+
+    // Never evict the compile unit that was just added, the caller is
+    // going to use it.
+    EvictIfNeeded (cu);
+}
+
+bool
+DWARFDIEArena::RemoveEvictable (DWARFCompileUnit *cu)
+{
+    EvictableCompileUnits &evictable = GetEvictableCompileUnits();
+    Mutex::Locker locker (evictable.mutex);
+
+    if (!cu->m_dies_evictable)
+        return false;
+    evictable.cus.erase (cu->m_arena_pos);
+    cu->m_dies_evictable = false;
+    evictable.byte_size -= cu->GetDIEArrayByteSize();
+    return true;
+}
+
+void
+DWARFDIEArena::DisableEviction ()
+{
+    EvictableCompileUnits &evictable = GetEvictableCompileUnits();
+    Mutex::Locker locker (evictable.mutex);
+    ++evictable.disable_count;
+}
+
+void
+DWARFDIEArena::EnableEviction ()
+{
+    EvictableCompileUnits &evictable = GetEvictableCompileUnits();
+    Mutex::Locker locker (evictable.mutex);
+    assert (evictable.disable_count > 0);
+    if (--evictable.disable_count == 0)
+        EvictIfNeeded (NULL);
+}
+
+void
+DWARFDIEArena::SetMaxEvictableByteSize (size_t max_byte_size)
+{
+    EvictableCompileUnits &evictable = GetEvictableCompileUnits();
+    Mutex::Locker locker (evictable.mutex);
+    evictable.max_byte_size = max_byte_size;
+}
+
+size_t
+DWARFDIEArena::GetEvictableByteSize ()
+{
+    EvictableCompileUnits &evictable = GetEvictableCompileUnits();
+    Mutex::Locker locker (evictable.mutex);
+    return evictable.byte_size;
+}
+
+//----------------------------------------------------------------------
+// Evict the least recently used compile units other than "keep_cu"
+// until the list fits the budget. The list lock is held while the DIEs
+// are cleared, so a thread taking a compile unit off the list with
+// RemoveEvictable() either gets it before the eviction starts or sees
+// it already evicted.
+//----------------------------------------------------------------------
+void
+DWARFDIEArena::EvictIfNeeded (DWARFCompileUnit *keep_cu)
+{
+    EvictableCompileUnits &evictable = GetEvictableCompileUnits();
+    Mutex::Locker locker (evictable.mutex);
+
+    if (evictable.disable_count > 0)
+        return;
+
+    LogSP log (LogChannelDWARF::GetLogIfAll (DWARF_LOG_DEBUG_INFO | DWARF_LOG_VERBOSE));
+
+    while (evictable.byte_size > evictable.max_byte_size &&
+           !evictable.cus.empty() &&
+           evictable.cus.front() != keep_cu)
+    {
+        DWARFCompileUnit *lru_cu = evictable.cus.front();
+        RemoveEvictable (lru_cu);
+        if (log)
+            log->Printf ("DWARFDIEArena::EvictIfNeeded() evicting DIEs for compile unit at .debug_info[0x%8.8x]",
+                         lru_cu->GetOffset());
+        lru_cu->ClearDIEs (true);
+        ++lru_cu->GetSymbolFileDWARF()->GetDIEArena().m_num_evictions;
+    }
+}
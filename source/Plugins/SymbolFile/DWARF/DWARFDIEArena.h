@@ -0,0 +1,100 @@
+//===-- DWARFDIEArena.h -----------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SymbolFileDWARF_DWARFDIEArena_h_
+#define SymbolFileDWARF_DWARFDIEArena_h_
+
+#include <list>
+#include <map>
+
+#include "llvm/Support/Allocator.h"
+#include "lldb/lldb-defines.h"
+#include "lldb/Host/Mutex.h"
+
+class DWARFCompileUnit;
+class DWARFDebugInfoEntry;
+
+//----------------------------------------------------------------------
+// Allocates the DIE arrays of all compile units in a symbol file.
+//
+// Arrays are carved out of large slabs and are recycled when a compile
+// unit frees its DIEs, so re-extracting an evicted compile unit
+// typically gets its old block back.
+//
+// Compile units whose DIEs were only extracted to scan them (indexing,
+// building address ranges) are kept on an LRU list instead of being
+// freed right away. The list is shared by all symbol files in the
+// process. Nothing holds on to pointers into these arrays, so once the
+// list uses more than the budget the least recently used compile units
+// get their DIEs cleared.
+//----------------------------------------------------------------------
+class DWARFDIEArena
+{
+public:
+    typedef std::list<DWARFCompileUnit *> CompileUnitList;
+
+    DWARFDIEArena ();
+
+    ~DWARFDIEArena ();
+
+    DWARFDebugInfoEntry *
+    Allocate (uint32_t num_dies, uint32_t &capacity);
+
+    void
+    Deallocate (DWARFDebugInfoEntry *dies, uint32_t capacity);
+
+    //------------------------------------------------------------------
+    // Add a compile unit to the back of the LRU list, evicting other
+    // compile units until the list fits the budget again. Does nothing
+    // if the compile unit is already on the list.
+    //------------------------------------------------------------------
+    static void
+    AddEvictable (DWARFCompileUnit *cu);
+
+    //------------------------------------------------------------------
+    // Take a compile unit off the LRU list. Returns false if it wasn't
+    // on it. Once this returns, no other thread will evict the compile
+    // unit's DIEs until it is added again.
+    //------------------------------------------------------------------
+    static bool
+    RemoveEvictable (DWARFCompileUnit *cu);
+
+    //------------------------------------------------------------------
+    // Stop evicting compile units while DIEs are scanned in parallel.
+    // EnableEviction() must be called once for each DisableEviction()
+    // call and trims the list to the budget when the last one is done.
+    //------------------------------------------------------------------
+    static void
+    DisableEviction ();
+
+    static void
+    EnableEviction ();
+
+    static void
+    SetMaxEvictableByteSize (size_t max_byte_size);
+
+    static size_t
+    GetEvictableByteSize ();
+
+protected:
+    typedef std::multimap<uint32_t, DWARFDebugInfoEntry *> FreeBlockMap;
+
+    static void
+    EvictIfNeeded (DWARFCompileUnit *keep_cu);
+
+    lldb_private::Mutex m_mutex;
+    llvm::BumpPtrAllocator m_allocator;
+    FreeBlockMap m_free_blocks;         // Freed arrays keyed by capacity
+    uint32_t m_num_evictions;
+
+private:
+    DISALLOW_COPY_AND_ASSIGN (DWARFDIEArena);
+};
+
+#endif  // SymbolFileDWARF_DWARFDIEArena_h_
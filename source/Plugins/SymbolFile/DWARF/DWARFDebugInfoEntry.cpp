@@ -148,11 +148,12 @@ DWARFDebugInfoEntry::FastExtract
         }
         m_tag = abbrevDecl->Tag();
         m_has_children = abbrevDecl->HasChildren();
-        // Skip all data in the .debug_info for the attributes
+        // Skip all data in the .debug_info for the attributes. The leading
+        // fixed size attributes are skipped in one go.
         const uint32_t numAttributes = abbrevDecl->NumAttributes();
-        register uint32_t i;
+        register uint32_t i = abbrevDecl->SkipFixedSizeAttributes (numAttributes, cu->GetAddressByteSize(), offset);
         register dw_form_t form;
-        for (i=0; i<numAttributes; ++i)
+        for (; i<numAttributes; ++i)
         {
             form = abbrevDecl->GetFormByIndexUnchecked(i);
 
@@ -1266,7 +1267,7 @@ DWARFDebugInfoEntry::GetAttributeValue
         {
             const DataExtractor& debug_info_data = dwarf2Data->get_debug_info_data();
 
-            uint32_t idx=0;
+            uint32_t idx = abbrevDecl->SkipFixedSizeAttributes (attr_idx, DWARFCompileUnit::GetAddressByteSize(cu), offset);
             while (idx<attr_idx)
                 DWARFFormValue::SkipValue(abbrevDecl->GetFormByIndex(idx++), debug_info_data, &offset, cu);
 
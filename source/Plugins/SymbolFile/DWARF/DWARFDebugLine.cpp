@@ -472,13 +472,14 @@ DWARFDebugLine::ParseSupportFiles(const DataExtractor& debug_line_data, const ch
     uint32_t offset = stmt_list + 4;    // Skip the total length
     const char * s;
     uint32_t version = debug_line_data.GetU16(&offset);
-    if (version != 2)
+    if (version < 2 || version > 4)
       return false;
 
     const dw_offset_t end_prologue_offset = debug_line_data.GetU32(&offset) + offset;
-    // Skip instruction length, default is stmt, line base, line range and
-    // opcode base, and all opcode lengths
-    offset += 4;
+    // Skip instruction length, maximum operations per instruction (version
+    // 4 only), default is stmt, line base and line range, then skip all
+    // opcode lengths
+    offset += version >= 4 ? 5 : 4;
     const uint8_t opcode_base = debug_line_data.GetU8(&offset);
     offset += opcode_base - 1;
     std::vector<std::string> include_directories;
@@ -552,6 +553,51 @@ DWARFDebugLine::ParseSupportFiles(const DataExtractor& debug_line_data, const ch
     return end_prologue_offset;
 }
 
+//----------------------------------------------------------------------
+// ParseFileNames
+//
+// Append the file names from the prologue of the line table at
+// "stmt_list" as they appear in the table, without their directories.
+// The strings point into "debug_line_data".
+//----------------------------------------------------------------------
+bool
+DWARFDebugLine::ParseFileNames(const DataExtractor& debug_line_data, dw_offset_t stmt_list, std::vector<const char *> &file_names)
+{
+    uint32_t offset = stmt_list + 4;    // Skip the total length
+    const char * s;
+    uint32_t version = debug_line_data.GetU16(&offset);
+    if (version < 2 || version > 4)
+      return false;
+
+    const dw_offset_t end_prologue_offset = debug_line_data.GetU32(&offset) + offset;
+    // Skip instruction length, maximum operations per instruction (version
+    // 4 only), default is stmt, line base and line range, then skip all
+    // opcode lengths
+    offset += version >= 4 ? 5 : 4;
+    const uint8_t opcode_base = debug_line_data.GetU8(&offset);
+    offset += opcode_base - 1;
+    while (offset < end_prologue_offset)
+    {
+        s = debug_line_data.GetCStr(&offset);
+        if (s == NULL || s[0] == '\0')
+            break;
+    }
+    while (offset < end_prologue_offset)
+    {
+        const char* path = debug_line_data.GetCStr( &offset );
+        if (path && path[0])
+        {
+            debug_line_data.Skip_LEB128(&offset); // Skip dir_idx
+            debug_line_data.Skip_LEB128(&offset); // Skip mod_time
+            debug_line_data.Skip_LEB128(&offset); // Skip length
+            file_names.push_back(path);
+        }
+        else
+            break;
+    }
+    return offset <= end_prologue_offset;
+}
+
 //----------------------------------------------------------------------
 // ParseStatementTable
 //
@@ -88,7 +88,7 @@ DWARFDebugPubnames::GeneratePubnames(SymbolFileDWARF* dwarf2Data)
 
             const uint8_t *fixed_form_sizes = DWARFFormValue::GetFixedFormSizesForAddressSize (cu->GetAddressByteSize());
 
-            bool clear_dies = cu->ExtractDIEsIfNeeded (false) > 1;
+            bool release_dies = cu->ExtractDIEsForScan ();
 
             DWARFDIECollection dies;
             const size_t die_count = cu->AppendDIEsWithTag (DW_TAG_subprogram, dies) +
@@ -199,10 +199,10 @@ DWARFDebugPubnames::GeneratePubnames(SymbolFileDWARF* dwarf2Data)
                 m_sets.push_back(pubnames_set);
             }
             
-            // Keep memory down by clearing DIEs if this generate function
-            // caused them to be parsed
-            if (clear_dies)
-                cu->ClearDIEs (true);
+            // Keep memory down by letting the DIEs be evicted if this
+            // generate function caused them to be parsed
+            if (release_dies)
+                cu->ReleaseDIEs ();
         }
     }
     if (m_sets.empty())
@@ -296,3 +296,29 @@ DWARFDebugPubnames::Find(const RegularExpression& regex, std::vector<dw_offset_t
 
     return !die_offsets.empty();
 }
+
+void
+DWARFDebugPubnames::AppendCompileUnitsByName (NameToDIE &name_to_cu_offset) const
+{
+    const_iterator pos;
+    const_iterator end = m_sets.end();
+
+    for (pos = m_sets.begin(); pos != end; ++pos)
+    {
+        const dw_offset_t cu_offset = pos->GetHeader().die_offset;
+        const uint32_t num_descriptors = pos->NumDescriptors();
+        for (uint32_t i = 0; i < num_descriptors; ++i)
+        {
+            const char *name = pos->GetDescriptor(i)->name.c_str();
+            if (name[0] == '\0')
+                continue;
+            name_to_cu_offset.Insert (ConstString(name), cu_offset);
+
+            // Some producers emit qualified names, so also add the base
+            // name which is what most lookups start with.
+            const char *base_name = strrchr (name, ':');
+            if (base_name && base_name > name && base_name[-1] == ':' && base_name[1] != '\0')
+                name_to_cu_offset.Insert (ConstString(base_name + 1), cu_offset);
+        }
+    }
+}
@@ -27,6 +27,9 @@ public:
     void    Dump(lldb_private::Log *s) const;
     bool    Find(const char* name, bool ignore_case, std::vector<dw_offset_t>& die_offset_coll) const;
     bool    Find(const lldb_private::RegularExpression& regex, std::vector<dw_offset_t>& die_offsets) const;
+
+    // Map each name to the offset of the compile unit that defines it.
+    void    AppendCompileUnitsByName(NameToDIE &name_to_cu_offset) const;
 protected:
     typedef std::list<DWARFDebugPubnamesSet>    collection;
     typedef collection::iterator                iterator;
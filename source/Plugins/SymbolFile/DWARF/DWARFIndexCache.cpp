@@ -0,0 +1,381 @@
+//===-- DWARFIndexCache.cpp -------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "DWARFIndexCache.h"
+
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <sys/time.h>
+#include <unistd.h>
+
+#include <algorithm>
+#include <string>
+#include <vector>
+
+#include "llvm/ADT/DenseMap.h"
+
+#include "lldb/Core/ArchSpec.h"
+#include "lldb/Core/ConstString.h"
+#include "lldb/Core/DataBuffer.h"
+#include "lldb/Core/DataExtractor.h"
+#include "lldb/Core/Log.h"
+#include "lldb/Core/Module.h"
+#include "lldb/Core/UUID.h"
+#include "lldb/Host/File.h"
+#include "lldb/Host/FileSpec.h"
+#include "lldb/Host/Host.h"
+#include "lldb/Host/TimeValue.h"
+#include "lldb/Symbol/ObjectFile.h"
+#include "lldb/Target/Target.h"
+
+#include "LogChannelDWARF.h"
+#include "NameToDIE.h"
+
+using namespace lldb;
+using namespace lldb_private;
+
+//----------------------------------------------------------------------
+// Cache file layout, all values in host byte order:
+//
+//  Header
+//  uint32_t entry_count[num_indexes]
+//  { uint32_t strx; uint32_t die_offset; } entries[sum of entry counts]
+//  char string_table[string_table_size]
+//
+// Entries of each index are grouped by name so that each name only has
+// to be added to the ConstString pool once when the file is loaded.
+//----------------------------------------------------------------------
+static const char g_cache_magic[8] = { 'L', 'L', 'D', 'B', 'D', 'I', 'D', 'X' };
+static const uint32_t g_cache_version = 1;
+static const uint32_t g_cache_byte_order_mark = 0x01020304;
+static const char *g_cache_file_suffix = ".dwarfindex";
+
+namespace {
+
+    struct CacheHeader
+    {
+        char magic[8];
+        uint32_t version;
+        uint32_t byte_order_mark;
+        uint64_t file_size;
+        uint64_t mod_time;
+        uint64_t object_offset;
+        uint8_t uuid[16];
+        uint32_t num_indexes;
+        uint32_t string_table_size;
+    };
+
+    struct CacheFileInfo
+    {
+        std::string path;
+        uint64_t size;
+        time_t mod_time;
+
+        bool
+        operator < (const CacheFileInfo &rhs) const
+        {
+            return mod_time < rhs.mod_time;
+        }
+    };
+
+}
+
+static void
+AppendBytes (std::vector<uint8_t> &buffer, const void *bytes, size_t size)
+{
+    const uint8_t *src = (const uint8_t *)bytes;
+    buffer.insert (buffer.end(), src, src + size);
+}
+
+static void
+AppendU32 (std::vector<uint8_t> &buffer, uint32_t value)
+{
+    AppendBytes (buffer, &value, sizeof(value));
+}
+
+bool
+DWARFIndexCache::GetCacheFile (ObjectFile &objfile, FileSpec &cache_file, Key &key)
+{
+    const FileSpec cache_dir (Target::GetIndexCachePath());
+    if (!cache_dir)
+        return false;
+
+    const FileSpec &file_spec = objfile.GetFileSpec();
+    char path[PATH_MAX];
+    if (file_spec.GetPath (path, sizeof(path)) == 0)
+        return false;
+
+    ::memset (&key, 0, sizeof(key));
+    key.file_size = file_spec.GetByteSize();
+    key.mod_time = file_spec.GetModificationTime().GetAsSecondsSinceJan1_1970();
+    key.object_offset = objfile.GetOffset();
+
+    // Name the file after the UUID if there is one, else after a FNV-1a
+    // hash of the object file path. Object files without a UUID (ELF)
+    // still get a unique name per path, and the key below rejects a
+    // cache file once the object file at that path changes.
+    char name[64];
+    UUID uuid;
+    if (objfile.GetUUID (&uuid) && uuid.IsValid())
+    {
+        ::memcpy (key.uuid, uuid.GetBytes(), sizeof(key.uuid));
+        if (uuid.GetAsCString (name, sizeof(name)) == 0)
+            return false;
+    }
+    else
+    {
+        uint64_t hash = 14695981039346656037ull;
+        for (const char *p = path; *p; ++p)
+            hash = (hash ^ (uint8_t)*p) * 1099511628211ull;
+        ::snprintf (name, sizeof(name), "%16.16llx", hash);
+    }
+
+    char cache_dir_path[PATH_MAX];
+    if (cache_dir.GetPath (cache_dir_path, sizeof(cache_dir_path)) == 0)
+        return false;
+
+    std::string cache_path (cache_dir_path);
+    cache_path.append ("/");
+    cache_path.append (name);
+    cache_path.append ("-");
+    cache_path.append (file_spec.GetFilename().AsCString("unknown"));
+    cache_path.append (g_cache_file_suffix);
+    cache_file.SetFile (cache_path.c_str(), false);
+    return true;
+}
+
+bool
+DWARFIndexCache::Load (ObjectFile &objfile, NameToDIE **indexes, uint32_t num_indexes)
+{
+    FileSpec cache_file;
+    Key key;
+    if (!GetCacheFile (objfile, cache_file, key) || !cache_file.Exists())
+        return false;
+
+    LogSP log (LogChannelDWARF::GetLogIfAll (DWARF_LOG_DEBUG_INFO));
+
+    DataBufferSP data_sp (cache_file.MemoryMapFileContents());
+    if (!data_sp || data_sp->GetByteSize() < sizeof(CacheHeader))
+        return false;
+
+    const uint8_t *bytes = data_sp->GetBytes();
+    const uint64_t byte_size = data_sp->GetByteSize();
+    CacheHeader header;
+    ::memcpy (&header, bytes, sizeof(header));
+    if (::memcmp (header.magic, g_cache_magic, sizeof(g_cache_magic)) != 0 ||
+        header.version != g_cache_version ||
+        header.byte_order_mark != g_cache_byte_order_mark ||
+        header.num_indexes != num_indexes)
+        return false;
+
+    if (header.file_size != key.file_size ||
+        header.mod_time != key.mod_time ||
+        header.object_offset != key.object_offset ||
+        ::memcmp (header.uuid, key.uuid, sizeof(key.uuid)) != 0)
+    {
+        if (log)
+            objfile.GetModule()->LogMessage (log.get(), "DWARFIndexCache::Load() cache file is out of date");
+        return false;
+    }
+
+    DataExtractor data (data_sp, lldb::endian::InlHostByteOrder(), sizeof(void *));
+    uint32_t offset = sizeof(CacheHeader);
+    std::vector<uint32_t> entry_counts (num_indexes);
+    uint64_t total_entries = 0;
+    for (uint32_t i = 0; i < num_indexes; ++i)
+    {
+        entry_counts[i] = data.GetU32 (&offset);
+        total_entries += entry_counts[i];
+    }
+
+    const uint64_t entries_offset = offset;
+    const uint64_t strtab_offset = entries_offset + total_entries * 2 * sizeof(uint32_t);
+    if (strtab_offset + header.string_table_size != byte_size ||
+        header.string_table_size == 0 ||
+        bytes[byte_size - 1] != '\0')
+        return false;
+
+    // Add each name in the string table to the ConstString pool once, no
+    // matter how many entries or indexes refer to it.
+    typedef llvm::DenseMap<uint32_t, ConstString> OffsetToNameMap;
+    OffsetToNameMap names;
+    const char *strtab = (const char *)bytes + strtab_offset;
+    for (uint32_t strx = 0; strx < header.string_table_size; )
+    {
+        const size_t len = ::strlen (strtab + strx);
+        names[strx].SetCStringWithLength (strtab + strx, len);
+        strx += len + 1;
+    }
+
+    for (uint32_t i = 0; i < num_indexes; ++i)
+    {
+        indexes[i]->Reserve (entry_counts[i]);
+        for (uint32_t j = 0; j < entry_counts[i]; ++j)
+        {
+            const uint32_t strx = data.GetU32 (&offset);
+            const uint32_t die_offset = data.GetU32 (&offset);
+            OffsetToNameMap::const_iterator pos = names.find (strx);
+            if (pos == names.end())
+            {
+                for (uint32_t k = 0; k <= i; ++k)
+                    *indexes[k] = NameToDIE();
+                return false;
+            }
+            indexes[i]->Insert (pos->second, die_offset);
+        }
+        indexes[i]->Finalize();
+    }
+
+    // Mark the file as recently used.
+    char path[PATH_MAX];
+    if (cache_file.GetPath (path, sizeof(path)))
+        ::utimes (path, NULL);
+
+    if (log)
+        objfile.GetModule()->LogMessage (log.get(), "DWARFIndexCache::Load() loaded %llu entries from %s", total_entries, path);
+    return true;
+}
+
+bool
+DWARFIndexCache::Save (ObjectFile &objfile, NameToDIE *const *indexes, uint32_t num_indexes)
+{
+    FileSpec cache_file;
+    Key key;
+    if (!GetCacheFile (objfile, cache_file, key))
+        return false;
+
+    // Build the string table, giving each unique name a single entry.
+    typedef llvm::DenseMap<const char *, uint32_t> StringToOffsetMap;
+    StringToOffsetMap string_offsets;
+    std::vector<uint8_t> strtab;
+    std::vector<uint8_t> entries;
+    std::vector<uint32_t> entry_counts (num_indexes);
+    for (uint32_t i = 0; i < num_indexes; ++i)
+    {
+        const NameToDIE &index = *indexes[i];
+        const uint32_t size = index.GetSize();
+        entry_counts[i] = size;
+        for (uint32_t j = 0; j < size; ++j)
+        {
+            const char *cstr = index.GetCStringAtIndex(j);
+            std::pair<StringToOffsetMap::iterator, bool> insert_result =
+                string_offsets.insert (std::make_pair (cstr, (uint32_t)strtab.size()));
+            if (insert_result.second)
+                AppendBytes (strtab, cstr, ::strlen(cstr) + 1);
+            AppendU32 (entries, insert_result.first->second);
+            AppendU32 (entries, index.GetDIEOffsetAtIndex(j));
+        }
+    }
+    if (strtab.empty())
+        strtab.push_back ('\0');
+
+    CacheHeader header;
+    ::memset (&header, 0, sizeof(header));
+    ::memcpy (header.magic, g_cache_magic, sizeof(g_cache_magic));
+    header.version = g_cache_version;
+    header.byte_order_mark = g_cache_byte_order_mark;
+    header.file_size = key.file_size;
+    header.mod_time = key.mod_time;
+    header.object_offset = key.object_offset;
+    ::memcpy (header.uuid, key.uuid, sizeof(header.uuid));
+    header.num_indexes = num_indexes;
+    header.string_table_size = strtab.size();
+
+    std::vector<uint8_t> buffer;
+    buffer.reserve (sizeof(header) + num_indexes * sizeof(uint32_t) + entries.size() + strtab.size());
+    AppendBytes (buffer, &header, sizeof(header));
+    for (uint32_t i = 0; i < num_indexes; ++i)
+        AppendU32 (buffer, entry_counts[i]);
+    buffer.insert (buffer.end(), entries.begin(), entries.end());
+    buffer.insert (buffer.end(), strtab.begin(), strtab.end());
+
+    char cache_dir_path[PATH_MAX];
+    char path[PATH_MAX];
+    if (cache_file.GetDirectory().IsEmpty() ||
+        cache_file.GetPath (path, sizeof(path)) == 0)
+        return false;
+    ::snprintf (cache_dir_path, sizeof(cache_dir_path), "%s", cache_file.GetDirectory().GetCString());
+    if (::mkdir (cache_dir_path, 0755) != 0 && errno != EEXIST)
+        return false;
+
+    // Write to a temporary file and rename it into place so that other
+    // debuggers never see a partially written cache file.
+    char temp_path[PATH_MAX];
+    ::snprintf (temp_path, sizeof(temp_path), "%s.%llu.tmp", path, (uint64_t)Host::GetCurrentProcessID());
+    File file;
+    Error error (file.Open (temp_path,
+                            File::eOpenOptionWrite | File::eOpenOptionCanCreate | File::eOpenOptionTruncate,
+                            File::ePermissionsUserRW | File::ePermissionsGroupRead | File::ePermissionsWorldRead));
+    if (error.Fail())
+        return false;
+
+    size_t num_bytes = buffer.size();
+    error = file.Write (&buffer[0], num_bytes);
+    file.Close();
+    if (error.Fail() || num_bytes != buffer.size() || ::rename (temp_path, path) != 0)
+    {
+        ::unlink (temp_path);
+        return false;
+    }
+
+    LogSP log (LogChannelDWARF::GetLogIfAll (DWARF_LOG_DEBUG_INFO));
+    if (log)
+        objfile.GetModule()->LogMessage (log.get(), "DWARFIndexCache::Save() wrote %zu bytes to %s", buffer.size(), path);
+
+    Prune (FileSpec (cache_dir_path, false), Target::GetIndexCacheMaxSize());
+    return true;
+}
+
+static FileSpec::EnumerateDirectoryResult
+CollectCacheFiles (void *baton, FileSpec::FileType file_type, const FileSpec &spec)
+{
+    std::vector<CacheFileInfo> *files = (std::vector<CacheFileInfo> *)baton;
+    const char *filename = spec.GetFilename().GetCString();
+    const size_t suffix_len = ::strlen (g_cache_file_suffix);
+    const size_t filename_len = filename ? ::strlen (filename) : 0;
+    if (filename_len <= suffix_len || ::strcmp (filename + filename_len - suffix_len, g_cache_file_suffix) != 0)
+        return FileSpec::eEnumerateDirectoryResultNext;
+
+    char path[PATH_MAX];
+    struct stat file_stat;
+    if (spec.GetPath (path, sizeof(path)) && ::stat (path, &file_stat) == 0)
+    {
+        CacheFileInfo info;
+        info.path = path;
+        info.size = file_stat.st_size;
+        info.mod_time = file_stat.st_mtime;
+        files->push_back (info);
+    }
+    return FileSpec::eEnumerateDirectoryResultNext;
+}
+
+void
+DWARFIndexCache::Prune (const FileSpec &cache_dir, uint64_t max_size)
+{
+    char cache_dir_path[PATH_MAX];
+    if (cache_dir.GetPath (cache_dir_path, sizeof(cache_dir_path)) == 0)
+        return;
+
+    std::vector<CacheFileInfo> files;
+    FileSpec::EnumerateDirectory (cache_dir_path, false, true, false, CollectCacheFiles, &files);
+
+    uint64_t total_size = 0;
+    for (size_t i = 0; i < files.size(); ++i)
+        total_size += files[i].size;
+
+    // Remove the least recently used files first.
+    std::sort (files.begin(), files.end());
+    for (size_t i = 0; i < files.size() && total_size > max_size; ++i)
+    {
+        if (::unlink (files[i].path.c_str()) == 0)
+            total_size -= files[i].size;
+    }
+}
@@ -0,0 +1,64 @@
+//===-- DWARFIndexCache.h ---------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef SymbolFileDWARF_DWARFIndexCache_h_
+#define SymbolFileDWARF_DWARFIndexCache_h_
+
+#include "lldb/lldb-private.h"
+
+class NameToDIE;
+
+//----------------------------------------------------------------------
+// Saves the name indexes built by SymbolFileDWARF::Index() to disk and
+// loads them back in later debug sessions.
+//
+// Cache files live in the directory named by the "target.index-cache-path"
+// setting. A cache file is named after the UUID of the object file (or a
+// hash of its path when it has no UUID) and is only used if the size,
+// modification time and offset of the object file it was built from still
+// match. Using a cache file marks it as recently used, and the least
+// recently used files are removed when the cache grows beyond the
+// "target.index-cache-max-size" setting.
+//----------------------------------------------------------------------
+class DWARFIndexCache
+{
+public:
+    // Fill in "num_indexes" empty indexes from the cache file for
+    // "objfile". Returns true if the indexes were loaded and finalized.
+    static bool
+    Load (lldb_private::ObjectFile &objfile,
+          NameToDIE **indexes,
+          uint32_t num_indexes);
+
+    // Save "num_indexes" finalized indexes to the cache file for
+    // "objfile", then trim the cache to its maximum size.
+    static bool
+    Save (lldb_private::ObjectFile &objfile,
+          NameToDIE *const *indexes,
+          uint32_t num_indexes);
+
+private:
+    struct Key
+    {
+        uint64_t file_size;
+        uint64_t mod_time;
+        uint64_t object_offset;
+        uint8_t uuid[16];
+    };
+
+    static bool
+    GetCacheFile (lldb_private::ObjectFile &objfile,
+                  lldb_private::FileSpec &cache_file,
+                  Key &key);
+
+    static void
+    Prune (const lldb_private::FileSpec &cache_dir, uint64_t max_size);
+};
+
+#endif  // SymbolFileDWARF_DWARFIndexCache_h_
@@ -23,16 +23,30 @@ using namespace lldb;
 using namespace lldb_private;
 
 void
-NameToDIE::Finalize()
+NameToDIE::Finalize(uint32_t sorted_size)
 {
-    m_map.Sort ();
+    // Entries with the same name are ordered by DIE offset so lookups
+    // return the same results no matter how the index was built.
+    m_map.SortByCStringThenValue (sorted_size);
     m_map.SizeToFit ();
+    m_trigrams.Clear ();
+}
+
+void
+NameToDIE::Append (const NameToDIE& name_to_die)
+{
+    const uint32_t size = name_to_die.m_map.GetSize();
+    m_map.Reserve (m_map.GetSize() + size);
+    for (uint32_t i=0; i<size; ++i)
+        m_map.Append (name_to_die.m_map.GetCStringAtIndex(i), name_to_die.m_map.GetValueAtIndexUnchecked(i));
+    m_trigrams.Clear ();
 }
 
 void
 NameToDIE::Insert (const ConstString& name, uint32_t die_offset)
 {
     m_map.Append(name.GetCString(), die_offset);
+    m_trigrams.Clear ();
 }
 
 size_t
@@ -44,7 +58,35 @@ NameToDIE::Find (const ConstString &name, DIEArray &info_array) const
 size_t
 NameToDIE::Find (const RegularExpression& regex, DIEArray &info_array) const
 {
-    return m_map.GetValues (regex, info_array);
+    // Only names containing the literal text of the regular expression
+    // need to be run through it. Candidates come back in map order so
+    // the results are the same as checking every name.
+    std::vector<uint32_t> candidates;
+    bool use_candidates;
+    {
+        // Several threads can look up names in the same index at once.
+        Mutex::Locker locker (m_trigrams_mutex);
+        if (!m_trigrams.IsFinalized())
+        {
+            const uint32_t size = m_map.GetSize();
+            for (uint32_t i=0; i<size; ++i)
+                m_trigrams.Append (i, m_map.GetCStringAtIndex(i));
+            m_trigrams.Finalize ();
+        }
+        use_candidates = m_trigrams.GetCandidates (regex, candidates);
+    }
+    if (!use_candidates)
+        return m_map.GetValues (regex, info_array);
+
+    const size_t initial_size = info_array.size();
+    const size_t num_candidates = candidates.size();
+    for (size_t i=0; i<num_candidates; ++i)
+    {
+        const uint32_t idx = candidates[i];
+        if (regex.Execute (m_map.GetCStringAtIndex(idx)))
+            info_array.push_back (m_map.GetValueAtIndexUnchecked(idx));
+    }
+    return info_array.size() - initial_size;
 }
 
 size_t
@@ -10,7 +10,9 @@
 #ifndef SymbolFileDWARF_NameToDIE_h_
 #define SymbolFileDWARF_NameToDIE_h_
 
+#include "lldb/Core/TrigramIndex.h"
 #include "lldb/Core/UniqueCStringMap.h"
+#include "lldb/Host/Mutex.h"
 #include "lldb/lldb-defines.h"
 
 class SymbolFileDWARF;
@@ -21,9 +23,30 @@ class NameToDIE
 {
 public:
     NameToDIE () :   
-        m_map()
+        m_map(),
+        m_trigrams(),
+        m_trigrams_mutex(lldb_private::Mutex::eMutexTypeNormal)
     {
     }
+
+    // The trigram index is rebuilt on demand, so copies don't share it.
+    NameToDIE (const NameToDIE& rhs) :
+        m_map(rhs.m_map),
+        m_trigrams(),
+        m_trigrams_mutex(lldb_private::Mutex::eMutexTypeNormal)
+    {
+    }
+
+    const NameToDIE&
+    operator= (const NameToDIE& rhs)
+    {
+        if (this != &rhs)
+        {
+            m_map = rhs.m_map;
+            m_trigrams.Clear();
+        }
+        return *this;
+    }
     
     ~NameToDIE ()
     {
@@ -35,8 +58,39 @@ public:
     void
     Insert (const lldb_private::ConstString& name, uint32_t die_offset);
 
+    // Sort the map for lookups. Pass the size the map had when it was
+    // last finalized to only sort the entries added since.
     void
-    Finalize();
+    Finalize(uint32_t sorted_size = 0);
+
+    // Append all entries from "name_to_die" to this map. Finalize() must
+    // be called again before doing any lookups.
+    void
+    Append (const NameToDIE& name_to_die);
+
+    void
+    Reserve (size_t n)
+    {
+        m_map.Reserve (n);
+    }
+
+    uint32_t
+    GetSize () const
+    {
+        return m_map.GetSize();
+    }
+
+    const char *
+    GetCStringAtIndex (uint32_t idx) const
+    {
+        return m_map.GetCStringAtIndex (idx);
+    }
+
+    uint32_t
+    GetDIEOffsetAtIndex (uint32_t idx) const
+    {
+        return m_map.GetValueAtIndexUnchecked (idx);
+    }
 
     size_t
     Find (const lldb_private::ConstString &name, 
@@ -53,6 +107,8 @@ public:
 
 protected:
     lldb_private::UniqueCStringMap<uint32_t> m_map;
+    mutable lldb_private::TrigramIndex m_trigrams; // Built on the first regex lookup
+    mutable lldb_private::Mutex m_trigrams_mutex;  // Guards building and reading m_trigrams from const lookups
 
 };
 
@@ -46,6 +46,7 @@
 #include "lldb/Symbol/VariableList.h"
 
 #include "lldb/Target/ObjCLanguageRuntime.h"
+#include "lldb/Target/Target.h"
 #include "lldb/Target/CPPLanguageRuntime.h"
 
 #include "DWARFCompileUnit.h"
@@ -58,6 +59,7 @@
 #include "DWARFDebugRanges.h"
 #include "DWARFDIECollection.h"
 #include "DWARFFormValue.h"
+#include "DWARFIndexCache.h"
 #include "DWARFLocationList.h"
 #include "LogChannelDWARF.h"
 #include "SymbolFileDWARFDebugMap.h"
@@ -179,11 +181,14 @@ SymbolFileDWARF::SymbolFileDWARF(ObjectFile* objfile) :
     m_data_debug_info (),
     m_data_debug_line (),
     m_data_debug_loc (),
+    m_data_debug_pubnames (),
+    m_data_debug_pubtypes (),
     m_data_debug_ranges (),
     m_data_debug_str (),
     m_data_apple_names (),
     m_data_apple_types (),
     m_data_apple_namespaces (),
+    m_die_arena(),
     m_abbr(),
     m_info(),
     m_line(),
@@ -199,9 +204,16 @@ SymbolFileDWARF::SymbolFileDWARF(ObjectFile* objfile) :
     m_global_index(),
     m_type_index(),
     m_namespace_index(),
+    m_pubnames_cu_index(),
+    m_pubtypes_cu_index(),
+    m_indexed_cus(),
+    m_source_file_cu_index(),
+    m_unindexed_source_file_cus(),
     m_indexed (false),
     m_is_external_ast_source (false),
     m_using_apple_tables (false),
+    m_using_pubnames (false),
+    m_indexed_source_files (false),
     m_ranges(),
     m_unique_ast_type_map ()
 {
@@ -252,6 +264,8 @@ SymbolFileDWARF::GetClangASTContext ()
 void
 SymbolFileDWARF::InitializeObject()
 {
+    DWARFDIEArena::SetMaxEvictableByteSize (Target::GetDIECacheMaxSize());
+
     // Install our external AST source callbacks so we can complete Clang types.
     Module *module = m_obj_file->GetModule();
     if (module)
@@ -303,6 +317,26 @@ SymbolFileDWARF::InitializeObject()
         else
             m_apple_objc_ap.reset();
     }
+
+    // Without the apple tables, .debug_pubnames and .debug_pubtypes can
+    // tell us which compile units to index for a given name so we don't
+    // need to index all of them up front.
+    if (!m_using_apple_tables && Target::GetUsePubnamesIndex())
+    {
+        DWARFDebugPubnames pubnames;
+        if (get_debug_pubnames_data().GetByteSize() > 0 && pubnames.Extract (m_data_debug_pubnames))
+        {
+            pubnames.AppendCompileUnitsByName (m_pubnames_cu_index);
+            m_pubnames_cu_index.Finalize();
+            m_using_pubnames = m_pubnames_cu_index.GetSize() > 0;
+        }
+        DWARFDebugPubnames pubtypes;
+        if (m_using_pubnames && get_debug_pubtypes_data().GetByteSize() > 0 && pubtypes.Extract (m_data_debug_pubtypes))
+        {
+            pubtypes.AppendCompileUnitsByName (m_pubtypes_cu_index);
+            m_pubtypes_cu_index.Finalize();
+        }
+    }
 }
 
 bool
@@ -493,6 +527,18 @@ SymbolFileDWARF::get_debug_loc_data()
     return GetCachedSectionData (flagsGotDebugLocData, eSectionTypeDWARFDebugLoc, m_data_debug_loc);
 }
 
+const DataExtractor&
+SymbolFileDWARF::get_debug_pubnames_data()
+{
+    return GetCachedSectionData (flagsGotDebugPubNamesData, eSectionTypeDWARFDebugPubNames, m_data_debug_pubnames);
+}
+
+const DataExtractor&
+SymbolFileDWARF::get_debug_pubtypes_data()
+{
+    return GetCachedSectionData (flagsGotDebugPubTypesData, eSectionTypeDWARFDebugPubTypes, m_data_debug_pubtypes);
+}
+
 const DataExtractor&
 SymbolFileDWARF::get_debug_ranges_data()
 {
@@ -2064,6 +2110,82 @@ SymbolFileDWARF::ResolveSymbolContext (const Address& so_addr, uint32_t resolve_
 
 
 
+//----------------------------------------------------------------------
+// Map the base name of each compile unit's main source file, and of
+// every file in its line table prologue, to the compile unit index.
+// Only the compile unit DIEs and the .debug_line headers are read, so
+// file and line lookups can skip parsing the support files and line
+// tables of compile units that can't contain the file. Compile units
+// whose line table header can't be read are kept aside and returned
+// for every file.
+//----------------------------------------------------------------------
+void
+SymbolFileDWARF::IndexSourceFiles ()
+{
+    if (m_indexed_source_files)
+        return;
+    m_indexed_source_files = true;
+
+    Timer scoped_timer (__PRETTY_FUNCTION__,
+                        "SymbolFileDWARF::IndexSourceFiles (%s)",
+                        GetObjectFile()->GetFileSpec().GetFilename().AsCString());
+
+    DWARFDebugInfo* debug_info = DebugInfo();
+    if (debug_info == NULL)
+        return;
+
+    const DataExtractor &debug_line_data = get_debug_line_data();
+    std::vector<const char *> file_names;
+    DWARFCompileUnit* curr_cu = NULL;
+    for (uint32_t cu_idx = 0; (curr_cu = debug_info->GetCompileUnitAtIndex(cu_idx)) != NULL; ++cu_idx)
+    {
+        const DWARFDebugInfoEntry * cu_die = curr_cu->GetCompileUnitDIEOnly();
+        if (cu_die == NULL)
+            continue;
+
+        file_names.clear();
+        const char *cu_die_name = cu_die->GetAttributeValueAsString(this, curr_cu, DW_AT_name, NULL);
+        if (cu_die_name)
+            file_names.push_back (cu_die_name);
+
+        const dw_offset_t stmt_list = cu_die->GetAttributeValueAsUnsigned(this, curr_cu, DW_AT_stmt_list, DW_INVALID_OFFSET);
+        if (stmt_list != DW_INVALID_OFFSET && !DWARFDebugLine::ParseFileNames (debug_line_data, stmt_list, file_names))
+        {
+            m_unindexed_source_file_cus.push_back (cu_idx);
+            continue;
+        }
+
+        for (size_t i = 0; i < file_names.size(); ++i)
+        {
+            const char *basename = strrchr (file_names[i], '/');
+            basename = basename ? basename + 1 : file_names[i];
+            if (basename[0])
+                m_source_file_cu_index.Insert (ConstString(basename), cu_idx);
+        }
+    }
+    m_source_file_cu_index.Finalize();
+}
+
+bool
+SymbolFileDWARF::FindCompileUnitsForFile (const FileSpec& file_spec, std::vector<uint32_t>& cu_indexes)
+{
+    if (!file_spec.GetFilename())
+        return false;
+
+    IndexSourceFiles ();
+
+    const size_t initial_size = cu_indexes.size();
+    m_source_file_cu_index.Find (file_spec.GetFilename(), cu_indexes);
+    if (!m_unindexed_source_file_cus.empty())
+    {
+        cu_indexes.insert (cu_indexes.end(), m_unindexed_source_file_cus.begin(), m_unindexed_source_file_cus.end());
+        std::sort (cu_indexes.begin() + initial_size, cu_indexes.end());
+    }
+    // The same file often shows up more than once in a line table.
+    cu_indexes.erase (std::unique (cu_indexes.begin() + initial_size, cu_indexes.end()), cu_indexes.end());
+    return true;
+}
+
 uint32_t
 SymbolFileDWARF::ResolveSymbolContext(const FileSpec& file_spec, uint32_t line, bool check_inlines, uint32_t resolve_scope, SymbolContextList& sc_list)
 {
@@ -2073,11 +2195,23 @@ SymbolFileDWARF::ResolveSymbolContext(const FileSpec& file_spec, uint32_t line,
         DWARFDebugInfo* debug_info = DebugInfo();
         if (debug_info)
         {
-            uint32_t cu_idx;
-            DWARFCompileUnit* curr_cu = NULL;
+            // Only visit the compile units that mention the file, in the
+            // same order as checking all of them.
+            std::vector<uint32_t> cu_indexes;
+            if (!FindCompileUnitsForFile (file_spec, cu_indexes))
+            {
+                const uint32_t num_compile_units = debug_info->GetNumCompileUnits();
+                for (uint32_t cu_idx = 0; cu_idx < num_compile_units; ++cu_idx)
+                    cu_indexes.push_back (cu_idx);
+            }
 
-            for (cu_idx = 0; (curr_cu = debug_info->GetCompileUnitAtIndex(cu_idx)) != NULL; ++cu_idx)
+            const size_t num_cu_indexes = cu_indexes.size();
+            for (size_t i = 0; i < num_cu_indexes; ++i)
             {
+                const uint32_t cu_idx = cu_indexes[i];
+                DWARFCompileUnit* curr_cu = debug_info->GetCompileUnitAtIndex(cu_idx);
+                if (curr_cu == NULL)
+                    continue;
                 CompileUnit *dc_cu = GetCompUnitForDWARFCompUnit(curr_cu, cu_idx);
                 bool file_spec_matches_cu_file_spec = dc_cu != NULL && FileSpec::Compare(file_spec, *dc_cu, false) == 0;
                 if (check_inlines || file_spec_matches_cu_file_spec)
@@ -2174,6 +2308,238 @@ SymbolFileDWARF::ResolveSymbolContext(const FileSpec& file_spec, uint32_t line,
     return sc_list.GetSize() - prev_size;
 }
 
+namespace {
+
+    // The name indexes built by SymbolFileDWARF::Index().
+    enum DWARFIndexKind
+    {
+        eIndexFunctionBasename = 0,
+        eIndexFunctionFullname,
+        eIndexFunctionMethod,
+        eIndexFunctionSelector,
+        eIndexObjCClassSelectors,
+        eIndexGlobal,
+        eIndexType,
+        eIndexNamespace,
+        kNumIndexes
+    };
+
+    // The indexes built by a single worker thread.
+    struct DWARFIndexShard
+    {
+        NameToDIE indexes[kNumIndexes];
+        DWARFCompileUnit::ExternalSpecificationColl external_specifications;
+    };
+
+    struct DWARFIndexArgs
+    {
+        DWARFDebugInfo *debug_info;
+        const uint32_t *cu_indexes;
+        DWARFIndexShard *shards;
+        size_t num_shards;
+        NameToDIE **indexes;
+    };
+
+}
+
+static void
+IndexCompileUnit (void *baton, uint32_t worker_idx, size_t task_idx)
+{
+    DWARFIndexArgs *args = (DWARFIndexArgs *)baton;
+    DWARFIndexShard &shard = args->shards[worker_idx];
+    const uint32_t cu_idx = args->cu_indexes[task_idx];
+    DWARFCompileUnit* curr_cu = args->debug_info->GetCompileUnitAtIndex(cu_idx);
+
+    bool release_dies = curr_cu->ExtractDIEsForScan ();
+
+    curr_cu->Index (cu_idx,
+                    shard.indexes[eIndexFunctionBasename],
+                    shard.indexes[eIndexFunctionFullname],
+                    shard.indexes[eIndexFunctionMethod],
+                    shard.indexes[eIndexFunctionSelector],
+                    shard.indexes[eIndexObjCClassSelectors],
+                    shard.indexes[eIndexGlobal],
+                    shard.indexes[eIndexType],
+                    shard.indexes[eIndexNamespace],
+                    shard.external_specifications);
+
+    // Keep memory down by letting the DIEs be evicted if this generate
+    // function caused them to be parsed. Until then later lookups in
+    // this compile unit don't have to parse them again.
+    if (release_dies)
+        curr_cu->ReleaseDIEs ();
+}
+
+static void
+MergeIndexShards (void *baton, uint32_t worker_idx, size_t index_kind)
+{
+    DWARFIndexArgs *args = (DWARFIndexArgs *)baton;
+    NameToDIE &index = *args->indexes[index_kind];
+    const uint32_t sorted_size = index.GetSize();
+    for (size_t i = 0; i < args->num_shards; ++i)
+        index.Append (args->shards[i].indexes[index_kind]);
+
+    // Compile units indexed on demand usually only add to a few of the
+    // indexes. Leave the others alone and only sort in the new entries.
+    if (index.GetSize() != sorted_size)
+        index.Finalize (sorted_size);
+}
+
+void
+SymbolFileDWARF::GetNameIndexes (NameToDIE **indexes)
+{
+    indexes[eIndexFunctionBasename]     = &m_function_basename_index;
+    indexes[eIndexFunctionFullname]     = &m_function_fullname_index;
+    indexes[eIndexFunctionMethod]       = &m_function_method_index;
+    indexes[eIndexFunctionSelector]     = &m_function_selector_index;
+    indexes[eIndexObjCClassSelectors]   = &m_objc_class_selectors_index;
+    indexes[eIndexGlobal]               = &m_global_index;
+    indexes[eIndexType]                 = &m_type_index;
+    indexes[eIndexNamespace]            = &m_namespace_index;
+}
+
+void
+SymbolFileDWARF::IndexCompileUnits (const std::vector<uint32_t> &cu_indexes)
+{
+    DWARFDebugInfo* debug_info = DebugInfo();
+    if (debug_info == NULL || cu_indexes.empty())
+        return;
+
+    const uint32_t num_compile_units = GetNumCompileUnits();
+    if (m_indexed_cus.size() < num_compile_units)
+        m_indexed_cus.resize (num_compile_units, false);
+    for (size_t i = 0; i < cu_indexes.size(); ++i)
+    {
+        assert (!m_indexed_cus[cu_indexes[i]]);
+        m_indexed_cus[cu_indexes[i]] = true;
+    }
+
+    // Load the sections the workers read from up front since they are
+    // lazily loaded and not protected by any locks.
+    get_debug_info_data();
+    get_debug_str_data();
+
+    // Each worker indexes into its own shard, so the workers never
+    // contend on anything but the ConstString pool.
+    uint32_t num_workers = Host::GetNumberOfCPUs();
+    if (num_workers > cu_indexes.size())
+        num_workers = cu_indexes.size();
+    std::vector<DWARFIndexShard> shards (num_workers);
+    DWARFIndexArgs index_args = { debug_info, &cu_indexes[0], &shards[0], shards.size(), NULL };
+
+    // Evicting a compile unit clears its DIEs, which must not happen
+    // while another worker is scanning them. Let the LRU list grow while
+    // the workers run and trim it once they are all done.
+    DWARFDIEArena::DisableEviction ();
+    Host::ParallelForEach ("<lldb.dwarf.index>",
+                           num_workers,
+                           cu_indexes.size(),
+                           IndexCompileUnit,
+                           &index_args);
+    DWARFDIEArena::EnableEviction ();
+
+    // Functions whose specification lives in another compile unit can
+    // only be classified once all compile units have been indexed.
+    DWARFIndexShard &first_shard = shards.front();
+    for (size_t i = 0; i < shards.size(); ++i)
+    {
+        const DWARFCompileUnit::ExternalSpecificationColl &external_specs = shards[i].external_specifications;
+        for (size_t j = 0; j < external_specs.size(); ++j)
+        {
+            const DWARFCompileUnit::ExternalSpecification &external_spec = external_specs[j];
+            bool is_method = false;
+            const DWARFDebugInfoEntry *specification_die = debug_info->GetDIEPtr (external_spec.specification_die_offset, NULL);
+            if (specification_die)
+            {
+                const DWARFDebugInfoEntry *parent = specification_die->GetParent();
+                if (parent)
+                {
+                    const dw_tag_t parent_tag = parent->Tag();
+                    is_method = parent_tag == DW_TAG_class_type || parent_tag == DW_TAG_structure_type;
+                }
+            }
+            first_shard.indexes[is_method ? eIndexFunctionMethod : eIndexFunctionBasename].Insert (ConstString(external_spec.name),
+                                                                                                   external_spec.die_offset);
+        }
+    }
+
+    // Merge the shards into the name indexes and sort each of them on its
+    // own thread. Finalize() orders entries by name and then by DIE offset,
+    // so the result doesn't depend on how compile units were spread
+    // across the workers or on the order they were indexed in.
+    NameToDIE *indexes[kNumIndexes];
+    GetNameIndexes (indexes);
+    DWARFIndexArgs merge_args = { debug_info, NULL, &shards[0], shards.size(), indexes };
+    Host::ParallelForEach ("<lldb.dwarf.index>",
+                           0,
+                           kNumIndexes,
+                           MergeIndexShards,
+                           &merge_args);
+}
+
+void
+SymbolFileDWARF::IndexForName (const ConstString &name, bool is_type_name)
+{
+    if (m_indexed)
+        return;
+
+    // Without .debug_pubnames/.debug_pubtypes tables there is no way of
+    // telling which compile units define a name.
+    const NameToDIE &pubnames_index = is_type_name ? m_pubtypes_cu_index : m_pubnames_cu_index;
+    if (!m_using_pubnames || pubnames_index.GetSize() == 0)
+    {
+        Index ();
+        return;
+    }
+
+    DWARFDebugInfo* debug_info = DebugInfo();
+    if (debug_info == NULL || !name)
+        return;
+
+    DIEArray cu_offsets;
+    pubnames_index.Find (name, cu_offsets);
+
+    // Producers leave static functions and other internal names out of
+    // .debug_pubnames, so a name that isn't listed may still be defined
+    // somewhere. Fall back to indexing every compile unit.
+    if (cu_offsets.empty())
+    {
+        Index ();
+        return;
+    }
+
+    std::vector<uint32_t> cu_indexes;
+    for (size_t i = 0; i < cu_offsets.size(); ++i)
+    {
+        uint32_t cu_idx = UINT32_MAX;
+        if (debug_info->GetCompileUnit (cu_offsets[i], &cu_idx) &&
+            (cu_idx >= m_indexed_cus.size() || !m_indexed_cus[cu_idx]))
+            cu_indexes.push_back (cu_idx);
+    }
+    std::sort (cu_indexes.begin(), cu_indexes.end());
+    cu_indexes.erase (std::unique (cu_indexes.begin(), cu_indexes.end()), cu_indexes.end());
+    IndexCompileUnits (cu_indexes);
+}
+
+void
+SymbolFileDWARF::IndexForCompileUnit (DWARFCompileUnit *dwarf_cu)
+{
+    if (m_indexed)
+        return;
+
+    if (!m_using_pubnames)
+    {
+        Index ();
+        return;
+    }
+
+    uint32_t cu_idx = UINT32_MAX;
+    DWARFDebugInfo* debug_info = DebugInfo();
+    if (debug_info && debug_info->GetCompileUnit (dwarf_cu->GetOffset(), &cu_idx) &&
+        (cu_idx >= m_indexed_cus.size() || !m_indexed_cus[cu_idx]))
+        IndexCompileUnits (std::vector<uint32_t> (1, cu_idx));
+}
+
 void
 SymbolFileDWARF::Index ()
 {
@@ -2184,41 +2550,30 @@ SymbolFileDWARF::Index ()
                         "SymbolFileDWARF::Index (%s)",
                         GetObjectFile()->GetFileSpec().GetFilename().AsCString());
 
+    NameToDIE *indexes[kNumIndexes];
+    GetNameIndexes (indexes);
+
+    // Use the indexes from a previous session if the object file hasn't
+    // changed since. The cache can't be merged with compile units that
+    // have already been indexed on demand.
+    const bool partially_indexed = std::find (m_indexed_cus.begin(), m_indexed_cus.end(), true) != m_indexed_cus.end();
+    if (!partially_indexed && DWARFIndexCache::Load (*GetObjectFile(), indexes, kNumIndexes))
+        return;
+
     DWARFDebugInfo* debug_info = DebugInfo();
     if (debug_info)
     {
-        uint32_t cu_idx = 0;
         const uint32_t num_compile_units = GetNumCompileUnits();
-        for (cu_idx = 0; cu_idx < num_compile_units; ++cu_idx)
+        std::vector<uint32_t> cu_indexes;
+        cu_indexes.reserve (num_compile_units);
+        for (uint32_t cu_idx = 0; cu_idx < num_compile_units; ++cu_idx)
         {
-            DWARFCompileUnit* curr_cu = debug_info->GetCompileUnitAtIndex(cu_idx);
-
-            bool clear_dies = curr_cu->ExtractDIEsIfNeeded (false) > 1;
-
-            curr_cu->Index (cu_idx,
-                            m_function_basename_index,
-                            m_function_fullname_index,
-                            m_function_method_index,
-                            m_function_selector_index,
-                            m_objc_class_selectors_index,
-                            m_global_index, 
-                            m_type_index,
-                            m_namespace_index);
-            
-            // Keep memory down by clearing DIEs if this generate function
-            // caused them to be parsed
-            if (clear_dies)
-                curr_cu->ClearDIEs (true);
+            if (cu_idx >= m_indexed_cus.size() || !m_indexed_cus[cu_idx])
+                cu_indexes.push_back (cu_idx);
         }
-        
-        m_function_basename_index.Finalize();
-        m_function_fullname_index.Finalize();
-        m_function_method_index.Finalize();
-        m_function_selector_index.Finalize();
-        m_objc_class_selectors_index.Finalize();
-        m_global_index.Finalize(); 
-        m_type_index.Finalize();
-        m_namespace_index.Finalize();
+        IndexCompileUnits (cu_indexes);
+
+        DWARFIndexCache::Save (*GetObjectFile(), indexes, kNumIndexes);
 
 #if defined (ENABLE_DEBUG_PRINTF)
         StreamFile s(stdout, false);
@@ -2369,7 +2724,7 @@ SymbolFileDWARF::FindGlobalVariables (const ConstString &name, const lldb_privat
     {
         // Index the DWARF if we haven't already
         if (!m_indexed)
-            Index ();
+            IndexForName (name, false);
 
         m_global_index.Find (name, die_offsets);
     }
@@ -2885,9 +3240,18 @@ SymbolFileDWARF::FindFunctions (const ConstString &name,
     else
     {
 
-        // Index the DWARF if we haven't already
+        // Index the DWARF if we haven't already. Selectors and mangled names
+        // aren't listed in .debug_pubnames.
         if (!m_indexed)
-            Index ();
+        {
+            if ((effective_name_type_mask & eFunctionNameTypeSelector) || CPPLanguageRuntime::IsCPPMangledName (name_cstr))
+                Index ();
+            else
+            {
+                IndexForName (name, false);
+                IndexForName (ConstString (base_name_start, base_name_end - base_name_start), false);
+            }
+        }
 
         if (name_type_mask & eFunctionNameTypeFull)
             FindFunctions (name, m_function_fullname_index, sc_list);
@@ -3051,7 +3415,7 @@ SymbolFileDWARF::FindTypes (const SymbolContext& sc,
     else
     {
         if (!m_indexed)
-            Index ();
+            IndexForName (name, true);
         
         m_type_index.Find (name, die_offsets);
     }
@@ -3869,7 +4233,7 @@ SymbolFileDWARF::FindCompleteObjCDefinitionTypeForDIE (DWARFCompileUnit* cu,
     else
     {
         if (!m_indexed)
-            Index ();
+            IndexForName (type_name, true);
         
         m_type_index.Find (type_name, die_offsets);
     }
@@ -3995,7 +4359,7 @@ SymbolFileDWARF::FindDefinitionTypeForDIE (DWARFCompileUnit* cu,
     else
     {
         if (!m_indexed)
-            Index ();
+            IndexForName (type_name, true);
         
         m_type_index.Find (type_name, die_offsets);
     }
@@ -5392,7 +5756,7 @@ SymbolFileDWARF::ParseVariablesForContext (const SymbolContext& sc)
                     // Index if we already haven't to make sure the compile units
                     // get indexed and make their global DIE index list
                     if (!m_indexed)
-                        Index ();
+                        IndexForCompileUnit (dwarf_cu);
 
                     m_global_index.FindAllEntriesForCompileUnit (dwarf_cu->GetOffset(), 
                                                                  dwarf_cu->GetNextCompileUnitOffset(), 
@@ -5992,10 +6356,11 @@ SymbolFileDWARF::SearchDeclContext (const clang::DeclContext *decl_context,
         }
         else
         {
+            ConstString type_name (name);
             if (!m_indexed)
-                Index ();
+                IndexForName (type_name, true);
             
-            m_type_index.Find (ConstString(name), die_offsets);
+            m_type_index.Find (type_name, die_offsets);
         }
         
         const size_t num_matches = die_offsets.size();
@@ -34,6 +34,7 @@
 
 // Project includes
 #include "DWARFDefines.h"
+#include "DWARFDIEArena.h"
 #include "HashedNameToDIE.h"
 #include "NameToDIE.h"
 #include "UniqueDWARFASTType.h"
@@ -109,6 +110,7 @@ public:
 
     virtual uint32_t        ResolveSymbolContext (const lldb_private::Address& so_addr, uint32_t resolve_scope, lldb_private::SymbolContext& sc);
     virtual uint32_t        ResolveSymbolContext (const lldb_private::FileSpec& file_spec, uint32_t line, bool check_inlines, uint32_t resolve_scope, lldb_private::SymbolContextList& sc_list);
+    virtual bool            FindCompileUnitsForFile (const lldb_private::FileSpec& file_spec, std::vector<uint32_t>& cu_indexes);
     virtual uint32_t        FindGlobalVariables(const lldb_private::ConstString &name, const lldb_private::ClangNamespaceDecl *namespace_decl, bool append, uint32_t max_matches, lldb_private::VariableList& variables);
     virtual uint32_t        FindGlobalVariables(const lldb_private::RegularExpression& regex, bool append, uint32_t max_matches, lldb_private::VariableList& variables);
     virtual uint32_t        FindFunctions(const lldb_private::ConstString &name, const lldb_private::ClangNamespaceDecl *namespace_decl, uint32_t name_type_mask, bool append, lldb_private::SymbolContextList& sc_list);
@@ -165,6 +167,8 @@ public:
     const lldb_private::DataExtractor&      get_debug_info_data ();
     const lldb_private::DataExtractor&      get_debug_line_data ();
     const lldb_private::DataExtractor&      get_debug_loc_data ();
+    const lldb_private::DataExtractor&      get_debug_pubnames_data ();
+    const lldb_private::DataExtractor&      get_debug_pubtypes_data ();
     const lldb_private::DataExtractor&      get_debug_ranges_data ();
     const lldb_private::DataExtractor&      get_debug_str_data ();
     const lldb_private::DataExtractor&      get_apple_names_data ();
@@ -179,6 +183,8 @@ public:
     DWARFDebugInfo*         DebugInfo();
     const DWARFDebugInfo*   DebugInfo() const;
 
+    DWARFDIEArena&          GetDIEArena() { return m_die_arena; }
+
     DWARFDebugRanges*       DebugRanges();
     const DWARFDebugRanges* DebugRanges() const;
 
@@ -389,6 +395,11 @@ protected:
     uint32_t                FindTypes(std::vector<dw_offset_t> die_offsets, uint32_t max_matches, lldb_private::TypeList& types);
 
     void                    Index();
+    void                    GetNameIndexes (NameToDIE **indexes);
+    void                    IndexCompileUnits (const std::vector<uint32_t> &cu_indexes);
+    void                    IndexForName (const lldb_private::ConstString &name, bool is_type_name);
+    void                    IndexForCompileUnit (DWARFCompileUnit *dwarf_cu);
+    void                    IndexSourceFiles ();
     
     void                    DumpIndexes();
 
@@ -474,6 +485,8 @@ protected:
     lldb_private::DataExtractor     m_data_debug_info;
     lldb_private::DataExtractor     m_data_debug_line;
     lldb_private::DataExtractor     m_data_debug_loc;
+    lldb_private::DataExtractor     m_data_debug_pubnames;
+    lldb_private::DataExtractor     m_data_debug_pubtypes;
     lldb_private::DataExtractor     m_data_debug_ranges;
     lldb_private::DataExtractor     m_data_debug_str;
     lldb_private::DataExtractor     m_data_apple_names;
@@ -481,6 +494,9 @@ protected:
     lldb_private::DataExtractor     m_data_apple_namespaces;
     lldb_private::DataExtractor     m_data_apple_objc;
 
+    // Owns the DIEs of all compile units, so it must outlive m_info.
+    DWARFDIEArena                       m_die_arena;
+
     // The auto_ptr items below are generated on demand if and when someone accesses
     // them through a non const version of this class.
     std::auto_ptr<DWARFDebugAbbrev>     m_abbr;
@@ -498,9 +514,16 @@ protected:
     NameToDIE                           m_global_index;             // Global and static variables
     NameToDIE                           m_type_index;               // All type DIE offsets
     NameToDIE                           m_namespace_index;          // All type DIE offsets
+    NameToDIE                           m_pubnames_cu_index;        // Compile unit offsets for each name in .debug_pubnames
+    NameToDIE                           m_pubtypes_cu_index;        // Compile unit offsets for each name in .debug_pubtypes
+    std::vector<bool>                   m_indexed_cus;              // Compile units already added to the name indexes
+    NameToDIE                           m_source_file_cu_index;     // Compile unit indexes for each source file base name
+    std::vector<uint32_t>               m_unindexed_source_file_cus; // Compile units whose line table header couldn't be read, they may contain any file
     bool m_indexed:1,
          m_is_external_ast_source:1,
-         m_using_apple_tables:1;
+         m_using_apple_tables:1,
+         m_using_pubnames:1,
+         m_indexed_source_files:1;
 
     std::auto_ptr<DWARFDebugRanges>     m_ranges;
     UniqueDWARFASTTypeMap m_unique_ast_type_map;
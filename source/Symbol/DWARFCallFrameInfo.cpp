@@ -37,6 +37,13 @@ DWARFCallFrameInfo::DWARFCallFrameInfo(ObjectFile& objfile, SectionSP& section,
     m_cfi_data_initialized (false),
     m_fde_index (),
     m_fde_index_initialized (false),
+    m_hdr_data (),
+    m_hdr_file_addr (LLDB_INVALID_ADDRESS),
+    m_hdr_table_offset (0),
+    m_hdr_fde_count (0),
+    m_hdr_table_enc (DW_EH_PE_omit),
+    m_hdr_table_value_size (0),
+    m_hdr_initialized (false),
     m_is_eh_frame (is_eh_frame)
 {
 }
@@ -70,6 +77,11 @@ DWARFCallFrameInfo::GetFDEEntryByAddress (Address addr, FDEEntry& fde_entry)
 {
     if (m_section.get() == NULL || m_section->IsEncrypted())
         return false;
+
+    // Only scan the whole section if there is no .eh_frame_hdr to search
+    if (GetEHFrameHeader())
+        return GetFDEEntryFromEHFrameHeader (addr, fde_entry);
+
     GetFDEIndex();
 
     struct FDEEntry searchfde;
@@ -102,6 +114,21 @@ DWARFCallFrameInfo::GetCIE(dw_offset_t cie_offset)
 {
     cie_map_t::iterator pos = m_cie_map.find(cie_offset);
 
+    if (pos == m_cie_map.end() && m_fde_index_initialized == false)
+    {
+        // GetFDEIndex() finds every CIE up front, but FDEs found without
+        // it get their CIE parsed the first time it is needed.
+        if (m_cfi_data_initialized == false)
+            GetCFIData();
+        dw_offset_t offset = cie_offset + 4;
+        if (!m_cfi_data.ValidOffsetForDataOfSize (cie_offset, CFI_HEADER_SIZE))
+            return NULL;
+        const dw_offset_t cie_id = m_cfi_data.GetU32 (&offset);
+        if (cie_id != (m_is_eh_frame ? 0 : UINT32_MAX))
+            return NULL;
+        pos = m_cie_map.insert (cie_map_t::value_type (cie_offset, CIESP())).first;
+    }
+
     if (pos != m_cie_map.end())
     {
         // Parse and cache the CIE
@@ -343,6 +370,159 @@ DWARFCallFrameInfo::GetFDEIndex ()
     m_fde_index_initialized = true;
 }
 
+// The .eh_frame_hdr section (PT_GNU_EH_FRAME in the program headers)
+// holds a table of (initial location, FDE address) pairs sorted by
+// location, which the runtime unwinder uses to find FDEs without
+// parsing .eh_frame. We can use it the same way.
+
+bool
+DWARFCallFrameInfo::GetEHFrameHeader ()
+{
+    if (m_hdr_initialized)
+        return m_hdr_fde_count > 0;
+    m_hdr_initialized = true;
+
+    if (!m_is_eh_frame)
+        return false;
+
+    SectionList *section_list = m_objfile.GetSectionList();
+    if (section_list == NULL)
+        return false;
+
+    static ConstString g_sect_name_eh_frame_hdr (".eh_frame_hdr");
+    SectionSP hdr_section_sp (section_list->FindSectionByName (g_sect_name_eh_frame_hdr));
+    if (hdr_section_sp.get() == NULL || hdr_section_sp->IsEncrypted())
+        return false;
+    if (hdr_section_sp->ReadSectionDataFromObjectFile (&m_objfile, m_hdr_data) == 0)
+        return false;
+    m_hdr_file_addr = hdr_section_sp->GetFileAddress();
+
+    uint32_t offset = 0;
+    if (!m_hdr_data.ValidOffsetForDataOfSize (offset, 4))
+        return false;
+    const uint8_t version = m_hdr_data.GetU8 (&offset);
+    const uint8_t eh_frame_ptr_enc = m_hdr_data.GetU8 (&offset);
+    const uint8_t fde_count_enc = m_hdr_data.GetU8 (&offset);
+    const uint8_t table_enc = m_hdr_data.GetU8 (&offset);
+    if (version != 1)
+        return false;
+
+    const lldb::addr_t eh_frame_addr = m_hdr_data.GetGNUEHPointer (&offset, eh_frame_ptr_enc, m_hdr_file_addr, LLDB_INVALID_ADDRESS, m_hdr_file_addr);
+    const uint64_t fde_count = m_hdr_data.GetGNUEHPointer (&offset, fde_count_enc, m_hdr_file_addr, LLDB_INVALID_ADDRESS, m_hdr_file_addr);
+    // Make sure the table describes our .eh_frame
+    if (eh_frame_addr != m_section->GetFileAddress())
+        return false;
+
+    // We can only binary search a table of fixed size values that don't
+    // need to be read from memory
+    uint8_t value_size = 0;
+    switch (table_enc & DW_EH_PE_MASK_ENCODING)
+    {
+        case DW_EH_PE_absptr:   value_size = m_hdr_data.GetAddressByteSize(); break;
+        case DW_EH_PE_udata2:
+        case DW_EH_PE_sdata2:   value_size = 2; break;
+        case DW_EH_PE_udata4:
+        case DW_EH_PE_sdata4:   value_size = 4; break;
+        case DW_EH_PE_udata8:
+        case DW_EH_PE_sdata8:   value_size = 8; break;
+    }
+    switch (table_enc & 0xf0)
+    {
+        case DW_EH_PE_absptr:
+        case DW_EH_PE_pcrel:
+        case DW_EH_PE_datarel:
+            break;
+        default:
+            value_size = 0;
+            break;
+    }
+    if (value_size == 0 || fde_count == 0 || fde_count > UINT32_MAX)
+        return false;
+    if (!m_hdr_data.ValidOffsetForDataOfSize (offset, fde_count * 2 * value_size))
+        return false;
+
+    m_hdr_table_offset = offset;
+    m_hdr_table_enc = table_enc;
+    m_hdr_table_value_size = value_size;
+    m_hdr_fde_count = fde_count;
+
+    LogSP log(GetLogIfAllCategoriesSet (LIBLLDB_LOG_UNWIND));
+    if (log)
+        m_objfile.GetModule()->LogMessage(log.get(), "Using .eh_frame_hdr to find %u FDEs", m_hdr_fde_count);
+    return true;
+}
+
+lldb::addr_t
+DWARFCallFrameInfo::GetEHFrameHeaderTableValue (uint32_t index)
+{
+    uint32_t offset = m_hdr_table_offset + index * m_hdr_table_value_size;
+    return m_hdr_data.GetGNUEHPointer (&offset, m_hdr_table_enc, m_hdr_file_addr, LLDB_INVALID_ADDRESS, m_hdr_file_addr);
+}
+
+bool
+DWARFCallFrameInfo::GetFDEEntryFromEHFrameHeader (Address addr, FDEEntry& fde_entry)
+{
+    const lldb::addr_t file_addr = addr.GetFileAddress();
+    if (file_addr == LLDB_INVALID_ADDRESS)
+        return false;
+
+    // Find the last entry whose initial location is at or before the address
+    uint32_t low = 0;
+    uint32_t high = m_hdr_fde_count;
+    while (low < high)
+    {
+        const uint32_t mid = low + (high - low) / 2;
+        if (GetEHFrameHeaderTableValue (mid * 2) <= file_addr)
+            low = mid + 1;
+        else
+            high = mid;
+    }
+    if (low == 0)
+        return false;
+
+    const lldb::addr_t fde_addr = GetEHFrameHeaderTableValue ((low - 1) * 2 + 1);
+    const lldb::addr_t eh_frame_addr = m_section->GetFileAddress();
+    if (fde_addr < eh_frame_addr)
+        return false;
+
+    FDEEntry fde;
+    if (!ParseFDEEntry (fde_addr - eh_frame_addr, fde))
+        return false;
+    if (!fde.bounds.ContainsFileAddress (addr))
+        return false;
+    fde_entry = fde;
+    return true;
+}
+
+bool
+DWARFCallFrameInfo::ParseFDEEntry (dw_offset_t fde_offset, FDEEntry& fde_entry)
+{
+    if (m_cfi_data_initialized == false)
+        GetCFIData();
+    if (!m_cfi_data.ValidOffsetForDataOfSize (fde_offset, CFI_HEADER_SIZE))
+        return false;
+
+    dw_offset_t offset = fde_offset;
+    const uint32_t length = m_cfi_data.GetU32 (&offset);
+    const dw_offset_t cie_id = m_cfi_data.GetU32 (&offset);
+    if (length == 0 || cie_id == 0 || cie_id == UINT32_MAX)
+        return false;
+
+    const CIE *cie = GetCIE (fde_offset + 4 - cie_id);
+    if (cie == NULL)
+        return false;
+
+    const lldb::addr_t pc_rel_addr = m_section->GetFileAddress();
+    const lldb::addr_t text_addr = LLDB_INVALID_ADDRESS;
+    const lldb::addr_t data_addr = LLDB_INVALID_ADDRESS;
+
+    lldb::addr_t addr = m_cfi_data.GetGNUEHPointer(&offset, cie->ptr_encoding, pc_rel_addr, text_addr, data_addr);
+    lldb::addr_t range_len = m_cfi_data.GetGNUEHPointer(&offset, cie->ptr_encoding & DW_EH_PE_MASK_ENCODING, pc_rel_addr, text_addr, data_addr);
+    fde_entry.bounds = AddressRange (addr, range_len, m_objfile.GetSectionList());
+    fde_entry.offset = fde_offset;
+    return true;
+}
+
 bool
 DWARFCallFrameInfo::FDEToUnwindPlan (dw_offset_t offset, Address startaddr, UnwindPlan& unwind_plan)
 {
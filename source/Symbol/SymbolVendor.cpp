@@ -215,6 +215,15 @@ SymbolVendor::ResolveSymbolContext (const FileSpec& file_spec, uint32_t line, bo
     return 0;
 }
 
+bool
+SymbolVendor::FindCompileUnitsForFile (const FileSpec& file_spec, std::vector<uint32_t>& cu_indexes)
+{
+    Mutex::Locker locker(m_mutex);
+    if (m_sym_file_ap.get())
+        return m_sym_file_ap->FindCompileUnitsForFile(file_spec, cu_indexes);
+    return false;
+}
+
 uint32_t
 SymbolVendor::FindGlobalVariables (const ConstString &name, const ClangNamespaceDecl *namespace_decl, bool append, uint32_t max_matches, VariableList& variables)
 {
@@ -12,6 +12,7 @@
 #include "lldb/Core/Module.h"
 #include "lldb/Core/RegularExpression.h"
 #include "lldb/Core/Timer.h"
+#include "lldb/Host/Host.h"
 #include "lldb/Symbol/ObjectFile.h"
 #include "lldb/Symbol/Symtab.h"
 #include "lldb/Target/ObjCLanguageRuntime.h"
@@ -26,6 +27,8 @@ Symtab::Symtab(ObjectFile *objfile) :
     m_symbols (),
     m_addr_indexes (),
     m_name_to_index (),
+    m_pending_demangle_indexes (),
+    m_name_trigrams (),
     m_mutex (Mutex::eMutexTypeRecursive),
     m_addr_indexes_computed (false),
     m_name_indexes_computed (false)
@@ -60,6 +63,8 @@ Symtab::AddSymbol(const Symbol& symbol)
     // when calling this function to avoid performance issues.
     uint32_t symbol_idx = m_symbols.size();
     m_name_to_index.Clear();
+    m_pending_demangle_indexes.clear();
+    m_name_trigrams.Clear();
     m_addr_indexes.clear();
     m_symbols.push_back(symbol);
     m_addr_indexes_computed = false;
@@ -285,10 +290,11 @@ Symtab::InitNameIndexes()
 #endif
 
         NameToIndexMap::Entry entry;
+        char qualified_name[1024];
 
         for (entry.value = 0; entry.value < count; ++entry.value)
         {
-            const Symbol *symbol = &m_symbols[entry.value];
+            Symbol *symbol = &m_symbols[entry.value];
 
             // Don't let trampolines get into the lookup by name map
             // If we ever need the trampoline symbols to be searchable by name
@@ -298,11 +304,38 @@ Symtab::InitNameIndexes()
             if (symbol->IsTrampoline())
                 continue;
 
-            const Mangled &mangled = symbol->GetMangled();
+            Mangled &mangled = symbol->GetMangled();
             entry.cstring = mangled.GetMangledName().GetCString();
             if (entry.cstring && entry.cstring[0])
                 m_name_to_index.Append (entry);
 
+            // Running every C++ name through the demangler here is what
+            // makes the first lookup in a large library slow. Names without
+            // a parameter list get their demangled name from the mangled
+            // name directly. The demangled names of the others contain
+            // characters a plain identifier can't ("foo(int)", "vtable for
+            // Foo", "A<int>::x"), so they are only needed once a lookup
+            // uses such characters. Local names ("main::x") are the
+            // exception and are still demangled here.
+            if (!mangled.DemangledNameIsCached() && entry.cstring[0] == '_' && entry.cstring[1] == 'Z')
+            {
+                size_t basename_offset = 0;
+                bool is_demangled_name = false;
+                if (Mangled::ExtractQualifiedName (entry.cstring,
+                                                   qualified_name,
+                                                   sizeof(qualified_name),
+                                                   basename_offset,
+                                                   is_demangled_name) && is_demangled_name)
+                {
+                    mangled.SetDemangledName (qualified_name);
+                }
+                else if (entry.cstring[2] != 'Z')
+                {
+                    m_pending_demangle_indexes.push_back (entry.value);
+                    continue;
+                }
+            }
+
             entry.cstring = mangled.GetDemangledName().GetCString();
             if (entry.cstring && entry.cstring[0])
                 m_name_to_index.Append (entry);
@@ -326,6 +359,87 @@ Symtab::InitNameIndexes()
     }
 }
 
+namespace {
+
+    struct DemangleArgs
+    {
+        Symbol *symbols;
+        const uint32_t *indexes;
+        size_t num_indexes;
+    };
+
+}
+
+static const size_t g_demangle_batch_size = 1024;
+
+static void
+DemangleSymbolNames (void *baton, uint32_t worker_idx, size_t task_idx)
+{
+    DemangleArgs *args = (DemangleArgs *)baton;
+    const size_t start = task_idx * g_demangle_batch_size;
+    const size_t end = std::min<size_t> (start + g_demangle_batch_size, args->num_indexes);
+    for (size_t i = start; i < end; ++i)
+        args->symbols[args->indexes[i]].GetMangled().GetDemangledName();
+}
+
+//----------------------------------------------------------------------
+// Returns true if "name" could only be found among the full demangled
+// C++ names, i.e. it has characters that don't appear in mangled names
+// or in the qualified names we extract from them ("foo(int)",
+// "vtable for Foo", "std::vector<int>::size() const", ...).
+//----------------------------------------------------------------------
+static bool
+NameNeedsDemangledNames (const char *name)
+{
+    if (name[0] == '_' && name[1] == 'Z')
+        return false;
+    for (const char *p = name; *p; ++p)
+    {
+        if (!isalnum (*p) && *p != '_' && *p != ':' && *p != '$' && *p != '.')
+            return true;
+    }
+    return false;
+}
+
+//----------------------------------------------------------------------
+// InitDemangledNameIndexes
+//----------------------------------------------------------------------
+void
+Symtab::InitDemangledNameIndexes()
+{
+    // Protected function, no need to lock mutex...
+    if (m_pending_demangle_indexes.empty())
+        return;
+
+    Timer scoped_timer (__PRETTY_FUNCTION__, "%s", __PRETTY_FUNCTION__);
+
+    // Each symbol is only touched by one worker, and the demangled names
+    // end up in the thread safe string pool.
+    DemangleArgs args;
+    args.symbols = &m_symbols[0];
+    args.indexes = &m_pending_demangle_indexes[0];
+    args.num_indexes = m_pending_demangle_indexes.size();
+    const size_t num_batches = (args.num_indexes + g_demangle_batch_size - 1) / g_demangle_batch_size;
+    Host::ParallelForEach ("<lldb.symtab.demangle>",
+                           0,
+                           num_batches,
+                           DemangleSymbolNames,
+                           &args);
+
+    NameToIndexMap::Entry entry;
+    for (size_t i = 0; i < args.num_indexes; ++i)
+    {
+        entry.value = m_pending_demangle_indexes[i];
+        entry.cstring = m_symbols[entry.value].GetMangled().GetDemangledName().GetCString();
+        if (entry.cstring && entry.cstring[0])
+            m_name_to_index.Append (entry);
+    }
+    IndexCollection().swap (m_pending_demangle_indexes);
+
+    m_name_to_index.Sort();
+    m_name_to_index.SizeToFit();
+}
+
 void
 Symtab::AppendSymbolNamesToMap (const IndexCollection &indexes, 
                                 bool add_demangled,
@@ -501,6 +615,8 @@ Symtab::AppendSymbolIndexesWithName (const ConstString& symbol_name, std::vector
         const char *symbol_cstr = symbol_name.GetCString();
         if (!m_name_indexes_computed)
             InitNameIndexes();
+        if (!m_pending_demangle_indexes.empty() && NameNeedsDemangledNames (symbol_cstr))
+            InitDemangledNameIndexes();
 
         return m_name_to_index.GetValues (symbol_cstr, indexes);
     }
@@ -520,6 +636,8 @@ Symtab::AppendSymbolIndexesWithName (const ConstString& symbol_name, Debug symbo
             InitNameIndexes();
 
         const char *symbol_cstr = symbol_name.GetCString();
+        if (!m_pending_demangle_indexes.empty() && NameNeedsDemangledNames (symbol_cstr))
+            InitDemangledNameIndexes();
         
         std::vector<uint32_t> all_name_indexes;
         const size_t name_match_count = m_name_to_index.GetValues (symbol_cstr, all_name_indexes);
@@ -572,28 +690,34 @@ Symtab::AppendSymbolIndexesWithNameAndType (const ConstString& symbol_name, Symb
 }
 
 
-uint32_t
-Symtab::AppendSymbolIndexesMatchingRegExAndType (const RegularExpression &regexp, SymbolType symbol_type, std::vector<uint32_t>& indexes)
+//----------------------------------------------------------------------
+// InitNameTrigramIndex
+//----------------------------------------------------------------------
+void
+Symtab::InitNameTrigramIndex()
 {
-    Mutex::Locker locker (m_mutex);
+    // Protected function, no need to lock mutex...
+    if (m_name_trigrams.IsFinalized())
+        return;
 
-    uint32_t prev_size = indexes.size();
-    uint32_t sym_end = m_symbols.size();
+    Timer scoped_timer (__PRETTY_FUNCTION__, "%s", __PRETTY_FUNCTION__);
 
-    for (int i = 0; i < sym_end; i++)
-    {
-        if (symbol_type == eSymbolTypeAny || m_symbols[i].GetType() == symbol_type)
-        {
-            const char *name = m_symbols[i].GetMangled().GetName().AsCString();
-            if (name)
-            {
-                if (regexp.Execute (name))
-                    indexes.push_back(i);
-            }
-        }
-    }
-    return indexes.size() - prev_size;
+    // Regular expressions are matched against the demangled names, so
+    // get all of them up front on a pool of threads.
+    if (!m_name_indexes_computed)
+        InitNameIndexes();
+    InitDemangledNameIndexes();
 
+    const size_t count = m_symbols.size();
+    for (uint32_t i = 0; i < count; ++i)
+        m_name_trigrams.Append (i, m_symbols[i].GetMangled().GetName().AsCString());
+    m_name_trigrams.Finalize();
+}
+
+uint32_t
+Symtab::AppendSymbolIndexesMatchingRegExAndType (const RegularExpression &regexp, SymbolType symbol_type, std::vector<uint32_t>& indexes)
+{
+    return AppendSymbolIndexesMatchingRegExAndType (regexp, symbol_type, eDebugAny, eVisibilityAny, indexes);
 }
 
 uint32_t
@@ -602,10 +726,18 @@ Symtab::AppendSymbolIndexesMatchingRegExAndType (const RegularExpression &regexp
     Mutex::Locker locker (m_mutex);
 
     uint32_t prev_size = indexes.size();
-    uint32_t sym_end = m_symbols.size();
 
-    for (int i = 0; i < sym_end; i++)
+    // Only symbols whose names contain the literal text of the regular
+    // expression need to be checked. Candidates are sorted by symbol
+    // index so we find the same symbols in the same order as a full scan.
+    InitNameTrigramIndex();
+    std::vector<uint32_t> candidates;
+    const bool use_candidates = m_name_trigrams.GetCandidates (regexp, candidates);
+    const uint32_t sym_end = use_candidates ? candidates.size() : m_symbols.size();
+
+    for (uint32_t n = 0; n < sym_end; n++)
     {
+        const uint32_t i = use_candidates ? candidates[n] : n;
         if (symbol_type == eSymbolTypeAny || m_symbols[i].GetType() == symbol_type)
         {
             if (CheckSymbolAtIndex(i, symbol_debug_type, symbol_visibility) == false)
@@ -17,6 +17,12 @@
 #include "lldb/Symbol/FuncUnwinders.h"
 #include "lldb/Symbol/SymbolContext.h"
 #include "lldb/Symbol/DWARFCallFrameInfo.h"
+#include "lldb/Symbol/Function.h"
+#include "lldb/Symbol/Symbol.h"
+#include "lldb/Target/DynamicLoader.h"
+#include "lldb/Target/Process.h"
+#include "lldb/Target/RegisterContext.h"
+#include "lldb/Target/Thread.h"
 #include "lldb/Target/UnwindAssembly.h"
 
 // There is one UnwindTable object per ObjectFile.
@@ -31,8 +37,11 @@ UnwindTable::UnwindTable (ObjectFile& objfile) :
     m_unwinds (),
     m_initialized (false),
     m_assembly_profiler (NULL),
-    m_eh_frame (NULL)
+    m_eh_frame (NULL),
+    m_fast_unwind_mutex (Mutex::eMutexTypeNormal)
 {
+    m_fast_unwind_misses[0] = 0;
+    m_fast_unwind_misses[1] = 0;
 }
 
 // We can't do some of this initialization when the ObjectFile is running its ctor; delay doing it
@@ -126,3 +135,326 @@ UnwindTable::GetEHFrameInfo ()
     Initialize();
     return m_eh_frame;
 }
+
+//----------------------------------------------------------------------
+// Fast unwind rows
+//----------------------------------------------------------------------
+
+static void
+InitFastUnwindRow (UnwindTable::FastUnwindRow &fast_row, 
+                   addr_t base, 
+                   addr_t size, 
+                   UnwindTable::FastUnwindRow::Type type)
+{
+    ::memset (&fast_row, 0, sizeof(fast_row));
+    fast_row.base = base;
+    fast_row.size = size;
+    fast_row.type = type;
+    fast_row.cfa_reg = LLDB_INVALID_REGNUM;
+}
+
+static bool
+FastUnwindRowBaseLessThan (addr_t file_addr, const UnwindTable::FastUnwindRow &fast_row)
+{
+    return file_addr < fast_row.base;
+}
+
+// A row for an address we know nothing about, made when there's no
+// symbol or function around it to remember the miss for instead.
+static bool
+FastUnwindRowIsMiss (const UnwindTable::FastUnwindRow &fast_row)
+{
+    return fast_row.type == UnwindTable::FastUnwindRow::eTypeNoUnwindInfo && fast_row.size == 1;
+}
+
+// Most one byte misses we keep in each table before throwing them away,
+// code without any symbols could otherwise fill it with one row per pc.
+static const uint32_t g_max_fast_unwind_misses = 4096;
+
+// Finds the row containing "file_addr" in "rows", which must be locked
+bool
+UnwindTable::FindFastUnwindRow (const FastUnwindRows &rows, 
+                                lldb::addr_t file_addr, 
+                                FastUnwindRow &fast_row)
+{
+    FastUnwindRows::const_iterator pos = std::upper_bound (rows.begin(), rows.end(), file_addr, FastUnwindRowBaseLessThan);
+    if (pos == rows.begin())
+        return false;
+    --pos;
+    if (file_addr - pos->base >= pos->size)
+        return false;
+    fast_row = *pos;
+    return true;
+}
+
+bool
+UnwindTable::GetFastUnwindRow (const Address& addr, 
+                               bool frame_zero, 
+                               Thread &thread, 
+                               FastUnwindRow &fast_row)
+{
+    const addr_t file_addr = addr.GetFileAddress();
+    if (file_addr == LLDB_INVALID_ADDRESS)
+        return false;
+
+    Initialize();
+
+    const uint32_t table_idx = frame_zero ? 0 : 1;
+    {
+        Mutex::Locker locker (m_fast_unwind_mutex);
+        if (FindFastUnwindRow (m_fast_unwind_rows[table_idx], file_addr, fast_row))
+            return true;
+    }
+
+    // First time we see this function, compile its rows. This resolves
+    // symbols and may parse unwind info, which can come back to this table
+    // (m_fast_unwind_mutex isn't recursive) and shouldn't hold up other
+    // threads unwinding through it, so do it without the lock. If another
+    // thread compiled the same rows meanwhile, the overlap check below
+    // keeps the ones that got in first.
+    FastUnwindRows new_rows;
+    CompileFastUnwindRows (addr, frame_zero, thread, new_rows);
+
+    Mutex::Locker locker (m_fast_unwind_mutex);
+    FastUnwindRows &rows = m_fast_unwind_rows[table_idx];
+    uint32_t &num_misses = m_fast_unwind_misses[table_idx];
+    if (num_misses >= g_max_fast_unwind_misses)
+    {
+        rows.erase (std::remove_if (rows.begin(), rows.end(), FastUnwindRowIsMiss), rows.end());
+        num_misses = 0;
+    }
+    for (FastUnwindRows::const_iterator new_pos = new_rows.begin(), end = new_rows.end(); new_pos != end; ++new_pos)
+    {
+        FastUnwindRows::iterator insert_pos = std::upper_bound (rows.begin(), rows.end(), new_pos->base, FastUnwindRowBaseLessThan);
+        if (insert_pos != rows.end() && new_pos->base + new_pos->size > insert_pos->base)
+            continue;
+        if (insert_pos != rows.begin())
+        {
+            FastUnwindRows::iterator prev_pos = insert_pos - 1;
+            if (prev_pos->base + prev_pos->size > new_pos->base)
+                continue;
+        }
+        rows.insert (insert_pos, *new_pos);
+        if (FastUnwindRowIsMiss (*new_pos))
+            ++num_misses;
+    }
+    return FindFastUnwindRow (rows, file_addr, fast_row);
+}
+
+void
+UnwindTable::CompileFastUnwindRows (const Address& addr, 
+                                    bool frame_zero, 
+                                    Thread &thread, 
+                                    FastUnwindRows &rows)
+{
+    const addr_t file_addr = addr.GetFileAddress();
+    FastUnwindRow fast_row;
+    InitFastUnwindRow (fast_row, file_addr, 1, FastUnwindRow::eTypeNoUnwindInfo);
+
+    SymbolContext sc;
+    Module *module = m_object_file.GetModule();
+    if (module)
+        module->ResolveSymbolContextForAddress (addr, eSymbolContextFunction | eSymbolContextSymbol, sc);
+
+    // If we end up knowing nothing about the address, say so for all of
+    // the function or symbol it's in, so the next pc in there finds the
+    // row instead of looking again.
+    AddressRange miss_range;
+    if (sc.GetAddressRange (eSymbolContextFunction | eSymbolContextSymbol, 0, false, miss_range))
+    {
+        const addr_t miss_base = miss_range.GetBaseAddress().GetFileAddress();
+        if (miss_base != LLDB_INVALID_ADDRESS && file_addr >= miss_base && file_addr - miss_base < miss_range.GetByteSize())
+            InitFastUnwindRow (fast_row, miss_base, miss_range.GetByteSize(), FastUnwindRow::eTypeNoUnwindInfo);
+    }
+    FuncUnwindersSP func_unwinders_sp (GetFuncUnwindersContainingAddress (addr, sc));
+    if (!func_unwinders_sp)
+    {
+        rows.push_back (fast_row);
+        return;
+    }
+
+    const AddressRange &func_range = func_unwinders_sp->GetFunctionAddressRange();
+    const addr_t func_base = func_range.GetBaseAddress().GetFileAddress();
+    const addr_t func_end = func_base + func_range.GetByteSize();
+    if (func_base == LLDB_INVALID_ADDRESS || file_addr < func_base || file_addr >= func_end)
+    {
+        rows.push_back (fast_row);
+        return;
+    }
+
+    // Unwinding out of _sigtramp needs all of the machinery
+    static ConstString g_sigtramp_name ("_sigtramp");
+    if ((sc.function && sc.function->GetName() == g_sigtramp_name) ||
+        (sc.symbol && sc.symbol->GetName() == g_sigtramp_name))
+    {
+        InitFastUnwindRow (fast_row, func_base, func_end - func_base, FastUnwindRow::eTypeUnsupported);
+        rows.push_back (fast_row);
+        return;
+    }
+
+    // Pick the UnwindPlan the way RegisterContextLLDB does
+    UnwindPlanSP unwind_plan_sp;
+    DynamicLoader *dyld = thread.GetProcess().GetDynamicLoader();
+    if (dyld && dyld->AlwaysRelyOnEHUnwindInfo (sc))
+        unwind_plan_sp = func_unwinders_sp->GetUnwindPlanAtCallSite (-1);
+    if (!unwind_plan_sp && frame_zero)
+        unwind_plan_sp = func_unwinders_sp->GetUnwindPlanAtNonCallSite (thread);
+    if (!unwind_plan_sp)
+        unwind_plan_sp = func_unwinders_sp->GetUnwindPlanAtCallSite (-1);
+    if (!unwind_plan_sp && !frame_zero)
+        unwind_plan_sp = func_unwinders_sp->GetUnwindPlanAtNonCallSite (thread);
+
+    RegisterContextSP reg_ctx_sp (thread.GetRegisterContext());
+    if (!unwind_plan_sp || unwind_plan_sp->GetRowCount() == 0 || !reg_ctx_sp)
+    {
+        InitFastUnwindRow (fast_row, func_base, func_end - func_base, FastUnwindRow::eTypeNoUnwindInfo);
+        rows.push_back (fast_row);
+        return;
+    }
+
+    // Row offsets are from the start of the range the plan was made for,
+    // which may not cover all of the function.  Whatever it doesn't cover
+    // is left to the full unwinder.
+    addr_t plan_base = func_base;
+    addr_t plan_end = func_end;
+    const AddressRange &plan_range = unwind_plan_sp->GetAddressRange();
+    if (plan_range.GetBaseAddress().IsValid() && plan_range.GetByteSize() > 0)
+    {
+        plan_base = plan_range.GetBaseAddress().GetFileAddress();
+        plan_end = plan_base + plan_range.GetByteSize();
+    }
+    const addr_t valid_base = std::max (func_base, plan_base);
+    const addr_t valid_end = std::min (func_end, plan_end);
+
+    addr_t curr_addr = func_base;
+    const int row_count = unwind_plan_sp->GetRowCount();
+    for (int i = 0; i < row_count; ++i)
+    {
+        const UnwindPlan::Row &row = unwind_plan_sp->GetRowAtIndex (i);
+        addr_t row_base = std::max (valid_base, plan_base + row.GetOffset());
+        addr_t row_end = valid_end;
+        if (i + 1 < row_count)
+            row_end = std::min (valid_end, plan_base + unwind_plan_sp->GetRowAtIndex (i + 1).GetOffset());
+        if (row_base < curr_addr)
+            row_base = curr_addr;
+        if (row_base >= row_end)
+            continue;
+
+        if (row_base > curr_addr)
+        {
+            InitFastUnwindRow (fast_row, curr_addr, row_base - curr_addr, FastUnwindRow::eTypeUnsupported);
+            rows.push_back (fast_row);
+        }
+        if (!CompileFastUnwindRow (*unwind_plan_sp, row, *reg_ctx_sp, fast_row))
+            InitFastUnwindRow (fast_row, 0, 0, FastUnwindRow::eTypeUnsupported);
+        fast_row.base = row_base;
+        fast_row.size = row_end - row_base;
+        rows.push_back (fast_row);
+        curr_addr = row_end;
+    }
+    if (curr_addr < func_end)
+    {
+        InitFastUnwindRow (fast_row, curr_addr, func_end - curr_addr, FastUnwindRow::eTypeUnsupported);
+        rows.push_back (fast_row);
+    }
+}
+
+bool
+UnwindTable::CompileFastUnwindRow (const UnwindPlan &unwind_plan,
+                                   const UnwindPlan::Row &row,
+                                   RegisterContext &reg_ctx,
+                                   FastUnwindRow &fast_row)
+{
+    InitFastUnwindRow (fast_row, 0, 0, FastUnwindRow::eTypeCompiled);
+
+    const RegisterKind kind = unwind_plan.GetRegisterKind();
+    uint32_t pc_regnum = LLDB_INVALID_REGNUM;
+    uint32_t ra_regnum = LLDB_INVALID_REGNUM;
+    uint32_t sp_regnum = LLDB_INVALID_REGNUM;
+    uint32_t fp_regnum = LLDB_INVALID_REGNUM;
+    reg_ctx.ConvertBetweenRegisterKinds (eRegisterKindGeneric, LLDB_REGNUM_GENERIC_PC, kind, pc_regnum);
+    reg_ctx.ConvertBetweenRegisterKinds (eRegisterKindGeneric, LLDB_REGNUM_GENERIC_RA, kind, ra_regnum);
+    reg_ctx.ConvertBetweenRegisterKinds (eRegisterKindGeneric, LLDB_REGNUM_GENERIC_SP, kind, sp_regnum);
+    reg_ctx.ConvertBetweenRegisterKinds (eRegisterKindGeneric, LLDB_REGNUM_GENERIC_FP, kind, fp_regnum);
+
+    // The CFA has to be a register we track plus an offset
+    const uint32_t cfa_regnum = row.GetCFARegister();
+    if (cfa_regnum == LLDB_INVALID_REGNUM)
+        return false;
+    if (cfa_regnum == sp_regnum)
+        fast_row.cfa_reg = LLDB_REGNUM_GENERIC_SP;
+    else if (cfa_regnum == fp_regnum)
+        fast_row.cfa_reg = LLDB_REGNUM_GENERIC_FP;
+    else
+        return false;
+    fast_row.cfa_offset = row.GetCFAOffset();
+
+    // The caller's pc is the return address, which must have been saved
+    // on the stack
+    UnwindPlan::Row::RegisterLocation regloc;
+    if (pc_regnum == LLDB_INVALID_REGNUM || !row.GetRegisterInfo (pc_regnum, regloc) || regloc.IsUnspecified())
+    {
+        if (ra_regnum == LLDB_INVALID_REGNUM || !row.GetRegisterInfo (ra_regnum, regloc))
+            return false;
+    }
+    switch (regloc.GetLocationType())
+    {
+        case UnwindPlan::Row::RegisterLocation::atCFAPlusOffset:
+            fast_row.pc_rule = FastUnwindRow::eRuleAtCFAPlusOffset;
+            fast_row.pc_offset = regloc.GetOffset();
+            break;
+        case UnwindPlan::Row::RegisterLocation::undefined:
+            fast_row.pc_rule = FastUnwindRow::eRuleUndefined;
+            break;
+        default:
+            return false;
+    }
+
+    // The caller's stack pointer is the CFA unless we're told otherwise
+    fast_row.sp_rule = FastUnwindRow::eRuleIsCFAPlusOffset;
+    fast_row.sp_offset = 0;
+    if (sp_regnum != LLDB_INVALID_REGNUM && row.GetRegisterInfo (sp_regnum, regloc))
+    {
+        switch (regloc.GetLocationType())
+        {
+            case UnwindPlan::Row::RegisterLocation::unspecified:
+                break;
+            case UnwindPlan::Row::RegisterLocation::same:
+                fast_row.sp_rule = FastUnwindRow::eRuleSame;
+                break;
+            case UnwindPlan::Row::RegisterLocation::atCFAPlusOffset:
+                fast_row.sp_rule = FastUnwindRow::eRuleAtCFAPlusOffset;
+                fast_row.sp_offset = regloc.GetOffset();
+                break;
+            case UnwindPlan::Row::RegisterLocation::isCFAPlusOffset:
+                fast_row.sp_offset = regloc.GetOffset();
+                break;
+            default:
+                return false;
+        }
+    }
+
+    // The frame pointer is callee saved, unchanged unless we're told
+    // where it was saved
+    fast_row.fp_rule = FastUnwindRow::eRuleSame;
+    if (fp_regnum != LLDB_INVALID_REGNUM && row.GetRegisterInfo (fp_regnum, regloc))
+    {
+        switch (regloc.GetLocationType())
+        {
+            case UnwindPlan::Row::RegisterLocation::unspecified:
+            case UnwindPlan::Row::RegisterLocation::same:
+                break;
+            case UnwindPlan::Row::RegisterLocation::atCFAPlusOffset:
+                fast_row.fp_rule = FastUnwindRow::eRuleAtCFAPlusOffset;
+                fast_row.fp_offset = regloc.GetOffset();
+                break;
+            case UnwindPlan::Row::RegisterLocation::isCFAPlusOffset:
+                fast_row.fp_rule = FastUnwindRow::eRuleIsCFAPlusOffset;
+                fast_row.fp_offset = regloc.GetOffset();
+                break;
+            default:
+                return false;
+        }
+    }
+    return true;
+}
@@ -15,6 +15,7 @@
 #include "lldb/Core/DataBufferHeap.h"
 #include "lldb/Core/State.h"
 #include "lldb/Core/Log.h"
+#include "lldb/Core/Stream.h"
 #include "lldb/Target/Process.h"
 
 using namespace lldb;
@@ -25,9 +26,21 @@ using namespace lldb_private;
 //----------------------------------------------------------------------
 MemoryCache::MemoryCache(Process &process) :
     m_process (process),
-    m_cache_line_byte_size (512),
-    m_cache_mutex (Mutex::eMutexTypeRecursive),
-    m_cache ()
+    m_cache_line_byte_size (eDefaultLineByteSize),
+    m_cache_mutex (Mutex::eMutexTypeNormal),
+    m_lines (),
+    m_num_lines (0),
+    m_generation (0),
+    m_slabs (),
+    m_regions (),
+    m_prefetched_blocks (),
+    m_supports_region_info (eLazyBoolCalculate),
+    m_last_fetch_end (LLDB_INVALID_ADDRESS),
+    m_num_sequential_misses (0),
+    m_prefetch_byte_size (0),
+    m_num_stops (0),
+    m_stop_stats (),
+    m_total_stats ()
 {
 }
 
@@ -36,13 +49,77 @@ MemoryCache::MemoryCache(Process &process) :
 //----------------------------------------------------------------------
 MemoryCache::~MemoryCache()
 {
+    for (size_t i = 0; i < m_slabs.size(); ++i)
+        delete [] m_slabs[i];
+}
+
+static inline size_t
+HashLineAddress (addr_t line_addr)
+{
+    // Lines are at least 256 bytes, the low bits carry no information
+    return (size_t)(((line_addr >> 8) * 0x9e3779b97f4a7c15ull) >> 32);
+}
+
+static inline uint32_t
+GetLineSizeIndex (uint32_t line_byte_size)
+{
+    return line_byte_size <= 256 ? 0 : (line_byte_size <= 512 ? 1 : 2);
+}
+
+static void
+DumpMemoryCacheStatistics (Stream *s, 
+                           const char *title, 
+                           uint64_t num_hits,
+                           uint64_t num_misses,
+                           uint64_t num_prefetched_lines,
+                           uint64_t num_bytes_fetched)
+{
+    const uint64_t num_lookups = num_hits + num_misses;
+    s->Printf ("%s: %llu hits, %llu misses (%.1f%% hit rate), %llu lines prefetched, %llu bytes fetched\n",
+               title,
+               num_hits,
+               num_misses,
+               num_lookups ? (100.0 * num_hits) / num_lookups : 0.0,
+               num_prefetched_lines,
+               num_bytes_fetched);
 }
 
 void
 MemoryCache::Clear()
 {
     Mutex::Locker locker (m_cache_mutex);
-    m_cache.clear();
+    ++m_generation;
+    ++m_num_stops;
+
+    // What we know of the regions goes too: the process may have mapped,
+    // unmapped or changed the permissions of memory while it was running
+    ClearCachedMemory ();
+
+    if (m_stop_stats.num_hits > 0 || m_stop_stats.num_misses > 0)
+    {
+        LogSP log (lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_PROCESS));
+        if (log)
+            log->Printf ("MemoryCache::Clear () stop %u: %llu hits, %llu misses, %llu lines prefetched, %llu bytes fetched",
+                         m_num_stops,
+                         m_stop_stats.num_hits,
+                         m_stop_stats.num_misses,
+                         m_stop_stats.num_prefetched_lines,
+                         m_stop_stats.num_bytes_fetched);
+
+        m_total_stats.num_hits += m_stop_stats.num_hits;
+        m_total_stats.num_misses += m_stop_stats.num_misses;
+        m_total_stats.num_prefetched_lines += m_stop_stats.num_prefetched_lines;
+        m_total_stats.num_bytes_fetched += m_stop_stats.num_bytes_fetched;
+        m_stop_stats = Statistics();
+    }
+}
+
+void
+MemoryCache::MemoryMapChanged ()
+{
+    Mutex::Locker locker (m_cache_mutex);
+    ++m_generation;
+    ClearCachedMemory ();
 }
 
 void
@@ -51,22 +128,41 @@ MemoryCache::Flush (addr_t addr, size_t size)
     if (size == 0)
         return;
     
-    const uint32_t cache_line_byte_size = m_cache_line_byte_size;
-    const addr_t end_addr = (addr + size - 1);
-    const addr_t flush_start_addr = addr - (addr % cache_line_byte_size);
-    const addr_t flush_end_addr = end_addr - (end_addr % cache_line_byte_size);
+    const addr_t end_addr = addr + size - 1;
     
     Mutex::Locker locker (m_cache_mutex);
-    if (m_cache.empty())
+    // Make sure a read that is in flight doesn't put back what we flush
+    ++m_generation;
+
+    if (!m_prefetched_blocks.empty())
+    {
+        PrefetchedBlocks::iterator pos = m_prefetched_blocks.upper_bound (end_addr);
+        while (pos != m_prefetched_blocks.begin())
+        {
+            --pos;
+            if (pos->first + pos->second->GetByteSize() <= addr)
+                continue;
+            m_prefetched_blocks.erase (pos++);
+        }
+    }
+
+    if (m_num_lines == 0)
         return;
     
-    assert ((flush_start_addr % cache_line_byte_size) == 0);
-    
-    for (addr_t curr_addr = flush_start_addr; curr_addr <= flush_end_addr; curr_addr += cache_line_byte_size)
+    // A region may not start on a line boundary of its line size, so look
+    // for lines of every size instead of trusting what we know of regions
+    static const uint32_t g_line_byte_sizes[eNumLineSizes] = { eSmallLineByteSize, eDefaultLineByteSize, eLargeLineByteSize };
+    for (uint32_t i = 0; i < eNumLineSizes; ++i)
     {
-        collection::iterator pos = m_cache.find (curr_addr);
-        if (pos != m_cache.end())
-            m_cache.erase(pos);
+        const uint32_t line_byte_size = g_line_byte_sizes[i];
+        addr_t line_addr = addr & ~((addr_t)line_byte_size - 1);
+        while (line_addr <= end_addr)
+        {
+            RemoveLine (line_addr, line_byte_size);
+            if (line_addr + line_byte_size <= line_addr)
+                break;
+            line_addr += line_byte_size;
+        }
     }
 }
 
@@ -76,83 +172,498 @@ MemoryCache::Read (addr_t addr,
                    size_t dst_len,
                    Error &error)
 {
-    size_t bytes_left = dst_len;
-    if (dst && bytes_left > 0)
+    if (dst == NULL || dst_len == 0)
+        return 0;
+
+    uint8_t *dst_buf = (uint8_t *)dst;
+    size_t bytes_read = 0;
+    
+    while (bytes_read < dst_len)
     {
-        const uint32_t cache_line_byte_size = m_cache_line_byte_size;
-        uint8_t *dst_buf = (uint8_t *)dst;
-        addr_t curr_addr = addr - (addr % cache_line_byte_size);
-        addr_t cache_offset = addr - curr_addr;
-        Mutex::Locker locker (m_cache_mutex);
-        
-        while (bytes_left > 0)
+        const addr_t curr_addr = addr + bytes_read;
+        uint32_t line_byte_size = 0;
+        addr_t line_addr = LLDB_INVALID_ADDRESS;
+        size_t fetch_byte_size = 0;
+        uint32_t generation = 0;
+        bool need_region = false;
         {
-            collection::const_iterator pos = m_cache.find (curr_addr);
-            collection::const_iterator end = m_cache.end ();
+            Mutex::Locker locker (m_cache_mutex);
             
-            if (pos != end)
+            if (!m_prefetched_blocks.empty())
             {
-                size_t curr_read_size = cache_line_byte_size - cache_offset;
-                if (curr_read_size > bytes_left)
-                    curr_read_size = bytes_left;
-                
-                memcpy (dst_buf + dst_len - bytes_left, pos->second->GetBytes() + cache_offset, curr_read_size);
-                
-                bytes_left -= curr_read_size;
-                curr_addr += curr_read_size + cache_offset;
-                cache_offset = 0;
-                
-                if (bytes_left > 0)
+                const size_t curr_read_size = ReadPrefetchedData (curr_addr, 
+                                                                  dst_buf + bytes_read, 
+                                                                  dst_len - bytes_read);
+                if (curr_read_size > 0)
                 {
-                    // Get sequential cache page hits
-                    for (++pos; (pos != end) && (bytes_left > 0); ++pos)
-                    {
-                        assert ((curr_addr % cache_line_byte_size) == 0);
-                        
-                        if (pos->first != curr_addr)
-                            break;
-                        
-                        curr_read_size = pos->second->GetByteSize();
-                        if (curr_read_size > bytes_left)
-                            curr_read_size = bytes_left;
-                        
-                        memcpy (dst_buf + dst_len - bytes_left, pos->second->GetBytes(), curr_read_size);
-                        
-                        bytes_left -= curr_read_size;
-                        curr_addr += curr_read_size;
-                        
-                        // We have a cache page that succeeded to read some bytes
-                        // but not an entire page. If this happens, we must cap
-                        // off how much data we are able to read...
-                        if (pos->second->GetByteSize() != cache_line_byte_size)
-                            return dst_len - bytes_left;
-                    }
+                    ++m_stop_stats.num_hits;
+                    bytes_read += curr_read_size;
+                    continue;
+                }
+            }
+
+            addr_t region_end = LLDB_INVALID_ADDRESS;
+            if (m_supports_region_info == eLazyBoolNo)
+            {
+                line_byte_size = m_cache_line_byte_size;
+            }
+            else
+            {
+                const RegionLineSizes::Entry *region = FindRegion (curr_addr);
+                if (region)
+                {
+                    line_byte_size = region->data;
+                    region_end = region->GetRangeEnd();
+                }
+                else
+                {
+                    need_region = true;
                 }
             }
             
-            // We need to read from the process
-            
-            if (bytes_left > 0)
+            if (!need_region)
             {
-                assert ((curr_addr % cache_line_byte_size) == 0);
-                std::auto_ptr<DataBufferHeap> data_buffer_heap_ap(new DataBufferHeap (cache_line_byte_size, 0));
-                size_t process_bytes_read = m_process.ReadMemoryFromInferior (curr_addr, 
-                                                                              data_buffer_heap_ap->GetBytes(), 
-                                                                              data_buffer_heap_ap->GetByteSize(), 
-                                                                              error);
-                if (process_bytes_read == 0)
-                    return dst_len - bytes_left;
+                line_addr = curr_addr & ~((addr_t)line_byte_size - 1);
+                const CacheLine *line = FindLine (line_addr, line_byte_size);
+                if (line)
+                {
+                    ++m_stop_stats.num_hits;
+                    const size_t line_offset = curr_addr - line_addr;
+                    if (line_offset >= line->byte_size)
+                    {
+                        // We already found out this memory isn't readable
+                        if (bytes_read == 0)
+                            error.SetErrorStringWithFormat ("memory read failed for 0x%llx", (uint64_t)curr_addr);
+                        return bytes_read;
+                    }
+
+                    size_t curr_read_size = line->byte_size - line_offset;
+                    if (curr_read_size > dst_len - bytes_read)
+                        curr_read_size = dst_len - bytes_read;
+                    memcpy (dst_buf + bytes_read, line->bytes + line_offset, curr_read_size);
+                    bytes_read += curr_read_size;
+                    
+                    // We have a cache line that succeeded to read some bytes
+                    // but not an entire line. If this happens, we must cap
+                    // off how much data we are able to read...
+                    if (line->byte_size != line->line_byte_size && bytes_read < dst_len)
+                        return bytes_read;
+                    continue;
+                }
                 
-                if (process_bytes_read != cache_line_byte_size)
-                    data_buffer_heap_ap->SetByteSize (process_bytes_read);
-                m_cache[curr_addr] = DataBufferSP (data_buffer_heap_ap.release());
-                // We have read data and put it into the cache, continue through the
-                // loop again to get the data out of the cache...
+                ++m_stop_stats.num_misses;
+                fetch_byte_size = GetFetchByteSize (line_addr, line_byte_size, addr + dst_len, region_end);
+                generation = m_generation;
+            }
+        }
+        
+        if (need_region)
+        {
+            // Asking the process may take a round trip to a remote stub, so
+            // we do it without holding the lock
+            AddRegion (curr_addr);
+            continue;
+        }
+
+        // Read from the process without holding the lock too. If the cache
+        // is flushed or cleared in the meantime, "generation" will no longer
+        // match and we won't cache what we read.
+        uint8_t line_buffer[eLargeLineByteSize];
+        uint8_t *fetch_bytes = line_buffer;
+        std::auto_ptr<DataBufferHeap> prefetch_buffer_ap;
+        if (fetch_byte_size > sizeof(line_buffer))
+        {
+            prefetch_buffer_ap.reset (new DataBufferHeap (fetch_byte_size, 0));
+            fetch_bytes = prefetch_buffer_ap->GetBytes();
+        }
+        size_t fetch_bytes_read = 0;
+        if (fetch_byte_size > line_byte_size)
+        {
+            // Read each line as a range of its own, so a line further ahead
+            // that can't be read doesn't cost us the line we need.
+            const size_t num_ranges = (fetch_byte_size + line_byte_size - 1) / line_byte_size;
+            std::vector<Process::MemoryReadRange> ranges (num_ranges);
+            for (size_t i = 0; i < num_ranges; ++i)
+            {
+                const size_t offset = i * line_byte_size;
+                ranges[i].addr = line_addr + offset;
+                ranges[i].buf = fetch_bytes + offset;
+                ranges[i].size = std::min<size_t> (line_byte_size, fetch_byte_size - offset);
             }
+            Error ranges_error;
+            m_process.ReadMemoryRangesFromInferior (&ranges[0], num_ranges, ranges_error);
+            // We can only cache what was read up to the first short range
+            for (size_t i = 0; i < num_ranges; ++i)
+            {
+                fetch_bytes_read += ranges[i].bytes_read;
+                if (ranges[i].bytes_read < ranges[i].size)
+                    break;
+            }
+            // Not being able to read ahead isn't an error
+            if (fetch_bytes_read <= curr_addr - line_addr)
+                error = ranges_error;
+        }
+        else
+        {
+            fetch_bytes_read = m_process.ReadMemoryFromInferior (line_addr, 
+                                                                 fetch_bytes, 
+                                                                 fetch_byte_size, 
+                                                                 error);
+        }
+
+        const size_t line_offset = curr_addr - line_addr;
+        if (fetch_bytes_read > 0)
+        {
+            Mutex::Locker locker (m_cache_mutex);
+            m_stop_stats.num_bytes_fetched += fetch_bytes_read;
+            if (generation == m_generation)
+                InsertLines (line_addr, fetch_bytes, fetch_bytes_read, line_byte_size);
         }
+
+        if (fetch_bytes_read <= line_offset)
+            return bytes_read;
+
+        size_t curr_read_size = fetch_bytes_read - line_offset;
+        if (curr_read_size > dst_len - bytes_read)
+            curr_read_size = dst_len - bytes_read;
+        memcpy (dst_buf + bytes_read, fetch_bytes + line_offset, curr_read_size);
+        bytes_read += curr_read_size;
+        
+        if (fetch_bytes_read < fetch_byte_size && bytes_read < dst_len)
+            return bytes_read;
     }
     
-    return dst_len - bytes_left;
+    return bytes_read;
+}
+
+void
+MemoryCache::AddPrefetchedData (addr_t addr, const void *src, size_t src_len)
+{
+    if (src == NULL || src_len == 0)
+        return;
+
+    DataBufferSP data_sp (new DataBufferHeap (src, src_len));
+    Mutex::Locker locker (m_cache_mutex);
+    m_prefetched_blocks[addr] = data_sp;
+    m_stop_stats.num_bytes_fetched += src_len;
+}
+
+void
+MemoryCache::DumpStatistics (Stream *s)
+{
+    if (s == NULL)
+        return;
+    
+    Mutex::Locker locker (m_cache_mutex);
+    s->Printf ("%llu lines cached, %llu regions known, %u stops\n",
+               (uint64_t)m_num_lines,
+               (uint64_t)m_regions.GetSize(),
+               m_num_stops);
+    for (size_t i = 0, n = m_regions.GetSize(); i < n; ++i)
+    {
+        const RegionLineSizes::Entry *region = m_regions.GetEntryAtIndex (i);
+        s->Printf ("    [0x%16.16llx-0x%16.16llx) %u byte lines\n",
+                   (uint64_t)region->GetRangeBase(),
+                   (uint64_t)region->GetRangeEnd(),
+                   region->data);
+    }
+    DumpMemoryCacheStatistics (s,
+                               "since the last stop",
+                               m_stop_stats.num_hits,
+                               m_stop_stats.num_misses,
+                               m_stop_stats.num_prefetched_lines,
+                               m_stop_stats.num_bytes_fetched);
+    DumpMemoryCacheStatistics (s,
+                               "total",
+                               m_total_stats.num_hits + m_stop_stats.num_hits,
+                               m_total_stats.num_misses + m_stop_stats.num_misses,
+                               m_total_stats.num_prefetched_lines + m_stop_stats.num_prefetched_lines,
+                               m_total_stats.num_bytes_fetched + m_stop_stats.num_bytes_fetched);
+}
+
+void
+MemoryCache::ResetStatistics ()
+{
+    Mutex::Locker locker (m_cache_mutex);
+    m_num_stops = 0;
+    m_stop_stats = Statistics();
+    m_total_stats = Statistics();
+}
+
+//----------------------------------------------------------------------
+// Throws away the cached lines, the prefetched blocks and the regions.
+// Must be called with m_cache_mutex locked.
+//----------------------------------------------------------------------
+void
+MemoryCache::ClearCachedMemory ()
+{
+    // The lines go back to the pool so the next stop doesn't have to
+    // allocate them again.
+    if (m_num_lines > 0)
+    {
+        for (LineTable::iterator pos = m_lines.begin(), end = m_lines.end(); pos != end; ++pos)
+        {
+            if (pos->bytes)
+            {
+                FreeLine (*pos);
+                pos->bytes = NULL;
+            }
+        }
+        m_num_lines = 0;
+    }
+    m_prefetched_blocks.clear();
+    m_regions.Clear();
+    m_last_fetch_end = LLDB_INVALID_ADDRESS;
+    m_num_sequential_misses = 0;
+    m_prefetch_byte_size = 0;
+}
+
+//----------------------------------------------------------------------
+// Copies what we have of the memory at "addr" from the prefetched blocks
+// that contain it. Must be called with m_cache_mutex locked.
+//----------------------------------------------------------------------
+size_t
+MemoryCache::ReadPrefetchedData (addr_t addr, void *dst, size_t dst_len)
+{
+    PrefetchedBlocks::const_iterator pos = m_prefetched_blocks.upper_bound (addr);
+    if (pos == m_prefetched_blocks.begin())
+        return 0;
+    --pos;
+    const size_t block_offset = addr - pos->first;
+    const size_t block_size = pos->second->GetByteSize();
+    if (block_offset >= block_size)
+        return 0;
+    const size_t bytes_copied = std::min<size_t> (block_size - block_offset, dst_len);
+    memcpy (dst, pos->second->GetBytes() + block_offset, bytes_copied);
+    return bytes_copied;
+}
+
+//----------------------------------------------------------------------
+// The line table. All of these must be called with m_cache_mutex
+// locked.
+//----------------------------------------------------------------------
+MemoryCache::CacheLine *
+MemoryCache::FindLine (addr_t line_addr, uint32_t line_byte_size)
+{
+    if (m_num_lines == 0)
+        return NULL;
+
+    const size_t mask = m_lines.size() - 1;
+    for (size_t i = HashLineAddress (line_addr) & mask; m_lines[i].bytes; i = (i + 1) & mask)
+    {
+        if (m_lines[i].addr == line_addr && m_lines[i].line_byte_size == line_byte_size)
+            return &m_lines[i];
+    }
+    return NULL;
+}
+
+void
+MemoryCache::InsertLines (addr_t addr,
+                          const uint8_t *bytes,
+                          size_t byte_size,
+                          uint32_t line_byte_size)
+{
+    for (size_t offset = 0; offset < byte_size; offset += line_byte_size)
+    {
+        const addr_t line_addr = addr + offset;
+        // Another thread may have read the same line while we weren't
+        // holding the lock
+        if (FindLine (line_addr, line_byte_size))
+            continue;
+
+        if ((m_num_lines + 1) * 2 > m_lines.size())
+            GrowLineTable ();
+
+        CacheLine line;
+        line.addr = line_addr;
+        line.bytes = AllocateLine (line_byte_size);
+        line.byte_size = std::min<size_t> (line_byte_size, byte_size - offset);
+        line.line_byte_size = line_byte_size;
+        memcpy (line.bytes, bytes + offset, line.byte_size);
+
+        const size_t mask = m_lines.size() - 1;
+        size_t i = HashLineAddress (line_addr) & mask;
+        while (m_lines[i].bytes)
+            i = (i + 1) & mask;
+        m_lines[i] = line;
+        ++m_num_lines;
+        if (offset > 0)
+            ++m_stop_stats.num_prefetched_lines;
+    }
+}
+
+void
+MemoryCache::RemoveLine (addr_t line_addr, uint32_t line_byte_size)
+{
+    CacheLine *line = FindLine (line_addr, line_byte_size);
+    if (line == NULL)
+        return;
+
+    FreeLine (*line);
+    --m_num_lines;
+
+    // Shift back the lines that follow in the same run, so lookups never
+    // have to step over a deleted slot.
+    const size_t mask = m_lines.size() - 1;
+    size_t hole = line - &m_lines[0];
+    for (size_t i = (hole + 1) & mask; m_lines[i].bytes; i = (i + 1) & mask)
+    {
+        const size_t home = HashLineAddress (m_lines[i].addr) & mask;
+        const bool home_after_hole = hole <= i ? (hole < home && home <= i) : (hole < home || home <= i);
+        if (!home_after_hole)
+        {
+            m_lines[hole] = m_lines[i];
+            hole = i;
+        }
+    }
+    m_lines[hole].bytes = NULL;
+}
+
+void
+MemoryCache::GrowLineTable ()
+{
+    LineTable old_lines;
+    old_lines.swap (m_lines);
+
+    CacheLine empty_line;
+    ::memset (&empty_line, 0, sizeof(empty_line));
+    m_lines.resize (old_lines.empty() ? 256 : old_lines.size() * 2, empty_line);
+
+    const size_t mask = m_lines.size() - 1;
+    for (LineTable::const_iterator pos = old_lines.begin(), end = old_lines.end(); pos != end; ++pos)
+    {
+        if (pos->bytes == NULL)
+            continue;
+        size_t i = HashLineAddress (pos->addr) & mask;
+        while (m_lines[i].bytes)
+            i = (i + 1) & mask;
+        m_lines[i] = *pos;
+    }
+}
+
+uint8_t *
+MemoryCache::AllocateLine (uint32_t line_byte_size)
+{
+    std::vector<uint8_t *> &free_lines = m_free_lines[GetLineSizeIndex (line_byte_size)];
+    if (free_lines.empty())
+    {
+        // Carve a new slab up into lines of this size
+        uint8_t *slab = new uint8_t[eSlabByteSize];
+        m_slabs.push_back (slab);
+        for (size_t offset = 0; offset + line_byte_size <= eSlabByteSize; offset += line_byte_size)
+            free_lines.push_back (slab + offset);
+    }
+    uint8_t *bytes = free_lines.back();
+    free_lines.pop_back();
+    return bytes;
+}
+
+void
+MemoryCache::FreeLine (const CacheLine &line)
+{
+    m_free_lines[GetLineSizeIndex (line.line_byte_size)].push_back (line.bytes);
+}
+
+//----------------------------------------------------------------------
+// Regions of memory and the size of the lines we cache them in.
+//----------------------------------------------------------------------
+const MemoryCache::RegionLineSizes::Entry *
+MemoryCache::FindRegion (addr_t addr) const
+{
+    return m_regions.FindEntryThatContains (addr);
+}
+
+void
+MemoryCache::AddRegion (addr_t addr)
+{
+    MemoryRegionInfo region_info;
+    Error error (m_process.GetMemoryRegionInfo (addr, region_info));
+
+    Mutex::Locker locker (m_cache_mutex);
+    if (FindRegion (addr))
+        return;
+
+    RegionLineSizes::Entry region;
+    if (error.Success() && region_info.GetRange().Contains (addr))
+    {
+        m_supports_region_info = eLazyBoolYes;
+        region.SetRangeBase (region_info.GetRange().GetRangeBase());
+        region.SetByteSize (region_info.GetRange().GetByteSize());
+        if (region_info.GetExecutable() == MemoryRegionInfo::eYes ||
+            region_info.GetWritable() == MemoryRegionInfo::eNo)
+            region.data = eLargeLineByteSize;
+        else if (region_info.GetWritable() == MemoryRegionInfo::eYes)
+            region.data = eSmallLineByteSize;
+        else
+            region.data = m_cache_line_byte_size;
+    }
+    else if (m_supports_region_info == eLazyBoolCalculate)
+    {
+        // The process can't tell us about regions, cache everything with
+        // the default line size from now on
+        m_supports_region_info = eLazyBoolNo;
+        return;
+    }
+    else
+    {
+        // Remember the page so we don't ask about it again
+        region.SetRangeBase (addr & ~((addr_t)eLargeLineByteSize - 1));
+        region.SetByteSize (eLargeLineByteSize);
+        region.data = m_cache_line_byte_size;
+    }
+    m_regions.Append (region);
+    m_regions.Sort ();
+}
+
+//----------------------------------------------------------------------
+// Decide how much to read from the process for a miss on the line at
+// "line_addr". A miss that lands a short way past the end of the last
+// read continues a forward walk through memory; once a few misses in a
+// row do that, read further ahead each time.
+//
+// Must be called with m_cache_mutex locked.
+//----------------------------------------------------------------------
+size_t
+MemoryCache::GetFetchByteSize (addr_t line_addr, 
+                               uint32_t line_byte_size,
+                               addr_t request_end,
+                               addr_t region_end)
+{
+    if (m_last_fetch_end != LLDB_INVALID_ADDRESS &&
+        line_addr >= m_last_fetch_end &&
+        line_addr - m_last_fetch_end <= eMaxStrideByteSize)
+    {
+        if (++m_num_sequential_misses >= eMinSequentialMisses)
+        {
+            if (m_prefetch_byte_size < 4 * line_byte_size)
+                m_prefetch_byte_size = 4 * line_byte_size;
+            else if (m_prefetch_byte_size < eMaxPrefetchByteSize)
+                m_prefetch_byte_size *= 2;
+        }
+    }
+    else
+    {
+        m_num_sequential_misses = 0;
+        m_prefetch_byte_size = 0;
+    }
+
+    // Get all the lines of a read that spans several of them at once,
+    // rather than one round trip per line
+    size_t fetch_byte_size = line_byte_size;
+    const addr_t request_line_end = (request_end + line_byte_size - 1) & ~((addr_t)line_byte_size - 1);
+    if (request_line_end > line_addr + fetch_byte_size)
+        fetch_byte_size = request_line_end - line_addr;
+    if (m_prefetch_byte_size > fetch_byte_size)
+        fetch_byte_size = m_prefetch_byte_size;
+    if (fetch_byte_size > line_byte_size)
+    {
+        fetch_byte_size = std::min<size_t> (fetch_byte_size, eMaxPrefetchByteSize);
+        // Don't read ahead past the end of the region
+        if (region_end != LLDB_INVALID_ADDRESS && line_addr + fetch_byte_size > region_end)
+            fetch_byte_size = std::max<size_t> (line_byte_size, region_end - line_addr);
+    }
+    m_last_fetch_end = line_addr + fetch_byte_size;
+    return fetch_byte_size;
 }
 
 
@@ -1904,26 +1904,37 @@ Process::ReadCStringFromMemory (addr_t addr, char *dst, size_t dst_max_len, Erro
     return total_cstr_len;
 }
 
-size_t
-Process::ReadMemoryFromInferior (addr_t addr, void *buf, size_t size, Error &error)
+//----------------------------------------------------------------------
+// Keeps calling DoReadMemory until all of the memory is read or a call
+// reads nothing, software breakpoint opcodes are left in "buf".
+//----------------------------------------------------------------------
+static size_t
+ReadMemoryWithBreakpointOpcodes (Process &process, addr_t addr, void *buf, size_t size, Error &error)
 {
-    if (buf == NULL || size == 0)
-        return 0;
-
     size_t bytes_read = 0;
     uint8_t *bytes = (uint8_t *)buf;
     
     while (bytes_read < size)
     {
         const size_t curr_size = size - bytes_read;
-        const size_t curr_bytes_read = DoReadMemory (addr + bytes_read, 
-                                                     bytes + bytes_read, 
-                                                     curr_size,
-                                                     error);
+        const size_t curr_bytes_read = process.DoReadMemory (addr + bytes_read, 
+                                                             bytes + bytes_read, 
+                                                             curr_size,
+                                                             error);
         bytes_read += curr_bytes_read;
         if (curr_bytes_read == curr_size || curr_bytes_read == 0)
             break;
     }
+    return bytes_read;
+}
+
+size_t
+Process::ReadMemoryFromInferior (addr_t addr, void *buf, size_t size, Error &error)
+{
+    if (buf == NULL || size == 0)
+        return 0;
+
+    const size_t bytes_read = ReadMemoryWithBreakpointOpcodes (*this, addr, buf, size, error);
 
     // Replace any software breakpoint opcodes that fall into this range back
     // into "buf" before we return
@@ -1932,6 +1943,91 @@ Process::ReadMemoryFromInferior (addr_t addr, void *buf, size_t size, Error &err
     return bytes_read;
 }
 
+size_t
+Process::ReadMemoryRangesFromInferior (MemoryReadRange *ranges, size_t num_ranges, Error &error)
+{
+    if (ranges == NULL || num_ranges == 0)
+        return 0;
+
+    for (size_t i = 0; i < num_ranges; ++i)
+        ranges[i].bytes_read = 0;
+
+    const size_t total_bytes_read = DoReadMemoryRanges (ranges, num_ranges, error);
+
+    // Replace any software breakpoint opcodes that fall into the ranges
+    // back into their buffers before we return
+    for (size_t i = 0; i < num_ranges; ++i)
+    {
+        if (ranges[i].bytes_read > 0)
+            RemoveBreakpointOpcodesFromBuffer (ranges[i].addr, ranges[i].bytes_read, (uint8_t *)ranges[i].buf);
+    }
+    return total_bytes_read;
+}
+
+size_t
+Process::DoReadMemoryRanges (MemoryReadRange *ranges, size_t num_ranges, Error &error)
+{
+    size_t total_bytes_read = 0;
+    size_t i = 0;
+    while (i < num_ranges)
+    {
+        // Ranges that follow each other in the process and in their
+        // buffers are read with a single request
+        size_t end = i + 1;
+        size_t span_size = ranges[i].size;
+        while (end < num_ranges &&
+               ranges[end].addr == ranges[end - 1].addr + ranges[end - 1].size &&
+               (uint8_t *)ranges[end].buf == (uint8_t *)ranges[end - 1].buf + ranges[end - 1].size)
+        {
+            span_size += ranges[end].size;
+            ++end;
+        }
+
+        Error span_error;
+        size_t span_bytes_read = ReadMemoryWithBreakpointOpcodes (*this, ranges[i].addr, ranges[i].buf, span_size, span_error);
+        for (; i < end; ++i)
+        {
+            ranges[i].bytes_read = std::min<size_t> (ranges[i].size, span_bytes_read);
+            span_bytes_read -= ranges[i].bytes_read;
+            total_bytes_read += ranges[i].bytes_read;
+            if (ranges[i].bytes_read < ranges[i].size)
+                break;
+        }
+        if (i == end)
+            continue;
+
+        // Some processes fail a read as a whole if any part of it can't be
+        // read, so read what is left of the span one range at a time
+        for (; i < end; ++i)
+        {
+            MemoryReadRange &range = ranges[i];
+            if (range.bytes_read < range.size)
+            {
+                Error range_error;
+                const size_t range_bytes_read = ReadMemoryWithBreakpointOpcodes (*this,
+                                                                                 range.addr + range.bytes_read,
+                                                                                 (uint8_t *)range.buf + range.bytes_read,
+                                                                                 range.size - range.bytes_read,
+                                                                                 range_error);
+                range.bytes_read += range_bytes_read;
+                total_bytes_read += range_bytes_read;
+                if (range.bytes_read < range.size)
+                {
+                    if (error.Success())
+                    {
+                        if (range_error.Fail())
+                            error = range_error;
+                        else
+                            error.SetErrorStringWithFormat ("memory read failed for 0x%llx", (uint64_t)(range.addr + range.bytes_read));
+                    }
+                    return total_bytes_read;
+                }
+            }
+        }
+    }
+    return total_bytes_read;
+}
+
 uint64_t
 Process::ReadUnsignedIntegerFromMemory (lldb::addr_t vm_addr, size_t integer_byte_size, uint64_t fail_value, Error &error)
 {
@@ -2588,6 +2684,36 @@ Process::CompleteAttach ()
     }
 }
 
+Error
+Process::LoadCore (const FileSpec &core_file)
+{
+    Error error (DoLoadCore (core_file));
+    if (error.Success())
+    {
+        if (PrivateStateThreadIsValid ())
+            ResumePrivateStateThread ();
+        else
+            StartPrivateStateThread ();
+
+        // A core file has no live process behind it, so don't ask the
+        // platform about it like CompleteAttach() would.
+        m_dyld_ap.reset (DynamicLoader::FindPlugin(this, NULL));
+        if (m_dyld_ap.get())
+            m_dyld_ap->DidAttach();
+
+        m_os_ap.reset (OperatingSystem::FindPlugin (this, NULL));
+
+        SetPrivateState (eStateStopped);
+    }
+    return error;
+}
+
+DataBufferSP
+Process::GetAuxvData ()
+{
+    return Host::GetAuxvData (this);
+}
+
 Error
 Process::ConnectRemote (const char *remote_url)
 {
@@ -216,6 +216,11 @@ public:
                         // We need to make sure the user sees any parse errors in their condition, so we'll hook the
                         // constructor errors up to the debugger's Async I/O.
                         
+                        // Most conditions only compare variables, let the IR interpreter evaluate those
+                        // by reading registers and memory instead of running code in the inferior.  Conditions
+                        // that call functions still get JIT-compiled.  Either way the parsed condition is
+                        // cached by the target, so it is only compiled once per location.
+                        
                         ValueObjectSP result_valobj_sp;
                         
                         ExecutionResults result_code;
@@ -223,7 +228,7 @@ public:
                         const bool discard_on_error = true;
                         Error error;
                         result_code = ClangUserExpression::EvaluateWithError (context.exe_ctx,
-                                                                              eExecutionPolicyAlways,
+                                                                              eExecutionPolicyOnlyWhenNeeded,
                                                                               lldb::eLanguageTypeUnknown,
                                                                               ClangUserExpression::eResultTypeAny,
                                                                               discard_on_error,
@@ -493,7 +498,7 @@ public:
                 const bool discard_on_error = true;
                 Error error;
                 result_code = ClangUserExpression::EvaluateWithError (context.exe_ctx,
-                                                                      eExecutionPolicyAlways,
+                                                                      eExecutionPolicyOnlyWhenNeeded,
                                                                       lldb::eLanguageTypeUnknown,
                                                                       ClangUserExpression::eResultTypeAny,
                                                                       discard_on_error,
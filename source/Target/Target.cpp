@@ -64,6 +64,7 @@ Target::Target(Debugger &debugger, const ArchSpec &target_arch, const lldb::Plat
     m_scratch_ast_source_ap (NULL),
     m_ast_importer_ap (NULL),
     m_persistent_variables (),
+    m_expression_cache (),
     m_source_manager(*this),
     m_stop_hooks (),
     m_stop_hook_next_id (0),
@@ -131,6 +132,9 @@ Target::DeleteCurrentProcess ()
         m_internal_breakpoint_list.ClearAllBreakpointSites();
         // Disable watchpoints just on the debugger side.
         DisableAllWatchpoints(false);
+        // Cached expressions hold on to the process and to JIT-compiled
+        // code inside it.
+        m_expression_cache.Clear();
         m_process_sp.reset();
     }
 }
@@ -798,6 +802,7 @@ void
 Target::SetExecutableModule (ModuleSP& executable_sp, bool get_dependent_files)
 {
     m_images.Clear();
+    m_expression_cache.Clear();
     m_scratch_ast_context_ap.reset();
     m_scratch_ast_source_ap.reset();
     m_ast_importer_ap.reset();
@@ -928,6 +933,12 @@ void
 Target::ModulesDidLoad (ModuleList &module_list)
 {
     m_breakpoint_list.UpdateBreakpoints (module_list, true);
+    // Cached expressions may have resolved names differently without
+    // these modules.
+    m_expression_cache.Clear();
+    // Loading images maps memory, an exec replaces all of it
+    if (m_process_sp)
+        m_process_sp->GetMemoryCache().MemoryMapChanged();
     // TODO: make event data that packages up the module_list
     BroadcastEvent (eBroadcastBitModulesLoaded, NULL);
 }
@@ -937,6 +948,15 @@ Target::ModulesDidUnload (ModuleList &module_list)
 {
     m_breakpoint_list.UpdateBreakpoints (module_list, false);
 
+    // Cached expressions may refer to variables, functions and types
+    // in the modules going away.
+    m_expression_cache.Clear();
+
+    // The memory of the images is unmapped, don't keep serving it from
+    // the cache or reading it with the line sizes of its old regions
+    if (m_process_sp)
+        m_process_sp->GetMemoryCache().MemoryMapChanged();
+
     // Remove the images from the target image list
     m_images.Remove(module_list);
 
@@ -1231,6 +1251,30 @@ Target::GetSharedModule
     bool did_create_module = false;
     ModuleSP module_sp;
 
+    Error error (FindSharedModule (file_spec, arch, uuid_ptr, object_name, object_offset, module_sp, old_module_sp, did_create_module));
+    AddSharedModule (module_sp, old_module_sp, did_create_module);
+    if (error_ptr)
+        *error_ptr = error;
+    return module_sp;
+}
+
+//----------------------------------------------------------------------
+// Find or create the shared module for a file without adding it to our
+// image list.
+//----------------------------------------------------------------------
+Error
+Target::FindSharedModule
+(
+    const FileSpec& file_spec,
+    const ArchSpec& arch,
+    const lldb_private::UUID *uuid_ptr,
+    const ConstString *object_name,
+    off_t object_offset,
+    ModuleSP &module_sp,
+    ModuleSP &old_module_sp,
+    bool &did_create_module
+)
+{
     Error error;
 
     // If there are image search path entries, try to use them first to acquire a suitable image.
@@ -1262,7 +1306,12 @@ Target::GetSharedModule
     {
         error.SetErrorString("no platform is currently set");
     }
+    return error;
+}
 
+void
+Target::AddSharedModule (ModuleSP &module_sp, ModuleSP &old_module_sp, bool did_create_module)
+{
     // If a module hasn't been found yet, use the unmodified path.
     if (module_sp)
     {
@@ -1275,9 +1324,94 @@ Target::GetSharedModule
                 ModuleAdded(module_sp);
         }
     }
-    if (error_ptr)
-        *error_ptr = error;
-    return module_sp;
+}
+
+namespace {
+
+    struct SharedModuleLookup
+    {
+        SharedModuleLookup () :
+            file_spec (),
+            module_sp (),
+            old_module_sp (),
+            did_create_module (false)
+        {
+        }
+
+        FileSpec file_spec;
+        ModuleSP module_sp;
+        ModuleSP old_module_sp;
+        bool did_create_module;
+    };
+
+    struct SharedModuleLookupArgs
+    {
+        Target *target;
+        const ArchSpec *arch;
+        SharedModuleLookup *lookups;
+    };
+
+}
+
+static void
+FindSharedModuleAndParse (void *baton, uint32_t worker_idx, size_t lookup_idx)
+{
+    SharedModuleLookupArgs *args = (SharedModuleLookupArgs *)baton;
+    SharedModuleLookup &lookup = args->lookups[lookup_idx];
+    args->target->FindSharedModule (lookup.file_spec,
+                                    *args->arch,
+                                    NULL,
+                                    NULL,
+                                    0,
+                                    lookup.module_sp,
+                                    lookup.old_module_sp,
+                                    lookup.did_create_module);
+
+    // Parse the section headers and symbol table now, while we are on a
+    // worker thread, instead of on first use.
+    if (lookup.module_sp)
+    {
+        ObjectFile *objfile = lookup.module_sp->GetObjectFile();
+        if (objfile)
+        {
+            objfile->GetSectionList();
+            objfile->GetSymtab();
+        }
+    }
+}
+
+size_t
+Target::GetSharedModules (const FileSpecList &file_specs, const ArchSpec &arch, std::vector<ModuleSP> &modules)
+{
+    const size_t num_files = file_specs.GetSize();
+    modules.resize (num_files);
+    if (num_files == 0)
+        return 0;
+
+    std::vector<SharedModuleLookup> lookups (num_files);
+    for (size_t i = 0; i < num_files; ++i)
+        lookups[i].file_spec = file_specs.GetFileSpecAtIndex (i);
+
+    // Remote platforms may have to fetch files over a single connection,
+    // so only spread the lookups across threads when debugging locally.
+    const uint32_t num_workers = (m_platform_sp && m_platform_sp->IsHost()) ? 0 : 1;
+    SharedModuleLookupArgs args = { this, &arch, &lookups[0] };
+    Host::ParallelForEach ("<lldb.target.load-modules>",
+                           num_workers,
+                           num_files,
+                           FindSharedModuleAndParse,
+                           &args);
+
+    // Add the modules to our image list in the order they were given.
+    size_t num_modules = 0;
+    for (size_t i = 0; i < num_files; ++i)
+    {
+        AddSharedModule (lookups[i].module_sp, lookups[i].old_module_sp, lookups[i].did_create_module);
+        modules[i] = lookups[i].module_sp;
+        if (modules[i])
+            ++num_modules;
+    }
+    return num_modules;
 }
 
 
@@ -1408,6 +1542,46 @@ Target::GetDefaultArchitecture ()
     return ArchSpec();
 }
 
+FileSpec
+Target::GetIndexCachePath ()
+{
+    lldb::UserSettingsControllerSP settings_controller_sp (GetSettingsController());
+
+    if (settings_controller_sp)
+        return static_cast<Target::SettingsController *>(settings_controller_sp.get())->GetIndexCachePath ();
+    return FileSpec();
+}
+
+bool
+Target::GetUsePubnamesIndex ()
+{
+    lldb::UserSettingsControllerSP settings_controller_sp (GetSettingsController());
+
+    if (settings_controller_sp)
+        return static_cast<Target::SettingsController *>(settings_controller_sp.get())->GetUsePubnamesIndex ();
+    return false;
+}
+
+uint64_t
+Target::GetDIECacheMaxSize ()
+{
+    lldb::UserSettingsControllerSP settings_controller_sp (GetSettingsController());
+
+    if (settings_controller_sp)
+        return static_cast<Target::SettingsController *>(settings_controller_sp.get())->GetDIECacheMaxSize () * 1024ull * 1024ull;
+    return 0;
+}
+
+uint64_t
+Target::GetIndexCacheMaxSize ()
+{
+    lldb::UserSettingsControllerSP settings_controller_sp (GetSettingsController());
+
+    if (settings_controller_sp)
+        return static_cast<Target::SettingsController *>(settings_controller_sp.get())->GetIndexCacheMaxSize () * 1024ull * 1024ull;
+    return 0;
+}
+
 void
 Target::SetDefaultArchitecture (const ArchSpec& arch)
 {
@@ -1996,7 +2170,11 @@ Target::StopHook::GetDescription (Stream *s, lldb::DescriptionLevel level) const
 
 Target::SettingsController::SettingsController () :
     UserSettingsController ("target", Debugger::GetSettingsController()),
-    m_default_architecture ()
+    m_default_architecture (),
+    m_index_cache_path (),
+    m_index_cache_max_size (512),
+    m_use_pubnames_index (false, false),
+    m_die_cache_max_size (256)
 {
     m_default_settings.reset (new TargetInstanceSettings (*this, false,
                                                           InstanceSettings::GetDefaultName().AsCString()));
@@ -2018,9 +2196,14 @@ Target::SettingsController::CreateInstanceSettings (const char *instance_name)
 
 
 #define TSC_DEFAULT_ARCH        "default-arch"
+#define TSC_INDEX_CACHE_PATH    "index-cache-path"
+#define TSC_INDEX_CACHE_SIZE    "index-cache-max-size"
+#define TSC_PUBNAMES_INDEX      "use-pubnames-index"
+#define TSC_DIE_CACHE_SIZE      "die-cache-max-size"
 #define TSC_EXPR_PREFIX         "expr-prefix"
 #define TSC_PREFER_DYNAMIC      "prefer-dynamic-value"
 #define TSC_SKIP_PROLOGUE       "skip-prologue"
+#define TSC_USE_FAST_STEP       "use-fast-stepping"
 #define TSC_SOURCE_MAP          "source-map"
 #define TSC_MAX_CHILDREN        "max-children-count"
 #define TSC_MAX_STRLENSUMMARY   "max-string-summary-length"
@@ -2042,6 +2225,34 @@ GetSettingNameForDefaultArch ()
     return g_const_string;
 }
 
+static const ConstString &
+GetSettingNameForIndexCachePath ()
+{
+    static ConstString g_const_string (TSC_INDEX_CACHE_PATH);
+    return g_const_string;
+}
+
+static const ConstString &
+GetSettingNameForIndexCacheMaxSize ()
+{
+    static ConstString g_const_string (TSC_INDEX_CACHE_SIZE);
+    return g_const_string;
+}
+
+static const ConstString &
+GetSettingNameForUsePubnamesIndex ()
+{
+    static ConstString g_const_string (TSC_PUBNAMES_INDEX);
+    return g_const_string;
+}
+
+static const ConstString &
+GetSettingNameForDIECacheMaxSize ()
+{
+    static ConstString g_const_string (TSC_DIE_CACHE_SIZE);
+    return g_const_string;
+}
+
 static const ConstString &
 GetSettingNameForExpressionPrefix ()
 {
@@ -2070,6 +2281,13 @@ GetSettingNameForSkipPrologue ()
     return g_const_string;
 }
 
+static const ConstString &
+GetSettingNameForUseFastStepping ()
+{
+    static ConstString g_const_string (TSC_USE_FAST_STEP);
+    return g_const_string;
+}
+
 static const ConstString &
 GetSettingNameForMaxChildren ()
 {
@@ -2161,6 +2379,32 @@ Target::SettingsController::SetGlobalVariable (const ConstString &var_name,
         if (!m_default_architecture.IsValid())
             err.SetErrorStringWithFormat ("'%s' is not a valid architecture or triple.", value);
     }
+    else if (var_name == GetSettingNameForIndexCachePath())
+    {
+        err = UserSettingsController::UpdateFileSpecOptionValue (value, op, m_index_cache_path);
+    }
+    else if (var_name == GetSettingNameForIndexCacheMaxSize())
+    {
+        bool ok;
+        uint32_t new_value = Args::StringToUInt32(value, 0, 10, &ok);
+        if (ok)
+            m_index_cache_max_size = new_value;
+        else
+            err.SetErrorStringWithFormat ("'%s' is not a valid size in megabytes.", value);
+    }
+    else if (var_name == GetSettingNameForUsePubnamesIndex())
+    {
+        err = UserSettingsController::UpdateBooleanOptionValue (value, op, m_use_pubnames_index);
+    }
+    else if (var_name == GetSettingNameForDIECacheMaxSize())
+    {
+        bool ok;
+        uint32_t new_value = Args::StringToUInt32(value, 0, 10, &ok);
+        if (ok)
+            m_die_cache_max_size = new_value;
+        else
+            err.SetErrorStringWithFormat ("'%s' is not a valid size in megabytes.", value);
+    }
     return true;
 }
 
@@ -2177,6 +2421,36 @@ Target::SettingsController::GetGlobalVariable (const ConstString &var_name,
             value.AppendString (m_default_architecture.GetArchitectureName());
         return true;
     }
+    else if (var_name == GetSettingNameForIndexCachePath())
+    {
+        char path[PATH_MAX];
+        const size_t path_len = m_index_cache_path.GetCurrentValue().GetPath (path, sizeof(path));
+        if (path_len > 0)
+            value.AppendString (path, path_len);
+        return true;
+    }
+    else if (var_name == GetSettingNameForIndexCacheMaxSize())
+    {
+        StreamString size_str;
+        size_str.Printf ("%u", m_index_cache_max_size);
+        value.AppendString (size_str.GetData());
+        return true;
+    }
+    else if (var_name == GetSettingNameForUsePubnamesIndex())
+    {
+        if (m_use_pubnames_index)
+            value.AppendString ("true");
+        else
+            value.AppendString ("false");
+        return true;
+    }
+    else if (var_name == GetSettingNameForDIECacheMaxSize())
+    {
+        StreamString size_str;
+        size_str.Printf ("%u", m_die_cache_max_size);
+        value.AppendString (size_str.GetData());
+        return true;
+    }
     else
         err.SetErrorStringWithFormat ("unrecognized variable name '%s'", var_name.AsCString());
 
@@ -2198,6 +2472,7 @@ TargetInstanceSettings::TargetInstanceSettings
     m_expr_prefix_contents (),
     m_prefer_dynamic_value (2),
     m_skip_prologue (true, true),
+    m_use_fast_stepping (true, true),
     m_source_map (NULL, NULL),
     m_max_children_display(256),
     m_max_strlen_length(1024),
@@ -2236,6 +2511,7 @@ TargetInstanceSettings::TargetInstanceSettings (const TargetInstanceSettings &rh
     m_expr_prefix_contents (rhs.m_expr_prefix_contents),
     m_prefer_dynamic_value (rhs.m_prefer_dynamic_value),
     m_skip_prologue (rhs.m_skip_prologue),
+    m_use_fast_stepping (rhs.m_use_fast_stepping),
     m_source_map (rhs.m_source_map),
     m_max_children_display (rhs.m_max_children_display),
     m_max_strlen_length (rhs.m_max_strlen_length),
@@ -2269,6 +2545,7 @@ TargetInstanceSettings::operator= (const TargetInstanceSettings &rhs)
         m_expr_prefix_contents = rhs.m_expr_prefix_contents;
         m_prefer_dynamic_value = rhs.m_prefer_dynamic_value;
         m_skip_prologue = rhs.m_skip_prologue;
+        m_use_fast_stepping = rhs.m_use_fast_stepping;
         m_source_map = rhs.m_source_map;
         m_max_children_display = rhs.m_max_children_display;
         m_max_strlen_length = rhs.m_max_strlen_length;
@@ -2348,6 +2625,10 @@ TargetInstanceSettings::UpdateInstanceSettingsVariable (const ConstString &var_n
     {
         err = UserSettingsController::UpdateBooleanOptionValue (value, op, m_skip_prologue);
     }
+    else if (var_name == GetSettingNameForUseFastStepping())
+    {
+        err = UserSettingsController::UpdateBooleanOptionValue (value, op, m_use_fast_stepping);
+    }
     else if (var_name == GetSettingNameForMaxChildren())
     {
         bool ok;
@@ -2492,6 +2773,13 @@ TargetInstanceSettings::GetInstanceSettingsValue (const SettingEntry &entry,
         else
             value.AppendString ("false");
     }
+    else if (var_name == GetSettingNameForUseFastStepping())
+    {
+        if (m_use_fast_stepping)
+            value.AppendString ("true");
+        else
+            value.AppendString ("false");
+    }
     else if (var_name == GetSettingNameForSourcePathMap ())
     {
         if (m_source_map.GetSize())
@@ -2663,6 +2951,10 @@ Target::SettingsController::global_settings_table[] =
     // var-name           var-type           default      enum  init'd hidden help-text
     // =================  ================== ===========  ====  ====== ====== =========================================================================
     { TSC_DEFAULT_ARCH  , eSetVarTypeString , NULL      , NULL, false, false, "Default architecture to choose, when there's a choice." },
+    { TSC_INDEX_CACHE_PATH, eSetVarTypeString, NULL     , NULL, false, false, "Directory in which symbol file name indexes are cached between debug sessions. Caching is disabled when empty." },
+    { TSC_INDEX_CACHE_SIZE, eSetVarTypeInt  , "512"     , NULL, false, false, "Maximum size in megabytes of the symbol index cache. The least recently used indexes are removed first." },
+    { TSC_PUBNAMES_INDEX, eSetVarTypeBoolean, "false"   , NULL, false, false, "Use .debug_pubnames and .debug_pubtypes to only index the compile units a lookup needs. Looking up a name missing from those tables, like a static function, indexes every compile unit." },
+    { TSC_DIE_CACHE_SIZE, eSetVarTypeInt  , "256"     , NULL, false, false, "Maximum size in megabytes of the debug information entries all symbol files together keep parsed after indexing them. The least recently used compile units are thrown away first." },
     { NULL              , eSetVarTypeNone   , NULL      , NULL, false, false, NULL }
 };
 
@@ -2674,6 +2966,7 @@ Target::SettingsController::instance_settings_table[] =
     { TSC_EXPR_PREFIX       , eSetVarTypeString , NULL          , NULL,                  false, false, "Path to a file containing expressions to be prepended to all expressions." },
     { TSC_PREFER_DYNAMIC    , eSetVarTypeEnum   , NULL          , g_dynamic_value_types, false, false, "Should printed values be shown as their dynamic value." },
     { TSC_SKIP_PROLOGUE     , eSetVarTypeBoolean, "true"        , NULL,                  false, false, "Skip function prologues when setting breakpoints by name." },
+    { TSC_USE_FAST_STEP     , eSetVarTypeBoolean, "true"        , NULL,                  false, false, "Step through source lines by running to the next branch instruction instead of single-stepping every instruction." },
     { TSC_SOURCE_MAP        , eSetVarTypeArray  , NULL          , NULL,                  false, false, "Source path remappings to use when locating source files from debug information." },
     { TSC_MAX_CHILDREN      , eSetVarTypeInt    , "256"         , NULL,                  true,  false, "Maximum number of children to expand in any level of depth." },
     { TSC_MAX_STRLENSUMMARY , eSetVarTypeInt    , "1024"        , NULL,                  true,  false, "Maximum number of characters to show when using %s in summary strings." },
@@ -1278,7 +1278,8 @@ Thread::SettingsController::CreateInstanceSettings (const char *instance_name)
 ThreadInstanceSettings::ThreadInstanceSettings (UserSettingsController &owner, bool live_instance, const char *name) :
     InstanceSettings (owner, name ? name : InstanceSettings::InvalidName().AsCString(), live_instance), 
     m_avoid_regexp_ap (),
-    m_trace_enabled (false)
+    m_trace_enabled (false),
+    m_fast_unwind_enabled (false)
 {
     // CopyInstanceSettings is a pure virtual function in InstanceSettings; it therefore cannot be called
     // until the vtables for ThreadInstanceSettings are properly set up, i.e. AFTER all the initializers.
@@ -1302,7 +1303,8 @@ ThreadInstanceSettings::ThreadInstanceSettings (UserSettingsController &owner, b
 ThreadInstanceSettings::ThreadInstanceSettings (const ThreadInstanceSettings &rhs) :
     InstanceSettings (*Thread::GetSettingsController(), CreateInstanceName().AsCString()),
     m_avoid_regexp_ap (),
-    m_trace_enabled (rhs.m_trace_enabled)
+    m_trace_enabled (rhs.m_trace_enabled),
+    m_fast_unwind_enabled (rhs.m_fast_unwind_enabled)
 {
     if (m_instance_name != InstanceSettings::GetDefaultName())
     {
@@ -1329,6 +1331,7 @@ ThreadInstanceSettings::operator= (const ThreadInstanceSettings &rhs)
             m_avoid_regexp_ap.reset(NULL);
     }
     m_trace_enabled = rhs.m_trace_enabled;
+    m_fast_unwind_enabled = rhs.m_fast_unwind_enabled;
     return *this;
 }
 
@@ -1377,6 +1380,10 @@ ThreadInstanceSettings::UpdateInstanceSettingsVariable (const ConstString &var_n
         }
 
     }
+    else if (var_name == GetFastUnwindVarName())
+    {
+        UserSettingsController::UpdateBooleanVariable (op, m_fast_unwind_enabled, value, false, err);
+    }
 }
 
 void
@@ -1391,6 +1398,7 @@ ThreadInstanceSettings::CopyInstanceSettings (const lldb::InstanceSettingsSP &ne
         m_avoid_regexp_ap.reset (new RegularExpression (new_process_settings->GetSymbolsToAvoidRegexp()->GetText()));
     else 
         m_avoid_regexp_ap.reset ();
+    m_fast_unwind_enabled = new_process_settings->m_fast_unwind_enabled;
 }
 
 bool
@@ -1414,6 +1422,10 @@ ThreadInstanceSettings::GetInstanceSettingsValue (const SettingEntry &entry,
     {
         value.AppendString(m_trace_enabled ? "true" : "false");
     }
+    else if (var_name == GetFastUnwindVarName())
+    {
+        value.AppendString(m_fast_unwind_enabled ? "true" : "false");
+    }
     else
     {
         if (err)
@@ -1452,6 +1464,14 @@ ThreadInstanceSettings::GetTraceThreadVarName ()
     return trace_thread_var_name;
 }
 
+const ConstString &
+ThreadInstanceSettings::GetFastUnwindVarName ()
+{
+    static ConstString fast_unwind_var_name ("fast-unwind");
+
+    return fast_unwind_var_name;
+}
+
 //--------------------------------------------------
 // SettingsController Variable Tables
 //--------------------------------------------------
@@ -1470,5 +1490,6 @@ Thread::SettingsController::instance_settings_table[] =
   //{ "var-name",    var-type,              "default",      enum-table, init'd, hidden, "help-text"},
     { "step-avoid-regexp",  eSetVarTypeString,      "",  NULL,       false,  false,  "A regular expression defining functions step-in won't stop in." },
     { "trace-thread",  eSetVarTypeBoolean,      "false",  NULL,       false,  false,  "If true, this thread will single-step and log execution." },
+    { "fast-unwind",  eSetVarTypeBoolean,      "false",  NULL,       false,  false,  "If true, backtraces are computed from a compact table of each function's unwind rules with few stack memory reads, falling back to the full unwinder for frames the table can't describe. Meant for taking many stack samples quickly." },
     {  NULL, eSetVarTypeNone, NULL, NULL, 0, 0, NULL }
 };
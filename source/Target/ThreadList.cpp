@@ -24,6 +24,7 @@ ThreadList::ThreadList (Process *process) :
     m_process (process),
     m_stop_id (0),
     m_threads(),
+    m_tid_to_index(),
     m_threads_mutex (Mutex::eMutexTypeRecursive),
     m_selected_tid (LLDB_INVALID_THREAD_ID)
 {
@@ -33,6 +34,7 @@ ThreadList::ThreadList (const ThreadList &rhs) :
     m_process (),
     m_stop_id (),
     m_threads (),
+    m_tid_to_index (),
     m_threads_mutex (Mutex::eMutexTypeRecursive),
     m_selected_tid ()
 {
@@ -52,6 +54,7 @@ ThreadList::operator = (const ThreadList& rhs)
         m_process = rhs.m_process;
         m_stop_id = rhs.m_stop_id;
         m_threads = rhs.m_threads;
+        m_tid_to_index = rhs.m_tid_to_index;
         m_selected_tid = rhs.m_selected_tid;
     }
     return *this;
@@ -80,6 +83,7 @@ void
 ThreadList::AddThread (ThreadSP &thread_sp)
 {
     Mutex::Locker locker(m_threads_mutex);
+    m_tid_to_index[thread_sp->GetID()] = m_threads.size();
     m_threads.push_back(thread_sp);
 }
 
@@ -114,16 +118,9 @@ ThreadList::FindThreadByID (lldb::tid_t tid, bool can_update)
         m_process->UpdateThreadListIfNeeded();
 
     ThreadSP thread_sp;
-    uint32_t idx = 0;
-    const uint32_t num_threads = m_threads.size();
-    for (idx = 0; idx < num_threads; ++idx)
-    {
-        if (m_threads[idx]->GetID() == tid)
-        {
-            thread_sp = m_threads[idx];
-            break;
-        }
-    }
+    tid_to_index_collection::const_iterator pos = m_tid_to_index.find(tid);
+    if (pos != m_tid_to_index.end())
+        thread_sp = m_threads[pos->second];
     return thread_sp;
 }
 
@@ -351,6 +348,7 @@ ThreadList::Clear()
     Mutex::Locker locker(m_threads_mutex);
     m_stop_id = 0;
     m_threads.clear();
+    m_tid_to_index.clear();
     m_selected_tid = LLDB_INVALID_THREAD_ID;
 }
 
@@ -602,6 +600,7 @@ ThreadList::Update (ThreadList &rhs)
         m_process = rhs.m_process;
         m_stop_id = rhs.m_stop_id;
         m_threads.swap(rhs.m_threads);
+        m_tid_to_index.swap(rhs.m_tid_to_index);
         m_selected_tid = rhs.m_selected_tid;
     }
 }
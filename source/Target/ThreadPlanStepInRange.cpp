@@ -84,6 +84,10 @@ ThreadPlanStepInRange::PlanExplainsStop ()
         switch (reason)
         {
         case eStopReasonBreakpoint:
+            // Our own breakpoint on the next branch is just a faster trace.
+            if (NextRangeBreakpointExplainsStop (stop_info_sp))
+                break;
+            // Fall through
         case eStopReasonWatchpoint:
         case eStopReasonSignal:
         case eStopReasonException:
@@ -112,6 +116,8 @@ ThreadPlanStepInRange::ShouldStop (Event *event_ptr)
         log->Printf("ThreadPlanStepInRange reached %s.", s.GetData());
     }
 
+    ClearNextBranchBreakpoint();
+
     if (IsPlanComplete())
         return true;
         
@@ -15,13 +15,19 @@
 // Project includes
 
 #include "lldb/lldb-private-log.h"
+#include "lldb/Breakpoint/Breakpoint.h"
+#include "lldb/Breakpoint/BreakpointLocation.h"
+#include "lldb/Breakpoint/BreakpointSite.h"
+#include "lldb/Core/Disassembler.h"
 #include "lldb/Core/Log.h"
 #include "lldb/Core/Stream.h"
 #include "lldb/Symbol/Function.h"
 #include "lldb/Symbol/Symbol.h"
+#include "lldb/Target/ExecutionContext.h"
 #include "lldb/Target/Process.h"
 #include "lldb/Target/RegisterContext.h"
 #include "lldb/Target/StopInfo.h"
+#include "lldb/Target/Target.h"
 #include "lldb/Target/Thread.h"
 
 using namespace lldb;
@@ -46,7 +52,9 @@ ThreadPlanStepRange::ThreadPlanStepRange (ThreadPlanKind kind,
     m_stack_depth (0),
     m_stack_id (),
     m_no_more_plans (false),
-    m_first_run_event (true)
+    m_first_run_event (true),
+    m_instruction_ranges (),
+    m_next_branch_bp_sp ()
 {
     AddRange(range);
     m_stack_depth = m_thread.GetStackFrameCount();
@@ -55,6 +63,7 @@ ThreadPlanStepRange::ThreadPlanStepRange (ThreadPlanKind kind,
 
 ThreadPlanStepRange::~ThreadPlanStepRange ()
 {
+    ClearNextBranchBreakpoint();
 }
 
 bool
@@ -81,6 +90,7 @@ ThreadPlanStepRange::AddRange(const AddressRange &new_range)
     // condense the ranges if they overlap, though I don't think it is likely
     // to be very important.
     m_address_ranges.push_back (new_range);
+    m_instruction_ranges.push_back (DisassemblerSP());
 }
 
 void
@@ -151,6 +161,7 @@ ThreadPlanStepRange::InRange ()
                     // range to the line we've stepped into the middle of and continue.
                     m_addr_context = new_context;
                     m_address_ranges.clear();
+                    m_instruction_ranges.clear();
                     AddRange(m_addr_context.line_entry.range);
                     ret_value = true;
                     if (log)
@@ -263,15 +274,174 @@ ThreadPlanStepRange::StopOthers ()
         return false;
 }
 
+InstructionList *
+ThreadPlanStepRange::GetInstructionsForAddress (lldb::addr_t addr, size_t &range_index, size_t &insn_offset)
+{
+    Target &target = m_thread.GetProcess().GetTarget();
+    size_t num_ranges = m_address_ranges.size();
+    for (size_t i = 0; i < num_ranges; i++)
+    {
+        if (!m_address_ranges[i].ContainsLoadAddress (addr, &target))
+            continue;
+
+        if (!m_instruction_ranges[i])
+        {
+            ExecutionContext exe_ctx;
+            m_thread.CalculateExecutionContext (exe_ctx);
+            m_instruction_ranges[i] = Disassembler::DisassembleRange (target.GetArchitecture(),
+                                                                      NULL,
+                                                                      exe_ctx,
+                                                                      m_address_ranges[i]);
+        }
+        if (!m_instruction_ranges[i])
+            return NULL;
+
+        // If the pc isn't at the start of one of the instructions we
+        // disassembled, we can't trust the disassembly.
+        InstructionList &instructions = m_instruction_ranges[i]->GetInstructionList();
+        const size_t num_instructions = instructions.GetSize();
+        for (size_t j = 0; j < num_instructions; j++)
+        {
+            if (instructions.GetInstructionAtIndex(j)->GetAddress().GetLoadAddress(&target) == addr)
+            {
+                range_index = i;
+                insn_offset = j;
+                return &instructions;
+            }
+        }
+        return NULL;
+    }
+    return NULL;
+}
+
+bool
+ThreadPlanStepRange::SetNextBranchBreakpoint ()
+{
+    if (m_next_branch_bp_sp)
+        return true;
+
+    Target &target = m_thread.GetProcess().GetTarget();
+    if (!target.GetUseFastStepping())
+        return false;
+
+    // Only the x86 disassembler flags every instruction that can leave
+    // straight line code (returns, interrupts, system calls) as a branch.
+    const llvm::Triple::ArchType machine = target.GetArchitecture().GetMachine();
+    if (machine != llvm::Triple::x86 && machine != llvm::Triple::x86_64)
+        return false;
+
+    LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_STEP));
+    lldb::addr_t cur_addr = m_thread.GetRegisterContext()->GetPC();
+    size_t range_index = 0;
+    size_t pc_index = 0;
+    InstructionList *instructions = GetInstructionsForAddress (cur_addr, range_index, pc_index);
+    if (instructions == NULL)
+        return false;
+
+    // If we are sitting on the branch, let the plan step over it.
+    const size_t num_instructions = instructions->GetSize();
+    size_t branch_index = pc_index;
+    while (branch_index < num_instructions && !instructions->GetInstructionAtIndex(branch_index)->DoesBranch())
+        ++branch_index;
+    if (branch_index == pc_index)
+        return false;
+
+    lldb::addr_t run_to_addr;
+    if (branch_index < num_instructions)
+    {
+        run_to_addr = instructions->GetInstructionAtIndex(branch_index)->GetAddress().GetLoadAddress(&target);
+    }
+    else
+    {
+        // Nothing in the rest of the range branches, so run to the first
+        // instruction past its end.
+        InstructionSP last_insn_sp (instructions->GetInstructionAtIndex(num_instructions - 1));
+        run_to_addr = last_insn_sp->GetAddress().GetLoadAddress(&target) + last_insn_sp->GetOpcode().GetByteSize();
+    }
+    if (run_to_addr == LLDB_INVALID_ADDRESS)
+        return false;
+
+    m_next_branch_bp_sp = target.CreateBreakpoint (run_to_addr, true);
+    if (!m_next_branch_bp_sp)
+        return false;
+
+    if (m_next_branch_bp_sp->GetNumResolvedLocations() == 0)
+    {
+        // We couldn't insert a breakpoint there, fall back to stepping.
+        ClearNextBranchBreakpoint();
+        return false;
+    }
+
+    m_next_branch_bp_sp->SetThreadID (m_thread.GetID());
+
+    if (log)
+        log->Printf ("Step range plan running from 0x%llx to the next branch at 0x%llx (breakpoint %d), skipping %llu instructions.",
+                     cur_addr,
+                     run_to_addr,
+                     m_next_branch_bp_sp->GetID(),
+                     (uint64_t)(branch_index - pc_index));
+    return true;
+}
+
+void
+ThreadPlanStepRange::ClearNextBranchBreakpoint ()
+{
+    if (m_next_branch_bp_sp)
+    {
+        LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_STEP));
+        if (log)
+            log->Printf ("Removing next branch breakpoint: %d.", m_next_branch_bp_sp->GetID());
+        m_thread.GetProcess().GetTarget().RemoveBreakpointByID (m_next_branch_bp_sp->GetID());
+        m_next_branch_bp_sp.reset();
+    }
+}
+
+bool
+ThreadPlanStepRange::NextRangeBreakpointExplainsStop (lldb::StopInfoSP stop_info_sp)
+{
+    if (!m_next_branch_bp_sp)
+        return false;
+
+    break_id_t bp_site_id = stop_info_sp->GetValue();
+    BreakpointSiteSP bp_site_sp = m_thread.GetProcess().GetBreakpointSiteList().FindByID (bp_site_id);
+    if (!bp_site_sp || !bp_site_sp->IsBreakpointAtThisSite (m_next_branch_bp_sp->GetID()))
+        return false;
+
+    // If a user breakpoint shares the site, it should get to stop us.
+    const uint32_t num_owners = bp_site_sp->GetNumberOfOwners();
+    for (uint32_t i = 0; i < num_owners; i++)
+    {
+        if (&bp_site_sp->GetOwnerAtIndex(i)->GetBreakpoint() != m_next_branch_bp_sp.get())
+            return false;
+    }
+    return true;
+}
+
 bool
 ThreadPlanStepRange::WillStop ()
 {
+    // We may be stopping for a reason we don't explain, with the run to
+    // the next branch still pending. Don't leave the breakpoint behind.
+    ClearNextBranchBreakpoint();
     return true;
 }
 
+void
+ThreadPlanStepRange::WillPop ()
+{
+    // Popped plans may stay alive on the completed or discarded plan
+    // stacks, so remove the breakpoint now rather than when deleted.
+    ClearNextBranchBreakpoint();
+    ThreadPlan::WillPop();
+}
+
 StateType
 ThreadPlanStepRange::GetPlanRunState ()
 {
+    // Run to the next branch if we can, and only single step the branch
+    // itself.  The breakpoint is cleared again whenever we stop.
+    if (SetNextBranchBreakpoint())
+        return eStateRunning;
     return eStateStepping;
 }
 
@@ -301,6 +471,7 @@ ThreadPlanStepRange::MischiefManaged ()
         LogSP log(lldb_private::GetLogIfAllCategoriesSet (LIBLLDB_LOG_STEP));
         if (log)
             log->Printf("Completed step through range plan.");
+        ClearNextBranchBreakpoint();
         ThreadPlan::MischiefManaged ();
         return true;
     }
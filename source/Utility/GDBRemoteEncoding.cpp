@@ -0,0 +1,379 @@
+//===-- GDBRemoteEncoding.cpp -----------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#include "Utility/GDBRemoteEncoding.h"
+
+// C Includes
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+// C++ Includes
+#include <algorithm>
+#include <vector>
+
+// Other libraries and framework includes
+// Project includes
+
+enum
+{
+    // Run-length encoding
+    eRLEMinRepeat       = 3,    // Shorter runs are cheaper to send as they are
+    eRLEMaxRepeat       = 126 - 29, // The repeat count has to be a printable character
+
+    // LZSS compression
+    eLZSSWindowSize     = 4096,
+    eLZSSMinMatch       = 3,
+    eLZSSMaxMatch       = eLZSSMinMatch + 15,
+    eLZSSHashSize       = 4096,
+    eLZSSMaxChain       = 32,   // Match candidates to try at each position
+    eLZSSMinPayloadSize = 64    // Smaller payloads are sent as they are
+};
+
+const char *
+GDBRemoteEncoding::GetCompressionName (CompressionType type)
+{
+    switch (type)
+    {
+    case eCompressionNone:  return "none";
+    case eCompressionRLE:   return "rle";
+    case eCompressionLZSS:  return "lzss";
+    }
+    return "none";
+}
+
+bool
+GDBRemoteEncoding::GetCompressionType (const char *name, size_t name_len, CompressionType &type)
+{
+    if (name_len == 4 && ::strncmp (name, "none", 4) == 0)
+        type = eCompressionNone;
+    else if (name_len == 3 && ::strncmp (name, "rle", 3) == 0)
+        type = eCompressionRLE;
+    else if (name_len == 4 && ::strncmp (name, "lzss", 4) == 0)
+        type = eCompressionLZSS;
+    else
+        return false;
+    return true;
+}
+
+const char *
+GDBRemoteEncoding::GetSupportedCompressionNames ()
+{
+    return "lzss,rle";
+}
+
+void
+GDBRemoteEncoding::AppendEscapedBytes (std::string &dst, const void *src, size_t src_len)
+{
+    const uint8_t *bytes = (const uint8_t *)src;
+    for (size_t i = 0; i < src_len; ++i)
+    {
+        const uint8_t byte = bytes[i];
+        switch (byte)
+        {
+        case '#':
+        case '$':
+        case '}':
+        case '*':
+        case '\0':
+            dst.push_back ('}');
+            dst.push_back ((char)(byte ^ 0x20));
+            break;
+
+        default:
+            dst.push_back ((char)byte);
+            break;
+        }
+    }
+}
+
+size_t
+GDBRemoteEncoding::UnescapeBytes (const char *src, size_t src_len, void *dst, size_t dst_len)
+{
+    uint8_t *bytes = (uint8_t *)dst;
+    size_t bytes_decoded = 0;
+    for (size_t i = 0; i < src_len && bytes_decoded < dst_len; ++i)
+    {
+        uint8_t byte = src[i];
+        if (byte == '}')
+        {
+            if (++i == src_len)
+                break;
+            byte = src[i] ^ 0x20;
+        }
+        bytes[bytes_decoded++] = byte;
+    }
+    return bytes_decoded;
+}
+
+void
+GDBRemoteEncoding::CompressPayload (CompressionType type, const std::string &src, std::string &dst)
+{
+    switch (type)
+    {
+    case eCompressionNone:
+        break;
+
+    case eCompressionRLE:
+        RunLengthEncode (src, dst);
+        return;
+
+    case eCompressionLZSS:
+        if (src.size() >= eLZSSMinPayloadSize)
+        {
+            std::string compressed;
+            LZSSCompress ((const uint8_t *)src.data(), src.size(), compressed);
+            char header[32];
+            ::snprintf (header, sizeof(header), "*%llx:", (unsigned long long)src.size());
+            dst.assign (header);
+            AppendEscapedBytes (dst, compressed.data(), compressed.size());
+            if (dst.size() < src.size())
+                return;
+        }
+        break;
+    }
+    dst = src;
+}
+
+bool
+GDBRemoteEncoding::DecompressPayload (CompressionType type, const std::string &src, size_t max_byte_size, std::string &dst)
+{
+    switch (type)
+    {
+    case eCompressionNone:
+        break;
+
+    case eCompressionRLE:
+        return RunLengthDecode (src, max_byte_size, dst);
+
+    case eCompressionLZSS:
+        if (!src.empty() && src[0] == '*')
+        {
+            char *end = NULL;
+            const unsigned long long byte_size = ::strtoull (src.c_str() + 1, &end, 16);
+            if (end == src.c_str() + 1 || *end != ':' || byte_size > max_byte_size)
+                return false;
+            // Compressed payloads are escaped, unescaping only makes them
+            // smaller
+            const size_t data_offset = end + 1 - src.c_str();
+            std::string compressed (src.size() - data_offset, '\0');
+            compressed.resize (UnescapeBytes (src.data() + data_offset,
+                                              compressed.size(),
+                                              &compressed[0],
+                                              compressed.size()));
+            return LZSSDecompress ((const uint8_t *)compressed.data(),
+                                   compressed.size(),
+                                   byte_size,
+                                   dst);
+        }
+        break;
+    }
+    dst = src;
+    return true;
+}
+
+void
+GDBRemoteEncoding::RunLengthEncode (const std::string &src, std::string &dst)
+{
+    dst.clear();
+    dst.reserve (src.size());
+    const size_t src_len = src.size();
+    size_t i = 0;
+    while (i < src_len)
+    {
+        const char ch = src[i];
+        size_t repeat = 0;
+        while (i + 1 + repeat < src_len && src[i + 1 + repeat] == ch && repeat < eRLEMaxRepeat)
+            ++repeat;
+
+        // A '*' in the payload would be read back as a repeat count, send
+        // it escaped like binary data is. '}' is escaped too so that it
+        // can't be mistaken for an escaped '*'.
+        if (ch == '*' || ch == '}')
+        {
+            dst.push_back ('}');
+            dst.push_back ((char)(ch ^ 0x20));
+        }
+        else
+        {
+            dst.push_back (ch);
+        }
+        if (repeat >= eRLEMinRepeat)
+        {
+            // Repeat counts of 6 and 7 would be sent as '#' and '$'
+            if (repeat == 6 || repeat == 7)
+                repeat = 5;
+            dst.push_back ('*');
+            dst.push_back ((char)(repeat + 29));
+            i += 1 + repeat;
+        }
+        else
+        {
+            ++i;
+        }
+    }
+}
+
+bool
+GDBRemoteEncoding::RunLengthDecode (const std::string &src, size_t max_byte_size, std::string &dst)
+{
+    dst.clear();
+    dst.reserve (src.size());
+    const size_t src_len = src.size();
+    for (size_t i = 0; i < src_len; ++i)
+    {
+        const char ch = src[i];
+        if (ch == '*')
+        {
+            if (dst.empty() || i + 1 == src_len)
+                return false;
+            const int repeat = (uint8_t)src[++i] - 29;
+            if (repeat < 0)
+                return false;
+            if (dst.size() + repeat > max_byte_size)
+                return false;
+            dst.append (repeat, dst[dst.size() - 1]);
+        }
+        else if (ch == '}')
+        {
+            // A '*' or '}' escaped by RunLengthEncode
+            if (i + 1 == src_len)
+                return false;
+            dst.push_back ((char)(src[++i] ^ 0x20));
+        }
+        else
+        {
+            dst.push_back (ch);
+        }
+    }
+    return true;
+}
+
+static inline uint32_t
+LZSSHash (const uint8_t *p)
+{
+    return ((p[0] << 8) ^ (p[1] << 4) ^ p[2]) & (eLZSSHashSize - 1);
+}
+
+//----------------------------------------------------------------------
+// The compressed data is a series of groups of a flag byte followed by
+// up to eight items. If bit N of the flag byte (starting from the least
+// significant bit) is set, item N is a literal byte. Otherwise it is a
+// two byte match: the low byte of (distance - 1), then the upper four
+// bits of (distance - 1) and (length - eLZSSMinMatch).
+//----------------------------------------------------------------------
+void
+GDBRemoteEncoding::LZSSCompress (const uint8_t *src, size_t src_len, std::string &dst)
+{
+    std::vector<int32_t> head (eLZSSHashSize, -1);
+    std::vector<int32_t> prev (eLZSSWindowSize, -1);
+
+    dst.clear();
+    dst.reserve (src_len);
+    size_t flag_pos = 0;
+    uint32_t flag_bit = 8;
+    size_t pos = 0;
+    while (pos < src_len)
+    {
+        if (flag_bit == 8)
+        {
+            flag_pos = dst.size();
+            dst.push_back ('\0');
+            flag_bit = 0;
+        }
+
+        size_t best_len = 0;
+        size_t best_distance = 0;
+        if (pos + eLZSSMinMatch <= src_len)
+        {
+            const size_t max_len = std::min<size_t> (eLZSSMaxMatch, src_len - pos);
+            int32_t candidate = head[LZSSHash (src + pos)];
+            for (uint32_t chain = 0; candidate >= 0 && chain < eLZSSMaxChain; ++chain)
+            {
+                const size_t distance = pos - candidate;
+                if (distance > eLZSSWindowSize)
+                    break;
+                size_t len = 0;
+                while (len < max_len && src[candidate + len] == src[pos + len])
+                    ++len;
+                if (len > best_len)
+                {
+                    best_len = len;
+                    best_distance = distance;
+                    if (len == max_len)
+                        break;
+                }
+                candidate = prev[candidate & (eLZSSWindowSize - 1)];
+            }
+        }
+
+        size_t advance = 1;
+        if (best_len >= eLZSSMinMatch)
+        {
+            const uint32_t encoded_distance = best_distance - 1;
+            dst.push_back ((char)(encoded_distance & 0xff));
+            dst.push_back ((char)(((encoded_distance >> 8) << 4) | (best_len - eLZSSMinMatch)));
+            advance = best_len;
+        }
+        else
+        {
+            dst[flag_pos] |= (char)(1u << flag_bit);
+            dst.push_back ((char)src[pos]);
+        }
+        ++flag_bit;
+
+        for (size_t i = 0; i < advance; ++i, ++pos)
+        {
+            if (pos + eLZSSMinMatch <= src_len)
+            {
+                const uint32_t hash = LZSSHash (src + pos);
+                prev[pos & (eLZSSWindowSize - 1)] = head[hash];
+                head[hash] = pos;
+            }
+        }
+    }
+}
+
+bool
+GDBRemoteEncoding::LZSSDecompress (const uint8_t *src, size_t src_len, size_t dst_len, std::string &dst)
+{
+    dst.clear();
+    dst.reserve (dst_len);
+    size_t i = 0;
+    while (dst.size() < dst_len)
+    {
+        if (i == src_len)
+            return false;
+        const uint8_t flags = src[i++];
+        for (uint32_t bit = 0; bit < 8 && dst.size() < dst_len; ++bit)
+        {
+            if (flags & (1u << bit))
+            {
+                if (i == src_len)
+                    return false;
+                dst.push_back ((char)src[i++]);
+            }
+            else
+            {
+                if (i + 2 > src_len)
+                    return false;
+                const size_t distance = (src[i] | ((src[i + 1] >> 4) << 8)) + 1;
+                const size_t len = (src[i + 1] & 0xf) + eLZSSMinMatch;
+                i += 2;
+                if (distance > dst.size())
+                    return false;
+                // Matches may overlap the bytes they produce
+                const size_t start = dst.size() - distance;
+                for (size_t j = 0; j < len; ++j)
+                    dst.push_back (dst[start + j]);
+            }
+        }
+    }
+    return dst.size() == dst_len;
+}
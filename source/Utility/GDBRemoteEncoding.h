@@ -0,0 +1,111 @@
+//===-- GDBRemoteEncoding.h -------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+#ifndef utility_GDBRemoteEncoding_h_
+#define utility_GDBRemoteEncoding_h_
+
+// C Includes
+// C++ Includes
+#include <string>
+#include <stdint.h>
+
+// Other libraries and framework includes
+// Project includes
+
+//----------------------------------------------------------------------
+// Encodings of GDB remote protocol payloads that are shared by lldb and
+// the remote stubs, so this doesn't depend on anything else in lldb.
+//
+// Binary data escapes '#', '$', '}' and '*' as a '}' followed by the
+// byte XOR'ed with 0x20.  We escape NUL bytes too, so stubs that handle
+// packets as C strings can decode them.
+//
+// Compression applies to whole packet payloads, and is only used in
+// packets sent by a stub after the debugger asked for it with the
+// "QEnableCompression" packet:
+//
+//  rle     The run-length encoding from the GDB remote protocol: "c*N"
+//          repeats the character 'c' N - 29 more times. A '*' or '}' in
+//          the payload itself is escaped as '}' followed by the character
+//          xor 0x20.
+//
+//  lzss    "*<size>:<data>", where "size" is the hex byte size of the
+//          payload and "data" is the escaped LZSS compressed payload.
+//          Payloads that don't get any smaller are sent as they are; no
+//          payload can start with a '*', since it is escaped in binary
+//          data and is the repeat marker of run-length encoding.
+//----------------------------------------------------------------------
+class GDBRemoteEncoding
+{
+public:
+    enum CompressionType
+    {
+        eCompressionNone = 0,
+        eCompressionRLE,
+        eCompressionLZSS
+    };
+
+    static const char *
+    GetCompressionName (CompressionType type);
+
+    // Returns false if "name" isn't a compression type we know
+    static bool
+    GetCompressionType (const char *name,
+                        size_t name_len,
+                        CompressionType &type);
+
+    // Comma separated names of the compression types, best first
+    static const char *
+    GetSupportedCompressionNames ();
+
+    static void
+    AppendEscapedBytes (std::string &dst,
+                        const void *src,
+                        size_t src_len);
+
+    // Decodes up to "dst_len" bytes and returns how many were decoded
+    static size_t
+    UnescapeBytes (const char *src,
+                   size_t src_len,
+                   void *dst,
+                   size_t dst_len);
+
+    static void
+    CompressPayload (CompressionType type,
+                     const std::string &src,
+                     std::string &dst);
+
+    // Returns false if the payload is corrupt, or would decompress to
+    // more than "max_byte_size" bytes
+    static bool
+    DecompressPayload (CompressionType type,
+                       const std::string &src,
+                       size_t max_byte_size,
+                       std::string &dst);
+
+private:
+    static void
+    RunLengthEncode (const std::string &src, std::string &dst);
+
+    static bool
+    RunLengthDecode (const std::string &src,
+                     size_t max_byte_size,
+                     std::string &dst);
+
+    static void
+    LZSSCompress (const uint8_t *src, size_t src_len, std::string &dst);
+
+    static bool
+    LZSSDecompress (const uint8_t *src,
+                    size_t src_len,
+                    size_t dst_len,
+                    std::string &dst);
+};
+
+#endif  // utility_GDBRemoteEncoding_h_
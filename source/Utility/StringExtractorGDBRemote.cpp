@@ -78,12 +78,45 @@ StringExtractorGDBRemote::GetServerPacketType () const
 
     case 'A':
         return eServerPacketType_A;
+
+    case '?':
+        if (packet_size == 1) return eServerPacketType_stop_reason;
+        break;
+
+    case 'c':   return eServerPacketType_c;
+    case 'C':   return eServerPacketType_C;
+    case 's':   return eServerPacketType_s;
+    case 'S':   return eServerPacketType_S;
+    case 'm':   return eServerPacketType_m;
+    case 'M':   return eServerPacketType_M;
+    case 'x':   return eServerPacketType_x;
+    case 'X':   return eServerPacketType_X;
+    case 'p':   return eServerPacketType_p;
+    case 'P':   return eServerPacketType_P;
+    case 'g':   return eServerPacketType_g;
+    case 'G':   return eServerPacketType_G;
+    case 'Z':   return eServerPacketType_Z;
+    case 'z':   return eServerPacketType_z;
+    case 'H':   return eServerPacketType_H;
+    case 'T':   return eServerPacketType_T;
+    case 'D':   return eServerPacketType_D;
+
+    case 'k':
+        if (packet_size == 1) return eServerPacketType_k;
+        break;
+
+    case 'v':
+        if (PACKET_MATCHES ("vCont?"))                          return eServerPacketType_vCont_actions;
+        else if (PACKET_STARTS_WITH ("vCont;"))                 return eServerPacketType_vCont;
+        else if (PACKET_STARTS_WITH ("vAttach;"))               return eServerPacketType_vAttach;
+        break;
             
     case 'Q':
         switch (packet_cstr[1])
         {
         case 'E':
             if (PACKET_STARTS_WITH ("QEnvironment:"))           return eServerPacketType_QEnvironment; 
+            else if (PACKET_STARTS_WITH ("QEnableCompression:"))return eServerPacketType_QEnableCompression;
             break;
 
         case 'S':
@@ -94,6 +127,10 @@ StringExtractorGDBRemote::GetServerPacketType () const
             else if (PACKET_STARTS_WITH ("QSetSTDERR:"))        return eServerPacketType_QSetSTDERR;
             else if (PACKET_STARTS_WITH ("QSetWorkingDir:"))    return eServerPacketType_QSetWorkingDir;
             break;
+
+        case 'T':
+            if (PACKET_MATCHES ("QThreadSuffixSupported"))      return eServerPacketType_QThreadSuffixSupported;
+            break;
         }
         break;
             
@@ -102,10 +139,12 @@ StringExtractorGDBRemote::GetServerPacketType () const
         {
         case 's':
             if (PACKET_MATCHES ("qsProcessInfo"))               return eServerPacketType_qsProcessInfo;
+            else if (PACKET_MATCHES ("qsThreadInfo"))           return eServerPacketType_qsThreadInfo;
             break;
 
         case 'f':
             if (PACKET_STARTS_WITH ("qfProcessInfo"))           return eServerPacketType_qfProcessInfo;
+            else if (PACKET_MATCHES ("qfThreadInfo"))           return eServerPacketType_qfThreadInfo;
             break;
 
         case 'C':
@@ -129,8 +168,18 @@ StringExtractorGDBRemote::GetServerPacketType () const
             if (PACKET_STARTS_WITH ("qProcessInfoPID:"))        return eServerPacketType_qProcessInfoPID;
             break;
 
+        case 'R':
+            if (PACKET_STARTS_WITH ("qRegisterInfo"))           return eServerPacketType_qRegisterInfo;
+            break;
+
         case 'S':
             if (PACKET_STARTS_WITH ("qSpeedTest:"))             return eServerPacketType_qSpeedTest;
+            else if (PACKET_STARTS_WITH ("qSupported"))         return eServerPacketType_qSupported;
+            break;
+
+        case 'T':
+            if (PACKET_STARTS_WITH ("qThreadStopInfo"))         return eServerPacketType_qThreadStopInfo;
+            else if (PACKET_STARTS_WITH ("qThreadStopSnapshot:")) return eServerPacketType_qThreadStopSnapshot;
             break;
 
         case 'U':
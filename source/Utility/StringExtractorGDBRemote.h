@@ -56,14 +56,44 @@ public:
         eServerPacketType_qLaunchSuccess,
         eServerPacketType_qProcessInfoPID,
         eServerPacketType_qSpeedTest,
+        eServerPacketType_qSupported,
         eServerPacketType_qUserName,
+        eServerPacketType_QEnableCompression,
         eServerPacketType_QEnvironment,
         eServerPacketType_QSetDisableASLR,
         eServerPacketType_QSetSTDIN,
         eServerPacketType_QSetSTDOUT,
         eServerPacketType_QSetSTDERR,
         eServerPacketType_QSetWorkingDir,
-        eServerPacketType_QStartNoAckMode
+        eServerPacketType_QStartNoAckMode,
+        eServerPacketType_QThreadSuffixSupported,
+        eServerPacketType_qfThreadInfo,
+        eServerPacketType_qsThreadInfo,
+        eServerPacketType_qRegisterInfo,
+        eServerPacketType_qThreadStopInfo,
+        eServerPacketType_qThreadStopSnapshot,
+        eServerPacketType_stop_reason, // '?' packet
+        eServerPacketType_c,
+        eServerPacketType_C,
+        eServerPacketType_s,
+        eServerPacketType_S,
+        eServerPacketType_vCont,
+        eServerPacketType_vCont_actions, // "vCont?" packet
+        eServerPacketType_vAttach,
+        eServerPacketType_m,
+        eServerPacketType_M,
+        eServerPacketType_x,
+        eServerPacketType_X,
+        eServerPacketType_p,
+        eServerPacketType_P,
+        eServerPacketType_g,
+        eServerPacketType_G,
+        eServerPacketType_Z,
+        eServerPacketType_z,
+        eServerPacketType_H,
+        eServerPacketType_T,
+        eServerPacketType_k,
+        eServerPacketType_D
     };
     
     ServerPacketType
@@ -55,6 +55,7 @@
 #include "Plugins/DynamicLoader/POSIX-DYLD/DynamicLoaderPOSIXDYLD.h"
 #include "Plugins/Platform/Linux/PlatformLinux.h"
 #include "Plugins/Process/Linux/ProcessLinux.h"
+#include "Plugins/Process/elf-core/ProcessElfCore.h"
 #endif
 
 #if defined (__FreeBSD__)
@@ -62,6 +63,7 @@
 #include "Plugins/Platform/FreeBSD/PlatformFreeBSD.h"
 #include "Plugins/Process/POSIX/ProcessPOSIX.h"
 #include "Plugins/Process/FreeBSD/ProcessFreeBSD.h"
+#include "Plugins/Process/elf-core/ProcessElfCore.h"
 #endif
 
 #include "Plugins/Platform/gdb-server/PlatformRemoteGDBServer.h"
@@ -123,11 +125,13 @@ lldb_private::Initialize ()
         //----------------------------------------------------------------------
         PlatformLinux::Initialize();
         ProcessLinux::Initialize();
+        ProcessElfCore::Initialize();
         DynamicLoaderPOSIXDYLD::Initialize();
 #endif
 #if defined (__FreeBSD__)
         PlatformFreeBSD::Initialize();
         ProcessFreeBSD::Initialize();
+        ProcessElfCore::Initialize();
         DynamicLoaderPOSIXDYLD::Initialize();
 #endif
         //----------------------------------------------------------------------
@@ -195,12 +199,14 @@ lldb_private::Terminate ()
 #if defined (__linux__)
     PlatformLinux::Terminate();
     ProcessLinux::Terminate();
+    ProcessElfCore::Terminate();
     DynamicLoaderPOSIXDYLD::Terminate();
 #endif
 
 #if defined (__FreeBSD__)
     PlatformFreeBSD::Terminate();
     ProcessFreeBSD::Terminate();
+    ProcessElfCore::Terminate();
     DynamicLoaderPOSIXDYLD::Terminate();
 #endif
     
@@ -0,0 +1,93 @@
+"""Measure how many conditional breakpoint hits per second lldb can test."""
+
+import os, sys
+import unittest2
+import lldb
+import pexpect
+from lldbbench import *
+
+class ConditionalBreakpointHitsBench(BenchBase):
+
+    mydir = os.path.join("benchmarks", "breakpoint_condition")
+
+    def setUp(self):
+        BenchBase.setUp(self)
+        self.source = 'main.c'
+        self.line_before_loop = line_number(self.source, '// Set breakpoint before the loop here.')
+        self.line_in_loop = line_number(self.source, '// Set conditional breakpoint here.')
+        # Must match the default loop count in main.c.
+        self.num_hits = 1000
+        self.count = lldb.bmIterationCount
+        if self.count <= 0:
+            self.count = 5
+
+    @benchmarks_test
+    def test_interpreted_condition(self):
+        """Test hits per second of a condition that only reads variables."""
+        self.buildDefault()
+        print
+        self.run_lldb_conditional_breakpoint('i == %d' % (self.num_hits - 1), self.count)
+        print "lldb interpreted condition benchmark:", self.stopwatch
+        print "hits per second: %f" % (self.num_hits / self.stopwatch.avg())
+
+    @benchmarks_test
+    def test_jit_condition(self):
+        """Test hits per second of a condition that calls a function."""
+        self.buildDefault()
+        print
+        self.run_lldb_conditional_breakpoint('is_last(i, count)', self.count)
+        print "lldb JIT condition benchmark:", self.stopwatch
+        print "hits per second: %f" % (self.num_hits / self.stopwatch.avg())
+
+    def run_lldb_conditional_breakpoint(self, condition, count):
+        exe = os.path.join(os.getcwd(), 'a.out')
+
+        # Set self.child_prompt, which is "(lldb) ".
+        self.child_prompt = '(lldb) '
+        prompt = self.child_prompt
+
+        # So that the child gets torn down after the test.
+        self.child = pexpect.spawn('%s %s %s' % (self.lldbExec, self.lldbOption, exe))
+        child = self.child
+
+        # Turn on logging for what the child sends back.
+        if self.TraceOn():
+            child.logfile_read = sys.stdout
+
+        child.expect_exact(prompt)
+        child.sendline('breakpoint set -f %s -l %d' % (self.source, self.line_before_loop))
+        child.expect_exact(prompt)
+        child.sendline('breakpoint set -f %s -l %d' % (self.source, self.line_in_loop))
+        child.expect_exact(prompt)
+        child.sendline('breakpoint modify -c "%s" 2' % condition)
+        child.expect_exact(prompt)
+
+        # Reset the stopwatch now.
+        self.stopwatch.reset()
+        for i in range(count):
+            child.sendline('run')
+            child.expect_exact(prompt)
+            # Only the last iteration of the loop stops, time the rest.
+            with self.stopwatch:
+                child.sendline('process continue')
+                child.expect_exact(prompt)
+            child.sendline('process kill')
+            child.expect_exact(prompt)
+
+        child.sendline('log expression-cache dump')
+        child.expect_exact(prompt)
+
+        child.sendline('quit')
+        try:
+            self.child.expect(pexpect.EOF)
+        except:
+            pass
+
+        self.child = None
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
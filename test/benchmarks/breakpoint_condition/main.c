@@ -0,0 +1,32 @@
+//===-- main.c --------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+#include <stdio.h>
+#include <stdlib.h>
+
+int
+is_last (int i, int count)
+{
+    return i == count - 1;
+}
+
+int
+main (int argc, char const *argv[])
+{
+    int count = argc > 1 ? atoi (argv[1]) : 1000;
+    int sum = 0;
+    int i;
+
+    printf ("Starting the loop.\n"); // Set breakpoint before the loop here.
+    for (i = 0; i < count; ++i)
+    {
+        sum += i; // Set conditional breakpoint here.
+    }
+    printf ("sum = %d\n", sum);
+    return 0;
+}
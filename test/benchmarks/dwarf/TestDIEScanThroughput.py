@@ -0,0 +1,101 @@
+"""Test the throughput of scanning all DIEs in .debug_info while building the
+DWARF name indexes.  Each iteration spawns a fresh lldb so no module or index
+is reused, and does a regular expression function lookup, which indexes every
+compile unit.  It is important to specify an executable with a sizable
+.debug_info section and no apple accelerator tables as the inferior."""
+
+import os, sys
+import unittest2
+import lldb
+import pexpect
+from lldbbench import *
+
+class DIEScanThroughputBench(BenchBase):
+
+    mydir = os.path.join("benchmarks", "dwarf")
+
+    def setUp(self):
+        BenchBase.setUp(self)
+        if lldb.bmExecutable:
+            self.exe = lldb.bmExecutable
+        else:
+            self.exe = self.lldbHere
+        self.count = lldb.bmIterationCount
+        if self.count <= 0:
+            self.count = 10
+
+    @benchmarks_test
+    def test_die_scan_throughput(self):
+        """Measure how many MB/s of .debug_info lldb indexes."""
+        print
+        debug_info_size = self.get_debug_info_size(self.exe)
+        if debug_info_size == 0:
+            self.skipTest("'%s' has no .debug_info section" % self.exe)
+        self.run_lldb_index_debug_info(self.exe, self.count)
+        print "lldb DIE scan benchmark:", self.stopwatch
+        print "lldb DIE scan throughput: %.2f MB/s (.debug_info is %d bytes)" % (debug_info_size / self.stopwatch.avg() / (1024 * 1024),
+                                                                                 debug_info_size)
+
+    def get_debug_info_size(self, exe):
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+        module = target.GetModuleAtIndex(0)
+
+        def find_debug_info(section):
+            if section.GetName() in [".debug_info", "__debug_info"]:
+                return section.GetByteSize()
+            for i in range(section.GetNumSubSections()):
+                size = find_debug_info(section.GetSubSectionAtIndex(i))
+                if size:
+                    return size
+            return 0
+
+        for i in range(module.GetNumSections()):
+            size = find_debug_info(module.GetSectionAtIndex(i))
+            if size:
+                return size
+        return 0
+
+    def run_lldb_index_debug_info(self, exe, count):
+        # Set self.child_prompt, which is "(lldb) ".
+        self.child_prompt = '(lldb) '
+        prompt = self.child_prompt
+
+        # Reset the stopwatch now.
+        self.stopwatch.reset()
+        for i in range(count):
+            # So that the child gets torn down after the test.
+            self.child = pexpect.spawn('%s %s' % (self.lldbHere, self.lldbOption))
+            child = self.child
+
+            # Turn on logging for what the child sends back.
+            if self.TraceOn():
+                child.logfile_read = sys.stdout
+
+            # Don't let a cached index from an earlier run skip the scan.
+            child.sendline('settings set target.index-cache-path ""')
+            child.expect_exact(prompt)
+            child.sendline('file %s' % exe) # Aka 'target create'.
+            child.expect_exact(prompt)
+
+            with self.stopwatch:
+                # Index all compile units. The pattern doesn't match any function.
+                child.sendline('image lookup -r -n "^lldb_die_scan_bench_no_such_function$"')
+                child.expect_exact(prompt)
+
+            child.sendline('quit')
+            try:
+                self.child.expect(pexpect.EOF)
+            except:
+                pass
+
+        # The test is about to end and if we come to here, the child process has
+        # been terminated.  Mark it so.
+        self.child = None
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -67,6 +67,10 @@ class RepeatedExprsCase(BenchBase):
             child.sendline('process continue')
             child.expect_exact(prompt)        
 
+        # Show how often the compiled expressions could be reused.
+        child.sendline('log expression-cache dump')
+        child.expect_exact(prompt)
+
         child.sendline('quit')
         try:
             self.child.expect(pexpect.EOF)
@@ -35,7 +35,14 @@ class SteppingSpeedBench(BenchBase):
         self.run_lldb_steppings(self.exe, self.break_spec, self.count)
         print "lldb stepping benchmark:", self.stopwatch
 
-    def run_lldb_steppings(self, exe, break_spec, count):
+    @benchmarks_test
+    def test_run_lldb_steppings_single_stepping(self):
+        """Test lldb steppings on a large executable, single-stepping every instruction."""
+        print
+        self.run_lldb_steppings(self.exe, self.break_spec, self.count, fast_stepping=False)
+        print "lldb single-stepping benchmark:", self.stopwatch
+
+    def run_lldb_steppings(self, exe, break_spec, count, fast_stepping=True):
         # Set self.child_prompt, which is "(lldb) ".
         self.child_prompt = '(lldb) '
         prompt = self.child_prompt
@@ -49,6 +56,9 @@ class SteppingSpeedBench(BenchBase):
             child.logfile_read = sys.stdout
 
         child.expect_exact(prompt)
+        if not fast_stepping:
+            child.sendline('settings set target.use-fast-stepping false')
+            child.expect_exact(prompt)
         child.sendline('breakpoint set %s' % break_spec)
         child.expect_exact(prompt)
         child.sendline('run')
@@ -0,0 +1,84 @@
+"""
+Test that expressions reused from the target's expression cache read the
+current values of variables and still get new result variables.
+"""
+
+import os, time
+import unittest2
+import lldb
+from lldbtest import *
+
+class ExpressionCacheTestCase(TestBase):
+
+    mydir = os.path.join("expression_command", "expression_cache")
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line numbers to break at.
+        self.loop_line = line_number('main.c', '// Set break point in loop.')
+        self.base_case_line = line_number('main.c', '// Set break point at base case.')
+
+    def test_reused_expressions(self):
+        """Test that cached expressions are evaluated against the current frame."""
+        self.buildDefault()
+
+        self.runCmd("file a.out", CURRENT_EXECUTABLE_SET)
+
+        self.expect("breakpoint set -f main.c -l %d" % self.loop_line,
+                    BREAKPOINT_CREATED,
+            startstr = "Breakpoint created: 1: file ='main.c', line = %d" %
+                        self.loop_line)
+
+        self.expect("breakpoint set -f main.c -l %d" % self.base_case_line,
+                    BREAKPOINT_CREATED,
+            startstr = "Breakpoint created: 2: file ='main.c', line = %d" %
+                        self.base_case_line)
+
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        self.runCmd("log expression-cache reset")
+
+        # The same expression is evaluated on every iteration of the loop
+        # and must see the new values of the loop variables each time.
+        self.expect("expression i * 100 + total",
+            startstr = "(int) $0 = 0")
+
+        self.runCmd("process continue")
+        self.expect("expression i * 100 + total",
+            startstr = "(int) $1 = 100")
+
+        self.runCmd("process continue")
+        self.expect("expression i * 100 + total",
+            startstr = "(int) $2 = 210")
+
+        # Earlier results keep their values.
+        self.expect("expression $0 + $1",
+            startstr = "(int) $3 = 100")
+
+        # Stop in the innermost call of factorial (3).
+        self.runCmd("process continue")
+
+        # The frames of the recursion share their blocks, so the expression
+        # is reused, but it must read each frame's own argument.
+        self.expect("expression n * 2",
+            startstr = "(int) $4 = 2")
+
+        self.runCmd("frame select 1")
+        self.expect("expression n * 2",
+            startstr = "(int) $5 = 4")
+
+        self.runCmd("frame select 2")
+        self.expect("expression n * 2",
+            startstr = "(int) $6 = 6")
+
+        # Make sure the expressions above were actually reused.
+        self.expect("log expression-cache dump",
+            patterns = [" [1-9][0-9]* hits"])
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,25 @@
+//===-- main.c --------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+int
+factorial (int n)
+{
+    if (n <= 1)
+        return 1; // Set break point at base case.
+    return n * factorial (n - 1);
+}
+
+int main (int argc, char const *argv[])
+{
+    int total = 0;
+    int i;
+    for (i = 0; i < 3; ++i)
+        total += i * 10; // Set break point in loop.
+    return total + factorial (3);
+}
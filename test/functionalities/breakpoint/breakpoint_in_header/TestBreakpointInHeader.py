@@ -0,0 +1,68 @@
+"""
+Test that a file and line breakpoint in a header file resolves in every
+compile unit that includes the header.
+"""
+
+import os, time
+import unittest2
+import lldb
+from lldbtest import *
+
+class BreakpointInHeaderTestCase(TestBase):
+
+    mydir = os.path.join("functionalities", "breakpoint", "breakpoint_in_header")
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    def test_with_dsym_and_run_command(self):
+        """Test 'b header.h:<line>' breaks in each compile unit including header.h."""
+        self.buildDsym()
+        self.breakpoint_in_header()
+
+    def test_with_dwarf_and_run_command(self):
+        """Test 'b header.h:<line>' breaks in each compile unit including header.h."""
+        self.buildDwarf()
+        self.breakpoint_in_header()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line number to break inside header.h.
+        self.line = line_number('header.h', '// Set break point at this line.')
+
+    def breakpoint_in_header(self):
+        """Test 'b header.h:<line>' breaks in each compile unit including header.h."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+
+        # header.h is only named in the line tables of main.c and a.c,
+        # never as the main file of a compile unit.
+        self.expect("breakpoint set -f header.h -l %d" % self.line,
+                    BREAKPOINT_CREATED,
+            startstr = "Breakpoint created: 1: file ='header.h', line = %d, locations = 2" %
+                        self.line)
+
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        # The stop reason of the thread should be breakpoint.
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+            substrs = ['stopped',
+                       'stop reason = breakpoint',
+                       'header.h:%d' % self.line])
+
+        self.runCmd("process continue")
+
+        # The copy in a.c is hit next.
+        self.expect("thread backtrace", STOPPED_DUE_TO_BREAKPOINT,
+            substrs = ['stop reason = breakpoint',
+                       'header.h:%d' % self.line,
+                       'a_function'])
+
+        self.expect("breakpoint list -f", BREAKPOINT_HIT_TWICE,
+            substrs = [' resolved, hit count = 2'])
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,16 @@
+//===-- header.h ------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// Each compile unit that includes this header gets its own copy of
+// header_function, so the breakpoint below has one location per copy.
+static int
+header_function (int value)
+{
+    return value * 2; // Set break point at this line.
+}
@@ -0,0 +1,18 @@
+//===-- main.c --------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+#include "header.h"
+
+extern int a_function (int value);
+extern int other_function (int value);
+
+int
+main (int argc, char const *argv[])
+{
+    return header_function (argc) + a_function (argc) + other_function (argc);
+}
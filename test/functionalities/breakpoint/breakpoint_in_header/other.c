@@ -0,0 +1,15 @@
+//===-- other.c -------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// Doesn't include header.h, so its line table doesn't mention it.
+int
+other_function (int value)
+{
+    return value + 3;
+}
@@ -0,0 +1,102 @@
+"""
+Test loading an x86_64 Linux core file with "target create --core-file" and
+reading its threads, registers and memory.
+
+The core file, linux-x86_64.core, is written by make-core.py.
+"""
+
+import os, sys
+import unittest2
+import lldb
+from lldbtest import *
+import lldbutil
+
+class ElfCoreTestCase(TestBase):
+
+    mydir = os.path.join("functionalities", "elf-core")
+
+    # The values make-core.py puts in the core file.
+    pid = 4242
+    tid2 = 4243
+    data_addr = 0x600000
+
+    @unittest2.skipUnless(sys.platform.startswith("linux") or sys.platform.startswith("freebsd"),
+                          "the elf-core plug-in is only built on Linux and FreeBSD")
+    def test_elf_core_with_dwarf(self):
+        """Test the threads, registers and memory of an ELF core file."""
+        if self.getArchitecture() not in ['', 'x86_64']:
+            self.skipTest("the core file is an x86_64 core file")
+        self.buildDwarf()
+        self.elf_core()
+
+    def elf_core(self):
+        """Load the core file and check what it contains."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        core = os.path.join(os.getcwd(), "linux-x86_64.core")
+
+        self.expect("target create --core-file %s %s" % (core, exe),
+            substrs = ["Core file '%s' (x86_64) was loaded." % core])
+
+        target = self.dbg.GetSelectedTarget()
+        process = target.GetProcess()
+        self.assertTrue(process.IsValid(), PROCESS_IS_VALID)
+        self.assertTrue(process.GetProcessID() == self.pid)
+
+        # Both threads are there, the first one got the SIGSEGV.
+        self.assertTrue(process.GetNumThreads() == 2)
+        self.assertTrue(process.GetThreadAtIndex(0).GetThreadID() == self.pid)
+        self.assertTrue(process.GetThreadAtIndex(1).GetThreadID() == self.tid2)
+        thread = lldbutil.get_stopped_thread(process, lldb.eStopReasonSignal)
+        self.assertTrue(thread.IsValid() and thread.GetThreadID() == self.pid,
+                        "the crashing thread stopped with a signal")
+        self.assertTrue(thread.GetStopReasonDataAtIndex(0) == 11)
+
+        self.expect("thread list",
+            patterns = ["thread #1: tid = 0x0*%x" % self.pid,
+                        "thread #2: tid = 0x0*%x" % self.tid2])
+
+        # The registers of each thread come from its NT_PRSTATUS and
+        # NT_FPREGSET notes.
+        self.runCmd("thread select 1")
+        self.expect("register read rip rsp rbp rax rbx rflags",
+            substrs = ["rip = 0x0000000000400123",
+                       "rsp = 0x000000007fff0000",
+                       "rbp = 0x000000007fff0010",
+                       "rax = 0x0000000000001111",
+                       "rbx = 0x0000000000002222",
+                       "rflags = 0x0000000000000246"])
+        self.expect("register read mxcsr",
+            substrs = ["mxcsr = 0x00001f80"])
+
+        self.runCmd("thread select 2")
+        self.expect("register read rip rsp rax",
+            substrs = ["rip = 0x0000000000400456",
+                       "rsp = 0x000000007ffe0000",
+                       "rax = 0x0000000000003333"])
+
+        # The data segment has 16 bytes in the file, the rest of it reads
+        # as zeros.
+        error = lldb.SBError()
+        content = process.ReadMemory(self.data_addr, 32, error)
+        self.assertTrue(error.Success(), "reading the data segment succeeds")
+        self.assertTrue(content == "lldb core file" + "\0" * 18)
+        self.expect("memory read --format c --count 14 0x%x" % self.data_addr,
+            substrs = ["lldb core file"])
+
+        # The text segment has no bytes in the core file and the memory past
+        # the data segment isn't in it at all, reading either fails.
+        process.ReadMemory(0x400000, 16, error)
+        self.assertTrue(error.Fail(), "the text segment isn't in the core file")
+        process.ReadMemory(self.data_addr + 32, 16, error)
+        self.assertTrue(error.Fail(), "nothing past the data segment is in the core file")
+
+        # A process loaded from a core file can't run.
+        self.expect("process continue", error=True,
+            substrs = ["can't be resumed"])
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,15 @@
+//===-- main.c --------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// The core file isn't dumped from this program, "target create" just needs
+// an x86_64 ELF executable to go with it.
+int main (int argc, char const *argv[])
+{
+    return 0;
+}
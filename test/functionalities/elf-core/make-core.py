@@ -0,0 +1,99 @@
+#!/usr/bin/env python
+
+"""
+Write linux-x86_64.core, the core file used by TestElfCore.py.
+
+The core file is built by hand instead of being dumped by the kernel so that
+it is tiny and its contents are known. It has the program headers and notes
+a Linux x86_64 core file has: a PT_NOTE segment with an NT_PRPSINFO note and
+an NT_PRSTATUS and NT_FPREGSET note for each of its two threads, a PT_LOAD
+segment with some bytes in the file followed by zeros, and a PT_LOAD segment
+with nothing in the file, like the text of a mapped file.
+
+Usage: make-core.py [output-file]
+"""
+
+import struct, sys
+
+PID = 4242
+TID2 = 4243
+SIGSEGV = 11
+
+DATA_ADDR = 0x600000
+DATA_BYTES = b"lldb core file\0\0"
+DATA_MEMSZ = 0x20
+TEXT_ADDR = 0x400000
+TEXT_MEMSZ = 0x1000
+
+# The order of the registers in the pr_reg field of prstatus.
+GPR_NAMES = ["r15", "r14", "r13", "r12", "rbp", "rbx", "r11", "r10", "r9",
+             "r8", "rax", "rcx", "rdx", "rsi", "rdi", "orig_rax", "rip", "cs",
+             "rflags", "rsp", "ss", "fs_base", "gs_base", "ds", "es", "fs",
+             "gs"]
+
+def note(name, type, desc):
+    name = name.encode("ascii") + b"\0"
+    pad = lambda s: s + b"\0" * (-len(s) % 4)
+    return struct.pack("<III", len(name), len(desc), type) + pad(name) + pad(desc)
+
+def prstatus(tid, signo, regs):
+    # pr_info, pr_cursig, pr_sigpend, pr_sighold, pr_pid, pr_ppid, pr_pgrp,
+    # pr_sid and four timevals, then pr_reg and pr_fpvalid.
+    desc = struct.pack("<iiiH2xQQiiii", 0, 0, 0, signo, 0, 0, tid, 1, tid, tid)
+    desc += b"\0" * 64
+    desc += b"".join(struct.pack("<Q", regs.get(name, 0)) for name in GPR_NAMES)
+    desc += struct.pack("<i4x", 1)
+    assert len(desc) == 336
+    return note("CORE", 1, desc)
+
+def fpregset(mxcsr):
+    # The 512 byte fxsave area, mxcsr is at offset 24.
+    desc = b"\0" * 24 + struct.pack("<I", mxcsr) + b"\0" * (512 - 28)
+    return note("CORE", 2, desc)
+
+def prpsinfo(pid):
+    # pr_state, pr_sname, pr_zomb, pr_nice, pr_flag, pr_uid, pr_gid, pr_pid,
+    # pr_ppid, pr_pgrp, pr_sid, pr_fname and pr_psargs.
+    desc = struct.pack("<bcbb4xQIIiiii", 0, b"R", 0, 0, 0, 0, 0, pid, 1, pid, pid)
+    desc += b"a.out".ljust(16, b"\0") + b"./a.out".ljust(80, b"\0")
+    assert len(desc) == 136
+    return note("CORE", 3, desc)
+
+def main(path):
+    notes = prpsinfo(PID)
+    notes += prstatus(PID, SIGSEGV, {"rax": 0x1111, "rbx": 0x2222,
+                                     "rip": 0x400123, "rsp": 0x7fff0000,
+                                     "rbp": 0x7fff0010, "rflags": 0x246})
+    notes += fpregset(0x1f80)
+    notes += prstatus(TID2, 0, {"rax": 0x3333, "rip": 0x400456,
+                                "rsp": 0x7ffe0000})
+    notes += fpregset(0x1f80)
+
+    ehdr_size = 64
+    phdr_size = 56
+    num_phdrs = 3
+    notes_offset = ehdr_size + phdr_size * num_phdrs
+    data_offset = notes_offset + len(notes)
+
+    PT_LOAD, PT_NOTE = 1, 4
+    PF_X, PF_W, PF_R = 1, 2, 4
+    phdr = lambda type, flags, offset, vaddr, filesz, memsz, align: \
+        struct.pack("<IIQQQQQQ", type, flags, offset, vaddr, 0, filesz, memsz, align)
+
+    # e_ident, then ET_CORE for EM_X86_64 with the program headers right
+    # after the ELF header.
+    out = b"\x7fELF" + struct.pack("<BBBB8x", 2, 1, 1, 0)
+    out += struct.pack("<HHIQQQIHHHHHH", 4, 62, 1, 0, ehdr_size, 0, 0,
+                       ehdr_size, phdr_size, num_phdrs, 0, 0, 0)
+    out += phdr(PT_NOTE, 0, notes_offset, 0, len(notes), 0, 4)
+    out += phdr(PT_LOAD, PF_R | PF_X, data_offset, TEXT_ADDR, 0, TEXT_MEMSZ, 0x1000)
+    out += phdr(PT_LOAD, PF_R | PF_W, data_offset, DATA_ADDR, len(DATA_BYTES), DATA_MEMSZ, 0x1000)
+    out += notes
+    out += DATA_BYTES
+
+    f = open(path, "wb")
+    f.write(out)
+    f.close()
+
+if __name__ == '__main__':
+    main(sys.argv[1] if len(sys.argv) > 1 else "linux-x86_64.core")
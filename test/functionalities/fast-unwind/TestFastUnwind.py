@@ -0,0 +1,100 @@
+"""
+Test that backtraces from the fast unwinder match the ones from the full
+unwinder, and that asking for the registers of a frame from a fast unwind
+doesn't change the frames that were already listed.
+"""
+
+import os, time
+import unittest2
+import lldb
+from lldbutil import get_stopped_thread
+from lldbtest import *
+
+class FastUnwindTestCase(TestBase):
+
+    mydir = os.path.join("functionalities", "fast-unwind")
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    def test_fast_unwind_with_dsym(self):
+        """Test that the fast and the full unwinder find the same frames."""
+        self.buildDsym()
+        self.fast_unwind()
+
+    def test_fast_unwind_with_dwarf(self):
+        """Test that the fast and the full unwinder find the same frames."""
+        self.buildDwarf()
+        self.fast_unwind()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line number to break inside leaf().
+        self.line = line_number('main.c', '// Stop in leaf.')
+
+    def backtrace(self, fast_unwind):
+        """Launch the program, stop in leaf() and return its thread and the
+        function name and pc of every frame."""
+        self.runCmd("settings set target.process.thread.fast-unwind %s" % ("true" if fast_unwind else "false"))
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        breakpoint = target.BreakpointCreateByLocation("main.c", self.line)
+        self.assertTrue(breakpoint, VALID_BREAKPOINT)
+
+        process = target.LaunchSimple(None, None, os.getcwd())
+        self.assertTrue(process, PROCESS_IS_VALID)
+        thread = get_stopped_thread(process, lldb.eStopReasonBreakpoint)
+        self.assertTrue(thread, "There should be a thread stopped due to breakpoint")
+        return (thread, self.frames(thread))
+
+    def frames(self, thread):
+        """Return the function name and pc of every frame. Unlike the stack
+        pointer, these don't need the registers of the frames."""
+        return [(frame.GetFunctionName(), frame.GetPC())
+                for frame in [thread.GetFrameAtIndex(i) for i in range(thread.GetNumFrames())]]
+
+    def stack_pointers(self, thread, frame_indexes):
+        return [thread.GetFrameAtIndex(i).GetSP() for i in frame_indexes]
+
+    def fast_unwind(self):
+        """Compare the backtraces of the fast and the full unwinder."""
+        thread, full_frames = self.backtrace(False)
+        names = [name for (name, pc) in full_frames]
+        self.assertTrue(names[:9] == ["leaf", "with_buffer", "recurse", "recurse", "recurse",
+                                      "recurse", "recurse", "recurse", "main"],
+                        "Unexpected backtrace: %s" % str(names))
+        frame_indexes = range(len(full_frames))
+        full_sps = self.stack_pointers(thread, frame_indexes)
+        self.runCmd("process kill")
+
+        thread, fast_frames = self.backtrace(True)
+        self.assertTrue(fast_frames == full_frames,
+                        "Fast backtrace %s doesn't match full backtrace %s" % (str(fast_frames), str(full_frames)))
+
+        # Reading the variables of a frame needs its registers, which the
+        # fast unwind didn't compute. Getting them, out of order, must not
+        # change any of the frames.
+        for i in [3, 1, 8]:
+            frame = thread.GetFrameAtIndex(i)
+            self.assertTrue(frame.GetRegisters().GetSize() > 0)
+            local = frame.FindVariable("local" if frame.GetFunctionName() == "recurse" else "argc")
+            self.assertTrue(local.IsValid(), "Couldn't read a variable of frame %d" % i)
+            self.assertTrue(self.frames(thread) == fast_frames,
+                            "Frames changed after getting the registers of frame %d" % i)
+
+        # The registers match the ones the full unwinder found for each frame.
+        self.assertTrue(self.stack_pointers(thread, frame_indexes) == full_sps,
+                        "Stack pointers of the fast frames don't match the ones of the full unwind")
+        self.assertTrue(self.frames(thread) == fast_frames)
+
+        # The deepest recurse() frame got depth 0, the first one 5.
+        self.assertTrue(thread.GetFrameAtIndex(2).FindVariable("depth").GetValueAsUnsigned() == 0)
+        self.assertTrue(thread.GetFrameAtIndex(7).FindVariable("depth").GetValueAsUnsigned() == 5)
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
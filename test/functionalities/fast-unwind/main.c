@@ -0,0 +1,39 @@
+//===-- main.c --------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+#include <stdio.h>
+#include <string.h>
+
+int leaf (int depth)
+{
+    return depth * 2; // Stop in leaf.
+}
+
+int with_buffer (int depth)
+{
+    char buffer[256];
+    int result;
+    memset (buffer, depth, sizeof(buffer));
+    result = leaf (depth) + buffer[depth];
+    return result;
+}
+
+int recurse (int depth)
+{
+    int local = depth * 3;
+    if (depth == 0)
+        return with_buffer (local);
+    return recurse (depth - 1) + local;
+}
+
+int main (int argc, char const *argv[])
+{
+    int result = recurse (5);
+    printf ("result = %d\n", result);
+    return 0;
+}
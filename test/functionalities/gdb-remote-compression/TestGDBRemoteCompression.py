@@ -0,0 +1,103 @@
+"""
+Test that memory written and read through debugserver comes back the same
+with each of the compression types of the GDB remote connection.
+"""
+
+import os, time, random
+import unittest2
+import lldb
+from lldbutil import get_stopped_thread
+from lldbtest import *
+
+class GDBRemoteCompressionTestCase(TestBase):
+
+    mydir = os.path.join("functionalities", "gdb-remote-compression")
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    def test_compression_with_dsym(self):
+        """Test memory round trips with no, rle and lzss compression."""
+        self.buildDsym()
+        self.compression()
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "processes are debugged through debugserver only on Darwin")
+    def test_compression_with_dwarf(self):
+        """Test memory round trips with no, rle and lzss compression."""
+        self.buildDwarf()
+        self.compression()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line number to break at.
+        self.line = line_number('main.c', '// Break here.')
+        self.old_compression = os.environ.get("LLDB_GDB_REMOTE_COMPRESSION")
+        def restore_compression():
+            if self.old_compression is None:
+                del os.environ["LLDB_GDB_REMOTE_COMPRESSION"]
+            else:
+                os.environ["LLDB_GDB_REMOTE_COMPRESSION"] = self.old_compression
+        self.addTearDownHook(restore_compression)
+
+    def compression_test_data(self):
+        """Return data that exercises the corner cases of the encodings."""
+        # Every byte value, including the ones that have to be escaped.
+        data = "".join([chr(i) for i in range(256)]) * 2
+        # Runs of every length up to more than fits in one repeat count, of
+        # bytes that are escaped or are the repeat marker and of ordinary
+        # ones. Runs of 7 and 8 bytes would need repeat counts of 6 and 7,
+        # which are sent as '#' and '$'.
+        for length in range(1, 120):
+            data += "#$}*\0a"[length % 6] * length
+        # Matches that overlap the bytes they produce, at distances of 1
+        # and 3, and a match from near the far end of the window.
+        data += "x" * 300 + "abc" * 200
+        rand = random.Random(7)
+        block = "".join([chr(rand.randint(0, 255)) for i in range(3000)])
+        data += block + "-" * 500 + block
+        return data
+
+    def compression(self):
+        """Write the test data and read it back with each compression type."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        data = self.compression_test_data()
+
+        for compression in ["none", "rle", "lzss"]:
+            # ProcessGDBRemote reads this when it connects to debugserver.
+            os.environ["LLDB_GDB_REMOTE_COMPRESSION"] = compression
+
+            target = self.dbg.CreateTarget(exe)
+            self.assertTrue(target, VALID_TARGET)
+            breakpoint = target.BreakpointCreateByLocation("main.c", self.line)
+            self.assertTrue(breakpoint, VALID_BREAKPOINT)
+
+            process = target.LaunchSimple(None, None, os.getcwd())
+            self.assertTrue(process, PROCESS_IS_VALID)
+            thread = get_stopped_thread(process, lldb.eStopReasonBreakpoint)
+            self.assertTrue(thread, "There should be a thread stopped due to breakpoint")
+            frame = thread.GetFrameAtIndex(0)
+            addr = frame.EvaluateExpression("(unsigned long)g_buffer").GetValueAsUnsigned()
+            self.assertTrue(addr != 0)
+
+            # Writing flushes the memory cache, so the reads go to
+            # debugserver. Read in pieces of several sizes, so there are
+            # both replies too small to compress and large ones.
+            error = lldb.SBError()
+            self.assertTrue(process.WriteMemory(addr, data, error) == len(data) and error.Success(),
+                            "Failed to write memory with %s compression" % compression)
+            for size in [0x10, 0x100, 0x1000, len(data)]:
+                process.WriteMemory(addr, data, error)
+                for offset in range(0, len(data), size):
+                    chunk = data[offset:offset + size]
+                    content = process.ReadMemory(addr + offset, len(chunk), error)
+                    self.assertTrue(error.Success() and content == chunk,
+                                    "Wrong bytes read at offset %d with %s compression" % (offset, compression))
+
+            process.Kill()
+            self.dbg.DeleteTarget(target)
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
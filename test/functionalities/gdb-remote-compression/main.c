@@ -0,0 +1,17 @@
+//===-- main.c --------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+#include <stdio.h>
+
+unsigned char g_buffer[32768];
+
+int main (int argc, char const *argv[])
+{
+    printf ("g_buffer = %p\n", g_buffer); // Break here.
+    return 0;
+}
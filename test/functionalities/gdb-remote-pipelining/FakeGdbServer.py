@@ -0,0 +1,155 @@
+#!/usr/bin/env python
+
+"""
+A fake GDB remote stub for testing how lldb sends packets.
+
+It debugs a pretend process with one stopped thread, the x86_64 general
+purpose registers and a megabyte of memory. The stub holds its responses
+back until the client stops sending, then prints the packets it got as one
+"batch:" line and answers them in order. That way the batches show how
+many packets the client had in flight at once.
+"""
+
+import optparse, re, select, socket, struct, sys
+
+MEMORY_START = 0x100000
+MEMORY_END = 0x200000
+
+REGISTERS = ["rax", "rbx", "rcx", "rdx", "rsi", "rdi", "rbp", "rsp",
+             "r8", "r9", "r10", "r11", "r12", "r13", "r14", "r15", "rip"]
+GENERIC_REGISTERS = {"rbp": "fp", "rsp": "sp", "rip": "pc"}
+
+# How long the client has to be quiet before the stub answers
+QUIET_SECONDS = 0.05
+
+def memory_byte(addr):
+    """Return the byte at an address. Neighbouring lines of memory differ,
+    so a response for the wrong address doesn't look right."""
+    return chr((addr + (addr >> 8) + (addr >> 16)) & 0xff)
+
+def register_value(reg):
+    """Return the value of a register, by number."""
+    name = REGISTERS[reg]
+    if name == "rip":
+        return MEMORY_START + 0x100
+    if name == "rsp":
+        return MEMORY_END - 0x1000
+    if name == "rbp":
+        return MEMORY_END - 0xf00
+    return 0x0101010101010101 * (reg + 1)
+
+class FakeGdbServer:
+
+    def __init__(self, options):
+        self.options = options
+        self.no_ack_mode = False
+
+    def handle_packet(self, packet):
+        """Return the response to a packet, or None to send none."""
+        if packet == "QStartNoAckMode":
+            if self.options.acks:
+                return ""
+            return "OK"
+        if packet.startswith("qSupported"):
+            # 0x48 byte packets hold 20 bytes of memory, so a 512 byte
+            # memory cache line takes 26 packets
+            return "PacketSize=48;pipelining+"
+        if packet == "qHostInfo":
+            if sys.platform.startswith("darwin"):
+                return "cputype:16777223;cpusubtype:3;ostype:macosx;vendor:apple;endian:little;ptrsize:8;"
+            return "triple:%s;endian:little;ptrsize:8;" % "x86_64-pc-linux-gnu".encode("hex")
+        if packet == "qC":
+            return "QC4d2"
+        if packet == "qfThreadInfo":
+            return "m1"
+        if packet == "qsThreadInfo":
+            return "l"
+        if packet in ["?", "c"] or packet.startswith("qThreadStopInfo"):
+            return "T05thread:1;"
+        if packet.startswith("H"):
+            return "OK"
+        if packet.startswith("qRegisterInfo"):
+            reg = int(packet[len("qRegisterInfo"):], 16)
+            if reg >= len(REGISTERS):
+                return "E45"
+            name = REGISTERS[reg]
+            info = "name:%s;bitsize:64;offset:%d;encoding:uint;format:hex;set:General Purpose Registers;" % (name, reg * 8)
+            if name in GENERIC_REGISTERS:
+                info += "generic:%s;" % GENERIC_REGISTERS[name]
+            return info
+        if packet.startswith("p"):
+            reg = int(packet[1:].split(";")[0], 16)
+            if reg >= len(REGISTERS) or reg == self.options.error_register:
+                return "E45"
+            return struct.pack("<Q", register_value(reg)).encode("hex")
+        if packet.startswith("m"):
+            addr, size = [int(s, 16) for s in packet[1:].split(",")]
+            if addr < MEMORY_START or addr >= MEMORY_END:
+                return "E03"
+            size = min(size, MEMORY_END - addr)
+            if self.options.error_address is not None and addr <= self.options.error_address < addr + size:
+                return "E03"
+            return "".join([memory_byte(addr + i) for i in range(size)]).encode("hex")
+        if packet == "k":
+            return "X09"
+        return ""
+
+    def send_packet(self, conn, payload):
+        checksum = sum(ord(c) for c in payload) & 0xff
+        conn.sendall("$%s#%2.2x" % (payload, checksum))
+
+    def serve(self, conn):
+        data = ""
+        pending = []
+        while True:
+            readable = select.select([conn], [], [], QUIET_SECONDS if pending else None)[0]
+            if readable:
+                chunk = conn.recv(4096)
+                if not chunk:
+                    return
+                data += chunk
+                while True:
+                    # Skip the client's acks
+                    data = data.lstrip("+-")
+                    match = re.match(r"\$([^#]*)#[0-9a-fA-F]{2}", data)
+                    if not match:
+                        break
+                    data = data[match.end():]
+                    if not self.no_ack_mode:
+                        conn.sendall("+")
+                    pending.append(match.group(1))
+                continue
+
+            print "batch: " + " ".join(pending)
+            sys.stdout.flush()
+            for packet in pending:
+                response = self.handle_packet(packet)
+                if response is not None:
+                    self.send_packet(conn, response)
+                if packet == "QStartNoAckMode" and response == "OK":
+                    self.no_ack_mode = True
+                if packet == "k":
+                    return
+            pending = []
+
+def main():
+    parser = optparse.OptionParser()
+    parser.add_option("--acks", action="store_true", default=False,
+                      help="refuse QStartNoAckMode, so the client keeps using acks")
+    parser.add_option("--error-address", type="int", default=None,
+                      help="answer memory reads that include this address with an error")
+    parser.add_option("--error-register", type="int", default=None,
+                      help="answer reads of this register with an error")
+    (options, args) = parser.parse_args()
+
+    s = socket.socket(socket.AF_INET, socket.SOCK_STREAM)
+    s.bind(("localhost", 0))
+    s.listen(1)
+    print "Listening on port %d" % s.getsockname()[1]
+    sys.stdout.flush()
+    conn, addr = s.accept()
+    FakeGdbServer(options).serve(conn)
+    conn.close()
+
+if __name__ == '__main__':
+    main()
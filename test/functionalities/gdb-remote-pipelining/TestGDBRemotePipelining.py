@@ -0,0 +1,173 @@
+"""
+Test that lldb pipelines independent memory and register reads to a stub
+that supports it, keeps them in order, and falls back to one packet at a
+time when the connection uses acks.
+"""
+
+import os, sys
+import unittest2
+import lldb
+import pexpect
+from lldbutil import get_GPRs
+from lldbtest import *
+from FakeGdbServer import MEMORY_START, REGISTERS, memory_byte, register_value
+
+class GDBRemotePipeliningTestCase(TestBase):
+
+    mydir = os.path.join("functionalities", "gdb-remote-pipelining")
+
+    # Packets in flight at once, eMaxOutstandingPackets in GDBRemoteCommunicationClient.cpp
+    max_outstanding_packets = 16
+
+    def test_pipelined_memory_reads(self):
+        """Test that memory reads have up to 16 packets in flight and get their responses in order."""
+        process = self.connect([])
+        self.batches()
+
+        for addr, size in [(MEMORY_START + 0x1000, 0x200), (MEMORY_START + 0x2000, 0x1000)]:
+            self.check_memory_read(process, addr, size)
+        batch_sizes = self.check_packet_order(self.batches(), "m")
+        self.assertTrue(max(batch_sizes) == self.max_outstanding_packets,
+                        "Memory read batches of %s packets" % batch_sizes)
+
+    def test_pipelined_register_reads(self):
+        """Test that the registers of a set are read with up to 16 packets in flight."""
+        process = self.connect([])
+        self.batches()
+
+        # Stopping again invalidates the registers, all 17 of them are
+        # read along with the pc.
+        process.Continue()
+        self.check_registers(process, None)
+        batches = self.batches_after_continue()
+        batch_sizes = self.check_packet_order(batches, "p")
+        self.assertTrue(max(batch_sizes) == self.max_outstanding_packets,
+                        "Register read batches of %s packets" % batch_sizes)
+        reads = [packet for batch in batches for packet in batch if packet.startswith("p")]
+        self.assertTrue(sorted(reads) == sorted(["p%x" % reg for reg in range(len(REGISTERS))]),
+                        "Each register is read once: %s" % reads)
+
+    def test_error_reply(self):
+        """Test that the responses after an error reply aren't taken for the responses to later packets."""
+        error_address = MEMORY_START + 0x1100
+        process = self.connect(["--error-address", "%#x" % error_address,
+                                "--error-register", "%d" % REGISTERS.index("rdx")])
+
+        # The read stops at the packet that got the error.
+        error = lldb.SBError()
+        content = process.ReadMemory(MEMORY_START + 0x1000, 0x200, error)
+        self.assertTrue(error.Success() and content, "The bytes before the error are read")
+        self.assertTrue(len(content) <= error_address - (MEMORY_START + 0x1000), "Bytes past the error are read")
+        self.assertTrue(content == self.expected_memory(MEMORY_START + 0x1000, len(content)),
+                        "Wrong bytes read before the error")
+
+        # The packets in flight after the one that failed were answered
+        # too, the next reads get their own responses.
+        self.check_memory_read(process, MEMORY_START + 0x2000, 0x1000)
+        process.Continue()
+        self.check_registers(process, "rdx")
+
+    def test_lock_step_with_acks(self):
+        """Test that packets are sent one at a time when the stub doesn't take QStartNoAckMode."""
+        process = self.connect(["--acks"])
+        self.batches()
+
+        self.check_memory_read(process, MEMORY_START + 0x1000, 0x200)
+        process.Continue()
+        self.check_registers(process, None)
+        batches = self.batches()
+        self.check_packet_order(batches, "m")
+        self.check_packet_order(batches, "p")
+        self.assertTrue(max([len(batch) for batch in batches]) == 1,
+                        "Packets were pipelined with acks on: %s" % batches)
+
+    def connect(self, args):
+        """Start the fake stub with the given arguments and connect to it.
+        Return the process."""
+        server = pexpect.spawn(sys.executable, [os.path.join(os.getcwd(), "FakeGdbServer.py")] + args)
+        if self.TraceOn():
+            server.logfile_read = sys.stdout
+        self.server = server
+        def shutdown_server():
+            server.close(force=True)
+        self.addTearDownHook(shutdown_server)
+
+        server.expect(r"Listening on port (\d+)")
+        port = int(server.match.group(1))
+        self.runCmd("process connect --plugin gdb-remote connect://localhost:%d" % port)
+        process = self.dbg.GetSelectedTarget().GetProcess()
+        self.assertTrue(process.GetState() == lldb.eStateStopped, PROCESS_STOPPED)
+        self.addTearDownHook(lambda: process.Kill())
+        return process
+
+    def batches(self):
+        """Return the batches of packets the stub got since the last call,
+        each one a list of packets that were in flight at once."""
+        output = ""
+        while True:
+            try:
+                output += self.server.read_nonblocking(4096, 0.5)
+            except pexpect.TIMEOUT:
+                break
+        return [line.split()[1:] for line in output.splitlines() if line.startswith("batch:")]
+
+    def batches_after_continue(self):
+        """Return the batches of packets the stub got after the last 'c'."""
+        batches = self.batches()
+        for i in reversed(range(len(batches))):
+            if "c" in batches[i]:
+                return batches[i + 1:]
+        self.fail("The process wasn't continued")
+
+    def check_packet_order(self, batches, command):
+        """Check that no more packets than the window were in flight, and
+        that the packets of a memory read went out in address order. Return
+        the sizes of the batches with packets of the given command."""
+        batch_sizes = []
+        next_addr = None
+        for batch in batches:
+            self.assertTrue(len(batch) <= self.max_outstanding_packets,
+                            "%d packets in flight at once" % len(batch))
+            packets = [packet for packet in batch if packet.startswith(command)]
+            if packets:
+                batch_sizes.append(len(batch))
+            if command != "m":
+                continue
+            for packet in packets:
+                addr, size = [int(s, 16) for s in packet[1:].split(",")]
+                self.assertTrue(next_addr is None or addr == next_addr or addr % 0x200 == 0,
+                                "Packet %s out of order" % packet)
+                next_addr = addr + size
+        self.assertTrue(batch_sizes, "No '%s' packets were sent" % command)
+        return batch_sizes
+
+    def expected_memory(self, addr, size):
+        return "".join([memory_byte(addr + i) for i in range(size)])
+
+    def check_memory_read(self, process, addr, size):
+        error = lldb.SBError()
+        content = process.ReadMemory(addr, size, error)
+        self.assertTrue(error.Success(), "Failed to read memory at %#x" % addr)
+        self.assertTrue(content == self.expected_memory(addr, size), "Wrong bytes read at %#x" % addr)
+
+    def check_registers(self, process, error_register):
+        """Check the general purpose registers of the only thread, the one
+        named error_register can't be read."""
+        frame = process.GetThreadAtIndex(0).GetFrameAtIndex(0)
+        names = []
+        for reg in get_GPRs(frame):
+            name = reg.GetName()
+            names.append(name)
+            if name == error_register:
+                self.assertTrue(reg.GetValue() is None, "%s has a value" % name)
+            else:
+                self.assertTrue(reg.GetValueAsUnsigned() == register_value(REGISTERS.index(name)),
+                                "Wrong value for %s" % name)
+        self.assertTrue(names == REGISTERS, "Wrong registers: %s" % names)
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,380 @@
+"""
+Test the Linux debug stub, lldb-gdbserver, by talking the GDB remote protocol
+to it directly.
+"""
+
+import os, random, re, socket, sys
+import unittest2
+import lldb
+import pexpect
+from lldbtest import *
+
+class GdbServerTestCase(TestBase):
+
+    mydir = os.path.join("functionalities", "gdbserver")
+
+    @unittest2.skipUnless(sys.platform.startswith("linux"), "lldb-gdbserver is only built on Linux")
+    def test_gdbserver_with_dwarf(self):
+        """Test launching, registers, memory and killing with lldb-gdbserver."""
+        if self.getArchitecture() not in ['', 'x86_64']:
+            self.skipTest("lldb-gdbserver only debugs x86_64 processes")
+        self.buildDwarf()
+        self.gdbserver()
+
+    @unittest2.skipUnless(sys.platform.startswith("linux"), "lldb-gdbserver is only built on Linux")
+    def test_gdbserver_encodings_with_dwarf(self):
+        """Test binary memory packets and compressed replies with lldb-gdbserver."""
+        if self.getArchitecture() not in ['', 'x86_64']:
+            self.skipTest("lldb-gdbserver only debugs x86_64 processes")
+        self.buildDwarf()
+        self.encodings()
+
+    @unittest2.skipUnless(sys.platform.startswith("linux"), "lldb-gdbserver is only built on Linux")
+    def test_gdbserver_thread_stop_snapshot_with_dwarf(self):
+        """Test the stop replies and stack memory of qThreadStopSnapshot with lldb-gdbserver."""
+        if self.getArchitecture() not in ['', 'x86_64']:
+            self.skipTest("lldb-gdbserver only debugs x86_64 processes")
+        self.buildDwarf()
+        self.thread_stop_snapshot()
+
+    def find_gdbserver(self):
+        """Return the path of lldb-gdbserver, next to the lldb under test."""
+        dirs = []
+        if "LLDB_BUILD_DIR" in os.environ:
+            dirs.append(os.environ["LLDB_BUILD_DIR"])
+        if "LLDB_EXEC" in os.environ:
+            dirs.append(os.path.dirname(os.environ["LLDB_EXEC"]))
+        for dir in dirs:
+            path = os.path.join(dir, "lldb-gdbserver")
+            if os.path.isfile(path) and os.access(path, os.X_OK):
+                return path
+        self.skipTest("lldb-gdbserver can't be found")
+
+    def send_packet(self, payload):
+        """Send a packet to the stub and return the payload of its reply."""
+        checksum = sum(ord(c) for c in payload) & 0xff
+        self.sock.sendall("$%s#%2.2x" % (payload, checksum))
+        data = ""
+        while True:
+            # Skip the acks from before we turned them off.
+            match = re.match(r"[+-]*\$([^#]*)#[0-9a-fA-F]{2}", data)
+            if match:
+                return match.group(1)
+            chunk = self.sock.recv(4096)
+            self.assertTrue(chunk, "the stub closed the connection")
+            data += chunk
+
+    def register_number(self, generic):
+        """Return the number of the register with the given generic name."""
+        reg = 0
+        while True:
+            info = self.send_packet("qRegisterInfo%x" % reg)
+            self.assertFalse(info.startswith("E"), "no register is the %s" % generic)
+            if "generic:%s;" % generic in info:
+                return reg
+            reg += 1
+
+    def read_register(self, reg):
+        """Return the value of a register of the stopped thread."""
+        reply = self.send_packet("p%x" % reg)
+        self.assertTrue(len(reply) == 16, "registers are 8 bytes")
+        return int("".join(reversed([reply[i:i+2] for i in range(0, 16, 2)])), 16)
+
+    def start_gdbserver(self):
+        """Start lldb-gdbserver, connect to it without acks and return the
+        features from its qSupported reply."""
+        server = pexpect.spawn(self.find_gdbserver(), ["localhost:0"])
+        if self.TraceOn():
+            server.logfile_read = sys.stdout
+        self.addTearDownHook(lambda: server.close(force=True))
+        self.server = server
+
+        server.expect(r"Listening for a connection on port (\d+)")
+        port = int(server.match.group(1))
+        self.sock = socket.create_connection(("localhost", port))
+        self.addTearDownHook(lambda: self.sock.close())
+
+        # The stub waits for an ack before it reads any packets.
+        self.sock.sendall("+")
+        self.assertTrue(self.send_packet("QStartNoAckMode") == "OK")
+
+        supported = self.send_packet("qSupported").split(";")
+        packet_sizes = [int(s[len("PacketSize="):], 16) for s in supported if s.startswith("PacketSize=")]
+        self.assertTrue(len(packet_sizes) == 1, "the stub advertises its packet size")
+        self.max_packet_size = packet_sizes[0]
+        return supported
+
+    def launch(self, args):
+        """Launch the program with the given arguments, it stops before
+        running any of its code. Return its pid."""
+        launch = ",".join("%d,%d,%s" % (len(arg) * 2, i, arg.encode("hex")) for i, arg in enumerate(args))
+        self.assertTrue(self.send_packet("A" + launch) == "OK")
+        self.assertTrue(self.send_packet("qLaunchSuccess") == "OK")
+        pid = int(self.send_packet("qC")[len("QC"):], 16)
+        self.assertTrue(pid > 0)
+        self.assertTrue(self.send_packet("?").startswith("T05"), "stopped with SIGTRAP")
+        return pid
+
+    def gdbserver(self):
+        """Launch a.out under lldb-gdbserver and check the packets it serves."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.start_gdbserver()
+        max_packet_size = self.max_packet_size
+        self.launch([exe, "one", "two"])
+
+        # The registers come from the table the Linux process plug-in uses,
+        # the stack pointer points at argc.
+        self.assertTrue(self.register_number("pc") != self.register_number("sp"))
+        sp = self.read_register(self.register_number("sp"))
+        argc = self.send_packet("m%x,8" % sp)
+        self.assertTrue(argc == "0300000000000000", "argc is 3")
+
+        # Memory can be written and read back.
+        self.assertTrue(self.send_packet("M%x,8:1122334455667788" % sp) == "OK")
+        self.assertTrue(self.send_packet("m%x,8" % sp) == "1122334455667788")
+        self.assertTrue(self.send_packet("M%x,8:%s" % (sp, argc)) == "OK")
+
+        # Memory packets for more than fits in a packet are refused.
+        self.assertTrue(self.send_packet("m%x,%x" % (sp, max_packet_size)).startswith("E"))
+        self.assertTrue(self.send_packet("m%x,ffffffffffffffff" % sp).startswith("E"))
+        self.assertTrue(self.send_packet("M%x,%x:00" % (sp, max_packet_size)).startswith("E"))
+
+        # Run the program to its end.
+        self.assertTrue(self.send_packet("c") == "W00", "the program exits with status 0")
+
+        # The stub exits after a kill.
+        self.assertTrue(self.send_packet("k") == "X09")
+        self.server.expect(pexpect.EOF)
+
+    def escape(self, data):
+        """Escape binary data the way the protocol requires it."""
+        return "".join(["}" + chr(ord(c) ^ 0x20) if c in "#$}*" else c for c in data])
+
+    def unescape(self, data):
+        """Undo the escaping of binary data."""
+        result = []
+        i = 0
+        while i < len(data):
+            if data[i] == "}":
+                i += 1
+                result.append(chr(ord(data[i]) ^ 0x20))
+            else:
+                result.append(data[i])
+            i += 1
+        return "".join(result)
+
+    def run_length_decode(self, payload):
+        """Decode a run-length encoded payload: "c*N" repeats 'c' N - 29
+        more times, '*' and '}' themselves are escaped."""
+        result = []
+        i = 0
+        while i < len(payload):
+            if payload[i] == "*":
+                i += 1
+                result.append(result[-1][-1] * (ord(payload[i]) - 29))
+            elif payload[i] == "}":
+                i += 1
+                result.append(chr(ord(payload[i]) ^ 0x20))
+            else:
+                result.append(payload[i])
+            i += 1
+        return "".join(result)
+
+    def lzss_decompress(self, payload):
+        """Decompress a "*<size>:<escaped data>" LZSS payload, other payloads
+        weren't compressed."""
+        if not payload.startswith("*"):
+            return payload
+        size, data = payload[1:].split(":", 1)
+        size = int(size, 16)
+        data = [ord(c) for c in self.unescape(data)]
+        result = []
+        i = 0
+        while len(result) < size:
+            flags = data[i]
+            i += 1
+            for bit in range(8):
+                if len(result) == size:
+                    break
+                if flags & (1 << bit):
+                    result.append(chr(data[i]))
+                    i += 1
+                else:
+                    distance = (data[i] | ((data[i + 1] >> 4) << 8)) + 1
+                    length = (data[i + 1] & 0xf) + 3
+                    i += 2
+                    self.assertTrue(distance <= len(result), "match before the start of the data")
+                    # Matches may overlap the bytes they produce.
+                    start = len(result) - distance
+                    for j in range(length):
+                        result.append(result[start + j])
+        self.assertTrue(i == len(data), "data left after the compressed payload")
+        return "".join(result)
+
+    def encoding_test_data(self):
+        """Return data that exercises the corner cases of the encodings."""
+        # Every byte value, including the ones that have to be escaped.
+        data = "".join([chr(i) for i in range(256)]) * 2
+        # Runs of every length up to more than fits in one repeat count, of
+        # bytes that are escaped or are the repeat marker and of ordinary
+        # ones. Runs of 7 and 8 bytes would need repeat counts of 6 and 7,
+        # which are sent as '#' and '$'.
+        for length in range(1, 120):
+            data += "#$}*\0a"[length % 6] * length
+        # Matches that overlap the bytes they produce, at distances of 1
+        # and 3, and a match from near the far end of the window.
+        data += "x" * 300 + "abc" * 200
+        rand = random.Random(7)
+        block = "".join([chr(rand.randint(0, 255)) for i in range(3000)])
+        data += block + "-" * 500 + block
+        return data
+
+    def read_binary_memory(self, addr, size, compression):
+        """Read memory with an 'x' packet and decode the reply. Return the
+        bytes and whether the reply was compressed."""
+        reply = self.send_packet("x%x,%x" % (addr, size))
+        if compression == "rle":
+            # A literal '*' is escaped, any other one is a repeat count.
+            compressed = "*" in reply
+            reply = self.run_length_decode(reply)
+        elif compression == "lzss":
+            compressed = reply.startswith("*")
+            reply = self.lzss_decompress(reply)
+        else:
+            compressed = False
+        self.assertTrue(reply.startswith("b"), "binary memory replies start with a 'b'")
+        return (self.unescape(reply[1:]), compressed)
+
+    def encodings(self):
+        """Write memory with 'X' packets and read it back with 'x' packets
+        with each compression type."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        supported = self.start_gdbserver()
+        self.assertTrue("binary-memory+" in supported)
+        self.assertTrue("compression=lzss,rle" in supported)
+        self.launch([exe])
+
+        # The stack is mapped well below the stack pointer at the start of
+        # the program, and nothing uses that part of it yet.
+        sp = self.read_register(self.register_number("sp"))
+        addr = (sp - 0x9000) & ~0xfff
+        data = self.encoding_test_data()
+        chunk_size = 0x1000
+
+        for offset in range(0, len(data), chunk_size):
+            chunk = data[offset:offset + chunk_size]
+            self.assertTrue(self.send_packet("X%x,%x:%s" % (addr + offset, len(chunk), self.escape(chunk))) == "OK")
+        for offset in range(0, len(data), chunk_size):
+            chunk = data[offset:offset + chunk_size]
+            self.assertTrue(self.send_packet("m%x,%x" % (addr + offset, len(chunk))) == chunk.encode("hex"),
+                            "'X' wrote the wrong bytes at offset %d" % offset)
+
+        for compression in ["none", "rle", "lzss"]:
+            self.assertTrue(self.send_packet("QEnableCompression:type:%s;" % compression) == "OK")
+            num_compressed = 0
+            # Small reads too, LZSS doesn't compress replies that are short.
+            for size in [0x10, 0x100, chunk_size]:
+                for offset in range(0, len(data), size):
+                    chunk = data[offset:offset + size]
+                    read_data, compressed = self.read_binary_memory(addr + offset, len(chunk), compression)
+                    self.assertTrue(read_data == chunk,
+                                    "wrong bytes read at offset %d with %s compression" % (offset, compression))
+                    if compressed:
+                        num_compressed += 1
+            if compression != "none":
+                self.assertTrue(num_compressed > 0, "no reply was compressed with %s" % compression)
+        self.assertTrue(self.send_packet("QEnableCompression:type:none;") == "OK")
+
+        self.assertTrue(self.send_packet("k") == "X09")
+        self.server.expect(pexpect.EOF)
+
+
+    def parse_thread_stop_snapshot(self, reply):
+        """Split a qThreadStopSnapshot reply into (stop reply, stack address,
+        stack bytes, binary) tuples, and return them with whether the reply
+        was truncated."""
+        entries = []
+        i = 0
+        while i < len(reply):
+            if reply[i:] == "truncated":
+                return (entries, True)
+            self.assertTrue(reply[i] == "T", "snapshot entries are stop replies")
+            stop_reply = reply[i:i + 3]
+            addr, data, binary = None, None, False
+            i += 3
+            while i < len(reply) and reply[i] != "|":
+                colon = reply.index(":", i)
+                name = reply[i:colon]
+                if name == "binary-memory":
+                    # The escaped bytes may contain any separator, their
+                    # size says where they end.
+                    match = re.match(r"([0-9a-f]+),([0-9a-f]+)=", reply[colon + 1:])
+                    self.assertTrue(match, "binary-memory has an address and a size")
+                    start = colon + 1 + match.end()
+                    end = start + int(match.group(2), 16)
+                    self.assertTrue(reply[end:end + 1] == ";", "binary-memory ends at its size")
+                    addr, data, binary = int(match.group(1), 16), self.unescape(reply[start:end]), True
+                    i = end + 1
+                    continue
+                semicolon = reply.index(";", colon)
+                value = reply[colon + 1:semicolon]
+                i = semicolon + 1
+                if name == "memory":
+                    addr, data = value.split("=")
+                    addr, data = int(addr, 16), data.decode("hex")
+                else:
+                    stop_reply += "%s:%s;" % (name, value)
+            # Skip the '|'
+            i += 1
+            entries.append((stop_reply, addr, data, binary))
+        return (entries, False)
+
+    def thread_stop_snapshot(self):
+        """Check the stop replies and the stack memory qThreadStopSnapshot
+        sends, in hex and in binary."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        supported = self.start_gdbserver()
+        self.assertTrue("binary-memory+" in supported)
+        self.launch([exe])
+        sp = self.read_register(self.register_number("sp"))
+        thread = re.search(r"thread:([0-9a-f]+);", self.send_packet("?")).group(1)
+
+        # start_gdbserver() didn't say the client takes binary memory, so
+        # the stack comes in hex.
+        for binary in [False, True]:
+            if binary:
+                self.assertTrue(self.send_packet("qSupported:binary-memory+").startswith("PacketSize="))
+            entries, truncated = self.parse_thread_stop_snapshot(self.send_packet("qThreadStopSnapshot:stack:100;"))
+            self.assertFalse(truncated)
+            self.assertTrue(len(entries) == 1, "the program has one thread")
+            stop_reply, addr, data, entry_binary = entries[0]
+            self.assertTrue(stop_reply.startswith("T05"), "stopped with SIGTRAP")
+            self.assertTrue("thread:%s;" % thread in stop_reply)
+            self.assertTrue(entry_binary == binary, "the stack is sent binary only if the client takes it")
+            self.assertTrue(addr == sp, "the stack is read from the stack pointer")
+            self.assertTrue(data == self.send_packet("m%x,100" % sp).decode("hex"), "the stack bytes are wrong")
+
+        # Requests for more stack than the stub sends are cut down, and the
+        # reply still fits in a packet.
+        reply = self.send_packet("qThreadStopSnapshot:stack:ffffffff;")
+        self.assertTrue(len(reply) <= self.max_packet_size)
+        entries, truncated = self.parse_thread_stop_snapshot(reply)
+        self.assertFalse(truncated)
+        stop_reply, addr, data, binary = entries[0]
+        self.assertTrue(binary and addr == sp)
+        self.assertTrue(0 < len(data) <= 4096, "at most 4KB of stack is sent")
+        self.assertTrue(data == self.send_packet("m%x,%x" % (sp, len(data))).decode("hex"), "the stack bytes are wrong")
+
+        # A client that doesn't take binary memory gets hex again.
+        self.send_packet("qSupported")
+        entries, truncated = self.parse_thread_stop_snapshot(self.send_packet("qThreadStopSnapshot:stack:10;"))
+        self.assertFalse(entries[0][3], "the stack is sent in hex")
+
+        self.assertTrue(self.send_packet("k") == "X09")
+        self.server.expect(pexpect.EOF)
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,137 @@
+"""
+Test that the memory cache picks the line size of each region of memory,
+reads ahead when memory is walked through in order, and never hands out
+memory that was written or that changed while the process ran.
+"""
+
+import os, time, re
+import unittest2
+import lldb
+from lldbutil import get_stopped_thread
+from lldbtest import *
+
+class MemoryCacheTestCase(TestBase):
+
+    mydir = os.path.join("functionalities", "memory-cache")
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    def test_memory_cache_with_dsym(self):
+        """Test region line sizes, sequential prefetch and invalidation of the memory cache."""
+        self.buildDsym()
+        self.memory_cache()
+
+    def test_memory_cache_with_dwarf(self):
+        """Test region line sizes, sequential prefetch and invalidation of the memory cache."""
+        self.buildDwarf()
+        self.memory_cache()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line numbers used by the test.
+        self.read_only_line = line_number('main.c', '// Break with the pages read-only.')
+        self.writable_line = line_number('main.c', '// Break with the pages writable.')
+
+    def cache_statistics(self):
+        """Return the regions the memory cache knows of, as a list of
+        (start, end, line byte size), and the statistics since the last stop,
+        as a dictionary."""
+        self.runCmd("log memory-cache dump")
+        output = self.res.GetOutput()
+        regions = [(int(m.group(1), 16), int(m.group(2), 16), int(m.group(3)))
+                   for m in re.finditer(r"\[0x([0-9a-f]+)-0x([0-9a-f]+)\) (\d+) byte lines", output)]
+        m = re.search(r"since the last stop: (\d+) hits, (\d+) misses .* (\d+) lines prefetched, (\d+) bytes fetched", output)
+        self.assertTrue(m, "Unexpected memory cache statistics: " + output)
+        stats = { 'hits': int(m.group(1)),
+                  'misses': int(m.group(2)),
+                  'prefetched': int(m.group(3)),
+                  'fetched': int(m.group(4)) }
+        return (regions, stats)
+
+    def line_byte_size(self, regions, addr):
+        """Return the line byte size of the region containing addr, or None."""
+        for start, end, line_byte_size in regions:
+            if start <= addr and addr < end:
+                return line_byte_size
+        return None
+
+    def read(self, process, addr, size):
+        error = lldb.SBError()
+        content = process.ReadMemory(addr, size, error)
+        self.assertTrue(error.Success(), "Failed to read %d bytes at 0x%x" % (size, addr))
+        self.assertTrue(len(content) == size)
+        return content
+
+    def memory_cache(self):
+        """Check the line sizes of the regions, read ahead and invalidation."""
+        exe = os.path.join(os.getcwd(), "a.out")
+
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+
+        breakpoint = target.BreakpointCreateByLocation("main.c", self.read_only_line)
+        self.assertTrue(breakpoint, VALID_BREAKPOINT)
+        breakpoint = target.BreakpointCreateByLocation("main.c", self.writable_line)
+        self.assertTrue(breakpoint, VALID_BREAKPOINT)
+
+        process = target.LaunchSimple(None, None, os.getcwd())
+        self.assertTrue(process, PROCESS_IS_VALID)
+        thread = get_stopped_thread(process, lldb.eStopReasonBreakpoint)
+        self.assertTrue(thread, "There should be a thread stopped due to breakpoint")
+        frame = thread.GetFrameAtIndex(0)
+
+        pc = frame.GetPC()
+        buffer_addr = frame.EvaluateExpression("(unsigned long)g_buffer").GetValueAsUnsigned()
+        pages_addr = frame.FindVariable("pages").GetValueAsUnsigned()
+        self.assertTrue(buffer_addr != 0 and pages_addr != 0)
+
+        self.runCmd("log memory-cache reset")
+        self.read(process, pc, 16)
+        self.read(process, buffer_addr, 16)
+        self.assertTrue(self.read(process, pages_addr, 16) == '\x5a' * 16)
+
+        # Code and read-only memory are cached in large lines, writable
+        # memory in small ones. Processes that can't describe their memory
+        # regions cache everything with the default line size.
+        regions, stats = self.cache_statistics()
+        supports_regions = len(regions) > 0
+        if supports_regions:
+            self.assertTrue(self.line_byte_size(regions, pc) == 4096)
+            self.assertTrue(self.line_byte_size(regions, buffer_addr) == 256)
+            self.assertTrue(self.line_byte_size(regions, pages_addr) == 4096)
+
+        # Walking forward through the buffer makes the cache read ahead.
+        expected = ''.join([chr(i & 0xff) for i in range(16384)])
+        for offset in range(0, 8192, 64):
+            self.assertTrue(self.read(process, buffer_addr + offset, 64) == expected[offset:offset + 64],
+                            "Wrong bytes read at offset %d" % offset)
+        regions, stats = self.cache_statistics()
+        self.assertTrue(stats['prefetched'] > 0, "Sequential reads didn't prefetch any lines")
+        self.assertTrue(stats['hits'] > stats['misses'])
+
+        # Writing memory flushes what was cached of it, in lines of every
+        # size and in the prefetched memory.
+        error = lldb.SBError()
+        self.assertTrue(process.WriteMemory(buffer_addr + 1000, '\xaa' * 100, error) == 100 and error.Success())
+        expected = expected[:1000] + '\xaa' * 100 + expected[1100:]
+        self.assertTrue(self.read(process, buffer_addr + 960, 256) == expected[960:1216])
+        self.assertTrue(self.read(process, buffer_addr, 8192) == expected[:8192])
+
+        # After the program made the pages writable, the cache must read
+        # them again, with the line size of writable memory.
+        process.Continue()
+        thread = get_stopped_thread(process, lldb.eStopReasonBreakpoint)
+        self.assertTrue(thread, "There should be a thread stopped due to breakpoint")
+        self.assertTrue(thread.GetFrameAtIndex(0).GetLineEntry().GetLine() == self.writable_line)
+        self.assertTrue(self.read(process, pages_addr, 16) == '\xa5' + '\x5a' * 15)
+        if supports_regions:
+            regions, stats = self.cache_statistics()
+            self.assertTrue(self.line_byte_size(regions, pages_addr) == 256,
+                            "The line size of the pages wasn't updated after they became writable")
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,38 @@
+//===-- main.c --------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+#include <stdio.h>
+#include <string.h>
+#include <sys/mman.h>
+
+#define PAGES_BYTE_SIZE (4 * 4096)
+
+unsigned char g_buffer[16384];
+
+int main (int argc, char const *argv[])
+{
+    unsigned int i;
+    unsigned char *pages;
+
+    for (i = 0; i < sizeof(g_buffer); ++i)
+        g_buffer[i] = (unsigned char)i;
+
+    pages = (unsigned char *)mmap (NULL, PAGES_BYTE_SIZE, PROT_READ | PROT_WRITE, MAP_PRIVATE | MAP_ANON, -1, 0);
+    if (pages == MAP_FAILED)
+        return 1;
+    memset (pages, 0x5a, PAGES_BYTE_SIZE);
+    mprotect (pages, PAGES_BYTE_SIZE, PROT_READ);
+
+    printf ("pages = %p\n", pages); // Break with the pages read-only.
+
+    mprotect (pages, PAGES_BYTE_SIZE, PROT_READ | PROT_WRITE);
+    pages[0] = 0xa5;
+
+    printf ("pages[0] = 0x%x\n", pages[0]); // Break with the pages writable.
+    return 0;
+}
@@ -0,0 +1,111 @@
+"""
+Test that stepping over source lines stops at the right places, both when
+the stepping plans run to the next branch and when they single step.
+"""
+
+import os, time
+import unittest2
+import lldb
+from lldbtest import *
+
+class StepOverRangesTestCase(TestBase):
+
+    mydir = os.path.join("functionalities", "step-over-ranges")
+
+    def test_step_over_with_fast_stepping(self):
+        """Test stepping over calls, loops and returns running to the next branch."""
+        self.buildDefault()
+        self.step_over_ranges(True)
+
+    def test_step_over_with_single_stepping(self):
+        """Test stepping over calls, loops and returns single stepping."""
+        self.buildDefault()
+        self.step_over_ranges(False)
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line numbers used by the test.
+        self.loop_head = line_number('main.c', '// Loop head.')
+        self.loop_body = line_number('main.c', '// Loop body.')
+        self.return_sum = line_number('main.c', '// Return sum.')
+        self.call_line = line_number('main.c', '// Call sum_of_squares.')
+        self.print_line = line_number('main.c', '// Print result.')
+
+    def current_line(self):
+        """Return the function name and line number of the selected frame."""
+        frame = self.dbg.GetSelectedTarget().GetProcess().GetSelectedThread().GetFrameAtIndex(0)
+        return (frame.GetFunctionName(), frame.GetLineEntry().GetLine())
+
+    def step_over_ranges(self, fast_stepping):
+        """Step over calls, loop iterations and a return and check where each step stops."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+
+        self.runCmd("settings set target.use-fast-stepping %s" % ("true" if fast_stepping else "false"))
+
+        self.expect("breakpoint set -f main.c -l %d" % self.call_line, BREAKPOINT_CREATED,
+            startstr = "Breakpoint created: 1: file ='main.c', line = %d, locations = 1" %
+                        self.call_line)
+        self.expect("breakpoint set -f main.c -l %d" % self.loop_body, BREAKPOINT_CREATED,
+            startstr = "Breakpoint created: 2: file ='main.c', line = %d, locations = 1" %
+                        self.loop_body)
+
+        self.runCmd("run", RUN_SUCCEEDED)
+        self.assertTrue(self.current_line() == ("main", self.call_line))
+
+        # Stop in the first iteration of the loop and step through the
+        # remaining ones without the help of the breakpoint.  Each step
+        # over the call to square() must stop on one of the lines of the
+        # loop, in the frame of sum_of_squares().
+        self.runCmd("process continue")
+        self.assertTrue(self.current_line() == ("sum_of_squares", self.loop_body))
+        self.runCmd("breakpoint delete 2")
+
+        loop_lines = [self.loop_head, self.loop_body, self.return_sum]
+        for i in range(20):
+            self.runCmd("thread step-over")
+            self.expect("thread backtrace", "Stepping stopped in sum_of_squares",
+                substrs = ["stop reason = step over"],
+                patterns = ["frame #0.*sum_of_squares"])
+            function, line = self.current_line()
+            self.assertTrue(line in loop_lines,
+                            "Stopped at unexpected line %d of %s" % (line, function))
+            if line == self.return_sum:
+                break
+
+        self.assertTrue(self.current_line() == ("sum_of_squares", self.return_sum))
+        self.expect("frame variable i", VARIABLES_DISPLAYED_CORRECTLY,
+            startstr = "(int) i = 4")
+        self.expect("frame variable sum", VARIABLES_DISPLAYED_CORRECTLY,
+            startstr = "(int) sum = 14")
+
+        # Stepping over the return ends up back in main, in the middle of the
+        # line that made the call, or on the line after it.
+        self.runCmd("thread step-over")
+        function, line = self.current_line()
+        self.assertTrue(function == "main" and line in [self.call_line, self.print_line],
+                        "Stopped at unexpected line %d of %s" % (line, function))
+        if line == self.call_line:
+            self.runCmd("thread step-over")
+        self.assertTrue(self.current_line() == ("main", self.print_line))
+        self.expect("frame variable result", VARIABLES_DISPLAYED_CORRECTLY,
+            startstr = "(int) result = 14")
+
+        # Finally step over the whole call from the start of the line.
+        self.runCmd("process kill")
+        self.runCmd("run", RUN_SUCCEEDED)
+        self.assertTrue(self.current_line() == ("main", self.call_line))
+        self.runCmd("thread step-over")
+        self.expect("thread backtrace", "Stepped over the call to sum_of_squares",
+            substrs = ["stop reason = step over"],
+            patterns = ["frame #0.*main.c:%d" % self.print_line])
+        self.expect("frame variable result", VARIABLES_DISPLAYED_CORRECTLY,
+            startstr = "(int) result = 14")
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,31 @@
+//===-- main.c --------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+#include <stdio.h>
+
+int square (int value)
+{
+    return value * value; // In square.
+}
+
+int sum_of_squares (int count)
+{
+    int sum = 0;
+    int i;
+    for (i = 0; i < count; ++i) // Loop head.
+        sum += square (i); // Loop body.
+    return sum; // Return sum.
+}
+
+int main (int argc, char const *argv[])
+{
+    int result = 0;
+    result = sum_of_squares (4); // Call sum_of_squares.
+    printf ("result = %d\n", result); // Print result.
+    return 0;
+}
@@ -0,0 +1,82 @@
+"""
+Test that the threads of a process that stopped get their stop reasons and
+backtraces from the qThreadStopSnapshot packet, instead of asking for each
+thread's stop info.
+"""
+
+import os
+import unittest2
+import lldb
+from lldbutil import get_stopped_thread
+from lldbtest import *
+
+class ThreadStopSnapshotTestCase(TestBase):
+
+    mydir = os.path.join("functionalities", "thread-stop-snapshot")
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    def test_thread_stop_snapshot_with_dsym(self):
+        """Test the stop info and backtraces of threads that come from a snapshot."""
+        self.buildDsym()
+        self.thread_stop_snapshot()
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "processes are debugged through debugserver only on Darwin")
+    def test_thread_stop_snapshot_with_dwarf(self):
+        """Test the stop info and backtraces of threads that come from a snapshot."""
+        self.buildDwarf()
+        self.thread_stop_snapshot()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line number to break at.
+        self.line = line_number('main.c', '// Break here.')
+        self.log_file = os.path.join(os.getcwd(), "thread-stop-snapshot-packets.txt")
+        if os.path.exists(self.log_file):
+            os.remove(self.log_file)
+
+    def thread_stop_snapshot(self):
+        """Stop with several threads and check what each one reports."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+        breakpoint = target.BreakpointCreateByLocation("main.c", self.line)
+        self.assertTrue(breakpoint, VALID_BREAKPOINT)
+
+        self.runCmd("log enable -f %s gdb-remote packets" % self.log_file)
+        self.addTearDownHook(lambda: self.runCmd("log disable gdb-remote packets"))
+
+        process = target.LaunchSimple(None, None, os.getcwd())
+        self.assertTrue(process, PROCESS_IS_VALID)
+        stopped_thread = get_stopped_thread(process, lldb.eStopReasonBreakpoint)
+        self.assertTrue(stopped_thread, "There should be a thread stopped due to breakpoint")
+
+        # The main thread and the eight it started.
+        self.assertTrue(process.GetNumThreads() == 9, "Wrong number of threads")
+        num_thread_funcs = 0
+        for thread in process:
+            frame_names = [frame.GetFunctionName() for frame in thread]
+            if thread.GetThreadID() == stopped_thread.GetThreadID():
+                self.assertTrue(frame_names[0] == "main")
+                self.assertTrue(thread.GetStopReason() == lldb.eStopReasonBreakpoint)
+            else:
+                self.assertTrue(thread.GetStopReason() == lldb.eStopReasonNone,
+                                "Thread 0x%x has a stop reason" % thread.GetThreadID())
+                if "thread_func" in frame_names:
+                    num_thread_funcs += 1
+        self.assertTrue(num_thread_funcs == 8, "Some threads don't backtrace through thread_func")
+
+        # The stop info of the threads came from the snapshot.
+        self.runCmd("log disable gdb-remote packets")
+        packets = open(self.log_file).read()
+        self.assertTrue("qThreadStopSnapshot" in packets, "qThreadStopSnapshot wasn't sent")
+        self.assertTrue("qThreadStopInfo" not in packets, "Threads asked for their own stop info")
+
+        process.Kill()
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
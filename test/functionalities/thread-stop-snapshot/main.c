@@ -0,0 +1,51 @@
+//===-- main.c --------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+#include <pthread.h>
+#include <stdio.h>
+
+#define NUM_THREADS 8
+
+pthread_mutex_t g_mutex = PTHREAD_MUTEX_INITIALIZER;
+pthread_cond_t g_started_cond = PTHREAD_COND_INITIALIZER;
+pthread_cond_t g_done_cond = PTHREAD_COND_INITIALIZER;
+int g_num_started = 0;
+int g_done = 0;
+
+void *
+thread_func (void *input)
+{
+    pthread_mutex_lock (&g_mutex);
+    ++g_num_started;
+    pthread_cond_signal (&g_started_cond);
+    while (!g_done)
+        pthread_cond_wait (&g_done_cond, &g_mutex);
+    pthread_mutex_unlock (&g_mutex);
+    return NULL;
+}
+
+int main (int argc, char const *argv[])
+{
+    pthread_t threads[NUM_THREADS];
+    int i;
+
+    for (i = 0; i < NUM_THREADS; ++i)
+        pthread_create (&threads[i], NULL, thread_func, NULL);
+
+    pthread_mutex_lock (&g_mutex);
+    while (g_num_started < NUM_THREADS)
+        pthread_cond_wait (&g_started_cond, &g_mutex);
+    g_done = 1; // Break here.
+    pthread_cond_broadcast (&g_done_cond);
+    pthread_mutex_unlock (&g_mutex);
+
+    for (i = 0; i < NUM_THREADS; ++i)
+        pthread_join (threads[i], NULL);
+    printf ("%d threads done\n", NUM_THREADS);
+    return 0;
+}
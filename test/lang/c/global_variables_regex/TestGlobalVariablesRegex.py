@@ -0,0 +1,60 @@
+"""
+Test that looking up global variables with a regular expression finds the
+same variables as matching the expression against every global name.
+"""
+
+import os, time, re
+import unittest2
+import lldb
+from lldbtest import *
+
+class GlobalVariablesRegexTestCase(TestBase):
+
+    mydir = os.path.join("lang", "c", "global_variables_regex")
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    def test_with_dsym(self):
+        """Test that 'target variable -r' matches a scan of all global names."""
+        self.buildDsym()
+        self.global_variables_regex()
+
+    def test_with_dwarf(self):
+        """Test that 'target variable -r' matches a scan of all global names."""
+        self.buildDwarf()
+        self.global_variables_regex()
+
+    def find_variables(self, regex):
+        """Return the names of the globals 'target variable -r' finds for regex."""
+        result = lldb.SBCommandReturnObject()
+        self.dbg.GetCommandInterpreter().HandleCommand("target variable -r '%s'" % regex, result)
+        output = result.GetOutput() or ""
+        if self.TraceOn():
+            print "target variable -r '%s':\n%s" % (regex, output)
+        return set(re.findall(r"\) (\w+) = ", output))
+
+    def global_variables_regex(self):
+        """Test that 'target variable -r' matches a scan of all global names."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+
+        # "." requires no literal text, so it is checked against every
+        # name in the index. That is the linear scan to compare with.
+        all_names = self.find_variables(".")
+        self.assertTrue(set(["g_alpha_one", "g_beta_two", "s_alpha_static", "alpha_no_prefix"]) <= all_names,
+                        "the linear scan finds the globals")
+
+        # Expressions with required literals are narrowed down with the
+        # trigram index first. Alternations and short literals fall back
+        # on the linear scan.
+        for regex in ["alpha", "^g_alpha", "_two$", "g_.*_one", "al+pha", "[ab]eta",
+                      "alpha_(one|two)", "gamma|delta", "be", "alphabet", "no_such_name"]:
+            expected = set([name for name in all_names if re.search(regex, name)])
+            self.assertTrue(self.find_variables(regex) == expected,
+                            "'%s' finds the same globals as a linear scan" % regex)
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,25 @@
+//===-- main.c --------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+int g_alpha_one = 1;
+int g_alpha_two = 2;
+int g_beta_one = 3;
+int g_beta_two = 4;
+int g_gamma = 5;
+int g_delta = 6;
+int g_alphabet = 7;
+int alpha_no_prefix = 8;
+static int s_alpha_static = 9;
+static int s_beta_static = 10;
+
+int main (int argc, char const *argv[])
+{
+    return g_alpha_one + g_alpha_two + g_beta_one + g_beta_two + g_gamma +
+           g_delta + g_alphabet + alpha_no_prefix + s_alpha_static + s_beta_static;
+}
@@ -0,0 +1,83 @@
+"""
+Test that looking up functions by name finds the same code symbols as
+checking every symbol in the symbol table.
+"""
+
+import os, time
+import unittest2
+import lldb
+from lldbtest import *
+
+class FunctionSymbolsTestCase(TestBase):
+
+    mydir = os.path.join("lang", "cpp", "function_symbols")
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    def test_with_dsym(self):
+        """Test that function lookups by name find the same symbols as a linear scan."""
+        self.buildDsym()
+        self.function_symbols()
+
+    def test_with_dwarf(self):
+        """Test that function lookups by name find the same symbols as a linear scan."""
+        self.buildDwarf()
+        self.function_symbols()
+
+    def find_symbol_addresses(self, module, name, name_type):
+        """Return the file addresses of the functions and code symbols a lookup finds."""
+        addresses = set()
+        list = lldb.SBSymbolContextList()
+        module.FindFunctions(name, name_type, False, list)
+        for sc in list:
+            if sc.GetSymbol():
+                addresses.add(sc.GetSymbol().GetStartAddress().GetFileAddress())
+            elif sc.GetFunction():
+                addresses.add(sc.GetFunction().GetStartAddress().GetFileAddress())
+        return addresses
+
+    def function_symbols(self):
+        """Test that function lookups by name find the same symbols as a linear scan."""
+        exe = os.path.join(os.getcwd(), "a.out")
+
+        target = self.dbg.CreateTarget(exe)
+        self.assertTrue(target, VALID_TARGET)
+        module = target.GetModuleAtIndex(0)
+        self.assertTrue(module.IsValid())
+
+        # Build the expected name to symbol map by checking every symbol.
+        # The mangled names are collected first so that the demangled names
+        # are only computed by the lookups themselves.
+        expected = {}
+        code_symbols = []
+        for i in range(module.GetNumSymbols()):
+            symbol = module.GetSymbolAtIndex(i)
+            if symbol.GetType() == lldb.eSymbolTypeCode and symbol.GetMangledName():
+                code_symbols.append(symbol)
+        self.assertTrue(len(code_symbols) > 0, "a.out has mangled code symbols")
+
+        for symbol in code_symbols:
+            address = symbol.GetStartAddress().GetFileAddress()
+            for name in [symbol.GetMangledName(), symbol.GetName()]:
+                if name:
+                    expected.setdefault(name, set()).add(address)
+
+        for name, addresses in expected.items():
+            found = self.find_symbol_addresses(module, name, lldb.eFunctionNameTypeFull)
+            if self.TraceOn():
+                print "%s: expected %s, found %s" % (name, addresses, found)
+            self.assertTrue(addresses <= found,
+                            "lookup of '%s' finds every symbol with that name" % name)
+
+        # Methods are only found as methods, and free functions only as
+        # base names.
+        self.assertTrue(len(self.find_symbol_addresses(module, "method", lldb.eFunctionNameTypeMethod)) == 1)
+        self.assertTrue(len(self.find_symbol_addresses(module, "method", lldb.eFunctionNameTypeBase)) == 0)
+        self.assertTrue(len(self.find_symbol_addresses(module, "free_function", lldb.eFunctionNameTypeBase)) == 1)
+        self.assertTrue(len(self.find_symbol_addresses(module, "free_function", lldb.eFunctionNameTypeMethod)) == 0)
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,50 @@
+//===-- main.cpp ------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// Code symbols of the kinds the symbol table indexes differently: plain
+// and namespaced functions, methods, operators, templates and local
+// names.
+
+int free_function (int i) { return i + 1; }
+
+namespace ns
+{
+    int ns_function (int i) { return i + 2; }
+
+    class Class
+    {
+    public:
+        Class () : m_value (3) {}
+        virtual ~Class () {}
+        int method (int i) const { return i + m_value; }
+        static int static_method (int i) { return i + 4; }
+        bool operator== (const Class &rhs) const { return m_value == rhs.m_value; }
+    private:
+        int m_value;
+    };
+}
+
+template <typename T> T template_function (T t) { return t + 5; }
+
+int local_static ()
+{
+    static int counter = 0;
+    struct Local { static int get () { return 6; } };
+    return ++counter + Local::get();
+}
+
+int main (int argc, char const *argv[])
+{
+    ns::Class c;
+    int result = free_function (argc) + ns::ns_function (argc) + c.method (argc) +
+                 ns::Class::static_method (argc) + (c == c) +
+                 template_function<int> (argc) + (int)template_function<double> (argc) +
+                 local_static ();
+    return result; // Set break point at this line.
+}
@@ -0,0 +1,74 @@
+"""
+Test that enumerators with negative and 64-bit values are read correctly.
+"""
+
+import os, time
+import unittest2
+import lldb
+from lldbtest import *
+
+class SignedEnumsTestCase(TestBase):
+
+    mydir = os.path.join("lang", "cpp", "signed_enums")
+
+    @unittest2.skipUnless(sys.platform.startswith("darwin"), "requires Darwin")
+    def test_with_dsym(self):
+        """Test that enumerators with negative and 64-bit values are read correctly."""
+        self.buildDsym()
+        self.signed_enums()
+
+    def test_with_dwarf(self):
+        """Test that enumerators with negative and 64-bit values are read correctly."""
+        self.buildDwarf()
+        self.signed_enums()
+
+    def setUp(self):
+        # Call super's setUp().
+        TestBase.setUp(self)
+        # Find the line number to break inside main().
+        self.line = line_number('main.cpp', '// Set break point at this line.')
+
+    def signed_enums(self):
+        """Test that enumerators with negative and 64-bit values are read correctly."""
+        exe = os.path.join(os.getcwd(), "a.out")
+        self.runCmd("file " + exe, CURRENT_EXECUTABLE_SET)
+
+        self.expect("breakpoint set -f main.cpp -l %d" % self.line,
+                    BREAKPOINT_CREATED,
+            startstr = "Breakpoint created: 1: file ='main.cpp', line = %d, locations = 1" %
+                        self.line)
+
+        self.runCmd("run", RUN_SUCCEEDED)
+
+        # The stop reason of the thread should be breakpoint.
+        self.expect("thread list", STOPPED_DUE_TO_BREAKPOINT,
+            substrs = ['stopped', 'stop reason = breakpoint'])
+
+        # A variable only displays as an enumerator if the enumerator's
+        # signed LEB128 value was decoded to exactly the value in memory.
+        # The nine and ten byte values also take the byte at a time path,
+        # where the shift reaches 64 and beyond.
+        self.expect("frame variable", VARIABLES_DISPLAYED_CORRECTLY,
+            substrs = ["one_byte = eNegOneByte",
+                       "three_bytes = eNegThreeBytes",
+                       "eight_bytes = eNegEightBytes",
+                       "nine_bytes = eNegNineBytes",
+                       "min = eMin",
+                       "max = eMax"])
+
+        # The enumerator values themselves.
+        self.expect("expression -- (long long)eNegThreeBytes", VARIABLES_DISPLAYED_CORRECTLY,
+            substrs = ["-1000000"])
+        self.expect("expression -- (long long)eNegEightBytes", VARIABLES_DISPLAYED_CORRECTLY,
+            substrs = ["-36028797018963968"])
+        self.expect("expression -- (long long)eNegNineBytes", VARIABLES_DISPLAYED_CORRECTLY,
+            substrs = ["-4611686018427387904"])
+        self.expect("expression -- (long long)eMin", VARIABLES_DISPLAYED_CORRECTLY,
+            substrs = ["-9223372036854775808"])
+
+
+if __name__ == '__main__':
+    import atexit
+    lldb.SBDebugger.Initialize()
+    atexit.register(lambda: lldb.SBDebugger.Terminate())
+    unittest2.main()
@@ -0,0 +1,31 @@
+//===-- main.cpp ------------------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// The enumerator values are stored as signed LEB128 numbers of one to
+// ten bytes in the debug info.
+enum SignedEnum
+{
+    eNegOneByte     = -2,
+    eNegThreeBytes  = -1000000,
+    eNegEightBytes  = -(1LL << 55),
+    eNegNineBytes   = -(1LL << 62),
+    eMin            = -9223372036854775807LL - 1,
+    eMax            = 9223372036854775807LL
+};
+
+int main (int argc, char const *argv[])
+{
+    SignedEnum one_byte = eNegOneByte;
+    SignedEnum three_bytes = eNegThreeBytes;
+    SignedEnum eight_bytes = eNegEightBytes;
+    SignedEnum nine_bytes = eNegNineBytes;
+    SignedEnum min = eMin;
+    SignedEnum max = eMax;
+    return 0; // Set break point at this line.
+}
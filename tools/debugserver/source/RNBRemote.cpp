@@ -74,10 +74,12 @@ RNBRemote::RNBRemote () :
     m_rx_pthread(0),
     m_breakpoints(),
     m_max_payload_size(DEFAULT_GDB_REMOTE_PROTOCOL_BUFSIZE - 4),
+    m_compression_type(GDBRemoteEncoding::eCompressionNone),
     m_extended_mode(false),
     m_noack_mode(false),
     m_thread_suffix_supported (false),
-    m_use_native_regs (false)
+    m_use_native_regs (false),
+    m_client_supports_binary_memory (false)
 {
     DNBLogThreadedIf (LOG_RNB_REMOTE, "%s", __PRETTY_FUNCTION__);
     CreatePacketTable ();
@@ -114,6 +116,7 @@ RNBRemote::CreatePacketTable  ()
     t.push_back (Packet (ack,                           NULL,                                   NULL, "+", "ACK"));
     t.push_back (Packet (nack,                          NULL,                                   NULL, "-", "!ACK"));
     t.push_back (Packet (read_memory,                   &RNBRemote::HandlePacket_m,             NULL, "m", "Read memory"));
+    t.push_back (Packet (read_data_from_memory,         &RNBRemote::HandlePacket_x,             NULL, "x", "Read memory as binary data"));
     t.push_back (Packet (read_register,                 &RNBRemote::HandlePacket_p,             NULL, "p", "Read one register"));
     t.push_back (Packet (read_general_regs,             &RNBRemote::HandlePacket_g,             NULL, "g", "Read registers"));
     t.push_back (Packet (write_memory,                  &RNBRemote::HandlePacket_M,             NULL, "M", "Write memory"));
@@ -143,8 +146,7 @@ RNBRemote::CreatePacketTable  ()
     t.push_back (Packet (vattachname,                   &RNBRemote::HandlePacket_v,             NULL, "vAttachName", "Attach to an existing process by name"));
     t.push_back (Packet (vcont_list_actions,            &RNBRemote::HandlePacket_v,             NULL, "vCont;", "Verbose resume with thread actions"));
     t.push_back (Packet (vcont_list_actions,            &RNBRemote::HandlePacket_v,             NULL, "vCont?", "List valid continue-with-thread-actions actions"));
-    // The X packet doesn't currently work. If/when it does, remove the line above and uncomment out the line below
-//  t.push_back (Packet (write_data_to_memory,          &RNBRemote::HandlePacket_X,             NULL, "X", "Write data to memory"));
+    t.push_back (Packet (write_data_to_memory,          &RNBRemote::HandlePacket_X,             NULL, "X", "Write data to memory"));
 //  t.push_back (Packet (insert_hardware_bp,            &RNBRemote::HandlePacket_UNIMPLEMENTED, NULL, "Z1", "Insert hardware breakpoint"));
 //  t.push_back (Packet (remove_hardware_bp,            &RNBRemote::HandlePacket_UNIMPLEMENTED, NULL, "z1", "Remove hardware breakpoint"));
     t.push_back (Packet (insert_write_watch_bp,         &RNBRemote::HandlePacket_z,             NULL, "Z2", "Insert write watchpoint"));
@@ -162,6 +164,7 @@ RNBRemote::CreatePacketTable  ()
     // syntax: qThreadStopInfoTTTT
     //  TTTT is hex thread ID
     t.push_back (Packet (query_thread_stop_info,        &RNBRemote::HandlePacket_qThreadStopInfo,   NULL, "qThreadStopInfo", "Get detailed info on why the specified thread stopped"));
+    t.push_back (Packet (query_thread_stop_snapshot,    &RNBRemote::HandlePacket_qThreadStopSnapshot, NULL, "qThreadStopSnapshot:", "Get detailed info on why every thread stopped, and the top of its stack"));
     t.push_back (Packet (query_thread_extra_info,       &RNBRemote::HandlePacket_qThreadExtraInfo,NULL, "qThreadExtraInfo", "Get printable status of a thread"));
 //  t.push_back (Packet (query_image_offsets,           &RNBRemote::HandlePacket_UNIMPLEMENTED, NULL, "qOffsets", "Report offset of loaded program"));
     t.push_back (Packet (query_launch_success,          &RNBRemote::HandlePacket_qLaunchSuccess,NULL, "qLaunchSuccess", "Report the success or failure of the launch attempt"));
@@ -169,8 +172,10 @@ RNBRemote::CreatePacketTable  ()
     t.push_back (Packet (query_shlib_notify_info_addr,  &RNBRemote::HandlePacket_qShlibInfoAddr,NULL, "qShlibInfoAddr", "Returns the address that contains info needed for getting shared library notifications"));
     t.push_back (Packet (query_step_packet_supported,   &RNBRemote::HandlePacket_qStepPacketSupported,NULL, "qStepPacketSupported", "Replys with OK if the 's' packet is supported."));
     t.push_back (Packet (query_host_info,               &RNBRemote::HandlePacket_qHostInfo,     NULL, "qHostInfo", "Replies with multiple 'key:value;' tuples appended to each other."));
+    t.push_back (Packet (query_supported,               &RNBRemote::HandlePacket_qSupported,    NULL, "qSupported", "Replies with the optional features " DEBUGSERVER_PROGRAM_NAME " supports."));
 //  t.push_back (Packet (query_symbol_lookup,           &RNBRemote::HandlePacket_UNIMPLEMENTED, NULL, "qSymbol", "Notify that host debugger is ready to do symbol lookups"));
     t.push_back (Packet (start_noack_mode,              &RNBRemote::HandlePacket_QStartNoAckMode        , NULL, "QStartNoAckMode", "Request that " DEBUGSERVER_PROGRAM_NAME " stop acking remote protocol packets"));
+    t.push_back (Packet (enable_compression,            &RNBRemote::HandlePacket_QEnableCompression     , NULL, "QEnableCompression:", "Request that " DEBUGSERVER_PROGRAM_NAME " compress the packets it sends"));
     t.push_back (Packet (prefix_reg_packets_with_tid,   &RNBRemote::HandlePacket_QThreadSuffixSupported , NULL, "QThreadSuffixSupported", "Check if thread specifc packets (register packets 'g', 'G', 'p', and 'P') support having the thread ID appended to the end of the command"));
     t.push_back (Packet (set_logging_mode,              &RNBRemote::HandlePacket_QSetLogging            , NULL, "QSetLogging:", "Check if register packets ('g', 'G', 'p', and 'P' support having the thread ID prefix"));
     t.push_back (Packet (set_max_packet_size,           &RNBRemote::HandlePacket_QSetMaxPacketSize      , NULL, "QSetMaxPacketSize:", "Tell " DEBUGSERVER_PROGRAM_NAME " the max sized packet gdb can handle"));
@@ -259,7 +264,9 @@ rnb_err_t
 RNBRemote::SendPacket (const std::string &s)
 {
     DNBLogThreadedIf (LOG_RNB_MAX, "%8d RNBRemote::%s (%s) called", (uint32_t)m_comm.Timer().ElapsedMicroSeconds(true), __FUNCTION__, s.c_str());
-    std::string sendpacket = "$" + s + "#";
+    std::string payload;
+    GDBRemoteEncoding::CompressPayload (m_compression_type, s, payload);
+    std::string sendpacket = "$" + payload + "#";
     int cksum = 0;
     char hexbuf[5];
 
@@ -269,8 +276,8 @@ RNBRemote::SendPacket (const std::string &s)
     }
     else
     {
-        for (int i = 0; i != s.size(); ++i)
-            cksum += s[i];
+        for (int i = 0; i != payload.size(); ++i)
+            cksum += payload[i];
         snprintf (hexbuf, sizeof hexbuf, "%02x", cksum & 0xff);
         sendpacket += hexbuf;
     }
@@ -743,39 +750,6 @@ RNBRemote::ThreadFunctionReadRemoteData(void *arg)
 
 
 
-/* Read the bytes in STR which are GDB Remote Protocol binary encoded bytes
- (8-bit bytes).
- This encoding uses 0x7d ('}') as an escape character for 0x7d ('}'),
- 0x23 ('#'), and 0x24 ('$').
- LEN is the number of bytes to be processed.  If a character is escaped,
- it is 2 characters for LEN.  A LEN of -1 means encode-until-nul-byte
- (end of string).  */
-
-std::vector<uint8_t>
-decode_binary_data (const char *str, int len)
-{
-    std::vector<uint8_t> bytes;
-    if (len == 0)
-    {
-        return bytes;
-    }
-    if (len == -1)
-        len = strlen (str);
-
-    while (len--)
-    {
-        unsigned char c = *str;
-        if (c == 0x7d && len > 0)
-        {
-            len--;
-            str++;
-            c ^= 0x20;
-        }
-        bytes.push_back (c);
-    }
-    return bytes;
-}
-
 typedef struct register_map_entry
 {
     uint32_t        gdb_regnum; // gdb register number
@@ -1306,6 +1280,83 @@ RNBRemote::HandlePacket_qThreadStopInfo (const char *p)
     return SendStopReplyPacketForThread (tid);
 }
 
+/* 'qThreadStopSnapshot:stack:<hex byte size>;'
+ Get the stop reply packet of every thread at once, separated by '|'.
+ Each one also has the top of the thread's stack, starting at its stack
+ pointer, as "binary-memory:<addr>,<hex size of escaped bytes>=<escaped
+ bytes>;" if the debugger takes binary memory, or as
+ "memory:<addr>=<hex bytes>;".  The stack is dropped for threads it
+ doesn't fit in the packet for, and the reply ends with "|truncated" if
+ even the stop replies of all threads don't fit.  */
+
+/* The most stack memory we send for each thread.  */
+#define MAX_SNAPSHOT_STACK_BYTE_SIZE 4096
+
+rnb_err_t
+RNBRemote::HandlePacket_qThreadStopSnapshot (const char *p)
+{
+    nub_process_t pid = m_ctx.ProcessID();
+    if (pid == INVALID_NUB_PROCESS)
+        return SendPacket ("E50");
+
+    p += sizeof ("qThreadStopSnapshot:") - 1;
+    nub_size_t stack_byte_size = 0;
+    if (strncmp (p, "stack:", 6) == 0)
+        stack_byte_size = strtoul (p + 6, NULL, 16);
+    if (stack_byte_size > MAX_SNAPSHOT_STACK_BYTE_SIZE)
+        stack_byte_size = MAX_SNAPSHOT_STACK_BYTE_SIZE;
+
+    /* Leave room for the framing of the packet and the truncation marker.  */
+    const size_t max_reply_size = MAX_GDB_REMOTE_PACKET_SIZE - 32;
+    std::vector<uint8_t> stack_data (stack_byte_size);
+    std::string reply;
+    const nub_size_t numthreads = DNBProcessGetNumThreads (pid);
+    for (nub_size_t i = 0; i < numthreads; ++i)
+    {
+        nub_thread_t tid = DNBProcessGetThreadAtIndex (pid, i);
+        std::ostringstream entry;
+        if (i > 0)
+            entry << '|';
+        if (!AppendStopReplyForThread (pid, tid, entry))
+            return SendPacket ("E51");
+        if (reply.size() + entry.str().size() > max_reply_size)
+        {
+            /* The debugger gets the rest of the threads with qfThreadInfo.  */
+            reply += "|truncated";
+            break;
+        }
+        reply += entry.str();
+
+        DNBRegisterValue reg_value;
+        if (stack_byte_size > 0 &&
+            DNBThreadGetRegisterValueByID (pid, tid, REGISTER_SET_GENERIC, GENERIC_REGNUM_SP, &reg_value))
+        {
+            const nub_addr_t sp = reg_value.info.size == 8 ? reg_value.value.uint64 : reg_value.value.uint32;
+            const nub_size_t bytes_read = DNBProcessMemoryRead (pid, sp, stack_byte_size, &stack_data[0]);
+            if (bytes_read > 0)
+            {
+                std::ostringstream memory;
+                if (m_client_supports_binary_memory)
+                {
+                    std::string escaped_bytes;
+                    GDBRemoteEncoding::AppendEscapedBytes (escaped_bytes, &stack_data[0], bytes_read);
+                    memory << "binary-memory:" << std::hex << sp << ',' << escaped_bytes.size() << '=' << escaped_bytes;
+                }
+                else
+                {
+                    memory << "memory:" << std::hex << sp << '=';
+                    for (nub_size_t j = 0; j < bytes_read; ++j)
+                        memory << RAWHEX8(stack_data[j]);
+                }
+                memory << ';';
+                if (reply.size() + memory.str().size() <= max_reply_size)
+                    reply += memory.str();
+            }
+        }
+    }
+    return SendPacket (reply);
+}
+
 rnb_err_t
 RNBRemote::HandlePacket_qThreadInfo (const char *p)
 {
@@ -1758,6 +1809,31 @@ RNBRemote::HandlePacket_QThreadSuffixSupported (const char *p)
     return SendPacket ("OK");
 }
 
+rnb_err_t
+RNBRemote::HandlePacket_qSupported (const char *p)
+{
+    // The debugger asks for most features with other packets. The one we
+    // need to know about up front is whether it takes binary memory in our
+    // replies. Packets are queued as they arrive, so the debugger can send
+    // several before waiting for our responses.
+    m_client_supports_binary_memory = false;
+    p = strchr (p, ':');
+    while (p)
+    {
+        ++p;
+        const char *end = strchr (p, ';');
+        const size_t feature_len = end ? end - p : strlen (p);
+        if (feature_len == 14 && strncmp (p, "binary-memory+", 14) == 0)
+            m_client_supports_binary_memory = true;
+        p = end;
+    }
+
+    std::ostringstream ostrm;
+    ostrm << "PacketSize=" << std::hex << MAX_GDB_REMOTE_PACKET_SIZE << std::dec
+          << ";binary-memory+;pipelining+;compression=" << GDBRemoteEncoding::GetSupportedCompressionNames();
+    return SendPacket (ostrm.str());
+}
+
 rnb_err_t
 RNBRemote::HandlePacket_QStartNoAckMode (const char *p)
 {
@@ -1767,6 +1843,28 @@ RNBRemote::HandlePacket_QStartNoAckMode (const char *p)
     return result;
 }
 
+/* 'QEnableCompression:type:<name>;'
+ Compress the packets we send after replying to this one with the named
+ compression type, or stop compressing them if it is "none".  */
+
+rnb_err_t
+RNBRemote::HandlePacket_QEnableCompression (const char *p)
+{
+    p += sizeof ("QEnableCompression:") - 1;
+    if (strncmp (p, "type:", 5) != 0)
+        return HandlePacket_ILLFORMED (__FILE__, __LINE__, p, "Missing type in QEnableCompression packet");
+    p += 5;
+    const char *end = strchr (p, ';');
+    GDBRemoteEncoding::CompressionType type;
+    if (!GDBRemoteEncoding::GetCompressionType (p, end ? end - p : strlen (p), type))
+        return SendPacket ("E68");
+
+    // Send the OK packet the way the debugger expects it...
+    rnb_err_t result = SendPacket ("OK");
+    m_compression_type = type;
+    return result;
+}
+
 
 rnb_err_t
 RNBRemote::HandlePacket_QSetLogging (const char *p)
@@ -2058,6 +2156,15 @@ RNBRemote::SendStopReplyPacketForThread (nub_thread_t tid)
     if (pid == INVALID_NUB_PROCESS)
         return SendPacket("E50");
 
+    std::ostringstream ostrm;
+    if (AppendStopReplyForThread (pid, tid, ostrm))
+        return SendPacket (ostrm.str ());
+    return SendPacket("E51");
+}
+
+bool
+RNBRemote::AppendStopReplyForThread (nub_process_t pid, nub_thread_t tid, std::ostringstream &ostrm)
+{
     struct DNBThreadStopInfo tid_stop_info;
 
     /* Fill the remaining space in this packet with as many registers
@@ -2065,7 +2172,6 @@ RNBRemote::SendStopReplyPacketForThread (nub_thread_t tid)
 
     if (DNBThreadGetStopReason (pid, tid, &tid_stop_info))
     {
-        std::ostringstream ostrm;
         // Output the T packet with the thread
         ostrm << 'T';
         int signum = tid_stop_info.details.signal.signo;
@@ -2099,7 +2205,8 @@ RNBRemote::SendStopReplyPacketForThread (nub_thread_t tid)
         {
             size_t thread_name_len = strlen(thread_name);
             
-            if (::strcspn (thread_name, "$#+-;:") == thread_name_len)
+            // '|' separates the threads in a qThreadStopSnapshot reply
+            if (::strcspn (thread_name, "$#+-;:|") == thread_name_len)
                 ostrm << std::hex << "name:" << thread_name << ';';
             else
             {
@@ -2140,9 +2247,9 @@ RNBRemote::SendStopReplyPacketForThread (nub_thread_t tid)
             for (int i = 0; i < tid_stop_info.details.exception.data_count; ++i)
                 ostrm << "medata:" << std::hex << tid_stop_info.details.exception.data[i] << ";";
         }
-        return SendPacket (ostrm.str ());
+        return true;
     }
-    return SendPacket("E51");
+    return false;
 }
 
 /* `?'
@@ -2348,6 +2455,58 @@ RNBRemote::HandlePacket_m (const char *p)
     return SendPacket (ostrm.str ());
 }
 
+/* 'x' -- read memory as binary data
+ Same as 'm', but the reply is a 'b' followed by the bytes escaped as
+ binary data.  The 'b' keeps replies like "OK" from being mistaken for
+ other responses.  */
+
+rnb_err_t
+RNBRemote::HandlePacket_x (const char *p)
+{
+    if (p == NULL || p[0] == '\0' || strlen (p) < 3)
+    {
+        return HandlePacket_ILLFORMED (__FILE__, __LINE__, p, "Too short x packet");
+    }
+
+    char *c;
+    p++;
+    errno = 0;
+    nub_addr_t addr = strtoull (p, &c, 16);
+    if (errno != 0 && addr == 0)
+    {
+        return HandlePacket_ILLFORMED (__FILE__, __LINE__, p, "Invalid address in x packet");
+    }
+    if (*c != ',')
+    {
+        return HandlePacket_ILLFORMED (__FILE__, __LINE__, p, "Comma sep missing in x packet");
+    }
+
+    /* Advance 'p' to the length part of the packet.  */
+    p += (c - p) + 1;
+
+    errno = 0;
+    uint32_t length = strtoul (p, NULL, 16);
+    if (errno != 0 && length == 0)
+    {
+        return HandlePacket_ILLFORMED (__FILE__, __LINE__, p, "Invalid length in x packet");
+    }
+    if (length == 0)
+    {
+        return SendPacket ("b");
+    }
+
+    std::vector<uint8_t> buf (length);
+    int bytes_read = DNBProcessMemoryRead (m_ctx.ProcessID(), addr, length, &buf[0]);
+    if (bytes_read == 0)
+    {
+        return SendPacket ("E08");
+    }
+
+    std::string reply ("b");
+    GDBRemoteEncoding::AppendEscapedBytes (reply, &buf[0], bytes_read);
+    return SendPacket (reply);
+}
+
 rnb_err_t
 RNBRemote::HandlePacket_X (const char *p)
 {
@@ -2373,10 +2532,10 @@ RNBRemote::HandlePacket_X (const char *p)
     p += (c - p) + 1;
 
     errno = 0;
-    int length = strtoul (p, NULL, 16);
+    uint32_t length = strtoul (p, &c, 16);
     if (errno != 0 && length == 0)
     {
-        return HandlePacket_ILLFORMED (__FILE__, __LINE__, p, "Invalid length in m packet");
+        return HandlePacket_ILLFORMED (__FILE__, __LINE__, p, "Invalid length in X packet");
     }
 
     // I think gdb sends a zero length write request to test whether this
@@ -2386,17 +2545,22 @@ RNBRemote::HandlePacket_X (const char *p)
         return SendPacket ("OK");
     }
 
-    std::vector<uint8_t> data = decode_binary_data (c, -1);
-    std::vector<uint8_t>::const_iterator it;
-    uint8_t *buf = (uint8_t *) alloca (data.size ());
-    uint8_t *i = buf;
-    for (it = data.begin (); it != data.end (); ++it)
+    if (*c != ':')
     {
-        *i++ = *it;
+        return HandlePacket_ILLFORMED (__FILE__, __LINE__, p, "Missing colon in X packet");
+    }
+    /* Advance 'p' to the data part of the packet.  */
+    p += (c - p) + 1;
+
+    // lldb escapes NUL bytes, so the data ends at the end of the string
+    std::vector<uint8_t> buf (length);
+    if (GDBRemoteEncoding::UnescapeBytes (p, strlen (p), &buf[0], length) != length)
+    {
+        return HandlePacket_ILLFORMED (__FILE__, __LINE__, p, "Too little data in X packet");
     }
 
-    nub_size_t wrote = DNBProcessMemoryWrite (m_ctx.ProcessID(), addr, data.size(), buf);
-    if (wrote != data.size ())
+    nub_size_t wrote = DNBProcessMemoryWrite (m_ctx.ProcessID(), addr, length, &buf[0]);
+    if (wrote != length)
         return SendPacket ("E08");
     return SendPacket ("OK");
 }
@@ -19,6 +19,8 @@
 #include "RNBContext.h"
 #include "RNBSocket.h"
 #include "PThreadMutex.h"
+#include "Utility/GDBRemoteEncoding.h"
+#include <sstream>
 #include <string>
 #include <vector>
 #include <deque>
@@ -53,6 +55,7 @@ public:
         signal_and_step_inf_one_cycle,  // 'I'
         kill,                           // 'k'
         read_memory,                    // 'm'
+        read_data_from_memory,          // 'x'
         write_memory,                   // 'M'
         read_register,                  // 'p'
         write_register,                 // 'P'
@@ -85,6 +88,7 @@ public:
         query_thread_ids_subsequent,    // 'qsThreadInfo'
         query_thread_extra_info,        // 'qThreadExtraInfo'
         query_thread_stop_info,         // 'qThreadStopInfo'
+        query_thread_stop_snapshot,     // 'qThreadStopSnapshot:'
         query_image_offsets,            // 'qOffsets'
         query_symbol_lookup,            // 'gSymbols'
         query_launch_success,           // 'qLaunchSuccess'
@@ -92,8 +96,10 @@ public:
         query_shlib_notify_info_addr,   // 'qShlibInfoAddr'
         query_step_packet_supported,    // 'qStepPacketSupported'
         query_host_info,                // 'qHostInfo'
+        query_supported,                // 'qSupported'
         pass_signals_to_inferior,       // 'QPassSignals'
         start_noack_mode,               // 'QStartNoAckMode'
+        enable_compression,             // 'QEnableCompression:'
         prefix_reg_packets_with_tid,    // 'QPrefixRegisterPacketsWithThreadID
         set_logging_mode,               // 'QSetLogging:'
         set_max_packet_size,            // 'QSetMaxPacketSize:'
@@ -165,8 +171,11 @@ public:
     rnb_err_t HandlePacket_qThreadInfo (const char *p);
     rnb_err_t HandlePacket_qThreadExtraInfo (const char *p);
     rnb_err_t HandlePacket_qThreadStopInfo (const char *p);
+    rnb_err_t HandlePacket_qThreadStopSnapshot (const char *p);
     rnb_err_t HandlePacket_qHostInfo (const char *p);
+    rnb_err_t HandlePacket_qSupported (const char *p);
     rnb_err_t HandlePacket_QStartNoAckMode (const char *p);
+    rnb_err_t HandlePacket_QEnableCompression (const char *p);
     rnb_err_t HandlePacket_QThreadSuffixSupported (const char *p);
     rnb_err_t HandlePacket_QSetLogging (const char *p);
     rnb_err_t HandlePacket_QSetDisableASLR (const char *p);
@@ -181,6 +190,7 @@ public:
     rnb_err_t HandlePacket_last_signal (const char *p);
     rnb_err_t HandlePacket_m (const char *p);
     rnb_err_t HandlePacket_M (const char *p);
+    rnb_err_t HandlePacket_x (const char *p);
     rnb_err_t HandlePacket_X (const char *p);
     rnb_err_t HandlePacket_g (const char *p);
     rnb_err_t HandlePacket_G (const char *p);
@@ -204,6 +214,7 @@ public:
     rnb_err_t HandlePacket_stop_process (const char *p);
 
     rnb_err_t SendStopReplyPacketForThread (nub_thread_t tid);
+    bool AppendStopReplyForThread (nub_process_t pid, nub_thread_t tid, std::ostringstream &ostrm);
     rnb_err_t SendHexEncodedBytePacket (const char *header, const void *buf, size_t buf_len, const char *footer);
     rnb_err_t SendSTDOUTPacket (char *buf, nub_size_t buf_size);
     rnb_err_t SendSTDERRPacket (char *buf, nub_size_t buf_size);
@@ -328,10 +339,12 @@ protected:
     BreakpointMap   m_breakpoints;
     BreakpointMap   m_watchpoints;
     uint32_t        m_max_payload_size;  // the maximum sized payload we should send to gdb
+    GDBRemoteEncoding::CompressionType m_compression_type; // how we compress the packets we send
     bool            m_extended_mode:1,   // are we in extended mode?
                     m_noack_mode:1,      // are we in no-ack mode?
                     m_noack_mode_just_enabled:1, // Did we just enable this and need to compute one more checksum?
                     m_use_native_regs:1, // Use native registers by querying DNB layer for register definitions?
+                    m_client_supports_binary_memory:1, // The debugger said "binary-memory+" in its qSupported packet
                     m_thread_suffix_supported:1; // Set to true if the 'p', 'P', 'g', and 'G' packets should be prefixed with the thread ID and colon:
                                                                 // "$pRR;thread:TTTT;" instead of "$pRR"
                                                                 // "$PRR=VVVVVVVV;thread:TTTT;" instead of "$PRR=VVVVVVVV"
@@ -358,4 +371,10 @@ protected:
    about how many bytes gdb might try to send in a single packet.  */
 #define DEFAULT_GDB_REMOTE_PROTOCOL_BUFSIZE 399
 
+/* The largest packet we tell the debugger we can receive, with the
+   "PacketSize" feature of the qSupported reply.  The debugger sizes its
+   memory reads and writes to fit, and doesn't accept compressed packets
+   that expand to more than this.  */
+#define MAX_GDB_REMOTE_PACKET_SIZE 0x20000
+
 #endif // #ifndef __RNBRemote_h__
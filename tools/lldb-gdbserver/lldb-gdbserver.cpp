@@ -0,0 +1,276 @@
+//===-- lldb-gdbserver.cpp --------------------------------------*- C++ -*-===//
+//
+//                     The LLVM Compiler Infrastructure
+//
+// This file is distributed under the University of Illinois Open Source
+// License. See LICENSE.TXT for details.
+//
+//===----------------------------------------------------------------------===//
+
+// C Includes
+#include <errno.h>
+#include <getopt.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <arpa/inet.h>
+#include <netinet/in.h>
+#include <netinet/tcp.h>
+#include <sys/socket.h>
+
+// C++ Includes
+
+// Other libraries and framework includes
+#include "lldb/Core/Error.h"
+#include "lldb/Core/ConnectionFileDescriptor.h"
+#include "lldb/Core/Debugger.h"
+#include "lldb/Core/StreamFile.h"
+#include "GDBRemoteCommunicationServer.h"
+#include "Plugins/Process/gdb-remote/ProcessGDBRemoteLog.h"
+using namespace lldb;
+using namespace lldb_private;
+
+//----------------------------------------------------------------------
+// option descriptors for getopt_long()
+//
+// The options match the ones debugserver takes, so the gdb-remote
+// plug-in and lldb-platform can start either one the same way.
+//----------------------------------------------------------------------
+
+int g_debug = 0;
+int g_verbose = 0;
+int g_native_regs = 0;
+int g_setsid = 0;
+
+static struct option g_long_options[] =
+{
+    { "debug",              no_argument,        &g_debug,           1   },
+    { "verbose",            no_argument,        &g_verbose,         1   },
+    { "native-regs",        no_argument,        &g_native_regs,     1   },
+    { "setsid",             no_argument,        &g_setsid,          1   },
+    { "log-file",           required_argument,  NULL,               'l' },
+    { "log-flags",          required_argument,  NULL,               'f' },
+    { "unix-socket",        required_argument,  NULL,               'u' },
+    { NULL,                 0,                  NULL,               0   }
+};
+
+//----------------------------------------------------------------------
+// Watch for signals
+//----------------------------------------------------------------------
+int g_sigpipe_received = 0;
+void
+signal_handler(int signo)
+{
+    switch (signo)
+    {
+    case SIGPIPE:
+        g_sigpipe_received = 1;
+        break;
+    }
+}
+
+static void
+display_usage (const char *progname)
+{
+    fprintf(stderr, "Usage:\n  %s [--log-file log-file-path] [--log-flags flags] [--unix-socket path] HOST:PORT\n", progname);
+}
+
+//----------------------------------------------------------------------
+// Binds to PORT on the loopback interface, and tells the process that
+// launched us which port that was, which matters if PORT is zero.
+//----------------------------------------------------------------------
+static int
+ListenForConnection (uint16_t port, const char *unix_socket_name, Error &error)
+{
+    int listen_fd = ::socket (AF_INET, SOCK_STREAM, IPPROTO_TCP);
+    if (listen_fd == -1)
+    {
+        error.SetErrorToErrno();
+        return -1;
+    }
+
+    int option_value = 1;
+    ::setsockopt (listen_fd, SOL_SOCKET, SO_REUSEADDR, &option_value, sizeof(option_value));
+
+    struct sockaddr_in listen_addr;
+    ::memset (&listen_addr, 0, sizeof(listen_addr));
+    listen_addr.sin_family = AF_INET;
+    listen_addr.sin_port = htons (port);
+    listen_addr.sin_addr.s_addr = htonl (INADDR_LOOPBACK);
+    socklen_t listen_addr_len = sizeof(listen_addr);
+    if (::bind (listen_fd, (struct sockaddr *)&listen_addr, sizeof(listen_addr)) == -1 ||
+        ::listen (listen_fd, 1) == -1 ||
+        ::getsockname (listen_fd, (struct sockaddr *)&listen_addr, &listen_addr_len) == -1)
+    {
+        error.SetErrorToErrno();
+        ::close (listen_fd);
+        return -1;
+    }
+    port = ntohs (listen_addr.sin_port);
+
+    if (unix_socket_name && unix_socket_name[0])
+    {
+        std::string connect_url ("unix-connect://");
+        connect_url.append (unix_socket_name);
+        ConnectionFileDescriptor port_conn;
+        if (port_conn.Connect (connect_url.c_str(), &error) != eConnectionStatusSuccess)
+        {
+            ::close (listen_fd);
+            return -1;
+        }
+        char port_str[32];
+        const int port_str_len = ::snprintf (port_str, sizeof(port_str), "%u", port);
+        ConnectionStatus status;
+        port_conn.Write (port_str, port_str_len, status, &error);
+    }
+    else
+    {
+        printf ("Listening for a connection on port %u...\n", port);
+    }
+
+    int fd = ::accept (listen_fd, NULL, 0);
+    if (fd == -1)
+        error.SetErrorToErrno();
+    ::close (listen_fd);
+
+    if (fd != -1)
+    {
+        // Keep our TCP packets coming without any delays.
+        ::setsockopt (fd, IPPROTO_TCP, TCP_NODELAY, &option_value, sizeof(option_value));
+    }
+    return fd;
+}
+
+//----------------------------------------------------------------------
+// main
+//----------------------------------------------------------------------
+int
+main (int argc, char *argv[])
+{
+    const char *progname = argv[0];
+    signal (SIGPIPE, signal_handler);
+    int long_option_index = 0;
+    StreamSP log_stream_sp;
+    Args log_args;
+    Error error;
+    std::string unix_socket_name;
+    int ch;
+    Debugger::Initialize();
+
+    while ((ch = getopt_long(argc, argv, "l:f:u:", g_long_options, &long_option_index)) != -1)
+    {
+        switch (ch)
+        {
+        case 0:   // Any optional that auto set themselves will return 0
+            break;
+
+        case 'l': // Set Log File
+            if (optarg && optarg[0])
+            {
+                if ((strcasecmp(optarg, "stdout") == 0) || (strcmp(optarg, "/dev/stdout") == 0))
+                {
+                    log_stream_sp.reset (new StreamFile (stdout, false));
+                }
+                else if ((strcasecmp(optarg, "stderr") == 0) || (strcmp(optarg, "/dev/stderr") == 0))
+                {
+                    log_stream_sp.reset (new StreamFile (stderr, false));
+                }
+                else
+                {
+                    FILE *log_file = fopen(optarg, "w");
+                    if (log_file)
+                    {
+                        setlinebuf(log_file);
+                        log_stream_sp.reset (new StreamFile (log_file, true));
+                    }
+                    else
+                    {
+                        const char *errno_str = strerror(errno);
+                        fprintf (stderr, "Failed to open log file '%s' for writing: errno = %i (%s)", optarg, errno, errno_str ? errno_str : "unknown error");
+                    }
+
+                }
+
+            }
+            break;
+
+        case 'f': // Log Flags
+            if (optarg && optarg[0])
+                log_args.AppendArgument(optarg);
+            break;
+
+        case 'u': // Unix socket to report the port we listen on to
+            if (optarg && optarg[0])
+                unix_socket_name.assign (optarg);
+            break;
+        }
+    }
+
+    if (log_stream_sp)
+    {
+        if (log_args.GetArgumentCount() == 0)
+            log_args.AppendArgument("default");
+        ProcessGDBRemoteLog::EnableLog (log_stream_sp, 0,log_args, log_stream_sp.get());
+    }
+
+    // Skip any options we consumed with getopt_long
+    argc -= optind;
+    argv += optind;
+
+    if (argc < 1)
+    {
+        display_usage (progname);
+        Debugger::Terminate();
+        return 1;
+    }
+
+    // Run in our own session so terminal signals for the debugger don't
+    // reach us.
+    if (g_setsid)
+        setsid();
+
+    // Only the port of HOST:PORT matters, we always listen on the loopback
+    // interface.
+    const char *port_cstr = strrchr (argv[0], ':');
+    const uint16_t port = atoi (port_cstr ? port_cstr + 1 : argv[0]);
+
+    GDBRemoteCommunicationServer gdb_server (false);
+    const int fd = ListenForConnection (port, unix_socket_name.c_str(), error);
+    if (fd != -1)
+        gdb_server.SetConnection (new ConnectionFileDescriptor (fd, true));
+
+    if (gdb_server.IsConnected())
+    {
+        // After we connected, we need to get an initial ack from...
+        if (gdb_server.HandshakeWithClient(&error))
+        {
+            bool interrupt = false;
+            bool done = false;
+            while (!interrupt && !done)
+            {
+                if (!gdb_server.GetPacketAndSendResponse (UINT32_MAX, error, interrupt, done))
+                    break;
+            }
+
+            if (error.Fail())
+            {
+                fprintf(stderr, "error: %s\n", error.AsCString());
+            }
+        }
+        else
+        {
+            fprintf(stderr, "error: handshake with client failed\n");
+        }
+    }
+    else if (error.Fail())
+    {
+        fprintf(stderr, "error: %s\n", error.AsCString());
+    }
+
+    Debugger::Terminate();
+
+    return 0;
+}